@@ -13,6 +13,11 @@
  *
  * @see @ref net_zep for protocol definitions
  *
+ * To connect several native instances, point their remote endpoint to the
+ * ZEP dispatcher in `dist/tools/zep_dispatch`. It emulates a topology with
+ * lossy links and collisions between the instances and hands the LQI of the
+ * link to the receiver.
+ *
  * @{
  *
  * @file
@@ -0,0 +1,59 @@
+#!/bin/sh
+
+ZEP_DISPATCH_DIR="$(dirname $(readlink -f $0))"
+ZEP_DISPATCH="${ZEP_DISPATCH_DIR}/bin/zep_dispatch"
+HUB_ADDR="::1"
+HUB_PORT=17754
+
+ELF=$1
+NODES=$2
+TOPOLOGY=$3
+BASE_PORT=${4:-20000}
+LOGDIR=${LOGDIR:-.}
+
+[ -z "${ELF}" -o -z "${NODES}" ] && {
+    echo "usage: $0 <native elf> <number of nodes> [topology] [base port]"
+    echo ""
+    echo "Starts a ZEP hub and <number of nodes> instances of <native elf>."
+    echo "Node <i> uses the local port <base port> + <i>, this is the port"
+    echo "that identifies it in the topology file. The output of node <i> is"
+    echo "written to \${LOGDIR}/node<i>.log."
+    exit 1
+}
+
+[ -x "${ZEP_DISPATCH}" ] || make -C "${ZEP_DISPATCH_DIR}" || exit 1
+
+cleanup() {
+    echo "Cleaning up..."
+    trap "" INT QUIT TERM EXIT
+    # stop the nodes first, so the hub prints complete statistics
+    [ -n "${NODE_PIDS}" ] && kill ${NODE_PIDS} 2> /dev/null
+    kill -INT ${HUB_PID} 2> /dev/null
+    wait ${HUB_PID}
+    rm -f "${STDIN_FIFO}"
+}
+
+trap "cleanup" INT QUIT TERM EXIT
+
+if [ -n "${TOPOLOGY}" ]; then
+    "${ZEP_DISPATCH}" -t "${TOPOLOGY}" ${HUB_ADDR} ${HUB_PORT} &
+else
+    "${ZEP_DISPATCH}" ${HUB_ADDR} ${HUB_PORT} &
+fi
+HUB_PID=$!
+
+# the shell of a node would exit on EOF, so give them a stdin that stays open
+STDIN_FIFO="$(mktemp -u)"
+mkfifo "${STDIN_FIFO}" && exec 3<> "${STDIN_FIFO}"
+
+i=0
+while [ ${i} -lt ${NODES} ]; do
+    "${ELF}" -z "[${HUB_ADDR}]:$((BASE_PORT + i)),[${HUB_ADDR}]:${HUB_PORT}" \
+        <&3 > "${LOGDIR}/node${i}.log" 2>&1 &
+    NODE_PIDS="${NODE_PIDS} $!"
+    i=$((i + 1))
+done
+
+echo "${NODES} nodes running, send SIGUSR1 to ${HUB_PID} for statistics," \
+     "press Ctrl-C to stop"
+wait ${HUB_PID}
@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @file
+ * @brief   ZEP hub that emulates a radio network between native instances
+ *
+ * Every native instance connects its socket_zep interface to the hub. The hub
+ * forwards each frame to the neighbors of its sender as given by a topology
+ * file, each link with its own loss rate, delay, bitrate and LQI. Frames that
+ * overlap in time at a receiver collide and are dropped, as are frames a node
+ * receives while it transmits.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define NODES_MAX           (128U)
+#define QUEUE_SIZE          (1024U)
+#define FRAME_MAX           (256U)
+
+#define BITRATE_DEFAULT     (250000U)   /* O-QPSK in the 2.4 GHz band */
+#define PHY_OVERHEAD        (6U)        /* preamble, SFD and PHR */
+#define TX_MA_DEFAULT       (13.8)      /* at86rf233 at 3 V */
+#define RX_MA_DEFAULT       (11.8)
+#define VOLTAGE             (3.0)
+
+#define PERCENT_MAX         (100U)
+#define LQI_DEFAULT         (0xffU)
+
+/* ZEPv2 data header, see sys/include/net/zep.h */
+typedef struct __attribute__((packed)) {
+    char preamble[2];
+    uint8_t version;
+    uint8_t type;
+    uint8_t chan;
+    uint16_t dev;
+    uint8_t lqi_mode;
+    uint8_t lqi_val;
+    uint32_t time[2];
+    uint32_t seq;
+    uint8_t resv[10];
+    uint8_t length;
+} zep_v2_data_hdr_t;
+
+#define ZEP_V2_TYPE_DATA    (1U)
+
+typedef struct {
+    bool up;
+    uint8_t loss;           /* in percent */
+    uint8_t lqi;
+    uint32_t delay;         /* in us */
+    uint32_t bitrate;       /* in bit/s, 0 for the default */
+} link_t;
+
+typedef struct {
+    struct sockaddr_storage addr;
+    socklen_t addr_len;     /* 0 until the node sent its first frame */
+    uint16_t port;
+    uint64_t tx_until;      /* end of the current transmission */
+    /* statistics */
+    unsigned long tx_frames;
+    unsigned long tx_bytes;
+    unsigned long rx_frames;
+    unsigned long rx_bytes;
+    unsigned long lost;
+    unsigned long collisions;
+    unsigned long dropped;
+    uint64_t tx_time;       /* in us */
+    uint64_t rx_time;       /* in us */
+} node_t;
+
+typedef struct {
+    bool used;
+    bool lost;
+    bool collided;
+    uint8_t dst;
+    uint64_t start;
+    uint64_t end;
+    size_t len;
+    uint8_t data[FRAME_MAX];
+} frame_t;
+
+static node_t nodes[NODES_MAX];
+static unsigned nodes_numof;
+static link_t links[NODES_MAX][NODES_MAX];
+static bool topology;
+static frame_t queue[QUEUE_SIZE];
+static uint32_t bitrate = BITRATE_DEFAULT;
+static double tx_ma = TX_MA_DEFAULT;
+static double rx_ma = RX_MA_DEFAULT;
+static uint64_t start_time;
+static volatile sig_atomic_t print_stats;
+static volatile sig_atomic_t quit;
+
+static uint64_t _now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + (ts.tv_nsec / 1000U);
+}
+
+static uint64_t _airtime(size_t len, uint32_t rate)
+{
+    return (((uint64_t)(len + PHY_OVERHEAD) * 8U) * 1000000U) / rate;
+}
+
+static uint16_t _port(const struct sockaddr_storage *addr)
+{
+    switch (addr->ss_family) {
+        case AF_INET:
+            return ntohs(((const struct sockaddr_in *)addr)->sin_port);
+        case AF_INET6:
+            return ntohs(((const struct sockaddr_in6 *)addr)->sin6_port);
+        default:
+            return 0;
+    }
+}
+
+static int _node_get(uint16_t port, bool create)
+{
+    for (unsigned i = 0; i < nodes_numof; i++) {
+        if (nodes[i].port == port) {
+            return i;
+        }
+    }
+    if (!create || (nodes_numof == NODES_MAX)) {
+        return -1;
+    }
+    memset(&nodes[nodes_numof], 0, sizeof(node_t));
+    nodes[nodes_numof].port = port;
+    return nodes_numof++;
+}
+
+static int _node_from_addr(const struct sockaddr_storage *addr, socklen_t len)
+{
+    int idx = _node_get(_port(addr), !topology);
+
+    if (idx < 0) {
+        return -1;
+    }
+    if (nodes[idx].addr_len == 0) {
+        if (!topology) {
+            /* without a topology every node hears every other node */
+            for (unsigned i = 0; i < nodes_numof; i++) {
+                links[i][idx] = links[idx][i] = (link_t){
+                    .up = (i != (unsigned)idx), .lqi = LQI_DEFAULT
+                };
+            }
+        }
+        printf("node %u joined (port %u)\n", idx, nodes[idx].port);
+    }
+    memcpy(&nodes[idx].addr, addr, len);
+    nodes[idx].addr_len = len;
+    return idx;
+}
+
+static int _parse_link(char *line, unsigned lineno)
+{
+    char *save, *tok;
+    char *args[7];
+    unsigned argc = 0;
+    bool directed = false;
+
+    for (tok = strtok_r(line, " \t\r\n", &save); (tok != NULL) && (argc < 7);
+         tok = strtok_r(NULL, " \t\r\n", &save)) {
+        if (tok[0] == '#') {
+            break;
+        }
+        if ((argc == 1) && (strcmp(tok, ">") == 0)) {
+            directed = true;
+            continue;
+        }
+        args[argc++] = tok;
+    }
+    if (argc == 0) {
+        return 0;
+    }
+    if (argc < 2) {
+        fprintf(stderr, "topology:%u: expected two ports\n", lineno);
+        return -1;
+    }
+
+    link_t link = { .up = true, .lqi = LQI_DEFAULT };
+    int a = _node_get(atoi(args[0]), true);
+    int b = _node_get(atoi(args[1]), true);
+
+    if ((a < 0) || (b < 0) || (a == b)) {
+        fprintf(stderr, "topology:%u: invalid link\n", lineno);
+        return -1;
+    }
+    if (argc > 2) {
+        link.loss = atoi(args[2]);
+    }
+    if (argc > 3) {
+        link.delay = (uint32_t)(atof(args[3]) * 1000);
+    }
+    if (argc > 4) {
+        link.bitrate = atoi(args[4]) * 1000U;
+    }
+    if (argc > 5) {
+        link.lqi = atoi(args[5]);
+    }
+    if (link.loss > PERCENT_MAX) {
+        fprintf(stderr, "topology:%u: loss must be in percent\n", lineno);
+        return -1;
+    }
+    links[a][b] = link;
+    if (!directed) {
+        links[b][a] = link;
+    }
+    return 0;
+}
+
+static int _read_topology(const char *filename)
+{
+    char line[256];
+    unsigned lineno = 0;
+    FILE *f = fopen(filename, "r");
+
+    if (f == NULL) {
+        perror(filename);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (_parse_link(line, ++lineno) < 0) {
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    topology = true;
+    return 0;
+}
+
+static void _print_stats(void)
+{
+    double elapsed = (_now() - start_time) / 1000000.0;
+
+    printf("\n%.1f s\n", elapsed);
+    printf("%4s %6s %8s %10s %8s %10s %8s %8s %8s %10s %10s %10s\n",
+           "node", "port", "tx", "tx bytes", "rx", "rx bytes", "lost",
+           "coll", "dropped", "tx ms", "rx ms", "mJ");
+    for (unsigned i = 0; i < nodes_numof; i++) {
+        node_t *node = &nodes[i];
+        double energy = ((node->tx_time * tx_ma) + (node->rx_time * rx_ma)) *
+                        VOLTAGE / 1000000.0;
+
+        printf("%4u %6u %8lu %10lu %8lu %10lu %8lu %8lu %8lu %10.1f %10.1f "
+               "%10.3f\n", i, node->port, node->tx_frames, node->tx_bytes,
+               node->rx_frames, node->rx_bytes, node->lost, node->collisions,
+               node->dropped, node->tx_time / 1000.0, node->rx_time / 1000.0,
+               energy);
+    }
+    fflush(stdout);
+}
+
+/* marks the frames that overlap with [start, end) at dst as collided */
+static bool _collide(unsigned dst, uint64_t start, uint64_t end)
+{
+    bool res = false;
+
+    for (unsigned i = 0; i < QUEUE_SIZE; i++) {
+        frame_t *frame = &queue[i];
+
+        if (frame->used && (frame->dst == dst) && (frame->start < end) &&
+            (start < frame->end)) {
+            frame->collided = true;
+            res = true;
+        }
+    }
+    return res;
+}
+
+static void _dispatch(unsigned src, const uint8_t *buf, size_t len)
+{
+    const zep_v2_data_hdr_t *hdr = (const zep_v2_data_hdr_t *)buf;
+    uint64_t now = _now();
+
+    if ((len < sizeof(zep_v2_data_hdr_t)) || (hdr->preamble[0] != 'E') ||
+        (hdr->preamble[1] != 'X') || (hdr->version != 2) ||
+        (hdr->type != ZEP_V2_TYPE_DATA) ||
+        ((sizeof(zep_v2_data_hdr_t) + hdr->length) != len)) {
+        return;
+    }
+
+    uint64_t airtime = _airtime(hdr->length, bitrate);
+    node_t *node = &nodes[src];
+
+    node->tx_frames++;
+    node->tx_bytes += hdr->length;
+    node->tx_time += airtime;
+    /* the radio can't receive while it transmits */
+    _collide(src, now, now + airtime);
+    node->tx_until = now + airtime;
+
+    for (unsigned dst = 0; dst < nodes_numof; dst++) {
+        const link_t *link = &links[src][dst];
+        frame_t *frame = NULL;
+
+        if (!link->up) {
+            continue;
+        }
+        for (unsigned i = 0; i < QUEUE_SIZE; i++) {
+            if (!queue[i].used) {
+                frame = &queue[i];
+                break;
+            }
+        }
+        if (frame == NULL) {
+            nodes[dst].dropped++;
+            continue;
+        }
+        frame->dst = dst;
+        frame->start = now + link->delay;
+        frame->end = frame->start +
+                     _airtime(hdr->length, link->bitrate ? link->bitrate : bitrate);
+        frame->lost = ((unsigned)(rand() % PERCENT_MAX)) < link->loss;
+        frame->collided = _collide(dst, frame->start, frame->end) ||
+                          (nodes[dst].tx_until > frame->start);
+        frame->used = true;
+        frame->len = len;
+        memcpy(frame->data, buf, len);
+        ((zep_v2_data_hdr_t *)frame->data)->lqi_val = link->lqi;
+    }
+}
+
+/* delivers the frames received completely, returns the time of the next
+ * delivery */
+static uint64_t _deliver(int sock)
+{
+    uint64_t now = _now();
+    uint64_t next = UINT64_MAX;
+
+    for (unsigned i = 0; i < QUEUE_SIZE; i++) {
+        frame_t *frame = &queue[i];
+        node_t *dst = &nodes[frame->dst];
+
+        if (!frame->used) {
+            continue;
+        }
+        if (frame->end > now) {
+            if (frame->end < next) {
+                next = frame->end;
+            }
+            continue;
+        }
+        frame->used = false;
+        dst->rx_time += frame->end - frame->start;
+        if (frame->collided) {
+            dst->collisions++;
+        }
+        else if (frame->lost) {
+            dst->lost++;
+        }
+        else if ((dst->addr_len == 0) ||
+                 (sendto(sock, frame->data, frame->len, 0,
+                         (struct sockaddr *)&dst->addr, dst->addr_len) < 0)) {
+            /* the node didn't join yet */
+            dst->dropped++;
+        }
+        else {
+            dst->rx_frames++;
+            dst->rx_bytes += frame->len - sizeof(zep_v2_data_hdr_t);
+        }
+    }
+    return next;
+}
+
+static void _signal(int sig)
+{
+    if (sig == SIGUSR1) {
+        print_stats = 1;
+    }
+    else {
+        quit = 1;
+    }
+}
+
+static int _bind(const char *addr, const char *port)
+{
+    static const struct addrinfo hints = { .ai_family = AF_UNSPEC,
+                                           .ai_socktype = SOCK_DGRAM,
+                                           .ai_flags = AI_PASSIVE };
+    struct addrinfo *ai;
+    int sock = -1, res;
+
+    if ((res = getaddrinfo(addr, port, &hints, &ai)) != 0) {
+        fprintf(stderr, "%s: %s\n", addr, gai_strerror(res));
+        return -1;
+    }
+    for (struct addrinfo *p = ai; p != NULL; p = p->ai_next) {
+        if ((sock = socket(p->ai_family, p->ai_socktype, p->ai_protocol)) < 0) {
+            continue;
+        }
+        if (bind(sock, p->ai_addr, p->ai_addrlen) == 0) {
+            break;
+        }
+        close(sock);
+        sock = -1;
+    }
+    freeaddrinfo(ai);
+    if (sock < 0) {
+        perror("bind");
+    }
+    return sock;
+}
+
+static void _usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-t <topology>] [-b <kbit/s>] [-s <seconds>] "
+            "[-e <tx mA>,<rx mA>] [-r <seed>] <address> <port>\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    struct sigaction sa = { .sa_handler = _signal };
+    unsigned interval = 0;
+    uint64_t next_stats = UINT64_MAX;
+    uint64_t next;
+    int sock, c;
+
+    srand(time(NULL));
+    while ((c = getopt(argc, argv, "t:b:s:e:r:h")) != -1) {
+        switch (c) {
+            case 't':
+                if (_read_topology(optarg) < 0) {
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'b':
+                bitrate = atoi(optarg) * 1000U;
+                break;
+            case 's':
+                interval = atoi(optarg);
+                break;
+            case 'e':
+                if (sscanf(optarg, "%lf,%lf", &tx_ma, &rx_ma) != 2) {
+                    _usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+                srand(atoi(optarg));
+                break;
+            default:
+                _usage(argv[0]);
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (((argc - optind) != 2) || (bitrate == 0)) {
+        _usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((sock = _bind(argv[optind], argv[optind + 1])) < 0) {
+        return EXIT_FAILURE;
+    }
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+
+    start_time = _now();
+    if (interval > 0) {
+        next_stats = start_time + (interval * 1000000ULL);
+    }
+    next = UINT64_MAX;
+    while (!quit) {
+        struct pollfd pfd = { .fd = sock, .events = POLLIN };
+        uint64_t now = _now();
+        uint64_t until = (next < next_stats) ? next : next_stats;
+        struct timespec timeout = { 0 };
+
+        if (until > now) {
+            timeout.tv_sec = (until - now) / 1000000U;
+            timeout.tv_nsec = ((until - now) % 1000000U) * 1000U;
+        }
+        int res = ppoll(&pfd, 1, (until == UINT64_MAX) ? NULL : &timeout, NULL);
+
+        if ((res < 0) && (errno != EINTR)) {
+            perror("poll");
+            break;
+        }
+        if ((res > 0) && (pfd.revents & POLLIN)) {
+            uint8_t buf[FRAME_MAX];
+            struct sockaddr_storage addr;
+            socklen_t addr_len = sizeof(addr);
+            ssize_t len = recvfrom(sock, buf, sizeof(buf), 0,
+                                   (struct sockaddr *)&addr, &addr_len);
+            int src;
+
+            if ((len > 0) && ((src = _node_from_addr(&addr, addr_len)) >= 0)) {
+                _dispatch(src, buf, len);
+            }
+        }
+        next = _deliver(sock);
+        if (print_stats || (_now() >= next_stats)) {
+            _print_stats();
+            print_stats = 0;
+            if (interval > 0) {
+                next_stats = _now() + (interval * 1000000ULL);
+            }
+        }
+    }
+    _print_stats();
+    close(sock);
+    return EXIT_SUCCESS;
+}
@@ -25,8 +25,10 @@
 
 #include "shell.h"
 #include "msg.h"
+#include "mutex.h"
 #include "net/emcute.h"
 #include "net/ipv6/addr.h"
+#include "xtimer.h"
 
 #define EMCUTE_PORT         (1883U)
 #define EMCUTE_ID           ("gertrud")
@@ -41,6 +43,11 @@ static msg_t queue[8];
 static emcute_sub_t subscriptions[NUMOFSUBS];
 static char topics[NUMOFSUBS][TOPIC_MAXLEN];
 
+/* state of the publish benchmark, the callbacks run in the emcute thread */
+static mutex_t bench_done = MUTEX_INIT_LOCKED;
+static volatile unsigned bench_pending;
+static volatile unsigned bench_failed;
+
 static void *emcute_thread(void *arg)
 {
     (void)arg;
@@ -163,6 +170,76 @@ static int cmd_pub(int argc, char **argv)
     return 0;
 }
 
+static void on_bench_pub(void *arg, int res)
+{
+    (void)arg;
+    if (res != EMCUTE_OK) {
+        bench_failed++;
+    }
+    bench_pending--;
+    /* wake up the shell thread waiting for a free slot or the last message */
+    mutex_unlock(&bench_done);
+}
+
+static int cmd_pubbench(int argc, char **argv)
+{
+    static const char data[] = "benchmark";
+    emcute_topic_t t;
+    unsigned flags = EMCUTE_QOS_1;
+
+    if (argc < 3) {
+        printf("usage: %s <topic name> <count> [QoS level]\n", argv[0]);
+        return 1;
+    }
+    if (argc >= 4) {
+        flags = get_qos(argv[3]);
+    }
+
+    t.name = argv[1];
+    if (emcute_reg(&t) != EMCUTE_OK) {
+        puts("error: unable to obtain topic ID");
+        return 1;
+    }
+
+    unsigned count = atoi(argv[2]);
+    bench_pending = 0;
+    bench_failed = 0;
+    uint32_t start = xtimer_now_usec();
+
+    unsigned i = 0;
+    while (i < count) {
+        /* the callback may run before emcute_pub_async() returns */
+        if (flags & EMCUTE_QOS_MASK) {
+            bench_pending++;
+        }
+        int res = emcute_pub_async(&t, data, sizeof(data) - 1, flags,
+                                   on_bench_pub, NULL);
+        if ((res != EMCUTE_OK) && (flags & EMCUTE_QOS_MASK)) {
+            bench_pending--;
+        }
+        if (res == EMCUTE_OK) {
+            i++;
+        }
+        else if (res == EMCUTE_BUSY) {
+            mutex_lock(&bench_done);
+        }
+        else {
+            printf("error: unable to publish [%i]\n", res);
+            break;
+        }
+    }
+    while (bench_pending > 0) {
+        mutex_lock(&bench_done);
+    }
+
+    uint32_t time = xtimer_now_usec() - start;
+    printf("Published %u messages in %u ms (%u failed), %u messages/s\n",
+           i, (unsigned)(time / US_PER_MS), bench_failed,
+           (unsigned)(((uint64_t)i * US_PER_SEC) / (time ? time : 1)));
+
+    return 0;
+}
+
 static int cmd_sub(int argc, char **argv)
 {
     unsigned flags = EMCUTE_QOS_0;
@@ -250,6 +327,7 @@ static const shell_command_t shell_commands[] = {
     { "con", "connect to MQTT broker", cmd_con },
     { "discon", "disconnect from the current broker", cmd_discon },
     { "pub", "publish something", cmd_pub },
+    { "pubbench", "measure the publish rate", cmd_pubbench },
     { "sub", "subscribe topic", cmd_sub },
     { "unsub", "unsubscribe from topic", cmd_unsub },
     { "will", "register a last will", cmd_will },
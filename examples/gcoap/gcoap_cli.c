@@ -287,5 +287,7 @@ int gcoap_cli_cmd(int argc, char **argv)
 
 void gcoap_cli_init(void)
 {
-    gcoap_register_listener(&_listener);
+    if (gcoap_register_listener(&_listener) < 0) {
+        puts("gcoap_cli: unable to register resources");
+    }
 }
@@ -71,7 +71,10 @@ int main(void)
             rdcli_common_get_ep(), RDCLI_LT);
 
     /* register resource handlers with gcoap */
-    gcoap_register_listener(&listener);
+    if (gcoap_register_listener(&listener) < 0) {
+        puts("error: unable to register resources with gcoap");
+        return 1;
+    }
 
     /* print RD client information */
     puts("RD client information:");
@@ -10,6 +10,7 @@ PSEUDOMODULES += conn_can_isotp_multi
 PSEUDOMODULES += core_%
 PSEUDOMODULES += emb6_router
 PSEUDOMODULES += event_%
+PSEUDOMODULES += gcoap_worker
 PSEUDOMODULES += gnrc_ipv6_default
 PSEUDOMODULES += gnrc_ipv6_router
 PSEUDOMODULES += gnrc_ipv6_router_default
@@ -28,6 +29,8 @@ PSEUDOMODULES += gnrc_sixlowpan_nd_border_router
 PSEUDOMODULES += gnrc_sixlowpan_router
 PSEUDOMODULES += gnrc_sixlowpan_router_default
 PSEUDOMODULES += gnrc_sock_check_reuse
+PSEUDOMODULES += gnrc_tftp_mtd
+PSEUDOMODULES += gnrc_tftp_vfs
 PSEUDOMODULES += gnrc_txtsnd
 PSEUDOMODULES += l2filter_blacklist
 PSEUDOMODULES += l2filter_whitelist
@@ -70,7 +73,10 @@ PSEUDOMODULES += saul_default
 PSEUDOMODULES += saul_gpio
 PSEUDOMODULES += schedstatistics
 PSEUDOMODULES += sock
+PSEUDOMODULES += sock_dns_async
+PSEUDOMODULES += sock_dns_cache
 PSEUDOMODULES += sock_ip
+PSEUDOMODULES += sock_poll
 PSEUDOMODULES += sock_tcp
 PSEUDOMODULES += sock_udp
 
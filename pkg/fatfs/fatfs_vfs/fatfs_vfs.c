@@ -250,6 +250,29 @@ static off_t _lseek(vfs_file_t *filp, off_t off, int whence)
     return fatfs_err_to_errno(res);
 }
 
+static int _ftruncate(vfs_file_t *filp, off_t length)
+{
+    fatfs_file_desc_t *fd = (fatfs_file_desc_t *)filp->private_data.buffer;
+    FSIZE_t pos = f_tell(&fd->file);
+    FRESULT res;
+
+    if ((FSIZE_t)length > f_size(&fd->file)) {
+        return -EINVAL;
+    }
+
+    /* f_truncate() cuts the file at the read/write pointer */
+    res = f_lseek(&fd->file, length);
+    if (res == FR_OK) {
+        res = f_truncate(&fd->file);
+    }
+    /* seeking beyond the end would extend the file again */
+    if ((res == FR_OK) && (pos < (FSIZE_t)length)) {
+        res = f_lseek(&fd->file, pos);
+    }
+
+    return fatfs_err_to_errno(res);
+}
+
 static int _fstat(vfs_file_t *filp, struct stat *buf)
 {
     fatfs_file_desc_t *fd = (fatfs_file_desc_t *)filp->private_data.buffer;
@@ -452,6 +475,7 @@ static const vfs_file_ops_t fatfs_file_ops = {
     .write = _write,
     .lseek = _lseek,
     .fstat = _fstat,
+    .ftruncate = _ftruncate,
 };
 
 static const vfs_dir_ops_t fatfs_dir_ops = {
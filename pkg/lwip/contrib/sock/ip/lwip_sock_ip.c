@@ -172,9 +172,17 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
 ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
                      uint8_t proto, const sock_ip_ep_t *remote)
 {
-    assert((sock != NULL) || (remote != NULL));
+    iolist_t snip = { .iol_base = (void *)data, .iol_len = len };
+
     assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
-    return lwip_sock_send(&sock->conn, data, len, proto,
+    return sock_ip_sendv(sock, &snip, proto, remote);
+}
+
+ssize_t sock_ip_sendv(sock_ip_t *sock, const iolist_t *snips,
+                      uint8_t proto, const sock_ip_ep_t *remote)
+{
+    assert((sock != NULL) || (remote != NULL));
+    return lwip_sock_send(&sock->conn, snips, proto,
                           (struct _sock_tl_ep *)remote, NETCONN_RAW);
 }
 
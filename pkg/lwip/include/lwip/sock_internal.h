@@ -29,6 +29,7 @@
 
 #include "lwip/ip_addr.h"
 #include "lwip/api.h"
+#include "iolist.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,7 +56,7 @@ int lwip_sock_get_addr(struct netconn *conn, struct _sock_tl_ep *ep, u8_t local)
 #if defined(MODULE_LWIP_SOCK_UDP) || defined(MODULE_LWIP_SOCK_IP)
 int lwip_sock_recv(struct netconn *conn, uint32_t timeout, struct netbuf **buf);
 #endif
-ssize_t lwip_sock_send(struct netconn **conn, const void *data, size_t len,
+ssize_t lwip_sock_send(struct netconn **conn, const iolist_t *snips,
                        int proto, const struct _sock_tl_ep *remote, int type);
 /**
  * @}
@@ -52,6 +52,10 @@
 #include "net/gnrc/pktdump.h"
 #endif
 
+#ifdef MODULE_GNRC_PKTCAPTURE
+#include "net/gnrc/pktcapture.h"
+#endif
+
 #ifdef MODULE_GNRC_UDP
 #include "net/gnrc/udp.h"
 #endif
@@ -76,6 +80,10 @@
 #include "net/gcoap.h"
 #endif
 
+#ifdef MODULE_SOCK_DNS_ASYNC
+#include "net/sock/dns.h"
+#endif
+
 #ifdef MODULE_GNRC_IPV6_NIB
 #include "net/gnrc/ipv6/nib.h"
 #endif
@@ -118,6 +126,10 @@ void auto_init(void)
     DEBUG("Auto init gnrc_pktdump module.\n");
     gnrc_pktdump_init();
 #endif
+#ifdef MODULE_GNRC_PKTCAPTURE
+    DEBUG("Auto init gnrc_pktcapture module.\n");
+    gnrc_pktcapture_init();
+#endif
 #ifdef MODULE_GNRC_SIXLOWPAN
     DEBUG("Auto init gnrc_sixlowpan module.\n");
     gnrc_sixlowpan_init();
@@ -146,6 +158,10 @@ void auto_init(void)
     DEBUG("Auto init gcoap module.\n");
     gcoap_init();
 #endif
+#ifdef MODULE_SOCK_DNS_ASYNC
+    DEBUG("Auto init sock_dns_async module.\n");
+    sock_dns_async_init();
+#endif
 #ifdef MODULE_DEVFS
     DEBUG("Mounting /dev\n");
     extern void auto_init_devfs(void);
@@ -59,13 +59,26 @@
  * - updating will message
  * - sending out periodic PINGREQ messages
  * - handling re-transmits
+ * - publishing and receiving with QoS 2
+ *
+ *
+ * # Publishing with QoS 1 and 2
+ * Up to @ref EMCUTE_PUB_WINDOW confirmed publishes are in flight at the same
+ * time, so the publish rate is not limited to one message per round trip to
+ * the gateway. emcute_pub_async() returns as soon as the message is sent and
+ * calls back once it is acknowledged, emcute_pub() blocks until then. Several
+ * threads can call emcute_pub() at the same time.
+ *
+ * The emCute thread retransmits the publishes in flight. It checks them on
+ * every received packet, but at least every @ref EMCUTE_T_RETRY seconds, so
+ * a message is retransmitted between one and two times @ref EMCUTE_T_RETRY
+ * after it was sent.
  *
  * The following features are however still missing (but planned):
  * @todo        Gateway discovery (so far there is no support for handling
  *              ADVERTISE, GWINFO, and SEARCHGW). Open question to answer here:
  *              how to put / how to encode the IPv(4/6) address AND the port of
  *              a gateway in the GwAdd field of the GWINFO message
- * @todo        QOS level 2
  * @todo        put the node to sleep (send DISCONNECT with duration field set)
  * @todo        handle DISCONNECT messages initiated by the broker/gateway
  * @todo        support for pre-defined and short topic IDs
@@ -164,6 +177,24 @@ extern "C" {
 #define EMCUTE_N_RETRY          (3U)
 #endif
 
+#ifndef EMCUTE_PUB_WINDOW
+/**
+ * @brief   Number of publishes with QoS 1 or 2 that can be in flight at the
+ *          same time
+ */
+#define EMCUTE_PUB_WINDOW       (4U)
+#endif
+
+#ifndef EMCUTE_QOS2_RX_NUMOF
+/**
+ * @brief   Number of received publishes with QoS 2 that can be waiting for
+ *          their release by the gateway at the same time
+ *
+ * Used to deliver messages retransmitted by the gateway only once.
+ */
+#define EMCUTE_QOS2_RX_NUMOF    (2U)
+#endif
+
 /**
  * @brief   MQTT-SN flags
  *
@@ -198,7 +229,8 @@ enum {
     EMCUTE_REJECT   = -2,       /**< error: operation was rejected by broker */
     EMCUTE_OVERFLOW = -3,       /**< error: ran out of buffer space */
     EMCUTE_TIMEOUT  = -4,       /**< error: timeout */
-    EMCUTE_NOTSUP   = -5        /**< error: feature not supported */
+    EMCUTE_NOTSUP   = -5,       /**< error: feature not supported */
+    EMCUTE_BUSY     = -6        /**< error: too many publishes in flight */
 };
 
 /**
@@ -218,6 +250,18 @@ typedef struct {
  */
 typedef void(*emcute_cb_t)(const emcute_topic_t *topic, void *data, size_t len);
 
+/**
+ * @brief   Signature for callbacks fired when a publish is done
+ *
+ * Called in the context of the emCute thread or the thread calling
+ * emcute_discon().
+ *
+ * @param[in] arg       argument given to emcute_pub_async()
+ * @param[in] res       EMCUTE_OK, if the publish was acknowledged, an error
+ *                      code as returned by emcute_pub() otherwise
+ */
+typedef void(*emcute_pub_cb_t)(void *arg, int res);
+
 /**
  * @brief   Data-structure for keeping track of topics we register to
  */
@@ -255,6 +299,8 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
 /**
  * @brief   Disconnect from the gateway we are currently connected to
  *
+ * Publishes still in flight are done with EMCUTE_NOGW.
+ *
  * @return  EMCUTE_OK on success
  * @return  EMCUTE_GW if not connected to a gateway
  * @return  EMCUTE_TIMEOUT on response timeout
@@ -277,6 +323,9 @@ int emcute_reg(emcute_topic_t *topic);
 /**
  * @brief   Publish data on the given topic
  *
+ * With QoS 1 or 2 this function blocks until the publish is acknowledged,
+ * and until there is room in the window of publishes in flight.
+ *
  * @param[in] topic     topic to send data to, topic **must** be registered
  *                      (topic.id **must** populated).
  * @param[in] buf       data to publish
@@ -293,6 +342,32 @@ int emcute_reg(emcute_topic_t *topic);
 int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
                unsigned flags);
 
+/**
+ * @brief   Publish data on the given topic without waiting for the
+ *          acknowledgment
+ *
+ * With QoS 1 or 2 the message takes one of @ref EMCUTE_PUB_WINDOW slots
+ * until it is acknowledged, which is reported to @p cb. With QoS 0 the
+ * message is just sent and @p cb is not called.
+ *
+ * @param[in] topic     topic to send data to, topic **must** be registered
+ *                      (topic.id **must** populated).
+ * @param[in] buf       data to publish, **must** stay valid until @p cb is
+ *                      called, as it is needed for retransmissions
+ * @param[in] len       length of @p data in bytes
+ * @param[in] flags     flags used for publication, allowed are QoS and retain
+ * @param[in] cb        called when done, **must** be set for QoS 1 and 2
+ * @param[in] arg       argument for @p cb
+ *
+ * @return  EMCUTE_OK if the message was sent
+ * @return  EMCUTE_NOGW if not connected to a gateway
+ * @return  EMCUTE_OVERFLOW if length of data exceeds @ref EMCUTE_BUFSIZE
+ * @return  EMCUTE_NOTSUP on unsupported flag values
+ * @return  EMCUTE_BUSY if @ref EMCUTE_PUB_WINDOW publishes are in flight
+ */
+int emcute_pub_async(emcute_topic_t *topic, const void *buf, size_t len,
+                     unsigned flags, emcute_pub_cb_t cb, void *arg);
+
 /**
  * @brief   Subscribe to the given topic
  *
@@ -45,9 +45,23 @@
  *
  * gcoap allows an application to specify a collection of request resource paths
  * it wants to be notified about. Create an array of resources (coap_resource_t
- * structs). Note that the elements must be ordered alphabetically with respect
- * to the resource path. Use gcoap_register_listener() at application startup
- * to pass in these resources, wrapped in a gcoap_listener_t.
+ * structs). Use gcoap_register_listener() at application startup to pass in
+ * these resources, wrapped in a gcoap_listener_t.
+ *
+ * gcoap_register_listener() adds the resources to a trie of path segments,
+ * so a request is matched against its Uri-Path options segment by segment,
+ * independently of the number of registered resources. The size of the trie
+ * is configured with @ref GCOAP_RESOURCES_MAX and @ref GCOAP_PATH_NODES_MAX.
+ * Besides exact paths, two kinds of patterns are supported:
+ *
+ * - A path segment `*` matches any single segment, e.g. `/3/ *` (without the
+ *   blank) matches `/3/0` and `/3/1`, but neither `/3` nor `/3/0/1`.
+ * - A resource with @ref GCOAP_MATCH_SUBTREE in coap_resource_t::methods
+ *   matches its path and any path below it, e.g. `/fw` matches `/fw` and
+ *   `/fw/slot/0`.
+ *
+ * More specific resources take precedence: an exact segment is preferred
+ * over `*` and a longer path over a subtree resource.
  *
  * gcoap itself defines a resource for `/.well-known/core` discovery, which
  * lists all of the registered paths.
@@ -80,6 +94,23 @@
  * described above. In fact, the gcoap_response() function is inline, and uses
  * those two functions.
  *
+ * gcoap_finish() writes the options behind the header and then moves the
+ * payload to them. To write the payload in place, add the options with the
+ * nanocoap `coap_opt_add_*()` functions right after gcoap_resp_init(), e.g.
+ * coap_opt_add_format(), and call coap_opt_finish() with
+ * COAP_OPT_FINISH_PAYLOAD before writing the payload. Then gcoap_finish(),
+ * with COAP_FORMAT_NONE as format, only sets the length.
+ *
+ * ### Slow handlers ###
+ *
+ * By default, callbacks run on the gcoap thread, so no other message is
+ * received while a callback runs. With the `gcoap_worker` module, requests
+ * are handed to a pool of @ref GCOAP_WORKER_NUMOF worker threads instead, and
+ * the gcoap thread keeps receiving responses and further requests. Up to
+ * @ref GCOAP_WORKER_QUEUE_SIZE requests wait for a worker; gcoap answers
+ * further requests with 5.03 (Service Unavailable). With more than one
+ * worker, callbacks must be thread-safe.
+ *
  * ## Client Operation ##
  *
  * Client operation includes two phases:  creating and sending a request, and
@@ -107,9 +138,18 @@
  * as described above. The gcoap_request() function is inline, and uses those
  * two functions.
  *
+ * As for a response, further options can be added with the nanocoap
+ * `coap_opt_add_*()` functions after gcoap_req_init(), so the payload is
+ * written in place after coap_opt_finish(). Options are kept in order of
+ * their numbers, regardless of the order they are added in.
+ *
  * Finally, call gcoap_req_send2() for the destination endpoint, as well as a
  * callback function for the host's response.
  *
+ * Up to @ref GCOAP_NSTART requests to the same server may await a response at
+ * a time (see RFC 7252, section 4.7); gcoap_req_send2() fails for further
+ * requests.
+ *
  * ### Handling the response ###
  *
  * When gcoap receives the response to a request, it executes the callback from
@@ -274,6 +314,21 @@ extern "C" {
 #define GCOAP_REQ_WAITING_MAX   (2)
 #endif
 
+/**
+ * @brief   Maximum number of requests awaiting a response from the same
+ *          server (NSTART, see RFC 7252, section 4.7)
+ *
+ * Values larger than 1 require congestion control: while a confirmable
+ * request to a server is retransmitted, gcoap falls back to a single
+ * outstanding request for that server.
+ *
+ * Defaults to @ref GCOAP_REQ_WAITING_MAX, so all open requests may go to the
+ * same server as before. Set it to 1 for the default of RFC 7252.
+ */
+#ifndef GCOAP_NSTART
+#define GCOAP_NSTART            (GCOAP_REQ_WAITING_MAX)
+#endif
+
 /**
  * @brief   Maximum length in bytes for a token
  */
@@ -423,12 +478,86 @@ extern "C" {
 #define GCOAP_RESEND_BUFS_MAX      (1)
 #endif
 
+/**
+ * @brief   Number of worker threads handling requests with `gcoap_worker`
+ */
+#ifndef GCOAP_WORKER_NUMOF
+#define GCOAP_WORKER_NUMOF      (1)
+#endif
+
+/**
+ * @brief   Number of requests waiting for a worker with `gcoap_worker`
+ *
+ * @note    Must be a power of 2.
+ */
+#ifndef GCOAP_WORKER_QUEUE_SIZE
+#define GCOAP_WORKER_QUEUE_SIZE (2)
+#endif
+
+/**
+ * @brief   Stack size of a worker thread with `gcoap_worker`
+ */
+#ifndef GCOAP_WORKER_STACK_SIZE
+#define GCOAP_WORKER_STACK_SIZE (GCOAP_STACK_SIZE)
+#endif
+
+/**
+ * @brief   Priority of the worker threads with `gcoap_worker`
+ *
+ * Lower than the gcoap thread, so slow callbacks don't delay receiving.
+ */
+#ifndef GCOAP_WORKER_PRIO
+#define GCOAP_WORKER_PRIO       (THREAD_PRIORITY_MAIN)
+#endif
+
+/**
+ * @brief   Maximum number of resources of all listeners, including
+ *          `/.well-known/core`
+ *
+ * The default leaves room for the resources of a typical application besides
+ * `/.well-known/core`. On 32-bit platforms each resource takes 12 bytes, plus
+ * 24 bytes for its share of @ref GCOAP_PATH_NODES_MAX, so the default trie
+ * takes 576 bytes. gcoap_register_listener() fails with -ENOMEM if the
+ * resources do not fit, so increase this for applications with more
+ * resources.
+ */
+#ifndef GCOAP_RESOURCES_MAX
+#define GCOAP_RESOURCES_MAX     (16)
+#endif
+
+/**
+ * @brief   Maximum number of distinct path segments in the resource trie
+ *
+ * Each resource needs at most one node per segment of its path; common
+ * prefixes of paths share nodes.
+ */
+#ifndef GCOAP_PATH_NODES_MAX
+#define GCOAP_PATH_NODES_MAX    (2 * GCOAP_RESOURCES_MAX)
+#endif
+
+/**
+ * @brief   Flag for coap_resource_t::methods to match the resource's path
+ *          as prefix
+ *
+ * Takes the bit of request code 0.16, which is never matched as a method.
+ */
+#define GCOAP_MATCH_SUBTREE     (0x8000)
+
+/**
+ * @name    Return values for gcoap_find_resource()
+ * @{
+ */
+#define GCOAP_RESOURCE_FOUND        (0)
+#define GCOAP_RESOURCE_WRONG_METHOD (-1)
+#define GCOAP_RESOURCE_NO_PATH      (-2)
+/** @} */
+
 /**
  * @brief   A modular collection of resources for a server
  */
 typedef struct gcoap_listener {
     coap_resource_t *resources;     /**< First element in the array of
-                                     *   resources; must order alphabetically */
+                                     *   resources */
     size_t resources_len;           /**< Length of array */
     struct gcoap_listener *next;    /**< Next listener in list */
 } gcoap_listener_t;
@@ -453,7 +582,7 @@ typedef struct {
 /**
  * @brief   Memo to handle a response for a request
  */
-typedef struct {
+typedef struct gcoap_request_memo {
     unsigned state;                     /**< State of this memo, a GCOAP_MEMO... */
     int send_limit;                     /**< Remaining resends, 0 if none;
                                              GCOAP_SEND_LIMIT_NON if non-confirmable */
@@ -467,6 +596,8 @@ typedef struct {
     gcoap_resp_handler_t resp_handler;  /**< Callback for the response */
     xtimer_t response_timer;            /**< Limits wait for response */
     msg_t timeout_msg;                  /**< For response timer */
+    struct gcoap_request_memo *next;    /**< Next memo in the same bucket of
+                                             the token hash table */
 } gcoap_request_memo_t;
 
 /**
@@ -484,6 +615,8 @@ typedef struct {
  *
  * Must call once before first use.
  *
+ * With `gcoap_worker`, also starts the worker threads.
+ *
  * @return  PID of the gcoap thread on success.
  * @return  -EEXIST, if thread already has been created.
  * @return  -EINVAL, if the IP port already is in use.
@@ -493,9 +626,32 @@ kernel_pid_t gcoap_init(void);
 /**
  * @brief   Starts listening for resource paths
  *
+ * @pre     The paths of all resources start with '/'.
+ *
  * @param[in] listener  Listener containing the resources.
+ *
+ * @return  0 on success.
+ * @return  -ENOMEM, if the resources do not fit into the trie (see
+ *          @ref GCOAP_RESOURCES_MAX and @ref GCOAP_PATH_NODES_MAX), none of
+ *          them is registered then.
  */
-void gcoap_register_listener(gcoap_listener_t *listener);
+int gcoap_register_listener(gcoap_listener_t *listener);
+
+/**
+ * @brief   Finds the resource a request is dispatched to
+ *
+ * @param[in] pdu           Parsed request.
+ * @param[out] resource_ptr The resource, if found.
+ * @param[out] listener_ptr The listener of the resource, if found.
+ *
+ * @return  GCOAP_RESOURCE_FOUND, if a resource was found.
+ * @return  GCOAP_RESOURCE_WRONG_METHOD, if resources match the path of
+ *          @p pdu, but none of them accepts its method.
+ * @return  GCOAP_RESOURCE_NO_PATH, if no resource matches the path of
+ *          @p pdu.
+ */
+int gcoap_find_resource(coap_pkt_t *pdu, coap_resource_t **resource_ptr,
+                        gcoap_listener_t **listener_ptr);
 
 /**
  * @brief   Initializes a CoAP request PDU on a buffer.
@@ -557,7 +713,8 @@ static inline ssize_t gcoap_request(coap_pkt_t *pdu, uint8_t *buf, size_t len,
  * @param[in] resp_handler  Callback when response received, may be NULL
  *
  * @return  length of the packet
- * @return  0 if cannot send
+ * @return  0 if cannot send, e.g. if @ref GCOAP_REQ_WAITING_MAX requests or
+ *          @ref GCOAP_NSTART requests to @p remote await a response
  */
 size_t gcoap_req_send2(const uint8_t *buf, size_t len,
                        const sock_udp_ep_t *remote,
@@ -584,6 +741,7 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len, const ipv6_addr_t *addr,
  * @brief   Initializes a CoAP response packet on a buffer
  *
  * Initializes payload location within the buffer based on packet setup.
+ * The options of the request can't be read afterwards.
  *
  * @param[out] pdu      Response metadata
  * @param[in] buf       Buffer containing the PDU
@@ -683,6 +841,10 @@ int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf);
  * To add multiple Uri-Query options, simply call this function multiple times.
  * The Uri-Query options will be added in the order those calls.
  *
+ * The option is written to @p pdu right away, in front of the payload. So
+ * when the payload is written in place, call this function before
+ * coap_opt_finish(), like the other `coap_opt_add_*()` functions.
+ *
  * @param[out] pdu      The package that is being build
  * @param[in]  key      Key to add to the query string
  * @param[in]  val      Value to assign to @p key (may be NULL)
@@ -690,7 +852,8 @@ int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf);
  * @pre     ((pdu != NULL) && (key != NULL))
  *
  * @return  overall length of new query string
- * @return  -1 on error
+ * @return  -1 on error, e.g. if the option doesn't fit in front of the
+ *          payload or the options were finished already
  */
 int gcoap_add_qstring(coap_pkt_t *pdu, const char *key, const char *val);
 
@@ -15,18 +15,19 @@
  * @file
  * @brief   ICMPv6 error message definitions
  *
+ * The invoking packet of an error message is a packet as received by the
+ * IPv6 layer, i.e. with its snips in receive order: the (unparsed) payload
+ * first, the IPv6 header and the interface header last.
+ *
  * @author  Martine Lenders <mlenders@inf.fu-berlin.de>
  */
 #ifndef NET_GNRC_ICMPV6_ERROR_H
 #define NET_GNRC_ICMPV6_ERROR_H
 
-#include <errno.h>
 #include <stdint.h>
 
 #include "net/icmpv6.h"
 #include "net/ipv6/hdr.h"
-#include "net/gnrc/ipv6.h"
-#include "net/gnrc/netapi.h"
 #include "net/gnrc/pkt.h"
 
 #ifdef __cplusplus
@@ -37,7 +38,7 @@ extern "C" {
  * @brief   Builds an ICMPv6 destination unreachable message for sending.
  *
  * @param[in] code      The code for the message @see net/icmpv6.h.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received.
  *
  * @return  The destination unreachable message on success.
  * @return  NULL, on failure.
@@ -48,7 +49,7 @@ gnrc_pktsnip_t *gnrc_icmpv6_error_dst_unr_build(uint8_t code, gnrc_pktsnip_t *or
  * @brief   Builds an ICMPv6 packet too big message for sending.
  *
  * @param[in] mtu       The maximum transission unit of the next-hop link.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received.
  *
  * @return  The packet too big message on success.
  * @return  NULL, on failure.
@@ -59,7 +60,7 @@ gnrc_pktsnip_t *gnrc_icmpv6_error_pkt_too_big_build(uint32_t mtu, gnrc_pktsnip_t
  * @brief   Builds an ICMPv6 time exceeded message for sending.
  *
  * @param[in] code      The code for the message @see net/icmpv6.h.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received.
  *
  * @return  The time exceeded message on success.
  * @return  NULL, on failure.
@@ -71,7 +72,7 @@ gnrc_pktsnip_t *gnrc_icmpv6_error_time_exc_build(uint8_t code, gnrc_pktsnip_t *o
  *
  * @param[in] code      The code for the message @see net/icmpv6.h.
  * @param[in] ptr       Pointer to the errorneous octet in @p orig_pkt.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received.
  *
  * @return  The parameter problem message on success.
  * @return  NULL, on failure.
@@ -82,84 +83,51 @@ gnrc_pktsnip_t *gnrc_icmpv6_error_param_prob_build(uint8_t code, void *ptr,
 /**
  * @brief   Sends an ICMPv6 destination unreachable message for sending.
  *
+ * The message is sent to the source of @p orig_pkt, via the interface
+ * @p orig_pkt was received on. No message is sent in reply to a multicast
+ * packet (see [RFC 4443, section 2.4 (e)](https://tools.ietf.org/html/rfc4443#section-2.4)).
+ *
  * @param[in] code      The code for the message @see net/icmpv6.h.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received. Is released.
  */
-static inline void gnrc_icmpv6_error_dst_unr_send(uint8_t code, gnrc_pktsnip_t *orig_pkt)
-{
-    gnrc_pktsnip_t *pkt = gnrc_icmpv6_error_dst_unr_build(code, orig_pkt);
-
-    if (pkt != NULL) {
-        gnrc_netapi_send(gnrc_ipv6_pid, pkt);
-    }
-#ifdef MODULE_GNRC_PKTBUF
-    gnrc_pktbuf_release_error(orig_pkt, EHOSTUNREACH);
-#else
-    (void)orig_pkt;
-#endif
-}
+void gnrc_icmpv6_error_dst_unr_send(uint8_t code, gnrc_pktsnip_t *orig_pkt);
 
 /**
  * @brief   Sends an ICMPv6 packet too big message for sending.
  *
+ * The message is sent to the source of @p orig_pkt, via the interface
+ * @p orig_pkt was received on.
+ *
  * @param[in] mtu       The maximum transission unit of the next-hop link.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received. Is released.
  */
-static inline void gnrc_icmpv6_error_pkt_too_big_send(uint32_t mtu, gnrc_pktsnip_t *orig_pkt)
-{
-    gnrc_pktsnip_t *pkt = gnrc_icmpv6_error_pkt_too_big_build(mtu, orig_pkt);
-
-    if (pkt != NULL) {
-        gnrc_netapi_send(gnrc_ipv6_pid, pkt);
-    }
-#ifdef MODULE_GNRC_PKTBUF
-    gnrc_pktbuf_release_error(orig_pkt, EMSGSIZE);
-#else
-    (void)orig_pkt;
-#endif
-}
+void gnrc_icmpv6_error_pkt_too_big_send(uint32_t mtu, gnrc_pktsnip_t *orig_pkt);
 
 /**
  * @brief   Sends an ICMPv6 time exceeded message for sending.
  *
+ * The message is sent to the source of @p orig_pkt, via the interface
+ * @p orig_pkt was received on. No message is sent in reply to a multicast
+ * packet.
+ *
  * @param[in] code      The code for the message @see net/icmpv6.h.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received. Is released.
  */
-static inline void gnrc_icmpv6_error_time_exc_send(uint8_t code, gnrc_pktsnip_t *orig_pkt)
-{
-    gnrc_pktsnip_t *pkt = gnrc_icmpv6_error_time_exc_build(code, orig_pkt);
-
-    if (pkt != NULL) {
-        gnrc_netapi_send(gnrc_ipv6_pid, pkt);
-    }
-#ifdef MODULE_GNRC_PKTBUF
-    gnrc_pktbuf_release_error(orig_pkt, ETIMEDOUT);
-#else
-    (void)orig_pkt;
-#endif
-}
+void gnrc_icmpv6_error_time_exc_send(uint8_t code, gnrc_pktsnip_t *orig_pkt);
 
 /**
  * @brief   Sends an ICMPv6 parameter problem message for sending.
  *
+ * The message is sent to the source of @p orig_pkt, via the interface
+ * @p orig_pkt was received on. No message is sent in reply to a multicast
+ * packet, unless @p code is @ref ICMPV6_ERROR_PARAM_PROB_OPT.
+ *
  * @param[in] code      The code for the message @see net/icmpv6.h.
  * @param[in] ptr       Pointer to the errorneous octet in @p orig_pkt.
- * @param[in] orig_pkt  The invoking packet.
+ * @param[in] orig_pkt  The invoking packet, as received. Is released.
  */
-static inline void gnrc_icmpv6_error_param_prob_send(uint8_t code, void *ptr,
-                                                     gnrc_pktsnip_t *orig_pkt)
-{
-    gnrc_pktsnip_t *pkt = gnrc_icmpv6_error_param_prob_build(code, ptr, orig_pkt);
-
-    if (pkt != NULL) {
-        gnrc_netapi_send(gnrc_ipv6_pid, pkt);
-    }
-#ifdef MODULE_GNRC_PKTBUF
-    gnrc_pktbuf_release_error(orig_pkt, EINVAL);
-#else
-    (void)orig_pkt;
-#endif
-}
+void gnrc_icmpv6_error_param_prob_send(uint8_t code, void *ptr,
+                                       gnrc_pktsnip_t *orig_pkt);
 
 #ifdef __cplusplus
 }
@@ -24,6 +24,7 @@
 #define NET_GNRC_IPV6_EXT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -35,6 +36,33 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Maximum number of extension headers a
+ *          @ref gnrc_ipv6_ext_desc_t can describe
+ */
+#ifndef GNRC_IPV6_EXT_DESC_NUMOF
+#define GNRC_IPV6_EXT_DESC_NUMOF    (4U)
+#endif
+
+/**
+ * @brief   Descriptor of the extension header chain of a packet
+ *
+ * Filled by gnrc_ipv6_ext_parse() in a single pass over the chain, so the
+ * headers can be located without marking each of them as a snip of its own.
+ */
+typedef struct {
+    /**
+     * @brief   The extension headers in order of appearance
+     */
+    struct {
+        uint16_t offset;    /**< offset of the header from the chain's start */
+        uint8_t type;       /**< @ref net_protnum of the header */
+    } hdrs[GNRC_IPV6_EXT_DESC_NUMOF];
+    uint16_t len;           /**< length of the whole chain */
+    uint8_t num;            /**< number of extension headers in gnrc_ipv6_ext_desc_t::hdrs */
+    uint8_t nh;             /**< @ref net_protnum of the header following the chain */
+} gnrc_ipv6_ext_desc_t;
+
 /**
  * @brief   Demultiplex extension headers according to @p nh.
  *
@@ -48,6 +76,16 @@ extern "C" {
  * This situation may happen when the packet has a source routing extension
  * header (RFC 6554), and the packet is forwarded from an interface to another.
  *
+ * If no-one is registered (with @ref GNRC_NETTYPE_IPV6 and the header's
+ * @ref net_protnum as demultiplexing context) for any extension header
+ * following the first one and the packet does not need to be routed further,
+ * the whole chain is walked in one pass (see gnrc_ipv6_ext_parse()) and
+ * marked as a single @ref GNRC_NETTYPE_IPV6_EXT snip. Otherwise every
+ * extension header is marked as a snip of its own, and the packet is
+ * dispatched to those registered after each header. Registrations for the
+ * header following the chain, e.g. raw sockets for UDP, do not prevent the
+ * single pass. Use gnrc_ipv6_ext_get() to find a header in either case.
+ *
  * @internal
  *
  * @param[in] netif     The receiving interface.
@@ -75,6 +113,45 @@ void gnrc_ipv6_ext_demux(gnrc_netif_t *netif,
 gnrc_pktsnip_t *gnrc_ipv6_ext_build(gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *next,
                                     uint8_t nh, size_t size);
 
+/**
+ * @brief   Walks an extension header chain in a contiguous buffer
+ *
+ * The walk stops at the first header that is not an extension header or at
+ * the end of @p data, whichever comes first. Authentication headers and
+ * encapsulating security payload headers are not supported.
+ *
+ * @param[out] desc The descriptor of the chain.
+ * @param[in] data  Start of the chain, i.e. the data following the IPv6
+ *                  header.
+ * @param[in] len   Length of @p data.
+ * @param[in] nh    @ref net_protnum of the header at @p data (next header
+ *                  field of the IPv6 header).
+ *
+ * @return  0, on success. gnrc_ipv6_ext_desc_t::num may be 0 if @p nh is not
+ *          an extension header.
+ * @return  -EBADMSG, if a header exceeds @p len.
+ * @return  -ENOBUFS, if there are more than @ref GNRC_IPV6_EXT_DESC_NUMOF
+ *          extension headers.
+ * @return  -ENOTSUP, if the chain contains an authentication header or an
+ *          encapsulating security payload header.
+ */
+int gnrc_ipv6_ext_parse(gnrc_ipv6_ext_desc_t *desc, const uint8_t *data,
+                        size_t len, uint8_t nh);
+
+/**
+ * @brief   Gets an extension header of a received packet
+ *
+ * Works regardless of whether the extension headers were marked as one snip
+ * each or as a single snip for the whole chain.
+ *
+ * @param[in] pkt       A received packet with marked IPv6 header.
+ * @param[in] protnum   @ref net_protnum of the extension header.
+ *
+ * @return  The first extension header of type @p protnum in @p pkt.
+ * @return  NULL, if @p pkt has no such extension header.
+ */
+ipv6_ext_t *gnrc_ipv6_ext_get(gnrc_pktsnip_t *pkt, uint8_t protnum);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,13 +29,22 @@
  * spend less preamble packets (also called WR packet, i.e., wake-up-request, in
  * LWMAC) for initiating a hand-shaking procedure for transmitting a data packet,
  * compared to the first time it talks to the receiver.
+ * The sender learns the phase from the WA packet of the receiver and corrects it
+ * by the drift it observes between consecutive WAs (see
+ * @ref GNRC_LWMAC_PHASE_DRIFT_WEIGHT). It starts the WR stream just before the
+ * predicted wake-up and, unlike an unlocked sender, stops it at the end of the
+ * receiver's wake-up period, widened by the uncertainty of the phase (see
+ * @ref GNRC_LWMAC_PHASE_GUARD_PPM).
  *
  * ## Burst transmission
  * LWMAC adopts pending-bit technique to enhance its throughput. Namely, in case
  * of having multi packets for the receiver, a sender uses the pending-bit flag
  * embedded in the MAC header to instruct this situation, and the buffered packets
  * will be transmitted in a continuous sequence, back to back, to the receiver in
- * one shot.
+ * one shot. The receiver stays awake as long as the sender announces further
+ * packets, even close to the end of its cycle. The burst is managed by the
+ * gnrc_mac burst helpers, gnrc_mac_tx_burst_pending() on the sender and
+ * gnrc_mac_rx_set_burst() on the receiver side.
  *
  * ## Auto wake-up extension
  * LWMAC adopts auto wake-up extension scheme based on timeout (like T-MAC). In short,
@@ -190,6 +199,50 @@ extern "C" {
 #define GNRC_LWMAC_WR_PREPARATION_US         ((3U *US_PER_MS))
 #endif
 
+/**
+ * @brief Clock tolerance (in ppm) assumed between a sender and its receiver.
+ *
+ * The wake-up phase learned from a WA becomes less certain the longer it has
+ * not been refreshed, since the clocks of sender and receiver drift apart.
+ * The sender starts the WR stream @ref GNRC_LWMAC_WR_PREPARATION_US plus a
+ * guard time of this tolerance applied to the time since the phase was learned
+ * ahead of the predicted wake-up of the receiver, and stops it at the same
+ * guard time after the predicted end of the wake-up period. Once the guard
+ * time grows beyond half the wake-up interval, i.e., the WR stream would
+ * cover the whole interval, the phase is regarded unknown.
+ */
+#ifndef GNRC_LWMAC_PHASE_GUARD_PPM
+#define GNRC_LWMAC_PHASE_GUARD_PPM           (100U)
+#endif
+
+/**
+ * @brief Weight of the old value when smoothing the phase drift of a receiver.
+ *
+ * Every WA of a phase-locked receiver yields a sample of the drift of its
+ * phase per wake-up interval, i.e., the offset between the predicted and the
+ * actual phase divided by the intervals passed since the last WA. The drift
+ * is smoothed by an exponentially weighted moving average, that adds
+ * 1 / @ref GNRC_LWMAC_PHASE_DRIFT_WEIGHT of the new sample. The predicted
+ * phase of the receiver is corrected by the drift.
+ */
+#ifndef GNRC_LWMAC_PHASE_DRIFT_WEIGHT
+#define GNRC_LWMAC_PHASE_DRIFT_WEIGHT        (4U)
+#endif
+
+/**
+ * @brief Phase-locked transmission attempts without a WA after which the
+ *        phase of a receiver is regarded unknown.
+ *
+ * If a phase-locked WR stream misses the receiver, e.g., since it reselected
+ * its wake-up phase, the next attempt is also phase-locked. After
+ * @ref GNRC_LWMAC_PHASE_MAX_MISSES consecutive misses the phase is dropped and
+ * the sender streams WRs for a full @ref GNRC_LWMAC_PREAMBLE_DURATION_US again
+ * to relearn it.
+ */
+#ifndef GNRC_LWMAC_PHASE_MAX_MISSES
+#define GNRC_LWMAC_PHASE_MAX_MISSES          (2U)
+#endif
+
 /**
  * @brief How long to wait after a WA for data to come in.
  *
@@ -115,6 +115,69 @@ static inline void gnrc_netif_set_tx_feedback(gnrc_netif_t *netif,
 bool gnrc_mac_queue_tx_packet(gnrc_mac_tx_t *tx, uint32_t priority, gnrc_pktsnip_t *pkt);
 #endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) || defined(DOXYGEN) */
 
+#if ((GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0)) || defined(DOXYGEN)
+/**
+ * @brief Starts a burst transfer to gnrc_mac_tx_t::current_neighbor.
+ *
+ *        Once a duty-cycled MAC protocol has established a rendezvous with a
+ *        neighbor, it may send all packets queued for that neighbor back-to-back
+ *        instead of one packet per rendezvous. Every frame followed by another
+ *        one of the burst carries a frame-pending indication, so the receiver
+ *        stays awake (see gnrc_mac_rx_set_burst()).
+ *
+ * @param[in,out] tx        gnrc_mac transmission management object
+ */
+static inline void gnrc_mac_tx_burst_start(gnrc_mac_tx_t *tx)
+{
+    tx->burst_count = 0;
+}
+
+/**
+ * @brief Decides if the frame about to be sent to gnrc_mac_tx_t::current_neighbor
+ *        is followed by another one of the burst.
+ *
+ *        Broadcasts are never sent in bursts.
+ *
+ * @pre `tx->current_neighbor != NULL`
+ *
+ * @param[in,out] tx        gnrc_mac transmission management object
+ * @param[in]     limit     maximum number of frames following the first one
+ *                          of a burst
+ *
+ * @return                  true, if the frame shall carry the frame-pending
+ *                          indication. The following frame is then accounted
+ *                          to the burst.
+ * @return                  false, if the burst ends with the frame.
+ */
+bool gnrc_mac_tx_burst_pending(gnrc_mac_tx_t *tx, unsigned limit);
+#endif /* ((GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0)) || defined(DOXYGEN) */
+
+#if ((GNRC_MAC_RX_QUEUE_SIZE != 0) || (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0)) || defined(DOXYGEN)
+/**
+ * @brief Records if the sender of the last received frame announced another
+ *        frame of a burst.
+ *
+ * @param[in,out] rx        gnrc_mac reception management object
+ * @param[in]     pending   the frame-pending indication of the last frame
+ */
+static inline void gnrc_mac_rx_set_burst(gnrc_mac_rx_t *rx, bool pending)
+{
+    rx->burst = pending;
+}
+
+/**
+ * @brief Checks if the receiver should stay awake for another frame of a burst.
+ *
+ * @param[in] rx            gnrc_mac reception management object
+ *
+ * @return                  the frame-pending indication of the last frame
+ */
+static inline bool gnrc_mac_rx_get_burst(const gnrc_mac_rx_t *rx)
+{
+    return rx->burst;
+}
+#endif /* ((GNRC_MAC_RX_QUEUE_SIZE != 0) || (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0)) || defined(DOXYGEN) */
+
 #if (GNRC_MAC_RX_QUEUE_SIZE != 0) || defined(DOXYGEN)
 /**
  * @brief Queues the packet into the reception packet queue in netdev_t::rx.
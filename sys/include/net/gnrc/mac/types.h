@@ -80,6 +80,8 @@ typedef struct {
     gnrc_pktsnip_t *dispatch_buffer[GNRC_MAC_DISPATCH_BUFFER_SIZE];      /**< dispatch packet buffer */
 #endif /* (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0) || defined(DOXYGEN) */
 
+    bool burst;                   /**< The sender announced another frame of a burst */
+
 #ifdef MODULE_GNRC_LWMAC
     gnrc_lwmac_l2_addr_t l2_addr; /**< Records the sender's address */
     gnrc_lwmac_rx_state_t state;  /**< LWMAC specific internal reception state */
@@ -102,15 +104,18 @@ typedef struct {
         PRIORITY_PKTQUEUE_INIT, \
         { PRIORITY_PKTQUEUE_NODE_INIT(0, NULL) }, \
         { NULL }, \
+        false, \
 }
 #elif (GNRC_MAC_RX_QUEUE_SIZE != 0) && (GNRC_MAC_DISPATCH_BUFFER_SIZE == 0) || defined(DOXYGEN)
 #define GNRC_MAC_RX_INIT { \
         PRIORITY_PKTQUEUE_INIT, \
         { PRIORITY_PKTQUEUE_NODE_INIT(0, NULL) }, \
+        false, \
 }
 #elif (GNRC_MAC_RX_QUEUE_SIZE == 0) && (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0) || defined(DOXYGEN)
 #define GNRC_MAC_RX_INIT { \
         { NULL }, \
+        false, \
 }
 #endif  /* ((GNRC_MAC_RX_QUEUE_SIZE != 0) && (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0)) || defined(DOXYGEN) */
 #endif  /* ((GNRC_MAC_RX_QUEUE_SIZE != 0) || (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0)) || defined(DOXYGEN) */
@@ -128,6 +133,13 @@ typedef struct {
     gnrc_priority_pktqueue_t queue;                  /**< TX queue for this particular Neighbor */
 #endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) || defined(DOXYGEN) */
 
+#ifdef MODULE_GNRC_LWMAC
+    uint32_t phase_sync;    /**< RTT ticks when the phase was last learned. */
+    int32_t phase_drift;    /**< Neighbor's phase drift per wake-up interval
+                                 in 1/256 RTT ticks. */
+    uint8_t phase_misses;   /**< Phase-locked attempts not answered by a WA. */
+#endif
+
 #ifdef MODULE_GNRC_GOMACH
     uint16_t pub_chanseq;   /**< Neighbor's current public channel sequence. */
     uint32_t cp_phase;      /**< Neighbor's wake-up phase. */
@@ -188,6 +200,10 @@ typedef struct {
 
     gnrc_priority_pktqueue_node_t _queue_nodes[GNRC_MAC_TX_QUEUE_SIZE]; /**< Shared buffer for TX queue nodes */
     gnrc_pktsnip_t *packet;                                             /**< currently scheduled packet for sending */
+#if (GNRC_MAC_NEIGHBOR_COUNT != 0) || defined(DOXYGEN)
+    uint8_t burst_count;                                                /**< Frames following the first one in the
+                                                                             current burst */
+#endif /* (GNRC_MAC_NEIGHBOR_COUNT != 0) || defined(DOXYGEN) */
 #endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) || defined(DOXYGEN) */
 
 #ifdef MODULE_GNRC_LWMAC
@@ -195,7 +211,6 @@ typedef struct {
     uint32_t wr_sent;                  /**< Count how many WRs were sent until WA received */
     uint32_t timestamp;                /**< Records the receiver's current phase */
     uint8_t bcast_seqnr;               /**< Sequence number for broadcast data to filter at receiver */
-    uint8_t tx_burst_count;            /**< Count how many consecutive packets have been transmitted */
     uint8_t tx_retry_count;            /**< Count how many Tx-retrials have been executed before packet drop */
 #endif
 
@@ -225,6 +240,7 @@ typedef struct {
         NULL, \
         { PRIORITY_PKTQUEUE_NODE_INIT(0, NULL) }, \
         NULL, \
+        0, \
 }
 #elif ((GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT == 0)) || defined(DOXYGEN)
 #define GNRC_MAC_TX_INIT { \
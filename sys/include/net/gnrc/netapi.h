@@ -110,7 +110,8 @@ typedef struct {
  * @param[in] pkt       pointer into the packet buffer holding the data to send
  *
  * @return              1 if packet was successfully delivered
- * @return              -1 on error (invalid PID or no space in queue)
+ * @return              0 if there is no space in the queue of @p pid
+ * @return              -1 if @p pid is invalid
  */
 int gnrc_netapi_send(kernel_pid_t pid, gnrc_pktsnip_t *pkt);
 
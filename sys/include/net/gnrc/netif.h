@@ -44,7 +44,16 @@
 #ifdef MODULE_GNRC_MAC
 #include "net/gnrc/netif/mac.h"
 #endif
+#ifdef MODULE_GNRC_NETIF_TXQ
+#include "net/gnrc/netif/txq.h"
+#endif
 #include "net/netdev.h"
+#ifdef MODULE_NETSTATS_NEIGHBOR
+#include "net/netstats/neighbor.h"
+#endif
+#ifdef MODULE_NETSTATS_RADIO
+#include "net/netstats/radio.h"
+#endif
 #include "rmutex.h"
 
 #ifdef __cplusplus
@@ -93,6 +102,15 @@ typedef struct {
 #endif
 #if defined(MODULE_GNRC_SIXLOWPAN) || DOXYGEN
     gnrc_netif_6lo_t sixlo;                 /**< 6Lo component */
+#endif
+#if defined(MODULE_GNRC_NETIF_TXQ) || DOXYGEN
+    gnrc_netif_txq_t txq;                   /**< @ref net_gnrc_netif_txq component */
+#endif
+#if defined(MODULE_NETSTATS_NEIGHBOR) || DOXYGEN
+    netstats_nb_table_t nb_stats;           /**< @ref net_netstats_neighbor of the interface */
+#endif
+#if defined(MODULE_NETSTATS_RADIO) || DOXYGEN
+    netstats_radio_t radio_stats;           /**< @ref net_netstats_radio of the interface */
 #endif
     uint8_t cur_hl;                         /**< Current hop-limit for out-going packets */
     uint8_t device_type;                    /**< Device type */
@@ -478,6 +496,39 @@ char *gnrc_netif_addr_to_str(const uint8_t *addr, size_t addr_len, char *out);
  */
 size_t gnrc_netif_addr_from_str(const char *str, uint8_t *out);
 
+#if defined(MODULE_NETSTATS_NEIGHBOR) || DOXYGEN
+/**
+ * @brief   Gets the @ref net_netstats_neighbor of a neighbor
+ *
+ * @pre `(netif != NULL) && (stats != NULL)`
+ *
+ * @param[in] netif         The network interface.
+ * @param[in] l2addr        Link-layer address of the neighbor.
+ * @param[in] l2addr_len    Length of @p l2addr.
+ * @param[out] stats        A copy of the statistics of the neighbor.
+ *
+ * @return  0 on success.
+ * @return  -ENOENT, if @p netif did not send a frame to the neighbor yet.
+ */
+int gnrc_netif_nb_stats_get(gnrc_netif_t *netif, const uint8_t *l2addr,
+                            size_t l2addr_len, netstats_nb_t *stats);
+#endif
+
+#if defined(MODULE_NETSTATS_RADIO) || DOXYGEN
+/**
+ * @brief   Gets the @ref net_netstats_radio of an interface
+ *
+ * @pre `(netif != NULL) && (stats != NULL)`
+ *
+ * @param[in] netif     The network interface.
+ * @param[out] stats    A copy of the statistics, including the time spent in
+ *                      the current state up to now.
+ * @param[in] reset     Reset the statistics of @p netif after the copy.
+ */
+void gnrc_netif_radio_stats_get(gnrc_netif_t *netif, netstats_radio_t *stats,
+                                bool reset);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
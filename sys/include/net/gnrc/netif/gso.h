@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_netif_gso  Generic segmentation offload
+ * @ingroup     net_gnrc_netif
+ * @brief       Send large UDP payloads as a burst of datagrams with one
+ *              header chain
+ *
+ * A sender hands a single packet with a large UDP payload and a segment size
+ * (gnrc_netif_hdr_t::gso_size) down the stack. The IPv6 layer builds the
+ * header chain, selects source address and next hop only once for all of the
+ * payload and skips the checksum. The payload is only split into datagrams of
+ * at most gnrc_netif_hdr_t::gso_size bytes of UDP payload right before it is
+ * handed to the device: in @ref net_gnrc_netif for interfaces without
+ * 6LoWPAN, and in @ref net_gnrc_sixlowpan before header compression
+ * otherwise. Every segment gets a copy of the header chain in which only the
+ * length fields and the UDP checksum are updated.
+ *
+ * For 6LoWPAN interfaces the segment size should be chosen so that segments
+ * fit into a single link-layer frame; segments that still need
+ * fragmentation are sent one after another, which serializes the burst.
+ *
+ * @note    Packets addressed to the node itself are delivered unsegmented.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Generic segmentation offload definitions
+ */
+#ifndef NET_GNRC_NETIF_GSO_H
+#define NET_GNRC_NETIF_GSO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/netif/hdr.h"
+#ifdef MODULE_GNRC_SOCK_UDP
+#include "net/sock/udp.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Gets the segment size from a @ref net_gnrc_netif_hdr
+ *
+ * @pre `pkt != NULL`
+ *
+ * @param[in] pkt   A packet.
+ *
+ * @return  The segment size, if @p pkt starts with a
+ *          @ref net_gnrc_netif_hdr that requests segmentation.
+ * @return  0, otherwise.
+ */
+static inline uint16_t gnrc_netif_gso_size(const gnrc_pktsnip_t *pkt)
+{
+    if ((pkt->type != GNRC_NETTYPE_NETIF) ||
+        (pkt->size < sizeof(gnrc_netif_hdr_t))) {
+        return 0;
+    }
+    return ((gnrc_netif_hdr_t *)pkt->data)->gso_size;
+}
+
+/**
+ * @brief   Gets the length of the largest segment a packet will be cut into
+ *
+ * @pre `pkt != NULL`
+ *
+ * @param[in] pkt   A packet starting with a @ref net_gnrc_netif_hdr.
+ *
+ * @return  Length of the first segment of @p pkt without its
+ *          @ref net_gnrc_netif_hdr, if gnrc_netif_gso_size() of @p pkt is not 0.
+ * @return  Length of @p pkt without its @ref net_gnrc_netif_hdr, otherwise.
+ */
+size_t gnrc_netif_gso_seg_len(const gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Cuts the next segment from a packet
+ *
+ * The returned segment is a new packet consisting of copies of all headers of
+ * @p pkt (with gnrc_netif_hdr_t::gso_size reset to 0 and length fields and
+ * UDP checksum updated) and the next at most gnrc_netif_hdr_t::gso_size bytes
+ * of the UDP payload of @p pkt, starting at @p offset. @p pkt itself stays
+ * untouched and has to be released by the caller after the last segment.
+ *
+ * @pre `(pkt != NULL) && (gnrc_netif_gso_size(pkt) > 0)`
+ * @pre `offset != NULL`
+ *
+ * @param[in] pkt           A packet starting with a @ref net_gnrc_netif_hdr,
+ *                          followed by an IPv6 header and a UDP header.
+ * @param[in,out] offset    Offset into the UDP payload of @p pkt. Start with
+ *                          0. Is advanced by the payload size of the returned
+ *                          segment.
+ *
+ * @return  The next segment.
+ * @return  NULL, if there are no more segments, @p pkt is not a UDP packet or
+ *          the packet buffer is full.
+ */
+gnrc_pktsnip_t *gnrc_netif_gso_next(gnrc_pktsnip_t *pkt, size_t *offset);
+
+#if defined(MODULE_GNRC_SOCK_UDP) || DOXYGEN
+/**
+ * @brief   Sends a large payload as UDP datagrams of at most @p seg_size
+ *          bytes each over a UDP sock
+ *
+ * Behaves like @ref sock_udp_send(), but @p data is split into datagrams of
+ * at most @p seg_size bytes at the network interface. All datagrams but the
+ * last one carry exactly @p seg_size bytes.
+ *
+ * @param[in] sock      A raw UDP sock object. May be NULL (see
+ *                      @ref sock_udp_send()).
+ * @param[in] data      Pointer where the received data should be stored.
+ *                      May be `NULL` if `len == 0`.
+ * @param[in] len       Maximum space available at @p data.
+ * @param[in] seg_size  Maximum UDP payload size of a single datagram. 0 to
+ *                      not segment at all.
+ * @param[in] remote    Remote end point for the sent data. May be `NULL`
+ *                      if @p sock has a remote end point.
+ *
+ * @return  The number of bytes sent on success.
+ * @return  All error codes of @ref sock_udp_send().
+ */
+ssize_t gnrc_sock_udp_send_gso(sock_udp_t *sock, const void *data, size_t len,
+                               uint16_t seg_size, const sock_udp_ep_t *remote);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_NETIF_GSO_H */
+/** @} */
@@ -70,6 +70,16 @@ extern "C" {
  *          this flag the same way it does @ref GNRC_NETIF_HDR_FLAGS_BROADCAST.
  */
 #define GNRC_NETIF_HDR_FLAGS_MULTICAST  (0x40)
+
+/**
+ * @brief   Transmission class of the packet.
+ *
+ * @details Holds the @ref net_gnrc_netif_txq "transmission class" plus one,
+ *          so 0 means the class was not set. Use
+ *          gnrc_netif_hdr_set_txq_class() and gnrc_netif_hdr_get_txq_class()
+ *          to access it.
+ */
+#define GNRC_NETIF_HDR_FLAGS_TXQ_CLASS_MASK (0x07)
 /**
  * @}
  */
@@ -87,6 +97,16 @@ typedef struct {
     uint8_t flags;              /**< flags as defined above */
     uint8_t lqi;                /**< lqi of received packet (optional) */
     int16_t rssi;               /**< rssi of received packet in dBm (optional) */
+#if defined(MODULE_GNRC_NETIF_GSO) || DOXYGEN
+    /**
+     * @brief   Maximum UDP payload size per segment for outgoing packets
+     *
+     * 0 if the packet is not to be segmented.
+     *
+     * @see @ref net_gnrc_netif_gso
+     */
+    uint16_t gso_size;
+#endif
 } gnrc_netif_hdr_t;
 
 /**
@@ -105,6 +125,9 @@ static inline void gnrc_netif_hdr_init(gnrc_netif_hdr_t *hdr, uint8_t src_l2addr
     hdr->rssi = 0;
     hdr->lqi = 0;
     hdr->flags = 0;
+#ifdef MODULE_GNRC_NETIF_GSO
+    hdr->gso_size = 0;
+#endif
 }
 
 /**
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_netif_txq  Transmission queue with priority classes
+ * @ingroup     net_gnrc_netif
+ * @brief       Per-interface transmission scheduler for @ref net_gnrc_netif
+ *
+ * Without this module, packets handed to a network interface are sent in the
+ * order of the interface thread's message queue. With it, the interface
+ * drains pending send requests into a set of priority classes and picks the
+ * next packet to send according to a scheduling policy:
+ *
+ * - @ref GNRC_NETIF_TXQ_SCHED_STRICT always sends from the most urgent
+ *   non-empty class first.
+ * - @ref GNRC_NETIF_TXQ_SCHED_DRR serves all classes but
+ *   @ref GNRC_NETIF_TXQ_CLASS_CTRL with deficit round robin, weighted by
+ *   class. @ref GNRC_NETIF_TXQ_CLASS_CTRL is always served strictly first,
+ *   so routing and neighbor discovery traffic never waits behind bulk data.
+ *
+ * The class of a packet is taken from its @ref net_gnrc_netif_hdr (see
+ * gnrc_netif_hdr_set_txq_class()). If it was not set explicitly, the IPv6
+ * layer derives it from the DSCP of the traffic class field and from the
+ * ICMPv6 message type (see gnrc_netif_txq_classify()).
+ *
+ * If the queue of a class is full the packet is released with
+ * gnrc_pktbuf_release_error() and `ENOBUFS`, so senders subscribed via
+ * @ref net_gnrc_neterr learn about it.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Transmission queue definitions for @ref net_gnrc_netif
+ */
+#ifndef NET_GNRC_NETIF_TXQ_H
+#define NET_GNRC_NETIF_TXQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/pktqueue.h"
+#include "net/gnrc/netif/hdr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of packets that can be queued on one interface over all
+ *          classes
+ */
+#ifndef GNRC_NETIF_TXQ_SIZE
+#define GNRC_NETIF_TXQ_SIZE             (8U)
+#endif
+
+/**
+ * @brief   Maximum number of packets a single class may occupy in the queue
+ *
+ * Keeps bulk traffic from taking up all of gnrc_netif_txq_t::nodes, so there
+ * is always room left for more urgent classes.
+ */
+#ifndef GNRC_NETIF_TXQ_CLASS_LIMIT
+#define GNRC_NETIF_TXQ_CLASS_LIMIT      (GNRC_NETIF_TXQ_SIZE - 2U)
+#endif
+
+/**
+ * @brief   Number of packets sent after every message handled by the
+ *          interface thread
+ *
+ * The queue is sent out completely once the message queue of the interface
+ * thread is empty. Until then, only this many packets are sent in between
+ * messages, so more urgent packets still waiting in the message queue can
+ * overtake the ones queued already.
+ */
+#ifndef GNRC_NETIF_TXQ_BATCH
+#define GNRC_NETIF_TXQ_BATCH            (1U)
+#endif
+
+/**
+ * @brief   Deficit round robin quantum in bytes for the least urgent class
+ *
+ * The quantum doubles with every more urgent class.
+ */
+#ifndef GNRC_NETIF_TXQ_DRR_QUANTUM
+#define GNRC_NETIF_TXQ_DRR_QUANTUM      (128U)
+#endif
+
+/**
+ * @brief   Scheduling policy used for newly created interfaces
+ */
+#ifndef GNRC_NETIF_TXQ_SCHED_DEFAULT
+#define GNRC_NETIF_TXQ_SCHED_DEFAULT    (GNRC_NETIF_TXQ_SCHED_STRICT)
+#endif
+
+/**
+ * @name    Transmission classes
+ * @{
+ */
+#define GNRC_NETIF_TXQ_CLASS_CTRL       (0U)    /**< network control traffic */
+#define GNRC_NETIF_TXQ_CLASS_HIGH       (1U)    /**< latency-sensitive traffic */
+#define GNRC_NETIF_TXQ_CLASS_DEFAULT    (2U)    /**< best effort traffic */
+#define GNRC_NETIF_TXQ_CLASS_BULK       (3U)    /**< low-priority bulk traffic */
+#define GNRC_NETIF_TXQ_CLASS_NUMOF      (4U)    /**< number of classes */
+/**
+ * @brief   Class is not set and is determined by gnrc_netif_txq_classify()
+ */
+#define GNRC_NETIF_TXQ_CLASS_AUTO       (0xffU)
+/** @} */
+
+/**
+ * @name    Scheduling policies
+ * @{
+ */
+#define GNRC_NETIF_TXQ_SCHED_STRICT     (0U)    /**< strict priority */
+#define GNRC_NETIF_TXQ_SCHED_DRR        (1U)    /**< deficit round robin */
+/** @} */
+
+/**
+ * @brief   Statistics of one transmission class
+ */
+typedef struct {
+    uint32_t enqueued;          /**< packets accepted into the class */
+    uint32_t dropped;           /**< packets rejected because of a full queue */
+    uint8_t len;                /**< packets currently queued */
+    uint8_t max_len;            /**< highest value of gnrc_netif_txq_stats_t::len */
+} gnrc_netif_txq_stats_t;
+
+/**
+ * @brief   Transmission queue of a network interface
+ */
+typedef struct {
+    gnrc_pktqueue_t *classes[GNRC_NETIF_TXQ_CLASS_NUMOF];       /**< per-class FIFOs */
+    gnrc_pktqueue_t nodes[GNRC_NETIF_TXQ_SIZE];                 /**< node pool */
+    gnrc_netif_txq_stats_t stats[GNRC_NETIF_TXQ_CLASS_NUMOF];   /**< per-class statistics */
+    uint16_t deficit[GNRC_NETIF_TXQ_CLASS_NUMOF];               /**< DRR deficit counters */
+    uint8_t sched;              /**< scheduling policy */
+    uint8_t drr_cur;            /**< class currently served by DRR */
+    bool drr_visited;           /**< quantum already granted to gnrc_netif_txq_t::drr_cur */
+} gnrc_netif_txq_t;
+
+/**
+ * @brief   Initializes a transmission queue
+ *
+ * @pre `txq != NULL`
+ *
+ * @param[out] txq  A transmission queue.
+ */
+void gnrc_netif_txq_init(gnrc_netif_txq_t *txq);
+
+/**
+ * @brief   Determines the transmission class for an outgoing packet
+ *
+ * Uses the class stored in the @ref net_gnrc_netif_hdr of @p pkt if it is
+ * set. Otherwise, IPv6 packets are classified by DSCP (CS6/CS7 as
+ * @ref GNRC_NETIF_TXQ_CLASS_CTRL, EF, VA, CS4, CS5 and AF4x as
+ * @ref GNRC_NETIF_TXQ_CLASS_HIGH, CS1 and LE as
+ * @ref GNRC_NETIF_TXQ_CLASS_BULK) and ICMPv6 neighbor discovery and RPL
+ * messages as @ref GNRC_NETIF_TXQ_CLASS_CTRL. Everything else is
+ * @ref GNRC_NETIF_TXQ_CLASS_DEFAULT.
+ *
+ * @pre `pkt != NULL`
+ *
+ * @param[in] pkt   A packet, starting with its @ref net_gnrc_netif_hdr, if
+ *                  it has any.
+ *
+ * @return  The transmission class of @p pkt.
+ */
+uint8_t gnrc_netif_txq_classify(const gnrc_pktsnip_t *pkt);
+
+/**
+ * @brief   Puts a packet into the transmission queue
+ *
+ * @pre `(txq != NULL) && (pkt != NULL) && (cls < GNRC_NETIF_TXQ_CLASS_NUMOF)`
+ *
+ * @param[in] txq   A transmission queue.
+ * @param[in] pkt   The packet to queue.
+ * @param[in] cls   The transmission class for @p pkt.
+ *
+ * @return  0 on success.
+ * @return  -ENOBUFS, if the queue or the class are full. @p pkt is not
+ *          released in that case.
+ */
+int gnrc_netif_txq_push(gnrc_netif_txq_t *txq, gnrc_pktsnip_t *pkt,
+                        uint8_t cls);
+
+/**
+ * @brief   Takes the next packet to send from the transmission queue
+ *
+ * @pre `txq != NULL`
+ *
+ * @param[in] txq   A transmission queue.
+ *
+ * @return  The next packet according to gnrc_netif_txq_t::sched.
+ * @return  NULL, if the queue is empty.
+ */
+gnrc_pktsnip_t *gnrc_netif_txq_pop(gnrc_netif_txq_t *txq);
+
+/**
+ * @brief   Checks if a transmission queue is empty
+ *
+ * @pre `txq != NULL`
+ *
+ * @param[in] txq   A transmission queue.
+ *
+ * @return  true, if there is no packet queued in @p txq.
+ */
+static inline bool gnrc_netif_txq_empty(const gnrc_netif_txq_t *txq)
+{
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_CLASS_NUMOF; i++) {
+        if (txq->classes[i] != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief   Releases all packets in a transmission queue
+ *
+ * @pre `txq != NULL`
+ *
+ * @param[in] txq   A transmission queue.
+ */
+void gnrc_netif_txq_flush(gnrc_netif_txq_t *txq);
+
+/**
+ * @brief   Sets the transmission class in a @ref net_gnrc_netif_hdr
+ *
+ * @pre `hdr != NULL`
+ * @pre `(cls < GNRC_NETIF_TXQ_CLASS_NUMOF) || (cls == GNRC_NETIF_TXQ_CLASS_AUTO)`
+ *
+ * @param[out] hdr  A network interface header.
+ * @param[in] cls   A transmission class.
+ */
+static inline void gnrc_netif_hdr_set_txq_class(gnrc_netif_hdr_t *hdr,
+                                                uint8_t cls)
+{
+    hdr->flags &= ~GNRC_NETIF_HDR_FLAGS_TXQ_CLASS_MASK;
+    if (cls != GNRC_NETIF_TXQ_CLASS_AUTO) {
+        hdr->flags |= (cls + 1) & GNRC_NETIF_HDR_FLAGS_TXQ_CLASS_MASK;
+    }
+}
+
+/**
+ * @brief   Gets the transmission class from a @ref net_gnrc_netif_hdr
+ *
+ * @pre `hdr != NULL`
+ *
+ * @param[in] hdr   A network interface header.
+ *
+ * @return  The transmission class set in @p hdr.
+ * @return  @ref GNRC_NETIF_TXQ_CLASS_AUTO, if no class was set.
+ */
+static inline uint8_t gnrc_netif_hdr_get_txq_class(const gnrc_netif_hdr_t *hdr)
+{
+    uint8_t cls = hdr->flags & GNRC_NETIF_HDR_FLAGS_TXQ_CLASS_MASK;
+
+    return (cls == 0) ? GNRC_NETIF_TXQ_CLASS_AUTO : (uint8_t)(cls - 1);
+}
+
+#if defined(MODULE_GNRC_SOCK_UDP) || DOXYGEN
+struct sock_udp;
+
+/**
+ * @brief   Sets the transmission class for all packets sent over a UDP sock
+ *
+ * @pre `sock != NULL`
+ * @pre `(cls < GNRC_NETIF_TXQ_CLASS_NUMOF) || (cls == GNRC_NETIF_TXQ_CLASS_AUTO)`
+ *
+ * @param[in] sock  A UDP sock.
+ * @param[in] cls   A transmission class. @ref GNRC_NETIF_TXQ_CLASS_AUTO to
+ *                  let gnrc_netif_txq_classify() decide (the default).
+ */
+void gnrc_sock_udp_set_txq_class(struct sock_udp *sock, uint8_t cls);
+#endif
+
+#if defined(MODULE_GNRC_SOCK_IP) || DOXYGEN
+struct sock_ip;
+
+/**
+ * @brief   Sets the transmission class for all packets sent over a raw IP sock
+ *
+ * @pre `sock != NULL`
+ * @pre `(cls < GNRC_NETIF_TXQ_CLASS_NUMOF) || (cls == GNRC_NETIF_TXQ_CLASS_AUTO)`
+ *
+ * @param[in] sock  A raw IP sock.
+ * @param[in] cls   A transmission class. @ref GNRC_NETIF_TXQ_CLASS_AUTO to
+ *                  let gnrc_netif_txq_classify() decide (the default).
+ */
+void gnrc_sock_ip_set_txq_class(struct sock_ip *sock, uint8_t cls);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_NETIF_TXQ_H */
+/** @} */
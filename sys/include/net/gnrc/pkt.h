@@ -120,6 +120,11 @@ typedef struct gnrc_pktsnip {
     kernel_pid_t err_sub;           /**< subscriber to errors related to this
                                      *   packet snip */
 #endif
+#if defined(MODULE_NETSTATS_EXT) || DOXYGEN
+    uint32_t rx_time;               /**< time the packet was received at by
+                                     *   the network interface (see
+                                     *   @ref net_netstats_ext), 0 if unknown */
+#endif
 } gnrc_pktsnip_t;
 
 /**
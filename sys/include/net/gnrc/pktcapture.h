@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_pktcapture Capture network packets to pcapng
+ * @ingroup     net_gnrc
+ * @brief       Record link-layer frames to a pcapng file for offline analysis
+ *
+ * The link-layer adapters of @ref net_gnrc_netif hand every received and
+ * sent frame to gnrc_pktcapture_add(). It copies the first
+ * @ref GNRC_PKTCAPTURE_SNAPLEN bytes of the frame together with an @ref
+ * xtimer timestamp into a ring buffer (see @ref sys_tsrb) and returns. A
+ * thread of low priority drains the ring to a pcapng file, so file I/O
+ * never happens in the network interface's thread. When the ring is full,
+ * frames are not captured and counted in gnrc_pktcapture_dropped().
+ *
+ * On `native` the file is created on the host file system, so it can be
+ * opened with Wireshark right away. On other boards the file is written
+ * with @ref sys_vfs, so a file system needs to be mounted before
+ * gnrc_pktcapture_start() is called.
+ *
+ * To start capturing on `native` right at boot, add
+ *
+ *     CFLAGS += -DGNRC_PKTCAPTURE_AUTO_FILE=\"riot.pcapng\"
+ *
+ * to the application's Makefile.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Packet capture definitions
+ */
+#ifndef NET_GNRC_PKTCAPTURE_H
+#define NET_GNRC_PKTCAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iolist.h"
+#include "kernel_types.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum number of bytes captured per frame
+ */
+#ifndef GNRC_PKTCAPTURE_SNAPLEN
+#define GNRC_PKTCAPTURE_SNAPLEN     (128U)
+#endif
+
+/**
+ * @brief   Size of the capture ring buffer in bytes
+ *
+ * @attention   Must be a power of two.
+ */
+#ifndef GNRC_PKTCAPTURE_BUFSIZE
+#define GNRC_PKTCAPTURE_BUFSIZE     (2048U)
+#endif
+
+/**
+ * @brief   Priority of the thread writing the capture file
+ */
+#ifndef GNRC_PKTCAPTURE_PRIO
+#define GNRC_PKTCAPTURE_PRIO        (THREAD_PRIORITY_IDLE - 1)
+#endif
+
+/**
+ * @brief   Stack size of the thread writing the capture file
+ */
+#ifndef GNRC_PKTCAPTURE_STACKSIZE
+#define GNRC_PKTCAPTURE_STACKSIZE   (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @name    Link types of captured frames
+ * @see     http://www.tcpdump.org/linktypes.html
+ * @{
+ */
+#define GNRC_PKTCAPTURE_LINKTYPE_ETHERNET   (1U)    /**< Ethernet */
+#define GNRC_PKTCAPTURE_LINKTYPE_IEEE802154 (230U)  /**< IEEE 802.15.4 without FCS */
+/** @} */
+
+/**
+ * @brief   Initializes packet capturing
+ *
+ * Starts the thread writing the capture file and, if
+ * `GNRC_PKTCAPTURE_AUTO_FILE` is defined, starts capturing to that file.
+ *
+ * @note    Called by @ref sys_auto_init.
+ */
+void gnrc_pktcapture_init(void);
+
+/**
+ * @brief   Starts capturing to a file
+ *
+ * @param[in] path  Path of the capture file. An existing file is
+ *                  overwritten.
+ *
+ * @return  0 on success.
+ * @return  -EBUSY, if a capture is still in progress.
+ * @return  other negative errno on file system errors.
+ */
+int gnrc_pktcapture_start(const char *path);
+
+/**
+ * @brief   Stops capturing
+ *
+ * Frames captured so far are still written and the capture file is closed
+ * afterwards.
+ */
+void gnrc_pktcapture_stop(void);
+
+/**
+ * @brief   Captures a frame
+ *
+ * Does nothing if no capture is in progress.
+ *
+ * @param[in] if_pid    The interface the frame was received or sent on.
+ * @param[in] linktype  Link type of the frame (see
+ *                      @ref GNRC_PKTCAPTURE_LINKTYPE_ETHERNET and
+ *                      following).
+ * @param[in] tx        The frame was sent, not received.
+ * @param[in] frame     The frame, starting with the link-layer header.
+ */
+void gnrc_pktcapture_add(kernel_pid_t if_pid, uint16_t linktype, bool tx,
+                         const iolist_t *frame);
+
+/**
+ * @brief   Gets the number of frames not captured due to a full ring buffer
+ *          since the last call of gnrc_pktcapture_start()
+ *
+ * @return  Number of frames not captured.
+ */
+unsigned gnrc_pktcapture_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_PKTCAPTURE_H */
+/** @} */
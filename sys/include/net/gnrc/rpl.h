@@ -58,6 +58,18 @@
  *   CFLAGS += -DGNRC_RPL_DEFAULT_DIO_REDUNDANCY_CONSTANT=10
  *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  *
+ * - Build every DIO from scratch instead of resending the last one as long
+ *   as the state of the DODAG did not change
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ *   CFLAGS += -DGNRC_RPL_WITHOUT_DIO_CACHE
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * - Adapt the DIO redundancy constant to the number of neighbors, see
+ *   @ref GNRC_RPL_DIO_REDUNDANCY_NEIGHBORS
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ *   CFLAGS += -DGNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+ *   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
  * - Make reception of DODAG_CONF optional when joining a DODAG.
  *   This will use the default trickle parameters until a
  *   DODAG_CONF is received from the parent. The DODAG_CONF is
@@ -193,12 +205,22 @@ extern "C" {
 /**
  * @brief   Number of implemented Objective Functions
  */
+#ifdef MODULE_GNRC_RPL_MRHOF
+#define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (2)
+#else
 #define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (1)
+#endif
 
 /**
  * @brief   Default Objective Code Point (OF0)
+ *
+ * Set to @ref GNRC_RPL_MRHOF_OCP to let a root use @ref net_gnrc_rpl_mrhof.
+ * Nodes use the objective function advertised by the root, if it is
+ * implemented, and this one otherwise.
  */
+#ifndef GNRC_RPL_DEFAULT_OCP
 #define GNRC_RPL_DEFAULT_OCP (0)
+#endif
 
 /**
  * @brief   Default Instance ID
@@ -280,6 +302,29 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
 #endif
 /** @} */
 
+/**
+ * @name Adaptive DIO redundancy constant
+ *
+ * With `GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE`, the redundancy constant k of the
+ * trickle timer is set anew for every interval: one per
+ * @ref GNRC_RPL_DIO_REDUNDANCY_NEIGHBORS neighbors DIOs were received from in
+ * this and the last interval, but at least @ref GNRC_RPL_DIO_REDUNDANCY_MIN
+ * and at most the redundancy constant of the DODAG configuration. In dense
+ * networks, fewer nodes send a DIO per interval.
+ *
+ * The neighbors are counted in a bitmap of 32 hashed addresses, so more than
+ * about 20 neighbors are undercounted.
+ * @{
+ */
+#ifndef GNRC_RPL_DIO_REDUNDANCY_NEIGHBORS
+#define GNRC_RPL_DIO_REDUNDANCY_NEIGHBORS   (4U)
+#endif
+
+#ifndef GNRC_RPL_DIO_REDUNDANCY_MIN
+#define GNRC_RPL_DIO_REDUNDANCY_MIN         (2U)
+#endif
+/** @} */
+
 /**
  * @name Default parent and route entry lifetime
  * default lifetime will be multiplied by the lifetime unit to obtain the resulting lifetime
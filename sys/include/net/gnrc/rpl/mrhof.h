@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_rpl_mrhof Minimum Rank with Hysteresis Objective Function
+ * @ingroup     net_gnrc_rpl
+ * @brief       Implementation of MRHOF with the ETX metric
+ * @see <a href="https://tools.ietf.org/html/rfc6719">
+ *          RFC 6719
+ *      </a>
+ *
+ * MRHOF selects the parent with the smallest path cost, i.e. the advertised
+ * rank of the parent plus the ETX of the link to it. The ETX of a link is
+ * taken from the @ref net_netstats_neighbor of the interface, which estimate
+ * it from the acknowledgments and retransmissions reported by the network
+ * device for unicast frames sent to the parent.
+ *
+ * A node only switches to another parent, if its path cost is lower by at
+ * least @ref GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD, so the preferred parent
+ * does not flap between candidates with similar path costs. The candidates
+ * are the up to @ref GNRC_RPL_PARENTS_NUMOF parents in the parent set.
+ *
+ * The DODAG root selects the objective function of the DODAG, so compile the
+ * root with `CFLAGS += -DGNRC_RPL_DEFAULT_OCP=1`.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Definitions for MRHOF
+ */
+#ifndef NET_GNRC_RPL_MRHOF_H
+#define NET_GNRC_RPL_MRHOF_H
+
+#include "net/gnrc/rpl/structs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Objective Code Point of MRHOF
+ */
+#define GNRC_RPL_MRHOF_OCP                      (0x1)
+
+/**
+ * @brief   Largest link metric (ETX times 128) of a parent in the parent set
+ *
+ * Links with a higher ETX are only used if no other parent is available.
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_LINK_METRIC
+#define GNRC_RPL_MRHOF_MAX_LINK_METRIC          (512U)
+#endif
+
+/**
+ * @brief   Largest path cost of a parent in the parent set
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_PATH_COST
+#define GNRC_RPL_MRHOF_MAX_PATH_COST            (32768U)
+#endif
+
+/**
+ * @brief   Path cost difference required to switch the preferred parent
+ */
+#ifndef GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD
+#define GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD  (192U)
+#endif
+
+/**
+ * @brief   Link metric assumed for a parent no unicast frame was sent to yet
+ */
+#ifndef GNRC_RPL_MRHOF_ETX_INIT
+#define GNRC_RPL_MRHOF_ETX_INIT                 (256U)
+#endif
+
+/**
+ * @brief   Return the address to the MRHOF objective function
+ *
+ * @return  Address of the MRHOF objective function
+ */
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_RPL_MRHOF_H */
+/** @} */
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_rpl_sr_table Source routing table of a non-storing root
+ * @ingroup     net_gnrc_rpl
+ * @brief       Downward routes of a RPL root in non-storing mode
+ * @see <a href="https://tools.ietf.org/html/rfc6550#section-9.7">
+ *          RFC 6550, section 9.7
+ *      </a>
+ *
+ * In non-storing mode every node reports its DAO parent to the root. The root
+ * keeps one entry per node with the ID of the entry of its parent, so the
+ * whole DODAG is stored as a tree of parent pointers. Nodes are found by
+ * address through a hash table, the source route to a node is the chain of
+ * its parents, so building a source routing header takes O(depth) steps and
+ * no memory but the header itself.
+ *
+ * Addresses in the source routing header are compressed as described in
+ * RFC 6554, see gnrc_rpl_srh_build().
+ *
+ * The table is filled from the DAOs received by a root in non-storing mode
+ * (`CFLAGS += -DGNRC_RPL_DEFAULT_MOP=GNRC_RPL_MOP_NON_STORING_MODE`) and
+ * flushed when the instance is removed, so it is only non-empty on such a
+ * root. Packets the root sends to a node in the table get a source routing
+ * header, packets it forwards are tunneled to the node in an outer IPv6
+ * header carrying it (RFC 6554, section 4). Both are sent to the link-local
+ * address with the interface identifier of the first hop. Nodes derive the
+ * global address of their parent from their own prefix the same way.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Source routing table definitions
+ */
+#ifndef NET_GNRC_RPL_SR_TABLE_H
+#define NET_GNRC_RPL_SR_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/ipv6/addr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum number of nodes in the table
+ *
+ * Must be less than 65535.
+ */
+#ifndef GNRC_RPL_SR_TABLE_SIZE
+#define GNRC_RPL_SR_TABLE_SIZE      (32U)
+#endif
+
+/**
+ * @brief   Number of hash buckets to find a node by address, must be a power
+ *          of two
+ */
+#ifndef GNRC_RPL_SR_TABLE_BUCKETS
+#define GNRC_RPL_SR_TABLE_BUCKETS   (32U)
+#endif
+
+/**
+ * @brief   Maximum depth of a node below the root
+ *
+ * Routes to deeper nodes are considered broken, this also stops loops in the
+ * reported parents.
+ */
+#ifndef GNRC_RPL_SR_TABLE_DEPTH_MAX
+#define GNRC_RPL_SR_TABLE_DEPTH_MAX (16U)
+#endif
+
+/**
+ * @brief   Largest source routing header built for a node at @p depth
+ */
+#define GNRC_RPL_SR_TABLE_SRH_LEN(depth) \
+    (8U + (((depth) - 1) * sizeof(ipv6_addr_t)))
+
+/**
+ * @brief   Largest source routing header built from the table
+ */
+#define GNRC_RPL_SR_TABLE_SRH_MAXLEN \
+    GNRC_RPL_SR_TABLE_SRH_LEN(GNRC_RPL_SR_TABLE_DEPTH_MAX)
+
+/**
+ * @brief   Adds or updates a node
+ *
+ * @param[in] target    Address of the node.
+ * @param[in] parent    Address of its DAO parent, NULL if it is the root.
+ * @param[in] lifetime  Lifetime of the route in seconds. 0 removes the node.
+ *
+ * @return  0 on success.
+ * @return  -ENOMEM, if the table is full.
+ */
+int gnrc_rpl_sr_table_add(const ipv6_addr_t *target, const ipv6_addr_t *parent,
+                          uint32_t lifetime);
+
+/**
+ * @brief   Removes a node
+ *
+ * Nodes that had it as parent are unreachable until they report their
+ * parent again.
+ *
+ * @param[in] target    Address of the node.
+ */
+void gnrc_rpl_sr_table_del(const ipv6_addr_t *target);
+
+/**
+ * @brief   Removes all nodes
+ */
+void gnrc_rpl_sr_table_flush(void);
+
+/**
+ * @brief   Ages all nodes and removes those whose lifetime expired
+ *
+ * @param[in] elapsed   Seconds since the last call.
+ */
+void gnrc_rpl_sr_table_timeout(uint32_t elapsed);
+
+/**
+ * @brief   Gets the depth of a node below the root
+ *
+ * @pre `dst != NULL`
+ *
+ * @param[in] dst   Address of the node.
+ *
+ * @return  Number of hops from the root to @p dst, 1 for a child of the
+ *          root.
+ * @return  -ENOENT, if no route to @p dst is known.
+ * @return  -ELOOP, if the route is deeper than
+ *          @ref GNRC_RPL_SR_TABLE_DEPTH_MAX.
+ */
+int gnrc_rpl_sr_table_depth(const ipv6_addr_t *dst);
+
+/**
+ * @brief   Builds the source routing header to a node
+ *
+ * @pre `(dst != NULL) && (first_hop != NULL)`
+ *
+ * @param[in] dst           Address of the node.
+ * @param[out] first_hop    The first hop towards @p dst, the IPv6
+ *                          destination address of the packet.
+ * @param[out] buf          Buffer for the source routing header, should be
+ *                          @ref GNRC_RPL_SR_TABLE_SRH_LEN of the depth of
+ *                          @p dst long. The next header field is left to the
+ *                          caller.
+ * @param[in] len           Length of @p buf.
+ *
+ * @return  Length of the source routing header in @p buf.
+ * @return  0, if @p dst is a child of the root, so no header is needed and
+ *          @p first_hop is @p dst.
+ * @return  -ENOENT, if no route to @p dst is known.
+ * @return  -ELOOP, if the route is deeper than
+ *          @ref GNRC_RPL_SR_TABLE_DEPTH_MAX.
+ * @return  -ENOBUFS, if @p buf is too small.
+ */
+int gnrc_rpl_sr_table_srh(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                          void *buf, size_t len);
+
+/**
+ * @brief   Gets the number of nodes in the table
+ *
+ * @return  Number of nodes.
+ */
+unsigned gnrc_rpl_sr_table_numof(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_RPL_SR_TABLE_H */
+/** @} */
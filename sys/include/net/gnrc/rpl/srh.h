@@ -66,6 +66,30 @@ typedef struct __attribute__((packed)) {
  */
 int gnrc_rpl_srh_process(ipv6_hdr_t *ipv6, gnrc_rpl_srh_t *rh);
 
+/**
+ * @brief   Builds a RPL source routing header.
+ *
+ * Each hop restores the elided prefix of the next address from its own
+ * address, so the prefix every address shares with the one before it (with
+ * @p dst for the first one) is elided: CmprI is the shortest of these for all
+ * but the last address, CmprE the one of the last address.
+ *
+ * @param[in] dst   The IPv6 destination address of the packet, i.e. the
+ *                  first hop.
+ * @param[in] addrs The addresses of the route after the first hop, the last
+ *                  one is the final destination.
+ * @param[in] n     Number of addresses in @p addrs.
+ * @param[out] buf  Buffer for the header. The next header field is left to
+ *                  the caller.
+ * @param[in] len   Length of @p buf.
+ *
+ * @return  Length of the header in @p buf.
+ * @return  -EINVAL, if @p n is 0 or too large.
+ * @return  -ENOBUFS, if @p buf is too small.
+ */
+int gnrc_rpl_srh_build(const ipv6_addr_t *dst, const ipv6_addr_t *const *addrs,
+                       unsigned n, void *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,7 @@ extern "C" {
 #endif
 
 #include "byteorder.h"
+#include "net/icmpv6.h"
 #include "net/ipv6/addr.h"
 #include "xtimer.h"
 #include "trickle.h"
@@ -202,6 +203,14 @@ typedef struct __attribute__((packed)) {
                                          *   Autoconfiguration */
 } gnrc_rpl_opt_prefix_info_t;
 
+/**
+ * @brief   Size of the cached DIO of a DODAG, large enough for a DIO with a
+ *          DODAG configuration and a prefix information option
+ */
+#define GNRC_RPL_DIO_CACHE_SIZE (sizeof(icmpv6_hdr_t) + sizeof(gnrc_rpl_dio_t) + \
+                                 sizeof(gnrc_rpl_opt_dodag_conf_t) + \
+                                 sizeof(gnrc_rpl_opt_prefix_info_t))
+
 /**
  * @brief DODAG representation
  */
@@ -227,7 +236,7 @@ struct gnrc_rpl_parent {
     uint16_t rank;                  /**< rank of the parent */
     gnrc_rpl_dodag_t *dodag;        /**< DODAG the parent belongs to */
     uint32_t lifetime;              /**< lifetime of this parent in seconds */
-    double  link_metric;            /**< metric of the link */
+    uint16_t link_metric;           /**< metric of the link */
     uint8_t link_metric_type;       /**< type of the metric */
 };
 /**
@@ -263,6 +272,8 @@ typedef struct {
     void (*parent_state_callback)(gnrc_rpl_parent_t *, int, int); /**< retrieves the state of a parent*/
     void (*init)(void);  /**< OF specific init function */
     void (*process_dio)(void);  /**< DIO processing callback (acc. to OF0 spec, chpt 5) */
+    void (*update_metrics)(gnrc_rpl_dodag_t *); /**< updates the link metrics of the parents
+                                                     before they are compared, may be NULL */
 } gnrc_rpl_of_t;
 
 /**
@@ -291,6 +302,20 @@ struct gnrc_rpl_dodag {
                                          (see @ref GNRC_RPL_REQ_DIO_OPTS "DIO Options") */
     uint8_t dao_time;               /**< time to schedule a DAO in seconds */
     trickle_t trickle;              /**< trickle representation */
+#ifndef GNRC_RPL_WITHOUT_DIO_CACHE
+    uint8_t dio_cache[GNRC_RPL_DIO_CACHE_SIZE]; /**< last DIO sent, including
+                                                     the ICMPv6 header */
+    uint8_t dio_cache_len;          /**< length of the cached DIO, 0 if none */
+    uint8_t dio_cache_opts;         /**< options in the cached DIO */
+#endif
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+    uint32_t dio_srcs;              /**< hashed senders of the DIOs received in
+                                         the current trickle interval */
+    uint32_t dio_srcs_last;         /**< hashed senders of the DIOs received in
+                                         the last trickle interval */
+    uint64_t dio_srcs_start;        /**< start of the trickle interval
+                                         gnrc_rpl_dodag_t::dio_srcs is for */
+#endif
 };
 
 struct gnrc_rpl_instance {
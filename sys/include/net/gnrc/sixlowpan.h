@@ -133,6 +133,14 @@ extern "C" {
 #define GNRC_SIXLOWPAN_MSG_QUEUE_SIZE   (8U)
 #endif
 
+/**
+ * @brief   Number of packets with @ref net_gnrc_netif_gso that can wait for
+ *          the segmentation of the current one to finish
+ */
+#ifndef GNRC_SIXLOWPAN_GSO_QUEUE_SIZE
+#define GNRC_SIXLOWPAN_GSO_QUEUE_SIZE   (2U)
+#endif
+
 /**
  * @brief   Initialization of the 6LoWPAN thread.
  *
@@ -11,6 +11,30 @@
  * @ingroup     net_gnrc
  * @brief       RIOT's TCP implementation for the GNRC network stack.
  *
+ * The functions gnrc_tcp_open_active(), gnrc_tcp_open_passive(), gnrc_tcp_send(),
+ * gnrc_tcp_recv() and gnrc_tcp_close() block the calling thread, one thread per connection
+ * is needed to serve several peers at once.
+ *
+ * The asynchronous API never blocks: gnrc_tcp_connect() and gnrc_tcp_listen() register a
+ * callback, that is called from the TCP thread whenever a connection can make progress
+ * (see @ref GNRC_TCP_EVENT_CONNECTED and following). gnrc_tcp_write(), gnrc_tcp_read(),
+ * gnrc_tcp_accept() and gnrc_tcp_disconnect() return immediately and may be called from the
+ * callback. To serve many connections from a single thread of the application, the callback
+ * hands its events to an @ref sys_event queue:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static void _cb(gnrc_tcp_tcb_t *tcb, unsigned events, void *arg)
+ * {
+ *     conn_t *conn = &conns[tcb - tcbs];
+ *
+ *     conn->events |= events;
+ *     event_post(arg, &conn->event);
+ * }
+ *
+ * gnrc_tcp_listen(&listener, tcbs, ARRAY_SIZE(tcbs), AF_INET6, NULL, 80, _cb, &queue);
+ * event_loop(&queue);
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ *
  * @{
  *
  * @file
@@ -34,6 +58,23 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Statistics of a TCP connection
+ */
+typedef struct {
+    const char *state;        /**< Connection state */
+    const char *cc;           /**< Name of the congestion control algorithm */
+    uint16_t local_port;      /**< Local port number */
+    uint16_t peer_port;       /**< Peer port number */
+    uint32_t snd_wnd;         /**< Send window */
+    uint32_t cwnd;            /**< Congestion window */
+    uint32_t ssthresh;        /**< Slow start threshold */
+    uint32_t flight_size;     /**< Bytes sent but not acknowledged */
+    int32_t srtt;             /**< Smoothed round trip time in us, negative if unknown */
+    int32_t rto;              /**< Retransmission timeout in us, negative if unknown */
+    uint16_t retransmits;     /**< Number of retransmitted segments */
+} gnrc_tcp_stats_t;
+
 /**
  * @brief Initialize TCP
  *
@@ -119,20 +160,23 @@ int gnrc_tcp_open_passive(gnrc_tcp_tcb_t *tcb,  const uint8_t address_family,
  * @pre @p tcb must not be NULL.
  * @pre @p data must not be NULL.
  *
- * @note Blocks until up to @p len bytes were transmitted or an error occured.
+ * @note Blocks until @p len bytes were put into the retransmit queue of @p tcb or an error
+ *       occured. Up to @ref GNRC_TCP_SND_QUEUE_SIZE segments are in flight at once, queued
+ *       segments are retransmitted in the background until they are acknowledged.
  *
  * @param[in,out] tcb                        TCB holding the connection information.
  * @param[in]     data                       Pointer to the data that should be transmitted.
  * @param[in]     len                        Number of bytes that should be transmitted.
- * @param[in]     user_timeout_duration_us   If not zero and there was not data transmitted
- *                                           the function returns after user_timeout_duration_us.
+ * @param[in]     user_timeout_duration_us   If not zero and not all data was queued the
+ *                                           function returns after user_timeout_duration_us.
  *                                           If zero, no timeout will be triggered.
  *
- * @returns   The number of successfully transmitted bytes.
+ * @returns   The number of successfully queued bytes.
  *            -ENOTCONN if connection is not established.
  *            -ECONNRESET if connection was resetted by the peer.
  *            -ECONNABORTED if the connection was aborted.
  *            -ETIMEDOUT if @p user_timeout_duration_us expired.
+ *            -ENOMEM if no data could be queued, because no packet could be allocated.
  */
 ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
                       const uint32_t user_timeout_duration_us);
@@ -187,6 +231,151 @@ void gnrc_tcp_close(gnrc_tcp_tcb_t *tcb);
  */
 void gnrc_tcp_abort(gnrc_tcp_tcb_t *tcb);
 
+/**
+ * @brief TCBs accepting connections on a local port, see gnrc_tcp_listen()
+ */
+typedef struct {
+    gnrc_tcp_tcb_t *tcbs;   /**< TCBs used for incoming connections */
+    size_t numof;           /**< Number of TCBs in gnrc_tcp_listener_t::tcbs */
+} gnrc_tcp_listener_t;
+
+/**
+ * @brief Opens a connection actively without blocking.
+ *
+ * @pre gnrc_tcp_tcb_init() must have been successfully called.
+ * @pre @p tcb must not be NULL
+ * @pre @p target_addr must not be NULL.
+ * @pre @p target_port must not be 0.
+ * @pre @p cb must not be NULL.
+ *
+ * @note @p cb is called with @ref GNRC_TCP_EVENT_CONNECTED once the connection is
+ *       established or with @ref GNRC_TCP_EVENT_CLOSED if it could not be opened.
+ *
+ * @param[in,out] tcb              TCB holding the connection information.
+ * @param[in]     address_family   Address family of @p target_addr.
+ * @param[in]     target_addr      Pointer to target address.
+ * @param[in]     target_port      Target port number.
+ * @param[in]     local_port       If zero or PORT_UNSPEC, the connections
+ *                                 source port is randomly chosen.
+ * @param[in]     cb               Callback for the events of the connection.
+ * @param[in]     arg              Argument for @p cb.
+ *
+ * @returns   Zero if the connection request was sent.
+ *            -EAFNOSUPPORT if @p address_family is not supported.
+ *            -EINVAL if @p address_family is not the same the address_family use by the TCB.
+ *            -EISCONN if TCB is already in use.
+ *            -ENOMEM if the receive buffer for the TCB could not be allocated.
+ *            -EADDRINUSE if @p local_port is already used by another connection.
+ */
+int gnrc_tcp_connect(gnrc_tcp_tcb_t *tcb, const uint8_t address_family,
+                     const uint8_t *target_addr, const uint16_t target_port,
+                     const uint16_t local_port, gnrc_tcp_cb_t cb, void *arg);
+
+/**
+ * @brief Accepts connections on a local port without blocking.
+ *
+ * Every TCB in @p tcbs waits for a connection request to @p local_port, so up to @p numof
+ * connections are served at once. Once a connection was established, @p cb is called with
+ * @ref GNRC_TCP_EVENT_ACCEPT and the connection is taken with gnrc_tcp_accept(). After an
+ * accepted connection reported @ref GNRC_TCP_EVENT_CLOSED, its TCB waits for the next
+ * connection request again and must not be used by the application anymore.
+ *
+ * @pre gnrc_tcp_tcb_init() must have been successfully called for all @p tcbs.
+ * @pre @p listener, @p tcbs and @p cb must not be NULL.
+ * @pre @p local_port must not be 0.
+ *
+ * @note Every waiting TCB holds a receive buffer, see @ref GNRC_TCP_RCV_BUFFERS. If it can't
+ *       get one back after a connection closed, it retries after @ref GNRC_TCP_LISTEN_RETRY.
+ *
+ * @param[out]    listener         Listener to initialize.
+ * @param[in,out] tcbs             TCBs for incoming connections.
+ * @param[in]     numof            Number of TCBs in @p tcbs.
+ * @param[in]     address_family   Address family of @p local_addr.
+ *                                 If local_addr == NULL, address_family is ignored.
+ * @param[in]     local_addr       If not NULL the connections are bound to @p local_addr.
+ * @param[in]     local_port       Port number to listen on.
+ * @param[in]     cb               Callback for the events of all connections.
+ * @param[in]     arg              Argument for @p cb.
+ *
+ * @returns   Zero on success.
+ *            -EAFNOSUPPORT if local_addr != NULL and @p address_family is not supported.
+ *            -EINVAL if @p address_family is not the same the address_family used in TCB.
+ *            -EISCONN if one of @p tcbs is already in use.
+ *            -ENOMEM if the receive buffers for @p tcbs could not be allocated.
+ */
+int gnrc_tcp_listen(gnrc_tcp_listener_t *listener, gnrc_tcp_tcb_t *tcbs, size_t numof,
+                    const uint8_t address_family, const uint8_t *local_addr,
+                    const uint16_t local_port, gnrc_tcp_cb_t cb, void *arg);
+
+/**
+ * @brief Takes an established connection of a listener.
+ *
+ * @pre @p listener must not be NULL.
+ *
+ * @param[in,out] listener   Listener initialized by gnrc_tcp_listen().
+ *
+ * @returns   TCB of the connection, data may be available for gnrc_tcp_read() already.
+ *            NULL if no connection is waiting to be accepted.
+ */
+gnrc_tcp_tcb_t *gnrc_tcp_accept(gnrc_tcp_listener_t *listener);
+
+/**
+ * @brief Stops a listener and aborts all of its connections.
+ *
+ * @pre @p listener must not be NULL.
+ *
+ * @param[in,out] listener   Listener initialized by gnrc_tcp_listen().
+ */
+void gnrc_tcp_unlisten(gnrc_tcp_listener_t *listener);
+
+/**
+ * @brief Transmits data to the connected peer without blocking.
+ *
+ * @pre @p tcb must not be NULL.
+ * @pre @p data must not be NULL.
+ *
+ * @note If less than @p len bytes were queued, the callback of the connection is called
+ *       with @ref GNRC_TCP_EVENT_SEND once more data can be queued.
+ *
+ * @param[in,out] tcb    TCB holding the connection information.
+ * @param[in]     data   Pointer to the data that should be transmitted.
+ * @param[in]     len    Number of bytes that should be transmitted.
+ *
+ * @returns   The number of queued bytes.
+ *            -ENOTCONN if connection is not established.
+ *            -EAGAIN if no data could be queued.
+ */
+ssize_t gnrc_tcp_write(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len);
+
+/**
+ * @brief Receives data from the peer without blocking.
+ *
+ * @pre @p tcb must not be NULL.
+ * @pre @p data must not be NULL.
+ *
+ * @param[in,out] tcb       TCB holding the connection information.
+ * @param[out]    data      Pointer to the buffer where the received data should be copied into.
+ * @param[in]     max_len   Maximum amount to bytes that should be read into @p data.
+ *
+ * @returns   The number of bytes read into @p data.
+ *            Zero if the peer closed its direction of the connection.
+ *            -ENOTCONN if connection is not established.
+ *            -EAGAIN if no data is available.
+ */
+ssize_t gnrc_tcp_read(gnrc_tcp_tcb_t *tcb, void *data, const size_t max_len);
+
+/**
+ * @brief Starts to close a connection without blocking.
+ *
+ * Queued data is still transmitted. The callback of the connection is called with
+ * @ref GNRC_TCP_EVENT_CLOSED once the connection is closed.
+ *
+ * @pre @p tcb must not be NULL.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+void gnrc_tcp_disconnect(gnrc_tcp_tcb_t *tcb);
+
 /**
  * @brief Calculate and set checksum in TCP header.
  *
@@ -212,6 +401,17 @@ int gnrc_tcp_calc_csum(const gnrc_pktsnip_t *hdr, const gnrc_pktsnip_t *pseudo_h
  */
 gnrc_pktsnip_t *gnrc_tcp_hdr_build(gnrc_pktsnip_t *payload, uint16_t src, uint16_t dst);
 
+/**
+ * @brief Get statistics of an active connection.
+ *
+ * @param[in]  idx     Index of the connection in the list of active connections.
+ * @param[out] stats   Statistics of the connection.
+ *
+ * @returns   Zero on success.
+ *            -ENOENT if there are less than @p idx + 1 active connections.
+ */
+int gnrc_tcp_get_stats(unsigned idx, gnrc_tcp_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_tcp_cc TCP congestion control
+ * @ingroup     net_gnrc_tcp
+ * @brief       Pluggable congestion control for GNRC TCP
+ *
+ * Every TCB references the congestion control algorithm used for the
+ * connection in gnrc_tcp_tcb_t::cc. gnrc_tcp_tcb_init() selects
+ * @ref GNRC_TCP_CC_DEFAULT, a different algorithm can be assigned after
+ * gnrc_tcp_tcb_init() and before the connection is opened:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * gnrc_tcp_tcb_init(&tcb);
+ * tcb.cc = &gnrc_tcp_cc_cubic_lite;
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Algorithms maintain gnrc_tcp_tcb_t::cwnd and gnrc_tcp_tcb_t::ssthresh.
+ * Their private state is kept in gnrc_tcp_tcb_t::cc_state.
+ *
+ * @{
+ *
+ * @file
+ * @brief       GNRC TCP congestion control interface
+ */
+
+#ifndef NET_GNRC_TCP_CC_H
+#define NET_GNRC_TCP_CC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct _transmission_control_block;
+
+/**
+ * @brief Congestion control algorithm
+ */
+typedef struct {
+    const char *name;   /**< Name of the algorithm */
+
+    /**
+     * @brief Initializes the congestion window once a connection is established.
+     *
+     * @param[in,out] tcb   TCB of the connection.
+     */
+    void (*init)(struct _transmission_control_block *tcb);
+
+    /**
+     * @brief Called when an ACK acknowledged new data.
+     *
+     * gnrc_tcp_tcb_t::snd_una is updated already.
+     *
+     * @param[in,out] tcb     TCB of the connection.
+     * @param[in]     acked   Number of newly acknowledged bytes.
+     *
+     * @returns   true, if the oldest unacknowledged segment must be retransmitted.
+     */
+    bool (*ack)(struct _transmission_control_block *tcb, uint32_t acked);
+
+    /**
+     * @brief Called on every duplicate ACK.
+     *
+     * gnrc_tcp_tcb_t::dup_acks holds the number of duplicate ACKs in a row.
+     *
+     * @param[in,out] tcb   TCB of the connection.
+     *
+     * @returns   true, if the oldest unacknowledged segment must be retransmitted.
+     */
+    bool (*dup_ack)(struct _transmission_control_block *tcb);
+
+    /**
+     * @brief Called when the retransmission timer expired.
+     *
+     * @param[in,out] tcb   TCB of the connection.
+     */
+    void (*timeout)(struct _transmission_control_block *tcb);
+} gnrc_tcp_cc_t;
+
+/**
+ * @brief Private state of the congestion control algorithms
+ */
+typedef union {
+    /**
+     * @brief State of @ref gnrc_tcp_cc_newreno
+     */
+    struct {
+        uint32_t recover;   /**< snd_nxt when fast recovery was entered */
+        bool recovery;      /**< Fast recovery is in progress */
+    } newreno;
+    /**
+     * @brief State of @ref gnrc_tcp_cc_cubic_lite
+     */
+    struct {
+        uint32_t recover;   /**< snd_nxt on the last window reduction */
+        uint32_t epoch;     /**< Start of the current epoch in ms, 0 if none */
+        uint32_t w_max;     /**< Congestion window before the last reduction */
+        uint32_t k;         /**< Time in ms to reach w_max again */
+    } cubic_lite;
+} gnrc_tcp_cc_state_t;
+
+/**
+ * @brief NewReno (see RFC 5681 and RFC 6582)
+ *
+ * Slow start, congestion avoidance, fast retransmit and fast recovery with
+ * partial ACK handling.
+ */
+extern const gnrc_tcp_cc_t gnrc_tcp_cc_newreno;
+
+/**
+ * @brief CUBIC-lite: CUBIC window growth (see RFC 8312) for constrained nodes
+ *
+ * Integer-only CUBIC without the TCP-friendly region and without fast
+ * recovery: after a fast retransmit the window is reduced once and further
+ * losses of the same window are repaired by the retransmission timer. This
+ * keeps code size small while recovering the previous window faster than
+ * NewReno on links with a large bandwidth-delay product.
+ */
+extern const gnrc_tcp_cc_t gnrc_tcp_cc_cubic_lite;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_TCP_CC_H */
+/** @} */
@@ -81,6 +81,49 @@ extern "C" {
 #define GNRC_TCP_RCV_BUF_SIZE (GNRC_TCP_DEFAULT_WINDOW)
 #endif
 
+/**
+ * @brief Number of unacknowledged data segments a connection may have in flight
+ *
+ * This is the send buffer of a connection: segments stay in the packet buffer
+ * until they are acknowledged, so GNRC_PKTBUF_SIZE must be able to hold this
+ * many segments of GNRC_TCP_MSS bytes per connection. A value of 1 restores
+ * stop-and-wait behaviour.
+ */
+#ifndef GNRC_TCP_SND_QUEUE_SIZE
+#define GNRC_TCP_SND_QUEUE_SIZE (2U)
+#endif
+
+/**
+ * @brief Number of duplicate ACKs that trigger a fast retransmit (see RFC 5681)
+ */
+#ifndef GNRC_TCP_DUPACK_THRESHOLD
+#define GNRC_TCP_DUPACK_THRESHOLD (3U)
+#endif
+
+/**
+ * @brief Number of retransmissions of a segment before an asynchronous connection is closed
+ *
+ * Blocking calls limit their duration with timeouts instead.
+ */
+#ifndef GNRC_TCP_ASYNC_MAX_RETRIES
+#define GNRC_TCP_ASYNC_MAX_RETRIES (6U)
+#endif
+
+/**
+ * @brief Duration after which a TCB of a listener tries to wait for connections again,
+ *        if its receive buffer could not be allocated
+ */
+#ifndef GNRC_TCP_LISTEN_RETRY
+#define GNRC_TCP_LISTEN_RETRY (1U * US_PER_SEC)
+#endif
+
+/**
+ * @brief Congestion control algorithm of new connections (see @ref net_gnrc_tcp_cc)
+ */
+#ifndef GNRC_TCP_CC_DEFAULT
+#define GNRC_TCP_CC_DEFAULT (gnrc_tcp_cc_newreno)
+#endif
+
 /**
  * @brief Lower bound for RTO = 1 sec (see RFC 6298)
  */
@@ -31,6 +31,7 @@
 #include "mbox.h"
 #include "net/gnrc/pkt.h"
 #include "config.h"
+#include "cc.h"
 
 #ifdef MODULE_GNRC_IPV6
 #include "net/gnrc/ipv6.h"
@@ -45,6 +46,29 @@ extern "C" {
  */
 #define GNRC_TCP_TCB_MBOX_SIZE (8U)
 
+/**
+ * @name Events of asynchronous connections
+ * @{
+ */
+#define GNRC_TCP_EVENT_CONNECTED (0x01)  /**< Connection opened with gnrc_tcp_connect() */
+#define GNRC_TCP_EVENT_ACCEPT    (0x02)  /**< Connection of a listener can be accepted */
+#define GNRC_TCP_EVENT_RECV      (0x04)  /**< Data or end of stream can be read */
+#define GNRC_TCP_EVENT_SEND      (0x08)  /**< Space to write data became available */
+#define GNRC_TCP_EVENT_CLOSED    (0x10)  /**< Connection was closed, reset or timed out */
+/** @} */
+
+struct _transmission_control_block;
+
+/**
+ * @brief Callback of an asynchronous connection
+ *
+ * @param[in] tcb      TCB of the connection.
+ * @param[in] events   Events that occurred, see @ref GNRC_TCP_EVENT_CONNECTED and following.
+ * @param[in] arg      Argument given on registration of the callback.
+ */
+typedef void (*gnrc_tcp_cb_t)(struct _transmission_control_block *tcb, unsigned events,
+                              void *arg);
+
 /**
  * @brief Transmission control block of GNRC TCP.
  */
@@ -69,19 +93,35 @@ typedef struct _transmission_control_block {
     uint32_t irs;          /**< Initial received sequence number */
     uint16_t mss;          /**< The peers MSS */
     uint32_t rtt_start;    /**< Timer value for rtt estimation */
+    uint32_t rtt_seq;      /**< Acknowledgment number completing the rtt estimation */
     int32_t rtt_var;       /**< Round trip time variance */
     int32_t srtt;          /**< Smoothed round trip time */
     int32_t rto;           /**< Retransmission timeout duration */
     uint8_t retries;       /**< Number of retransmissions */
+    uint8_t dup_acks;      /**< Number of duplicate ACKs received */
+    uint16_t retransmits;  /**< Number of retransmitted segments */
+    uint32_t cwnd;         /**< Congestion window */
+    uint32_t ssthresh;     /**< Slow start threshold */
+    const gnrc_tcp_cc_t *cc;          /**< Congestion control algorithm */
+    gnrc_tcp_cc_state_t cc_state;     /**< State of the congestion control algorithm */
     xtimer_t tim_tout;     /**< Timer struct for timeouts */
     msg_t msg_tout;        /**< Message, sent on timeouts */
-    gnrc_pktsnip_t *pkt_retransmit;   /**< Pointer to packet in "retransmit queue" */
+    uint8_t pkt_retransmit_numof;     /**< Number of packets in "retransmit queue" */
+    /**
+     * @brief "retransmit queue", oldest packet first
+     *
+     * One entry more than data segments are allowed in flight, so SYN and FIN
+     * can always be queued.
+     */
+    gnrc_pktsnip_t *pkt_retransmit[GNRC_TCP_SND_QUEUE_SIZE + 1];
     msg_t mbox_raw[GNRC_TCP_TCB_MBOX_SIZE];   /**< Msg queue for mbox */
     mbox_t mbox;             /**< TCB mbox for synchronization */
     uint8_t *rcv_buf_raw;    /**< Pointer to the receive buffer */
     ringbuffer_t rcv_buf;    /**< Receive buffer data structure */
     mutex_t fsm_lock;        /**< Mutex for FSM access synchronization */
     mutex_t function_lock;   /**< Mutex for function call synchronization */
+    gnrc_tcp_cb_t cb;        /**< Callback of an asynchronous connection, NULL if blocking */
+    void *cb_arg;            /**< Argument of cb */
     struct _transmission_control_block *next;   /**< Pointer next TCB */
 } gnrc_tcp_tcb_t;
 
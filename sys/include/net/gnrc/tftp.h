@@ -29,6 +29,22 @@
  *  - https://tools.ietf.org/html/rfc2349
  *     (RFC2349 TFTP Timeout Interval and Transfer Size Options)
  *
+ *  - https://tools.ietf.org/html/rfc7440
+ *     (RFC7440 TFTP Windowsize Option)
+ *
+ * With the windowsize option the sender transmits a window of blocks before
+ * it waits for an acknowledgment, the receiver only acknowledges the last
+ * block of every window. On a lost block the receiver acknowledges the last
+ * block received in order and the sender resends the window from there. On a
+ * timeout, e.g. when a whole window or its acknowledgment got lost on a
+ * congested path, the sender halves its window, and doubles it again with
+ * every window acknowledged completely, up to the negotiated window size. A
+ * receiver waiting for the rest of a window acknowledges what it got after a
+ * quarter of the timeout.
+ *
+ * The @ref net_gnrc_tftp_vfs and @ref net_gnrc_tftp_mtd submodules provide
+ * data callbacks to stream a transfer from or to a file or a flash device.
+ *
  * @author      Nick van IJzendoorn <nijzendoorn@engineering-spirit.nl>
  */
 
@@ -74,6 +90,17 @@ extern "C" {
 #define GNRC_TFTP_MAX_TRANSFER_UNIT         (512)
 #endif
 
+/**
+ * @brief The maximum number of data blocks sent before an acknowledgment
+ *
+ * The window size requested by the client and accepted by the server, see
+ * RFC 7440. Set to 1 to disable the windowsize option. The message queue of
+ * the thread running a transfer should hold a window of blocks.
+ */
+#ifndef GNRC_TFTP_MAX_WINDOW_SIZE
+#define GNRC_TFTP_MAX_WINDOW_SIZE           (8)
+#endif
+
 /**
  * @brief The number of retries that must be made before stopping a transfer
  */
@@ -130,6 +157,10 @@ typedef bool (*tftp_start_cb_t)(tftp_action_t action, tftp_mode_t mode,
 
 /**
  * @brief   callback define which is called to get or set data from/to the user application
+ *
+ * When sending, the data of a block may be requested again to retransmit it,
+ * in a window blocks are requested in order. Returning a negative value
+ * aborts the transfer with an error sent to the peer.
  */
 typedef int (*tftp_data_cb_t)(uint32_t offset, void *data, size_t data_len);
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_tftp_mtd TFTP flash streaming
+ * @ingroup     net_gnrc_tftp
+ * @brief       Streams a TFTP transfer from or to a region of a MTD
+ *
+ * Set the region before the transfer and pass @ref gnrc_tftp_mtd_data_cb as
+ * data callback. A received transfer is written to the region as its blocks
+ * arrive, erasing every sector before the first write to it, e.g. to store a
+ * firmware image without buffering it in RAM. Only one region can be
+ * streamed at a time.
+ *
+ * @{
+ *
+ * @file
+ * @brief       TFTP flash streaming definitions
+ */
+
+#ifndef NET_GNRC_TFTP_MTD_H
+#define NET_GNRC_TFTP_MTD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* not "mtd.h", that is this header */
+#include <mtd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Sets the region to stream
+ *
+ * @pre @p addr is aligned to a sector when @p write is set
+ *
+ * @param[in] dev       The MTD.
+ * @param[in] addr      Start address of the region.
+ * @param[in] size      Size of the region, the transfer size when sending.
+ * @param[in] write     Set to receive a transfer into the region.
+ */
+void gnrc_tftp_mtd_set(mtd_dev_t *dev, uint32_t addr, uint32_t size,
+                       bool write);
+
+/**
+ * @brief   Data callback reading or writing a block of the region
+ *
+ * @see tftp_data_cb_t
+ */
+int gnrc_tftp_mtd_data_cb(uint32_t offset, void *data, size_t data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_TFTP_MTD_H */
+/** @} */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_tftp_vfs TFTP file streaming
+ * @ingroup     net_gnrc_tftp
+ * @brief       Streams a TFTP transfer from or to a file
+ *
+ * Open the file before the transfer and pass @ref gnrc_tftp_vfs_data_cb as
+ * data callback, every block is read from or written to the file at its
+ * offset. Only one file can be streamed at a time.
+ *
+ * @{
+ *
+ * @file
+ * @brief       TFTP file streaming definitions
+ */
+
+#ifndef NET_GNRC_TFTP_VFS_H
+#define NET_GNRC_TFTP_VFS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Opens the file to stream
+ *
+ * @param[in] path      Path of the file.
+ * @param[in] flags     O_RDONLY to send the file, O_WRONLY with O_CREAT and
+ *                      O_TRUNC to receive it.
+ * @param[out] size     Size of the file, may be NULL.
+ *
+ * @return  0 on success.
+ * @return  -EBUSY if a file is open already.
+ * @return  negative errno of @ref vfs_open on error.
+ */
+int gnrc_tftp_vfs_open(const char *path, int flags, size_t *size);
+
+/**
+ * @brief   Data callback reading or writing a block of the open file
+ *
+ * @see tftp_data_cb_t
+ */
+int gnrc_tftp_vfs_data_cb(uint32_t offset, void *data, size_t data_len);
+
+/**
+ * @brief   Closes the file after the transfer
+ */
+void gnrc_tftp_vfs_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_TFTP_VFS_H */
+/** @} */
@@ -47,7 +47,6 @@ extern "C" {
  * @name    Nanocoap specific maximum values
  * @{
  */
-#define NANOCOAP_NOPTS_MAX      (16)
 #define NANOCOAP_URI_MAX        (64)
 /** @} */
 
@@ -67,6 +66,8 @@ extern "C" {
 #define COAP_OPT_URI_QUERY      (15)
 #define COAP_OPT_BLOCK2         (23)
 #define COAP_OPT_BLOCK1         (27)
+#define COAP_OPT_SIZE2          (28)
+#define COAP_OPT_SIZE1          (60)
 /** @} */
 
 /**
@@ -128,6 +129,7 @@ extern "C" {
 #define COAP_CODE_CONTENT      ((2 << 5) | 5)
 #define COAP_CODE_205          ((2 << 5) | 5)
 #define COAP_CODE_231          ((2 << 5) | 31)
+#define COAP_CODE_CONTINUE     ((2 << 5) | 31)
 /** @} */
 
 /**
@@ -234,24 +236,20 @@ typedef struct __attribute__((packed)) {
     uint8_t data[];             /**< convenience pointer to payload start   */
 } coap_hdr_t;
 
-/**
- * @brief   CoAP option array entry
- */
-typedef struct {
-    uint16_t opt_num;           /**< full CoAP option number    */
-    uint16_t offset;            /**< offset in packet           */
-} coap_optpos_t;
-
 /**
  * @brief   CoAP PDU parsing context structure
+ *
+ * Options are not decoded into the structure, they are found by walking the
+ * packet when asked for (see coap_find_option() and coap_optiter_next()).
  */
 typedef struct {
     coap_hdr_t *hdr;                            /**< pointer to raw packet   */
     uint8_t *token;                             /**< pointer to token        */
     uint8_t *payload;                           /**< pointer to payload      */
     uint16_t payload_len;                       /**< length of payload       */
-    uint16_t options_len;                       /**< length of options array */
-    coap_optpos_t options[NANOCOAP_NOPTS_MAX];  /**< option offset array     */
+    uint16_t options_end;                       /**< offset of the end of the
+                                                     options in packet       */
+    uint16_t options_last;                      /**< number of last option   */
 #ifdef MODULE_GCOAP
     uint8_t url[NANOCOAP_URI_MAX];              /**< parsed request URL      */
     uint8_t qs[NANOCOAP_QS_MAX];                /**< parsed query string     */
@@ -260,6 +258,15 @@ typedef struct {
 #endif
 } coap_pkt_t;
 
+/**
+ * @brief   Iterator over the options of a packet
+ */
+typedef struct {
+    uint8_t *pos;                   /**< header of the next option          */
+    uint8_t *end;                   /**< end of the options                 */
+    uint16_t opt_num;               /**< number of the current option       */
+} coap_optiter_t;
+
 /**
  * @brief   Resource handler type
  */
@@ -287,7 +294,7 @@ typedef struct {
 } coap_block1_t;
 
 /**
- * @brief   Global CoAP resource list
+ * @brief   Global CoAP resource list, sorted alphabetically by path
  */
 extern const coap_resource_t coap_resources[];
 
@@ -390,6 +397,108 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
 ssize_t coap_build_hdr(coap_hdr_t *hdr, unsigned type, uint8_t *token,
                        size_t token_len, unsigned code, uint16_t id);
 
+/**
+ * @name    Flags for coap_opt_finish()
+ * @{
+ */
+#define COAP_OPT_FINISH_NONE    (0x0000)    /**< no payload follows         */
+#define COAP_OPT_FINISH_PAYLOAD (0x0001)    /**< write the payload marker   */
+/** @} */
+
+/**
+ * @brief   Initializes a packet for writing options with coap_opt_add_*()
+ *
+ * The header (and token) must already be in @p buf, e.g. written with
+ * coap_build_hdr().
+ *
+ * Options can be added in any order: an option is inserted behind all options
+ * with a number lower or equal to its own, so only the options already
+ * written are ever moved. Adding them in ascending order just appends them.
+ * coap_opt_finish() concludes the options and sets coap_pkt_t::payload
+ * directly behind them, so the payload is written in place.
+ *
+ * @param[out]  pkt         packet to initialize
+ * @param[in]   buf         buffer holding the header
+ * @param[in]   len         length of @p buf
+ * @param[in]   header_len  length of the header including the token
+ */
+void coap_pkt_init(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                   size_t header_len);
+
+/**
+ * @brief   Adds an option with an opaque value
+ *
+ * Options may only be written up to coap_pkt_t::payload +
+ * coap_pkt_t::payload_len.
+ *
+ * @param[in,out]   pkt     packet to add the option to
+ * @param[in]       optnum  option number
+ * @param[in]       val     option value
+ * @param[in]       val_len length of @p val
+ *
+ * @returns     number of bytes the options grew by
+ * @returns     -ENOSPC, if the option does not fit
+ */
+ssize_t coap_opt_add_opaque(coap_pkt_t *pkt, uint16_t optnum,
+                            const uint8_t *val, size_t val_len);
+
+/**
+ * @brief   Adds an option with an unsigned integer value
+ *
+ * @param[in,out]   pkt     packet to add the option to
+ * @param[in]       optnum  option number
+ * @param[in]       value   option value, encoded in as few bytes as possible
+ *
+ * @returns     number of bytes the options grew by
+ * @returns     -ENOSPC, if the option does not fit
+ */
+ssize_t coap_opt_add_uint(coap_pkt_t *pkt, uint16_t optnum, uint32_t value);
+
+/**
+ * @brief   Adds a string as one option per separated part
+ *
+ * E.g. "/a/b" with separator '/' adds the options "a" and "b". Empty parts
+ * are skipped.
+ *
+ * @param[in,out]   pkt         packet to add the options to
+ * @param[in]       optnum      option number, e.g. COAP_OPT_URI_PATH
+ * @param[in]       string      string to split, null-terminated
+ * @param[in]       separator   separator of the parts, e.g. '/'
+ *
+ * @returns     number of bytes the options grew by
+ * @returns     -ENOSPC, if the options do not fit
+ */
+ssize_t coap_opt_add_string(coap_pkt_t *pkt, uint16_t optnum,
+                            const char *string, char separator);
+
+/**
+ * @brief   Adds a Content-Format option
+ *
+ * @param[in,out]   pkt     packet to add the option to
+ * @param[in]       format  content format, e.g. COAP_FORMAT_TEXT
+ *
+ * @returns     number of bytes the options grew by
+ * @returns     -ENOSPC, if the option does not fit
+ */
+static inline ssize_t coap_opt_add_format(coap_pkt_t *pkt, uint16_t format)
+{
+    return coap_opt_add_uint(pkt, COAP_OPT_CONTENT_FORMAT, format);
+}
+
+/**
+ * @brief   Concludes the options of a packet
+ *
+ * Sets coap_pkt_t::payload behind the options (and the payload marker) and
+ * coap_pkt_t::payload_len to the space left in the buffer.
+ *
+ * @param[in,out]   pkt     packet to finish
+ * @param[in]       flags   COAP_OPT_FINISH_PAYLOAD, if a payload follows
+ *
+ * @returns     length of the packet without payload
+ * @returns     -ENOSPC, if there is no space for the payload marker
+ */
+ssize_t coap_opt_finish(coap_pkt_t *pkt, uint16_t flags);
+
 /**
  * @brief   Insert a CoAP option into buffer
  *
@@ -499,6 +608,34 @@ size_t coap_put_option_block1(uint8_t *buf, uint16_t lastonum, unsigned blknum,
  */
 size_t coap_put_block1_ok(uint8_t *pkt_pos, coap_block1_t *block1, uint16_t lastonum);
 
+/**
+ * @brief    Block2 option getter
+ *
+ * Same as coap_get_block1(), for the block2 option. In a request, the block
+ * number and SZX value request a block of the response.
+ *
+ * @param[in]   pkt     pkt to work on
+ * @param[out]  block2  ptr to preallocated coap_block1_t structure
+ *
+ * @returns     0 if block2 option not present
+ * @returns     1 if structure has been filled
+ */
+int coap_get_block2(coap_pkt_t *pkt, coap_block1_t *block2);
+
+/**
+ * @brief   Insert block2 option into buffer
+ *
+ * @param[out]  buf         buffer to write to
+ * @param[in]   lastonum    number of previous option (for delta calculation),
+ *                          must be < 23
+ * @param[in]   blknum      block number
+ * @param[in]   szx         SXZ value
+ * @param[in]   more        more flag (1 or 0)
+ *
+ * @returns     amount of bytes written to @p buf
+ */
+size_t coap_put_option_block2(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more);
+
 /**
  * @brief   Get content type from packet
  *
@@ -509,6 +646,57 @@ size_t coap_put_block1_ok(uint8_t *pkt_pos, coap_block1_t *block1, uint16_t last
  */
 unsigned coap_get_content_type(coap_pkt_t *pkt);
 
+/**
+ * @brief   Find the first option of a given number
+ *
+ * @param[in]   pkt     packet to work on
+ * @param[in]   opt_num option number to look for
+ *
+ * @returns     position of the option's header in @p pkt
+ * @returns     NULL, if @p pkt has no option @p opt_num
+ */
+uint8_t *coap_find_option(coap_pkt_t *pkt, unsigned opt_num);
+
+/**
+ * @brief   Initializes an iterator over the options of @p pkt
+ *
+ * @param[in]   pkt     packet to work on
+ * @param[out]  iter    iterator to initialize
+ */
+void coap_optiter_init(coap_pkt_t *pkt, coap_optiter_t *iter);
+
+/**
+ * @brief   Returns the next option of a packet
+ *
+ * Options are returned in the order of the packet, i.e. with ascending
+ * numbers. The number of the option is in coap_optiter_t::opt_num.
+ *
+ * @param[in,out]   iter    iterator initialized with coap_optiter_init()
+ * @param[out]      opt_len length of the option's value
+ *
+ * @returns     pointer to the option's value
+ * @returns     NULL, if there is no further option
+ */
+uint8_t *coap_optiter_next(coap_optiter_t *iter, int *opt_len);
+
+/**
+ * @brief   Iterate over the values of a repeatable option
+ *
+ * Start with @p optpos set to the result of coap_find_option() and @p first
+ * set. On return, @p optpos points to the header of the next option or is
+ * NULL, if there is no further option.
+ *
+ * @param[in]       pkt     packet to work on
+ * @param[in,out]   optpos  position of the option header to parse
+ * @param[out]      opt_len length of the returned value
+ * @param[in]       first   non-zero for the first value of the option
+ *
+ * @returns     pointer to the option's value
+ * @returns     NULL, if the option at @p optpos is a different option
+ */
+uint8_t *coap_iterate_option(coap_pkt_t *pkt, uint8_t **optpos,
+                             int *opt_len, int first);
+
 /**
  * @brief   Get the packet's request URI
  *
@@ -537,6 +725,26 @@ static inline unsigned coap_szx2size(unsigned szx)
     return (1 << (szx + 4));
 }
 
+/**
+ * @brief    Helper to find the largest SZX value for a block size
+ *
+ * @param[in]   size    maximum block size in bytes, at least 16
+ *
+ * @returns     largest SZX value with a block size of at most @p size,
+ *              limited to 6 (1024 bytes)
+ */
+static inline unsigned coap_size2szx(size_t size)
+{
+    unsigned szx = 0;
+
+    assert(size >= 16);
+    while ((szx < (COAP_BLOCKWISE_SZX_MAX - 1)) &&
+           (coap_szx2size(szx + 1) <= size)) {
+        szx++;
+    }
+    return szx;
+}
+
 /**
  * @brief   Get the CoAP version number
  *
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_nanocoap_block  Blockwise transfers
+ * @ingroup     net_nanocoap
+ * @brief       Streaming blockwise transfers (RFC 7959) for resource handlers
+ *
+ * The functions of this module answer a request for a resource that is
+ * larger than a single message, one block at a time. The representation is
+ * never held in memory as a whole: a callback reads each block of a GET
+ * response (Block2) into the response buffer, or takes each block of a PUT
+ * or POST request (Block1) straight from the request buffer. So RAM usage is
+ * bounded by the message buffer the handler already has.
+ *
+ * Both work for nanocoap and @ref net_gcoap handlers, e.g.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * static ssize_t _fw_handler(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+ *                            void *ctx)
+ * {
+ *     if (coap_get_code_detail(pkt) == COAP_METHOD_GET) {
+ *         return coap_block2_reply(pkt, COAP_CODE_CONTENT, buf, len,
+ *                                  COAP_CT_OCTET_STREAM, coap_block_mtd_read,
+ *                                  ctx);
+ *     }
+ *     return coap_block1_reply(pkt, COAP_CODE_CHANGED, buf, len,
+ *                              coap_block_mtd_write, ctx);
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Callbacks for @ref sys_vfs files and @ref drivers_mtd devices are provided.
+ * A client fetches a representation block by block with
+ * nanocoap_get_blockwise_next().
+ *
+ * @{
+ *
+ * @file
+ * @brief       nanocoap blockwise transfer definitions
+ */
+
+#ifndef NET_NANOCOAP_BLOCK_H
+#define NET_NANOCOAP_BLOCK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "net/nanocoap.h"
+#ifdef MODULE_MTD
+#include "mtd.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Largest SZX value used for Block2 responses
+ *
+ * The block size actually used is also limited by the client's request and by
+ * the space in the response buffer.
+ */
+#ifndef NANOCOAP_BLOCK_SZX_MAX
+#define NANOCOAP_BLOCK_SZX_MAX      (6)
+#endif
+
+/**
+ * @brief   Reads a chunk of a representation
+ *
+ * @param[in] arg       Context of the callback
+ * @param[in] offset    Offset of the chunk within the representation
+ * @param[out] buf      Buffer for the chunk
+ * @param[in] len       Maximum length of the chunk
+ *
+ * @return  Length of the chunk, less than @p len only at the end of the
+ *          representation
+ * @return  < 0 on error
+ */
+typedef ssize_t (*coap_block_read_t)(void *arg, size_t offset, uint8_t *buf,
+                                     size_t len);
+
+/**
+ * @brief   Writes a chunk of a representation
+ *
+ * @param[in] arg       Context of the callback
+ * @param[in] offset    Offset of the chunk within the representation
+ * @param[in] buf       The chunk
+ * @param[in] len       Length of the chunk
+ * @param[in] more      true, if more chunks follow
+ *
+ * @return  0 on success
+ * @return  -ENOSPC, if the representation is too large
+ * @return  -EINVAL, if @p offset is out of order
+ * @return  other negative errno on error
+ */
+typedef int (*coap_block_write_t)(void *arg, size_t offset, const uint8_t *buf,
+                                  size_t len, bool more);
+
+/**
+ * @brief   Builds the response to a GET request with a block of the
+ *          representation (Block2)
+ *
+ * The block requested by the Block2 option of @p pkt (the first one, if
+ * there is none) is read with @p read directly into @p buf. The block size
+ * is the smallest of the one requested, @ref NANOCOAP_BLOCK_SZX_MAX, and the
+ * largest that fits into @p buf.
+ *
+ * @param[in] pkt       The request
+ * @param[in] code      Response code (e.g. COAP_CODE_CONTENT)
+ * @param[out] buf      Buffer for the response, may be the request buffer
+ * @param[in] len       Length of @p buf
+ * @param[in] ct        Content-Format of the representation
+ * @param[in] read      Reads the block
+ * @param[in] arg       Context for @p read
+ *
+ * @return  Length of the response in @p buf
+ * @return  -ENOSPC, if @p buf can't hold a block of 16 bytes
+ */
+ssize_t coap_block2_reply(coap_pkt_t *pkt, unsigned code, uint8_t *buf,
+                          size_t len, unsigned ct, coap_block_read_t read,
+                          void *arg);
+
+/**
+ * @brief   Passes a block of a PUT or POST request (Block1) to a callback
+ *          and builds the response
+ *
+ * The payload is passed to @p write as it is, in the request buffer. The
+ * response is 2.31 (Continue) while more blocks follow and @p code for the
+ * last one, or an error code if @p write fails.
+ *
+ * @param[in] pkt       The request
+ * @param[in] code      Response code for the last block (e.g.
+ *                      COAP_CODE_CHANGED)
+ * @param[out] buf      Buffer for the response, may be the request buffer
+ * @param[in] len       Length of @p buf
+ * @param[in] write     Writes the block
+ * @param[in] arg       Context for @p write
+ *
+ * @return  Length of the response in @p buf
+ * @return  < 0 on error
+ */
+ssize_t coap_block1_reply(coap_pkt_t *pkt, unsigned code, uint8_t *buf,
+                          size_t len, coap_block_write_t write, void *arg);
+
+#if defined(MODULE_VFS) || defined(DOXYGEN)
+/**
+ * @brief   Reads a chunk from a file
+ *
+ * @param[in] arg   Pointer to the file descriptor (`int *`)
+ *
+ * @see coap_block_read_t
+ */
+ssize_t coap_block_vfs_read(void *arg, size_t offset, uint8_t *buf, size_t len);
+
+/**
+ * @brief   Writes a chunk to a file
+ *
+ * The last chunk truncates the file behind it, so a shorter representation
+ * replaces a file completely. On file systems that can't truncate files
+ * (see vfs_ftruncate()), open the file with `O_TRUNC` instead; otherwise
+ * the last chunk fails with -ENOTSUP if the file was longer.
+ *
+ * @param[in] arg   Pointer to the file descriptor (`int *`)
+ *
+ * @see coap_block_write_t
+ */
+int coap_block_vfs_write(void *arg, size_t offset, const uint8_t *buf,
+                         size_t len, bool more);
+#endif
+
+#if defined(MODULE_MTD) || defined(DOXYGEN)
+/**
+ * @brief   Area of a MTD device holding a representation
+ */
+typedef struct {
+    mtd_dev_t *dev;         /**< The device */
+    uint32_t addr;          /**< Start of the area, aligned to a sector */
+    uint32_t size;          /**< Size of the area */
+} coap_block_mtd_t;
+
+/**
+ * @brief   Reads a chunk from an area of a MTD device
+ *
+ * The representation spans the whole area.
+ *
+ * @param[in] arg   Pointer to the area (`coap_block_mtd_t *`)
+ *
+ * @see coap_block_read_t
+ */
+ssize_t coap_block_mtd_read(void *arg, size_t offset, uint8_t *buf, size_t len);
+
+/**
+ * @brief   Writes a chunk to an area of a MTD device
+ *
+ * Each sector is erased when the first chunk starting in it is written, so
+ * chunks must be written in order.
+ *
+ * @param[in] arg   Pointer to the area (`coap_block_mtd_t *`)
+ *
+ * @see coap_block_write_t
+ */
+int coap_block_mtd_write(void *arg, size_t offset, const uint8_t *buf,
+                         size_t len, bool more);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NANOCOAP_BLOCK_H */
+/** @} */
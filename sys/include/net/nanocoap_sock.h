@@ -20,6 +20,7 @@
 #ifndef NET_NANOCOAP_SOCK_H
 #define NET_NANOCOAP_SOCK_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <unistd.h>
 
@@ -57,6 +58,59 @@ int nanocoap_server(sock_udp_ep_t *local, uint8_t *buf, size_t bufsize);
 ssize_t nanocoap_get(sock_udp_ep_t *remote, const char *path, uint8_t *buf,
                      size_t len);
 
+/**
+ * @brief   State of a blockwise GET (Block2)
+ *
+ * @see nanocoap_get_blockwise_init()
+ */
+typedef struct {
+    sock_udp_ep_t remote;   /**< remote UDP endpoint */
+    const char *path;       /**< remote path */
+    uint8_t *buf;           /**< buffer for requests and responses */
+    size_t len;             /**< length of nanocoap_blockwise_t::buf */
+    size_t offset;          /**< offset of the next block */
+    uint16_t id;            /**< message ID of the last request */
+    uint8_t szx;            /**< SZX value of the next request */
+    bool done;              /**< true, if the last block was received */
+} nanocoap_blockwise_t;
+
+/**
+ * @brief   Initializes a blockwise GET
+ *
+ * The representation at @p path is fetched block by block with
+ * nanocoap_get_blockwise_next(), so it is never held in memory as a whole.
+ * The block size is the largest one whose response fits into @p buf; the
+ * server may choose a smaller one.
+ *
+ * @param[out]  ctx     state of the transfer
+ * @param[in]   remote  remote UDP endpoint
+ * @param[in]   path    remote path, must stay valid during the transfer
+ * @param[in]   buf     buffer for requests and responses
+ * @param[in]   len     length of @p buf
+ *
+ * @returns     0 on success
+ * @returns     -ENOBUFS, if @p buf is too small for a block of 16 bytes
+ */
+int nanocoap_get_blockwise_init(nanocoap_blockwise_t *ctx,
+                                const sock_udp_ep_t *remote, const char *path,
+                                uint8_t *buf, size_t len);
+
+/**
+ * @brief   Fetches the next block of a blockwise GET
+ *
+ * @param[in,out]   ctx     state of the transfer
+ * @param[out]      chunk   start of the block within nanocoap_blockwise_t::buf,
+ *                          valid until the next call
+ *
+ * @returns     length of the block
+ * @returns     0, if the last block was already received
+ * @returns     -EBADMSG, if the response is not the requested block
+ * @returns     negative CoAP response code, if it is not 2.05
+ * @returns     other negative errno on error
+ */
+ssize_t nanocoap_get_blockwise_next(nanocoap_blockwise_t *ctx,
+                                    uint8_t **chunk);
+
 #ifdef __cplusplus
 }
 #endif
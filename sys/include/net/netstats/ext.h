@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_netstats_ext Extended packet statistics
+ * @ingroup     net_netstats
+ * @brief       Drop reasons, receive latencies and packet rates across the
+ *              network stack
+ *
+ * In addition to the cumulative counters of @ref net_netstats this module
+ * keeps, for the whole node:
+ *
+ * - drop counters per layer and reason (see @ref netstats_ext_drop_t),
+ * - histograms of the time a received packet took from the network device
+ *   to a layer (see @ref netstats_ext_hist_t). The receive time is kept in
+ *   the packet's first snip (gnrc_pktsnip_t::rx_time), so it survives all
+ *   in-place processing of the packet. Packets reassembled or decompressed
+ *   into new snips lose it and are not accounted in later layers.
+ * - packet and byte rates over a sliding window of
+ *   @ref NETSTATS_EXT_RATE_WINDOW seconds (see @ref netstats_ext_rate_t).
+ *
+ * The counters are updated without locking from the threads of the
+ * respective layers, just like the counters of @ref net_netstats.
+ *
+ * Use the `netstats` shell command to show the statistics, `netstats -j`
+ * for a machine-readable JSON dump.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Extended packet statistics definitions
+ */
+#ifndef NET_NETSTATS_EXT_H
+#define NET_NETSTATS_EXT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of latency histogram buckets
+ *
+ * Bucket 0 counts latencies below 2^@ref NETSTATS_EXT_HIST_SHIFT us, every
+ * following bucket covers twice the range of the previous one and the last
+ * bucket counts everything above.
+ */
+#ifndef NETSTATS_EXT_HIST_BUCKETS
+#define NETSTATS_EXT_HIST_BUCKETS   (12U)
+#endif
+
+/**
+ * @brief   Binary logarithm of the upper bound in microseconds of the first
+ *          latency histogram bucket
+ */
+#ifndef NETSTATS_EXT_HIST_SHIFT
+#define NETSTATS_EXT_HIST_SHIFT     (4U)
+#endif
+
+/**
+ * @brief   Length of the sliding window for rate calculation in seconds
+ */
+#ifndef NETSTATS_EXT_RATE_WINDOW
+#define NETSTATS_EXT_RATE_WINDOW    (4U)
+#endif
+
+/**
+ * @brief   Layers statistics are kept for
+ */
+typedef enum {
+    NETSTATS_EXT_LAYER_L2 = 0,      /**< network interface */
+    NETSTATS_EXT_LAYER_6LO,         /**< 6LoWPAN */
+    NETSTATS_EXT_LAYER_IPV6,        /**< IPv6 */
+    NETSTATS_EXT_LAYER_TRANSPORT,   /**< UDP, TCP and ICMPv6 */
+    NETSTATS_EXT_LAYER_SOCK,        /**< delivery to a sock */
+    NETSTATS_EXT_LAYER_NUMOF,       /**< number of layers */
+} netstats_ext_layer_t;
+
+/**
+ * @brief   Reasons a packet was dropped for
+ */
+typedef enum {
+    NETSTATS_EXT_DROP_PKTBUF_FULL = 0,  /**< packet buffer full */
+    NETSTATS_EXT_DROP_QUEUE_FULL,       /**< message or transmission queue full */
+    NETSTATS_EXT_DROP_RBUF_FULL,        /**< reassembly buffer full */
+    NETSTATS_EXT_DROP_CSUM,             /**< checksum error */
+    NETSTATS_EXT_DROP_NO_ROUTE,         /**< no route to destination */
+    NETSTATS_EXT_DROP_NUMOF,            /**< number of drop reasons */
+} netstats_ext_drop_t;
+
+/**
+ * @brief   Latency histogram
+ */
+typedef struct {
+    uint32_t buckets[NETSTATS_EXT_HIST_BUCKETS];    /**< packets per bucket */
+    uint32_t count;                 /**< number of samples */
+    uint32_t min;                   /**< smallest sample in us */
+    uint32_t max;                   /**< largest sample in us */
+    uint64_t sum;                   /**< sum of all samples in us */
+} netstats_ext_hist_t;
+
+/**
+ * @brief   One second slot of a @ref netstats_ext_rate_t
+ */
+typedef struct {
+    uint32_t sec;                   /**< second the slot was last used for */
+    uint32_t rx_count;              /**< packets received in that second */
+    uint32_t rx_bytes;              /**< bytes received in that second */
+    uint32_t tx_count;              /**< packets sent in that second */
+    uint32_t tx_bytes;              /**< bytes sent in that second */
+} netstats_ext_rate_slot_t;
+
+/**
+ * @brief   Sliding window packet and byte counter
+ */
+typedef struct {
+    netstats_ext_rate_slot_t slots[NETSTATS_EXT_RATE_WINDOW];   /**< ring of slots */
+} netstats_ext_rate_t;
+
+/**
+ * @brief   Rates as calculated by netstats_ext_rate_get()
+ */
+typedef struct {
+    uint32_t rx_count;              /**< received packets per second */
+    uint32_t rx_bytes;              /**< received bytes per second */
+    uint32_t tx_count;              /**< sent packets per second */
+    uint32_t tx_bytes;              /**< sent bytes per second */
+} netstats_ext_rates_t;
+
+/**
+ * @brief   All extended statistics
+ */
+typedef struct {
+    /** drop counters per layer and reason */
+    uint32_t drops[NETSTATS_EXT_LAYER_NUMOF][NETSTATS_EXT_DROP_NUMOF];
+    /** receive latencies per layer */
+    netstats_ext_hist_t latency[NETSTATS_EXT_LAYER_NUMOF];
+    /** packet rates per layer */
+    netstats_ext_rate_t rate[NETSTATS_EXT_LAYER_NUMOF];
+} netstats_ext_t;
+
+/**
+ * @brief   Gets the extended statistics of the node
+ *
+ * @return  The extended statistics.
+ */
+const netstats_ext_t *netstats_ext_get(void);
+
+/**
+ * @brief   Resets all extended statistics
+ */
+void netstats_ext_reset(void);
+
+/**
+ * @brief   Gets the current time as used for gnrc_pktsnip_t::rx_time
+ *
+ * @return  Current time in microseconds. Never 0, since 0 marks a packet
+ *          without receive time.
+ */
+uint32_t netstats_ext_now(void);
+
+/**
+ * @brief   Accounts a dropped packet
+ *
+ * @param[in] layer     The layer that dropped the packet.
+ * @param[in] reason    The reason the packet was dropped for.
+ */
+void netstats_ext_drop(netstats_ext_layer_t layer, netstats_ext_drop_t reason);
+
+/**
+ * @brief   Accounts a received packet in the rate of a layer
+ *
+ * @param[in] layer     A layer.
+ * @param[in] bytes     Size of the packet.
+ */
+void netstats_ext_rx(netstats_ext_layer_t layer, size_t bytes);
+
+/**
+ * @brief   Accounts a sent packet in the rate of a layer
+ *
+ * @param[in] layer     A layer.
+ * @param[in] bytes     Size of the packet.
+ */
+void netstats_ext_tx(netstats_ext_layer_t layer, size_t bytes);
+
+/**
+ * @brief   Accounts the time a received packet took to reach a layer
+ *
+ * @param[in] layer     The layer the packet reached.
+ * @param[in] rx_time   Time the packet was received at in microseconds as
+ *                      returned by netstats_ext_now(). 0 if unknown, in
+ *                      which case nothing is accounted.
+ */
+void netstats_ext_latency(netstats_ext_layer_t layer, uint32_t rx_time);
+
+/**
+ * @brief   Adds a sample to a latency histogram
+ *
+ * @pre `hist != NULL`
+ *
+ * @param[in,out] hist  A latency histogram.
+ * @param[in] usec      The sample in microseconds.
+ */
+void netstats_ext_hist_add(netstats_ext_hist_t *hist, uint32_t usec);
+
+/**
+ * @brief   Adds a packet to a sliding window counter
+ *
+ * @pre `rate != NULL`
+ *
+ * @param[in,out] rate  A sliding window counter.
+ * @param[in] sec       Current time in seconds.
+ * @param[in] tx        Packet was sent, not received.
+ * @param[in] bytes     Size of the packet.
+ */
+void netstats_ext_rate_add(netstats_ext_rate_t *rate, uint32_t sec, bool tx,
+                           size_t bytes);
+
+/**
+ * @brief   Calculates the rates of a sliding window counter
+ *
+ * The rates are averaged over the last @ref NETSTATS_EXT_RATE_WINDOW
+ * seconds up to and including @p sec.
+ *
+ * @pre `(rate != NULL) && (res != NULL)`
+ *
+ * @param[in] rate  A sliding window counter.
+ * @param[in] sec   Current time in seconds.
+ * @param[out] res  The rates.
+ */
+void netstats_ext_rate_get(const netstats_ext_rate_t *rate, uint32_t sec,
+                           netstats_ext_rates_t *res);
+
+/**
+ * @brief   Gets the rates of a layer
+ *
+ * @pre `res != NULL`
+ *
+ * @param[in] layer     A layer.
+ * @param[out] res      The rates of @p layer.
+ */
+void netstats_ext_rates(netstats_ext_layer_t layer, netstats_ext_rates_t *res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETSTATS_EXT_H */
+/** @} */
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_netstats_neighbor Per-neighbor link statistics
+ * @ingroup     net_netstats
+ * @brief       Transmission statistics and ETX estimation per link-layer
+ *              neighbor
+ *
+ * A network interface records the link-layer destination of every unicast
+ * frame it sends and accounts the outcome reported by the network device
+ * (acknowledged, not acknowledged, or medium busy, plus the number of
+ * retransmissions if the device reports it via
+ * @ref NETOPT_TX_RETRIES_NEEDED) to that neighbor.
+ *
+ * From this the expected transmission count (ETX) of the link is estimated
+ * as an exponentially weighted moving average. It is kept as a fixed-point
+ * value with @ref NETSTATS_NB_ETX_DIVISOR as divisor, which is the encoding
+ * of the ETX link metric in RPL (RFC 6551).
+ *
+ * Devices that neither report missing ACKs nor retransmissions keep the ETX
+ * of all their links at 1.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Per-neighbor link statistics definitions
+ */
+#ifndef NET_NETSTATS_NEIGHBOR_H
+#define NET_NETSTATS_NEIGHBOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of neighbors statistics are kept for per interface
+ *
+ * If the table is full, the neighbor used least recently is replaced.
+ */
+#ifndef NETSTATS_NB_SIZE
+#define NETSTATS_NB_SIZE            (8U)
+#endif
+
+/**
+ * @brief   Maximum length of a link-layer address in the table
+ */
+#ifndef NETSTATS_NB_L2ADDR_MAXLEN
+#define NETSTATS_NB_L2ADDR_MAXLEN   (8U)
+#endif
+
+/**
+ * @brief   Divisor of the fixed-point ETX value
+ */
+#define NETSTATS_NB_ETX_DIVISOR     (128U)
+
+/**
+ * @brief   Binary logarithm of the inverse smoothing factor of the ETX
+ *          moving average
+ *
+ * Every new sample contributes 1/2^@ref NETSTATS_NB_ETX_SHIFT to the ETX.
+ */
+#ifndef NETSTATS_NB_ETX_SHIFT
+#define NETSTATS_NB_ETX_SHIFT       (3U)
+#endif
+
+/**
+ * @brief   ETX sample accounted for a frame that was not acknowledged
+ */
+#ifndef NETSTATS_NB_ETX_NOACK
+#define NETSTATS_NB_ETX_NOACK       (8U)
+#endif
+
+/**
+ * @brief   Outcome of a transmission
+ */
+typedef enum {
+    NETSTATS_NB_TX_SUCCESS = 0,     /**< frame was acknowledged */
+    NETSTATS_NB_TX_NOACK,           /**< frame was not acknowledged */
+    NETSTATS_NB_TX_BUSY,            /**< medium was busy, nothing was sent */
+} netstats_nb_tx_t;
+
+/**
+ * @brief   Statistics of a neighbor
+ */
+typedef struct {
+    uint8_t l2addr[NETSTATS_NB_L2ADDR_MAXLEN];  /**< link-layer address */
+    uint8_t l2addr_len;             /**< length of netstats_nb_t::l2addr, 0 if unused */
+    uint16_t etx;                   /**< ETX times @ref NETSTATS_NB_ETX_DIVISOR */
+    uint32_t tx_count;              /**< frames sent */
+    uint32_t tx_failed;             /**< frames not acknowledged or not sent */
+    uint32_t last_used;             /**< table clock at the last transmission */
+} netstats_nb_t;
+
+/**
+ * @brief   Statistics of all neighbors of an interface
+ */
+typedef struct {
+    netstats_nb_t nbs[NETSTATS_NB_SIZE];    /**< the neighbors */
+    netstats_nb_t *pending;         /**< neighbor of the frame currently sent */
+    uint32_t clock;                 /**< transmissions recorded so far */
+} netstats_nb_table_t;
+
+/**
+ * @brief   Initializes a table
+ *
+ * @pre `table != NULL`
+ *
+ * @param[out] table    A table.
+ */
+void netstats_nb_init(netstats_nb_table_t *table);
+
+/**
+ * @brief   Records the destination of a frame about to be sent
+ *
+ * The outcome reported with netstats_nb_update_tx() is accounted to this
+ * neighbor.
+ *
+ * @pre `table != NULL`
+ *
+ * @param[in,out] table     A table.
+ * @param[in] l2addr        Link-layer destination address. NULL for
+ *                          broadcast or multicast frames, which are not
+ *                          accounted.
+ * @param[in] l2addr_len    Length of @p l2addr.
+ */
+void netstats_nb_record(netstats_nb_table_t *table, const uint8_t *l2addr,
+                        size_t l2addr_len);
+
+/**
+ * @brief   Accounts the outcome of the frame recorded last
+ *
+ * @pre `table != NULL`
+ *
+ * @param[in,out] table     A table.
+ * @param[in] res           Outcome of the transmission.
+ * @param[in] retries       Number of retransmissions, 0 if unknown.
+ */
+void netstats_nb_update_tx(netstats_nb_table_t *table, netstats_nb_tx_t res,
+                           unsigned retries);
+
+/**
+ * @brief   Gets the statistics of a neighbor
+ *
+ * @pre `table != NULL`
+ *
+ * @param[in] table         A table.
+ * @param[in] l2addr        Link-layer address of the neighbor.
+ * @param[in] l2addr_len    Length of @p l2addr.
+ *
+ * @return  The statistics of the neighbor.
+ * @return  NULL, if no frame was sent to the neighbor.
+ */
+const netstats_nb_t *netstats_nb_get(const netstats_nb_table_t *table,
+                                     const uint8_t *l2addr,
+                                     size_t l2addr_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETSTATS_NEIGHBOR_H */
+/** @} */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_netstats_radio Radio duty cycle statistics
+ * @ingroup     net_netstats
+ * @brief       Time, transitions and energy per radio state
+ *
+ * A network interface accounts every change of the state of its radio, as
+ * set via @ref NETOPT_STATE or reported by the start and end of a reception
+ * or transmission. For every state the time spent in it and the number of
+ * times it was entered are kept, from which the duty cycle of the radio
+ * follows.
+ *
+ * The energy spent in every state is estimated from the time and a power
+ * model of the radio (see @ref netstats_radio_power_t). Since every frame
+ * enters the transmit or receive state once, the energy per frame is the
+ * energy of that state divided by its transitions.
+ *
+ * The MAC layers @ref net_gnrc_lwmac and @ref net_gnrc_gomach report all
+ * changes of the radio state, other interfaces only those set via
+ * gnrc_netapi.
+ *
+ * Use `ifconfig <if_id> stats radio` to show the statistics.
+ *
+ * @{
+ *
+ * @file
+ * @brief   Radio duty cycle statistics definitions
+ */
+#ifndef NET_NETSTATS_RADIO_H
+#define NET_NETSTATS_RADIO_H
+
+#include <stdint.h>
+
+#include "net/netopt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Radio states statistics are kept for
+ */
+typedef enum {
+    NETSTATS_RADIO_OFF = 0,         /**< powered off */
+    NETSTATS_RADIO_SLEEP,           /**< sleeping */
+    NETSTATS_RADIO_STANDBY,         /**< awake, but not listening */
+    NETSTATS_RADIO_LISTEN,          /**< listening, @ref NETOPT_STATE_IDLE */
+    NETSTATS_RADIO_RX,              /**< receiving a frame */
+    NETSTATS_RADIO_TX,              /**< transmitting a frame */
+    NETSTATS_RADIO_STATE_NUMOF,     /**< number of states */
+} netstats_radio_state_t;
+
+/**
+ * @brief   Power model of a radio
+ */
+typedef struct {
+    uint32_t current[NETSTATS_RADIO_STATE_NUMOF];   /**< current per state in nA */
+    uint16_t voltage;                               /**< supply voltage in mV */
+} netstats_radio_power_t;
+
+/**
+ * @brief   Default power model, the one of an at86rf233 at 3 V and 0 dBm
+ *
+ * A radio listening and receiving draws the same current. The standby
+ * current is the one of the TRX_OFF state.
+ */
+#ifndef NETSTATS_RADIO_POWER_DEFAULT
+#define NETSTATS_RADIO_POWER_DEFAULT \
+    { .current = { 0, 200, 300000, 11800000, 11800000, 13800000 }, \
+      .voltage = 3000 }
+#endif
+
+/**
+ * @brief   Radio statistics
+ */
+typedef struct {
+    uint64_t time[NETSTATS_RADIO_STATE_NUMOF];          /**< time per state in us */
+    uint32_t transitions[NETSTATS_RADIO_STATE_NUMOF];   /**< times a state was entered */
+    uint64_t since;                 /**< time the current state was entered at in us */
+    const netstats_radio_power_t *power;    /**< power model of the radio */
+    uint8_t state;                  /**< current state */
+} netstats_radio_t;
+
+/**
+ * @brief   Initializes the statistics of a radio
+ *
+ * The radio is assumed to be listening.
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[out] stats    The statistics.
+ * @param[in] power     Power model of the radio, NULL for
+ *                      @ref NETSTATS_RADIO_POWER_DEFAULT.
+ * @param[in] now       Current time in us.
+ */
+void netstats_radio_init(netstats_radio_t *stats,
+                         const netstats_radio_power_t *power, uint64_t now);
+
+/**
+ * @brief   Accounts a change of the radio state
+ *
+ * Changes to the current state are ignored.
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[in,out] stats The statistics.
+ * @param[in] state     The new state.
+ * @param[in] now       Current time in us.
+ */
+void netstats_radio_set(netstats_radio_t *stats, netstats_radio_state_t state,
+                        uint64_t now);
+
+/**
+ * @brief   Accounts a change of the radio state to a @ref NETOPT_STATE
+ *
+ * @ref NETOPT_STATE_RESET is accounted as @ref NETSTATS_RADIO_LISTEN, the
+ * state after a reset.
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[in,out] stats The statistics.
+ * @param[in] state     The new state.
+ */
+void netstats_radio_set_netopt(netstats_radio_t *stats, netopt_state_t state);
+
+/**
+ * @brief   Accounts the time in the current state up to now
+ *
+ * Call before reading the statistics.
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[in,out] stats The statistics.
+ * @param[in] now       Current time in us.
+ */
+void netstats_radio_update(netstats_radio_t *stats, uint64_t now);
+
+/**
+ * @brief   Resets the statistics, keeping the current state
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[in,out] stats The statistics.
+ * @param[in] now       Current time in us.
+ */
+void netstats_radio_reset(netstats_radio_t *stats, uint64_t now);
+
+/**
+ * @brief   Gets the energy spent in a state
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[in] stats     The statistics.
+ * @param[in] state     A state, @ref NETSTATS_RADIO_STATE_NUMOF for the
+ *                      energy spent in all states.
+ *
+ * @return  Energy in uJ.
+ */
+uint64_t netstats_radio_energy(const netstats_radio_t *stats,
+                               netstats_radio_state_t state);
+
+/**
+ * @brief   Gets the duty cycle of the radio
+ *
+ * The radio is considered on while it listens, receives or transmits.
+ *
+ * @pre `stats != NULL`
+ *
+ * @param[in] stats     The statistics.
+ *
+ * @return  The duty cycle in 1/100 %.
+ */
+unsigned netstats_radio_duty_cycle(const netstats_radio_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETSTATS_RADIO_H */
+/** @} */
@@ -12,6 +12,22 @@
  *
  * @brief       Sock DNS client
  *
+ * Resolves names via the DNS server set in @ref sock_dns_server.
+ *
+ * Threads asking for the same name and address family while a query for it
+ * is pending share that query instead of sending their own (see
+ * @ref SOCK_DNS_PENDING_NUMOF).
+ *
+ * With the module `sock_dns_cache` answers are kept for the time to live
+ * (TTL) of their record in a cache of @ref SOCK_DNS_CACHE_SIZE entries.
+ * Names that do not exist or have no address of the requested family are
+ * kept for @ref SOCK_DNS_CACHE_NEG_TTL seconds, so they are not asked for
+ * again and again. Timeouts are not cached.
+ *
+ * With the module `sock_dns_async` @ref sock_dns_query_async() resolves
+ * names in a resolver thread and calls back when done, so the calling thread
+ * is not blocked.
+ *
  * @{
  *
  * @file
@@ -24,6 +40,7 @@
 #define NET_SOCK_DNS_H
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <unistd.h>
 
@@ -61,6 +78,53 @@ typedef struct {
 #define SOCK_DNS_QUERYBUF_LEN   (sizeof(sock_dns_hdr_t) + 4 + SOCK_DNS_MAX_NAME_LEN)
 /** @} */
 
+/**
+ * @brief   Number of different names that can be queried at the same time
+ *
+ * Further queries for other names are sent without being shared.
+ */
+#ifndef SOCK_DNS_PENDING_NUMOF
+#define SOCK_DNS_PENDING_NUMOF  (2U)
+#endif
+
+/**
+ * @brief   Number of entries of the DNS cache
+ */
+#ifndef SOCK_DNS_CACHE_SIZE
+#define SOCK_DNS_CACHE_SIZE     (4U)
+#endif
+
+/**
+ * @brief   Time in seconds names without an address are cached for
+ */
+#ifndef SOCK_DNS_CACHE_NEG_TTL
+#define SOCK_DNS_CACHE_NEG_TTL  (30U)
+#endif
+
+/**
+ * @brief   Stack size of the resolver thread of @ref sock_dns_query_async()
+ */
+#ifndef SOCK_DNS_ASYNC_STACK_SIZE
+#define SOCK_DNS_ASYNC_STACK_SIZE   (THREAD_STACKSIZE_DEFAULT + 512 + \
+                                     SOCK_DNS_QUERYBUF_LEN)
+#endif
+
+/**
+ * @brief   Priority of the resolver thread of @ref sock_dns_query_async()
+ */
+#ifndef SOCK_DNS_ASYNC_PRIO
+#define SOCK_DNS_ASYNC_PRIO     (THREAD_PRIORITY_MAIN - 1)
+#endif
+
+/**
+ * @brief   Resolver statistics
+ */
+typedef struct {
+    uint32_t hits;          /**< queries answered from the cache */
+    uint32_t misses;        /**< queries sent to the server */
+    uint32_t coalesced;     /**< queries sharing a pending query */
+} sock_dns_stats_t;
+
 /**
  * @brief Get IP address for DNS name
  *
@@ -80,11 +144,121 @@ typedef struct {
  * @param[out]  addr_out        buffer to write result into
  * @param[in]   family          Either AF_INET, AF_INET6 or AF_UNSPEC
  *
- * @return      0 on success
- * @return      !=0 otherwise
+ * @return      length of the address on success
+ * @return      -ENOSPC, if @p domain_name is too long
+ * @return      -ENOENT, if @p domain_name has no address of @p family
+ * @return      -EAGAIN, if the server failed to answer the query, e.g. with
+ *              SERVFAIL or REFUSED
+ * @return      -EBADMSG, if the reply is malformed, e.g. an address record
+ *              of the wrong length
+ * @return      <0 on other errors
  */
 int sock_dns_query(const char *domain_name, void *addr_out, int family);
 
+/**
+ * @brief   Gets the resolver statistics
+ *
+ * @param[out] stats    The statistics.
+ * @param[in] reset     Reset the statistics after reading them.
+ */
+void sock_dns_stats(sock_dns_stats_t *stats, bool reset);
+
+/**
+ * @brief   Looks up a name in the DNS cache
+ *
+ * @note    Only available with module `sock_dns_cache`.
+ *
+ * @param[in] domain_name   DNS name to look up
+ * @param[out] addr_out     buffer to write the address into
+ * @param[in] family        Either AF_INET, AF_INET6 or AF_UNSPEC
+ *
+ * @return  length of the address, if the name is cached
+ * @return  -ENOENT, if the name is cached as having no address
+ * @return  0, if the name is not cached
+ */
+int sock_dns_cache_query(const char *domain_name, void *addr_out, int family);
+
+/**
+ * @brief   Adds an answer to the DNS cache
+ *
+ * An existing entry for @p domain_name and @p family is replaced. If the
+ * cache is full, the entry that expires first is replaced.
+ *
+ * @note    Only available with module `sock_dns_cache`.
+ *
+ * @param[in] domain_name   queried DNS name
+ * @param[in] addr          the address, NULL if the name has none
+ * @param[in] addr_len      length of @p addr, 0 if the name has no address
+ * @param[in] family        family the name was queried for
+ * @param[in] ttl           time to live in seconds
+ */
+void sock_dns_cache_add(const char *domain_name, const void *addr,
+                        int addr_len, int family, uint32_t ttl);
+
+/**
+ * @brief   Removes all entries from the DNS cache
+ *
+ * @note    Only available with module `sock_dns_cache`.
+ */
+void sock_dns_cache_flush(void);
+
+/**
+ * @brief   Asynchronous DNS query, see @ref sock_dns_query_async()
+ */
+typedef struct sock_dns_async sock_dns_async_t;
+
+/**
+ * @brief   Callback for a finished asynchronous DNS query
+ *
+ * Called in the context of the resolver thread.
+ *
+ * @param[in] req   The query.
+ * @param[in] res   Result as returned by @ref sock_dns_query().
+ * @param[in] addr  The address, if @p res > 0.
+ */
+typedef void (*sock_dns_async_cb_t)(sock_dns_async_t *req, int res,
+                                    const void *addr);
+
+/**
+ * @brief   Asynchronous DNS query
+ */
+struct sock_dns_async {
+    sock_dns_async_t *next;     /**< next pending query (internal) */
+    const char *domain_name;    /**< DNS name to resolve */
+    int family;                 /**< Either AF_INET, AF_INET6 or AF_UNSPEC */
+    sock_dns_async_cb_t cb;     /**< called when done */
+    void *arg;                  /**< argument for the user */
+};
+
+/**
+ * @brief   Initializes the resolver thread of @ref sock_dns_query_async()
+ *
+ * Called by auto_init.
+ */
+void sock_dns_async_init(void);
+
+/**
+ * @brief   Resolves a name without blocking the calling thread
+ *
+ * The query is resolved like by @ref sock_dns_query() in the resolver
+ * thread, which calls @p cb when done. Queries for the same name and family
+ * are answered together.
+ *
+ * @note    Only available with module `sock_dns_async`.
+ *
+ * @param[out] req          The query, must stay valid until @p cb is called.
+ * @param[in] domain_name   DNS name to resolve, must stay valid until @p cb
+ *                          is called
+ * @param[in] family        Either AF_INET, AF_INET6 or AF_UNSPEC
+ * @param[in] cb            Called when done.
+ * @param[in] arg           Argument for the user, stored in @p req.
+ *
+ * @return  0, if the query is pending
+ * @return  -ENOSPC, if @p domain_name is too long
+ */
+int sock_dns_query_async(sock_dns_async_t *req, const char *domain_name,
+                         int family, sock_dns_async_cb_t cb, void *arg);
+
 /**
  * @brief global DNS server endpoint
  */
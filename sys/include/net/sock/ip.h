@@ -273,6 +273,7 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include "iolist.h"
 #include "net/sock.h"
 
 #ifdef __cplusplus
@@ -415,6 +416,48 @@ int sock_ip_get_remote(sock_ip_t *sock, sock_ip_ep_t *ep);
 ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
                      uint32_t timeout, sock_ip_ep_t *remote);
 
+/**
+ * @brief   Receives a message over IPv4/IPv6 from a remote end point without copying
+ *
+ * @pre `(sock != NULL) && (data != NULL) && (buf_ctx != NULL)`
+ *
+ * Instead of copying the received data into a buffer of the caller, the
+ * caller is lent a pointer into the stack's receive buffer, so data can be
+ * parsed in place. The data may be lent in several chunks: call this
+ * function again with the same @p buf_ctx until it returns 0 to get the
+ * next chunk. The last call gives the data back to the stack and must not be
+ * omitted, even if the caller is not interested in further chunks.
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object.
+ * @param[out] data     Pointer to the lent data. Set to NULL, once all data
+ *                      was given back.
+ * @param[in,out] buf_ctx   Lending context. Must point to NULL to receive a
+ *                      new message.
+ * @param[in] timeout   Timeout for receive in microseconds.
+ *                      If 0 and no data is available, the function returns
+ *                      immediately.
+ *                      May be @ref SOCK_NO_TIMEOUT for no timeout (wait until
+ *                      data is available).
+ * @param[out] remote   Remote end point of the received data.
+ *                      May be `NULL`, if it is not required by the application.
+ *
+ * @note    Function blocks if no packet is currently waiting.
+ *
+ * @return  The number of bytes in the chunk at @p data on success.
+ * @return  0, if all data of the message was given back or the message
+ *          was empty. Nothing is lent in that case.
+ * @return  -EADDRNOTAVAIL, if local of @p sock is not given.
+ * @return  -EAGAIN, if @p timeout is `0` and no data is available.
+ * @return  -EINVAL, if @p remote is invalid or @p sock is not properly
+ *          initialized (or closed while sock_ip_recv_buf() blocks).
+ * @return  -ENOMEM, if no memory was available to receive data.
+ * @return  -EPROTO, if source address of received packet did not equal
+ *          the remote of @p sock.
+ * @return  -ETIMEDOUT, if @p timeout expired.
+ */
+ssize_t sock_ip_recv_buf(sock_ip_t *sock, void **data, void **buf_ctx,
+                         uint32_t timeout, sock_ip_ep_t *remote);
+
 /**
  * @brief   Sends a message over IPv4/IPv6 to remote end point
  *
@@ -450,6 +493,34 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
 ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
                      uint8_t proto, const sock_ip_ep_t *remote);
 
+/**
+ * @brief   Sends a message made up of several chunks over IPv4/IPv6 to
+ *          remote end point
+ *
+ * Like sock_ip_send(), but the payload is the concatenation of all
+ * elements of @p snips.
+ *
+ * @pre `((sock != NULL || remote != NULL))`
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object. May be NULL.
+ *                      A sensible local end point should be selected by the
+ *                      implementation in that case.
+ * @param[in] snips     List of payload chunks. May be `NULL` to send an
+ *                      empty message.
+ * @param[in] proto     Protocol to use in the packet sent, in case
+ *                      `sock == NULL`. If `sock != NULL` this parameter will be
+ *                      ignored.
+ * @param[in] remote    Remote end point for the sent data.
+ *                      May be `NULL`, if @p sock has a remote end point.
+ *                      sock_ip_ep_t::family may be AF_UNSPEC, if local
+ *                      end point of @p sock provides this information.
+ *
+ * @return  The number of bytes sent on success.
+ * @return  Same errors as sock_ip_send() otherwise.
+ */
+ssize_t sock_ip_sendv(sock_ip_t *sock, const iolist_t *snips,
+                      uint8_t proto, const sock_ip_ep_t *remote);
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_sock_poll   Sock readiness multiplexing
+ * @ingroup     net_sock
+ * @brief       Wait for several socks at once
+ *
+ * sock_poll() blocks the calling thread until at least one of a set of
+ * socks has received data, so a single thread can serve several socks
+ * instead of one thread (and stack) per sock. Optionally, the set can
+ * contain event queues (see @ref sys_event) owned by the calling thread,
+ * so the thread can handle its own events while waiting for the network.
+ *
+ * The implementation for @ref net_gnrc "GNRC" is called `gnrc_sock_poll`.
+ * It supports @ref net_sock_udp and @ref net_sock_ip socks.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.c}
+ * sock_poll_t set[] = {
+ *     { .type = SOCK_POLL_UDP, .obj.udp = &coap_sock },
+ *     { .type = SOCK_POLL_UDP, .obj.udp = &mqtt_sock },
+ *     { .type = SOCK_POLL_EVENT, .obj.queue = &queue },
+ * };
+ *
+ * while (1) {
+ *     if (sock_poll(set, sizeof(set) / sizeof(set[0]),
+ *                   SOCK_NO_TIMEOUT) <= 0) {
+ *         continue;
+ *     }
+ *     if (set[0].ready) {
+ *         res = sock_udp_recv(&coap_sock, buf, sizeof(buf), 0, &remote);
+ *         [...]
+ *     }
+ *     [...]
+ *     if (set[2].ready) {
+ *         event_t *event = event_get(&queue);
+ *         [...]
+ *     }
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @{
+ *
+ * @file
+ * @brief   Sock readiness multiplexing definitions
+ */
+#ifndef NET_SOCK_POLL_H
+#define NET_SOCK_POLL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef MODULE_EVENT
+#include "event.h"
+#endif
+#include "net/sock/ip.h"
+#include "net/sock/udp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Types of entries in a set for sock_poll()
+ */
+typedef enum {
+    SOCK_POLL_UDP = 0,          /**< sock_poll_t::obj is a UDP sock */
+    SOCK_POLL_IP,               /**< sock_poll_t::obj is a raw IP sock */
+#if defined(MODULE_EVENT) || defined(DOXYGEN)
+    /**
+     * @brief   sock_poll_t::obj is an event queue
+     *
+     * @note    Only available with @ref sys_event. The queue must be owned
+     *          by the thread calling sock_poll().
+     */
+    SOCK_POLL_EVENT,
+#endif
+} sock_poll_type_t;
+
+/**
+ * @brief   Entry in a set for sock_poll()
+ */
+typedef struct {
+    /**
+     * @brief   The object to wait for
+     */
+    union {
+        sock_udp_t *udp;        /**< UDP sock */
+        sock_ip_t *ip;          /**< raw IP sock */
+#if defined(MODULE_EVENT) || defined(DOXYGEN)
+        event_queue_t *queue;   /**< event queue */
+#endif
+    } obj;
+    uint8_t type;               /**< type of sock_poll_t::obj */
+    bool ready;                 /**< set by sock_poll(), if sock_poll_t::obj
+                                 *   has data or events available */
+} sock_poll_t;
+
+/**
+ * @brief   Waits until at least one entry of a set is ready
+ *
+ * An entry is ready, if the next receive call on its sock (or event_get()
+ * on its event queue) returns immediately. Entries with sock_poll_t::obj
+ * set to `NULL` are ignored.
+ *
+ * @note    Only one thread may wait on a sock at a time. A thread must not
+ *          call sock_poll() while another thread is blocked in a receive
+ *          call on one of the socks of the set.
+ *
+ * @param[in,out] set       Set of entries to wait for. sock_poll_t::ready
+ *                          is set for each entry on return.
+ * @param[in] numof         Number of entries in @p set.
+ * @param[in] timeout       Timeout in microseconds.
+ *                          If 0, the function returns immediately.
+ *                          Use @ref SOCK_NO_TIMEOUT to wait until an entry
+ *                          is ready.
+ *
+ * @return  The number of ready entries on success.
+ * @return  0, if @p timeout expired (or is 0) and no entry is ready.
+ */
+int sock_poll(sock_poll_t *set, unsigned numof, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_SOCK_POLL_H */
+/** @} */
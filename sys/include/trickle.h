@@ -43,6 +43,22 @@ typedef struct {
     void *args;                 /**< callback function arguments */
 } trickle_callback_t;
 
+/**
+ * @brief Counters of a trickle timer, e.g. to tune its parameters
+ *
+ * They are reset by trickle_start().
+ */
+typedef struct {
+    uint32_t sent;                  /**< number of intervals the callback was
+                                         called in */
+    uint32_t suppressed;            /**< number of intervals the callback was
+                                         suppressed in, as the counter reached
+                                         the redundancy constant */
+    uint32_t resets;                /**< number of timer resets */
+    uint32_t heard;                 /**< number of counter increments, i.e.
+                                         consistent transmissions heard */
+} trickle_stats_t;
+
 /**
  * @brief all state variables of a trickle timer
  */
@@ -59,8 +75,14 @@ typedef struct {
                                          trickle calls after each interval */
     msg_t msg;                      /**< the msg_t to use for intervals */
     uint64_t msg_time;              /**< interval in ms */
+    uint64_t start;                 /**< start of the interval of the next
+                                         callback in us, see
+                                         xtimer_now_usec64(). Lies in the
+                                         future until the current interval
+                                         ends */
     xtimer_t msg_timer;             /**< xtimer to send a msg_t to the target
                                          thread for a new interval */
+    trickle_stats_t stats;          /**< counters of this timer */
 } trickle_t;
 
 /**
@@ -370,6 +370,17 @@ struct vfs_file_ops {
      * @return <0 on error
      */
     ssize_t (*write) (vfs_file_t *filp, const void *src, size_t nbytes);
+
+    /**
+     * @brief Truncate an open file
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  length   new length of the file, at most its current length
+     *
+     * @return 0 on success
+     * @return <0 on error
+     */
+    int (*ftruncate) (vfs_file_t *filp, off_t length);
 };
 
 /**
@@ -660,6 +671,23 @@ ssize_t vfs_read(int fd, void *dest, size_t count);
  */
 ssize_t vfs_write(int fd, const void *src, size_t count);
 
+/**
+ * @brief Truncate an open file
+ *
+ * Data beyond @p length is discarded. A position in the file beyond
+ * @p length may be moved to the new end of the file. Unlike ftruncate(),
+ * files can't be extended.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  length   new length of the file, at most its current length
+ *
+ * @return 0 on success
+ * @return -EBADF if the file is not open for writing
+ * @return -EINVAL if the file system doesn't support truncating files
+ * @return <0 on other errors
+ */
+int vfs_ftruncate(int fd, off_t length);
+
 /**
  * @brief Open a directory for reading with readdir
  *
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   sock DNS asynchronous resolver implementation
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/sock/dns.h"
+#include "thread.h"
+#include "thread_flags.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define SOCK_DNS_ASYNC_FLAG (0x1)
+
+static char _stack[SOCK_DNS_ASYNC_STACK_SIZE];
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static mutex_t _lock = MUTEX_INIT;
+static sock_dns_async_t *_queue;
+
+static bool _same(const sock_dns_async_t *a, const sock_dns_async_t *b)
+{
+    return (a->family == b->family) && !strcmp(a->domain_name, b->domain_name);
+}
+
+static void _resolve(sock_dns_async_t *req)
+{
+    uint8_t addr[16];
+    sock_dns_async_t *done = req;
+    sock_dns_async_t **prev;
+    int res = sock_dns_query(req->domain_name, addr, req->family);
+
+    /* answer all queries for the same name that came in meanwhile */
+    req->next = NULL;
+    mutex_lock(&_lock);
+    prev = &_queue;
+    while (*prev != NULL) {
+        sock_dns_async_t *cur = *prev;
+
+        if (_same(cur, req)) {
+            *prev = cur->next;
+            cur->next = done;
+            done = cur;
+        }
+        else {
+            prev = &cur->next;
+        }
+    }
+    mutex_unlock(&_lock);
+
+    while (done != NULL) {
+        sock_dns_async_t *next = done->next;
+
+        done->cb(done, res, addr);
+        done = next;
+    }
+}
+
+static void *_resolver(void *arg)
+{
+    (void)arg;
+    while (1) {
+        sock_dns_async_t *req;
+
+        thread_flags_wait_any(SOCK_DNS_ASYNC_FLAG);
+        while (1) {
+            mutex_lock(&_lock);
+            req = _queue;
+            if (req != NULL) {
+                _queue = req->next;
+            }
+            mutex_unlock(&_lock);
+            if (req == NULL) {
+                break;
+            }
+            DEBUG("dns_async: resolving %s\n", req->domain_name);
+            _resolve(req);
+        }
+    }
+    return NULL;
+}
+
+void sock_dns_async_init(void)
+{
+    if (_pid == KERNEL_PID_UNDEF) {
+        _pid = thread_create(_stack, sizeof(_stack), SOCK_DNS_ASYNC_PRIO,
+                             THREAD_CREATE_STACKTEST, _resolver, NULL, "dns");
+    }
+}
+
+int sock_dns_query_async(sock_dns_async_t *req, const char *domain_name,
+                         int family, sock_dns_async_cb_t cb, void *arg)
+{
+    sock_dns_async_t **tail;
+
+    assert((req != NULL) && (cb != NULL) && (_pid != KERNEL_PID_UNDEF));
+    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+    req->next = NULL;
+    req->domain_name = domain_name;
+    req->family = family;
+    req->cb = cb;
+    req->arg = arg;
+
+    /* append, so queries are resolved in order */
+    mutex_lock(&_lock);
+    for (tail = &_queue; *tail != NULL; tail = &(*tail)->next) {}
+    *tail = req;
+    mutex_unlock(&_lock);
+    thread_flags_set((thread_t *)thread_get(_pid), SOCK_DNS_ASYNC_FLAG);
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup net_sock_dns
+ * @{
+ * @file
+ * @brief   sock DNS cache implementation
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/sock/dns.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+typedef struct {
+    uint32_t expires;                       /* in s, 0 if unused */
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    uint8_t addr[16];
+    uint8_t addr_len;                       /* 0 if the name has no address */
+    uint8_t family;
+} _entry_t;
+
+static _entry_t _cache[SOCK_DNS_CACHE_SIZE];
+static mutex_t _lock = MUTEX_INIT;
+
+static uint32_t _now(void)
+{
+    /* entries expire after now, so 0 is never valid */
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC) + 1;
+}
+
+static _entry_t *_find(const char *domain_name, int family, uint32_t now)
+{
+    for (unsigned i = 0; i < SOCK_DNS_CACHE_SIZE; i++) {
+        _entry_t *e = &_cache[i];
+
+        if ((e->expires > now) && (e->family == family) &&
+            !strcmp(e->name, domain_name)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+int sock_dns_cache_query(const char *domain_name, void *addr_out, int family)
+{
+    _entry_t *e;
+    int res = 0;
+
+    mutex_lock(&_lock);
+    e = _find(domain_name, family, _now());
+    if (e != NULL) {
+        if (e->addr_len > 0) {
+            memcpy(addr_out, e->addr, e->addr_len);
+            res = e->addr_len;
+        }
+        else {
+            res = -ENOENT;
+        }
+    }
+    mutex_unlock(&_lock);
+    DEBUG("dns_cache: %s %s\n", domain_name, (res == 0) ? "missed" : "hit");
+    return res;
+}
+
+void sock_dns_cache_add(const char *domain_name, const void *addr,
+                        int addr_len, int family, uint32_t ttl)
+{
+    uint32_t now = _now();
+    _entry_t *e;
+
+    if ((ttl == 0) || (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) ||
+        (addr_len < 0) || (addr_len > (int)sizeof(e->addr))) {
+        return;
+    }
+    mutex_lock(&_lock);
+    e = _find(domain_name, family, now);
+    if (e == NULL) {
+        /* take the entry that expires first, unused ones have expired */
+        e = &_cache[0];
+        for (unsigned i = 1; i < SOCK_DNS_CACHE_SIZE; i++) {
+            if (_cache[i].expires < e->expires) {
+                e = &_cache[i];
+            }
+        }
+        strcpy(e->name, domain_name);
+        e->family = family;
+    }
+    e->addr_len = addr_len;
+    if (addr_len > 0) {
+        memcpy(e->addr, addr, addr_len);
+    }
+    e->expires = (ttl < (UINT32_MAX - now)) ? (now + ttl) : UINT32_MAX;
+    mutex_unlock(&_lock);
+    DEBUG("dns_cache: added %s for %lu s\n", domain_name, (unsigned long)ttl);
+}
+
+void sock_dns_cache_flush(void)
+{
+    mutex_lock(&_lock);
+    memset(_cache, 0, sizeof(_cache));
+    mutex_unlock(&_lock);
+}
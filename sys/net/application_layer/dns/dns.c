@@ -18,6 +18,7 @@
 #include <string.h>
 #include <stdio.h>
 
+#include "mutex.h"
 #include "net/sock/udp.h"
 #include "net/sock/dns.h"
 
@@ -28,6 +29,32 @@
 /* min domain name length is 1, so minimum record length is 7 */
 #define DNS_MIN_REPLY_LEN   (unsigned)(sizeof(sock_dns_hdr_t ) + 7)
 
+/* type, class, TTL and data length of a resource record */
+#define DNS_RR_FIXED_LEN    (10U)
+
+/* length of the data of A and AAAA records */
+#define DNS_A_LEN           (4U)
+#define DNS_AAAA_LEN        (16U)
+
+/* response codes of a reply: success and name does not exist */
+#define DNS_RCODE_MASK      (0x000f)
+#define DNS_RCODE_NOERROR   (0)
+#define DNS_RCODE_NXDOMAIN  (3)
+
+/* a query shared by all threads asking for the same name */
+typedef struct {
+    char name[SOCK_DNS_MAX_NAME_LEN + 1];
+    int family;
+    mutex_t done;           /* held by the thread sending the query */
+    unsigned users;         /* threads waiting for the result, 0 if unused */
+    int res;
+    uint8_t addr[16];
+} _pending_t;
+
+static _pending_t _pending[SOCK_DNS_PENDING_NUMOF];
+static mutex_t _lock = MUTEX_INIT;
+static sock_dns_stats_t _stats;
+
 static ssize_t _enc_domain_name(uint8_t *out, const char *domain_name)
 {
     /*
@@ -70,43 +97,66 @@ static unsigned _get_short(uint8_t *buf)
     return _tmp;
 }
 
-static size_t _skip_hostname(uint8_t *buf)
+static size_t _skip_hostname(uint8_t *buf, uint8_t *end)
 {
     uint8_t *bufpos = buf;
 
-    /* handle DNS Message Compression */
-    if (*bufpos >= 192) {
-        return 2;
-    }
-
-    while(*bufpos) {
+    /* a name running past end yields a length beyond it */
+    while ((bufpos < end) && *bufpos) {
+        /* handle DNS Message Compression */
+        if (*bufpos >= 192) {
+            return (bufpos - buf + 2);
+        }
         bufpos += *bufpos + 1;
     }
     return (bufpos - buf + 1);
 }
 
-static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family)
+static uint32_t _get_long(uint8_t *buf)
+{
+    uint32_t _tmp;
+    memcpy(&_tmp, buf, 4);
+    return _tmp;
+}
+
+static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family,
+                            uint32_t *ttl)
 {
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
     uint8_t *bufpos = buf + sizeof(*hdr);
+    uint8_t *end = buf + len;
+
+    unsigned rcode = ntohs(hdr->flags) & DNS_RCODE_MASK;
+
+    if (rcode == DNS_RCODE_NXDOMAIN) {
+        return -ENOENT;
+    }
+    if (rcode != DNS_RCODE_NOERROR) {
+        /* e.g. SERVFAIL or REFUSED, says nothing about the name */
+        return -EAGAIN;
+    }
 
     /* skip all queries that are part of the reply */
     for (unsigned n = 0; n < ntohs(hdr->qdcount); n++) {
-        bufpos += _skip_hostname(bufpos);
+        bufpos += _skip_hostname(bufpos, end);
         bufpos += 4;    /* skip type and class of query */
     }
 
     for (unsigned n = 0; n < ntohs(hdr->ancount); n++) {
-        bufpos += _skip_hostname(bufpos);
+        bufpos += _skip_hostname(bufpos, end);
+        if ((bufpos + DNS_RR_FIXED_LEN) > end) {
+            return -EBADMSG;
+        }
         uint16_t _type = ntohs(_get_short(bufpos));
         bufpos += 2;
         uint16_t class = ntohs(_get_short(bufpos));
         bufpos += 2;
-        bufpos += 4; /* skip ttl */
+        uint32_t _ttl = ntohl(_get_long(bufpos));
+        bufpos += 4;
 
         unsigned addrlen = ntohs(_get_short(bufpos));
         bufpos += 2;
-        if ((bufpos + addrlen) > (buf + len)) {
+        if ((bufpos + addrlen) > end) {
             return -EBADMSG;
         }
 
@@ -119,23 +169,26 @@ static int _parse_dns_reply(uint8_t *buf, size_t len, void* addr_out, int family
             bufpos += addrlen;
             continue;
         }
+        /* the record type fixes the length, the buffers are sized for it */
+        if (addrlen != ((_type == DNS_TYPE_A) ? DNS_A_LEN : DNS_AAAA_LEN)) {
+            return -EBADMSG;
+        }
 
         memcpy(addr_out, bufpos, addrlen);
+        *ttl = _ttl;
         return addrlen;
     }
 
-    return -1;
+    /* the name exists, but has no address of the requested family */
+    return -ENOENT;
 }
 
-int sock_dns_query(const char *domain_name, void *addr_out, int family)
+static int _query(const char *domain_name, void *addr_out, int family,
+                  uint32_t *ttl)
 {
     uint8_t buf[SOCK_DNS_QUERYBUF_LEN];
     uint8_t reply_buf[512];
 
-    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
-        return -ENOSPC;
-    }
-
     sock_dns_hdr_t *hdr = (sock_dns_hdr_t*) buf;
     memset(hdr, 0, sizeof(*hdr));
     hdr->id = 0; /* random? */
@@ -167,7 +220,6 @@ int sock_dns_query(const char *domain_name, void *addr_out, int family)
 
     ssize_t res = sock_udp_create(&sock_dns, NULL, &sock_dns_server, 0);
     if (res) {
-            puts("a");
         goto out;
     }
 
@@ -177,8 +229,14 @@ int sock_dns_query(const char *domain_name, void *addr_out, int family)
             continue;
         }
         res = sock_udp_recv(&sock_dns, reply_buf, sizeof(reply_buf), 1000000LU, NULL);
-        if ((res > 0) && (res > (int)DNS_MIN_REPLY_LEN)) {
-            if ((res = _parse_dns_reply(reply_buf, res, addr_out, family)) > 0) {
+        if ((res > 0) && (res < (int)DNS_MIN_REPLY_LEN)) {
+            /* don't return the length of a runt reply as address length */
+            res = -EBADMSG;
+        }
+        else if (res > 0) {
+            res = _parse_dns_reply(reply_buf, res, addr_out, family, ttl);
+            /* retry on server failures (-EAGAIN) and malformed replies */
+            if ((res > 0) || (res == -ENOENT)) {
                 goto out;
             }
         }
@@ -188,3 +246,106 @@ out:
     sock_udp_close(&sock_dns);
     return res;
 }
+
+static unsigned _addr_len(int res)
+{
+    return (res > 0) ? (unsigned)res : 0;
+}
+
+static _pending_t *_pending_get(const char *domain_name, int family)
+{
+    _pending_t *unused = NULL;
+
+    for (unsigned i = 0; i < SOCK_DNS_PENDING_NUMOF; i++) {
+        _pending_t *p = &_pending[i];
+
+        if (p->users == 0) {
+            unused = p;
+        }
+        else if ((p->family == family) && !strcmp(p->name, domain_name)) {
+            return p;
+        }
+    }
+    if (unused != NULL) {
+        strcpy(unused->name, domain_name);
+        unused->family = family;
+        mutex_init(&unused->done);
+    }
+    return unused;
+}
+
+int sock_dns_query(const char *domain_name, void *addr_out, int family)
+{
+    _pending_t *p;
+    uint32_t ttl = 0;
+    int res;
+
+    if (strlen(domain_name) > SOCK_DNS_MAX_NAME_LEN) {
+        return -ENOSPC;
+    }
+
+#ifdef MODULE_SOCK_DNS_CACHE
+    res = sock_dns_cache_query(domain_name, addr_out, family);
+    if (res != 0) {
+        mutex_lock(&_lock);
+        _stats.hits++;
+        mutex_unlock(&_lock);
+        return res;
+    }
+#endif
+
+    mutex_lock(&_lock);
+    p = _pending_get(domain_name, family);
+    if ((p != NULL) && (p->users++ > 0)) {
+        /* some other thread already asks for the name, wait for its result */
+        _stats.coalesced++;
+        mutex_unlock(&_lock);
+        mutex_lock(&p->done);
+        mutex_unlock(&p->done);
+        mutex_lock(&_lock);
+        res = p->res;
+        memcpy(addr_out, p->addr, _addr_len(res));
+        p->users--;
+        mutex_unlock(&_lock);
+        return res;
+    }
+    if (p != NULL) {
+        mutex_lock(&p->done);
+    }
+    _stats.misses++;
+    mutex_unlock(&_lock);
+
+    res = _query(domain_name, addr_out, family, &ttl);
+
+#ifdef MODULE_SOCK_DNS_CACHE
+    if (res > 0) {
+        sock_dns_cache_add(domain_name, addr_out, res, family, ttl);
+    }
+    else if (res == -ENOENT) {
+        /* not for -EAGAIN, a server failure says nothing about the name */
+        sock_dns_cache_add(domain_name, NULL, 0, family,
+                           SOCK_DNS_CACHE_NEG_TTL);
+    }
+#endif
+
+    if (p != NULL) {
+        mutex_lock(&_lock);
+        p->res = res;
+        memcpy(p->addr, addr_out, _addr_len(res));
+        p->users--;
+        /* release while holding _lock, so the entry is not reused before */
+        mutex_unlock(&p->done);
+        mutex_unlock(&_lock);
+    }
+    return res;
+}
+
+void sock_dns_stats(sock_dns_stats_t *stats, bool reset)
+{
+    mutex_lock(&_lock);
+    *stats = _stats;
+    if (reset) {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+    mutex_unlock(&_lock);
+}
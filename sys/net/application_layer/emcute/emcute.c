@@ -20,6 +20,8 @@
 
 #include <string.h>
 
+#include "iolist.h"
+#include "irq.h"
 #include "log.h"
 #include "mutex.h"
 #include "sched.h"
@@ -41,6 +43,50 @@
 #define TFLAGS_TIMEOUT      (0x0002)
 #define TFLAGS_ANY          (TFLAGS_RESP | TFLAGS_TIMEOUT)
 
+#define T_RETRY_US          (EMCUTE_T_RETRY * US_PER_SEC)
+
+/**
+ * @brief   States of a confirmed publish in flight
+ */
+enum {
+    PUB_FREE = 0,           /**< slot unused */
+    PUB_WAIT_PUBACK,        /**< QoS 1: PUBLISH sent */
+    PUB_WAIT_PUBREC,        /**< QoS 2: PUBLISH sent */
+    PUB_WAIT_PUBCOMP,       /**< QoS 2: PUBREL sent */
+};
+
+/**
+ * @brief   Confirmed publish in flight
+ */
+typedef struct {
+    emcute_pub_cb_t cb;     /**< called when done */
+    void *arg;              /**< argument for @p cb */
+    const void *data;       /**< published data, needed for retransmits */
+    size_t len;             /**< length of @p data */
+    uint32_t sent;          /**< time of the last transmission [in us] */
+    uint16_t topic_id;      /**< topic ID */
+    uint16_t msg_id;        /**< message ID */
+    uint8_t flags;          /**< publish flags */
+    uint8_t state;          /**< state, see above */
+    uint8_t retries;        /**< retransmissions so far */
+} pub_t;
+
+/**
+ * @brief   Message ID of a QoS 2 publish received, but not released yet
+ */
+typedef struct {
+    uint16_t msg_id;        /**< message ID */
+    bool used;              /**< entry is used */
+} qos2_rx_t;
+
+/**
+ * @brief   Result of a publish of a blocking emcute_pub()
+ */
+typedef struct {
+    mutex_t lock;           /**< unlocked when done */
+    int res;                /**< result */
+} pub_sync_t;
+
 
 static const char *cli_id;
 static sock_udp_t sock;
@@ -55,6 +101,15 @@ static mutex_t txlock;
 
 static xtimer_t timer;
 static uint16_t id_next = 0x1234;
+
+/* the window of confirmed publishes in flight, retransmitted by the emcute
+ * thread, with its receive timeout as the one timer of all of them */
+static pub_t pubs[EMCUTE_PUB_WINDOW];
+static mutex_t publock = MUTEX_INIT;
+static mutex_t pubfree = MUTEX_INIT_LOCKED;
+/* only accessed by the emcute thread */
+static qos2_rx_t qos2_rx[EMCUTE_QOS2_RX_NUMOF];
+static unsigned qos2_rx_next = 0;
 static volatile uint8_t waiton = 0xff;
 static volatile uint16_t waitonid = 0;
 static volatile int result;
@@ -87,7 +142,7 @@ static size_t set_len(uint8_t *buf, size_t len)
     }
     else {
         buf[0] = 0x01;
-        set_u16(&tbuf[1], (uint16_t)(len + 3));
+        set_u16(&buf[1], (uint16_t)(len + 3));
         return 3;
     }
 }
@@ -104,12 +159,20 @@ static size_t get_len(uint8_t *buf, uint16_t *len)
     }
 }
 
+static uint16_t next_id(void)
+{
+    unsigned state = irq_disable();
+    uint16_t id = id_next++;
+    irq_restore(state);
+    return id;
+}
+
 static void time_evt(void *arg)
 {
     thread_flags_set((thread_t *)arg, TFLAGS_TIMEOUT);
 }
 
-static int syncsend(uint8_t resp, size_t len, bool unlock)
+static int syncsendv(uint8_t resp, const iolist_t *msg, bool unlock)
 {
     int res = EMCUTE_TIMEOUT;
     waiton = resp;
@@ -120,7 +183,7 @@ static int syncsend(uint8_t resp, size_t len, bool unlock)
 
     for (unsigned retries = 0; retries < EMCUTE_N_RETRY; retries++) {
         DEBUG("[emcute] syncsend: sending round %i\n", retries);
-        sock_udp_send(&sock, tbuf, len, &gateway);
+        sock_udp_sendv(&sock, msg, &gateway);
 
         xtimer_set(&timer, (EMCUTE_T_RETRY * US_PER_SEC));
         thread_flags_t flags = thread_flags_wait_any(TFLAGS_ANY);
@@ -140,6 +203,150 @@ static int syncsend(uint8_t resp, size_t len, bool unlock)
     return res;
 }
 
+static int syncsend(uint8_t resp, size_t len, bool unlock)
+{
+    iolist_t msg = { .iol_base = tbuf, .iol_len = len };
+
+    return syncsendv(resp, &msg, unlock);
+}
+
+static void pub_send(pub_t *pub, bool dup)
+{
+    uint8_t hdr[9];
+    iolist_t payload = { .iol_base = (void *)pub->data, .iol_len = pub->len };
+    iolist_t msg = { .iol_base = hdr, .iol_next = NULL };
+
+    if (pub->state == PUB_WAIT_PUBCOMP) {
+        hdr[0] = 4;
+        hdr[1] = PUBREL;
+        set_u16(&hdr[2], pub->msg_id);
+        msg.iol_len = 4;
+    }
+    else {
+        size_t pos = set_len(hdr, (pub->len + 6));
+        hdr[pos++] = PUBLISH;
+        hdr[pos++] = pub->flags | ((dup) ? EMCUTE_DUP : 0);
+        set_u16(&hdr[pos], pub->topic_id);
+        pos += 2;
+        set_u16(&hdr[pos], pub->msg_id);
+        pos += 2;
+        msg.iol_len = pos;
+        msg.iol_next = &payload;
+    }
+    pub->sent = xtimer_now_usec();
+    sock_udp_sendv(&sock, &msg, &gateway);
+}
+
+/* must be called with publock held, releases it */
+static void pub_done(pub_t *pub, int res)
+{
+    emcute_pub_cb_t cb = pub->cb;
+    void *arg = pub->arg;
+
+    DEBUG("[emcute] pub: message %u done [%i]\n", (unsigned)pub->msg_id, res);
+    pub->state = PUB_FREE;
+    mutex_unlock(&publock);
+    mutex_unlock(&pubfree);
+    cb(arg, res);
+}
+
+static void pub_flush(int res)
+{
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        if (pubs[i].state != PUB_FREE) {
+            pub_done(&pubs[i], res);
+            mutex_lock(&publock);
+        }
+    }
+    mutex_unlock(&publock);
+}
+
+static uint32_t pub_retry(uint32_t now)
+{
+    uint32_t next = T_RETRY_US;
+
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        pub_t *pub = &pubs[i];
+
+        if (pub->state == PUB_FREE) {
+            continue;
+        }
+        if ((now - pub->sent) < T_RETRY_US) {
+            if ((T_RETRY_US - (now - pub->sent)) < next) {
+                next = T_RETRY_US - (now - pub->sent);
+            }
+            continue;
+        }
+        if (++pub->retries >= EMCUTE_N_RETRY) {
+            pub_done(pub, EMCUTE_TIMEOUT);
+            mutex_lock(&publock);
+            continue;
+        }
+        DEBUG("[emcute] pub: retransmitting message %u\n",
+              (unsigned)pub->msg_id);
+        pub_send(pub, true);
+    }
+    mutex_unlock(&publock);
+    return next;
+}
+
+static void on_pubresp(uint8_t type, uint16_t msg_id, int res)
+{
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        pub_t *pub = &pubs[i];
+
+        if ((pub->state == PUB_FREE) || (pub->msg_id != msg_id)) {
+            continue;
+        }
+        if ((type == PUBREC) && (pub->state != PUB_WAIT_PUBACK)) {
+            /* the gateway has the message, release it (again, in case the
+             * PUBREL got lost) */
+            pub->state = PUB_WAIT_PUBCOMP;
+            pub->retries = 0;
+            pub_send(pub, false);
+        }
+        else if (((type == PUBACK) && (pub->state == PUB_WAIT_PUBACK)) ||
+                 ((type == PUBACK) && (pub->state == PUB_WAIT_PUBREC) &&
+                  (res != EMCUTE_OK)) ||
+                 ((type == PUBCOMP) && (pub->state == PUB_WAIT_PUBCOMP))) {
+            pub_done(pub, res);
+            return;
+        }
+        break;
+    }
+    mutex_unlock(&publock);
+}
+
+static bool qos2_rx_add(uint16_t msg_id)
+{
+    for (unsigned i = 0; i < EMCUTE_QOS2_RX_NUMOF; i++) {
+        if (qos2_rx[i].used && (qos2_rx[i].msg_id == msg_id)) {
+            return false;
+        }
+    }
+    /* if all are used, forget the oldest one */
+    qos2_rx[qos2_rx_next].msg_id = msg_id;
+    qos2_rx[qos2_rx_next].used = true;
+    qos2_rx_next = (qos2_rx_next + 1) % EMCUTE_QOS2_RX_NUMOF;
+    return true;
+}
+
+static void on_pubrel(size_t pos)
+{
+    uint16_t msg_id = get_u16(&rbuf[pos + 1]);
+    uint8_t buf[4] = { 4, PUBCOMP, rbuf[pos + 1], rbuf[pos + 2] };
+
+    for (unsigned i = 0; i < EMCUTE_QOS2_RX_NUMOF; i++) {
+        if (qos2_rx[i].used && (qos2_rx[i].msg_id == msg_id)) {
+            qos2_rx[i].used = false;
+        }
+    }
+    sock_udp_send(&sock, &buf, 4, &gateway);
+}
+
 static void on_disconnect(void)
 {
     if (waiton == DISCONNECT) {
@@ -181,8 +388,9 @@ static void on_publish(size_t len, size_t pos)
     memcpy(&buf[2], &rbuf[pos + 2], 4);
 
     /* return error code in case we don't support/understand active flags. So
-     * far we only understand QoS 1... */
-    if (rbuf[pos + 1] & ~(EMCUTE_QOS_1 | EMCUTE_TIT_SHORT)) {
+     * far we only understand QoS 1 and 2... */
+    if ((rbuf[pos + 1] & ~(EMCUTE_DUP | EMCUTE_QOS_MASK | EMCUTE_TIT_SHORT)) ||
+        ((rbuf[pos + 1] & EMCUTE_QOS_MASK) == EMCUTE_QOS_MASK)) {
         buf[6] = REJ_NOTSUP;
         sock_udp_send(&sock, &buf, 7, &gateway);
         return;
@@ -199,6 +407,17 @@ static void on_publish(size_t len, size_t pos)
         if (rbuf[pos + 1] & EMCUTE_QOS_1) {
             sock_udp_send(&sock, &buf, 7, &gateway);
         }
+        else if (rbuf[pos + 1] & EMCUTE_QOS_2) {
+            uint8_t rec[4] = { 4, PUBREC, buf[4], buf[5] };
+            bool dup = !qos2_rx_add(get_u16(&rbuf[pos + 4]));
+
+            sock_udp_send(&sock, &rec, 4, &gateway);
+            /* deliver exactly once, until the gateway releases the message */
+            if (dup) {
+                DEBUG("[emcute] on pub: dropping duplicate\n");
+                return;
+            }
+        }
         DEBUG("[emcute] on pub: got %i bytes of data\n", (int)(len - pos - 6));
         size_t dat_len = (len - pos - 6);
         void *dat = (dat_len > 0) ? &rbuf[pos + 6] : NULL;
@@ -232,6 +451,8 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
 {
     int res;
     size_t len;
+    iolist_t will = { .iol_base = (void *)will_msg, .iol_len = will_msg_len };
+    iolist_t msg = { .iol_base = tbuf, .iol_next = NULL };
 
     assert(!will_topic || (will_topic && will_msg && !(will_flags & ~PUB_FLAGS)));
 
@@ -286,14 +507,15 @@ int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
             return res;
         }
 
-        /* and WILLMSG afterwards */
+        /* and WILLMSG afterwards, sent directly from the given buffer */
         pos = set_len(tbuf, (will_msg_len + 1));
-        len = (pos + will_msg_len + 1);
         tbuf[pos++] = WILLMSG;
-        memcpy(&tbuf[pos], will_msg, will_msg_len);
+        len = pos;
+        msg.iol_next = &will;
     }
 
-    res = syncsend(CONNACK, len, true);
+    msg.iol_len = len;
+    res = syncsendv(CONNACK, &msg, true);
     if (res != EMCUTE_OK) {
         gateway.port = 0;
     }
@@ -311,7 +533,9 @@ int emcute_discon(void)
     tbuf[0] = 2;
     tbuf[1] = DISCONNECT;
 
-    return syncsend(DISCONNECT, 2, true);
+    int res = syncsend(DISCONNECT, 2, true);
+    pub_flush(EMCUTE_NOGW);
+    return res;
 }
 
 int emcute_reg(emcute_topic_t *topic)
@@ -330,8 +554,8 @@ int emcute_reg(emcute_topic_t *topic)
     tbuf[0] = (strlen(topic->name) + 6);
     tbuf[1] = REGISTER;
     set_u16(&tbuf[2], 0);
-    set_u16(&tbuf[4], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    set_u16(&tbuf[4], waitonid);
     memcpy(&tbuf[6], topic->name, strlen(topic->name));
 
     int res = syncsend(REGACK, (size_t)tbuf[0], true);
@@ -342,12 +566,11 @@ int emcute_reg(emcute_topic_t *topic)
     return res;
 }
 
-int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
-               unsigned flags)
+int emcute_pub_async(emcute_topic_t *topic, const void *data, size_t len,
+                     unsigned flags, emcute_pub_cb_t cb, void *arg)
 {
-    int res = EMCUTE_OK;
-
     assert((topic->id != 0) && data && (len > 0) && !(flags & ~PUB_FLAGS));
+    assert(!(flags & EMCUTE_QOS_MASK) || cb);
 
     if (gateway.port == 0) {
         return EMCUTE_NOGW;
@@ -355,31 +578,78 @@ int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
     if (len >= (EMCUTE_BUFSIZE - 9)) {
         return EMCUTE_OVERFLOW;
     }
-    if (flags & EMCUTE_QOS_2) {
+    if ((flags & EMCUTE_QOS_MASK) == EMCUTE_QOS_MASK) {
         return EMCUTE_NOTSUP;
     }
 
-    mutex_lock(&txlock);
+    if (!(flags & EMCUTE_QOS_MASK)) {
+        mutex_lock(&txlock);
 
-    size_t pos = set_len(tbuf, (len + 6));
-    len += (pos + 6);
-    tbuf[pos++] = PUBLISH;
-    tbuf[pos++] = flags;
-    set_u16(&tbuf[pos], topic->id);
-    pos += 2;
-    set_u16(&tbuf[pos], id_next);
-    waitonid = id_next++;
-    pos += 2;
-    memcpy(&tbuf[pos], data, len);
+        size_t pos = set_len(tbuf, (len + 6));
+        tbuf[pos++] = PUBLISH;
+        tbuf[pos++] = flags;
+        set_u16(&tbuf[pos], topic->id);
+        pos += 2;
+        set_u16(&tbuf[pos], next_id());
+        pos += 2;
 
-    if (flags & EMCUTE_QOS_1) {
-        res = syncsend(PUBACK, len, true);
-    }
-    else {
-        sock_udp_send(&sock, tbuf, len, &gateway);
+        /* the payload is sent directly from the caller's buffer */
+        iolist_t payload = { .iol_base = (void *)data, .iol_len = len };
+        iolist_t msg = { .iol_next = &payload, .iol_base = tbuf, .iol_len = pos };
+
+        sock_udp_sendv(&sock, &msg, &gateway);
         mutex_unlock(&txlock);
+        return EMCUTE_OK;
+    }
+
+    mutex_lock(&publock);
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        pub_t *pub = &pubs[i];
+
+        if (pub->state == PUB_FREE) {
+            pub->cb = cb;
+            pub->arg = arg;
+            pub->data = data;
+            pub->len = len;
+            pub->topic_id = topic->id;
+            pub->msg_id = next_id();
+            pub->flags = flags;
+            pub->state = (flags & EMCUTE_QOS_1) ? PUB_WAIT_PUBACK
+                                                : PUB_WAIT_PUBREC;
+            pub->retries = 0;
+            DEBUG("[emcute] pub: sending message %u\n", (unsigned)pub->msg_id);
+            pub_send(pub, false);
+            mutex_unlock(&publock);
+            return EMCUTE_OK;
+        }
     }
+    mutex_unlock(&publock);
+    return EMCUTE_BUSY;
+}
+
+static void pub_sync_cb(void *arg, int res)
+{
+    pub_sync_t *sync = arg;
 
+    sync->res = res;
+    mutex_unlock(&sync->lock);
+}
+
+int emcute_pub(emcute_topic_t *topic, const void *data, size_t len,
+               unsigned flags)
+{
+    pub_sync_t sync = { .lock = MUTEX_INIT_LOCKED, .res = EMCUTE_OK };
+    int res;
+
+    /* wait for a free slot in the window */
+    while ((res = emcute_pub_async(topic, data, len, flags, pub_sync_cb,
+                                   &sync)) == EMCUTE_BUSY) {
+        mutex_lock(&pubfree);
+    }
+    if ((res == EMCUTE_OK) && (flags & EMCUTE_QOS_MASK)) {
+        mutex_lock(&sync.lock);
+        res = sync.res;
+    }
     return res;
 }
 
@@ -399,8 +669,8 @@ int emcute_sub(emcute_sub_t *sub, unsigned flags)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = SUBSCRIBE;
     tbuf[2] = flags;
-    set_u16(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    set_u16(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(SUBACK, (size_t)tbuf[0], false);
@@ -435,8 +705,8 @@ int emcute_unsub(emcute_sub_t *sub)
     tbuf[0] = (strlen(sub->topic.name) + 5);
     tbuf[1] = UNSUBSCRIBE;
     tbuf[2] = 0;
-    set_u16(&tbuf[3], id_next);
-    waitonid = id_next++;
+    waitonid = next_id();
+    set_u16(&tbuf[3], waitonid);
     memcpy(&tbuf[5], sub->topic.name, strlen(sub->topic.name));
 
     int res = syncsend(UNSUBACK, (size_t)tbuf[0], false);
@@ -499,11 +769,12 @@ int emcute_willupd_msg(const void *data, size_t len)
     mutex_lock(&txlock);
 
     size_t pos = set_len(tbuf, (len + 1));
-    len += (pos + 1);
     tbuf[pos++] = WILLMSGUPD;
-    memcpy(&tbuf[pos], data, len);
 
-    return syncsend(WILLMSGRESP, len, true);
+    iolist_t payload = { .iol_base = (void *)data, .iol_len = len };
+    iolist_t msg = { .iol_next = &payload, .iol_base = tbuf, .iol_len = pos };
+
+    return syncsendv(WILLMSGRESP, &msg, true);
 }
 
 void emcute_run(uint16_t port, const char *id)
@@ -556,7 +827,24 @@ void emcute_run(uint16_t port, const char *id)
                 case WILLMSGREQ:    on_ack(type, 0, 0, 0);              break;
                 case REGACK:        on_ack(type, 4, 6, 2);              break;
                 case PUBLISH:       on_publish((size_t)pkt_len, pos);   break;
-                case PUBACK:        on_ack(type, 4, 6, 0);              break;
+                case PUBACK:
+                    if ((size_t)pkt_len >= (pos + 6)) {
+                        on_pubresp(type, get_u16(&rbuf[pos + 3]),
+                                   (rbuf[pos + 5] == ACCEPT) ? EMCUTE_OK
+                                                             : EMCUTE_REJECT);
+                    }
+                    break;
+                case PUBREC:
+                case PUBCOMP:
+                    if ((size_t)pkt_len >= (pos + 3)) {
+                        on_pubresp(type, get_u16(&rbuf[pos + 1]), EMCUTE_OK);
+                    }
+                    break;
+                case PUBREL:
+                    if ((size_t)pkt_len >= (pos + 3)) {
+                        on_pubrel(pos);
+                    }
+                    break;
                 case SUBACK:        on_ack(type, 5, 7, 3);              break;
                 case UNSUBACK:      on_ack(type, 2, 0, 0);              break;
                 case PINGREQ:       on_pingreq(&remote);                break;
@@ -571,6 +859,7 @@ void emcute_run(uint16_t port, const char *id)
         }
 
         uint32_t now = xtimer_now_usec();
+        uint32_t t_pub = pub_retry(now);
         if ((now - start) >= (EMCUTE_KEEPALIVE * US_PER_SEC)) {
             send_ping();
             start = now;
@@ -579,5 +868,9 @@ void emcute_run(uint16_t port, const char *id)
         else {
             t_out = (EMCUTE_KEEPALIVE * US_PER_SEC) - (now - start);
         }
+        /* wake up for the next retransmit of the publishes in flight */
+        if (t_pub < t_out) {
+            t_out = t_pub;
+        }
     }
 }
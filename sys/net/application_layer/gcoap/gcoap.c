@@ -18,11 +18,14 @@
  * @author      Ken Bannister <kb2ma@runbox.com>
  */
 
+#include <assert.h>
 #include <errno.h>
 #include <stdint.h>
 #include <stdatomic.h>
+#include <string.h>
 
 #include "net/gcoap.h"
+#include "mbox.h"
 #include "mutex.h"
 #include "random.h"
 #include "thread.h"
@@ -30,25 +33,48 @@
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-/* Return values used by the _find_resource function. */
-#define GCOAP_RESOURCE_FOUND 0
-#define GCOAP_RESOURCE_WRONG_METHOD -1
-#define GCOAP_RESOURCE_NO_PATH -2
+/* Node of the resource trie, one per distinct path segment. The root node
+ * (index 0) represents "/"; as the root is nobody's child or sibling, index 0
+ * also terminates the child and sibling lists. */
+typedef struct {
+    const char *seg;                    /* Segment, within a resource path */
+    uint16_t child;                     /* First child node */
+    uint16_t sibling;                   /* Next node with the same parent */
+    uint16_t entries;                   /* First resource with the path
+                                           ending here, index + 1; 0 if none */
+    uint8_t seg_len;                    /* Length of seg */
+} _path_node_t;
+
+/* Resource indexed in the resource trie */
+typedef struct {
+    coap_resource_t *resource;
+    gcoap_listener_t *listener;
+    uint16_t next;                      /* Next resource with the same path,
+                                           index + 1; 0 if none */
+} _path_entry_t;
 
 /* Internal functions */
 static void *_event_loop(void *arg);
 static void _listen(sock_udp_t *sock);
+static void _process_pdu(sock_udp_t *sock, uint8_t *data, size_t len,
+                         sock_udp_ep_t *remote);
+static void _reply(sock_udp_t *sock, coap_pkt_t *pdu, uint8_t *buf,
+                   size_t len, sock_udp_ep_t *remote);
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
-static ssize_t _write_options(coap_pkt_t *pdu, uint8_t *buf, size_t len);
+static int _write_options(coap_pkt_t *pdu);
+static int _write_observe(coap_pkt_t *pdu);
 static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
                                                          sock_udp_ep_t *remote);
-static ssize_t _finish_pdu(coap_pkt_t *pdu, uint8_t *buf, size_t len);
 static void _expire_request(gcoap_request_memo_t *memo);
+static void _release_req_memo(gcoap_request_memo_t *memo);
 static bool _endpoints_equal(const sock_udp_ep_t *ep1, const sock_udp_ep_t *ep2);
 static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
                            const sock_udp_ep_t *remote);
-static int _find_resource(coap_pkt_t *pdu, coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr);
+static int _index_listener(gcoap_listener_t *listener);
+static int _path_insert(coap_resource_t *resource, gcoap_listener_t *listener);
+static int _path_match(coap_pkt_t *pdu, uint16_t node, uint8_t *optpos,
+                       int first, unsigned method_flag,
+                       _path_entry_t **entry_ptr);
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
 static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
@@ -70,10 +96,21 @@ static gcoap_listener_t _default_listener = {
 typedef struct {
     mutex_t lock;                       /* Shares state attributes safely */
     gcoap_listener_t *listeners;        /* List of registered listeners */
+    _path_node_t path_nodes[GCOAP_PATH_NODES_MAX];
+                                        /* Resource trie; first node is the
+                                           root */
+    uint16_t path_nodes_numof;          /* Nodes in use, including the root */
+    _path_entry_t path_entries[GCOAP_RESOURCES_MAX];
+                                        /* Resources indexed in the trie */
+    uint16_t path_entries_numof;        /* Resources in use; 0 until the
+                                           default listener is indexed */
     gcoap_request_memo_t open_reqs[GCOAP_REQ_WAITING_MAX];
                                         /* Storage for open requests; if first
                                            byte of an entry is zero, the entry
                                            is available */
+    gcoap_request_memo_t *open_reqs_by_token[GCOAP_REQ_WAITING_MAX];
+                                        /* Hash table of open requests by
+                                           token, chained via memo->next */
     atomic_uint next_message_id;        /* Next message ID to use */
     sock_udp_ep_t observers[GCOAP_OBS_CLIENTS_MAX];
                                         /* Observe clients; allows reuse for
@@ -88,6 +125,7 @@ typedef struct {
 
 static gcoap_state_t _coap_state = {
     .listeners   = &_default_listener,
+    .path_nodes_numof = 1,
 };
 
 static kernel_pid_t _pid = KERNEL_PID_UNDEF;
@@ -95,6 +133,22 @@ static char _msg_stack[GCOAP_STACK_SIZE];
 static msg_t _msg_queue[GCOAP_MSG_QUEUE_SIZE];
 static sock_udp_t _sock;
 
+#ifdef MODULE_GCOAP_WORKER
+/* Request waiting for or handled by a worker */
+typedef struct {
+    sock_udp_ep_t remote;
+    size_t len;
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+} _worker_req_t;
+
+static _worker_req_t _worker_reqs[GCOAP_WORKER_QUEUE_SIZE];
+static msg_t _worker_queue[GCOAP_WORKER_QUEUE_SIZE];
+static msg_t _worker_free_queue[GCOAP_WORKER_QUEUE_SIZE];
+static mbox_t _worker_mbox;             /* Requests to handle */
+static mbox_t _worker_free;             /* Unused entries of _worker_reqs */
+static char _worker_stacks[GCOAP_WORKER_NUMOF][GCOAP_WORKER_STACK_SIZE];
+#endif
+
 
 /* Event/Message loop for gcoap _pid thread. */
 static void *_event_loop(void *arg)
@@ -165,20 +219,18 @@ static void *_event_loop(void *arg)
 /* Listen for an incoming CoAP message. */
 static void _listen(sock_udp_t *sock)
 {
-    coap_pkt_t pdu;
-    uint8_t buf[GCOAP_PDU_BUF_SIZE];
     sock_udp_ep_t remote;
-    gcoap_request_memo_t *memo = NULL;
+    void *data, *buf_ctx = NULL;
     uint8_t open_reqs = gcoap_op_state();
 
     /* We expect a -EINTR response here when unlimited waiting (SOCK_NO_TIMEOUT)
      * is interrupted when sending a message in gcoap_req_send2(). While a
-     * request is outstanding, sock_udp_recv() is called here with limited
+     * request is outstanding, sock_udp_recv_buf() is called here with limited
      * waiting so the request's timeout can be handled in a timely manner in
      * _event_loop(). */
-    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf),
-                                open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
-                                &remote);
+    ssize_t res = sock_udp_recv_buf(sock, &data, &buf_ctx,
+                                    open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
+                                    &remote);
     if (res <= 0) {
 #if ENABLE_DEBUG
         if (res < 0 && res != -ETIMEDOUT) {
@@ -188,7 +240,29 @@ static void _listen(sock_udp_t *sock)
         return;
     }
 
-    res = coap_parse(&pdu, buf, res);
+    /* The message is parsed where the stack received it; GNRC lends it in
+     * one piece, so there is nothing left to read after the first chunk */
+    if (res <= GCOAP_PDU_BUF_SIZE) {
+        _process_pdu(sock, data, res, &remote);
+    }
+    else {
+        DEBUG("gcoap: message too large: %d\n", (int)res);
+    }
+    while (sock_udp_recv_buf(sock, &data, &buf_ctx, 0, NULL) > 0) {
+        DEBUG("gcoap: ignoring chained data\n");
+    }
+}
+
+/* Handles a received CoAP message, responses to requests are built in a
+ * buffer of their own. */
+static void _process_pdu(sock_udp_t *sock, uint8_t *data, size_t len,
+                         sock_udp_ep_t *remote)
+{
+    coap_pkt_t pdu;
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    gcoap_request_memo_t *memo = NULL;
+
+    int res = coap_parse(&pdu, data, len);
     if (res < 0) {
         DEBUG("gcoap: parse failure: %d\n", (int)res);
         /* If a response, can't clear memo, but it will timeout later. */
@@ -206,13 +280,29 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_REQ:
         if (coap_get_type(&pdu) == COAP_TYPE_NON
                 || coap_get_type(&pdu) == COAP_TYPE_CON) {
-            size_t pdu_len = _handle_req(&pdu, buf, sizeof(buf), &remote);
-            if (pdu_len > 0) {
-                ssize_t bytes = sock_udp_send(sock, buf, pdu_len, &remote);
-                if (bytes <= 0) {
-                    DEBUG("gcoap: send response failed: %d\n", (int)bytes);
+#ifdef MODULE_GCOAP_WORKER
+            msg_t msg;
+
+            if (mbox_try_get(&_worker_free, &msg)) {
+                _worker_req_t *req = msg.content.ptr;
+
+                /* data is only lent by the sock until the next receive */
+                memcpy(req->buf, data, len);
+                memcpy(&req->remote, remote, sizeof(req->remote));
+                req->len = len;
+                mbox_put(&_worker_mbox, &msg);
+            }
+            else {
+                DEBUG("gcoap: all workers busy\n");
+                ssize_t pdu_len = gcoap_response(&pdu, buf, sizeof(buf),
+                                                 COAP_CODE_SERVICE_UNAVAILABLE);
+                if (pdu_len > 0) {
+                    sock_udp_send(sock, buf, pdu_len, remote);
                 }
             }
+#else
+            _reply(sock, &pdu, buf, sizeof(buf), remote);
+#endif
         }
         else {
             DEBUG("gcoap: illegal request type: %u\n", coap_get_type(&pdu));
@@ -223,7 +313,7 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_SUCCESS:
     case COAP_CLASS_CLIENT_FAILURE:
     case COAP_CLASS_SERVER_FAILURE:
-        _find_req_memo(&memo, &pdu, &remote);
+        _find_req_memo(&memo, &pdu, remote);
         if (memo) {
             switch (coap_get_type(&pdu)) {
             case COAP_TYPE_NON:
@@ -231,13 +321,9 @@ static void _listen(sock_udp_t *sock)
                 xtimer_remove(&memo->response_timer);
                 memo->state = GCOAP_MEMO_RESP;
                 if (memo->resp_handler) {
-                    memo->resp_handler(memo->state, &pdu, &remote);
-                }
-
-                if (memo->send_limit >= 0) {        /* if confirmable */
-                    *memo->msg.data.pdu_buf = 0;    /* clear resend PDU buffer */
+                    memo->resp_handler(memo->state, &pdu, remote);
                 }
-                memo->state = GCOAP_MEMO_UNUSED;
+                _release_req_memo(memo);
                 break;
             case COAP_TYPE_CON:
                 DEBUG("gcoap: separate CON response not handled yet\n");
@@ -256,6 +342,42 @@ static void _listen(sock_udp_t *sock)
     }
 }
 
+/* Handles a request and sends the response. */
+static void _reply(sock_udp_t *sock, coap_pkt_t *pdu, uint8_t *buf,
+                   size_t len, sock_udp_ep_t *remote)
+{
+    size_t pdu_len = _handle_req(pdu, buf, len, remote);
+    if (pdu_len > 0) {
+        ssize_t bytes = sock_udp_send(sock, buf, pdu_len, remote);
+        if (bytes <= 0) {
+            DEBUG("gcoap: send response failed: %d\n", (int)bytes);
+        }
+    }
+}
+
+#ifdef MODULE_GCOAP_WORKER
+/* Loop of a worker thread, handles requests queued by _process_pdu(). */
+static void *_worker_loop(void *arg)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    (void)arg;
+
+    while (1) {
+        msg_t msg;
+        coap_pkt_t pdu;
+
+        mbox_get(&_worker_mbox, &msg);
+        _worker_req_t *req = msg.content.ptr;
+        if (coap_parse(&pdu, req->buf, req->len) == 0) {
+            _reply(&_sock, &pdu, buf, sizeof(buf), &req->remote);
+        }
+        mbox_put(&_worker_free, &msg);
+    }
+
+    return NULL;
+}
+#endif
+
 /*
  * Main request handler: generates response PDU in the provided buffer.
  *
@@ -272,17 +394,20 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
     gcoap_observe_memo_t *memo = NULL;
     gcoap_observe_memo_t *resource_memo = NULL;
 
-    switch (_find_resource(pdu, &resource, &listener)) {
+    switch (gcoap_find_resource(pdu, &resource, &listener)) {
         case GCOAP_RESOURCE_WRONG_METHOD:
             return gcoap_response(pdu, buf, len, COAP_CODE_METHOD_NOT_ALLOWED);
         case GCOAP_RESOURCE_NO_PATH:
             return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
         case GCOAP_RESOURCE_FOUND:
-            /* used below to ensure a memo not already recorded for the resource */
-            _find_obs_memo_resource(&resource_memo, resource);
             break;
     }
 
+    /* requests may be handled concurrently by several workers */
+    mutex_lock(&_coap_state.lock);
+    /* used below to ensure a memo not already recorded for the resource */
+    _find_obs_memo_resource(&resource_memo, resource);
+
     if (coap_get_observe(pdu) == COAP_OBS_REGISTER) {
         int empty_slot = _find_obs_memo(&memo, remote, pdu);
         /* record observe memo */
@@ -339,10 +464,12 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         coap_clear_observe(pdu);
 
     } else if (coap_has_observe(pdu)) {
+        mutex_unlock(&_coap_state.lock);
         /* bogus request; don't respond */
         DEBUG("gcoap: Observe value unexpected: %" PRIu32 "\n", coap_get_observe(pdu));
         return -1;
     }
+    mutex_unlock(&_coap_state.lock);
 
     ssize_t pdu_len = resource->handler(pdu, buf, len, resource->context);
     if (pdu_len < 0) {
@@ -353,81 +480,286 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 }
 
 /*
- * Searches listener registrations for the resource matching the path in a PDU.
+ * Removes the nodes and entries added to the resource trie since it had
+ * nodes_numof nodes and entries_numof entries. New children are prepended
+ * to the child lists and new entries appended to the entry lists.
  *
- * param[out] resource_ptr -- found resource
- * param[out] listener_ptr -- listener for found resource
- * return `GCOAP_RESOURCE_FOUND` if the resource was found,
- *        `GCOAP_RESOURCE_WRONG_METHOD` if a resource was found but the method
- *        code didn't match and `GCOAP_RESOURCE_NO_PATH` if no matching
- *        resource was found.
+ * Caller must hold _coap_state.lock.
  */
-static int _find_resource(coap_pkt_t *pdu, coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr)
+static void _path_truncate(uint16_t nodes_numof, uint16_t entries_numof)
 {
-    int ret = GCOAP_RESOURCE_NO_PATH;
-    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+    _path_node_t *nodes = _coap_state.path_nodes;
 
-    /* Find path for CoAP msg among listener resources and execute callback. */
-    gcoap_listener_t *listener = _coap_state.listeners;
-    while (listener) {
-        coap_resource_t *resource = listener->resources;
-        for (size_t i = 0; i < listener->resources_len; i++) {
-            if (i) {
-                resource++;
-            }
+    for (uint16_t node = 0; node < nodes_numof; node++) {
+        while (nodes[node].child >= nodes_numof) {
+            nodes[node].child = nodes[nodes[node].child].sibling;
+        }
+        if (nodes[node].entries > entries_numof) {
+            nodes[node].entries = 0;
+        }
+    }
+    for (uint16_t entry = 0; entry < entries_numof; entry++) {
+        if (_coap_state.path_entries[entry].next > entries_numof) {
+            _coap_state.path_entries[entry].next = 0;
+        }
+    }
+    _coap_state.path_nodes_numof = nodes_numof;
+    _coap_state.path_entries_numof = entries_numof;
+}
 
-            int res = strcmp((char *)&pdu->url[0], resource->path);
-            if (res > 0) {
-                continue;
-            }
-            else if (res < 0) {
-                /* resources expected in alphabetical order */
-                break;
-            }
-            else {
-                if (! (resource->methods & method_flag)) {
-                    ret = GCOAP_RESOURCE_WRONG_METHOD;
-                    continue;
-                }
+/*
+ * Adds the resources of a listener to the resource trie, either all of them
+ * or none.
+ *
+ * Caller must hold _coap_state.lock.
+ *
+ * return 0 on success, or -ENOMEM if the trie is full
+ */
+static int _index_listener(gcoap_listener_t *listener)
+{
+    uint16_t nodes_numof = _coap_state.path_nodes_numof;
+    uint16_t entries_numof = _coap_state.path_entries_numof;
+
+    for (size_t i = 0; i < listener->resources_len; i++) {
+        int res = _path_insert(&listener->resources[i], listener);
+        if (res < 0) {
+            /* GCOAP_RESOURCES_MAX or GCOAP_PATH_NODES_MAX too small */
+            DEBUG("gcoap: can't index %s: %d\n", listener->resources[i].path,
+                  res);
+            _path_truncate(nodes_numof, entries_numof);
+            return res;
+        }
+    }
+    return 0;
+}
 
-                *resource_ptr = resource;
-                *listener_ptr = listener;
-                return GCOAP_RESOURCE_FOUND;
-            }
+/*
+ * Indexes the default listener on first use, so _coap_state needs no
+ * initialization at runtime.
+ *
+ * Caller must hold _coap_state.lock.
+ */
+static void _index_default_listener(void)
+{
+    if (_coap_state.path_entries_numof == 0) {
+        _index_listener(&_default_listener);
+    }
+}
+
+/*
+ * Finds the child of a trie node for a path segment.
+ *
+ * param[in] create -- add the child if not found
+ * return index of the child, or 0 if not found or no space left
+ */
+static uint16_t _path_child(uint16_t node, const char *seg, size_t seg_len,
+                            bool create)
+{
+    _path_node_t *nodes = _coap_state.path_nodes;
+
+    for (uint16_t child = nodes[node].child; child;
+         child = nodes[child].sibling) {
+        if ((nodes[child].seg_len == seg_len) &&
+            (memcmp(nodes[child].seg, seg, seg_len) == 0)) {
+            return child;
         }
-        listener = listener->next;
     }
+    if (!create || (_coap_state.path_nodes_numof >= GCOAP_PATH_NODES_MAX) ||
+        (seg_len > UINT8_MAX)) {
+        return 0;
+    }
+
+    uint16_t child = _coap_state.path_nodes_numof++;
+    nodes[child].seg     = seg;
+    nodes[child].seg_len = seg_len;
+    nodes[child].child   = 0;
+    nodes[child].entries = 0;
+    nodes[child].sibling = nodes[node].child;
+    nodes[node].child    = child;
+    return child;
+}
+
+/*
+ * Adds a resource to the resource trie. Resources with the same path are
+ * kept in order of registration.
+ *
+ * return 0 on success, or -ENOMEM if the trie is full
+ */
+static int _path_insert(coap_resource_t *resource, gcoap_listener_t *listener)
+{
+    const char *seg = resource->path;
+    uint16_t node = 0;
+
+    assert(seg[0] == '/');
+    if (_coap_state.path_entries_numof >= GCOAP_RESOURCES_MAX) {
+        return -ENOMEM;
+    }
+    /* "/" is the root; each further '/' starts a segment, as in the path
+     * coap_get_uri() builds from the Uri-Path options */
+    if (seg[1] != '\0') {
+        do {
+            seg++;
+            size_t seg_len = strcspn(seg, "/");
+
+            node = _path_child(node, seg, seg_len, true);
+            if (node == 0) {
+                return -ENOMEM;
+            }
+            seg += seg_len;
+        } while (*seg != '\0');
+    }
+
+    _path_entry_t *entry = &_coap_state.path_entries[_coap_state.path_entries_numof++];
+    entry->resource = resource;
+    entry->listener = listener;
+    entry->next     = 0;
+
+    uint16_t *tail = &_coap_state.path_nodes[node].entries;
+    while (*tail) {
+        tail = &_coap_state.path_entries[*tail - 1].next;
+    }
+    *tail = _coap_state.path_entries_numof;
+    return 0;
+}
+
+/*
+ * Searches a list of resources with the same path for one accepting a method.
+ *
+ * param[in] subtree -- consider only resources with GCOAP_MATCH_SUBTREE
+ */
+static int _entries_match(uint16_t entry, unsigned method_flag, bool subtree,
+                          _path_entry_t **entry_ptr)
+{
+    int ret = GCOAP_RESOURCE_NO_PATH;
+
+    for (; entry; entry = _coap_state.path_entries[entry - 1].next) {
+        _path_entry_t *candidate = &_coap_state.path_entries[entry - 1];
 
+        if (subtree && !(candidate->resource->methods & GCOAP_MATCH_SUBTREE)) {
+            continue;
+        }
+        if (!(candidate->resource->methods & method_flag)) {
+            ret = GCOAP_RESOURCE_WRONG_METHOD;
+            continue;
+        }
+        *entry_ptr = candidate;
+        return GCOAP_RESOURCE_FOUND;
+    }
     return ret;
 }
 
 /*
- * Finishes handling a PDU -- write options and reposition payload.
+ * Matches the Uri-Path options of a PDU from optpos on against the subtrie
+ * below node. Tries the exact segment first, then the '*' wildcard, then
+ * subtree resources of node itself.
  *
- * Returns the size of the PDU within the buffer, or < 0 on error.
+ * param[in] optpos -- next Uri-Path option, or NULL at the end of the path
+ * param[in] first -- optpos is the first Uri-Path option
  */
-static ssize_t _finish_pdu(coap_pkt_t *pdu, uint8_t *buf, size_t len)
+static int _path_match(coap_pkt_t *pdu, uint16_t node, uint8_t *optpos,
+                       int first, unsigned method_flag,
+                       _path_entry_t **entry_ptr)
 {
-    ssize_t hdr_len = _write_options(pdu, buf, len);
-    DEBUG("gcoap: header length: %i\n", (int)hdr_len);
+    _path_node_t *nodes = _coap_state.path_nodes;
+    uint8_t *seg = NULL;
+    int seg_len = 0;
+
+    if (optpos) {
+        seg = coap_iterate_option(pdu, &optpos, &seg_len, first);
+    }
+    if (seg == NULL) {
+        return _entries_match(nodes[node].entries, method_flag, false,
+                              entry_ptr);
+    }
 
-    if (hdr_len > 0) {
-        /* move payload over unused space after options */
-        if (pdu->payload_len) {
-            memmove(buf + hdr_len, pdu->payload, pdu->payload_len);
+    uint16_t exact = 0, wildcard = 0;
+    for (uint16_t child = nodes[node].child; child;
+         child = nodes[child].sibling) {
+        if ((nodes[child].seg_len == seg_len) &&
+            (memcmp(nodes[child].seg, seg, seg_len) == 0)) {
+            exact = child;
+        }
+        else if ((nodes[child].seg_len == 1) && (nodes[child].seg[0] == '*')) {
+            wildcard = child;
+        }
+    }
+
+    int ret = GCOAP_RESOURCE_NO_PATH;
+    uint16_t candidates[] = { exact, wildcard };
+    for (unsigned i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        if (candidates[i] == 0) {
+            continue;
         }
+        int res = _path_match(pdu, candidates[i], optpos, 0, method_flag,
+                              entry_ptr);
+        if (res == GCOAP_RESOURCE_FOUND) {
+            return res;
+        }
+        if (res == GCOAP_RESOURCE_WRONG_METHOD) {
+            ret = res;
+        }
+    }
 
-        return hdr_len + pdu->payload_len;
+    int res = _entries_match(nodes[node].entries, method_flag, true,
+                             entry_ptr);
+    return (res == GCOAP_RESOURCE_NO_PATH) ? ret : res;
+}
+
+/* Returns the header of the request a memo is waiting for. */
+static coap_hdr_t *_req_memo_hdr(gcoap_request_memo_t *memo)
+{
+    if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
+        return (coap_hdr_t *)&memo->msg.hdr_buf[0];
     }
-    else {
-        return -1;      /* generic failure code */
+    return (coap_hdr_t *)memo->msg.data.pdu_buf;
+}
+
+/* Returns the bucket for a token in _coap_state.open_reqs_by_token. */
+static gcoap_request_memo_t **_req_memo_bucket(const uint8_t *token,
+                                               unsigned token_len)
+{
+    unsigned hash = 0;
+
+    for (unsigned i = 0; i < token_len; i++) {
+        hash = (hash * 31) + token[i];
+    }
+    return &_coap_state.open_reqs_by_token[hash % GCOAP_REQ_WAITING_MAX];
+}
+
+/* Returns the bucket a memo is kept in. */
+static gcoap_request_memo_t **_req_memo_bucket_of(gcoap_request_memo_t *memo)
+{
+    coap_pkt_t memo_pdu;
+
+    memo_pdu.hdr = _req_memo_hdr(memo);
+    return _req_memo_bucket(&memo_pdu.hdr->data[0],
+                            coap_get_token_len(&memo_pdu));
+}
+
+/*
+ * Frees the memo of a request, which is awaiting a response or was just
+ * handled, and its resend buffer.
+ */
+static void _release_req_memo(gcoap_request_memo_t *memo)
+{
+    mutex_lock(&_coap_state.lock);
+    gcoap_request_memo_t **prev = _req_memo_bucket_of(memo);
+    while (*prev && (*prev != memo)) {
+        prev = &(*prev)->next;
+    }
+    if (*prev) {
+        *prev = memo->next;
     }
+    if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
+        *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
+    }
+    memo->state = GCOAP_MEMO_UNUSED;
+    mutex_unlock(&_coap_state.lock);
 }
 
 /*
- * Finds the memo for an outstanding request within the _coap_state.open_reqs
- * array. Matches on remote endpoint and token.
+ * Finds the memo for an outstanding request by the token of its response.
+ * Matches on remote endpoint and token.
  *
  * memo_ptr[out] -- Registered request memo, or NULL if not found
  * src_pdu[in] -- PDU for token to match
@@ -442,18 +774,10 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
     coap_pkt_t *memo_pdu = &memo_pdu_data;
     unsigned cmplen      = coap_get_token_len(src_pdu);
 
-    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED)
-            continue;
-
-        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
-        if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-            memo_pdu->hdr = (coap_hdr_t *) &memo->msg.hdr_buf[0];
-        }
-        else {
-            memo_pdu->hdr = (coap_hdr_t *) memo->msg.data.pdu_buf;
-        }
-
+    mutex_lock(&_coap_state.lock);
+    gcoap_request_memo_t *memo = *_req_memo_bucket(src_pdu->token, cmplen);
+    for (; memo != NULL; memo = memo->next) {
+        memo_pdu->hdr = _req_memo_hdr(memo);
         if (coap_get_token_len(memo_pdu) == cmplen) {
             memo_pdu->token = &memo_pdu->hdr->data[0];
             if ((memcmp(src_pdu->token, memo_pdu->token, cmplen) == 0)
@@ -463,6 +787,7 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
             }
         }
     }
+    mutex_unlock(&_coap_state.lock);
 }
 
 /* Calls handler callback on receipt of a timeout message. */
@@ -474,18 +799,10 @@ static void _expire_request(gcoap_request_memo_t *memo)
         /* Pass response to handler */
         if (memo->resp_handler) {
             coap_pkt_t req;
-            if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-                req.hdr = (coap_hdr_t *)&memo->msg.hdr_buf[0];   /* for reference */
-            }
-            else {
-                req.hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
-            }
+            req.hdr = _req_memo_hdr(memo);      /* for reference */
             memo->resp_handler(memo->state, &req, NULL);
         }
-        if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
-            *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
-        }
-        memo->state = GCOAP_MEMO_UNUSED;
+        _release_req_memo(memo);
     }
     else {
         /* Response already handled; timeout must have fired while response */
@@ -509,66 +826,31 @@ static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t le
 }
 
 /*
- * Creates CoAP options and sets payload marker, if any.
+ * Adds the options only known when the PDU is finished, i.e. the
+ * Content-Format. Uri-Query options are written by gcoap_add_qstring().
  *
- * Returns length of header + options, or -EINVAL on illegal path.
+ * Returns 0 on success, or -ENOSPC if they don't fit.
  */
-static ssize_t _write_options(coap_pkt_t *pdu, uint8_t *buf, size_t len)
+static int _write_options(coap_pkt_t *pdu)
 {
-    uint8_t last_optnum = 0;
-    (void)len;
-
-    uint8_t *bufpos = buf + coap_get_total_hdr_len(pdu);  /* position for write */
-
-    /* Observe for notification or registration response */
-    if (coap_get_code_class(pdu) == COAP_CLASS_SUCCESS && coap_has_observe(pdu)) {
-        uint32_t nval  = htonl(pdu->observe_value);
-        uint8_t *nbyte = (uint8_t *)&nval;
-        unsigned i;
-        /* find address of non-zero MSB; max 3 bytes */
-        for (i = 1; i < 4; i++) {
-            if (*(nbyte+i) > 0) {
-                break;
-            }
-        }
-        bufpos += coap_put_option(bufpos, last_optnum, COAP_OPT_OBSERVE,
-                                                       nbyte+i, 4-i);
-        last_optnum = COAP_OPT_OBSERVE;
-    }
-
-    /* Uri-Path for request */
-    if (coap_get_code_class(pdu) == COAP_CLASS_REQ) {
-        size_t url_len = strlen((char *)pdu->url);
-        if (url_len) {
-            if (pdu->url[0] != '/') {
-                DEBUG("gcoap: _write_options: path does not start with '/'\n");
-                return -EINVAL;
-            }
-            bufpos += coap_put_option_uri(bufpos, last_optnum, (char *)pdu->url,
-                                          COAP_OPT_URI_PATH);
-            last_optnum = COAP_OPT_URI_PATH;
-        }
-    }
+    ssize_t res = 0;
 
-    /* Content-Format */
     if (pdu->content_type != COAP_FORMAT_NONE) {
-        bufpos += coap_put_option_ct(bufpos, last_optnum, pdu->content_type);
-        last_optnum = COAP_OPT_CONTENT_FORMAT;
-    }
-
-    /* Uri-query for requests */
-    if (coap_get_code_class(pdu) == COAP_CLASS_REQ) {
-        bufpos += coap_put_option_uri(bufpos, last_optnum, (char *)pdu->qs,
-                                      COAP_OPT_URI_QUERY);
-        /* uncomment when further options are added below ... */
-        /* last_optnum = COAP_OPT_URI_QUERY; */
+        res = coap_opt_add_format(pdu, pdu->content_type);
     }
+    return (res < 0) ? res : 0;
+}
 
-    /* write payload marker */
-    if (pdu->payload_len) {
-        *bufpos++ = GCOAP_PAYLOAD_MARKER;
+/* Adds the Observe option to a notification or registration response */
+static int _write_observe(coap_pkt_t *pdu)
+{
+    if ((coap_get_code_class(pdu) == COAP_CLASS_SUCCESS) &&
+        coap_has_observe(pdu)) {
+        /* the value has at most 3 bytes */
+        return coap_opt_add_uint(pdu, COAP_OPT_OBSERVE,
+                                 pdu->observe_value & 0xFFFFFF);
     }
-    return bufpos - buf;
+    return 0;
 }
 
 static bool _endpoints_equal(const sock_udp_ep_t *ep1, const sock_udp_ep_t *ep2)
@@ -688,12 +970,31 @@ kernel_pid_t gcoap_init(void)
     if (_pid != KERNEL_PID_UNDEF) {
         return -EEXIST;
     }
+#ifdef MODULE_GCOAP_WORKER
+    mbox_init(&_worker_mbox, _worker_queue, GCOAP_WORKER_QUEUE_SIZE);
+    mbox_init(&_worker_free, _worker_free_queue, GCOAP_WORKER_QUEUE_SIZE);
+    for (unsigned i = 0; i < GCOAP_WORKER_QUEUE_SIZE; i++) {
+        msg_t msg;
+        msg.content.ptr = &_worker_reqs[i];
+        mbox_put(&_worker_free, &msg);
+    }
+    for (unsigned i = 0; i < GCOAP_WORKER_NUMOF; i++) {
+        thread_create(_worker_stacks[i], sizeof(_worker_stacks[i]),
+                      GCOAP_WORKER_PRIO, THREAD_CREATE_STACKTEST,
+                      _worker_loop, NULL, "coap worker");
+    }
+#endif
     _pid = thread_create(_msg_stack, sizeof(_msg_stack), THREAD_PRIORITY_MAIN - 1,
                             THREAD_CREATE_STACKTEST, _event_loop, NULL, "coap");
 
     mutex_init(&_coap_state.lock);
+    mutex_lock(&_coap_state.lock);
+    _index_default_listener();
+    mutex_unlock(&_coap_state.lock);
     /* Blank lists so we know if an entry is available. */
     memset(&_coap_state.open_reqs[0], 0, sizeof(_coap_state.open_reqs));
+    memset(&_coap_state.open_reqs_by_token[0], 0,
+           sizeof(_coap_state.open_reqs_by_token));
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
     memset(&_coap_state.resend_bufs[0], 0, sizeof(_coap_state.resend_bufs));
@@ -703,8 +1004,16 @@ kernel_pid_t gcoap_init(void)
     return _pid;
 }
 
-void gcoap_register_listener(gcoap_listener_t *listener)
+int gcoap_register_listener(gcoap_listener_t *listener)
 {
+    mutex_lock(&_coap_state.lock);
+    _index_default_listener();
+    int res = _index_listener(listener);
+    mutex_unlock(&_coap_state.lock);
+    if (res < 0) {
+        return res;
+    }
+
     /* Add the listener to the end of the linked list. */
     gcoap_listener_t *_last = _coap_state.listeners;
     while (_last->next) {
@@ -713,11 +1022,39 @@ void gcoap_register_listener(gcoap_listener_t *listener)
 
     listener->next = NULL;
     _last->next = listener;
+    return 0;
+}
+
+int gcoap_find_resource(coap_pkt_t *pdu, coap_resource_t **resource_ptr,
+                        gcoap_listener_t **listener_ptr)
+{
+    /* GCOAP_MATCH_SUBTREE isn't a method, a request with the code of its bit
+     * must not match subtree resources */
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu)) &
+                           ~GCOAP_MATCH_SUBTREE;
+    _path_entry_t *entry = NULL;
+
+    mutex_lock(&_coap_state.lock);
+    _index_default_listener();
+    int res = _path_match(pdu, 0, coap_find_option(pdu, COAP_OPT_URI_PATH), 1,
+                          method_flag, &entry);
+    mutex_unlock(&_coap_state.lock);
+
+    if (res == GCOAP_RESOURCE_FOUND) {
+        *resource_ptr = entry->resource;
+        *listener_ptr = entry->listener;
+    }
+    return res;
 }
 
 int gcoap_req_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code,
                                                               char *path) {
-    (void)len;
+    size_t path_len = strlen(path);
+
+    if (path_len && (path[0] != '/')) {
+        DEBUG("gcoap: path does not start with '/'\n");
+        return -1;
+    }
 
     pdu->hdr = (coap_hdr_t *)buf;
     memset(pdu->url, 0, NANOCOAP_URL_MAX);
@@ -742,15 +1079,19 @@ int gcoap_req_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code,
 #endif
 
     if (hdrlen > 0) {
+        coap_pkt_init(pdu, buf, len, hdrlen);
+        if (coap_opt_add_string(pdu, COAP_OPT_URI_PATH, path, '/') < 0) {
+            return -1;
+        }
         /* Reserve some space between the header and payload to write options later */
-        pdu->payload      = buf + coap_get_total_hdr_len(pdu) + strlen(path)
+        pdu->payload      = buf + coap_get_total_hdr_len(pdu) + path_len
                                                               + GCOAP_REQ_OPTIONS_BUF;
         /* Payload length really zero at this point, but we set this to the available
          * length in the buffer. Allows us to reconstruct buffer length later. */
         pdu->payload_len  = len - (pdu->payload - buf);
         pdu->content_type = COAP_FORMAT_NONE;
 
-        memcpy(&pdu->url[0], path, strlen(path));
+        memcpy(&pdu->url[0], path, path_len);
         return 0;
     }
     else {
@@ -761,12 +1102,27 @@ int gcoap_req_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code,
 
 ssize_t gcoap_finish(coap_pkt_t *pdu, size_t payload_len, unsigned format)
 {
-    /* reconstruct full PDU buffer length */
-    size_t len = pdu->payload_len + (pdu->payload - (uint8_t *)pdu->hdr);
+    uint8_t *payload = pdu->payload;
 
+    /* The options must not run into the payload. If they were finished with
+     * coap_opt_finish() already, the payload directly follows them. */
+    if (payload_len) {
+        pdu->payload_len = 0;
+    }
     pdu->content_type = format;
-    pdu->payload_len  = payload_len;
-    return _finish_pdu(pdu, (uint8_t *)pdu->hdr, len);
+    if ((_write_options(pdu) < 0) ||
+        (coap_opt_finish(pdu, payload_len ? COAP_OPT_FINISH_PAYLOAD
+                                          : COAP_OPT_FINISH_NONE) < 0)) {
+        DEBUG("gcoap: no space for options\n");
+        return -1;
+    }
+
+    /* move payload over unused space after options */
+    if (payload_len && (pdu->payload != payload)) {
+        memmove(pdu->payload, payload, payload_len);
+    }
+    pdu->payload_len = payload_len;
+    return (pdu->payload - (uint8_t *)pdu->hdr) + payload_len;
 }
 
 size_t gcoap_req_send(const uint8_t *buf, size_t len, const ipv6_addr_t *addr,
@@ -788,22 +1144,38 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
                        gcoap_resp_handler_t resp_handler)
 {
     gcoap_request_memo_t *memo = NULL;
+    unsigned nstart = GCOAP_NSTART;
+    unsigned outstanding = 0;
     assert(remote != NULL);
 
-    /* Find empty slot in list of open requests. */
+    /* Find empty slot in list of open requests, and count the requests
+     * awaiting a response from remote (RFC 7252, section 4.7). */
     mutex_lock(&_coap_state.lock);
     for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED) {
-            memo = &_coap_state.open_reqs[i];
-            memo->state = GCOAP_MEMO_WAIT;
-            break;
+        gcoap_request_memo_t *open_req = &_coap_state.open_reqs[i];
+
+        if (open_req->state == GCOAP_MEMO_UNUSED) {
+            if (memo == NULL) {
+                memo = open_req;
+            }
+        }
+        else if ((open_req->state == GCOAP_MEMO_WAIT) &&
+                 _endpoints_equal(&open_req->remote_ep, remote)) {
+            outstanding++;
+            /* a retransmission indicates congestion */
+            if ((open_req->send_limit != GCOAP_SEND_LIMIT_NON) &&
+                (open_req->send_limit < COAP_MAX_RETRANSMIT)) {
+                nstart = 1;
+            }
         }
     }
-    if (!memo) {
+    if (!memo || (outstanding >= nstart)) {
         mutex_unlock(&_coap_state.lock);
-        DEBUG("gcoap: dropping request; no space for response tracking\n");
+        DEBUG("gcoap: dropping request; %s\n", (memo) ? "NSTART reached"
+                                                      : "no space for response tracking");
         return 0;
     }
+    memo->state = GCOAP_MEMO_WAIT;
 
     unsigned msg_type  = (*buf & 0x30) >> 4;
     uint32_t timeout   = 0;
@@ -844,6 +1216,12 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
         DEBUG("gcoap: illegal msg type %u\n", msg_type);
         break;
     }
+    if (memo->state != GCOAP_MEMO_UNUSED) {
+        /* track by token before a response can arrive */
+        gcoap_request_memo_t **bucket = _req_memo_bucket_of(memo);
+        memo->next = *bucket;
+        *bucket = memo;
+    }
     mutex_unlock(&_coap_state.lock);
     if (memo->state == GCOAP_MEMO_UNUSED) {
         return 0;
@@ -876,10 +1254,7 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
         }
     }
     if (res <= 0) {
-        if (msg_type == COAP_TYPE_CON) {
-            *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
-        }
-        memo->state = GCOAP_MEMO_UNUSED;
+        _release_req_memo(memo);
         DEBUG("gcoap: sock send failed: %d\n", (int)res);
     }
     return (size_t)((res > 0) ? res : 0);
@@ -887,11 +1262,22 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
 
 int gcoap_resp_init(coap_pkt_t *pdu, uint8_t *buf, size_t len, unsigned code)
 {
+    /* The request may still be in the receive buffer of the network stack */
+    if ((uint8_t *)pdu->hdr != buf) {
+        memcpy(buf, pdu->hdr, coap_get_total_hdr_len(pdu));
+        pdu->hdr = (coap_hdr_t *)buf;
+    }
     if (coap_get_type(pdu) == COAP_TYPE_CON) {
         coap_hdr_set_type(pdu->hdr, COAP_TYPE_ACK);
     }
     coap_hdr_set_code(pdu->hdr, code);
 
+    /* the options of the request are overwritten from here */
+    coap_pkt_init(pdu, buf, len, coap_get_total_hdr_len(pdu));
+    if (_write_observe(pdu) < 0) {
+        return -1;
+    }
+
     /* Reserve some space between the header and payload to write options later */
     pdu->payload      = buf + coap_get_total_hdr_len(pdu) + GCOAP_RESP_OPTIONS_BUF;
     /* Payload length really zero at this point, but we set this to the available
@@ -922,6 +1308,11 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         uint32_t now       = xtimer_now_usec();
         pdu->observe_value = (now >> GCOAP_OBS_TICK_EXPONENT) & 0xFFFFFF;
 
+        coap_pkt_init(pdu, buf, len, hdrlen);
+        if (_write_observe(pdu) < 0) {
+            return GCOAP_OBS_INIT_ERR;
+        }
+
         /* Reserve some space between the header and payload to write options later */
         pdu->payload       = buf + coap_get_total_hdr_len(pdu) + GCOAP_OBS_OPTIONS_BUF;
         /* Payload length really zero at this point, but we set this to the available
@@ -1018,6 +1409,10 @@ int gcoap_add_qstring(coap_pkt_t *pdu, const char *key, const char *val)
         return -1;
     }
 
+    size_t start = qs_len;
+    size_t payload_len = pdu->payload_len;
+    ssize_t res;
+
     pdu->qs[qs_len++] = '&';
     memcpy(&pdu->qs[qs_len], key, key_len);
     qs_len += key_len;
@@ -1028,6 +1423,19 @@ int gcoap_add_qstring(coap_pkt_t *pdu, const char *key, const char *val)
     }
     pdu->qs[qs_len] = '\0';
 
+    /* Write the option right away, so it doesn't matter if the payload is
+     * moved by gcoap_finish() or written in place after coap_opt_finish().
+     * It must not run into a payload written already. */
+    pdu->payload_len = 0;
+    res = coap_opt_add_opaque(pdu, COAP_OPT_URI_QUERY, &pdu->qs[start + 1],
+                              strlen((char *)&pdu->qs[start + 1]));
+    pdu->payload_len = payload_len;
+    if (res < 0) {
+        DEBUG("gcoap: no space for Uri-Query\n");
+        pdu->qs[start] = '\0';
+        return -1;
+    }
+
     return (int)qs_len;
 }
 
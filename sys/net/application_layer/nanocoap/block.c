@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_nanocoap_block
+ * @{
+ *
+ * @file
+ * @brief       nanocoap blockwise transfers
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/nanocoap_block.h"
+#ifdef MODULE_VFS
+#include "vfs.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief   Space reserved in a Block2 response for the Content-Format and
+ *          Block2 options and the payload marker
+ */
+#define BLOCK2_OPTS_MAX     (3U + 4U + 1U)
+
+ssize_t coap_block2_reply(coap_pkt_t *pkt, unsigned code, uint8_t *buf,
+                          size_t len, unsigned ct, coap_block_read_t read,
+                          void *arg)
+{
+    coap_block1_t block2;
+    size_t hdr_len = coap_get_total_hdr_len(pkt);
+
+    /* the request options are overwritten by the response, so get Block2
+     * first */
+    int blockwise = coap_get_block2(pkt, &block2);
+
+    /* one more byte than the block is read to find out if another block
+     * follows */
+    if (len < (hdr_len + BLOCK2_OPTS_MAX + 16 + 1)) {
+        return -ENOSPC;
+    }
+    unsigned szx = coap_size2szx(len - hdr_len - BLOCK2_OPTS_MAX - 1);
+    if (szx > NANOCOAP_BLOCK_SZX_MAX) {
+        szx = NANOCOAP_BLOCK_SZX_MAX;
+    }
+    if (blockwise && (block2.szx < szx)) {
+        szx = block2.szx;
+    }
+    size_t blksize = coap_szx2size(szx);
+    /* a block of a smaller size starts at the offset requested */
+    unsigned blknum = block2.offset / blksize;
+
+    uint8_t *payload = buf + hdr_len + BLOCK2_OPTS_MAX;
+    ssize_t n = read(arg, blknum * blksize, payload, blksize + 1);
+    if (n < 0) {
+        DEBUG("nanocoap_block: reading block %u failed\n", blknum);
+        return coap_build_reply(pkt, COAP_CODE_INTERNAL_SERVER_ERROR, buf,
+                                len, 0);
+    }
+    if ((n == 0) && (blknum > 0)) {
+        return coap_build_reply(pkt, COAP_CODE_BAD_OPTION, buf, len, 0);
+    }
+    int more = ((size_t)n > blksize);
+    if (more) {
+        n = blksize;
+    }
+
+    uint8_t *bufpos = buf + hdr_len;
+    bufpos += coap_put_option_ct(bufpos, 0, ct);
+    bufpos += coap_put_option_block2(bufpos, COAP_OPT_CONTENT_FORMAT, blknum,
+                                     szx, more);
+    if (n > 0) {
+        *bufpos++ = 0xff;
+        memmove(bufpos, payload, n);
+        bufpos += n;
+    }
+
+    return coap_build_reply(pkt, code, buf, len, bufpos - (buf + hdr_len));
+}
+
+ssize_t coap_block1_reply(coap_pkt_t *pkt, unsigned code, uint8_t *buf,
+                          size_t len, coap_block_write_t write, void *arg)
+{
+    coap_block1_t block1;
+    int blockwise = coap_get_block1(pkt, &block1);
+    bool more = blockwise && (block1.more == 1);
+
+    int res = write(arg, block1.offset, pkt->payload, pkt->payload_len, more);
+    if (res < 0) {
+        DEBUG("nanocoap_block: writing at offset %u failed: %d\n",
+              (unsigned)block1.offset, res);
+        switch (res) {
+            case -ENOSPC:
+            case -EFBIG:
+                code = COAP_CODE_REQUEST_ENTITY_TOO_LARGE;
+                break;
+            case -EINVAL:
+                code = COAP_CODE_REQUEST_ENTITY_INCOMPLETE;
+                break;
+            default:
+                code = COAP_CODE_INTERNAL_SERVER_ERROR;
+        }
+        return coap_build_reply(pkt, code, buf, len, 0);
+    }
+
+    size_t hdr_len = coap_get_total_hdr_len(pkt);
+    size_t opt_len = 0;
+    if (blockwise) {
+        /* the response to the last block echoes Block1, too */
+        opt_len = coap_put_option_block1(buf + hdr_len, 0, block1.blknum,
+                                         block1.szx, more);
+    }
+    return coap_build_reply(pkt, more ? COAP_CODE_CONTINUE : code, buf, len,
+                            opt_len);
+}
+
+#ifdef MODULE_VFS
+ssize_t coap_block_vfs_read(void *arg, size_t offset, uint8_t *buf, size_t len)
+{
+    int fd = *(int *)arg;
+    size_t pos = 0;
+
+    if (vfs_lseek(fd, offset, SEEK_SET) < 0) {
+        return -EIO;
+    }
+    while (pos < len) {
+        ssize_t n = vfs_read(fd, buf + pos, len - pos);
+        if (n < 0) {
+            return n;
+        }
+        if (n == 0) {
+            break;
+        }
+        pos += n;
+    }
+    return pos;
+}
+
+int coap_block_vfs_write(void *arg, size_t offset, const uint8_t *buf,
+                         size_t len, bool more)
+{
+    int fd = *(int *)arg;
+    size_t pos = 0;
+    struct stat st;
+
+    if (vfs_lseek(fd, offset, SEEK_SET) < 0) {
+        return -EIO;
+    }
+    while (pos < len) {
+        ssize_t n = vfs_write(fd, buf + pos, len - pos);
+        if (n <= 0) {
+            return (n < 0) ? n : -ENOSPC;
+        }
+        pos += n;
+    }
+    /* the last block ends the representation, a longer file written before
+     * must not keep its tail */
+    if (!more && ((vfs_fstat(fd, &st) < 0) ||
+                  ((size_t)st.st_size > (offset + len)))) {
+        int res = vfs_ftruncate(fd, offset + len);
+
+        /* -EINVAL would blame the client for blocks out of order */
+        return (res == -EINVAL) ? -ENOTSUP : res;
+    }
+    return 0;
+}
+#endif
+
+#ifdef MODULE_MTD
+ssize_t coap_block_mtd_read(void *arg, size_t offset, uint8_t *buf, size_t len)
+{
+    coap_block_mtd_t *area = arg;
+
+    if (offset >= area->size) {
+        return 0;
+    }
+    if (len > (area->size - offset)) {
+        len = area->size - offset;
+    }
+    int res = mtd_read(area->dev, buf, area->addr + offset, len);
+    return (res < 0) ? res : (ssize_t)len;
+}
+
+int coap_block_mtd_write(void *arg, size_t offset, const uint8_t *buf,
+                         size_t len, bool more)
+{
+    coap_block_mtd_t *area = arg;
+    mtd_dev_t *dev = area->dev;
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+
+    (void)more;
+    if ((offset > area->size) || (len > (area->size - offset))) {
+        return -ENOSPC;
+    }
+
+    /* erase the sectors starting within this chunk, assuming the chunks
+     * arrive in order */
+    uint32_t addr = area->addr + offset;
+    uint32_t sector = ((addr + sector_size - 1) / sector_size) * sector_size;
+    for (; sector < (addr + len); sector += sector_size) {
+        int res = mtd_erase(dev, sector, sector_size);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    /* a single write must not cross a page boundary */
+    while (len > 0) {
+        uint32_t chunk = dev->page_size - (addr % dev->page_size);
+
+        if (chunk > len) {
+            chunk = len;
+        }
+        int res = mtd_write(dev, buf, addr, chunk);
+        if (res < 0) {
+            return res;
+        }
+        buf += chunk;
+        addr += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+#endif
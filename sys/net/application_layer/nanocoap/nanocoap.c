@@ -66,9 +66,15 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
         pkt->token = NULL;
     }
 
-    coap_optpos_t *optpos = pkt->options;
     unsigned option_count = 0;
     unsigned option_nr = 0;
+#ifdef MODULE_GCOAP
+    /* the options gcoap needs are picked up in the same pass */
+    uint8_t *url_pos = pkt->url;
+    pkt->url[0] = '\0';
+    pkt->content_type = COAP_FORMAT_NONE;
+    pkt->observe_value = UINT32_MAX;
+#endif
 
     /* parse options */
     while (pkt_pos != pkt_end) {
@@ -77,6 +83,7 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
         if (option_byte == 0xff) {
             pkt->payload = pkt_pos;
             pkt->payload_len = buf + len - pkt_pos;
+            pkt_pos = option_start;
             DEBUG("payload len = %u\n", pkt->payload_len);
             break;
         }
@@ -92,36 +99,64 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
                 return -EBADMSG;
             }
             option_nr += option_delta;
+            option_count++;
             DEBUG("option count=%u nr=%u len=%i\n", option_count, option_nr, option_len);
 
-            if (option_delta) {
-                optpos->opt_num = option_nr;
-                optpos->offset = (uintptr_t)option_start - (uintptr_t)hdr;
-                DEBUG("optpos option_nr=%u %u\n", (unsigned)option_nr, (unsigned)optpos->offset);
-                optpos++;
-                option_count++;
-            }
-
-            pkt_pos += option_len;
-
-            if (pkt_pos > (buf + len)) {
+            if ((pkt_pos + option_len) > (buf + len)) {
                 DEBUG("nanocoap: bad pkt\n");
                 return -EBADMSG;
             }
+
+#ifdef MODULE_GCOAP
+            switch (option_nr) {
+                case COAP_OPT_URI_PATH:
+                    if (url_pos == NULL) {
+                        break;
+                    }
+                    if ((url_pos + option_len + 2) > (pkt->url + NANOCOAP_URI_MAX)) {
+                        /* leave the URL empty, so it matches no resource */
+                        DEBUG("nanocoap: URI too long\n");
+                        url_pos = NULL;
+                        break;
+                    }
+                    *url_pos++ = '/';
+                    memcpy(url_pos, pkt_pos, option_len);
+                    url_pos += option_len;
+                    break;
+                case COAP_OPT_CONTENT_FORMAT:
+                    if (option_len <= 2) {
+                        pkt->content_type = _decode_uint(pkt_pos, option_len);
+                    }
+                    break;
+                case COAP_OPT_OBSERVE:
+                    if (option_len <= 4) {
+                        pkt->observe_value = _decode_uint(pkt_pos, option_len);
+                    }
+                    break;
+                default:
+                    break;
+            }
+#endif
+
+            pkt_pos += option_len;
         }
     }
 
-    pkt->options_len = option_count;
+    pkt->options_end = pkt_pos - buf;
+    pkt->options_last = option_nr;
     if (!pkt->payload) {
         pkt->payload = pkt_pos;
     }
 
 #ifdef MODULE_GCOAP
-    coap_get_uri(pkt, pkt->url);
-    pkt->content_type = coap_get_content_type(pkt);
-
-    if (coap_get_option_uint(pkt, COAP_OPT_OBSERVE, &pkt->observe_value) != 0) {
-        pkt->observe_value = UINT32_MAX;
+    if (url_pos == NULL) {
+        pkt->url[0] = '\0';
+    }
+    else {
+        if (url_pos == pkt->url) {
+            *url_pos++ = '/';
+        }
+        *url_pos = '\0';
     }
 #endif
 
@@ -133,23 +168,51 @@ int coap_parse(coap_pkt_t *pkt, uint8_t *buf, size_t len)
     return 0;
 }
 
+void coap_optiter_init(coap_pkt_t *pkt, coap_optiter_t *iter)
+{
+    iter->pos = (uint8_t *)pkt->hdr + coap_get_total_hdr_len(pkt);
+    iter->end = (uint8_t *)pkt->hdr + pkt->options_end;
+    iter->opt_num = 0;
+}
+
+uint8_t *coap_optiter_next(coap_optiter_t *iter, int *opt_len)
+{
+    /* coap_parse() already validated the options */
+    if (iter->pos >= iter->end) {
+        return NULL;
+    }
+
+    uint8_t option_byte = *iter->pos++;
+    iter->opt_num += _decode_value(option_byte >> 4, &iter->pos, iter->end);
+    *opt_len = _decode_value(option_byte & 0xf, &iter->pos, iter->end);
+
+    uint8_t *value = iter->pos;
+    iter->pos += *opt_len;
+    return value;
+}
+
 uint8_t *coap_find_option(coap_pkt_t *pkt, unsigned opt_num)
 {
-    coap_optpos_t *optpos = pkt->options;
-    unsigned opt_count = pkt->options_len;
+    coap_optiter_t iter;
+    int opt_len;
+
+    coap_optiter_init(pkt, &iter);
+    while (iter.opt_num <= opt_num) {
+        uint8_t *opt_pos = iter.pos;
 
-    while (opt_count--) {
-        if (optpos->opt_num == opt_num) {
-            return (uint8_t*)pkt->hdr + optpos->offset;
+        if (!coap_optiter_next(&iter, &opt_len)) {
+            break;
+        }
+        if (iter.opt_num == opt_num) {
+            return opt_pos;
         }
-        optpos++;
     }
     return NULL;
 }
 
 static uint8_t *_parse_option(coap_pkt_t *pkt, uint8_t *pkt_pos, uint16_t *delta, int *opt_len)
 {
-    uint8_t *hdr_end = pkt->payload;
+    uint8_t *hdr_end = (uint8_t *)pkt->hdr + pkt->options_end;
 
     if (pkt_pos == hdr_end) {
         return NULL;
@@ -302,20 +365,25 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
 #endif
     DEBUG("nanocoap: URI path: \"%s\"\n", uri);
 
-    for (unsigned i = 0; i < coap_resources_numof; i++) {
-        const coap_resource_t *resource = &coap_resources[i];
-        if (!(resource->methods & method_flag)) {
-            continue;
+    /* coap_resources is sorted by path: find the first resource with the
+     * path by binary search, then the first of those accepting the method */
+    unsigned lo = 0, hi = coap_resources_numof;
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if (strcmp(coap_resources[mid].path, (char *)uri) < 0) {
+            lo = mid + 1;
         }
-
-        int res = strcmp((char *)uri, resource->path);
-        if (res > 0) {
-            continue;
+        else {
+            hi = mid;
         }
-        else if (res < 0) {
+    }
+
+    for (unsigned i = lo; i < coap_resources_numof; i++) {
+        const coap_resource_t *resource = &coap_resources[i];
+        if (strcmp((char *)uri, resource->path) != 0) {
             break;
         }
-        else {
+        if (resource->methods & method_flag) {
             return resource->handler(pkt, resp_buf, resp_buf_len, resource->context);
         }
     }
@@ -486,11 +554,8 @@ static unsigned _put_delta_optlen(uint8_t *buf, unsigned offset, unsigned shift,
     return offset;
 }
 
-size_t coap_put_option(uint8_t *buf, uint16_t lastonum, uint16_t onum, uint8_t *odata, size_t olen)
+static unsigned _put_opt_hdr(uint8_t *buf, unsigned delta, unsigned olen)
 {
-    assert(lastonum <= onum);
-
-    unsigned delta = (onum - lastonum);
     *buf = 0;
 
     /* write delta value to option header: 4 upper bits of header (shift 4) +
@@ -498,7 +563,20 @@ size_t coap_put_option(uint8_t *buf, uint16_t lastonum, uint16_t onum, uint8_t *
     unsigned n = _put_delta_optlen(buf, 1, 4, delta);
     /* write option length to option header: 4 lower bits of header (shift 0) +
      * 1 or 2 optional bytes depending of the length of the option */
-    n = _put_delta_optlen(buf, n, 0, olen);
+    return _put_delta_optlen(buf, n, 0, olen);
+}
+
+static unsigned _opt_hdr_len(unsigned delta, unsigned olen)
+{
+    return 1 + ((delta < 13) ? 0 : ((delta < 269) ? 1 : 2)) +
+               ((olen < 13) ? 0 : ((olen < 269) ? 1 : 2));
+}
+
+size_t coap_put_option(uint8_t *buf, uint16_t lastonum, uint16_t onum, uint8_t *odata, size_t olen)
+{
+    assert(lastonum <= onum);
+
+    unsigned n = _put_opt_hdr(buf, onum - lastonum, olen);
     if (olen) {
         memcpy(buf + n, odata, olen);
         n += olen;
@@ -532,22 +610,37 @@ size_t coap_put_option_block1(uint8_t *buf, uint16_t lastonum, unsigned blknum,
     return coap_put_option_block(buf, lastonum, blknum, szx, more, COAP_OPT_BLOCK1);
 }
 
-int coap_get_block1(coap_pkt_t *pkt, coap_block1_t *block1)
+size_t coap_put_option_block2(uint8_t *buf, uint16_t lastonum, unsigned blknum, unsigned szx, int more)
+{
+    return coap_put_option_block(buf, lastonum, blknum, szx, more, COAP_OPT_BLOCK2);
+}
+
+static int _get_block(coap_pkt_t *pkt, coap_block1_t *block, uint16_t option)
 {
     uint32_t blknum;
     unsigned szx;
-    block1->more = coap_get_blockopt(pkt, COAP_OPT_BLOCK1, &blknum, &szx);
-    if (block1->more >= 0) {
-        block1->offset = blknum << (szx + 4);
+    block->more = coap_get_blockopt(pkt, option, &blknum, &szx);
+    if (block->more >= 0) {
+        block->offset = blknum << (szx + 4);
     }
     else {
-        block1->offset = 0;
+        block->offset = 0;
     }
 
-    block1->blknum = blknum;
-    block1->szx = szx;
+    block->blknum = blknum;
+    block->szx = szx;
+
+    return (block->more >= 0);
+}
+
+int coap_get_block1(coap_pkt_t *pkt, coap_block1_t *block1)
+{
+    return _get_block(pkt, block1, COAP_OPT_BLOCK1);
+}
 
-    return (block1->more >= 0);
+int coap_get_block2(coap_pkt_t *pkt, coap_block1_t *block2)
+{
+    return _get_block(pkt, block2, COAP_OPT_BLOCK2);
 }
 
 size_t coap_put_block1_ok(uint8_t *pkt_pos, coap_block1_t *block1, uint16_t lastonum)
@@ -595,6 +688,120 @@ size_t coap_put_option_uri(uint8_t *buf, uint16_t lastonum, const char *uri, uin
     return bufpos - buf;
 }
 
+void coap_pkt_init(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                   size_t header_len)
+{
+    pkt->hdr = (coap_hdr_t *)buf;
+    pkt->token = coap_get_token_len(pkt) ? pkt->hdr->data : NULL;
+    pkt->payload = buf + header_len;
+    pkt->payload_len = len - header_len;
+    pkt->options_end = header_len;
+    pkt->options_last = 0;
+}
+
+ssize_t coap_opt_add_opaque(coap_pkt_t *pkt, uint16_t optnum,
+                            const uint8_t *val, size_t val_len)
+{
+    uint8_t *buf = (uint8_t *)pkt->hdr;
+    uint8_t *end = pkt->payload + pkt->payload_len;
+    uint8_t *pos = buf + pkt->options_end;
+    uint16_t lastonum = pkt->options_last;
+
+    if (optnum >= lastonum) {
+        /* common case, append */
+        size_t opt_len = _opt_hdr_len(optnum - lastonum, val_len) + val_len;
+
+        if ((pos + opt_len) > end) {
+            return -ENOSPC;
+        }
+        coap_put_option(pos, lastonum, optnum, (uint8_t *)val, val_len);
+        pkt->options_end += opt_len;
+        pkt->options_last = optnum;
+        return opt_len;
+    }
+
+    /* insert in front of the first option with a higher number, whose delta
+     * shrinks and so may need a shorter header */
+    coap_optiter_t iter;
+    int next_len;
+    coap_optiter_init(pkt, &iter);
+    lastonum = 0;
+    while (1) {
+        pos = iter.pos;
+        coap_optiter_next(&iter, &next_len);
+        if (iter.opt_num > optnum) {
+            break;
+        }
+        lastonum = iter.opt_num;
+    }
+    uint8_t *next_val = iter.pos - next_len;
+    size_t opt_len = _opt_hdr_len(optnum - lastonum, val_len) + val_len;
+    size_t next_hdr_len = _opt_hdr_len(iter.opt_num - optnum, next_len);
+    /* the new option's delta takes at least the bytes the next one saves */
+    size_t shift = opt_len + next_hdr_len - (next_val - pos);
+
+    if ((buf + pkt->options_end + shift) > end) {
+        return -ENOSPC;
+    }
+    memmove(next_val + shift, next_val, (buf + pkt->options_end) - next_val);
+    pos += coap_put_option(pos, lastonum, optnum, (uint8_t *)val, val_len);
+    _put_opt_hdr(pos, iter.opt_num - optnum, next_len);
+    pkt->options_end += shift;
+    return shift;
+}
+
+ssize_t coap_opt_add_uint(coap_pkt_t *pkt, uint16_t optnum, uint32_t value)
+{
+    size_t len = _encode_uint(&value);
+
+    return coap_opt_add_opaque(pkt, optnum, (uint8_t *)&value, len);
+}
+
+ssize_t coap_opt_add_string(coap_pkt_t *pkt, uint16_t optnum,
+                            const char *string, char separator)
+{
+    ssize_t total = 0;
+
+    while (*string) {
+        size_t part_len = 0;
+
+        while (string[part_len] && (string[part_len] != separator)) {
+            part_len++;
+        }
+        if (part_len) {
+            ssize_t res = coap_opt_add_opaque(pkt, optnum,
+                                              (const uint8_t *)string,
+                                              part_len);
+            if (res < 0) {
+                return res;
+            }
+            total += res;
+            string += part_len;
+        }
+        if (*string) {
+            /* skip separator */
+            string++;
+        }
+    }
+    return total;
+}
+
+ssize_t coap_opt_finish(coap_pkt_t *pkt, uint16_t flags)
+{
+    uint8_t *end = pkt->payload + pkt->payload_len;
+    uint8_t *pos = (uint8_t *)pkt->hdr + pkt->options_end;
+
+    if (flags & COAP_OPT_FINISH_PAYLOAD) {
+        if (pos >= end) {
+            return -ENOSPC;
+        }
+        *pos++ = 0xff;
+    }
+    pkt->payload = pos;
+    pkt->payload_len = end - pos;
+    return pos - (uint8_t *)pkt->hdr;
+}
+
 ssize_t coap_well_known_core_default_handler(coap_pkt_t *pkt, uint8_t *buf, \
                                              size_t len, void *context)
 {
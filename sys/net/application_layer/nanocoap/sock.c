@@ -20,18 +20,24 @@
 
 #include <errno.h>
 #include <string.h>
-#include <stdio.h>
 
 #include "net/nanocoap.h"
+#include "net/nanocoap_sock.h"
 #include "net/sock/udp.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-ssize_t nanocoap_get(sock_udp_ep_t *remote, const char *path, uint8_t *buf, size_t len)
+/* space for Content-Format, ETag and Block2 of a blockwise response */
+#define BLOCKWISE_RESP_OPTS_MAX     (3U + 9U + 4U)
+
+/* sends the request in buf and parses the response into pkt */
+static ssize_t _request(sock_udp_ep_t *remote, uint8_t *buf, size_t pdu_len,
+                        size_t len, coap_pkt_t *pkt)
 {
     ssize_t res;
     sock_udp_t sock;
+    uint16_t id = ntohs(((coap_hdr_t *)buf)->id);
 
     if (!remote->port) {
         remote->port = COAP_PORT;
@@ -42,28 +48,20 @@ ssize_t nanocoap_get(sock_udp_ep_t *remote, const char *path, uint8_t *buf, size
         return res;
     }
 
-    uint8_t *pktpos = buf;
-    pktpos += coap_build_hdr((coap_hdr_t *)pktpos, COAP_REQ, NULL, 0, COAP_METHOD_GET, 1);
-    pktpos += coap_put_option_uri(pktpos, 0, path, COAP_OPT_URI_PATH);
-
     /* TODO: timeout random between between ACK_TIMEOUT and (ACK_TIMEOUT *
      * ACK_RANDOM_FACTOR) */
     uint32_t timeout = COAP_ACK_TIMEOUT * (1000000U);
     int tries = 0;
     while (tries++ < COAP_MAX_RETRANSMIT) {
-        if (!tries) {
-            DEBUG("nanocoap: maximum retries reached.\n");
-            res = -ETIMEDOUT;
-            goto out;
-        }
-
-        res = sock_udp_send(&sock, buf, pktpos - buf, NULL);
+        res = sock_udp_send(&sock, buf, pdu_len, NULL);
         if (res <= 0) {
             DEBUG("nanocoap: error sending coap request\n");
-            goto out;
+            break;
         }
 
-        res = sock_udp_recv(&sock, buf, len, timeout, NULL);
+        /* the response overwrites the request, keep it for retransmissions
+         * until one arrives */
+        res = sock_udp_recv(&sock, buf + pdu_len, len - pdu_len, timeout, NULL);
         if (res <= 0) {
             if (res == -ETIMEDOUT) {
                 DEBUG("nanocoap: timeout\n");
@@ -75,32 +73,120 @@ ssize_t nanocoap_get(sock_udp_ep_t *remote, const char *path, uint8_t *buf, size
             break;
         }
 
-        coap_pkt_t pkt;
-        if (coap_parse(&pkt, (uint8_t *)buf, res) < 0) {
-            puts("error parsing packet");
+        if ((coap_parse(pkt, buf + pdu_len, res) < 0) ||
+            (coap_get_id(pkt) != id)) {
+            DEBUG("nanocoap: error parsing packet\n");
+            res = -EBADMSG;
             continue;
         }
-        else {
-            res = coap_get_code(&pkt);
-            if (res != 205) {
-                res = -res;
-            }
-            else {
-                if (pkt.payload_len) {
-                    memcpy(buf, pkt.payload, pkt.payload_len);
-                }
-                res = pkt.payload_len;
-            }
-            break;
-        }
+        break;
     }
 
-out:
     sock_udp_close(&sock);
 
     return res;
 }
 
+ssize_t nanocoap_get(sock_udp_ep_t *remote, const char *path, uint8_t *buf, size_t len)
+{
+    ssize_t res;
+    coap_pkt_t pkt;
+
+    uint8_t *pktpos = buf;
+    pktpos += coap_build_hdr((coap_hdr_t *)pktpos, COAP_REQ, NULL, 0, COAP_METHOD_GET, 1);
+    pktpos += coap_put_option_uri(pktpos, 0, path, COAP_OPT_URI_PATH);
+
+    res = _request(remote, buf, pktpos - buf, len, &pkt);
+    if (res < 0) {
+        return res;
+    }
+
+    res = coap_get_code(&pkt);
+    if (res != 205) {
+        return -res;
+    }
+    if (pkt.payload_len) {
+        memmove(buf, pkt.payload, pkt.payload_len);
+    }
+    return pkt.payload_len;
+}
+
+int nanocoap_get_blockwise_init(nanocoap_blockwise_t *ctx,
+                                const sock_udp_ep_t *remote, const char *path,
+                                uint8_t *buf, size_t len)
+{
+    /* the request is kept in front of the response: leave room for it (each
+     * path segment takes at most twice its length with the option header,
+     * plus Block2) and for the header and options of the response */
+    size_t reserved = (sizeof(coap_hdr_t) + 2 * strlen(path) + 4) +
+                      (sizeof(coap_hdr_t) + BLOCKWISE_RESP_OPTS_MAX + 1);
+
+    if (len < (reserved + 16)) {
+        return -ENOBUFS;
+    }
+
+    memcpy(&ctx->remote, remote, sizeof(ctx->remote));
+    ctx->path = path;
+    ctx->buf = buf;
+    ctx->len = len;
+    ctx->offset = 0;
+    ctx->id = 0;
+    ctx->szx = coap_size2szx(len - reserved);
+    ctx->done = false;
+
+    return 0;
+}
+
+ssize_t nanocoap_get_blockwise_next(nanocoap_blockwise_t *ctx, uint8_t **chunk)
+{
+    ssize_t res;
+    coap_pkt_t pkt;
+    coap_block1_t block2;
+
+    if (ctx->done) {
+        return 0;
+    }
+
+    uint8_t *pktpos = ctx->buf;
+    pktpos += coap_build_hdr((coap_hdr_t *)pktpos, COAP_REQ, NULL, 0,
+                             COAP_METHOD_GET, ++ctx->id);
+    pktpos += coap_put_option_uri(pktpos, 0, ctx->path, COAP_OPT_URI_PATH);
+    pktpos += coap_put_option_block2(pktpos, COAP_OPT_URI_PATH,
+                                     ctx->offset >> (ctx->szx + 4),
+                                     ctx->szx, 0);
+
+    res = _request(&ctx->remote, ctx->buf, pktpos - ctx->buf, ctx->len, &pkt);
+    if (res < 0) {
+        return res;
+    }
+
+    res = coap_get_code(&pkt);
+    if (res != 205) {
+        return -res;
+    }
+
+    if (coap_get_block2(&pkt, &block2)) {
+        /* the server may only decrease the block size */
+        if ((block2.szx > ctx->szx) || (block2.offset != ctx->offset)) {
+            DEBUG("nanocoap: unexpected block %u\n", (unsigned)block2.blknum);
+            return -EBADMSG;
+        }
+        ctx->szx = block2.szx;
+        ctx->done = !block2.more;
+    }
+    else if (ctx->offset == 0) {
+        /* representation fits into a single response */
+        ctx->done = true;
+    }
+    else {
+        return -EBADMSG;
+    }
+
+    ctx->offset += pkt.payload_len;
+    *chunk = pkt.payload;
+    return pkt.payload_len;
+}
+
 int nanocoap_server(sock_udp_ep_t *local, uint8_t *buf, size_t bufsize)
 {
     sock_udp_t sock;
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "bitarithm.h"
+#include "xtimer.h"
+
+#include "net/netstats/ext.h"
+
+static netstats_ext_t _stats;
+
+const netstats_ext_t *netstats_ext_get(void)
+{
+    return &_stats;
+}
+
+void netstats_ext_reset(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+uint32_t netstats_ext_now(void)
+{
+    uint32_t now = xtimer_now_usec();
+
+    /* 0 is reserved for "no receive time" */
+    return (now == 0) ? 1 : now;
+}
+
+static inline uint32_t _now_sec(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+void netstats_ext_drop(netstats_ext_layer_t layer, netstats_ext_drop_t reason)
+{
+    assert((layer < NETSTATS_EXT_LAYER_NUMOF) &&
+           (reason < NETSTATS_EXT_DROP_NUMOF));
+    _stats.drops[layer][reason]++;
+}
+
+void netstats_ext_rx(netstats_ext_layer_t layer, size_t bytes)
+{
+    assert(layer < NETSTATS_EXT_LAYER_NUMOF);
+    netstats_ext_rate_add(&_stats.rate[layer], _now_sec(), false, bytes);
+}
+
+void netstats_ext_tx(netstats_ext_layer_t layer, size_t bytes)
+{
+    assert(layer < NETSTATS_EXT_LAYER_NUMOF);
+    netstats_ext_rate_add(&_stats.rate[layer], _now_sec(), true, bytes);
+}
+
+void netstats_ext_latency(netstats_ext_layer_t layer, uint32_t rx_time)
+{
+    assert(layer < NETSTATS_EXT_LAYER_NUMOF);
+    if (rx_time != 0) {
+        netstats_ext_hist_add(&_stats.latency[layer],
+                              netstats_ext_now() - rx_time);
+    }
+}
+
+void netstats_ext_rates(netstats_ext_layer_t layer, netstats_ext_rates_t *res)
+{
+    assert(layer < NETSTATS_EXT_LAYER_NUMOF);
+    netstats_ext_rate_get(&_stats.rate[layer], _now_sec(), res);
+}
+
+void netstats_ext_hist_add(netstats_ext_hist_t *hist, uint32_t usec)
+{
+    unsigned bucket = 0;
+
+    assert(hist != NULL);
+    if ((usec >> NETSTATS_EXT_HIST_SHIFT) != 0) {
+        bucket = bitarithm_msb(usec >> NETSTATS_EXT_HIST_SHIFT) + 1;
+        if (bucket >= NETSTATS_EXT_HIST_BUCKETS) {
+            bucket = NETSTATS_EXT_HIST_BUCKETS - 1;
+        }
+    }
+    hist->buckets[bucket]++;
+    if ((hist->count == 0) || (usec < hist->min)) {
+        hist->min = usec;
+    }
+    if (usec > hist->max) {
+        hist->max = usec;
+    }
+    hist->sum += usec;
+    hist->count++;
+}
+
+void netstats_ext_rate_add(netstats_ext_rate_t *rate, uint32_t sec, bool tx,
+                           size_t bytes)
+{
+    netstats_ext_rate_slot_t *slot;
+
+    assert(rate != NULL);
+    slot = &rate->slots[sec % NETSTATS_EXT_RATE_WINDOW];
+    if (slot->sec != sec) {
+        /* slot was last used a full window ago */
+        memset(slot, 0, sizeof(*slot));
+        slot->sec = sec;
+    }
+    if (tx) {
+        slot->tx_count++;
+        slot->tx_bytes += bytes;
+    }
+    else {
+        slot->rx_count++;
+        slot->rx_bytes += bytes;
+    }
+}
+
+void netstats_ext_rate_get(const netstats_ext_rate_t *rate, uint32_t sec,
+                           netstats_ext_rates_t *res)
+{
+    assert((rate != NULL) && (res != NULL));
+    memset(res, 0, sizeof(*res));
+    for (unsigned i = 0; i < NETSTATS_EXT_RATE_WINDOW; i++) {
+        const netstats_ext_rate_slot_t *slot = &rate->slots[i];
+
+        /* skip slots outside of the window */
+        if ((sec - slot->sec) >= NETSTATS_EXT_RATE_WINDOW) {
+            continue;
+        }
+        res->rx_count += slot->rx_count;
+        res->rx_bytes += slot->rx_bytes;
+        res->tx_count += slot->tx_count;
+        res->tx_bytes += slot->tx_bytes;
+    }
+    res->rx_count /= NETSTATS_EXT_RATE_WINDOW;
+    res->rx_bytes /= NETSTATS_EXT_RATE_WINDOW;
+    res->tx_count /= NETSTATS_EXT_RATE_WINDOW;
+    res->tx_bytes /= NETSTATS_EXT_RATE_WINDOW;
+}
+
+/** @} */
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "net/netstats/neighbor.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static netstats_nb_t *_find(const netstats_nb_table_t *table,
+                            const uint8_t *l2addr, size_t l2addr_len)
+{
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        const netstats_nb_t *nb = &table->nbs[i];
+
+        if ((nb->l2addr_len == l2addr_len) &&
+            (memcmp(nb->l2addr, l2addr, l2addr_len) == 0)) {
+            return (netstats_nb_t *)nb;
+        }
+    }
+    return NULL;
+}
+
+void netstats_nb_init(netstats_nb_table_t *table)
+{
+    assert(table != NULL);
+    memset(table, 0, sizeof(*table));
+}
+
+void netstats_nb_record(netstats_nb_table_t *table, const uint8_t *l2addr,
+                        size_t l2addr_len)
+{
+    assert(table != NULL);
+    if ((l2addr == NULL) || (l2addr_len == 0) ||
+        (l2addr_len > NETSTATS_NB_L2ADDR_MAXLEN)) {
+        table->pending = NULL;
+        return;
+    }
+
+    netstats_nb_t *nb = _find(table, l2addr, l2addr_len);
+
+    if (nb == NULL) {
+        /* replace the neighbor used least recently; unused entries have
+         * never been used */
+        nb = &table->nbs[0];
+        for (unsigned i = 1; i < NETSTATS_NB_SIZE; i++) {
+            if ((nb->l2addr_len != 0) &&
+                ((table->nbs[i].l2addr_len == 0) ||
+                 ((table->clock - table->nbs[i].last_used) >
+                  (table->clock - nb->last_used)))) {
+                nb = &table->nbs[i];
+            }
+        }
+        DEBUG("netstats_nb: new neighbor in slot %u\n",
+              (unsigned)(nb - table->nbs));
+        memset(nb, 0, sizeof(*nb));
+        memcpy(nb->l2addr, l2addr, l2addr_len);
+        nb->l2addr_len = l2addr_len;
+    }
+    nb->last_used = ++table->clock;
+    table->pending = nb;
+}
+
+void netstats_nb_update_tx(netstats_nb_table_t *table, netstats_nb_tx_t res,
+                           unsigned retries)
+{
+    assert(table != NULL);
+    netstats_nb_t *nb = table->pending;
+
+    if (nb == NULL) {
+        return;
+    }
+    if (res == NETSTATS_NB_TX_BUSY) {
+        /* nothing was sent, so this says nothing about the link */
+        nb->tx_failed++;
+        return;
+    }
+
+    unsigned attempts = retries + 1;
+
+    nb->tx_count++;
+    if (res == NETSTATS_NB_TX_NOACK) {
+        nb->tx_failed++;
+        if (attempts < NETSTATS_NB_ETX_NOACK) {
+            attempts = NETSTATS_NB_ETX_NOACK;
+        }
+    }
+    if (attempts > (UINT16_MAX / NETSTATS_NB_ETX_DIVISOR)) {
+        attempts = UINT16_MAX / NETSTATS_NB_ETX_DIVISOR;
+    }
+
+    int32_t sample = attempts * NETSTATS_NB_ETX_DIVISOR;
+
+    if (nb->etx == 0) {
+        nb->etx = sample;
+    }
+    else {
+        nb->etx += (sample - (int32_t)nb->etx) / (1 << NETSTATS_NB_ETX_SHIFT);
+    }
+    DEBUG("netstats_nb: %u attempts, ETX now %u/%u\n", attempts,
+          (unsigned)nb->etx, NETSTATS_NB_ETX_DIVISOR);
+}
+
+const netstats_nb_t *netstats_nb_get(const netstats_nb_table_t *table,
+                                     const uint8_t *l2addr,
+                                     size_t l2addr_len)
+{
+    assert(table != NULL);
+    if ((l2addr_len == 0) || (l2addr_len > NETSTATS_NB_L2ADDR_MAXLEN)) {
+        return NULL;
+    }
+    return _find(table, l2addr, l2addr_len);
+}
+/** @} */
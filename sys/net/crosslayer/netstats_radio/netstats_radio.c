@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "net/netstats/radio.h"
+
+static const netstats_radio_power_t _power_default = NETSTATS_RADIO_POWER_DEFAULT;
+
+static const uint8_t _netopt_states[] = {
+    [NETOPT_STATE_OFF] = NETSTATS_RADIO_OFF,
+    [NETOPT_STATE_SLEEP] = NETSTATS_RADIO_SLEEP,
+    [NETOPT_STATE_IDLE] = NETSTATS_RADIO_LISTEN,
+    [NETOPT_STATE_RX] = NETSTATS_RADIO_RX,
+    [NETOPT_STATE_TX] = NETSTATS_RADIO_TX,
+    [NETOPT_STATE_RESET] = NETSTATS_RADIO_LISTEN,
+    [NETOPT_STATE_STANDBY] = NETSTATS_RADIO_STANDBY,
+};
+
+void netstats_radio_init(netstats_radio_t *stats,
+                         const netstats_radio_power_t *power, uint64_t now)
+{
+    assert(stats != NULL);
+    memset(stats, 0, sizeof(netstats_radio_t));
+    stats->power = (power != NULL) ? power : &_power_default;
+    stats->state = NETSTATS_RADIO_LISTEN;
+    stats->since = now;
+}
+
+void netstats_radio_update(netstats_radio_t *stats, uint64_t now)
+{
+    assert(stats != NULL);
+    stats->time[stats->state] += now - stats->since;
+    stats->since = now;
+}
+
+void netstats_radio_set(netstats_radio_t *stats, netstats_radio_state_t state,
+                        uint64_t now)
+{
+    assert(state < NETSTATS_RADIO_STATE_NUMOF);
+    if (state == stats->state) {
+        return;
+    }
+    netstats_radio_update(stats, now);
+    stats->state = state;
+    stats->transitions[state]++;
+}
+
+void netstats_radio_set_netopt(netstats_radio_t *stats, netopt_state_t state)
+{
+    if ((unsigned)state < (sizeof(_netopt_states) / sizeof(_netopt_states[0]))) {
+        netstats_radio_set(stats, _netopt_states[state], xtimer_now_usec64());
+    }
+}
+
+void netstats_radio_reset(netstats_radio_t *stats, uint64_t now)
+{
+    assert(stats != NULL);
+    memset(stats->time, 0, sizeof(stats->time));
+    memset(stats->transitions, 0, sizeof(stats->transitions));
+    stats->since = now;
+}
+
+static uint64_t _energy(const netstats_radio_t *stats, unsigned state)
+{
+    /* power in nW, time in ms, to not overflow within a few years */
+    uint64_t power = ((uint64_t)stats->power->current[state] *
+                      stats->power->voltage) / 1000U;
+
+    return ((stats->time[state] / US_PER_MS) * power) / 1000000U;
+}
+
+uint64_t netstats_radio_energy(const netstats_radio_t *stats,
+                               netstats_radio_state_t state)
+{
+    uint64_t res = 0;
+
+    assert(stats != NULL);
+    if (state < NETSTATS_RADIO_STATE_NUMOF) {
+        return _energy(stats, state);
+    }
+    for (unsigned i = 0; i < NETSTATS_RADIO_STATE_NUMOF; i++) {
+        res += _energy(stats, i);
+    }
+    return res;
+}
+
+unsigned netstats_radio_duty_cycle(const netstats_radio_t *stats)
+{
+    uint64_t total = 0;
+    uint64_t on;
+
+    assert(stats != NULL);
+    for (unsigned i = 0; i < NETSTATS_RADIO_STATE_NUMOF; i++) {
+        total += stats->time[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    on = stats->time[NETSTATS_RADIO_LISTEN] + stats->time[NETSTATS_RADIO_RX] +
+         stats->time[NETSTATS_RADIO_TX];
+    return (unsigned)((on * 10000U) / total);
+}
+
+/** @} */
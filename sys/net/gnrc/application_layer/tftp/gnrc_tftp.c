@@ -47,12 +47,14 @@ static kernel_pid_t _tftp_kernel_pid;
 #endif
 
 #define MIN(a, b)                   ((a) > (b) ? (b) : (a))
+#define MAX(a, b)                   ((a) > (b) ? (a) : (b))
 #define ARRAY_LEN(x)                (sizeof(x) / sizeof(x[0]))
 
 #define TFTP_TIMEOUT_MSG            0x4000
 #define TFTP_STOP_SERVER_MSG        0x4001
 #define TFTP_DEFAULT_DATA_SIZE      (GNRC_TFTP_MAX_TRANSFER_UNIT    \
                                      + sizeof(tftp_packet_data_t))
+#define TFTP_MIN_BLOCK_SIZE         (8)     /**< see RFC 2348 */
 
 /**
  * @brief TFTP mode help support
@@ -112,13 +114,15 @@ typedef enum {
     TOPT_BLKSIZE,
     TOPT_TIMEOUT,
     TOPT_TSIZE,
+    TOPT_WINDOWSIZE,
 } tftp_options_t;
 
 /* ordered as @see tftp_options_t */
 tftp_opt_t _tftp_options[] = {
-    [TOPT_BLKSIZE] = MODE(blksize),
-    [TOPT_TIMEOUT] = MODE(timeout),
-    [TOPT_TSIZE]   = MODE(tsize),
+    [TOPT_BLKSIZE]    = MODE(blksize),
+    [TOPT_TIMEOUT]    = MODE(timeout),
+    [TOPT_TSIZE]      = MODE(tsize),
+    [TOPT_WINDOWSIZE] = MODE(windowsize),
 };
 
 /**
@@ -168,6 +172,15 @@ typedef struct {
     bool use_options;
     bool enable_options;
     bool write_finished;
+
+    /* window parameters, see RFC 7440 */
+    uint16_t window_size;       /* negotiated window size [in blocks] */
+    uint16_t window;            /* sender: current, adaptive window size */
+    uint16_t block_acked;       /* sender: last acknowledged block */
+    uint16_t block_last;        /* sender: last block of the transfer, if sent */
+    uint16_t window_rx;         /* receiver: blocks received since last ACK */
+    bool window_opt;            /* the windowsize option is used */
+    bool dup_acked;             /* receiver: out of order block acknowledged */
 } tftp_context_t;
 
 /**
@@ -226,6 +239,9 @@ static tftp_state _tftp_send_start(tftp_context_t *ctxt, gnrc_pktsnip_t *buf);
 /* send data or and ack depending if we are reading or writing */
 static tftp_state _tftp_send_dack(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_opcodes_t op);
 
+/* send the window of data blocks following the last acknowledged block */
+static tftp_state _tftp_send_window(tftp_context_t *ctxt, gnrc_pktsnip_t *buf);
+
 /* send and TFTP error to the client */
 static tftp_state _tftp_send_error(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_err_codes_t err, const char *err_msg);
 
@@ -238,7 +254,7 @@ static int _tftp_decode_start(tftp_context_t *ctxt, uint8_t *buf, gnrc_pktsnip_t
 /* decode the TFTP option extensions */
 static int _tftp_decode_options(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, uint32_t start);
 
-/* decode the received ACK packet */
+/* decode the received ACK packet, checks if it acknowledges a block sent */
 static bool _tftp_validate_ack(tftp_context_t *ctxt, uint8_t *buf);
 
 /* processes the received data packet and calls the callback defined by the user */
@@ -250,6 +266,20 @@ static int _tftp_decode_error(uint8_t *buf, tftp_err_codes_t *err, const char *
 /* TFTP super loop server */
 static int _tftp_server(tftp_context_t *ctxt);
 
+/* check if we are sending the data of the transfer */
+static inline bool _tftp_is_sender(tftp_context_t *ctxt)
+{
+    return (ctxt->ct == CT_CLIENT) ? (ctxt->op == TO_WRQ) : (ctxt->op == TO_RRQ);
+}
+
+/* start the timer of the transfer */
+static void _tftp_set_timeout(tftp_context_t *ctxt, uint32_t timeout)
+{
+    ctxt->timer_msg.type = TFTP_TIMEOUT_MSG;
+    xtimer_set_msg(&(ctxt->timer), timeout, &(ctxt->timer_msg), thread_getpid());
+    DEBUG("tftp: set timeout %" PRIu32 " ms\n", timeout / US_PER_MS);
+}
+
 /* get the maximum allowed transfer unit to avoid 6Lo fragmentation */
 static uint16_t _tftp_get_maximum_block_size(void)
 {
@@ -363,6 +393,7 @@ int _tftp_init_ctxt(ipv6_addr_t *addr, const char *file_name,
     ctxt->block_size = GNRC_TFTP_MAX_TRANSFER_UNIT;
     ctxt->block_timeout = GNRC_TFTP_DEFAULT_TIMEOUT;
     ctxt->write_finished = false;
+    ctxt->window_size = 1;
 
     /* generate a random source UDP source port */
     do {
@@ -379,6 +410,8 @@ void _tftp_set_default_options(tftp_context_t *ctxt)
     ctxt->block_timeout = GNRC_TFTP_DEFAULT_TIMEOUT;
     ctxt->transfer_size = 0;
     ctxt->use_options = false;
+    ctxt->window_size = 1;
+    ctxt->window_opt = false;
 }
 
 int _tftp_set_opts(tftp_context_t *ctxt, size_t blksize, uint32_t timeout, size_t total_size)
@@ -392,6 +425,8 @@ int _tftp_set_opts(tftp_context_t *ctxt, size_t blksize, uint32_t timeout, size_
     ctxt->block_timeout = timeout;
     ctxt->transfer_size = total_size;
     ctxt->use_options = true;
+    ctxt->window_size = GNRC_TFTP_MAX_WINDOW_SIZE;
+    ctxt->window_opt = (GNRC_TFTP_MAX_WINDOW_SIZE > 1);
 
     return TS_FINISHED;
 }
@@ -584,11 +619,16 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             /* we are still negotiating resent, start */
             return _tftp_send_start(ctxt, outbuf);
         }
+        else if (_tftp_is_sender(ctxt)) {
+            DEBUG("tftp: window not acknowledged, resending\n");
+            /* back off, and resend the window from the last acknowledged block */
+            ctxt->window = MAX(1, ctxt->window / 2);
+            return _tftp_send_window(ctxt, outbuf);
+        }
         else {
-            DEBUG("tftp: last data or ack packet lost, resending\n");
-            /* we are sending / receiving data */
-            /* if we are reading resent the ACK, if writing the DATA */
-            return _tftp_send_dack(ctxt, outbuf, (ctxt->op == TO_RRQ) ? TO_ACK : TO_DATA);
+            DEBUG("tftp: window incomplete or ack packet lost, resending ACK\n");
+            ctxt->window_rx = 0;
+            return _tftp_send_dack(ctxt, outbuf, TO_ACK);
         }
     }
     else if (m->type != GNRC_NETAPI_MSG_TYPE_RCV) {
@@ -607,6 +647,15 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
     ipv6_hdr_t *ip = (ipv6_hdr_t *)tmp->data;
     uint8_t *data = (uint8_t *)pkt->data;
 
+    /* invalid or stale ACKs leave the timer running, so they can't postpone
+     * resending a window forever */
+    if ((_tftp_parse_type(data) == TO_ACK) && !_tftp_validate_ack(ctxt, data)) {
+        DEBUG("tftp: ACK of block %" PRIu16 " dropped\n",
+              byteorder_ntohs(((tftp_packet_data_t *)data)->block_nr));
+        gnrc_pktbuf_release(outbuf);
+        return TS_BUSY;
+    }
+
     xtimer_remove(&(ctxt->timer));
 
     switch (_tftp_parse_type(data)) {
@@ -660,7 +709,6 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
 
                 /* send the first data block */
                 if (ctxt->op == TO_RRQ) {
-                    ++(ctxt->block_nr);
                     opcode = TO_DATA;
                 }
                 else {
@@ -677,7 +725,12 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             }
 
             /* the client send the TFTP options */
-            state = _tftp_send_dack(ctxt, outbuf, opcode);
+            if (opcode == TO_DATA) {
+                state = _tftp_send_window(ctxt, outbuf);
+            }
+            else {
+                state = _tftp_send_dack(ctxt, outbuf, opcode);
+            }
 
             /* check if the client negotiation was successful */
             if (state != TS_BUSY) {
@@ -699,15 +752,24 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             }
 
             if (proc == TS_DUP) {
-                DEBUG("tftp: duplicated data received, acking...\n");
-                _tftp_send_dack(ctxt, outbuf, TO_ACK);
+                /* acknowledge the last block received in order right away
+                 * only once, so a resent window isn't answered block by block */
+                ctxt->window_rx = 0;
+                if (!ctxt->dup_acked) {
+                    DEBUG("tftp: block out of order received, acking...\n");
+                    ctxt->dup_acked = true;
+                    _tftp_send_dack(ctxt, outbuf, TO_ACK);
+                }
+                else {
+                    gnrc_pktbuf_release(outbuf);
+                    _tftp_set_timeout(ctxt, ctxt->timeout / 4);
+                }
                 return TS_BUSY;
             }
 
             /* check if this is the first block */
             if (!ctxt->block_nr
-                && ctxt->dst_port == GNRC_TFTP_DEFAULT_DST_PORT
-                && !ctxt->use_options) {
+                && ctxt->dst_port == GNRC_TFTP_DEFAULT_DST_PORT) {
                 /* no OACK received, restore default TFTP parameters */
                 _tftp_set_default_options(ctxt);
                 DEBUG("tftp: restore default TFTP parameters\n");
@@ -719,6 +781,18 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             /* wait for the next data block */
             DEBUG("tftp: wait for the next data block\n");
             ++(ctxt->block_nr);
+            ctxt->retries = 0;
+            ctxt->dup_acked = false;
+
+            /* acknowledge the last block of a window and of the transfer, but
+             * don't wait forever for the rest of a window the sender shrank */
+            if ((++(ctxt->window_rx) < ctxt->window_size) &&
+                (proc >= (int)ctxt->block_size)) {
+                gnrc_pktbuf_release(outbuf);
+                _tftp_set_timeout(ctxt, ctxt->timeout / 4);
+                return TS_BUSY;
+            }
+            ctxt->window_rx = 0;
             _tftp_send_dack(ctxt, outbuf, TO_ACK);
 
             /* check if the data transfer has finished */
@@ -737,15 +811,11 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
         break;
 
         case TO_ACK: {
-            /* validate if this is the ACK we are waiting for */
-            if (!_tftp_validate_ack(ctxt, data)) {
-                /* invalid packet ACK, drop */
-                gnrc_pktbuf_release(outbuf);
-                return TS_BUSY;
-            }
+            /* the ACK is validated above */
+            uint16_t block_nr = byteorder_ntohs(((tftp_packet_data_t *)data)->block_nr);
 
             /* check if the write action is finished */
-            if (ctxt->write_finished) {
+            if (ctxt->write_finished && (block_nr == ctxt->block_last)) {
                 gnrc_pktbuf_release(outbuf);
 
                 if (ctxt->stop_cb) {
@@ -764,10 +834,23 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
                 ctxt->dst_port = byteorder_ntohs(udp->src_port);
             }
 
-            /* send the next data block */
-            ++(ctxt->block_nr);
+            /* a window shrunk on a timeout doubles with every window that
+             * arrived completely, the receiver only acknowledges a shorter
+             * window after its own timeout */
+            if (block_nr == ctxt->block_nr) {
+                if (ctxt->window) {
+                    ctxt->window = MIN(ctxt->window * 2, ctxt->window_size);
+                }
+            }
+            else {
+                DEBUG("tftp: block %" PRIu16 " lost, resending\n",
+                      (uint16_t)(block_nr + 1));
+            }
+            ctxt->block_acked = block_nr;
+            ctxt->retries = 0;
 
-            return _tftp_send_dack(ctxt, outbuf, TO_DATA);
+            /* send the next window */
+            return _tftp_send_window(ctxt, outbuf);
         } break;
 
         case TO_ERROR: {
@@ -792,22 +875,25 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             if (ctxt->dst_port != byteorder_ntohs(udp->src_port)) {
                 DEBUG("tftp: TO_OACK received\n");
 
+                /* the server doesn't use a window, unless it tells so */
+                ctxt->window_size = 1;
+                ctxt->window_opt = false;
+
                 /* decode the options */
                 _tftp_decode_options(ctxt, pkt, 0);
 
                 /* take the new source port */
                 ctxt->dst_port = byteorder_ntohs(udp->src_port);
-
-                /* we must send block one to finish the negotiation in send mode */
-                if (ctxt->op == TO_WRQ) {
-                    ++(ctxt->block_nr);
-                }
             }
             else {
                 DEBUG("tftp: dropping double TO_OACK\n");
             }
 
-            return _tftp_send_dack(ctxt, outbuf, (ctxt->op == TO_WRQ) ? TO_DATA : TO_ACK);
+            /* we must send the first window to finish the negotiation in send mode */
+            if (ctxt->op == TO_WRQ) {
+                return _tftp_send_window(ctxt, outbuf);
+            }
+            return _tftp_send_dack(ctxt, outbuf, TO_ACK);
         } break;
     }
 
@@ -846,6 +932,10 @@ uint32_t _tftp_append_options(tftp_context_t *ctxt, tftp_header_t *hdr, uint32_t
         offset += _tftp_add_option(hdr->data + offset, _tftp_options + TOPT_TSIZE, ctxt->transfer_size);
     }
 
+    if (ctxt->window_opt) {
+        offset += _tftp_add_option(hdr->data + offset, _tftp_options + TOPT_WINDOWSIZE, ctxt->window_size);
+    }
+
     return offset;
 }
 
@@ -886,7 +976,14 @@ tftp_state _tftp_send_dack(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_opcod
     if (op == TO_DATA) {
         DEBUG("tftp: getting data from callback\n");
         /* get the required data from the user */
-        len = ctxt->data_cb(ctxt->block_size * (ctxt->block_nr - 1), pkt->data, ctxt->block_size);
+        int res = ctxt->data_cb(ctxt->block_size * (ctxt->block_nr - 1),
+                                pkt->data, ctxt->block_size);
+        if (res < 0) {
+            DEBUG("tftp: error in data callback\n");
+            _tftp_send_error(ctxt, buf, TE_UN_DEF, "Read failed");
+            return TS_APP_FAILED;
+        }
+        len = res;
 
         /* check if we are finished on ACK receive */
         ctxt->write_finished = (len < ctxt->block_size);
@@ -910,6 +1007,44 @@ tftp_state _tftp_send_dack(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_opcod
     return _tftp_send(buf, ctxt, sizeof(tftp_packet_data_t) + len);
 }
 
+tftp_state _tftp_send_window(tftp_context_t *ctxt, gnrc_pktsnip_t *buf)
+{
+    if ((ctxt->window == 0) || (ctxt->window > ctxt->window_size)) {
+        ctxt->window = ctxt->window_size;
+    }
+
+    /* go back to the block following the last acknowledged one */
+    for (unsigned i = 1; i <= ctxt->window; i++) {
+        ctxt->block_nr = ctxt->block_acked + i;
+
+        if (buf == NULL) {
+            buf = gnrc_pktbuf_add(NULL, NULL, TFTP_DEFAULT_DATA_SIZE,
+                                  GNRC_NETTYPE_UNDEF);
+            if (buf == NULL) {
+                DEBUG("tftp: unable to allocate block %" PRIu16 "\n",
+                      ctxt->block_nr);
+                /* the timeout resends the window */
+                break;
+            }
+        }
+
+        tftp_state state = _tftp_send_dack(ctxt, buf, TO_DATA);
+        buf = NULL;
+        if (state != TS_BUSY) {
+            return state;
+        }
+        if (ctxt->write_finished) {
+            ctxt->block_last = ctxt->block_nr;
+            break;
+        }
+    }
+
+    if (buf != NULL) {
+        gnrc_pktbuf_release(buf);
+    }
+    return TS_BUSY;
+}
+
 tftp_state _tftp_send_error(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_err_codes_t err, const char *err_msg)
 {
     int strl = err_msg ? strlen(err_msg) + 1 : 0;
@@ -1007,9 +1142,7 @@ tftp_state _tftp_send(gnrc_pktsnip_t *buf, tftp_context_t *ctxt, size_t len)
 
     /* only set timeout if enabled for this block */
     if (ctxt->block_timeout) {
-        ctxt->timer_msg.type = TFTP_TIMEOUT_MSG;
-        xtimer_set_msg(&(ctxt->timer), ctxt->block_timeout, &(ctxt->timer_msg), thread_getpid());
-        DEBUG("tftp: set timeout %" PRIu32 " ms\n", ctxt->block_timeout / US_PER_MS);
+        _tftp_set_timeout(ctxt, ctxt->block_timeout);
     }
 
     return TS_BUSY;
@@ -1018,8 +1151,18 @@ tftp_state _tftp_send(gnrc_pktsnip_t *buf, tftp_context_t *ctxt, size_t len)
 bool _tftp_validate_ack(tftp_context_t *ctxt, uint8_t *buf)
 {
     tftp_packet_data_t *pkt = (tftp_packet_data_t *) buf;
+    uint16_t block_nr = byteorder_ntohs(pkt->block_nr);
 
-    return ctxt->block_nr == byteorder_ntohs(pkt->block_nr);
+    /* a repeated ACK of the last acknowledged block is stale, resending on it
+     * would double every following block (RFC 1123, 4.2.3.1), unless it
+     * acknowledges the start of the transfer */
+    if ((block_nr == ctxt->block_acked) && (ctxt->block_nr != ctxt->block_acked)) {
+        return false;
+    }
+
+    /* any block following the last acknowledged one up to the last one sent */
+    return (uint16_t)(block_nr - ctxt->block_acked) <=
+           (uint16_t)(ctxt->block_nr - ctxt->block_acked);
 }
 
 int _tftp_decode_start(tftp_context_t *ctxt, uint8_t *buf, gnrc_pktsnip_t *outbuf)
@@ -1078,7 +1221,9 @@ int _tftp_decode_options(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, uint32_t sta
                 /* set the option value of the known options */
                 switch (idx) {
                     case TOPT_BLKSIZE:
-                        ctxt->block_size = atoi(value);
+                        /* don't let the peer overflow our buffers */
+                        ctxt->block_size = MAX(TFTP_MIN_BLOCK_SIZE,
+                                               MIN(atoi(value), GNRC_TFTP_MAX_TRANSFER_UNIT));
                         DEBUG("tftp: got option TOPT_BLKSIZE = %" PRIu16 "\n", ctxt->block_size);
                         break;
 
@@ -1095,6 +1240,15 @@ int _tftp_decode_options(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, uint32_t sta
                         ctxt->timeout = atoi(value) * US_PER_SEC;
                         DEBUG("tftp: option TOPT_TIMEOUT = %" PRIu32 " ms\n", ctxt->timeout / US_PER_MS);
                         break;
+
+                    case TOPT_WINDOWSIZE:
+                        /* the server may only make the client's window smaller */
+                        if (atoi(value) > 0) {
+                            ctxt->window_size = MIN(atoi(value), GNRC_TFTP_MAX_WINDOW_SIZE);
+                            ctxt->window_opt = true;
+                        }
+                        DEBUG("tftp: got option TOPT_WINDOWSIZE = %" PRIu16 "\n", ctxt->window_size);
+                        break;
                 }
 
                 break;
@@ -1114,13 +1268,9 @@ int _tftp_process_data(tftp_context_t *ctxt, gnrc_pktsnip_t *buf)
 
     uint16_t block_nr = byteorder_ntohs(pkt->block_nr);
 
-    /* check if this is the packet we are waiting for */
-    if (block_nr > (ctxt->block_nr + 1)) {
-        DEBUG("tftp: incorrect block_nr %d received from server, expected %d\n",
-               block_nr, (ctxt->block_nr + 1));
-        return TS_FAILED;
-    }
-    if (block_nr < (ctxt->block_nr + 1)) {
+    /* check if this is the packet we are waiting for, a block of a window
+     * following a lost one is out of order as well */
+    if (block_nr != (uint16_t)(ctxt->block_nr + 1)) {
         DEBUG("tftp: not the packet we were waiting for, expected %d, received %d\n",
               (uint16_t)(ctxt->block_nr + 1), block_nr);
         return TS_DUP;
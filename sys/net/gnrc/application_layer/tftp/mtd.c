@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include "net/gnrc/tftp/mtd.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define MIN(a, b)       ((a) > (b) ? (b) : (a))
+
+/* the callbacks of gnrc_tftp have no context, so there is one region only */
+static mtd_dev_t *_dev;
+static uint32_t _addr;
+static uint32_t _size;
+static uint32_t _erased;    /* end of the erased part of the region */
+static bool _write;
+
+void gnrc_tftp_mtd_set(mtd_dev_t *dev, uint32_t addr, uint32_t size,
+                       bool write)
+{
+    assert(!write ||
+           ((addr % (dev->pages_per_sector * dev->page_size)) == 0));
+    _dev = dev;
+    _addr = addr;
+    _size = size;
+    _erased = addr;
+    _write = write;
+}
+
+static int _write_block(uint32_t addr, const uint8_t *data, size_t len)
+{
+    uint32_t sector_size = _dev->pages_per_sector * _dev->page_size;
+
+    while (len) {
+        /* erase the sectors the first time they are written to */
+        if (addr + len > _erased) {
+            DEBUG("tftp_mtd: erase sector at 0x%" PRIx32 "\n", _erased);
+            int res = mtd_erase(_dev, _erased, sector_size);
+            if (res < 0) {
+                return res;
+            }
+            _erased += sector_size;
+            continue;
+        }
+
+        /* writes must not cross a page */
+        size_t chunk = MIN(len, _dev->page_size - (addr % _dev->page_size));
+        int res = mtd_write(_dev, data, addr, chunk);
+        if (res < 0) {
+            return res;
+        }
+        addr += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+int gnrc_tftp_mtd_data_cb(uint32_t offset, void *data, size_t data_len)
+{
+    int res;
+
+    if (_dev == NULL) {
+        return -ENODEV;
+    }
+    if (offset >= _size) {
+        /* sending: end of the transfer, receiving: the region is full,
+         * unless this is the empty last block of a transfer filling it */
+        return (_write && (data_len > 0)) ? -ENOSPC : 0;
+    }
+    if (_write) {
+        if (data_len > (_size - offset)) {
+            return -ENOSPC;
+        }
+        res = _write_block(_addr + offset, data, data_len);
+        return (res < 0) ? res : (int)data_len;
+    }
+    data_len = MIN(data_len, _size - offset);
+    res = mtd_read(_dev, data, _addr + offset, data_len);
+    return (res < 0) ? res : (int)data_len;
+}
+
+/** @} */
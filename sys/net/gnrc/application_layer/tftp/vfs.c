@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser General
+ * Public License v2.1. See the file LICENSE in the top level directory for
+ * more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+
+#include "vfs.h"
+#include "net/gnrc/tftp/vfs.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* the callbacks of gnrc_tftp have no context, so there is one file only */
+static int _fd = -1;
+static bool _write;
+
+int gnrc_tftp_vfs_open(const char *path, int flags, size_t *size)
+{
+    struct stat st;
+    int res;
+
+    if (_fd >= 0) {
+        return -EBUSY;
+    }
+    res = vfs_open(path, flags, 0);
+    if (res < 0) {
+        DEBUG("tftp_vfs: unable to open %s (%d)\n", path, res);
+        return res;
+    }
+    _fd = res;
+    _write = ((flags & O_ACCMODE) != O_RDONLY);
+    if (size) {
+        *size = (vfs_fstat(_fd, &st) == 0) ? (size_t)st.st_size : 0;
+    }
+    return 0;
+}
+
+int gnrc_tftp_vfs_data_cb(uint32_t offset, void *data, size_t data_len)
+{
+    if (_fd < 0) {
+        return -EBADF;
+    }
+    /* blocks may be requested again on retransmission */
+    if (vfs_lseek(_fd, offset, SEEK_SET) < 0) {
+        return -EIO;
+    }
+    if (_write) {
+        return vfs_write(_fd, data, data_len);
+    }
+    return vfs_read(_fd, data, data_len);
+}
+
+void gnrc_tftp_vfs_close(void)
+{
+    if (_fd >= 0) {
+        vfs_close(_fd);
+        _fd = -1;
+    }
+}
+
+/** @} */
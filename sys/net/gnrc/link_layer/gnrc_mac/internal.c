@@ -116,6 +116,11 @@ void _gnrc_mac_init_neighbor(gnrc_mac_tx_neighbor_t *neighbor, const uint8_t *ad
 
     neighbor->l2_addr_len = len;
     neighbor->phase = GNRC_MAC_PHASE_MAX;
+#ifdef MODULE_GNRC_LWMAC
+    neighbor->phase_sync = 0;
+    neighbor->phase_drift = 0;
+    neighbor->phase_misses = 0;
+#endif
     memcpy(&(neighbor->l2_addr), addr, len);
 }
 #endif /* GNRC_MAC_NEIGHBOR_COUNT != 0 */
@@ -212,6 +217,25 @@ bool gnrc_mac_queue_tx_packet(gnrc_mac_tx_t *tx, uint32_t priority, gnrc_pktsnip
 
 #endif  /* GNRC_MAC_NEIGHBOR_COUNT == 0 */
 }
+
+#if GNRC_MAC_NEIGHBOR_COUNT != 0
+bool gnrc_mac_tx_burst_pending(gnrc_mac_tx_t *tx, unsigned limit)
+{
+    assert(tx != NULL);
+    assert(tx->current_neighbor != NULL);
+
+    /* Every receiver wakes up for itself, so broadcasts are never bursted */
+    if ((tx->current_neighbor == &tx->neighbors[0]) ||
+        (gnrc_priority_pktqueue_length(&tx->current_neighbor->queue) == 0) ||
+        (tx->burst_count >= limit)) {
+        return false;
+    }
+
+    tx->burst_count++;
+    DEBUG("[gnrc_mac-int] Frame %u of burst pending\n", tx->burst_count);
+    return true;
+}
+#endif /* GNRC_MAC_NEIGHBOR_COUNT != 0 */
 #endif  /* GNRC_MAC_TX_QUEUE_SIZE != 0 */
 
 #if GNRC_MAC_RX_QUEUE_SIZE != 0
@@ -2033,11 +2033,17 @@ static void _gomach_event_cb(netdev_t *dev, netdev_event_t event)
         switch (event) {
             case NETDEV_EVENT_RX_STARTED: {
                 gnrc_netif_set_rx_started(netif, true);
+#ifdef MODULE_NETSTATS_RADIO
+                gnrc_gomach_radio_stats_set(netif, NETOPT_STATE_RX);
+#endif
                 gnrc_gomach_set_update(netif, true);
                 break;
             }
             case NETDEV_EVENT_RX_COMPLETE: {
                 gnrc_gomach_set_update(netif, true);
+#ifdef MODULE_NETSTATS_RADIO
+                gnrc_gomach_radio_stats_set(netif, NETOPT_STATE_IDLE);
+#endif
 
                 gnrc_pktsnip_t *pkt = netif->ops->recv(netif);
                 if (pkt == NULL) {
@@ -2091,6 +2097,12 @@ static void _gomach_event_cb(netdev_t *dev, netdev_event_t event)
                 gnrc_gomach_set_update(netif, true);
                 break;
             }
+#ifdef MODULE_NETSTATS_RADIO
+            case NETDEV_EVENT_TX_STARTED: {
+                gnrc_gomach_radio_stats_set(netif, NETOPT_STATE_TX);
+                break;
+            }
+#endif
             default: {
                 DEBUG("WARNING [GoMacH]: unhandled event %u.\n", event);
             }
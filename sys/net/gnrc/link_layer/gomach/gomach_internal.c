@@ -31,6 +31,7 @@
 #include "net/gnrc/gomach/types.h"
 #include "include/gomach_internal.h"
 #include "net/gnrc/netif/ieee802154.h"
+#include "net/gnrc/netif/internal.h"
 #include "net/netdev/ieee802154.h"
 
 #define ENABLE_DEBUG    (0)
@@ -294,6 +295,15 @@ uint64_t gnrc_gomach_phase_now(gnrc_netif_t *netif)
     return phase_now;
 }
 
+#ifdef MODULE_NETSTATS_RADIO
+void gnrc_gomach_radio_stats_set(gnrc_netif_t *netif, netopt_state_t devstate)
+{
+    gnrc_netif_acquire(netif);
+    netstats_radio_set_netopt(&netif->radio_stats, devstate);
+    gnrc_netif_release(netif);
+}
+#endif
+
 void gnrc_gomach_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate)
 {
     assert(netif != NULL);
@@ -302,6 +312,9 @@ void gnrc_gomach_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate)
                             NETOPT_STATE,
                             &devstate,
                             sizeof(devstate));
+#ifdef MODULE_NETSTATS_RADIO
+    gnrc_gomach_radio_stats_set(netif, devstate);
+#endif
 
 #if (GNRC_GOMACH_ENABLE_DUTYCYLE_RECORD == 1)
     if (devstate == NETOPT_STATE_IDLE) {
@@ -626,6 +626,19 @@ uint64_t gnrc_gomach_phase_now(gnrc_netif_t *netif);
  */
 void gnrc_gomach_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate);
 
+#if defined(MODULE_NETSTATS_RADIO) || defined(DOXYGEN)
+/**
+ * @brief Account a state change of the radio in the interface's statistics
+ *
+ * The statistics are also read by other threads, so this takes the lock of
+ * @p netif.
+ *
+ * @param[in]   netif       ptr to the network interface
+ * @param[in]   devstate    new state for netdev
+ */
+void gnrc_gomach_radio_stats_set(gnrc_netif_t *netif, netopt_state_t devstate);
+#endif
+
 /**
  * @brief Set the auto-ACK parameter of the device.
  *
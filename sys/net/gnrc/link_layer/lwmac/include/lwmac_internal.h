@@ -21,6 +21,7 @@
 #ifndef LWMAC_INTERNAL_H
 #define LWMAC_INTERNAL_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "periph/rtt.h"
@@ -331,6 +332,19 @@ netopt_state_t _gnrc_lwmac_get_netdev_state(gnrc_netif_t *netif);
  */
 void _gnrc_lwmac_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate);
 
+#if defined(MODULE_NETSTATS_RADIO) || defined(DOXYGEN)
+/**
+ * @brief Account a state change of the radio in the interface's statistics
+ *
+ * The statistics are also read by other threads, so this takes the lock of
+ * @p netif.
+ *
+ * @param[in]   netif       ptr to the network interface
+ * @param[in]   devstate    new state for netdev
+ */
+void _gnrc_lwmac_radio_stats_set(gnrc_netif_t *netif, netopt_state_t devstate);
+#endif
+
 /**
  * @brief Convert RTT ticks to device phase
  *
@@ -374,6 +388,86 @@ static inline uint32_t _gnrc_lwmac_ticks_until_phase(uint32_t phase)
     return (uint32_t)tmp;
 }
 
+/**
+ * @brief Fixed-point scale of gnrc_mac_tx_neighbor_t::phase_drift
+ */
+#define GNRC_LWMAC_PHASE_DRIFT_SCALE    (256)
+
+/**
+ * @brief Check if the wake-up phase of a neighbor is known
+ *
+ * @param[in]   neighbor    the neighbor
+ *
+ * @return                  true, if the phase of @p neighbor is known
+ */
+static inline bool _gnrc_lwmac_phase_known(const gnrc_mac_tx_neighbor_t *neighbor)
+{
+    return (neighbor->phase < RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US));
+}
+
+/**
+ * @brief Predict the current wake-up phase of a phase-locked neighbor
+ *
+ * The phase learned from the last WA of @p neighbor is corrected by its
+ * phase drift over the time passed since.
+ *
+ * @pre `_gnrc_lwmac_phase_known(neighbor)`
+ *
+ * @param[in]   neighbor    the neighbor
+ * @param[in]   now         current RTT ticks
+ *
+ * @return                  the predicted phase of @p neighbor
+ */
+uint32_t _gnrc_lwmac_neighbor_phase(const gnrc_mac_tx_neighbor_t *neighbor,
+                                    uint32_t now);
+
+/**
+ * @brief Get the uncertainty of the predicted phase of a neighbor
+ *
+ * @see @ref GNRC_LWMAC_PHASE_GUARD_PPM
+ *
+ * @param[in]   neighbor    the neighbor
+ * @param[in]   now         current RTT ticks
+ *
+ * @return                  guard time in RTT ticks
+ */
+uint32_t _gnrc_lwmac_phase_guard(const gnrc_mac_tx_neighbor_t *neighbor,
+                                 uint32_t now);
+
+/**
+ * @brief Check if the phase of a neighbor is too uncertain to be used
+ *
+ * @param[in]   neighbor    the neighbor
+ * @param[in]   now         current RTT ticks
+ *
+ * @return                  true, if the guard time of @p neighbor exceeds
+ *                          half the wake-up interval
+ */
+bool _gnrc_lwmac_phase_outdated(const gnrc_mac_tx_neighbor_t *neighbor,
+                                uint32_t now);
+
+/**
+ * @brief Learn the wake-up phase of a neighbor from its WA
+ *
+ * Updates the phase drift of @p neighbor in case its phase was already known.
+ *
+ * @param[in,out]   neighbor    the neighbor
+ * @param[in]       phase       phase of @p neighbor derived from its WA
+ * @param[in]       now         current RTT ticks
+ */
+void _gnrc_lwmac_phase_learn(gnrc_mac_tx_neighbor_t *neighbor, uint32_t phase,
+                             uint32_t now);
+
+/**
+ * @brief Account a phase-locked transmission attempt not answered by a WA
+ *
+ * Drops the phase of @p neighbor after @ref GNRC_LWMAC_PHASE_MAX_MISSES
+ * consecutive misses.
+ *
+ * @param[in,out]   neighbor    the neighbor
+ */
+void _gnrc_lwmac_phase_missed(gnrc_mac_tx_neighbor_t *neighbor);
+
 /**
  * @brief Store the received packet to the dispatch buffer and remove possible
  *        duplicate packets.
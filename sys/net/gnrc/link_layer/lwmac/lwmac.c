@@ -206,7 +206,12 @@ static gnrc_mac_tx_neighbor_t *_next_tx_neighbor(gnrc_netif_t *netif)
             /* Unknown destinations are initialized with their phase at the end
              * of the local interval, so known destinations that still wakeup
              * in this interval will be preferred. */
-            uint32_t phase_check = _gnrc_lwmac_ticks_until_phase(netif->mac.tx.neighbors[i].phase);
+            uint32_t phase_check = GNRC_LWMAC_PHASE_MAX;
+            if (_gnrc_lwmac_phase_known(&netif->mac.tx.neighbors[i])) {
+                phase_check = _gnrc_lwmac_ticks_until_phase(
+                    _gnrc_lwmac_neighbor_phase(&netif->mac.tx.neighbors[i],
+                                               rtt_get_counter()));
+            }
 
             if (phase_check <= phase_nearest) {
                 next = &(netif->mac.tx.neighbors[i]);
@@ -380,25 +385,40 @@ static void _sleep_management(gnrc_netif_t *netif)
         }
 
         if (neighbour != NULL) {
+            uint32_t now = rtt_get_counter();
+            uint32_t guard = 0;
+
+            if (_gnrc_lwmac_phase_known(neighbour)) {
+                /* the phase is too old to be of any use anymore */
+                if (_gnrc_lwmac_phase_outdated(neighbour, now)) {
+                    neighbour->phase = GNRC_MAC_PHASE_MAX;
+                }
+                else {
+                    guard = RTT_TICKS_TO_US(_gnrc_lwmac_phase_guard(neighbour, now));
+                }
+            }
+
             /* if phase is unknown, send immediately. */
-            if (neighbour->phase > RTT_TICKS_TO_US(GNRC_LWMAC_WAKEUP_INTERVAL_US)) {
+            if (!_gnrc_lwmac_phase_known(neighbour)) {
                 netif->mac.tx.current_neighbor = neighbour;
                 gnrc_lwmac_set_tx_continue(netif, false);
-                netif->mac.tx.tx_burst_count = 0;
+                gnrc_mac_tx_burst_start(&netif->mac.tx);
                 lwmac_set_state(netif, GNRC_LWMAC_TRANSMITTING);
                 return;
             }
 
             /* Offset in microseconds when the earliest (phase) destination
              * node wakes up that we have packets for. */
-            uint32_t time_until_tx = RTT_TICKS_TO_US(_gnrc_lwmac_ticks_until_phase(neighbour->phase));
+            uint32_t time_until_tx = RTT_TICKS_TO_US(_gnrc_lwmac_ticks_until_phase(
+                                                         _gnrc_lwmac_neighbor_phase(neighbour, now)));
 
-            /* If there's not enough time to prepare a WR to catch the phase
-             * postpone to next interval */
-            if (time_until_tx < GNRC_LWMAC_WR_PREPARATION_US) {
+            /* If there's not enough time to prepare a WR to catch the phase,
+             * including the uncertainty of the phase, postpone to next interval */
+            guard += GNRC_LWMAC_WR_PREPARATION_US;
+            if (time_until_tx < guard) {
                 time_until_tx += GNRC_LWMAC_WAKEUP_INTERVAL_US;
             }
-            time_until_tx -= GNRC_LWMAC_WR_PREPARATION_US;
+            time_until_tx -= guard;
 
             /* add a random time before goto TX, for avoiding one node for
              * always holding the medium (if the receiver's phase is recorded earlier in this
@@ -422,7 +442,7 @@ static void _sleep_management(gnrc_netif_t *netif)
     else if (gnrc_lwmac_timeout_is_expired(netif, GNRC_LWMAC_TIMEOUT_WAIT_DEST_WAKEUP)) {
         LOG_DEBUG("[LWMAC] Got timeout for dest wakeup, ticks: %" PRIu32 "\n", rtt_get_counter());
         gnrc_lwmac_set_tx_continue(netif, false);
-        netif->mac.tx.tx_burst_count = 0;
+        gnrc_mac_tx_burst_start(&netif->mac.tx);
         lwmac_set_state(netif, GNRC_LWMAC_TRANSMITTING);
     }
 }
@@ -433,6 +453,8 @@ static void _rx_management_failed(gnrc_netif_t *netif)
      * every node in range. */
     LOG_DEBUG("[LWMAC] Reception was NOT successful\n");
     gnrc_lwmac_rx_stop(netif);
+    /* The sender gave up its burst */
+    gnrc_mac_rx_set_burst(&netif->mac.rx, false);
 
     if (netif->mac.rx.rx_bad_exten_count >= GNRC_LWMAC_MAX_RX_EXTENSION_NUM) {
         gnrc_lwmac_set_quit_rx(netif, true);
@@ -479,8 +501,10 @@ static void _rx_management_success(gnrc_netif_t *netif)
     else {
         phase = phase - netif->mac.prot.lwmac.last_wakeup;
     }
-    /* If the relative phase is beyond 4/5 cycle time, go to sleep. */
-    if (phase > (4 * RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US) / 5)) {
+    /* If the relative phase is beyond 4/5 cycle time, go to sleep, unless the
+     * sender announced another packet of its burst. */
+    if ((phase > (4 * RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US) / 5)) &&
+        !gnrc_mac_rx_get_burst(&netif->mac.rx)) {
         gnrc_lwmac_set_quit_rx(netif, true);
     }
 
@@ -556,10 +580,9 @@ static void _tx_management_success(gnrc_netif_t *netif)
 
     gnrc_lwmac_tx_stop(netif);
 
-    /* In case have pending packets for the same receiver, continue to
-     * send immediately, before the maximum transmit-limit */
-    if ((gnrc_lwmac_get_tx_continue(netif)) &&
-        (netif->mac.tx.tx_burst_count < GNRC_LWMAC_MAX_TX_BURST_PKT_NUM)) {
+    /* In case the last packet announced another one of the burst, i.e., the
+     * maximum transmit-limit was not yet reached, continue to send immediately */
+    if (gnrc_lwmac_get_tx_continue(netif)) {
         lwmac_schedule_update(netif);
     }
     else {
@@ -773,10 +796,16 @@ static void _lwmac_event_cb(netdev_t *dev, netdev_event_t event)
             case NETDEV_EVENT_RX_STARTED: {
                 LOG_DEBUG("[LWMAC] NETDEV_EVENT_RX_STARTED\n");
                 gnrc_netif_set_rx_started(netif, true);
+#ifdef MODULE_NETSTATS_RADIO
+                _gnrc_lwmac_radio_stats_set(netif, NETOPT_STATE_RX);
+#endif
                 break;
             }
             case NETDEV_EVENT_RX_COMPLETE: {
                 LOG_DEBUG("[LWMAC] NETDEV_EVENT_RX_COMPLETE\n");
+#ifdef MODULE_NETSTATS_RADIO
+                _gnrc_lwmac_radio_stats_set(netif, NETOPT_STATE_IDLE);
+#endif
                 gnrc_pktsnip_t *pkt = netif->ops->recv(netif);
 
                 /* Prevent packet corruption when a packet is sent before the previous
@@ -808,23 +837,35 @@ static void _lwmac_event_cb(netdev_t *dev, netdev_event_t event)
             case NETDEV_EVENT_TX_STARTED: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_UNDEF);
                 gnrc_netif_set_rx_started(netif, false);
+#ifdef MODULE_NETSTATS_RADIO
+                _gnrc_lwmac_radio_stats_set(netif, NETOPT_STATE_TX);
+#endif
                 break;
             }
             case NETDEV_EVENT_TX_COMPLETE: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_SUCCESS);
                 gnrc_netif_set_rx_started(netif, false);
+#ifdef MODULE_NETSTATS_RADIO
+                _gnrc_lwmac_radio_stats_set(netif, NETOPT_STATE_IDLE);
+#endif
                 lwmac_schedule_update(netif);
                 break;
             }
             case NETDEV_EVENT_TX_NOACK: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_NOACK);
                 gnrc_netif_set_rx_started(netif, false);
+#ifdef MODULE_NETSTATS_RADIO
+                _gnrc_lwmac_radio_stats_set(netif, NETOPT_STATE_IDLE);
+#endif
                 lwmac_schedule_update(netif);
                 break;
             }
             case NETDEV_EVENT_TX_MEDIUM_BUSY: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_BUSY);
                 gnrc_netif_set_rx_started(netif, false);
+#ifdef MODULE_NETSTATS_RADIO
+                _gnrc_lwmac_radio_stats_set(netif, NETOPT_STATE_IDLE);
+#endif
                 lwmac_schedule_update(netif);
                 break;
             }
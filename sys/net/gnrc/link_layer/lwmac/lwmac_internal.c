@@ -20,6 +20,7 @@
  */
 
 #include <stdbool.h>
+#include <inttypes.h>
 
 #include "periph/rtt.h"
 #include "net/gnrc.h"
@@ -27,6 +28,7 @@
 #include "net/gnrc/lwmac/lwmac.h"
 #include "include/lwmac_internal.h"
 #include "net/gnrc/netif/ieee802154.h"
+#include "net/gnrc/netif/internal.h"
 #include "net/netdev/ieee802154.h"
 
 #define ENABLE_DEBUG    (0)
@@ -190,6 +192,9 @@ void _gnrc_lwmac_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate)
                             NETOPT_STATE,
                             &devstate,
                             sizeof(devstate));
+#ifdef MODULE_NETSTATS_RADIO
+    _gnrc_lwmac_radio_stats_set(netif, devstate);
+#endif
 
 #if (GNRC_LWMAC_ENABLE_DUTYCYLE_RECORD == 1)
     if (devstate == NETOPT_STATE_IDLE) {
@@ -212,6 +217,15 @@ void _gnrc_lwmac_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate)
 #endif
 }
 
+#ifdef MODULE_NETSTATS_RADIO
+void _gnrc_lwmac_radio_stats_set(gnrc_netif_t *netif, netopt_state_t devstate)
+{
+    gnrc_netif_acquire(netif);
+    netstats_radio_set_netopt(&netif->radio_stats, devstate);
+    gnrc_netif_release(netif);
+}
+#endif
+
 netopt_state_t _gnrc_lwmac_get_netdev_state(gnrc_netif_t *netif)
 {
     netopt_state_t state;
@@ -225,6 +239,92 @@ netopt_state_t _gnrc_lwmac_get_netdev_state(gnrc_netif_t *netif)
     return -1;
 }
 
+uint32_t _gnrc_lwmac_neighbor_phase(const gnrc_mac_tx_neighbor_t *neighbor,
+                                    uint32_t now)
+{
+    assert(_gnrc_lwmac_phase_known(neighbor));
+
+    const int64_t interval = RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US);
+    int64_t phase = neighbor->phase;
+
+    /* Correct the learned phase by the drift accumulated since */
+    phase += ((int64_t)neighbor->phase_drift * (now - neighbor->phase_sync)) /
+             (interval * GNRC_LWMAC_PHASE_DRIFT_SCALE);
+    phase %= interval;
+    if (phase < 0) {
+        phase += interval;
+    }
+    return (uint32_t)phase;
+}
+
+uint32_t _gnrc_lwmac_phase_guard(const gnrc_mac_tx_neighbor_t *neighbor,
+                                 uint32_t now)
+{
+    return (uint32_t)(((uint64_t)(now - neighbor->phase_sync) *
+                       GNRC_LWMAC_PHASE_GUARD_PPM) / US_PER_SEC);
+}
+
+bool _gnrc_lwmac_phase_outdated(const gnrc_mac_tx_neighbor_t *neighbor,
+                                uint32_t now)
+{
+    /* the WR stream would cover the whole interval */
+    return (_gnrc_lwmac_phase_guard(neighbor, now) >
+            (RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US) / 2));
+}
+
+void _gnrc_lwmac_phase_learn(gnrc_mac_tx_neighbor_t *neighbor, uint32_t phase,
+                             uint32_t now)
+{
+    const int32_t interval = RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US);
+    uint32_t intervals = (now - neighbor->phase_sync) / interval;
+
+    /* Within a burst the phase is refreshed before any drift is measurable */
+    if (_gnrc_lwmac_phase_known(neighbor) && (intervals > 0)) {
+        int32_t offset = phase - _gnrc_lwmac_neighbor_phase(neighbor, now);
+        int32_t max_offset = RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_DURATION_US) +
+                             _gnrc_lwmac_phase_guard(neighbor, now);
+
+        /* Take the shorter way around the interval */
+        if (offset > (interval / 2)) {
+            offset -= interval;
+        }
+        else if (offset < -(interval / 2)) {
+            offset += interval;
+        }
+
+        if ((offset > max_offset) || (offset < -max_offset)) {
+            /* Receiver has reselected its phase, the drift is meaningless */
+            DEBUG("[LWMAC-int] phase jumped by %" PRIi32 " ticks\n", offset);
+            neighbor->phase_drift = 0;
+        }
+        else {
+            /* The offset is what the current drift estimate missed */
+            int32_t sample = neighbor->phase_drift +
+                             ((int64_t)offset * GNRC_LWMAC_PHASE_DRIFT_SCALE) /
+                             (int64_t)intervals;
+            neighbor->phase_drift += (sample - neighbor->phase_drift) /
+                                     (int32_t)GNRC_LWMAC_PHASE_DRIFT_WEIGHT;
+            DEBUG("[LWMAC-int] phase off by %" PRIi32 " ticks, drift %" PRIi32
+                  "/%u ticks per interval\n", offset, neighbor->phase_drift,
+                  GNRC_LWMAC_PHASE_DRIFT_SCALE);
+        }
+    }
+
+    neighbor->phase = phase;
+    neighbor->phase_sync = now;
+    neighbor->phase_misses = 0;
+}
+
+void _gnrc_lwmac_phase_missed(gnrc_mac_tx_neighbor_t *neighbor)
+{
+    if (++neighbor->phase_misses >= GNRC_LWMAC_PHASE_MAX_MISSES) {
+        DEBUG("[LWMAC-int] Phase lost, relearn it\n");
+        neighbor->phase = GNRC_MAC_PHASE_MAX;
+        neighbor->phase_drift = 0;
+        neighbor->phase_misses = 0;
+    }
+}
+
 int _gnrc_lwmac_dispatch_defer(gnrc_pktsnip_t *buffer[], gnrc_pktsnip_t *pkt)
 {
     assert(buffer != NULL);
@@ -261,6 +261,8 @@ static uint8_t _packet_process_in_wait_for_data(gnrc_netif_t *netif)
             case GNRC_LWMAC_FRAMETYPE_DATA:
             case GNRC_LWMAC_FRAMETYPE_DATA_PENDING: {
                 /* Receiver gets the data packet */
+                gnrc_mac_rx_set_burst(&netif->mac.rx, (info.header->type ==
+                                                       GNRC_LWMAC_FRAMETYPE_DATA_PENDING));
                 _gnrc_lwmac_dispatch_defer(netif->mac.rx.dispatch_buffer, pkt);
                 gnrc_mac_dispatch(&netif->mac.rx);
                 LOG_DEBUG("[LWMAC-rx] Found DATA!\n");
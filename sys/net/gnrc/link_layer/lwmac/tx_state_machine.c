@@ -142,6 +142,35 @@ static uint8_t _send_bcast(gnrc_netif_t *netif)
     return tx_info;
 }
 
+/* Returns for how long to stream WRs until the destination has to answer */
+static uint32_t _wr_duration(gnrc_netif_t *netif)
+{
+    gnrc_mac_tx_neighbor_t *neighbor = netif->mac.tx.current_neighbor;
+
+    if (!_gnrc_lwmac_phase_known(neighbor) || gnrc_lwmac_get_tx_continue(netif)) {
+        return GNRC_LWMAC_PREAMBLE_DURATION_US;
+    }
+
+    /* Phase-locked, the WR stream started shortly before the predicted wake-up
+     * of the destination, so it has to answer within its wake-up period */
+    uint32_t guard = RTT_TICKS_TO_US(_gnrc_lwmac_phase_guard(neighbor, rtt_get_counter()));
+    uint32_t duration = GNRC_LWMAC_WR_PREPARATION_US + GNRC_LWMAC_TIME_BETWEEN_WR_US +
+                        GNRC_LWMAC_WAKEUP_DURATION_US + (2 * guard);
+
+    return (duration < GNRC_LWMAC_PREAMBLE_DURATION_US) ?
+           duration : GNRC_LWMAC_PREAMBLE_DURATION_US;
+}
+
+/* Accounts a WR stream not answered by the destination */
+static void _no_response(gnrc_netif_t *netif)
+{
+    gnrc_mac_tx_neighbor_t *neighbor = netif->mac.tx.current_neighbor;
+
+    if (_gnrc_lwmac_phase_known(neighbor) && !gnrc_lwmac_get_tx_continue(netif)) {
+        _gnrc_lwmac_phase_missed(neighbor);
+    }
+}
+
 static uint8_t _send_wr(gnrc_netif_t *netif)
 {
     assert(netif != NULL);
@@ -360,7 +389,8 @@ static uint8_t _packet_process_in_wait_for_wa(gnrc_netif_t *netif)
     }
 
     /* Save newly calculated phase for destination */
-    netif->mac.tx.current_neighbor->phase = netif->mac.tx.timestamp;
+    _gnrc_lwmac_phase_learn(netif->mac.tx.current_neighbor, netif->mac.tx.timestamp,
+                            rtt_get_counter());
     LOG_INFO("[LWMAC-tx] New phase: %" PRIu32 "\n", netif->mac.tx.timestamp);
 
     /* We've got our WA, so discard the rest, TODO: no flushing */
@@ -404,11 +434,9 @@ static bool _send_data(gnrc_netif_t *netif)
      * In case the sender has no more packet for the receiver, it simply sets the
      * data type to FRAMETYPE_DATA. */
     gnrc_lwmac_hdr_t hdr;
-    if ((gnrc_priority_pktqueue_length(&netif->mac.tx.current_neighbor->queue) > 0) &&
-        (netif->mac.tx.tx_burst_count < GNRC_LWMAC_MAX_TX_BURST_PKT_NUM)) {
+    if (gnrc_mac_tx_burst_pending(&netif->mac.tx, GNRC_LWMAC_MAX_TX_BURST_PKT_NUM)) {
         hdr.type = GNRC_LWMAC_FRAMETYPE_DATA_PENDING;
         gnrc_lwmac_set_tx_continue(netif, true);
-        netif->mac.tx.tx_burst_count++;
     }
     else {
         hdr.type = GNRC_LWMAC_FRAMETYPE_DATA;
@@ -576,7 +604,7 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
                 netif->dev->driver->set(netif->dev, NETOPT_CSMA,
                                         &csma_disable, sizeof(csma_disable));
                 /* Set a timeout for the maximum transmission procedure */
-                gnrc_lwmac_set_timeout(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE, GNRC_LWMAC_PREAMBLE_DURATION_US);
+                gnrc_lwmac_set_timeout(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE, _wr_duration(netif));
 
                 netif->mac.tx.state = GNRC_LWMAC_TX_STATE_SEND_WR;
                 reschedule = true;
@@ -628,6 +656,7 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
             /* In case of no Tx-isr error (e.g., no Tx-isr), goto TX failure. */
             if (gnrc_lwmac_timeout_is_expired(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE)) {
                 LOG_WARNING("WARNING: [LWMAC-tx] No response from destination\n");
+                _no_response(netif);
                 netif->mac.tx.state = GNRC_LWMAC_TX_STATE_FAILED;
                 reschedule = true;
                 break;
@@ -682,6 +711,7 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
 
             if (gnrc_lwmac_timeout_is_expired(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE)) {
                 LOG_WARNING("WARNING: [LWMAC-tx] No response from destination\n");
+                _no_response(netif);
                 netif->mac.tx.state = GNRC_LWMAC_TX_STATE_FAILED;
                 reschedule = true;
                 break;
@@ -23,6 +23,9 @@
 #include "net/gnrc/netreg.h"
 #include "net/gnrc/pktbuf.h"
 #include "net/gnrc/netapi.h"
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -91,6 +94,29 @@ static inline int _snd_rcv_mbox(mbox_t *mbox, uint16_t type, gnrc_pktsnip_t *pkt
 }
 #endif
 
+#ifdef MODULE_NETSTATS_EXT
+static void _netstats_queue_full(gnrc_nettype_t type, bool mbox)
+{
+    netstats_ext_layer_t layer = NETSTATS_EXT_LAYER_TRANSPORT;
+
+    if (mbox) {
+        layer = NETSTATS_EXT_LAYER_SOCK;
+    }
+#ifdef MODULE_GNRC_SIXLOWPAN
+    else if (type == GNRC_NETTYPE_SIXLOWPAN) {
+        layer = NETSTATS_EXT_LAYER_6LO;
+    }
+#endif
+#ifdef MODULE_GNRC_IPV6
+    else if (type == GNRC_NETTYPE_IPV6) {
+        layer = NETSTATS_EXT_LAYER_IPV6;
+    }
+#endif
+    (void)type;
+    netstats_ext_drop(layer, NETSTATS_EXT_DROP_QUEUE_FULL);
+}
+#endif
+
 int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
                          uint16_t cmd, gnrc_pktsnip_t *pkt)
 {
@@ -109,6 +135,9 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
                     if (_snd_rcv(sendto->target.pid, cmd, pkt) < 1) {
                         /* unable to dispatch packet */
                         release = 1;
+#ifdef MODULE_NETSTATS_EXT
+                        _netstats_queue_full(type, false);
+#endif
                     }
                     break;
 #ifdef MODULE_GNRC_NETAPI_MBOX
@@ -116,6 +145,9 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
                     if (_snd_rcv_mbox(sendto->target.mbox, cmd, pkt) < 1) {
                         /* unable to dispatch packet */
                         release = 1;
+#ifdef MODULE_NETSTATS_EXT
+                        _netstats_queue_full(type, true);
+#endif
                     }
                     break;
 #endif
@@ -136,6 +168,9 @@ int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
             if (_snd_rcv(sendto->target.pid, cmd, pkt) < 1) {
                 /* unable to dispatch packet */
                 gnrc_pktbuf_release(pkt);
+#ifdef MODULE_NETSTATS_EXT
+                _netstats_queue_full(type, false);
+#endif
             }
 #endif
             sendto = gnrc_netreg_getnext(sendto);
@@ -25,10 +25,19 @@
 #ifdef MODULE_NETSTATS_IPV6
 #include "net/netstats.h"
 #endif
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
 #include "log.h"
 #include "sched.h"
+#ifdef MODULE_NETSTATS_RADIO
+#include "xtimer.h"
+#endif
 
 #include "net/gnrc/netif.h"
+#ifdef MODULE_GNRC_NETIF_GSO
+#include "net/gnrc/netif/gso.h"
+#endif
 #include "net/gnrc/netif/internal.h"
 
 #define ENABLE_DEBUG    (0)
@@ -41,6 +50,11 @@ static gnrc_netif_t _netifs[GNRC_NETIF_NUMOF];
 static void _update_l2addr_from_dev(gnrc_netif_t *netif);
 static void *_gnrc_netif_thread(void *args);
 static void _event_cb(netdev_t *dev, netdev_event_t event);
+static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+#ifdef MODULE_GNRC_NETIF_TXQ
+static void _txq_push(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+static void _txq_send(gnrc_netif_t *netif);
+#endif
 
 gnrc_netif_t *gnrc_netif_create(char *stack, int stacksize, char priority,
                                 const char *name, netdev_t *netdev,
@@ -325,6 +339,12 @@ int gnrc_netif_set_from_netdev(gnrc_netif_t *netif,
                 case NETOPT_SRC_LEN:
                     _update_l2addr_from_dev(netif);
                     break;
+#ifdef MODULE_NETSTATS_RADIO
+                case NETOPT_STATE:
+                    netstats_radio_set_netopt(&netif->radio_stats,
+                                              *((netopt_state_t *)opt->data));
+                    break;
+#endif
                 default:
                     break;
             }
@@ -1243,8 +1263,17 @@ static void *_gnrc_netif_thread(void *args)
     dev->driver->init(dev);
     _init_from_device(netif);
     netif->cur_hl = GNRC_NETIF_DEFAULT_HL;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    gnrc_netif_txq_init(&netif->txq);
+#endif
 #ifdef MODULE_GNRC_IPV6_NIB
     gnrc_ipv6_nib_init_iface(netif);
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    netstats_nb_init(&netif->nb_stats);
+#endif
+#ifdef MODULE_NETSTATS_RADIO
+    netstats_radio_init(&netif->radio_stats, NULL, xtimer_now_usec64());
 #endif
     if (netif->ops->init) {
         netif->ops->init(netif);
@@ -1263,11 +1292,15 @@ static void *_gnrc_netif_thread(void *args)
                 break;
             case GNRC_NETAPI_MSG_TYPE_SND:
                 DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
-                res = netif->ops->send(netif, msg.content.ptr);
+#ifdef MODULE_GNRC_NETIF_TXQ
+                _txq_push(netif, msg.content.ptr);
+#else
+                res = _send(netif, msg.content.ptr);
                 if (res < 0) {
                     DEBUG("gnrc_netif: error sending packet %p (code: %u)\n",
                           msg.content.ptr, res);
                 }
+#endif
                 break;
             case GNRC_NETAPI_MSG_TYPE_SET:
                 opt = msg.content.ptr;
@@ -1311,11 +1344,159 @@ static void *_gnrc_netif_thread(void *args)
                 }
                 break;
         }
+#ifdef MODULE_GNRC_NETIF_TXQ
+        _txq_send(netif);
+#endif
     }
     /* never reached */
     return NULL;
 }
 
+#ifdef MODULE_GNRC_NETIF_TXQ
+static void _txq_push(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    uint8_t cls = gnrc_netif_txq_classify(pkt);
+
+    if (gnrc_netif_txq_push(&netif->txq, pkt, cls) < 0) {
+        DEBUG("gnrc_netif: TX queue full, dropping packet %p (class %u)\n",
+              (void *)pkt, cls);
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_L2, NETSTATS_EXT_DROP_QUEUE_FULL);
+#endif
+        /* report to sender instead of dropping silently */
+        gnrc_pktbuf_release_error(pkt, ENOBUFS);
+    }
+}
+
+static void _txq_send(gnrc_netif_t *netif)
+{
+    gnrc_pktsnip_t *pkt;
+    unsigned sent = 0;
+
+    /* pending send requests are queued first, so they get scheduled by their
+     * class and not by the order they arrived in. A batch is sent after
+     * every message nonetheless, so a busy message queue can't stall
+     * sending */
+    while (((sent < GNRC_NETIF_TXQ_BATCH) || (msg_avail() == 0)) &&
+           ((pkt = gnrc_netif_txq_pop(&netif->txq)) != NULL)) {
+        int res = _send(netif, pkt);
+
+        if (res < 0) {
+            DEBUG("gnrc_netif: error sending packet %p (code: %i)\n",
+                  (void *)pkt, res);
+        }
+        sent++;
+    }
+}
+#endif
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static void _nb_record(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    const uint8_t *dst = NULL;
+    size_t dst_len = 0;
+
+    if ((pkt != NULL) && (pkt->type == GNRC_NETTYPE_NETIF)) {
+        gnrc_netif_hdr_t *hdr = pkt->data;
+
+        if (!(hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                            GNRC_NETIF_HDR_FLAGS_MULTICAST))) {
+            dst = gnrc_netif_hdr_get_dst_addr(hdr);
+            dst_len = hdr->dst_l2addr_len;
+        }
+    }
+    gnrc_netif_acquire(netif);
+    netstats_nb_record(&netif->nb_stats, dst, dst_len);
+    gnrc_netif_release(netif);
+}
+
+static void _nb_update_tx(gnrc_netif_t *netif, netstats_nb_tx_t res)
+{
+    uint8_t retries = 0;
+
+    if ((res != NETSTATS_NB_TX_BUSY) &&
+        (netif->dev->driver->get(netif->dev, NETOPT_TX_RETRIES_NEEDED,
+                                 &retries, sizeof(retries)) < 0)) {
+        retries = 0;
+    }
+    gnrc_netif_acquire(netif);
+    netstats_nb_update_tx(&netif->nb_stats, res, retries);
+    gnrc_netif_release(netif);
+}
+
+int gnrc_netif_nb_stats_get(gnrc_netif_t *netif, const uint8_t *l2addr,
+                            size_t l2addr_len, netstats_nb_t *stats)
+{
+    const netstats_nb_t *nb;
+    int res = -ENOENT;
+
+    assert((netif != NULL) && (stats != NULL));
+    gnrc_netif_acquire(netif);
+    nb = netstats_nb_get(&netif->nb_stats, l2addr, l2addr_len);
+    if (nb != NULL) {
+        *stats = *nb;
+        res = 0;
+    }
+    gnrc_netif_release(netif);
+    return res;
+}
+#endif
+
+#ifdef MODULE_NETSTATS_RADIO
+void gnrc_netif_radio_stats_get(gnrc_netif_t *netif, netstats_radio_t *stats,
+                                bool reset)
+{
+    uint64_t now = xtimer_now_usec64();
+
+    assert((netif != NULL) && (stats != NULL));
+    gnrc_netif_acquire(netif);
+    netstats_radio_update(&netif->radio_stats, now);
+    *stats = netif->radio_stats;
+    if (reset) {
+        netstats_radio_reset(&netif->radio_stats, now);
+    }
+    gnrc_netif_release(netif);
+}
+#endif
+
+static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    _nb_record(netif, pkt);
+#endif
+#ifdef MODULE_GNRC_NETIF_GSO
+    if (gnrc_netif_gso_size(pkt) > 0) {
+        gnrc_pktsnip_t *seg;
+        size_t offset = 0;
+        int res = 0;
+
+        /* segments are sent back-to-back, so the header chain of pkt only
+         * needs to stay around until the last one is cut */
+        while ((seg = gnrc_netif_gso_next(pkt, &offset)) != NULL) {
+#ifdef MODULE_NETSTATS_EXT
+            netstats_ext_tx(NETSTATS_EXT_LAYER_L2, gnrc_pkt_len(seg->next));
+#endif
+            res = netif->ops->send(netif, seg);
+            if (res < 0) {
+                DEBUG("gnrc_netif: error sending segment at %u of %p "
+                      "(code: %i)\n", (unsigned)offset, (void *)pkt, res);
+            }
+        }
+        if (offset == 0) {
+            DEBUG("gnrc_netif: unable to segment %p\n", (void *)pkt);
+            gnrc_pktbuf_release_error(pkt, ENOBUFS);
+            return -ENOBUFS;
+        }
+        gnrc_pktbuf_release(pkt);
+        return res;
+    }
+#endif
+#ifdef MODULE_NETSTATS_EXT
+    netstats_ext_tx(NETSTATS_EXT_LAYER_L2, gnrc_pkt_len(pkt->next));
+#endif
+    return netif->ops->send(netif, pkt);
+}
+
 static void _pass_on_packet(gnrc_pktsnip_t *pkt)
 {
     /* throw away packet if no one is interested */
@@ -1345,20 +1526,40 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
                     gnrc_pktsnip_t *pkt = netif->ops->recv(netif);
 
                     if (pkt) {
+#ifdef MODULE_NETSTATS_EXT
+                        pkt->rx_time = netstats_ext_now();
+                        netstats_ext_rx(NETSTATS_EXT_LAYER_L2,
+                                        gnrc_pkt_len(pkt));
+#endif
                         _pass_on_packet(pkt);
                     }
                 }
                 break;
-#ifdef MODULE_NETSTATS_L2
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_NETSTATS_NEIGHBOR)
             case NETDEV_EVENT_TX_MEDIUM_BUSY:
+#ifdef MODULE_NETSTATS_L2
                 /* we are the only ones supposed to touch this variable,
                  * so no acquire necessary */
                 dev->stats.tx_failed++;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                _nb_update_tx(netif, NETSTATS_NB_TX_BUSY);
+#endif
                 break;
             case NETDEV_EVENT_TX_COMPLETE:
+#ifdef MODULE_NETSTATS_L2
                 /* we are the only ones supposed to touch this variable,
                  * so no acquire necessary */
                 dev->stats.tx_success++;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                _nb_update_tx(netif, NETSTATS_NB_TX_SUCCESS);
+#endif
+                break;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+            case NETDEV_EVENT_TX_NOACK:
+                _nb_update_tx(netif, NETSTATS_NB_TX_NOACK);
                 break;
 #endif
             default:
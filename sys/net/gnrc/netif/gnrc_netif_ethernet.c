@@ -22,6 +22,12 @@
 #ifdef MODULE_GNRC_IPV6
 #include "net/ipv6/hdr.h"
 #endif
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
+#ifdef MODULE_GNRC_PKTCAPTURE
+#include "net/gnrc/pktcapture.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -149,6 +155,10 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
     else {
         dev->stats.tx_unicast_count++;
     }
+#endif
+#ifdef MODULE_GNRC_PKTCAPTURE
+    gnrc_pktcapture_add(netif->pid, GNRC_PKTCAPTURE_LINKTYPE_ETHERNET, true,
+                        &iolist);
 #endif
     res = dev->driver->send(dev, &iolist);
 
@@ -170,6 +180,10 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
 
         if (!pkt) {
             DEBUG("gnrc_netif_ethernet: cannot allocate pktsnip.\n");
+#ifdef MODULE_NETSTATS_EXT
+            netstats_ext_drop(NETSTATS_EXT_LAYER_L2,
+                              NETSTATS_EXT_DROP_PKTBUF_FULL);
+#endif
 
             /* drop the packet */
             dev->driver->recv(dev, NULL, bytes_expected, NULL);
@@ -182,6 +196,12 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
             DEBUG("gnrc_netif_ethernet: read error.\n");
             goto safe_out;
         }
+#ifdef MODULE_GNRC_PKTCAPTURE
+        iolist_t frame = { .iol_base = pkt->data, .iol_len = (size_t)nread };
+
+        gnrc_pktcapture_add(netif->pid, GNRC_PKTCAPTURE_LINKTYPE_ETHERNET,
+                            false, &frame);
+#endif
 
         if (nread < bytes_expected) {
             /* we've got less than the expected packet size,
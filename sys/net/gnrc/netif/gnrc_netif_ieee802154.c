@@ -20,6 +20,12 @@
 #ifdef MODULE_GNRC_IPV6
 #include "net/ipv6/hdr.h"
 #endif
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
+#ifdef MODULE_GNRC_PKTCAPTURE
+#include "net/gnrc/pktcapture.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -88,6 +94,10 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
         pkt = gnrc_pktbuf_add(NULL, NULL, bytes_expected, GNRC_NETTYPE_UNDEF);
         if (pkt == NULL) {
             DEBUG("_recv_ieee802154: cannot allocate pktsnip.\n");
+#ifdef MODULE_NETSTATS_EXT
+            netstats_ext_drop(NETSTATS_EXT_LAYER_L2,
+                              NETSTATS_EXT_DROP_PKTBUF_FULL);
+#endif
             return NULL;
         }
         nread = dev->driver->recv(dev, pkt->data, bytes_expected, &rx_info);
@@ -95,6 +105,12 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
             gnrc_pktbuf_release(pkt);
             return NULL;
         }
+#ifdef MODULE_GNRC_PKTCAPTURE
+        iolist_t frame = { .iol_base = pkt->data, .iol_len = (size_t)nread };
+
+        gnrc_pktcapture_add(netif->pid, GNRC_PKTCAPTURE_LINKTYPE_IEEE802154,
+                            false, &frame);
+#endif
         if (!(state->flags & NETDEV_IEEE802154_RAW)) {
             gnrc_pktsnip_t *ieee802154_hdr, *netif_hdr;
             gnrc_netif_hdr_t *hdr;
@@ -227,6 +243,10 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
         netif->dev->stats.tx_unicast_count++;
     }
 #endif
+#ifdef MODULE_GNRC_PKTCAPTURE
+    gnrc_pktcapture_add(netif->pid, GNRC_PKTCAPTURE_LINKTYPE_IEEE802154, true,
+                        &iolist);
+#endif
 #ifdef MODULE_GNRC_MAC
     if (netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED) {
         res = csma_sender_csma_ca_send(dev, &iolist, &netif->mac.csma_conf);
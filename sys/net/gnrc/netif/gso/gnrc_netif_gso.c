@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "net/ipv6/hdr.h"
+#include "net/udp.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "net/gnrc/netif/gso.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/**
+ * @brief   Maximum number of header snips (including netif, IPv6 and UDP
+ *          header) a packet to segment may have
+ */
+#define _HDRS_MAX       (6U)
+
+static gnrc_pktsnip_t *_find_udp(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t **ipv6,
+                                 unsigned *hdrs)
+{
+    *ipv6 = NULL;
+    *hdrs = 0;
+    for (gnrc_pktsnip_t *ptr = pkt; ptr != NULL; ptr = ptr->next) {
+        if (++(*hdrs) > _HDRS_MAX) {
+            return NULL;
+        }
+        if ((ptr->type == GNRC_NETTYPE_IPV6) && (*ipv6 == NULL)) {
+            *ipv6 = ptr;
+        }
+        else if ((ptr->type == GNRC_NETTYPE_UDP) && (*ipv6 != NULL)) {
+            return (ptr->size == sizeof(udp_hdr_t)) ? ptr : NULL;
+        }
+    }
+    return NULL;
+}
+
+size_t gnrc_netif_gso_seg_len(const gnrc_pktsnip_t *pkt)
+{
+    size_t len = 0;
+    uint16_t gso_size = gnrc_netif_gso_size(pkt);
+
+    assert(pkt != NULL);
+    for (pkt = pkt->next; pkt != NULL; pkt = pkt->next) {
+        len += pkt->size;
+        if ((gso_size > 0) && (pkt->type == GNRC_NETTYPE_UDP)) {
+            size_t payload_len = gnrc_pkt_len(pkt->next);
+
+            return len + ((payload_len < gso_size) ? payload_len : gso_size);
+        }
+    }
+    return len;
+}
+
+gnrc_pktsnip_t *gnrc_netif_gso_next(gnrc_pktsnip_t *pkt, size_t *offset)
+{
+    gnrc_pktsnip_t *ipv6, *udp, *seg;
+    const gnrc_pktsnip_t *ptr;
+    size_t payload_len, seg_size, skip, left;
+    unsigned hdrs;
+    int res;
+    uint8_t *data;
+    uint16_t gso_size = gnrc_netif_gso_size(pkt);
+
+    assert((gso_size > 0) && (offset != NULL));
+    if ((udp = _find_udp(pkt, &ipv6, &hdrs)) == NULL) {
+        DEBUG("gnrc_netif_gso: no UDP packet\n");
+        return NULL;
+    }
+    payload_len = gnrc_pkt_len(udp->next);
+    if (*offset >= payload_len) {
+        return NULL;
+    }
+    seg_size = payload_len - *offset;
+    if (seg_size > gso_size) {
+        seg_size = gso_size;
+    }
+    /* copy payload slice first, so the headers can be prepended */
+    if ((seg = gnrc_pktbuf_add(NULL, NULL, seg_size,
+                               udp->next->type)) == NULL) {
+        DEBUG("gnrc_netif_gso: unable to allocate payload\n");
+        return NULL;
+    }
+    data = seg->data;
+    skip = *offset;
+    left = seg_size;
+    for (ptr = udp->next; (ptr != NULL) && (left > 0); ptr = ptr->next) {
+        size_t n;
+
+        if (skip >= ptr->size) {
+            skip -= ptr->size;
+            continue;
+        }
+        n = ptr->size - skip;
+        if (n > left) {
+            n = left;
+        }
+        memcpy(data, (uint8_t *)ptr->data + skip, n);
+        data += n;
+        left -= n;
+        skip = 0;
+    }
+    /* copy header chain back to front */
+    while (hdrs > 0) {
+        gnrc_pktsnip_t *tmp;
+
+        ptr = pkt;
+        for (unsigned i = 1; i < hdrs; i++) {
+            ptr = ptr->next;
+        }
+        if ((tmp = gnrc_pktbuf_add(seg, ptr->data, ptr->size,
+                                   ptr->type)) == NULL) {
+            DEBUG("gnrc_netif_gso: unable to allocate headers\n");
+            gnrc_pktbuf_release(seg);
+            return NULL;
+        }
+        seg = tmp;
+        hdrs--;
+    }
+    /* fix up lengths and checksum of the copy */
+    ((gnrc_netif_hdr_t *)seg->data)->gso_size = 0;
+    ipv6 = gnrc_pktsnip_search_type(seg, GNRC_NETTYPE_IPV6);
+    udp = gnrc_pktsnip_search_type(ipv6, GNRC_NETTYPE_UDP);
+    ((ipv6_hdr_t *)ipv6->data)->len = byteorder_htons(gnrc_pkt_len(ipv6->next));
+    ((udp_hdr_t *)udp->data)->length = byteorder_htons(gnrc_pkt_len(udp));
+    ((udp_hdr_t *)udp->data)->checksum.u16 = 0;
+    res = gnrc_netreg_calc_csum(udp, ipv6);
+    if ((res < 0) && (res != -ENOENT)) {
+        DEBUG("gnrc_netif_gso: unable to calculate checksum\n");
+        gnrc_pktbuf_release(seg);
+        return NULL;
+    }
+    *offset += seg_size;
+    return seg;
+}
+
+/** @} */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include "net/icmpv6.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/gnrc/nettype.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "net/gnrc/netif/txq.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/**
+ * @name    Differentiated services code points used for classification
+ * @{
+ */
+#define _DSCP_LE        (0x01)  /**< lower effort (RFC 8622) */
+#define _DSCP_CS1       (0x08)  /**< class selector 1 */
+#define _DSCP_CS4       (0x20)  /**< class selector 4 */
+#define _DSCP_AF41      (0x22)  /**< assured forwarding 41 */
+#define _DSCP_AF42      (0x24)  /**< assured forwarding 42 */
+#define _DSCP_AF43      (0x26)  /**< assured forwarding 43 */
+#define _DSCP_CS5       (0x28)  /**< class selector 5 */
+#define _DSCP_VA        (0x2c)  /**< voice admit */
+#define _DSCP_EF        (0x2e)  /**< expedited forwarding */
+#define _DSCP_CS6       (0x30)  /**< class selector 6 */
+#define _DSCP_CS7       (0x38)  /**< class selector 7 */
+/** @} */
+
+static uint8_t _classify_dscp(uint8_t dscp)
+{
+    switch (dscp) {
+        case _DSCP_CS6:
+        case _DSCP_CS7:
+            return GNRC_NETIF_TXQ_CLASS_CTRL;
+        case _DSCP_CS4:
+        case _DSCP_AF41:
+        case _DSCP_AF42:
+        case _DSCP_AF43:
+        case _DSCP_CS5:
+        case _DSCP_VA:
+        case _DSCP_EF:
+            return GNRC_NETIF_TXQ_CLASS_HIGH;
+        case _DSCP_LE:
+        case _DSCP_CS1:
+            return GNRC_NETIF_TXQ_CLASS_BULK;
+        default:
+            return GNRC_NETIF_TXQ_CLASS_DEFAULT;
+    }
+}
+
+static bool _is_ctrl_icmpv6(uint8_t type)
+{
+    switch (type) {
+        case ICMPV6_RTR_SOL:
+        case ICMPV6_RTR_ADV:
+        case ICMPV6_NBR_SOL:
+        case ICMPV6_NBR_ADV:
+        case ICMPV6_REDIRECT:
+        case ICMPV6_RPL_CTRL:
+        case ICMPV6_DAR:
+        case ICMPV6_DAC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline uint16_t _quantum(unsigned cls)
+{
+    return GNRC_NETIF_TXQ_DRR_QUANTUM << (GNRC_NETIF_TXQ_CLASS_NUMOF - 1 - cls);
+}
+
+static gnrc_pktsnip_t *_dequeue(gnrc_netif_txq_t *txq, unsigned cls)
+{
+    gnrc_pktqueue_t *node = gnrc_pktqueue_remove_head(&txq->classes[cls]);
+    gnrc_pktsnip_t *pkt = node->pkt;
+
+    node->pkt = NULL;
+    txq->stats[cls].len--;
+    return pkt;
+}
+
+static inline void _drr_next(gnrc_netif_txq_t *txq)
+{
+    txq->drr_cur++;
+    if (txq->drr_cur >= GNRC_NETIF_TXQ_CLASS_NUMOF) {
+        txq->drr_cur = GNRC_NETIF_TXQ_CLASS_CTRL + 1;
+    }
+    txq->drr_visited = false;
+}
+
+static gnrc_pktsnip_t *_drr_pop(gnrc_netif_txq_t *txq)
+{
+    while (1) {
+        unsigned cls = txq->drr_cur;
+        size_t len;
+
+        if (txq->classes[cls] == NULL) {
+            /* idle classes must not accumulate credit */
+            txq->deficit[cls] = 0;
+            _drr_next(txq);
+            continue;
+        }
+        if (!txq->drr_visited) {
+            txq->deficit[cls] += _quantum(cls);
+            txq->drr_visited = true;
+        }
+        len = gnrc_pkt_len(txq->classes[cls]->pkt);
+        if (len <= txq->deficit[cls]) {
+            txq->deficit[cls] -= len;
+            gnrc_pktsnip_t *pkt = _dequeue(txq, cls);
+            if (txq->classes[cls] == NULL) {
+                txq->deficit[cls] = 0;
+                _drr_next(txq);
+            }
+            return pkt;
+        }
+        _drr_next(txq);
+    }
+}
+
+void gnrc_netif_txq_init(gnrc_netif_txq_t *txq)
+{
+    assert(txq != NULL);
+    memset(txq, 0, sizeof(gnrc_netif_txq_t));
+    txq->sched = GNRC_NETIF_TXQ_SCHED_DEFAULT;
+    txq->drr_cur = GNRC_NETIF_TXQ_CLASS_CTRL + 1;
+}
+
+uint8_t gnrc_netif_txq_classify(const gnrc_pktsnip_t *pkt)
+{
+    assert(pkt != NULL);
+    if (pkt->type == GNRC_NETTYPE_NETIF) {
+        uint8_t cls = gnrc_netif_hdr_get_txq_class(pkt->data);
+
+        if (cls != GNRC_NETIF_TXQ_CLASS_AUTO) {
+            return cls;
+        }
+        pkt = pkt->next;
+    }
+#ifdef MODULE_GNRC_IPV6
+    if ((pkt != NULL) && (pkt->type == GNRC_NETTYPE_IPV6) &&
+        (pkt->size >= sizeof(ipv6_hdr_t)) && ipv6_hdr_is(pkt->data)) {
+        const ipv6_hdr_t *hdr = pkt->data;
+        const gnrc_pktsnip_t *payload = pkt->next;
+
+        if ((hdr->nh == PROTNUM_ICMPV6) && (payload != NULL) &&
+            (payload->size > 0) &&
+            _is_ctrl_icmpv6(((uint8_t *)payload->data)[0])) {
+            return GNRC_NETIF_TXQ_CLASS_CTRL;
+        }
+        return _classify_dscp(ipv6_hdr_get_tc_dscp(hdr));
+    }
+#else
+    (void)_classify_dscp;
+    (void)_is_ctrl_icmpv6;
+#endif
+    return GNRC_NETIF_TXQ_CLASS_DEFAULT;
+}
+
+int gnrc_netif_txq_push(gnrc_netif_txq_t *txq, gnrc_pktsnip_t *pkt,
+                        uint8_t cls)
+{
+    gnrc_netif_txq_stats_t *stats;
+
+    assert((txq != NULL) && (pkt != NULL));
+    assert(cls < GNRC_NETIF_TXQ_CLASS_NUMOF);
+    stats = &txq->stats[cls];
+    /* control traffic may use the whole queue */
+    if ((cls != GNRC_NETIF_TXQ_CLASS_CTRL) &&
+        (stats->len >= GNRC_NETIF_TXQ_CLASS_LIMIT)) {
+        DEBUG("gnrc_netif_txq: class %u full\n", cls);
+        stats->dropped++;
+        return -ENOBUFS;
+    }
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_SIZE; i++) {
+        gnrc_pktqueue_t *node = &txq->nodes[i];
+
+        if (node->pkt == NULL) {
+            node->pkt = pkt;
+            node->next = NULL;
+            gnrc_pktqueue_add(&txq->classes[cls], node);
+            stats->enqueued++;
+            if (++stats->len > stats->max_len) {
+                stats->max_len = stats->len;
+            }
+            return 0;
+        }
+    }
+    DEBUG("gnrc_netif_txq: queue full\n");
+    stats->dropped++;
+    return -ENOBUFS;
+}
+
+gnrc_pktsnip_t *gnrc_netif_txq_pop(gnrc_netif_txq_t *txq)
+{
+    assert(txq != NULL);
+    if (txq->classes[GNRC_NETIF_TXQ_CLASS_CTRL] != NULL) {
+        return _dequeue(txq, GNRC_NETIF_TXQ_CLASS_CTRL);
+    }
+    if (gnrc_netif_txq_empty(txq)) {
+        return NULL;
+    }
+    if (txq->sched == GNRC_NETIF_TXQ_SCHED_DRR) {
+        return _drr_pop(txq);
+    }
+    for (unsigned i = GNRC_NETIF_TXQ_CLASS_CTRL + 1;
+         i < GNRC_NETIF_TXQ_CLASS_NUMOF; i++) {
+        if (txq->classes[i] != NULL) {
+            return _dequeue(txq, i);
+        }
+    }
+    return NULL;
+}
+
+void gnrc_netif_txq_flush(gnrc_netif_txq_t *txq)
+{
+    assert(txq != NULL);
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_CLASS_NUMOF; i++) {
+        while (txq->classes[i] != NULL) {
+            gnrc_pktbuf_release(_dequeue(txq, i));
+        }
+        txq->deficit[i] = 0;
+    }
+}
+
+/** @} */
@@ -12,11 +12,17 @@
  * @file
  */
 
+#include <errno.h>
+
 #include "net/gnrc/pktbuf.h"
 
 #include "net/ipv6.h"
 #include "net/gnrc/icmpv6/error.h"
 #include "net/gnrc/icmpv6.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif/hdr.h"
+#include "utlist.h"
 
 /* all error messages are basically the same size and format */
 #define ICMPV6_ERROR_SZ (sizeof(icmpv6_error_dst_unr_t))
@@ -26,10 +32,42 @@
 /* TODO: generalize and centralize (see https://github.com/RIOT-OS/RIOT/pull/3184) */
 #define MIN(a, b)   ((a) < (b)) ? (a) : (b)
 
+/* The snips of a received packet are in reverse order, so the offset of a
+ * snip in the invoking packet is the size of the snips following it, up to
+ * the interface header */
+static size_t _rcv_offset(const gnrc_pktsnip_t *snip)
+{
+    size_t offset = 0;
+
+    for (snip = snip->next; (snip != NULL) && (snip->type != GNRC_NETTYPE_NETIF);
+         snip = snip->next) {
+        offset += snip->size;
+    }
+    return offset;
+}
+
 static inline size_t _fit(gnrc_pktsnip_t *pkt)
 {
     /* TODO: replace IPV6_MIN_MTU with known path MTU? */
-    return MIN((gnrc_pkt_len(pkt) + ICMPV6_ERROR_SZ), IPV6_MIN_MTU);
+    return MIN((_rcv_offset(pkt) + pkt->size + ICMPV6_ERROR_SZ),
+               IPV6_MIN_MTU - sizeof(ipv6_hdr_t));
+}
+
+/* copy as much of the originating packet into error message as fits the
+ * message's size */
+static void _copy_orig(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *orig_pkt)
+{
+    uint8_t *data = pkt->data;
+
+    while ((orig_pkt != NULL) && (orig_pkt->type != GNRC_NETTYPE_NETIF)) {
+        size_t offset = ICMPV6_ERROR_SZ + _rcv_offset(orig_pkt);
+
+        if (offset < pkt->size) {
+            memcpy(data + offset, orig_pkt->data,
+                   MIN(pkt->size - offset, orig_pkt->size));
+        }
+        orig_pkt = orig_pkt->next;
+    }
 }
 
 /* Build a generic error message */
@@ -38,17 +76,9 @@ static gnrc_pktsnip_t *_icmpv6_error_build(uint8_t type, uint8_t code,
 {
     gnrc_pktsnip_t *pkt = gnrc_icmpv6_build(NULL, type, code, _fit(orig_pkt));
 
-    /* copy as much of the originating packet into error message as fits the message's size */
     if (pkt != NULL) {
-        size_t offset = ICMPV6_ERROR_SZ;
-        uint8_t *data = pkt->data;
-        ICMPV6_ERROR_SET_VALUE(data, value);
-        while ((orig_pkt != NULL) && (offset < pkt->size)) {
-            memcpy(data + offset, orig_pkt->data,
-                   MIN(pkt->size - offset, orig_pkt->size));
-            offset += MIN(pkt->size - offset, orig_pkt->size);
-            orig_pkt = orig_pkt->next;
-        }
+        ICMPV6_ERROR_SET_VALUE(pkt->data, value);
+        _copy_orig(pkt, orig_pkt);
     }
 
     return pkt;
@@ -83,39 +113,115 @@ gnrc_pktsnip_t *gnrc_icmpv6_error_param_prob_build(uint8_t code, void *ptr,
     /* copy as much of the originating packet into error message and
      * determine relative *ptr* offset */
     if (pkt != NULL) {
-        size_t offset = sizeof(icmpv6_error_param_prob_t);
-        uint8_t *data = pkt->data;
         uint32_t ptr_offset = 0U;
-        bool found_offset = false;
-
-        while (orig_pkt != NULL) {
-            /* copy as long as it fits into packet */
-            if (offset < pkt->size) {
-                memcpy(data + offset, orig_pkt->data,
-                       MIN(pkt->size - offset, orig_pkt->size));
-                offset += MIN(pkt->size - offset, orig_pkt->size);
-            }
-
-            if (_in_range(ptr, orig_pkt->data, orig_pkt->size)) {
-                ptr_offset += (uint32_t)(((uint8_t *)ptr) - ((uint8_t *)orig_pkt->data));
-                found_offset = true;
-            }
-            else if (!found_offset) {
-                ptr_offset += (uint32_t)orig_pkt->size;
-            }
 
-            orig_pkt = orig_pkt->next;
-
-            if ((offset < pkt->size) && found_offset) {
+        _copy_orig(pkt, orig_pkt);
+        for (gnrc_pktsnip_t *snip = orig_pkt; snip != NULL; snip = snip->next) {
+            if (_in_range(ptr, snip->data, snip->size)) {
+                ptr_offset = (uint32_t)(_rcv_offset(snip) +
+                                        (((uint8_t *)ptr) - ((uint8_t *)snip->data)));
                 break;
             }
         }
 
         /* set "pointer" field to relative pointer offset */
-        ((icmpv6_error_param_prob_t *)data)->ptr = byteorder_htonl(ptr_offset);
+        ((icmpv6_error_param_prob_t *)pkt->data)->ptr = byteorder_htonl(ptr_offset);
     }
 
     return pkt;
 }
 
+/* checks if an error message may be sent in reply to orig_pkt
+ * (see RFC 4443, section 2.4 (e)) */
+static bool _check_send(gnrc_pktsnip_t *orig_pkt, bool mcast)
+{
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(orig_pkt, GNRC_NETTYPE_IPV6);
+    gnrc_pktsnip_t *netif = gnrc_pktsnip_search_type(orig_pkt, GNRC_NETTYPE_NETIF);
+
+    if (ipv6 == NULL) {
+        return false;
+    }
+
+    ipv6_hdr_t *hdr = ipv6->data;
+
+    if (ipv6_addr_is_unspecified(&hdr->src) ||
+        ipv6_addr_is_multicast(&hdr->src)) {
+        return false;
+    }
+    if (!mcast && (ipv6_addr_is_multicast(&hdr->dst) ||
+                   ((netif != NULL) &&
+                    (((gnrc_netif_hdr_t *)netif->data)->flags &
+                     (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                      GNRC_NETIF_HDR_FLAGS_MULTICAST))))) {
+        return false;
+    }
+    return true;
+}
+
+/* sends an error message to the source of orig_pkt via the interface it was
+ * received on */
+static void _send(gnrc_pktsnip_t *pkt, gnrc_pktsnip_t *orig_pkt)
+{
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(orig_pkt, GNRC_NETTYPE_IPV6);
+    gnrc_pktsnip_t *netif = gnrc_pktsnip_search_type(orig_pkt, GNRC_NETTYPE_NETIF);
+    gnrc_pktsnip_t *hdr;
+
+    if (pkt == NULL) {
+        return;
+    }
+    hdr = gnrc_ipv6_hdr_build(pkt, NULL, &((ipv6_hdr_t *)ipv6->data)->src);
+    if (hdr == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    pkt = hdr;
+    if (netif != NULL) {
+        hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+        if (hdr == NULL) {
+            gnrc_pktbuf_release(pkt);
+            return;
+        }
+        ((gnrc_netif_hdr_t *)hdr->data)->if_pid =
+            ((gnrc_netif_hdr_t *)netif->data)->if_pid;
+        LL_PREPEND(pkt, hdr);
+    }
+    if (gnrc_netapi_send(gnrc_ipv6_pid, pkt) < 1) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+void gnrc_icmpv6_error_dst_unr_send(uint8_t code, gnrc_pktsnip_t *orig_pkt)
+{
+    if (_check_send(orig_pkt, false)) {
+        _send(gnrc_icmpv6_error_dst_unr_build(code, orig_pkt), orig_pkt);
+    }
+    gnrc_pktbuf_release_error(orig_pkt, EHOSTUNREACH);
+}
+
+void gnrc_icmpv6_error_pkt_too_big_send(uint32_t mtu, gnrc_pktsnip_t *orig_pkt)
+{
+    if (_check_send(orig_pkt, true)) {
+        _send(gnrc_icmpv6_error_pkt_too_big_build(mtu, orig_pkt), orig_pkt);
+    }
+    gnrc_pktbuf_release_error(orig_pkt, EMSGSIZE);
+}
+
+void gnrc_icmpv6_error_time_exc_send(uint8_t code, gnrc_pktsnip_t *orig_pkt)
+{
+    if (_check_send(orig_pkt, false)) {
+        _send(gnrc_icmpv6_error_time_exc_build(code, orig_pkt), orig_pkt);
+    }
+    gnrc_pktbuf_release_error(orig_pkt, ETIMEDOUT);
+}
+
+void gnrc_icmpv6_error_param_prob_send(uint8_t code, void *ptr,
+                                       gnrc_pktsnip_t *orig_pkt)
+{
+    if (_check_send(orig_pkt, code == ICMPV6_ERROR_PARAM_PROB_OPT)) {
+        _send(gnrc_icmpv6_error_param_prob_build(code, ptr, orig_pkt),
+              orig_pkt);
+    }
+    gnrc_pktbuf_release_error(orig_pkt, EINVAL);
+}
+
 /** @} */
@@ -20,10 +20,37 @@
 #include "net/gnrc/ipv6.h"
 
 #include "net/gnrc/ipv6/ext.h"
+#ifdef MODULE_GNRC_ICMPV6_ERROR
+#include "net/gnrc/icmpv6/error.h"
+#endif
+#ifdef MODULE_GNRC_RPL_SRH
+#include "net/gnrc/rpl/srh.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
+/**
+ * @brief   Discards a packet with a routing header of unknown type and
+ *          segments left, see RFC 8200, section 4.4
+ *
+ * @param[in] pkt   The packet, is released.
+ * @param[in] rh    The routing header within @p pkt.
+ */
+static void _rh_discard(gnrc_pktsnip_t *pkt, ipv6_ext_rh_t *rh)
+{
+    DEBUG("ipv6_ext: can't process routing header type %u, discarding\n",
+          (unsigned)rh->type);
+#ifdef MODULE_GNRC_ICMPV6_ERROR
+    /* point to the routing type field */
+    gnrc_icmpv6_error_param_prob_send(ICMPV6_ERROR_PARAM_PROB_HDR_FIELD,
+                                      &rh->type, pkt);
+#else
+    (void)rh;
+    gnrc_pktbuf_release(pkt);
+#endif
+}
+
 #ifdef MODULE_GNRC_RPL_SRH
 
 enum gnrc_ipv6_ext_demux_status {
@@ -67,6 +94,10 @@ static enum gnrc_ipv6_ext_demux_status _handle_rh(gnrc_pktsnip_t *current, gnrc_
 
     switch (ipv6_ext_rh_process(hdr, (ipv6_ext_rh_t *)ext)) {
         case EXT_RH_CODE_ERROR:
+            if (((ipv6_ext_rh_t *)ext)->type != GNRC_RPL_SRH_TYPE) {
+                _rh_discard(pkt, (ipv6_ext_rh_t *)ext);
+                return GNRC_IPV6_EXT_ERROR;
+            }
             /* TODO: send ICMPv6 error codes */
             gnrc_pktbuf_release(pkt);
             return GNRC_IPV6_EXT_ERROR;
@@ -165,6 +196,61 @@ static inline bool _has_valid_size(gnrc_pktsnip_t *pkt, uint8_t nh)
     }
 }
 
+/**
+ * @brief   Marks the whole extension header chain as a single snip, if
+ *          no-one needs the headers as separate snips
+ *
+ * @param[in] netif The receiving interface.
+ * @param[in] pkt   A packet, starting with the extension header chain.
+ * @param[in] nh    @ref net_protnum of the first extension header.
+ *
+ * @return  true, if @p pkt was handled (or released on error).
+ * @return  false, if @p pkt needs to be handled header by header.
+ */
+static bool _demux_chain(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt, uint8_t nh)
+{
+    gnrc_ipv6_ext_desc_t desc;
+    gnrc_pktsnip_t *tmp;
+
+    if ((gnrc_ipv6_ext_parse(&desc, pkt->data, pkt->size, nh) < 0) ||
+        (desc.num == 0)) {
+        /* let header by header handling deal with it */
+        return false;
+    }
+    for (unsigned i = 0; i < desc.num; i++) {
+        ipv6_ext_t *ext = (ipv6_ext_t *)(((uint8_t *)pkt->data) +
+                                         desc.hdrs[i].offset);
+
+        if ((desc.hdrs[i].type == PROTNUM_IPV6_EXT_RH) &&
+            (((ipv6_ext_rh_t *)ext)->seg_left != 0)) {
+            /* packet needs to be routed further or discarded */
+            return false;
+        }
+        /* packet is dispatched after each header, when marked header by
+         * header. Those registered for the header following the chain get
+         * it from gnrc_ipv6_demux() either way */
+        if (((i + 1U) < desc.num) &&
+            (gnrc_netreg_num(GNRC_NETTYPE_IPV6, ext->nh) > 0)) {
+            return false;
+        }
+    }
+    if ((tmp = gnrc_pktbuf_start_write(pkt)) == NULL) {
+        DEBUG("ipv6_ext: could not get a copy of pkt\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    pkt = tmp;
+    if (gnrc_pktbuf_mark(pkt, desc.len, GNRC_NETTYPE_IPV6_EXT) == NULL) {
+        DEBUG("ipv6_ext: unable to mark extension headers\n");
+        gnrc_pktbuf_release(pkt);
+        return true;
+    }
+    DEBUG("ipv6_ext: %u extension headers, next header = %u\n",
+          desc.num, desc.nh);
+    gnrc_ipv6_demux(netif, pkt, pkt, desc.nh);
+    return true;
+}
+
 /*
  *         current                 pkt
  *         |                       |
@@ -178,12 +264,15 @@ void gnrc_ipv6_ext_demux(gnrc_netif_t *netif,
 {
     ipv6_ext_t *ext;
 
+    if ((current == pkt) && _demux_chain(netif, pkt, nh)) {
+        return;
+    }
+
     while (true) {
         ext = (ipv6_ext_t *) current->data;
 
         switch (nh) {
             case PROTNUM_IPV6_EXT_RH:
-#ifdef MODULE_GNRC_RPL_SRH
                 /* if current != pkt, size is already checked */
                 if (current == pkt && !_has_valid_size(pkt, nh)) {
                     DEBUG("ipv6_ext: invalid size\n");
@@ -191,6 +280,7 @@ void gnrc_ipv6_ext_demux(gnrc_netif_t *netif,
                     return;
                 }
 
+#ifdef MODULE_GNRC_RPL_SRH
                 switch (_handle_rh(current, pkt)) {
                     case GNRC_IPV6_EXT_OK:
                         /* We are the final destination. So proceeds like normal packet. */
@@ -215,6 +305,13 @@ void gnrc_ipv6_ext_demux(gnrc_netif_t *netif,
                 }
 
                 break;
+#else
+                if (((ipv6_ext_rh_t *)ext)->seg_left != 0) {
+                    _rh_discard(pkt, (ipv6_ext_rh_t *)ext);
+                    return;
+                }
+                /* a routing header without segments left is skipped */
+                /* Falls through. */
 #endif
 
             case PROTNUM_IPV6_EXT_HOPOPT:
@@ -297,5 +394,91 @@ gnrc_pktsnip_t *gnrc_ipv6_ext_build(gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *next,
     return snip;
 }
 
+int gnrc_ipv6_ext_parse(gnrc_ipv6_ext_desc_t *desc, const uint8_t *data,
+                        size_t len, uint8_t nh)
+{
+    size_t offset = 0;
+
+    desc->num = 0;
+    /* walk until end of chain or, for chains split over several snips, end
+     * of data */
+    while (offset < len) {
+        const ipv6_ext_t *ext;
+        size_t ext_len;
+
+        switch (nh) {
+            case PROTNUM_IPV6_EXT_HOPOPT:
+            case PROTNUM_IPV6_EXT_DST:
+            case PROTNUM_IPV6_EXT_RH:
+            case PROTNUM_IPV6_EXT_FRAG:
+            case PROTNUM_IPV6_EXT_MOB:
+                break;
+            case PROTNUM_IPV6_EXT_AH:
+            case PROTNUM_IPV6_EXT_ESP:
+                return -ENOTSUP;
+            default:
+                goto out;
+        }
+        if (desc->num >= GNRC_IPV6_EXT_DESC_NUMOF) {
+            return -ENOBUFS;
+        }
+        if ((len - offset) < sizeof(ipv6_ext_t)) {
+            return -EBADMSG;
+        }
+        ext = (const ipv6_ext_t *)(data + offset);
+        ext_len = (ext->len * IPV6_EXT_LEN_UNIT) + IPV6_EXT_LEN_UNIT;
+        if ((len - offset) < ext_len) {
+            return -EBADMSG;
+        }
+        desc->hdrs[desc->num].offset = (uint16_t)offset;
+        desc->hdrs[desc->num].type = nh;
+        desc->num++;
+        nh = ext->nh;
+        offset += ext_len;
+    }
+out:
+    desc->len = (uint16_t)offset;
+    desc->nh = nh;
+    return 0;
+}
+
+ipv6_ext_t *gnrc_ipv6_ext_get(gnrc_pktsnip_t *pkt, uint8_t protnum)
+{
+    gnrc_pktsnip_t *exts[GNRC_IPV6_EXT_DESC_NUMOF];
+    unsigned num = 0;
+    uint8_t nh;
+
+    /* in a received packet the extension headers are between payload and
+     * IPv6 header in reverse order */
+    for (; (pkt != NULL) && (pkt->type != GNRC_NETTYPE_IPV6); pkt = pkt->next) {
+        if (pkt->type != GNRC_NETTYPE_IPV6_EXT) {
+            continue;
+        }
+        if (num >= GNRC_IPV6_EXT_DESC_NUMOF) {
+            return NULL;
+        }
+        exts[num++] = pkt;
+    }
+    if (pkt == NULL) {
+        return NULL;
+    }
+    nh = ((ipv6_hdr_t *)pkt->data)->nh;
+    while (num > 0) {
+        gnrc_ipv6_ext_desc_t desc;
+        gnrc_pktsnip_t *ext = exts[--num];
+
+        if (gnrc_ipv6_ext_parse(&desc, ext->data, ext->size, nh) < 0) {
+            return NULL;
+        }
+        for (unsigned i = 0; i < desc.num; i++) {
+            if (desc.hdrs[i].type == protnum) {
+                return (ipv6_ext_t *)(((uint8_t *)ext->data) +
+                                      desc.hdrs[i].offset);
+            }
+        }
+        nh = desc.nh;
+    }
+    return NULL;
+}
 
 /** @} */
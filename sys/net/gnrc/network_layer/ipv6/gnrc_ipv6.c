@@ -29,10 +29,20 @@
 
 #include "net/gnrc/ipv6/nib.h"
 #include "net/gnrc/netif/internal.h"
+#ifdef MODULE_GNRC_NETIF_GSO
+#include "net/gnrc/netif/gso.h"
+#endif
 #include "net/gnrc/ipv6/whitelist.h"
 #include "net/gnrc/ipv6/blacklist.h"
 
 #include "net/gnrc/ipv6.h"
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+#include "net/gnrc/rpl/sr_table.h"
+#include "net/ipv6/ext/rh.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -313,7 +323,12 @@ static void _send_to_iface(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 {
     assert(netif != NULL);
     ((gnrc_netif_hdr_t *)pkt->data)->if_pid = netif->pid;
+#ifdef MODULE_GNRC_NETIF_GSO
+    /* segments are cut later on, so only they need to fit the MTU */
+    if (gnrc_netif_gso_seg_len(pkt) > netif->ipv6.mtu) {
+#else
     if (gnrc_pkt_len(pkt->next) > netif->ipv6.mtu) {
+#endif
         DEBUG("ipv6: packet too big\n");
         gnrc_pktbuf_release(pkt);
         return;
@@ -322,6 +337,13 @@ static void _send_to_iface(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
     netif->ipv6.stats.tx_success++;
     netif->ipv6.stats.tx_bytes += gnrc_pkt_len(pkt->next);
 #endif
+#ifdef MODULE_NETSTATS_EXT
+    netstats_ext_tx(NETSTATS_EXT_LAYER_IPV6, gnrc_pkt_len(pkt->next));
+#endif
+#ifdef MODULE_GNRC_NETIF_TXQ
+    /* classify while the IPv6 header is still uncompressed */
+    gnrc_netif_hdr_set_txq_class(pkt->data, gnrc_netif_txq_classify(pkt));
+#endif
 
 #ifdef MODULE_GNRC_SIXLOWPAN
     if (gnrc_netif_is_6ln(netif)) {
@@ -333,7 +355,16 @@ static void _send_to_iface(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
         return;
     }
 #endif
-    if (gnrc_netapi_send(netif->pid, pkt) < 1) {
+    int res = gnrc_netapi_send(netif->pid, pkt);
+
+    if (res == 0) {
+        DEBUG("ipv6: unable to send packet, queue of interface is full\n");
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_L2, NETSTATS_EXT_DROP_QUEUE_FULL);
+#endif
+        gnrc_pktbuf_release_error(pkt, ENOBUFS);
+    }
+    else if (res < 0) {
         DEBUG("ipv6: unable to send packet\n");
         gnrc_pktbuf_release(pkt);
     }
@@ -362,6 +393,9 @@ static gnrc_pktsnip_t *_create_netif_hdr(uint8_t *dst_l2addr,
         gnrc_netif_hdr_t *netif_new = netif_hdr->data, *netif_old = pkt->data;
         netif_new->flags = netif_old->flags & \
                            ~(GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST);
+#ifdef MODULE_GNRC_NETIF_GSO
+        netif_new->gso_size = netif_old->gso_size;
+#endif
         DEBUG("ipv6: removed old interface header\n");
         pkt = gnrc_pktbuf_remove_snip(pkt, pkt);
     }
@@ -389,7 +423,7 @@ static void _send_unicast(gnrc_netif_t *netif, uint8_t *dst_l2addr,
 }
 
 static int _fill_ipv6_hdr(gnrc_netif_t *netif, gnrc_pktsnip_t *ipv6,
-                          gnrc_pktsnip_t *payload)
+                          gnrc_pktsnip_t *payload, bool csum)
 {
     int res;
     ipv6_hdr_t *hdr = ipv6->data;
@@ -436,6 +470,11 @@ static int _fill_ipv6_hdr(gnrc_netif_t *netif, gnrc_pktsnip_t *ipv6,
         }
     }
 
+    if (!csum) {
+        /* checksum is calculated later on, e.g. per GSO segment */
+        return 0;
+    }
+
     DEBUG("ipv6: calculate checksum for upper header.\n");
 
     if ((res = gnrc_netreg_calc_csum(payload, ipv6)) < 0) {
@@ -513,7 +552,7 @@ static void _send_multicast(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
                     ptr = ptr->next;
                 }
 
-                if (_fill_ipv6_hdr(netif, ipv6, tmp) < 0) {
+                if (_fill_ipv6_hdr(netif, ipv6, tmp, true) < 0) {
                     /* error on filling up header */
                     gnrc_pktbuf_release(ipv6);
                     return;
@@ -529,7 +568,7 @@ static void _send_multicast(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
     }
     else {
         if (prep_hdr) {
-            if (_fill_ipv6_hdr(netif, ipv6, payload) < 0) {
+            if (_fill_ipv6_hdr(netif, ipv6, payload, true) < 0) {
                 /* error on filling up header */
                 gnrc_pktbuf_release(pkt);
                 return;
@@ -550,7 +589,7 @@ static void _send_multicast(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
     }
 
     if (prep_hdr) {
-        if (_fill_ipv6_hdr(netif, ipv6, payload) < 0) {
+        if (_fill_ipv6_hdr(netif, ipv6, payload, true) < 0) {
             /* error on filling up header */
             gnrc_pktbuf_release(pkt);
             return;
@@ -561,11 +600,114 @@ static void _send_multicast(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt,
 #endif  /* GNRC_NETIF_NUMOF */
 }
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+/**
+ * @brief   Looks up the source route to the destination of a packet, as RPL
+ *          root in non-storing mode
+ *
+ * @param[in] hdr           IPv6 header of the packet.
+ * @param[out] first_hop    First hop towards the destination.
+ * @param[out] srh          Source routing header to insert, NULL if the
+ *                          destination is a child of the root.
+ *
+ * @return  true, if the packet is source routed via @p first_hop.
+ * @return  false, if the packet is routed as usual.
+ */
+static bool _sr_table_route(const ipv6_hdr_t *hdr, ipv6_addr_t *first_hop,
+                            gnrc_pktsnip_t **srh)
+{
+    int depth;
+
+    *srh = NULL;
+    /* only a non-storing root has routes, inserting the header behind
+     * hop-by-hop options or a second routing header is not supported */
+    if ((gnrc_rpl_sr_table_numof() == 0) ||
+        (hdr->nh == PROTNUM_IPV6_EXT_HOPOPT) ||
+        (hdr->nh == PROTNUM_IPV6_EXT_RH) ||
+        ((depth = gnrc_rpl_sr_table_depth(&hdr->dst)) < 0)) {
+        return false;
+    }
+    if (depth == 1) {
+        *first_hop = hdr->dst;
+        return true;
+    }
+
+    int res;
+
+    *srh = gnrc_pktbuf_add(NULL, NULL, GNRC_RPL_SR_TABLE_SRH_LEN(depth),
+                           GNRC_NETTYPE_IPV6_EXT);
+    if (*srh == NULL) {
+        DEBUG("ipv6: unable to allocate source routing header\n");
+        return false;
+    }
+    res = gnrc_rpl_sr_table_srh(&hdr->dst, first_hop, (*srh)->data,
+                                (*srh)->size);
+    if (res <= 0) {
+        /* the route changed in between */
+        gnrc_pktbuf_release(*srh);
+        *srh = NULL;
+        return false;
+    }
+    gnrc_pktbuf_realloc_data(*srh, res);
+    return true;
+}
+
+/**
+ * @brief   Tunnels a forwarded packet to its destination with a source
+ *          routing header (IPv6-in-IPv6)
+ *
+ * A router must not insert headers into a packet it did not originate
+ * (RFC 6554, section 4 and RFC 8200, section 4), so the header goes into an
+ * outer IPv6 header from the root instead.
+ *
+ * @param[in] netif         Interface the packet is sent over.
+ * @param[in] ipv6          IPv6 header of the forwarded packet.
+ * @param[in] srh           Source routing header.
+ * @param[in] first_hop     First hop towards the destination.
+ *
+ * @return  The outer IPv6 header, followed by @p srh and @p ipv6.
+ * @return  NULL, if no source address or no space in the packet buffer was
+ *          available. Neither @p srh nor @p ipv6 are released then.
+ */
+static gnrc_pktsnip_t *_sr_table_encap(gnrc_netif_t *netif,
+                                       gnrc_pktsnip_t *ipv6,
+                                       gnrc_pktsnip_t *srh,
+                                       const ipv6_addr_t *first_hop)
+{
+    ipv6_hdr_t *hdr = ipv6->data;
+    ipv6_addr_t *src = gnrc_netif_ipv6_addr_best_src(netif, &hdr->dst, false);
+    gnrc_pktsnip_t *outer;
+
+    if (src == NULL) {
+        DEBUG("ipv6: no source address to tunnel forwarded packet\n");
+        return NULL;
+    }
+    outer = gnrc_ipv6_hdr_build(NULL, src, first_hop);
+    if (outer == NULL) {
+        DEBUG("ipv6: unable to allocate outer header\n");
+        return NULL;
+    }
+    ((ipv6_ext_rh_t *)srh->data)->nh = PROTNUM_IPV6;
+    srh->next = ipv6;
+    outer->next = srh;
+    hdr = outer->data;
+    hdr->nh = PROTNUM_IPV6_EXT_RH;
+    hdr->hl = netif->cur_hl;
+    hdr->len = byteorder_htons(gnrc_pkt_len(srh));
+    return outer;
+}
+#endif
+
 static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
 {
     gnrc_netif_t *netif = NULL;
     gnrc_pktsnip_t *ipv6, *payload;
     ipv6_hdr_t *hdr;
+#ifdef MODULE_GNRC_NETIF_GSO
+    bool gso = (gnrc_netif_gso_size(pkt) > 0);
+#else
+    const bool gso = false;
+#endif
     /* get IPv6 snip and (if present) generic interface header */
     if (pkt->type == GNRC_NETTYPE_NETIF) {
         /* If there is already a netif header (routing protocols and
@@ -617,7 +759,7 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
             gnrc_pktsnip_t *ptr = ipv6, *rcv_pkt;
 
             if (prep_hdr) {
-                if (_fill_ipv6_hdr(tmp_netif, ipv6, payload) < 0) {
+                if (_fill_ipv6_hdr(tmp_netif, ipv6, payload, true) < 0) {
                     /* error on filling up header */
                     gnrc_pktbuf_release(pkt);
                     return;
@@ -653,21 +795,83 @@ static void _send(gnrc_pktsnip_t *pkt, bool prep_hdr)
         }
         else {
             gnrc_ipv6_nib_nc_t nce;
+            ipv6_addr_t *next_dst = &hdr->dst;
+            int res;
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+            gnrc_pktsnip_t *srh = NULL;
+            ipv6_addr_t first_hop, first_hop_ll;
+
+            /* as RPL root in non-storing mode, source route own packets and
+             * tunnel forwarded ones down the DODAG */
+            if (!gso && _sr_table_route(hdr, &first_hop, &srh)) {
+                /* the first hop is a neighbor, reach it by its link-local
+                 * address */
+                ipv6_addr_set_link_local_prefix(&first_hop_ll);
+                ipv6_addr_init_iid(&first_hop_ll, &first_hop.u8[8], 64);
+                next_dst = &first_hop_ll;
+            }
+#endif
 
-            if (gnrc_ipv6_nib_get_next_hop_l2addr(&hdr->dst, netif, pkt,
-                                                  &nce) < 0) {
+            if ((res = gnrc_ipv6_nib_get_next_hop_l2addr(next_dst, netif, pkt,
+                                                         &nce)) < 0) {
                 /* packet is released by NIB */
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+                if (srh != NULL) {
+                    gnrc_pktbuf_release(srh);
+                }
+#endif
+#ifdef MODULE_NETSTATS_EXT
+                if (res == -ENETUNREACH) {
+                    netstats_ext_drop(NETSTATS_EXT_LAYER_IPV6,
+                                      NETSTATS_EXT_DROP_NO_ROUTE);
+                }
+#else
+                (void)res;
+#endif
                 return;
             }
             netif = gnrc_netif_get_by_pid(gnrc_ipv6_nib_nc_get_iface(&nce));
             assert(netif != NULL);
             if (prep_hdr) {
-                if (_fill_ipv6_hdr(netif, ipv6, payload) < 0) {
+                if (_fill_ipv6_hdr(netif, ipv6, payload, !gso) < 0) {
                     /* error on filling up header */
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+                    if (srh != NULL) {
+                        gnrc_pktbuf_release(srh);
+                    }
+#endif
+                    gnrc_pktbuf_release(pkt);
+                    return;
+                }
+            }
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+            if ((srh != NULL) && !prep_hdr) {
+                gnrc_pktsnip_t *outer = _sr_table_encap(netif, ipv6, srh,
+                                                        &first_hop);
+
+                if (outer == NULL) {
+                    gnrc_pktbuf_release(srh);
                     gnrc_pktbuf_release(pkt);
                     return;
                 }
+                if (pkt == ipv6) {
+                    pkt = outer;
+                }
+                else {
+                    pkt->next = outer;
+                }
             }
+            else if (srh != NULL) {
+                /* the checksum was calculated for the final destination, the
+                 * header goes in between */
+                ((ipv6_ext_rh_t *)srh->data)->nh = hdr->nh;
+                hdr->nh = PROTNUM_IPV6_EXT_RH;
+                hdr->len = byteorder_htons(byteorder_ntohs(hdr->len) + srh->size);
+                hdr->dst = first_hop;
+                srh->next = payload;
+                ipv6->next = srh;
+            }
+#endif
 
             _send_unicast(netif, nce.l2addr,
                           nce.l2addr_len, pkt);
@@ -699,6 +903,11 @@ static void _receive(gnrc_pktsnip_t *pkt)
 
     assert(pkt != NULL);
 
+#ifdef MODULE_NETSTATS_EXT
+    netstats_ext_latency(NETSTATS_EXT_LAYER_IPV6, pkt->rx_time);
+    netstats_ext_rx(NETSTATS_EXT_LAYER_IPV6, gnrc_pkt_len(pkt));
+#endif
+
     netif_hdr = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
 
     if (netif_hdr != NULL) {
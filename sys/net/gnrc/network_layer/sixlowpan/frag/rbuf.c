@@ -22,6 +22,9 @@
 #include "net/gnrc/sixlowpan.h"
 #include "net/gnrc/sixlowpan/frag.h"
 #include "net/sixlowpan.h"
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
 #include "thread.h"
 #include "xtimer.h"
 #include "utlist.h"
@@ -88,6 +91,12 @@ void rbuf_add(gnrc_netif_hdr_t *netif_hdr, gnrc_pktsnip_t *pkt,
         DEBUG("6lo rbuf: reassembly buffer full.\n");
         return;
     }
+#ifdef MODULE_NETSTATS_EXT
+    /* datagram was received when its first fragment arrived */
+    if (entry->pkt->rx_time == 0) {
+        entry->pkt->rx_time = pkt->rx_time;
+    }
+#endif
 
     ptr = entry->ints;
 
@@ -306,6 +315,9 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
         assert(oldest != NULL);
         assert(oldest->pkt != NULL); /* if oldest->pkt == NULL, res must not be NULL */
         DEBUG("6lo rfrag: reassembly buffer full, remove oldest entry\n");
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_6LO, NETSTATS_EXT_DROP_RBUF_FULL);
+#endif
         gnrc_pktbuf_release(oldest->pkt);
         _rbuf_rem(oldest);
         res = oldest;
@@ -316,6 +328,10 @@ static rbuf_t *_rbuf_get(const void *src, size_t src_len,
     res->pkt = gnrc_pktbuf_add(NULL, NULL, size, GNRC_NETTYPE_IPV6);
     if (res->pkt == NULL) {
         DEBUG("6lo rfrag: can not allocate reassembly buffer space.\n");
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_6LO,
+                          NETSTATS_EXT_DROP_PKTBUF_FULL);
+#endif
         return NULL;
     }
 
@@ -22,7 +22,14 @@
 #include "net/gnrc/sixlowpan/frag.h"
 #include "net/gnrc/sixlowpan/iphc.h"
 #include "net/gnrc/netif.h"
+#ifdef MODULE_GNRC_NETIF_GSO
+#include "net/gnrc/netif/gso.h"
+#include "net/gnrc/pktqueue.h"
+#endif
 #include "net/sixlowpan.h"
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -38,6 +45,17 @@ static kernel_pid_t _pid = KERNEL_PID_UNDEF;
 static gnrc_sixlowpan_msg_frag_t fragment_msg = {KERNEL_PID_UNDEF, NULL, 0, 0};
 #endif
 
+#ifdef MODULE_GNRC_NETIF_GSO
+/* packet currently segmented and offset of its next segment */
+static struct {
+    gnrc_pktsnip_t *pkt;
+    size_t offset;
+} _gso = { NULL, 0 };
+/* packets waiting for the current one to be segmented */
+static gnrc_pktqueue_t _gso_nodes[GNRC_SIXLOWPAN_GSO_QUEUE_SIZE];
+static gnrc_pktqueue_t *_gso_queue = NULL;
+#endif
+
 #if ENABLE_DEBUG
 static char _stack[GNRC_SIXLOWPAN_STACK_SIZE + THREAD_EXTRA_STACKSIZE_PRINTF];
 #else
@@ -49,6 +67,10 @@ static char _stack[GNRC_SIXLOWPAN_STACK_SIZE];
 static void _receive(gnrc_pktsnip_t *pkt);
 /* handles GNRC_NETAPI_MSG_TYPE_SND commands */
 static void _send(gnrc_pktsnip_t *pkt);
+#ifdef MODULE_GNRC_NETIF_GSO
+/* sends the segments of the current packet, as far as possible */
+static void _gso_send(void);
+#endif
 /* Main event loop for 6LoWPAN */
 static void *_event_loop(void *args);
 
@@ -98,10 +120,18 @@ void gnrc_sixlowpan_dispatch_send(gnrc_pktsnip_t *pkt, void *context,
     (void)page;
     assert(pkt->type == GNRC_NETTYPE_NETIF);
     gnrc_netif_hdr_t *hdr = pkt->data;
-    if (gnrc_netapi_send(hdr->if_pid, pkt) < 1) {
+    int res = gnrc_netapi_send(hdr->if_pid, pkt);
+
+    if (res < 1) {
         DEBUG("6lo: unable to send %p over interface %u\n", (void *)pkt,
               hdr->if_pid);
-        gnrc_pktbuf_release(pkt);
+        /* only a full queue is worth reporting to the sender */
+        if (res == 0) {
+            gnrc_pktbuf_release_error(pkt, ENOBUFS);
+        }
+        else {
+            gnrc_pktbuf_release(pkt);
+        }
     }
 }
 
@@ -110,12 +140,19 @@ static void _receive(gnrc_pktsnip_t *pkt)
     gnrc_pktsnip_t *payload;
     uint8_t *dispatch;
 
+#ifdef MODULE_NETSTATS_EXT
+    netstats_ext_latency(NETSTATS_EXT_LAYER_6LO, pkt->rx_time);
+#endif
     /* seize payload as a temporary variable */
     payload = gnrc_pktbuf_start_write(pkt); /* need to duplicate since pkt->next
                                              * might get replaced */
 
     if (payload == NULL) {
         DEBUG("6lo: can not get write access on received packet\n");
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_6LO,
+                          NETSTATS_EXT_DROP_PKTBUF_FULL);
+#endif
 #if defined(DEVELHELP) && ENABLE_DEBUG
         gnrc_pktbuf_stats();
 #endif
@@ -246,6 +283,29 @@ static void _send(gnrc_pktsnip_t *pkt)
         return;
     }
 
+#ifdef MODULE_GNRC_NETIF_GSO
+    if (gnrc_netif_gso_size(pkt) > 0) {
+        if (_gso.pkt != NULL) {
+            DEBUG("6lo: Segmentation already ongoing. Deferring packet\n");
+            for (unsigned i = 0; i < GNRC_SIXLOWPAN_GSO_QUEUE_SIZE; i++) {
+                if (_gso_nodes[i].pkt == NULL) {
+                    _gso_nodes[i].pkt = pkt;
+                    gnrc_pktqueue_add(&_gso_queue, &_gso_nodes[i]);
+                    return;
+                }
+            }
+            gnrc_pktbuf_release_error(pkt, ENOBUFS);
+            return;
+        }
+        /* segment before header compression, so every segment is
+         * compressed and (if needed) fragmented on its own */
+        _gso.pkt = pkt;
+        _gso.offset = 0;
+        _gso_send();
+        return;
+    }
+#endif
+
     pkt2 = gnrc_pktbuf_start_write(pkt);
 
     if (pkt2 == NULL) {
@@ -340,6 +400,46 @@ static void _send(gnrc_pktsnip_t *pkt)
 #endif
 }
 
+#ifdef MODULE_GNRC_NETIF_GSO
+/*
+ * Only one datagram can be fragmented at a time, so this stops at a segment
+ * that needs fragmentation and is called again once its last fragment is
+ * sent.
+ */
+static void _gso_send(void)
+{
+    while (_gso.pkt != NULL) {
+        size_t offset = _gso.offset;
+        gnrc_pktqueue_t *node;
+        gnrc_pktsnip_t *seg;
+
+#ifdef MODULE_GNRC_SIXLOWPAN_FRAG
+        if (fragment_msg.pkt != NULL) {
+            return;
+        }
+#endif
+        if ((seg = gnrc_netif_gso_next(_gso.pkt, &_gso.offset)) != NULL) {
+            _send(seg);
+            continue;
+        }
+        if (offset == 0) {
+            DEBUG("6lo: unable to segment packet\n");
+            gnrc_pktbuf_release_error(_gso.pkt, ENOBUFS);
+        }
+        else {
+            gnrc_pktbuf_release(_gso.pkt);
+        }
+        /* go on with the next packet waiting */
+        _gso.pkt = NULL;
+        _gso.offset = 0;
+        if ((node = gnrc_pktqueue_remove_head(&_gso_queue)) != NULL) {
+            _gso.pkt = node->pkt;
+            node->pkt = NULL;
+        }
+    }
+}
+#endif
+
 static void *_event_loop(void *args)
 {
     msg_t msg, reply, msg_q[GNRC_SIXLOWPAN_MSG_QUEUE_SIZE];
@@ -381,6 +481,12 @@ static void *_event_loop(void *args)
             case GNRC_SIXLOWPAN_MSG_FRAG_SND:
                 DEBUG("6lo: send fragmented event received\n");
                 gnrc_sixlowpan_frag_send(msg.content.ptr);
+#ifdef MODULE_GNRC_NETIF_GSO
+                /* the segment was sent completely or dropped */
+                if (fragment_msg.pkt == NULL) {
+                    _gso_send();
+                }
+#endif
                 break;
 #endif
 
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#include "irq.h"
+#include "mutex.h"
+#include "thread.h"
+#include "tsrb.h"
+#include "xtimer.h"
+#include "net/gnrc/netif.h"
+
+#ifdef CPU_NATIVE
+#include "native_internal.h"
+#else
+#include "vfs.h"
+#endif
+
+#include "net/gnrc/pktcapture.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/**
+ * @name    pcapng block types and options
+ * @see     https://github.com/pcapng/pcapng
+ * @{
+ */
+#define _SHB_TYPE           (0x0a0d0d0aUL)
+#define _SHB_MAGIC          (0x1a2b3c4dUL)
+#define _IDB_TYPE           (0x00000001UL)
+#define _EPB_TYPE           (0x00000006UL)
+#define _EPB_FLAGS_CODE     (2U)
+#define _EPB_FLAGS_IN       (0x1UL)
+#define _EPB_FLAGS_OUT      (0x2UL)
+/** @} */
+
+/**
+ * @brief   Length of an enhanced packet block without packet data
+ *
+ * 7 words of header, 3 words of options (epb_flags and opt_endofopt) and
+ * 1 word of trailing block length
+ */
+#define _EPB_LEN            (11U * sizeof(uint32_t))
+
+#define _WORDS(len)         (((len) + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+
+/**
+ * @brief   Header of a frame in the ring buffer, followed by
+ *          _record_t::caplen bytes of the frame
+ */
+typedef struct {
+    uint64_t time;          /**< capture time in microseconds */
+    uint32_t len;           /**< length of the frame */
+    uint16_t caplen;        /**< number of bytes captured */
+    uint16_t linktype;      /**< link type of the frame */
+    kernel_pid_t if_pid;    /**< interface of the frame */
+    uint8_t tx;             /**< frame was sent */
+} _record_t;
+
+static char _buf[GNRC_PKTCAPTURE_BUFSIZE];
+static tsrb_t _rb = TSRB_INIT(_buf);
+/* unlocked by producers, so the writer never misses a wakeup */
+static mutex_t _wakeup = MUTEX_INIT_LOCKED;
+static volatile bool _active;
+static volatile unsigned _dropped;
+static int _fd = -1;
+static kernel_pid_t _ifs[GNRC_NETIF_NUMOF];
+static unsigned _ifs_numof;
+static uint32_t _block[_WORDS(_EPB_LEN + GNRC_PKTCAPTURE_SNAPLEN)];
+static char _stack[GNRC_PKTCAPTURE_STACKSIZE];
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+
+#ifdef CPU_NATIVE
+static int _file_open(const char *path)
+{
+    int res;
+
+    _native_syscall_enter();
+    res = real_open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (res < 0) {
+        res = -errno;
+    }
+    _native_syscall_leave();
+    return res;
+}
+
+static int _file_write(int fd, const void *data, size_t len)
+{
+    ssize_t res;
+
+    _native_syscall_enter();
+    res = real_write(fd, data, len);
+    if (res < 0) {
+        res = -errno;
+    }
+    _native_syscall_leave();
+    return (int)res;
+}
+
+static void _file_close(int fd)
+{
+    _native_syscall_enter();
+    real_close(fd);
+    _native_syscall_leave();
+}
+#else
+static int _file_open(const char *path)
+{
+    return vfs_open(path, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+}
+
+static int _file_write(int fd, const void *data, size_t len)
+{
+    return vfs_write(fd, data, len);
+}
+
+static void _file_close(int fd)
+{
+    vfs_close(fd);
+}
+#endif
+
+static int _write_block(int fd, const uint32_t *block)
+{
+    /* block length is the second word of every block */
+    int res = _file_write(fd, block, block[1]);
+
+    return ((res < 0) || ((uint32_t)res == block[1])) ? res : -EIO;
+}
+
+static int _write_shb(int fd)
+{
+    const uint32_t shb[] = {
+        _SHB_TYPE, 7 * sizeof(uint32_t), _SHB_MAGIC,
+        1U,                     /* major version 1, minor version 0 */
+        UINT32_MAX, UINT32_MAX, /* section length unknown */
+        7 * sizeof(uint32_t),
+    };
+
+    return _write_block(fd, shb);
+}
+
+static int _if_id(const _record_t *rec)
+{
+    uint32_t idb[] = {
+        _IDB_TYPE, 5 * sizeof(uint32_t),
+        rec->linktype,          /* link type, reserved */
+        GNRC_PKTCAPTURE_SNAPLEN,
+        5 * sizeof(uint32_t),
+    };
+    int res;
+
+    for (unsigned i = 0; i < _ifs_numof; i++) {
+        if (_ifs[i] == rec->if_pid) {
+            return i;
+        }
+    }
+    if (_ifs_numof >= GNRC_NETIF_NUMOF) {
+        return -ENOMEM;
+    }
+    if ((res = _write_block(_fd, idb)) < 0) {
+        return res;
+    }
+    _ifs[_ifs_numof] = rec->if_pid;
+    return _ifs_numof++;
+}
+
+static int _write_epb(const _record_t *rec)
+{
+    uint32_t *opts;
+    unsigned words = _WORDS(rec->caplen);
+    int if_id;
+
+    if (words > 0) {
+        /* zero padding of packet data */
+        _block[7 + words - 1] = 0;
+    }
+    /* take frame from ring first, so it is consumed on errors, too */
+    tsrb_get(&_rb, (char *)&_block[7], rec->caplen);
+    if ((if_id = _if_id(rec)) < 0) {
+        return if_id;
+    }
+    _block[0] = _EPB_TYPE;
+    _block[1] = _EPB_LEN + (words * sizeof(uint32_t));
+    _block[2] = if_id;
+    _block[3] = (uint32_t)(rec->time >> 32);
+    _block[4] = (uint32_t)rec->time;
+    _block[5] = rec->caplen;
+    _block[6] = rec->len;
+    opts = &_block[7 + words];
+    opts[0] = _EPB_FLAGS_CODE | (sizeof(uint32_t) << 16);
+    opts[1] = (rec->tx) ? _EPB_FLAGS_OUT : _EPB_FLAGS_IN;
+    opts[2] = 0;                /* opt_endofopt */
+    opts[3] = _block[1];
+    return _write_block(_fd, _block);
+}
+
+static void *_writer(void *arg)
+{
+    (void)arg;
+    while (1) {
+        _record_t rec;
+
+        mutex_lock(&_wakeup);
+        /* producers add records with interrupts disabled, so a record is
+         * always complete once its header is in the ring */
+        while (tsrb_avail(&_rb) >= sizeof(rec)) {
+            tsrb_get(&_rb, (char *)&rec, sizeof(rec));
+            if (_fd < 0) {
+                /* drop leftovers of a failed capture */
+                tsrb_get(&_rb, (char *)_block, rec.caplen);
+                continue;
+            }
+            if (_write_epb(&rec) < 0) {
+                DEBUG("gnrc_pktcapture: unable to write capture file\n");
+                _active = false;
+                _file_close(_fd);
+                _fd = -1;
+            }
+        }
+        if (!_active && (_fd >= 0)) {
+            _file_close(_fd);
+            _fd = -1;
+        }
+    }
+    return NULL;
+}
+
+void gnrc_pktcapture_init(void)
+{
+    if (_pid > KERNEL_PID_UNDEF) {
+        return;
+    }
+    _pid = thread_create(_stack, sizeof(_stack), GNRC_PKTCAPTURE_PRIO,
+                         THREAD_CREATE_STACKTEST, _writer, NULL,
+                         "pktcapture");
+#ifdef GNRC_PKTCAPTURE_AUTO_FILE
+    if (gnrc_pktcapture_start(GNRC_PKTCAPTURE_AUTO_FILE) < 0) {
+        DEBUG("gnrc_pktcapture: unable to open %s\n",
+              GNRC_PKTCAPTURE_AUTO_FILE);
+    }
+#endif
+}
+
+int gnrc_pktcapture_start(const char *path)
+{
+    int fd, res;
+
+    if (_active || (_fd >= 0)) {
+        return -EBUSY;
+    }
+    if ((fd = _file_open(path)) < 0) {
+        return fd;
+    }
+    if ((res = _write_shb(fd)) < 0) {
+        _file_close(fd);
+        return res;
+    }
+    _ifs_numof = 0;
+    _dropped = 0;
+    _fd = fd;
+    _active = true;
+    return 0;
+}
+
+void gnrc_pktcapture_stop(void)
+{
+    _active = false;
+    mutex_unlock(&_wakeup);
+}
+
+void gnrc_pktcapture_add(kernel_pid_t if_pid, uint16_t linktype, bool tx,
+                         const iolist_t *frame)
+{
+    _record_t rec;
+    size_t left;
+    unsigned state;
+
+    if (!_active) {
+        return;
+    }
+    rec.time = xtimer_now_usec64();
+    rec.len = iolist_size(frame);
+    rec.caplen = (rec.len < GNRC_PKTCAPTURE_SNAPLEN) ? rec.len
+                                                     : GNRC_PKTCAPTURE_SNAPLEN;
+    rec.linktype = linktype;
+    rec.if_pid = if_pid;
+    rec.tx = tx;
+    /* serialize interfaces with each other; the writer does not lock */
+    state = irq_disable();
+    if (tsrb_free(&_rb) < (sizeof(rec) + rec.caplen)) {
+        _dropped++;
+        irq_restore(state);
+        return;
+    }
+    tsrb_add(&_rb, (char *)&rec, sizeof(rec));
+    left = rec.caplen;
+    for (; (frame != NULL) && (left > 0); frame = frame->iol_next) {
+        size_t len = (frame->iol_len < left) ? frame->iol_len : left;
+
+        tsrb_add(&_rb, frame->iol_base, len);
+        left -= len;
+    }
+    irq_restore(state);
+    mutex_unlock(&_wakeup);
+}
+
+unsigned gnrc_pktcapture_dropped(void)
+{
+    return _dropped;
+}
+
+/** @} */
@@ -19,12 +19,20 @@
 #include "net/gnrc/netif/internal.h"
 #include "net/gnrc.h"
 #include "mutex.h"
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+#include "bitarithm.h"
+#include "kernel_defines.h"
+#include "gnrc_rpl_internal/redundancy.h"
+#endif
 
 #include "net/gnrc/rpl.h"
 #ifdef MODULE_GNRC_RPL_P2P
 #include "net/gnrc/rpl/p2p.h"
 #include "net/gnrc/rpl/p2p_dodag.h"
 #endif
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+#include "net/gnrc/rpl/sr_table.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -196,6 +204,31 @@ static void _receive(gnrc_pktsnip_t *icmpv6)
     gnrc_pktbuf_release(icmpv6);
 }
 
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+static void _adapt_redundancy(gnrc_rpl_dodag_t *dodag)
+{
+    uint32_t srcs;
+    unsigned neighbors, k;
+
+    gnrc_rpl_dio_srcs_update(dodag);
+    srcs = dodag->dio_srcs | dodag->dio_srcs_last;
+    neighbors = bitarithm_bits_set(srcs & 0xffff) +
+                bitarithm_bits_set(srcs >> 16);
+    k = (neighbors + GNRC_RPL_DIO_REDUNDANCY_NEIGHBORS - 1) /
+        GNRC_RPL_DIO_REDUNDANCY_NEIGHBORS;
+
+    if (k < GNRC_RPL_DIO_REDUNDANCY_MIN) {
+        k = GNRC_RPL_DIO_REDUNDANCY_MIN;
+    }
+    /* a redundancy constant of 0 disables suppression */
+    if ((dodag->dio_redun == 0) || (k > dodag->dio_redun)) {
+        k = dodag->dio_redun;
+    }
+    DEBUG("RPL: %u neighbors, redundancy constant %u\n", neighbors, k);
+    dodag->trickle.k = k;
+}
+#endif
+
 static void *_event_loop(void *args)
 {
     msg_t msg, reply;
@@ -221,6 +254,10 @@ static void *_event_loop(void *args)
                 DEBUG("RPL: GNRC_RPL_MSG_TYPE_TRICKLE_MSG received\n");
                 trickle = msg.content.ptr;
                 if (trickle && (trickle->callback.func != NULL)) {
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+                    _adapt_redundancy(container_of(trickle, gnrc_rpl_dodag_t,
+                                                   trickle));
+#endif
                     trickle_callback(trickle);
                 }
                 break;
@@ -279,6 +316,13 @@ void _update_lifetime(void)
                 }
             }
 
+            /* link metrics change without the parents advertising anything
+             * new, so reevaluate the parents periodically */
+            if ((inst->dodag.parents != NULL) &&
+                (inst->of->update_metrics != NULL)) {
+                gnrc_rpl_parent_update(&inst->dodag, NULL);
+            }
+
             if (inst->dodag.dao_time > GNRC_RPL_LIFETIME_UPDATE_STEP) {
                 inst->dodag.dao_time -= GNRC_RPL_LIFETIME_UPDATE_STEP;
             }
@@ -288,6 +332,10 @@ void _update_lifetime(void)
         }
     }
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+    gnrc_rpl_sr_table_timeout(GNRC_RPL_LIFETIME_UPDATE_STEP);
+#endif
+
 #ifdef MODULE_GNRC_RPL_P2P
     gnrc_rpl_p2p_update();
 #endif
@@ -32,6 +32,9 @@
 #ifndef GNRC_RPL_WITHOUT_VALIDATION
 #include "gnrc_rpl_internal/validation.h"
 #endif
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+#include "gnrc_rpl_internal/redundancy.h"
+#endif
 
 #ifdef MODULE_GNRC_RPL_P2P
 #include "net/gnrc/rpl/p2p_structs.h"
@@ -39,6 +42,10 @@
 #include "net/gnrc/rpl/p2p.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+#include "net/gnrc/rpl/sr_table.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -161,9 +168,31 @@ static bool _get_pl_entry(unsigned iface, ipv6_addr_t *pfx,
     return false;
 }
 
-gnrc_pktsnip_t *_dio_prefix_info_build(gnrc_pktsnip_t *pkt, gnrc_rpl_dodag_t *dodag)
+/* sets the remaining lifetimes of the prefix */
+static bool _prefix_info_lifetimes(gnrc_rpl_opt_prefix_info_t *prefix_info,
+                                   gnrc_rpl_dodag_t *dodag)
 {
     gnrc_ipv6_nib_pl_t ple;
+
+    if (!_get_pl_entry(dodag->iface, &dodag->dodag_id, prefix_info->prefix_len,
+                       &ple)) {
+        DEBUG("RPL: Prefix of DODAG-ID not in prefix list\n");
+        return false;
+    }
+
+    uint32_t now = (xtimer_now_usec64() / US_PER_MS) & UINT32_MAX;
+    uint32_t valid_ltime = (ple.valid_until < UINT32_MAX) ?
+                           (ple.valid_until - now) / MS_PER_SEC : UINT32_MAX;
+    uint32_t pref_ltime = (ple.pref_until < UINT32_MAX) ?
+                          (ple.pref_until - now) / MS_PER_SEC : UINT32_MAX;
+
+    prefix_info->valid_lifetime = byteorder_htonl(valid_ltime);
+    prefix_info->pref_lifetime = byteorder_htonl(pref_ltime);
+    return true;
+}
+
+gnrc_pktsnip_t *_dio_prefix_info_build(gnrc_pktsnip_t *pkt, gnrc_rpl_dodag_t *dodag)
+{
     gnrc_rpl_opt_prefix_info_t *prefix_info;
     gnrc_pktsnip_t *opt_snip;
 
@@ -179,20 +208,8 @@ gnrc_pktsnip_t *_dio_prefix_info_build(gnrc_pktsnip_t *pkt, gnrc_rpl_dodag_t *do
     /* auto-address configuration */
     prefix_info->LAR_flags = GNRC_RPL_PREFIX_AUTO_ADDRESS_BIT;
     prefix_info->prefix_len = 64;
-    if (_get_pl_entry(dodag->iface, &dodag->dodag_id, prefix_info->prefix_len,
-                      &ple)) {
-        uint32_t now = (xtimer_now_usec64() / US_PER_MS) & UINT32_MAX;
-        uint32_t valid_ltime = (ple.valid_until < UINT32_MAX) ?
-                               (ple.valid_until - now) / MS_PER_SEC : UINT32_MAX;
-        uint32_t pref_ltime = (ple.pref_until < UINT32_MAX) ?
-                              (ple.pref_until - now) / MS_PER_SEC : UINT32_MAX;
-
-        prefix_info->valid_lifetime = byteorder_htonl(valid_ltime);
-        prefix_info->pref_lifetime = byteorder_htonl(pref_ltime);
-    }
-    else {
-        DEBUG("RPL: Prefix of DODAG-ID not in prefix list\n");
-        gnrc_pktbuf_release(pkt);
+    if (!_prefix_info_lifetimes(prefix_info, dodag)) {
+        gnrc_pktbuf_release(opt_snip);
         return NULL;
     }
     prefix_info->reserved = 0;
@@ -204,40 +221,39 @@ gnrc_pktsnip_t *_dio_prefix_info_build(gnrc_pktsnip_t *pkt, gnrc_rpl_dodag_t *do
 }
 #endif
 
-void gnrc_rpl_send_DIO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination)
+static void _dio_fill(gnrc_rpl_dio_t *dio, gnrc_rpl_instance_t *inst)
 {
-    if (inst == NULL) {
-        DEBUG("RPL: Error - trying to send DIO without being part of a dodag.\n");
-        return;
-    }
-
     gnrc_rpl_dodag_t *dodag = &inst->dodag;
-    gnrc_pktsnip_t *pkt = NULL, *tmp;
-    gnrc_rpl_dio_t *dio;
 
-#ifdef MODULE_GNRC_RPL_P2P
-    gnrc_rpl_p2p_ext_t *p2p_ext = gnrc_rpl_p2p_ext_get(dodag);
-    if (dodag->instance->mop == GNRC_RPL_P2P_MOP) {
-        if (!p2p_ext->for_me) {
-            if ((pkt = gnrc_rpl_p2p_rdo_build(pkt, p2p_ext)) == NULL) {
-                return;
-            }
-        }
-        dodag->dio_opts &= ~GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
-    }
-#endif
+    dio->instance_id = inst->id;
+    dio->version_number = dodag->version;
+    /* a leaf node announces an INFINITE_RANK */
+    dio->rank = ((dodag->node_status == GNRC_RPL_LEAF_NODE) ?
+                 byteorder_htons(GNRC_RPL_INFINITE_RANK) : byteorder_htons(dodag->my_rank));
+    dio->g_mop_prf = (dodag->grounded << GNRC_RPL_GROUNDED_SHIFT) |
+                     (inst->mop << GNRC_RPL_MOP_SHIFT) | dodag->prf;
+    dio->dtsn = dodag->dtsn;
+    dio->flags = 0;
+    dio->reserved = 0;
+    dio->dodag_id = dodag->dodag_id;
+}
+
+static gnrc_pktsnip_t *_dio_build(gnrc_rpl_instance_t *inst, gnrc_pktsnip_t *pkt)
+{
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+    gnrc_pktsnip_t *tmp;
 
 #ifndef GNRC_RPL_WITHOUT_PIO
     if (dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO) {
         if ((pkt = _dio_prefix_info_build(pkt, dodag)) == NULL) {
-            return;
+            return NULL;
         }
     }
 #endif
 
     if (dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_DODAG_CONF) {
         if ((pkt = _dio_dodag_conf_build(pkt, dodag)) == NULL) {
-            return;
+            return NULL;
         }
         dodag->dio_opts &= ~GNRC_RPL_REQ_DIO_OPT_DODAG_CONF;
     }
@@ -245,29 +261,124 @@ void gnrc_rpl_send_DIO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination)
     if ((tmp = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_dio_t), GNRC_NETTYPE_UNDEF)) == NULL) {
         DEBUG("RPL: Send DIO - no space left in packet buffer\n");
         gnrc_pktbuf_release(pkt);
-        return;
+        return NULL;
     }
     pkt = tmp;
-    dio = pkt->data;
-    dio->instance_id = inst->id;
-    dio->version_number = dodag->version;
-    /* a leaf node announces an INFINITE_RANK */
-    dio->rank = ((dodag->node_status == GNRC_RPL_LEAF_NODE) ?
-                 byteorder_htons(GNRC_RPL_INFINITE_RANK) : byteorder_htons(dodag->my_rank));
-    dio->g_mop_prf = (dodag->grounded << GNRC_RPL_GROUNDED_SHIFT) |
-                     (inst->mop << GNRC_RPL_MOP_SHIFT) | dodag->prf;
-    dio->dtsn = dodag->dtsn;
-    dio->flags = 0;
-    dio->reserved = 0;
-    dio->dodag_id = dodag->dodag_id;
+    _dio_fill(pkt->data, inst);
 
     if ((tmp = gnrc_icmpv6_build(pkt, ICMPV6_RPL_CTRL, GNRC_RPL_ICMPV6_CODE_DIO,
                                  sizeof(icmpv6_hdr_t))) == NULL) {
         DEBUG("RPL: Send DIO - no space left in packet buffer\n");
         gnrc_pktbuf_release(pkt);
+        return NULL;
+    }
+    return tmp;
+}
+
+#ifndef GNRC_RPL_WITHOUT_DIO_CACHE
+/* the options a DIO is built with */
+#define DIO_CACHE_OPTS  (GNRC_RPL_REQ_DIO_OPT_DODAG_CONF | \
+                         GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO)
+
+/* gets a copy of the cached DIO if it is still up to date */
+static gnrc_pktsnip_t *_dio_cache_get(gnrc_rpl_instance_t *inst)
+{
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+    uint8_t opts = dodag->dio_opts & DIO_CACHE_OPTS;
+    gnrc_rpl_dio_t dio;
+    gnrc_pktsnip_t *pkt;
+
+    if ((dodag->dio_cache_len == 0) || (dodag->dio_cache_opts != opts)) {
+        return NULL;
+    }
+    /* rank, version, DTSN etc. changed */
+    _dio_fill(&dio, inst);
+    if (memcmp(&dodag->dio_cache[sizeof(icmpv6_hdr_t)], &dio, sizeof(dio)) != 0) {
+        return NULL;
+    }
+    if ((pkt = gnrc_pktbuf_add(NULL, dodag->dio_cache, dodag->dio_cache_len,
+                               GNRC_NETTYPE_ICMPV6)) == NULL) {
+        return NULL;
+    }
+#ifndef GNRC_RPL_WITHOUT_PIO
+    if (opts & GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO) {
+        /* the prefix information option is the last one */
+        gnrc_rpl_opt_prefix_info_t *prefix_info =
+            (gnrc_rpl_opt_prefix_info_t *)(((uint8_t *)pkt->data) + pkt->size -
+                                           sizeof(gnrc_rpl_opt_prefix_info_t));
+
+        if (!_prefix_info_lifetimes(prefix_info, dodag)) {
+            gnrc_pktbuf_release(pkt);
+            dodag->dio_cache_len = 0;
+            return NULL;
+        }
+    }
+#endif
+    dodag->dio_opts &= ~GNRC_RPL_REQ_DIO_OPT_DODAG_CONF;
+    return pkt;
+}
+
+static void _dio_cache_set(gnrc_rpl_dodag_t *dodag, gnrc_pktsnip_t *pkt,
+                           uint8_t opts)
+{
+    size_t len = gnrc_pkt_len(pkt);
+
+    dodag->dio_cache_len = 0;
+    if (len > sizeof(dodag->dio_cache)) {
         return;
     }
-    pkt = tmp;
+    for (uint8_t *ptr = dodag->dio_cache; pkt != NULL; pkt = pkt->next) {
+        memcpy(ptr, pkt->data, pkt->size);
+        ptr += pkt->size;
+    }
+    dodag->dio_cache_len = len;
+    dodag->dio_cache_opts = opts;
+}
+#endif
+
+void gnrc_rpl_send_DIO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination)
+{
+    if (inst == NULL) {
+        DEBUG("RPL: Error - trying to send DIO without being part of a dodag.\n");
+        return;
+    }
+
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+    gnrc_pktsnip_t *pkt = NULL;
+
+#ifdef MODULE_GNRC_RPL_P2P
+    gnrc_rpl_p2p_ext_t *p2p_ext = gnrc_rpl_p2p_ext_get(dodag);
+    if (dodag->instance->mop == GNRC_RPL_P2P_MOP) {
+        if (!p2p_ext->for_me) {
+            if ((pkt = gnrc_rpl_p2p_rdo_build(pkt, p2p_ext)) == NULL) {
+                return;
+            }
+        }
+        dodag->dio_opts &= ~GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
+    }
+#endif
+
+#ifndef GNRC_RPL_WITHOUT_DIO_CACHE
+    /* DIOs with a route discovery option change every time */
+    if ((pkt != NULL) || ((pkt = _dio_cache_get(inst)) == NULL)) {
+        bool cache = (pkt == NULL);
+        uint8_t opts = dodag->dio_opts & DIO_CACHE_OPTS;
+
+        if ((pkt = _dio_build(inst, pkt)) == NULL) {
+            return;
+        }
+        if (cache) {
+            _dio_cache_set(dodag, pkt, opts);
+        }
+    }
+    else {
+        DEBUG("RPL: Send DIO - using cached DIO\n");
+    }
+#else
+    if ((pkt = _dio_build(inst, pkt)) == NULL) {
+        return;
+    }
+#endif
 
 #ifdef MODULE_NETSTATS_RPL
     gnrc_rpl_netstats_tx_DIO(&gnrc_rpl_netstats, gnrc_pkt_len(pkt),
@@ -426,6 +537,10 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                 dodag->trickle.Imin = (1 << dodag->dio_min);
                 dodag->trickle.Imax = dodag->dio_interval_doubl;
                 dodag->trickle.k = dodag->dio_redun;
+#ifndef GNRC_RPL_WITHOUT_DIO_CACHE
+                /* the cached DIO may carry the old configuration */
+                dodag->dio_cache_len = 0;
+#endif
                 break;
 
             case (GNRC_RPL_OPT_PREFIX_INFO):
@@ -463,6 +578,12 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     first_target = target;
                 }
 
+                /* in non-storing mode the route is given by the parent in the
+                 * transit option */
+                if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+                    break;
+                }
+
                 DEBUG("RPL: adding FT entry %s/%d\n",
                       ipv6_addr_to_str(addr_str, &(target->target), (unsigned)sizeof(addr_str)),
                       target->prefix_length);
@@ -484,6 +605,28 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                 }
 
                 do {
+                    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+                        ipv6_addr_t *parent = (ipv6_addr_t *) (transit + 1);
+
+                        if ((dodag->node_status == GNRC_RPL_ROOT_NODE) &&
+                            (first_target->prefix_length == IPV6_ADDR_BIT_LEN)) {
+                            DEBUG("RPL: updating source route to %s\n",
+                                  ipv6_addr_to_str(addr_str, &(first_target->target),
+                                                   sizeof(addr_str)));
+                            /* own addresses mark direct children */
+                            gnrc_rpl_sr_table_add(&(first_target->target),
+                                                  gnrc_netif_get_by_ipv6_addr(parent) ?
+                                                  NULL : parent,
+                                                  transit->path_lifetime *
+                                                  dodag->lifetime_unit);
+                        }
+#endif
+                        first_target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (first_target)) +
+                                       sizeof(gnrc_rpl_opt_t) + first_target->length);
+                        continue;
+                    }
+
                     DEBUG("RPL: updating FT entry %s/%d\n",
                           ipv6_addr_to_str(addr_str, &(first_target->target), sizeof(addr_str)),
                           first_target->prefix_length);
@@ -515,6 +658,18 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
     return true;
 }
 
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+/* hashes the interface identifier of a neighbor to a bit of a 32 bit map */
+static inline uint32_t _dio_src_bit(const ipv6_addr_t *src)
+{
+    uint32_t h = src->u32[2].u32 ^ src->u32[3].u32;
+
+    h ^= h >> 16;
+    h ^= h >> 8;
+    return ((uint32_t)1) << (h & 0x1f);
+}
+#endif
+
 void gnrc_rpl_recv_DIO(gnrc_rpl_dio_t *dio, kernel_pid_t iface, ipv6_addr_t *src, ipv6_addr_t *dst,
                        uint16_t len)
 {
@@ -631,6 +786,11 @@ void gnrc_rpl_recv_DIO(gnrc_rpl_dio_t *dio, kernel_pid_t iface, ipv6_addr_t *src
         }
     }
 
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+    gnrc_rpl_dio_srcs_update(dodag);
+    dodag->dio_srcs |= _dio_src_bit(src);
+#endif
+
     if (inst->mop != ((dio->g_mop_prf >> GNRC_RPL_MOP_SHIFT) & GNRC_RPL_SHIFTED_MOP_MASK)) {
         DEBUG("RPL: invalid MOP for this instance.\n");
         return;
@@ -731,11 +891,13 @@ gnrc_pktsnip_t *_dao_target_build(gnrc_pktsnip_t *pkt, ipv6_addr_t *addr, uint8_
     return opt_snip;
 }
 
-gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external)
+gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external,
+                                   const ipv6_addr_t *parent)
 {
     gnrc_rpl_opt_transit_t *transit;
     gnrc_pktsnip_t *opt_snip;
-    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_transit_t),
+    size_t parent_len = (parent != NULL) ? sizeof(ipv6_addr_t) : 0;
+    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_transit_t) + parent_len,
                                GNRC_NETTYPE_UNDEF)) == NULL) {
         DEBUG("RPL: Send DAO - no space left in packet buffer\n");
         gnrc_pktbuf_release(pkt);
@@ -749,6 +911,10 @@ gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool e
     transit->path_control = 0;
     transit->path_sequence = 0;
     transit->path_lifetime = lifetime;
+    if (parent != NULL) {
+        transit->length += sizeof(ipv6_addr_t);
+        memcpy(transit + 1, parent, sizeof(ipv6_addr_t));
+    }
     return opt_snip;
 }
 
@@ -779,7 +945,9 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
             return;
         }
 
-        destination = &(dodag->parents->addr);
+        /* in non-storing mode DAOs are sent to the root directly */
+        destination = (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) ?
+                      &(dodag->dodag_id) : &(dodag->parents->addr);
     }
 
     gnrc_pktsnip_t *pkt = NULL, *tmp = NULL;
@@ -797,26 +965,46 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     idx = gnrc_netif_ipv6_addr_match(netif, &dodag->dodag_id);
     me = &netif->ipv6.addrs[idx];
 
-    /* add external and RPL FT entries */
-    /* TODO: nib: dropped support for external transit options for now */
-    void *ft_state = NULL;
-    gnrc_ipv6_nib_ft_t fte;
-    while(gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
-        DEBUG("RPL: Send DAO - building transit option\n");
+    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        /* the root needs a global address of the parent, assume it is
+         * configured from the same prefix as ours */
+        ipv6_addr_t parent;
 
-        if ((pkt = _dao_transit_build(pkt, lifetime, false)) == NULL) {
+        if (dodag->parents == NULL) {
+            DEBUG("RPL: dodag has no preferred parent\n");
+            return;
+        }
+        ipv6_addr_init_prefix(&parent, me, 64);
+        ipv6_addr_init_iid(&parent, &dodag->parents->addr.u8[8], 64);
+        DEBUG("RPL: Send DAO - building transit option with parent %s\n",
+              ipv6_addr_to_str(addr_str, &parent, sizeof(addr_str)));
+        if ((pkt = _dao_transit_build(pkt, lifetime, false, &parent)) == NULL) {
             DEBUG("RPL: Send DAO - no space left in packet buffer\n");
             return;
         }
-        if (ipv6_addr_is_global(&fte.dst) &&
-            !ipv6_addr_is_unspecified(&fte.next_hop)) {
-            DEBUG("RPL: Send DAO - building target %s/%d\n",
-                  ipv6_addr_to_str(addr_str, &fte.dst, sizeof(addr_str)), fte.dst_len);
-
-            if ((pkt = _dao_target_build(pkt, &fte.dst, fte.dst_len)) == NULL) {
+    }
+    else {
+        /* add external and RPL FT entries */
+        /* TODO: nib: dropped support for external transit options for now */
+        void *ft_state = NULL;
+        gnrc_ipv6_nib_ft_t fte;
+        while(gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
+            DEBUG("RPL: Send DAO - building transit option\n");
+
+            if ((pkt = _dao_transit_build(pkt, lifetime, false, NULL)) == NULL) {
                 DEBUG("RPL: Send DAO - no space left in packet buffer\n");
                 return;
             }
+            if (ipv6_addr_is_global(&fte.dst) &&
+                !ipv6_addr_is_unspecified(&fte.next_hop)) {
+                DEBUG("RPL: Send DAO - building target %s/%d\n",
+                      ipv6_addr_to_str(addr_str, &fte.dst, sizeof(addr_str)), fte.dst_len);
+
+                if ((pkt = _dao_target_build(pkt, &fte.dst, fte.dst_len)) == NULL) {
+                    DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+                    return;
+                }
+            }
         }
     }
 
@@ -28,6 +28,9 @@
 #include "net/gnrc/rpl/p2p.h"
 #include "net/gnrc/rpl/p2p_dodag.h"
 #endif
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+#include "net/gnrc/rpl/sr_table.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -110,6 +113,13 @@ bool gnrc_rpl_instance_remove(gnrc_rpl_instance_t *inst)
     gnrc_rpl_dodag_t *dodag = &inst->dodag;
 #ifdef MODULE_GNRC_RPL_P2P
     gnrc_rpl_p2p_ext_remove(dodag);
+#endif
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+    /* the routes are only used by the root in non-storing mode */
+    if ((inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+        (dodag->node_status == GNRC_RPL_ROOT_NODE)) {
+        gnrc_rpl_sr_table_flush();
+    }
 #endif
     gnrc_rpl_dodag_remove_all_parents(dodag);
     trickle_stop(&dodag->trickle);
@@ -291,9 +301,20 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         return NULL;
     }
 
+    if (dodag->instance->of->update_metrics != NULL) {
+        dodag->instance->of->update_metrics(dodag);
+    }
     LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
     new_best = dodag->parents;
 
+    /* the OF may keep the current preferred parent, e.g. for hysteresis */
+    if ((new_best != old_best) &&
+        (dodag->instance->of->which_parent(old_best, new_best) == old_best)) {
+        LL_DELETE(dodag->parents, old_best);
+        LL_PREPEND(dodag->parents, old_best);
+        new_best = old_best;
+    }
+
     if (new_best->rank == GNRC_RPL_INFINITE_RANK) {
         return NULL;
     }
@@ -319,7 +340,10 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
     }
 
     dodag->my_rank = dodag->instance->of->calc_rank(dodag->parents, 0);
-    if (dodag->my_rank != old_rank) {
+    /* the metrics of MRHOF are reevaluated periodically and change the rank
+     * by small amounts, only a new DAGRank is worth announcing right away */
+    if (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc) !=
+        DAGRANK(old_rank, dodag->instance->min_hop_rank_inc)) {
         trickle_reset_timer(&dodag->trickle);
     }
 
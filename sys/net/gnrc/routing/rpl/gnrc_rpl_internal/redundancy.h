@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl
+ * @{
+ *
+ * @file
+ * @brief       Neighbor accounting for the adaptive DIO redundancy constant
+ */
+
+#ifndef REDUNDANCY_H
+#define REDUNDANCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "net/gnrc/rpl/structs.h"
+#include "xtimer.h"
+
+#ifdef GNRC_RPL_DIO_REDUNDANCY_ADAPTIVE
+/**
+ * @brief   Moves the DIO senders of the last trickle interval to
+ *          gnrc_rpl_dodag_t::dio_srcs_last, once the next interval began
+ *
+ * Trickle only signals the time t within an interval, so this is called
+ * before the senders are used or added to.
+ *
+ * @param[in]   dodag   The DODAG
+ */
+static inline void gnrc_rpl_dio_srcs_update(gnrc_rpl_dodag_t *dodag)
+{
+    uint64_t start = dodag->trickle.start;
+
+    if ((start != dodag->dio_srcs_start) && (xtimer_now_usec64() >= start)) {
+        dodag->dio_srcs_last = dodag->dio_srcs;
+        dodag->dio_srcs = 0;
+        dodag->dio_srcs_start = start;
+    }
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REDUNDANCY_H */
+/** @} */
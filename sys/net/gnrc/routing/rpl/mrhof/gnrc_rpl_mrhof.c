@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl_mrhof
+ * @{
+ *
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "net/gnrc/ipv6/nib/nc.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/mrhof.h"
+#include "net/gnrc/rpl/structs.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static uint16_t calc_rank(gnrc_rpl_parent_t *, uint16_t);
+static gnrc_rpl_parent_t *which_parent(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+static int parent_cmp(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+static gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *, gnrc_rpl_dodag_t *);
+static void reset(gnrc_rpl_dodag_t *);
+static void update_metrics(gnrc_rpl_dodag_t *);
+
+static gnrc_rpl_of_t gnrc_rpl_mrhof = {
+    GNRC_RPL_MRHOF_OCP,
+    calc_rank,
+    which_parent,
+    parent_cmp,
+    which_dodag,
+    reset,
+    NULL,
+    NULL,
+    NULL,
+    update_metrics
+};
+
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void)
+{
+    return &gnrc_rpl_mrhof;
+}
+
+/**
+ * @brief   Gets the link-layer address of a parent
+ *
+ * Neighbor cache entries take precedence, otherwise the address is derived
+ * from the interface identifier of the link-local address of the parent, just
+ * like the NIB does for 6LoWPAN.
+ */
+static size_t _parent_l2addr(gnrc_netif_t *netif, const ipv6_addr_t *addr,
+                             uint8_t *l2addr)
+{
+    void *state = NULL;
+    gnrc_ipv6_nib_nc_t nce;
+
+    while (gnrc_ipv6_nib_nc_iter(netif->pid, &state, &nce)) {
+        if (ipv6_addr_equal(&nce.ipv6, addr) && (nce.l2addr_len > 0)) {
+            memcpy(l2addr, nce.l2addr, nce.l2addr_len);
+            return nce.l2addr_len;
+        }
+    }
+    if (ipv6_addr_is_link_local(addr)) {
+        memcpy(l2addr, &addr->u64[1], sizeof(uint64_t));
+        l2addr[0] ^= 0x02;
+        return sizeof(uint64_t);
+    }
+    return 0;
+}
+
+void update_metrics(gnrc_rpl_dodag_t *dodag)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(dodag->iface);
+    gnrc_rpl_parent_t *parent;
+
+    for (parent = dodag->parents; parent != NULL; parent = parent->next) {
+        uint8_t l2addr[GNRC_IPV6_NIB_L2ADDR_MAX_LEN];
+        netstats_nb_t stats;
+        size_t l2addr_len;
+
+        parent->link_metric = GNRC_RPL_MRHOF_ETX_INIT;
+        if (netif == NULL) {
+            continue;
+        }
+        l2addr_len = _parent_l2addr(netif, &parent->addr, l2addr);
+        if ((l2addr_len > 0) &&
+            (gnrc_netif_nb_stats_get(netif, l2addr, l2addr_len, &stats) == 0) &&
+            (stats.etx != 0)) {
+            /* the ETX is kept in the encoding of RFC 6551 already */
+            parent->link_metric = stats.etx;
+        }
+        DEBUG("RPL: MRHOF link metric of parent %p: %u\n", (void *)parent,
+              parent->link_metric);
+    }
+}
+
+void reset(gnrc_rpl_dodag_t *dodag)
+{
+    /* Nothing to do in MRHOF */
+    (void) dodag;
+}
+
+static uint32_t _path_cost(const gnrc_rpl_parent_t *parent, uint16_t rank)
+{
+    if (rank == GNRC_RPL_INFINITE_RANK) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+    uint32_t cost = (uint32_t)rank + parent->link_metric;
+    return (cost > GNRC_RPL_INFINITE_RANK) ? GNRC_RPL_INFINITE_RANK : cost;
+}
+
+static bool _acceptable(const gnrc_rpl_parent_t *parent)
+{
+    return (parent->link_metric <= GNRC_RPL_MRHOF_MAX_LINK_METRIC) &&
+           (_path_cost(parent, parent->rank) <= GNRC_RPL_MRHOF_MAX_PATH_COST);
+}
+
+/*
+ * The rank is the largest of (RFC 6719, section 3.3)
+ * 1. the path cost through the preferred parent,
+ * 2. the rank of the preferred parent rounded up to the next DAGRank, and
+ * 3. the largest path cost through the rest of the parent set minus
+ *    MaxRankIncrease.
+ * Parents of the same or a higher DAGRank than the result are removed from the
+ * parent set afterwards, so they are not considered for 3.
+ */
+uint16_t calc_rank(gnrc_rpl_parent_t *parent, uint16_t base_rank)
+{
+    if (parent == NULL) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+    if (base_rank == 0) {
+        base_rank = parent->rank;
+    }
+
+    gnrc_rpl_instance_t *inst = parent->dodag->instance;
+    uint16_t mhri = inst->min_hop_rank_inc;
+    uint32_t rank = _path_cost(parent, base_rank);
+
+    if (rank >= GNRC_RPL_INFINITE_RANK) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+    uint32_t rounded = (uint32_t)mhri * (DAGRANK(base_rank, mhri) + 1);
+    if (rank < rounded) {
+        rank = rounded;
+    }
+
+    if (inst->max_rank_inc > 0) {
+        for (gnrc_rpl_parent_t *elt = parent->next; elt != NULL;
+             elt = elt->next) {
+            uint32_t cost = _path_cost(elt, elt->rank);
+
+            if (!_acceptable(elt) ||
+                (DAGRANK(elt->rank, mhri) >= DAGRANK(rank, mhri)) ||
+                (cost <= inst->max_rank_inc)) {
+                continue;
+            }
+            if ((cost - inst->max_rank_inc) > rank) {
+                rank = cost - inst->max_rank_inc;
+            }
+        }
+    }
+
+    return (rank >= GNRC_RPL_INFINITE_RANK) ? GNRC_RPL_INFINITE_RANK
+                                             : (uint16_t)rank;
+}
+
+/*
+ * p1 is the current preferred parent, p2 the best candidate. Switch only if
+ * the path cost through p2 is lower by the threshold.
+ */
+gnrc_rpl_parent_t *which_parent(gnrc_rpl_parent_t *p1, gnrc_rpl_parent_t *p2)
+{
+    bool acc1 = _acceptable(p1), acc2 = _acceptable(p2);
+
+    if (acc1 != acc2) {
+        return acc1 ? p1 : p2;
+    }
+
+    uint32_t cost1 = _path_cost(p1, p1->rank);
+    uint32_t cost2 = _path_cost(p2, p2->rank);
+
+    if (acc1 && (cost1 < GNRC_RPL_INFINITE_RANK)) {
+        cost2 += GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD;
+    }
+    return (cost2 < cost1) ? p2 : p1;
+}
+
+int parent_cmp(gnrc_rpl_parent_t *parent1, gnrc_rpl_parent_t *parent2)
+{
+    bool acc1 = _acceptable(parent1), acc2 = _acceptable(parent2);
+
+    if (acc1 != acc2) {
+        return acc1 ? -1 : 1;
+    }
+
+    uint32_t cost1 = _path_cost(parent1, parent1->rank);
+    uint32_t cost2 = _path_cost(parent2, parent2->rank);
+
+    if (cost1 < cost2) {
+        return -1;
+    }
+    else if (cost1 > cost2) {
+        return 1;
+    }
+    return 0;
+}
+
+/* Not used yet */
+gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *d1, gnrc_rpl_dodag_t *d2)
+{
+    (void) d2;
+    return d1;
+}
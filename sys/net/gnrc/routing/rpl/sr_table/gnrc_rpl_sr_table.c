@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/sr_table.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if (GNRC_RPL_SR_TABLE_BUCKETS & (GNRC_RPL_SR_TABLE_BUCKETS - 1))
+#error "GNRC_RPL_SR_TABLE_BUCKETS must be a power of two"
+#endif
+
+/* references are the index of a node plus one, so an all-zero table is
+ * empty */
+#define REF_NONE    (0U)
+#define REF_ROOT    (UINT16_MAX)
+
+typedef struct {
+    ipv6_addr_t addr;       /* unspecified if unused */
+    uint32_t lifetime;      /* in seconds */
+    uint16_t parent;        /* reference to the parent */
+    uint16_t next;          /* reference to the next node in the bucket */
+} _node_t;
+
+static _node_t _nodes[GNRC_RPL_SR_TABLE_SIZE];
+static uint16_t _buckets[GNRC_RPL_SR_TABLE_BUCKETS];
+static unsigned _numof;
+static mutex_t _mutex = MUTEX_INIT;
+
+static inline uint16_t *_bucket(const ipv6_addr_t *addr)
+{
+    uint32_t h = addr->u32[0].u32 ^ addr->u32[1].u32 ^ addr->u32[2].u32 ^
+                 addr->u32[3].u32;
+
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
+    return &_buckets[h & (GNRC_RPL_SR_TABLE_BUCKETS - 1)];
+}
+
+static uint16_t _find(const ipv6_addr_t *addr)
+{
+    uint16_t ref = *_bucket(addr);
+
+    while ((ref != REF_NONE) && !ipv6_addr_equal(&_nodes[ref - 1].addr, addr)) {
+        ref = _nodes[ref - 1].next;
+    }
+    return ref;
+}
+
+static uint16_t _alloc(const ipv6_addr_t *addr, uint32_t lifetime)
+{
+    for (unsigned i = 0; i < GNRC_RPL_SR_TABLE_SIZE; i++) {
+        _node_t *node = &_nodes[i];
+
+        if (ipv6_addr_is_unspecified(&node->addr)) {
+            uint16_t *bucket = _bucket(addr);
+
+            node->addr = *addr;
+            node->lifetime = lifetime;
+            node->parent = REF_NONE;
+            node->next = *bucket;
+            *bucket = i + 1;
+            _numof++;
+            return i + 1;
+        }
+    }
+    return REF_NONE;
+}
+
+static void _remove(uint16_t ref)
+{
+    uint16_t *ptr = _bucket(&_nodes[ref - 1].addr);
+
+    while (*ptr != ref) {
+        ptr = &_nodes[*ptr - 1].next;
+    }
+    *ptr = _nodes[ref - 1].next;
+    /* orphan the children, the slot may be reused by another node */
+    for (unsigned i = 0; i < GNRC_RPL_SR_TABLE_SIZE; i++) {
+        if (_nodes[i].parent == ref) {
+            _nodes[i].parent = REF_NONE;
+        }
+    }
+    memset(&_nodes[ref - 1], 0, sizeof(_node_t));
+    _numof--;
+}
+
+int gnrc_rpl_sr_table_add(const ipv6_addr_t *target, const ipv6_addr_t *parent,
+                          uint32_t lifetime)
+{
+    int res = 0;
+
+    assert(target != NULL);
+    if (lifetime == 0) {
+        gnrc_rpl_sr_table_del(target);
+        return 0;
+    }
+
+    mutex_lock(&_mutex);
+    uint16_t ref = _find(target);
+    if ((ref == REF_NONE) && ((ref = _alloc(target, lifetime)) == REF_NONE)) {
+        DEBUG("RPL SR table: table full\n");
+        mutex_unlock(&_mutex);
+        return -ENOMEM;
+    }
+    _nodes[ref - 1].lifetime = lifetime;
+
+    uint16_t parent_ref = REF_ROOT;
+    if (parent != NULL) {
+        /* the parent may report itself later, keep it as long as it is on a
+         * route */
+        parent_ref = _find(parent);
+        if (parent_ref == REF_NONE) {
+            parent_ref = _alloc(parent, lifetime);
+        }
+        if (parent_ref == REF_NONE) {
+            DEBUG("RPL SR table: table full\n");
+            res = -ENOMEM;
+        }
+        else if (parent_ref == ref) {
+            DEBUG("RPL SR table: node is its own parent\n");
+            parent_ref = REF_NONE;
+        }
+        else if (_nodes[parent_ref - 1].lifetime < lifetime) {
+            _nodes[parent_ref - 1].lifetime = lifetime;
+        }
+    }
+    _nodes[ref - 1].parent = parent_ref;
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+void gnrc_rpl_sr_table_del(const ipv6_addr_t *target)
+{
+    mutex_lock(&_mutex);
+    uint16_t ref = _find(target);
+    if (ref != REF_NONE) {
+        _remove(ref);
+    }
+    mutex_unlock(&_mutex);
+}
+
+void gnrc_rpl_sr_table_flush(void)
+{
+    mutex_lock(&_mutex);
+    memset(_nodes, 0, sizeof(_nodes));
+    memset(_buckets, 0, sizeof(_buckets));
+    _numof = 0;
+    mutex_unlock(&_mutex);
+}
+
+void gnrc_rpl_sr_table_timeout(uint32_t elapsed)
+{
+    mutex_lock(&_mutex);
+    for (unsigned i = 0; i < GNRC_RPL_SR_TABLE_SIZE; i++) {
+        _node_t *node = &_nodes[i];
+
+        if (ipv6_addr_is_unspecified(&node->addr)) {
+            continue;
+        }
+        if (node->lifetime > elapsed) {
+            node->lifetime -= elapsed;
+        }
+        else {
+            _remove(i + 1);
+        }
+    }
+    mutex_unlock(&_mutex);
+}
+
+/* collects the route from the destination up to the root, returns its
+ * depth. Caller must hold _mutex. */
+static int _route(const ipv6_addr_t *dst, const ipv6_addr_t **route)
+{
+    uint16_t ref = _find(dst);
+    unsigned depth = 0;
+
+    while (ref != REF_ROOT) {
+        if (ref == REF_NONE) {
+            return -ENOENT;
+        }
+        if (depth == GNRC_RPL_SR_TABLE_DEPTH_MAX) {
+            DEBUG("RPL SR table: route too deep or looping\n");
+            return -ELOOP;
+        }
+        if (route != NULL) {
+            route[depth] = &_nodes[ref - 1].addr;
+        }
+        depth++;
+        ref = _nodes[ref - 1].parent;
+    }
+    return depth;
+}
+
+int gnrc_rpl_sr_table_depth(const ipv6_addr_t *dst)
+{
+    int res;
+
+    assert(dst != NULL);
+    if (_numof == 0) {
+        return -ENOENT;
+    }
+    mutex_lock(&_mutex);
+    res = _route(dst, NULL);
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+int gnrc_rpl_sr_table_srh(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                          void *buf, size_t len)
+{
+    const ipv6_addr_t *route[GNRC_RPL_SR_TABLE_DEPTH_MAX];
+    unsigned depth;
+    int res;
+
+    assert((dst != NULL) && (first_hop != NULL));
+    mutex_lock(&_mutex);
+    if ((res = _route(dst, route)) < 0) {
+        mutex_unlock(&_mutex);
+        return res;
+    }
+    depth = res;
+
+    *first_hop = *route[--depth];
+    if (depth == 0) {
+        mutex_unlock(&_mutex);
+        return 0;
+    }
+    /* the header lists the hops after the first one top-down */
+    for (unsigned i = 0; i < (depth / 2); i++) {
+        const ipv6_addr_t *tmp = route[i];
+
+        route[i] = route[depth - 1 - i];
+        route[depth - 1 - i] = tmp;
+    }
+    res = gnrc_rpl_srh_build(first_hop, route, depth, buf, len);
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+unsigned gnrc_rpl_sr_table_numof(void)
+{
+    return _numof;
+}
+/** @} */
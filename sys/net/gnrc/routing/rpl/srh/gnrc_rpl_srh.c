@@ -12,6 +12,7 @@
  * @file
  */
 
+#include <errno.h>
 #include <string.h>
 #include "net/gnrc/netif/internal.h"
 #include "net/ipv6/ext/rh.h"
@@ -92,4 +93,71 @@ int gnrc_rpl_srh_process(ipv6_hdr_t *ipv6, gnrc_rpl_srh_t *rh)
     return EXT_RH_CODE_FORWARD;
 }
 
+static unsigned _prefix_len(const ipv6_addr_t *a, const ipv6_addr_t *b)
+{
+    unsigned i = 0;
+
+    /* at least one octet is always carried */
+    while ((i < (sizeof(ipv6_addr_t) - 1)) && (a->u8[i] == b->u8[i])) {
+        i++;
+    }
+    return i;
+}
+
+int gnrc_rpl_srh_build(const ipv6_addr_t *dst, const ipv6_addr_t *const *addrs,
+                       unsigned n, void *buf, size_t len)
+{
+    gnrc_rpl_srh_t *rh = buf;
+
+    if (n == 0) {
+        return -EINVAL;
+    }
+
+    /* every hop restores the elided prefix from the destination address
+     * at that time, i.e. from the address before */
+    unsigned compre = _prefix_len((n > 1) ? addrs[n - 2] : dst, addrs[n - 1]);
+    unsigned compri = (n > 1) ? (sizeof(ipv6_addr_t) - 1) : compre;
+
+    for (unsigned k = 0; k < (n - 1); k++) {
+        unsigned tmp = _prefix_len((k > 0) ? addrs[k - 1] : dst, addrs[k]);
+
+        if (tmp < compri) {
+            compri = tmp;
+        }
+    }
+
+    size_t size = sizeof(gnrc_rpl_srh_t) +
+                  ((n - 1) * (sizeof(ipv6_addr_t) - compri)) +
+                  (sizeof(ipv6_addr_t) - compre);
+    unsigned pad = (8 - (size & 0x7)) & 0x7;
+
+    if ((((size + pad) / 8) - 1) > UINT8_MAX) {
+        return -EINVAL;
+    }
+    if (len < (size + pad)) {
+        return -ENOBUFS;
+    }
+
+    uint8_t *addr_vec = (uint8_t *)(rh + 1);
+
+    for (unsigned k = 0; k < n; k++) {
+        unsigned elided = (k < (n - 1)) ? compri : compre;
+
+        memcpy(addr_vec, &addrs[k]->u8[elided], sizeof(ipv6_addr_t) - elided);
+        addr_vec += sizeof(ipv6_addr_t) - elided;
+    }
+    memset(addr_vec, 0, pad);
+
+    rh->len = ((size + pad) / 8) - 1;
+    rh->type = GNRC_RPL_SRH_TYPE;
+    rh->seg_left = n;
+    rh->compr = (compri << 4) | compre;
+    rh->pad_resv = pad << 4;
+    rh->resv = 0;
+
+    DEBUG("RPL SRH: built header with %u addresses, CmprI %u, CmprE %u\n",
+          n, compri, compre);
+    return size + pad;
+}
+
 /** @} */
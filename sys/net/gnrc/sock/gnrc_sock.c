@@ -21,7 +21,13 @@
 #include "net/gnrc/netreg.h"
 #include "net/udp.h"
 #include "utlist.h"
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
 #include "xtimer.h"
+#ifdef MODULE_GNRC_SOCK_POLL
+#include "thread_flags.h"
+#endif
 
 #include "sock_types.h"
 #include "gnrc_sock_internal.h"
@@ -43,10 +49,43 @@ static void _callback_put(void *arg)
 }
 #endif
 
+#ifdef MODULE_GNRC_SOCK_POLL
+static void _netreg_cb(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    msg_t msg = { .type = cmd, .content = { .ptr = pkt } };
+    gnrc_sock_reg_t *reg = ctx;
+    thread_t *poller;
+
+    if (mbox_try_put(&reg->mbox, &msg) < 1) {
+        gnrc_pktbuf_release(pkt);
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_SOCK,
+                          NETSTATS_EXT_DROP_QUEUE_FULL);
+#endif
+        return;
+    }
+    /* read after the message is queued, so a poller registering right now
+     * finds it in the mbox */
+    poller = reg->poller;
+    if (poller != NULL) {
+        thread_flags_set(poller, GNRC_SOCK_POLL_THREAD_FLAG);
+    }
+}
+#endif
+
 void gnrc_sock_create(gnrc_sock_reg_t *reg, gnrc_nettype_t type, uint32_t demux_ctx)
 {
     mbox_init(&reg->mbox, reg->mbox_queue, SOCK_MBOX_SIZE);
+#ifdef MODULE_GNRC_SOCK_POLL
+    /* a callback instead of the mbox itself as target, so a thread waiting
+     * in sock_poll() can be woken up */
+    reg->poller = NULL;
+    reg->netreg_cb.cb = _netreg_cb;
+    reg->netreg_cb.ctx = reg;
+    gnrc_netreg_entry_init_cb(&reg->entry, demux_ctx, &reg->netreg_cb);
+#else
     gnrc_netreg_entry_init_mbox(&reg->entry, demux_ctx, &reg->mbox);
+#endif
     gnrc_netreg_register(type, &reg->entry);
 }
 
@@ -82,6 +121,10 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
     switch (msg.type) {
         case GNRC_NETAPI_MSG_TYPE_RCV:
             pkt = msg.content.ptr;
+#ifdef MODULE_NETSTATS_EXT
+            netstats_ext_latency(NETSTATS_EXT_LAYER_SOCK, pkt->rx_time);
+            netstats_ext_rx(NETSTATS_EXT_LAYER_SOCK, gnrc_pkt_len(pkt));
+#endif
             break;
 #ifdef MODULE_XTIMER
         case _TIMEOUT_MSG_TYPE:
@@ -114,13 +157,35 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
     return 0;
 }
 
+gnrc_pktsnip_t *gnrc_sock_payload_build(const iolist_t *snips)
+{
+    gnrc_pktsnip_t *payload;
+    uint8_t *ptr;
+
+    /* copy into a single snip, so lower layers (e.g. GSO) only ever see
+     * contiguous payload */
+    payload = gnrc_pktbuf_add(NULL, NULL, iolist_size(snips),
+                              GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return NULL;
+    }
+    ptr = payload->data;
+    for (; snips != NULL; snips = snips->iol_next) {
+        memcpy(ptr, snips->iol_base, snips->iol_len);
+        ptr += snips->iol_len;
+    }
+    return payload;
+}
+
 ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
-                       const sock_ip_ep_t *remote, uint8_t nh)
+                       const sock_ip_ep_t *remote, uint8_t nh,
+                       uint8_t txq_class, uint16_t gso_size)
 {
     gnrc_pktsnip_t *pkt;
     kernel_pid_t iface = KERNEL_PID_UNDEF;
     gnrc_nettype_t type;
     size_t payload_len = gnrc_pkt_len(payload);
+    bool add_netif;
 
     if (local->family != remote->family) {
         gnrc_pktbuf_release(payload);
@@ -160,7 +225,18 @@ ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
         /* TODO: use API in #5511 */
         iface = (kernel_pid_t)remote->netif;
     }
-    if (iface != KERNEL_PID_UNDEF) {
+    add_netif = (iface != KERNEL_PID_UNDEF);
+#ifdef MODULE_GNRC_NETIF_TXQ
+    add_netif |= (txq_class != GNRC_NETIF_TXQ_CLASS_AUTO);
+#else
+    (void)txq_class;
+#endif
+#ifdef MODULE_GNRC_NETIF_GSO
+    add_netif |= (gso_size != 0);
+#else
+    (void)gso_size;
+#endif
+    if (add_netif) {
         gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
         gnrc_netif_hdr_t *netif_hdr;
 
@@ -170,6 +246,12 @@ ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
         }
         netif_hdr = netif->data;
         netif_hdr->if_pid = iface;
+#ifdef MODULE_GNRC_NETIF_TXQ
+        gnrc_netif_hdr_set_txq_class(netif_hdr, txq_class);
+#endif
+#ifdef MODULE_GNRC_NETIF_GSO
+        netif_hdr->gso_size = gso_size;
+#endif
         LL_PREPEND(pkt, netif);
     }
 #ifdef MODULE_GNRC_NETERR
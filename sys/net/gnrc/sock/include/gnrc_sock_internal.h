@@ -25,6 +25,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "iolist.h"
 #include "mbox.h"
 #include "net/af.h"
 #include "net/gnrc.h"
@@ -66,6 +67,13 @@ extern "C" {
  */
 #define GNRC_SOCK_DYN_PORTRANGE_OFF (17U)
 
+/**
+ * @brief   Thread flag used to wake up a thread waiting in sock_poll()
+ */
+#ifndef GNRC_SOCK_POLL_THREAD_FLAG
+#define GNRC_SOCK_POLL_THREAD_FLAG  (0x1 << 13)
+#endif
+
 /**
  * @brief   Internal helper functions for GNRC
  * @internal
@@ -129,12 +137,36 @@ void gnrc_sock_create(gnrc_sock_reg_t *reg, gnrc_nettype_t type, uint32_t demux_
 ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt, uint32_t timeout,
                        sock_ip_ep_t *remote);
 
+/**
+ * @brief   Gathers a list of payload chunks into a single packet snip
+ * @internal
+ *
+ * @return  The payload snip of type @ref GNRC_NETTYPE_UNDEF.
+ * @return  NULL, if the packet buffer is full.
+ */
+gnrc_pktsnip_t *gnrc_sock_payload_build(const iolist_t *snips);
+
+/**
+ * @brief   Get the @ref net_gnrc_netif_txq class of a (possibly NULL) sock
+ * @internal
+ */
+#ifdef MODULE_GNRC_NETIF_TXQ
+#define GNRC_SOCK_TXQ_CLASS(sock)   (((sock) != NULL) ? (sock)->txq_class : \
+                                     GNRC_NETIF_TXQ_CLASS_AUTO)
+#else
+#define GNRC_SOCK_TXQ_CLASS(sock)   (0)
+#endif
+
 /**
  * @brief   Send a packet internally
  * @internal
+ *
+ * @p gso_size is the segment size for @ref net_gnrc_netif_gso (0 to not
+ * segment). It is ignored without that module.
  */
 ssize_t gnrc_sock_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
-                       const sock_ip_ep_t *remote, uint8_t nh);
+                       const sock_ip_ep_t *remote, uint8_t nh,
+                       uint8_t txq_class, uint16_t gso_size);
 /**
  * @}
  */
@@ -31,6 +31,7 @@
 #include "net/gnrc/netreg.h"
 #include "net/sock/ip.h"
 #include "net/sock/udp.h"
+#include "thread.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +52,13 @@ typedef struct gnrc_sock_reg {
     gnrc_netreg_entry_t entry;          /**< @ref net_gnrc_netreg entry for mbox */
     mbox_t mbox;                        /**< @ref core_mbox target for the sock */
     msg_t mbox_queue[SOCK_MBOX_SIZE];   /**< queue for gnrc_sock_reg_t::mbox */
+#ifdef MODULE_GNRC_SOCK_POLL
+    /**
+     * @brief   Callback filling gnrc_sock_reg_t::mbox
+     */
+    gnrc_netreg_entry_cbd_t netreg_cb;
+    thread_t *poller;                   /**< thread waiting in sock_poll() */
+#endif
 } gnrc_sock_reg_t;
 
 /**
@@ -62,6 +70,9 @@ struct sock_ip {
     sock_ip_ep_t local;                 /**< local end-point */
     sock_ip_ep_t remote;                /**< remote end-point */
     uint16_t flags;                     /**< option flags */
+#ifdef MODULE_GNRC_NETIF_TXQ
+    uint8_t txq_class;                  /**< @ref net_gnrc_netif_txq class */
+#endif
 };
 
 /**
@@ -73,6 +84,9 @@ struct sock_udp {
     sock_udp_ep_t local;                /**< local end-point */
     sock_udp_ep_t remote;               /**< remote end-point */
     uint16_t flags;                     /**< option flags */
+#ifdef MODULE_GNRC_NETIF_TXQ
+    uint8_t txq_class;                  /**< @ref net_gnrc_netif_txq class */
+#endif
 };
 
 #ifdef __cplusplus
@@ -56,6 +56,9 @@ int sock_ip_create(sock_ip_t *sock, const sock_ip_ep_t *local,
     gnrc_sock_create(&sock->reg, GNRC_NETTYPE_IPV6,
                      proto);
     sock->flags = flags;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    sock->txq_class = GNRC_NETIF_TXQ_CLASS_AUTO;
+#endif
     return 0;
 }
 
@@ -85,14 +88,13 @@ int sock_ip_get_remote(sock_ip_t *sock, sock_ip_ep_t *remote)
     return 0;
 }
 
-ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
-                     uint32_t timeout, sock_ip_ep_t *remote)
+static ssize_t _ip_recv(sock_ip_t *sock, gnrc_pktsnip_t **pkt_out,
+                        uint32_t timeout, sock_ip_ep_t *remote)
 {
     gnrc_pktsnip_t *pkt;
     sock_ip_ep_t tmp;
     int res;
 
-    assert((sock != NULL) && (data != NULL) && (max_len > 0));
     if (sock->local.family == 0) {
         return -EADDRNOTAVAIL;
     }
@@ -101,10 +103,6 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
     if (res < 0) {
         return res;
     }
-    if (pkt->size > max_len) {
-        gnrc_pktbuf_release(pkt);
-        return -ENOBUFS;
-    }
     if (remote != NULL) {
         /* return remote to possibly block if wrong remote */
         memcpy(remote, &tmp, sizeof(tmp));
@@ -118,13 +116,73 @@ ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
         gnrc_pktbuf_release(pkt);
         return -EPROTO;
     }
+    *pkt_out = pkt;
+    return 0;
+}
+
+ssize_t sock_ip_recv(sock_ip_t *sock, void *data, size_t max_len,
+                     uint32_t timeout, sock_ip_ep_t *remote)
+{
+    gnrc_pktsnip_t *pkt;
+    ssize_t res;
+
+    assert((sock != NULL) && (data != NULL) && (max_len > 0));
+    res = _ip_recv(sock, &pkt, timeout, remote);
+    if (res < 0) {
+        return res;
+    }
+    if (pkt->size > max_len) {
+        gnrc_pktbuf_release(pkt);
+        return -ENOBUFS;
+    }
+    res = pkt->size;
     memcpy(data, pkt->data, pkt->size);
     gnrc_pktbuf_release(pkt);
-    return (int)pkt->size;
+    return res;
 }
 
-ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
-                     uint8_t proto, const sock_ip_ep_t *remote)
+ssize_t sock_ip_recv_buf(sock_ip_t *sock, void **data, void **buf_ctx,
+                         uint32_t timeout, sock_ip_ep_t *remote)
+{
+    gnrc_pktsnip_t *pkt;
+    ssize_t res;
+
+    assert((sock != NULL) && (data != NULL) && (buf_ctx != NULL));
+    if (*buf_ctx != NULL) {
+        /* the payload is lent in one piece: give it back */
+        gnrc_pktbuf_release(*buf_ctx);
+        *buf_ctx = NULL;
+        *data = NULL;
+        return 0;
+    }
+    res = _ip_recv(sock, &pkt, timeout, remote);
+    if (res < 0) {
+        return res;
+    }
+    if (pkt->size == 0) {
+        /* nothing to lend, 0 would make the caller stop without giving the
+         * packet back */
+        gnrc_pktbuf_release(pkt);
+        *data = NULL;
+        return 0;
+    }
+    *buf_ctx = pkt;
+    *data = pkt->data;
+    return pkt->size;
+}
+
+#ifdef MODULE_GNRC_NETIF_TXQ
+void gnrc_sock_ip_set_txq_class(sock_ip_t *sock, uint8_t cls)
+{
+    assert(sock != NULL);
+    assert((cls < GNRC_NETIF_TXQ_CLASS_NUMOF) ||
+           (cls == GNRC_NETIF_TXQ_CLASS_AUTO));
+    sock->txq_class = cls;
+}
+#endif
+
+ssize_t sock_ip_sendv(sock_ip_t *sock, const iolist_t *snips,
+                      uint8_t proto, const sock_ip_ep_t *remote)
 {
     int res;
     gnrc_pktsnip_t *pkt;
@@ -132,7 +190,6 @@ ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
     sock_ip_ep_t rem;
 
     assert((sock != NULL) || (remote != NULL));
-    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
     if ((remote != NULL) && (sock != NULL) &&
         (sock->local.netif != SOCK_ADDR_ANY_NETIF) &&
         (remote->netif != SOCK_ADDR_ANY_NETIF) &&
@@ -185,15 +242,25 @@ ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
          * there was no remote given on create, take from local */
         rem.family = local.family;
     }
-    pkt = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    pkt = gnrc_sock_payload_build(snips);
     if (pkt == NULL) {
         return -ENOMEM;
     }
-    res = gnrc_sock_send(pkt, &local, &rem, proto);
+    res = gnrc_sock_send(pkt, &local, &rem, proto, GNRC_SOCK_TXQ_CLASS(sock),
+                         0);
     if (res <= 0) {
         return res;
     }
     return res;
 }
 
+ssize_t sock_ip_send(sock_ip_t *sock, const void *data, size_t len,
+                     uint8_t proto, const sock_ip_ep_t *remote)
+{
+    iolist_t snip = { .iol_base = (void *)data, .iol_len = len };
+
+    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
+    return sock_ip_sendv(sock, &snip, proto, remote);
+}
+
 /** @} */
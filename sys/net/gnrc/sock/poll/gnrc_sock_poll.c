@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+
+#include "cib.h"
+#include "thread_flags.h"
+#include "xtimer.h"
+
+#include "net/sock/poll.h"
+
+#include "sock_types.h"
+#include "gnrc_sock_internal.h"
+
+static gnrc_sock_reg_t *_reg(const sock_poll_t *entry)
+{
+    switch (entry->type) {
+#ifdef MODULE_SOCK_UDP
+        case SOCK_POLL_UDP:
+            return (entry->obj.udp != NULL) ? &entry->obj.udp->reg : NULL;
+#endif
+#ifdef MODULE_SOCK_IP
+        case SOCK_POLL_IP:
+            return (entry->obj.ip != NULL) ? &entry->obj.ip->reg : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+static void _set_poller(sock_poll_t *set, unsigned numof, thread_t *poller)
+{
+    for (unsigned i = 0; i < numof; i++) {
+        gnrc_sock_reg_t *reg = _reg(&set[i]);
+
+        if (reg != NULL) {
+            reg->poller = poller;
+        }
+    }
+}
+
+static int _check(sock_poll_t *set, unsigned numof)
+{
+    int res = 0;
+
+    for (unsigned i = 0; i < numof; i++) {
+        gnrc_sock_reg_t *reg = _reg(&set[i]);
+
+        if (reg != NULL) {
+            /* cib_avail() is 0 for socks that were never bound */
+            set[i].ready = (cib_avail(&reg->mbox.cib) > 0);
+        }
+#ifdef MODULE_EVENT
+        else if ((set[i].type == SOCK_POLL_EVENT) &&
+                 (set[i].obj.queue != NULL)) {
+            set[i].ready = (set[i].obj.queue->event_list.next != NULL);
+        }
+#endif
+        else {
+            set[i].ready = false;
+        }
+        res += set[i].ready;
+    }
+    return res;
+}
+
+int sock_poll(sock_poll_t *set, unsigned numof, uint32_t timeout)
+{
+    thread_flags_t wait_for = GNRC_SOCK_POLL_THREAD_FLAG |
+                              THREAD_FLAG_TIMEOUT;
+    xtimer_t timer;
+    bool timer_set = (timeout != 0) && (timeout != SOCK_NO_TIMEOUT);
+    int res;
+
+    assert((set != NULL) || (numof == 0));
+#ifdef MODULE_EVENT
+    wait_for |= THREAD_FLAG_EVENT;
+#endif
+    thread_flags_clear(GNRC_SOCK_POLL_THREAD_FLAG | THREAD_FLAG_TIMEOUT);
+    /* register before checking, so no packet arriving in between is
+     * missed */
+    _set_poller(set, numof, (thread_t *)sched_active_thread);
+    if (timer_set) {
+        xtimer_set_timeout_flag(&timer, timeout);
+    }
+    while (((res = _check(set, numof)) == 0) && (timeout != 0)) {
+        if (thread_flags_wait_any(wait_for) & THREAD_FLAG_TIMEOUT) {
+            res = _check(set, numof);
+            break;
+        }
+    }
+    if (timer_set) {
+        xtimer_remove(&timer);
+    }
+    _set_poller(set, numof, NULL);
+    return res;
+}
+
+/** @} */
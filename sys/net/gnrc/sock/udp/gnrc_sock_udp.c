@@ -21,6 +21,9 @@
 #include "net/af.h"
 #include "net/protnum.h"
 #include "net/gnrc/ipv6.h"
+#ifdef MODULE_GNRC_NETIF_GSO
+#include "net/gnrc/netif/gso.h"
+#endif
 #include "net/gnrc/udp.h"
 #include "net/sock/udp.h"
 #include "net/udp.h"
@@ -131,6 +134,9 @@ int sock_udp_create(sock_udp_t *sock, const sock_udp_ep_t *local,
         gnrc_sock_create(&sock->reg, GNRC_NETTYPE_UDP, local->port);
     }
     sock->flags = flags;
+#ifdef MODULE_GNRC_NETIF_TXQ
+    sock->txq_class = GNRC_NETIF_TXQ_CLASS_AUTO;
+#endif
     return 0;
 }
 
@@ -166,15 +172,14 @@ int sock_udp_get_remote(sock_udp_t *sock, sock_udp_ep_t *remote)
     return 0;
 }
 
-ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
-                      uint32_t timeout, sock_udp_ep_t *remote)
+static ssize_t _udp_recv(sock_udp_t *sock, gnrc_pktsnip_t **pkt_out,
+                         uint32_t timeout, sock_udp_ep_t *remote)
 {
     gnrc_pktsnip_t *pkt, *udp;
     udp_hdr_t *hdr;
     sock_ip_ep_t tmp;
     int res;
 
-    assert((sock != NULL) && (data != NULL) && (max_len > 0));
     if (sock->local.family == AF_UNSPEC) {
         return -EADDRNOTAVAIL;
     }
@@ -183,10 +188,6 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
     if (res < 0) {
         return res;
     }
-    if (pkt->size > max_len) {
-        gnrc_pktbuf_release(pkt);
-        return -ENOBUFS;
-    }
     udp = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_UDP);
     assert(udp);
     hdr = udp->data;
@@ -205,13 +206,73 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
         gnrc_pktbuf_release(pkt);
         return -EPROTO;
     }
+    *pkt_out = pkt;
+    return 0;
+}
+
+ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
+                      uint32_t timeout, sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *pkt;
+    ssize_t res;
+
+    assert((sock != NULL) && (data != NULL) && (max_len > 0));
+    res = _udp_recv(sock, &pkt, timeout, remote);
+    if (res < 0) {
+        return res;
+    }
+    if (pkt->size > max_len) {
+        gnrc_pktbuf_release(pkt);
+        return -ENOBUFS;
+    }
+    res = pkt->size;
     memcpy(data, pkt->data, pkt->size);
     gnrc_pktbuf_release(pkt);
-    return (int)pkt->size;
+    return res;
 }
 
-ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
-                      const sock_udp_ep_t *remote)
+ssize_t sock_udp_recv_buf(sock_udp_t *sock, void **data, void **buf_ctx,
+                          uint32_t timeout, sock_udp_ep_t *remote)
+{
+    gnrc_pktsnip_t *pkt;
+    ssize_t res;
+
+    assert((sock != NULL) && (data != NULL) && (buf_ctx != NULL));
+    if (*buf_ctx != NULL) {
+        /* the payload is lent in one piece: give it back */
+        gnrc_pktbuf_release(*buf_ctx);
+        *buf_ctx = NULL;
+        *data = NULL;
+        return 0;
+    }
+    res = _udp_recv(sock, &pkt, timeout, remote);
+    if (res < 0) {
+        return res;
+    }
+    if (pkt->size == 0) {
+        /* nothing to lend, 0 would make the caller stop without giving the
+         * packet back */
+        gnrc_pktbuf_release(pkt);
+        *data = NULL;
+        return 0;
+    }
+    *buf_ctx = pkt;
+    *data = pkt->data;
+    return pkt->size;
+}
+
+#ifdef MODULE_GNRC_NETIF_TXQ
+void gnrc_sock_udp_set_txq_class(sock_udp_t *sock, uint8_t cls)
+{
+    assert(sock != NULL);
+    assert((cls < GNRC_NETIF_TXQ_CLASS_NUMOF) ||
+           (cls == GNRC_NETIF_TXQ_CLASS_AUTO));
+    sock->txq_class = cls;
+}
+#endif
+
+static ssize_t _udp_send(sock_udp_t *sock, const iolist_t *snips,
+                         const sock_udp_ep_t *remote, uint16_t gso_size)
 {
     int res;
     gnrc_pktsnip_t *payload, *pkt;
@@ -221,7 +282,6 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
     sock_ip_ep_t *rem;
 
     assert((sock != NULL) || (remote != NULL));
-    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
 
     if (remote != NULL) {
         if (remote->port == 0) {
@@ -294,7 +354,7 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
         return -EINVAL;
     }
     /* generate payload and header snips */
-    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    payload = gnrc_sock_payload_build(snips);
     if (payload == NULL) {
         return -ENOMEM;
     }
@@ -303,11 +363,45 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
         gnrc_pktbuf_release(payload);
         return -ENOMEM;
     }
-    res = gnrc_sock_send(pkt, &local, rem, PROTNUM_UDP);
+    res = gnrc_sock_send(pkt, &local, rem, PROTNUM_UDP,
+                         GNRC_SOCK_TXQ_CLASS(sock), gso_size);
     if (res > 0) {
         res -= sizeof(udp_hdr_t);
     }
     return res;
 }
 
+ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
+                      const sock_udp_ep_t *remote)
+{
+    iolist_t snip = { .iol_base = (void *)data, .iol_len = len };
+
+    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
+    return _udp_send(sock, &snip, remote, 0);
+}
+
+ssize_t sock_udp_sendv(sock_udp_t *sock, const iolist_t *snips,
+                       const sock_udp_ep_t *remote)
+{
+    return _udp_send(sock, snips, remote, 0);
+}
+
+#ifdef MODULE_GNRC_NETIF_GSO
+ssize_t gnrc_sock_udp_send_gso(sock_udp_t *sock, const void *data, size_t len,
+                               uint16_t seg_size, const sock_udp_ep_t *remote)
+{
+    iolist_t snip = { .iol_base = (void *)data, .iol_len = len };
+
+    /* the unsegmented packet still has to fit the length fields */
+    if ((len + sizeof(udp_hdr_t)) > UINT16_MAX) {
+        return -ENOMEM;
+    }
+    /* no need to segment if it fits anyway */
+    if (seg_size >= len) {
+        seg_size = 0;
+    }
+    return _udp_send(sock, &snip, remote, seg_size);
+}
+#endif
+
 /** @} */
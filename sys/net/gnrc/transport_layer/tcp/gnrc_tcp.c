@@ -240,6 +240,7 @@ void gnrc_tcp_tcb_init(gnrc_tcp_tcb_t *tcb)
     tcb->rtt_var = RTO_UNINITIALIZED;
     tcb->srtt = RTO_UNINITIALIZED;
     tcb->rto = RTO_UNINITIALIZED;
+    tcb->cc = &GNRC_TCP_CC_DEFAULT;
     mbox_init(&(tcb->mbox), tcb->mbox_raw, GNRC_TCP_TCB_MBOX_SIZE);
     mutex_init(&(tcb->fsm_lock));
     mutex_init(&(tcb->function_lock));
@@ -309,6 +310,7 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
     cb_arg_t probe_timeout_arg = {MSG_TYPE_PROBE_TIMEOUT, &(tcb->mbox)};
     uint32_t probe_timeout_duration_us = 0;
     ssize_t ret = 0;
+    size_t sent = 0;
     bool probing_mode = false;
 
     /* Lock the TCB for this function call */
@@ -336,8 +338,8 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
         _setup_timeout(&user_timeout, timeout_duration_us, _cb_mbox_put_msg, &user_timeout_arg);
     }
 
-    /* Loop until something was sent and acked */
-    while (ret == 0 || tcb->pkt_retransmit != NULL) {
+    /* Loop until all data was put into the retransmit queue */
+    while (ret == 0) {
         /* Check if the connections state is closed. If so, a reset was received */
         if (tcb->state == FSM_STATE_CLOSED) {
             ret = -ECONNRESET;
@@ -356,9 +358,21 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
                            &probe_timeout_arg);
         }
 
-        /* Try to send data in case there nothing has been sent and we are not probing */
-        if (ret == 0 && !probing_mode) {
-            ret = _fsm(tcb, FSM_EVENT_CALL_SEND, NULL, (void *) data, len);
+        /* Try to send remaining data in case we are not probing */
+        if (!probing_mode) {
+            size_t queued = _fsm(tcb, FSM_EVENT_CALL_SEND, NULL, (uint8_t *) data + sent,
+                                 len - sent);
+
+            sent += queued;
+            if (sent == len) {
+                break;
+            }
+            /* The window is open but no packet could be allocated. Without a segment
+             * in flight no ACK would ever wake us up again */
+            if (queued == 0 && tcb->pkt_retransmit_numof == 0) {
+                ret = -ENOMEM;
+                break;
+            }
         }
 
         /* Wait for responses */
@@ -372,7 +386,7 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
 
             case MSG_TYPE_USER_SPEC_TIMEOUT:
                 DEBUG("gnrc_tcp.c : gnrc_tcp_send() : USER_SPEC_TIMEOUT\n");
-                _fsm(tcb, FSM_EVENT_CLEAR_RETRANSMIT, NULL, NULL, 0);
+                /* Queued data belongs to the stream already, it must not be cleared */
                 ret = -ETIMEDOUT;
                 break;
 
@@ -416,6 +430,11 @@ ssize_t gnrc_tcp_send(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len,
     xtimer_remove(&user_timeout);
     tcb->status &= ~STATUS_WAIT_FOR_MSG;
     mutex_unlock(&(tcb->function_lock));
+
+    /* Report partially queued data instead of a timeout or an allocation failure */
+    if (ret == 0 || ((ret == -ETIMEDOUT || ret == -ENOMEM) && sent > 0)) {
+        ret = sent;
+    }
     return ret;
 }
 
@@ -579,6 +598,230 @@ void gnrc_tcp_abort(gnrc_tcp_tcb_t *tcb)
     mutex_unlock(&(tcb->function_lock));
 }
 
+int gnrc_tcp_connect(gnrc_tcp_tcb_t *tcb, const uint8_t address_family,
+                     const uint8_t *target_addr, const uint16_t target_port,
+                     const uint16_t local_port, gnrc_tcp_cb_t cb, void *arg)
+{
+    assert(tcb != NULL);
+    assert(target_addr != NULL);
+    assert(target_port != PORT_UNSPEC);
+    assert(cb != NULL);
+
+    /* Check if AF-Family of target_addr is supported */
+#ifdef MODULE_GNRC_IPV6
+    if (address_family != AF_INET6) {
+        return -EAFNOSUPPORT;
+    }
+#else
+    return -EAFNOSUPPORT;
+#endif
+
+    /* Check if AF-Family for target address matches internally used AF-Family */
+    if (tcb->address_family != address_family) {
+        return -EINVAL;
+    }
+    if (tcb->state != FSM_STATE_CLOSED) {
+        return -EISCONN;
+    }
+
+    /* Copy target address and port number into TCB */
+#ifdef MODULE_GNRC_IPV6
+    memcpy(tcb->peer_addr, target_addr, sizeof(ipv6_addr_t));
+#endif
+    tcb->local_port = local_port;
+    tcb->peer_port = target_port;
+    tcb->cb = cb;
+    tcb->cb_arg = arg;
+
+    /* Send SYN, the callback reports the outcome */
+    return _fsm(tcb, FSM_EVENT_CALL_OPEN, NULL, NULL, 0);
+}
+
+/**
+ * @brief Puts a TCB of a listener into LISTEN.
+ *
+ * @param[in,out] tcb          TCB holding the connection information.
+ * @param[in]     local_addr   Local address to bind on, NULL for any address.
+ * @param[in]     local_port   Local port to bind on.
+ * @param[in]     cb           Callback for the events of the connection.
+ * @param[in]     arg          Argument for @p cb.
+ *
+ * @returns   Zero on success.
+ *            -EISCONN if TCB is already in use.
+ *            -ENOMEM if the receive buffer for the TCB could not be allocated.
+ */
+static int _listen(gnrc_tcp_tcb_t *tcb, const uint8_t *local_addr, uint16_t local_port,
+                   gnrc_tcp_cb_t cb, void *arg)
+{
+    if (tcb->state != FSM_STATE_CLOSED) {
+        return -EISCONN;
+    }
+
+    /* Mark connection as passive opened by a listener */
+    tcb->status |= (STATUS_PASSIVE | STATUS_LISTENER);
+    if (local_addr == NULL) {
+        tcb->status |= STATUS_ALLOW_ANY_ADDR;
+    }
+#ifdef MODULE_GNRC_IPV6
+    else if (tcb->address_family == AF_INET6) {
+        memcpy(tcb->local_addr, local_addr, sizeof(ipv6_addr_t));
+    }
+#endif
+    tcb->local_port = local_port;
+    tcb->cb = cb;
+    tcb->cb_arg = arg;
+    return _fsm(tcb, FSM_EVENT_CALL_OPEN, NULL, NULL, 0);
+}
+
+int gnrc_tcp_listen(gnrc_tcp_listener_t *listener, gnrc_tcp_tcb_t *tcbs, size_t numof,
+                    const uint8_t address_family, const uint8_t *local_addr,
+                    const uint16_t local_port, gnrc_tcp_cb_t cb, void *arg)
+{
+    assert(listener != NULL);
+    assert(tcbs != NULL);
+    assert(local_port != PORT_UNSPEC);
+    assert(cb != NULL);
+
+    /* Check AF-Family support if local address was supplied */
+    if (local_addr != NULL) {
+#ifdef MODULE_GNRC_IPV6
+        if (address_family != AF_INET6) {
+            return -EAFNOSUPPORT;
+        }
+#else
+        return -EAFNOSUPPORT;
+#endif
+    }
+
+    listener->tcbs = tcbs;
+    listener->numof = 0;
+    for (size_t i = 0; i < numof; i++) {
+        int ret = -EINVAL;
+
+        /* Check if AF-Family matches internally used AF-Family */
+        if (local_addr == NULL || tcbs[i].address_family == address_family) {
+            ret = _listen(&tcbs[i], local_addr, local_port, cb, arg);
+        }
+        if (ret < 0) {
+            /* Stop the TCBs opened so far */
+            gnrc_tcp_unlisten(listener);
+            return ret;
+        }
+        listener->numof++;
+    }
+    return 0;
+}
+
+gnrc_tcp_tcb_t *gnrc_tcp_accept(gnrc_tcp_listener_t *listener)
+{
+    assert(listener != NULL);
+
+    for (size_t i = 0; i < listener->numof; i++) {
+        gnrc_tcp_tcb_t *tcb = &listener->tcbs[i];
+
+        mutex_lock(&(tcb->fsm_lock));
+        if (!(tcb->status & STATUS_ACCEPTED) &&
+            (tcb->state == FSM_STATE_ESTABLISHED || tcb->state == FSM_STATE_CLOSE_WAIT)) {
+            tcb->status |= STATUS_ACCEPTED;
+            mutex_unlock(&(tcb->fsm_lock));
+            return tcb;
+        }
+        mutex_unlock(&(tcb->fsm_lock));
+    }
+    return NULL;
+}
+
+void gnrc_tcp_unlisten(gnrc_tcp_listener_t *listener)
+{
+    assert(listener != NULL);
+
+    for (size_t i = 0; i < listener->numof; i++) {
+        gnrc_tcp_tcb_t *tcb = &listener->tcbs[i];
+
+        /* Closed TCBs must not wait for connections again */
+        mutex_lock(&(tcb->fsm_lock));
+        tcb->status &= ~(STATUS_LISTENER | STATUS_ACCEPTED);
+        if (tcb->state == FSM_STATE_CLOSED) {
+            /* Stop a pending retry to listen */
+            xtimer_remove(&tcb->tim_tout);
+        }
+        mutex_unlock(&(tcb->fsm_lock));
+        if (tcb->state != FSM_STATE_CLOSED) {
+            _fsm(tcb, FSM_EVENT_CALL_ABORT, NULL, NULL, 0);
+        }
+    }
+    listener->numof = 0;
+}
+
+ssize_t gnrc_tcp_write(gnrc_tcp_tcb_t *tcb, const void *data, const size_t len)
+{
+    assert(tcb != NULL);
+    assert(data != NULL);
+
+    ssize_t ret;
+
+    /* Lock the TCB for this function call */
+    mutex_lock(&(tcb->function_lock));
+
+    /* Check if connection is in a valid state */
+    if (tcb->state != FSM_STATE_ESTABLISHED && tcb->state != FSM_STATE_CLOSE_WAIT) {
+        mutex_unlock(&(tcb->function_lock));
+        return -ENOTCONN;
+    }
+
+    /* Queue as much as the windows and the retransmit queue allow */
+    ret = _fsm(tcb, FSM_EVENT_CALL_SEND, NULL, (void *) data, len);
+    if (ret == 0 && len > 0) {
+        ret = -EAGAIN;
+    }
+    mutex_unlock(&(tcb->function_lock));
+    return ret;
+}
+
+ssize_t gnrc_tcp_read(gnrc_tcp_tcb_t *tcb, void *data, const size_t max_len)
+{
+    assert(tcb != NULL);
+    assert(data != NULL);
+
+    ssize_t ret;
+    bool fin_rcvd;
+
+    /* Lock the TCB for this function call */
+    mutex_lock(&(tcb->function_lock));
+
+    /* The peer closed its direction in all states after a FIN was received */
+    fin_rcvd = (tcb->state == FSM_STATE_CLOSE_WAIT || tcb->state == FSM_STATE_CLOSING ||
+                tcb->state == FSM_STATE_LAST_ACK || tcb->state == FSM_STATE_TIME_WAIT);
+
+    /* Check if connection is in a valid state */
+    if (tcb->state != FSM_STATE_ESTABLISHED && tcb->state != FSM_STATE_FIN_WAIT_1 &&
+        tcb->state != FSM_STATE_FIN_WAIT_2 && !fin_rcvd) {
+        mutex_unlock(&(tcb->function_lock));
+        return -ENOTCONN;
+    }
+
+    /* Zero signals end of stream, once all data was read after the peer closed */
+    ret = _fsm(tcb, FSM_EVENT_CALL_RECV, NULL, data, max_len);
+    if (ret == 0 && !fin_rcvd) {
+        ret = -EAGAIN;
+    }
+    mutex_unlock(&(tcb->function_lock));
+    return ret;
+}
+
+void gnrc_tcp_disconnect(gnrc_tcp_tcb_t *tcb)
+{
+    assert(tcb != NULL);
+
+    /* Nothing was received from the peer yet: no need for a FIN handshake */
+    if (tcb->state == FSM_STATE_SYN_SENT) {
+        _fsm(tcb, FSM_EVENT_CALL_ABORT, NULL, NULL, 0);
+    }
+    else if (tcb->state != FSM_STATE_CLOSED) {
+        _fsm(tcb, FSM_EVENT_CALL_CLOSE, NULL, NULL, 0);
+    }
+}
+
 int gnrc_tcp_calc_csum(const gnrc_pktsnip_t *hdr, const gnrc_pktsnip_t *pseudo_hdr)
 {
     uint16_t csum;
@@ -621,3 +864,36 @@ gnrc_pktsnip_t *gnrc_tcp_hdr_build(gnrc_pktsnip_t *payload, uint16_t src, uint16
     hdr->off_ctl = byteorder_htons(TCP_HDR_OFFSET_MIN);
     return res;
 }
+
+int gnrc_tcp_get_stats(unsigned idx, gnrc_tcp_stats_t *stats)
+{
+    static const char *states[] = {
+        "CLOSED", "LISTEN", "SYN_SENT", "SYN_RCVD", "ESTABLISHED", "CLOSE_WAIT",
+        "LAST_ACK", "FIN_WAIT_1", "FIN_WAIT_2", "CLOSING", "TIME_WAIT"
+    };
+    gnrc_tcp_tcb_t *tcb;
+
+    assert(stats != NULL);
+
+    mutex_lock(&_list_tcb_lock);
+    for (tcb = _list_tcb_head; tcb != NULL && idx > 0; tcb = tcb->next) {
+        idx--;
+    }
+    if (tcb == NULL) {
+        mutex_unlock(&_list_tcb_lock);
+        return -ENOENT;
+    }
+    stats->state = states[tcb->state];
+    stats->cc = tcb->cc->name;
+    stats->local_port = tcb->local_port;
+    stats->peer_port = tcb->peer_port;
+    stats->snd_wnd = tcb->snd_wnd;
+    stats->cwnd = tcb->cwnd;
+    stats->ssthresh = tcb->ssthresh;
+    stats->flight_size = GET_FLIGHT_SIZE(tcb);
+    stats->srtt = tcb->srtt;
+    stats->rto = tcb->rto;
+    stats->retransmits = tcb->retransmits;
+    mutex_unlock(&_list_tcb_lock);
+    return 0;
+}
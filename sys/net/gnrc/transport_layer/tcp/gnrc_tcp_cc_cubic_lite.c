@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_tcp_cc
+ * @{
+ *
+ * @file
+ * @brief       Integer-only CUBIC congestion control (RFC 8312) for constrained nodes
+ * @}
+ */
+
+#include "xtimer.h"
+#include "net/gnrc/tcp/cc.h"
+#include "internal/common.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief Multiplicative decrease factor, 0.7 in 1/1024
+ */
+#define BETA        (717)
+
+/**
+ * @brief Cubic scaling constant, 0.4 in 1/1024
+ */
+#define C           (410)
+
+/**
+ * @brief Time since the epoch start is limited to 100 seconds to prevent overflows
+ */
+#define T_MAX_MS    (100000L)
+
+/**
+ * @brief Calculates the integer cube root of @p x.
+ */
+static uint32_t _cbrt(uint64_t x)
+{
+    uint64_t res = 0;
+
+    for (int shift = 63; shift >= 0; shift -= 3) {
+        res <<= 1;
+        uint64_t b = 3 * res * (res + 1) + 1;
+        if ((x >> shift) >= b) {
+            x -= b << shift;
+            res++;
+        }
+    }
+    return (uint32_t)res;
+}
+
+/**
+ * @brief Reduces the window on a congestion event (see RFC 8312, 4.5 and 4.6).
+ */
+static void _reduce(gnrc_tcp_tcb_t *tcb, uint32_t smss)
+{
+    uint32_t ssthresh = (uint32_t)(((uint64_t)tcb->cwnd * BETA) / 1024);
+
+    /* Fast convergence: release bandwidth if the window is still shrinking */
+    if (tcb->cwnd < tcb->cc_state.cubic_lite.w_max) {
+        tcb->cc_state.cubic_lite.w_max = (uint32_t)(((uint64_t)tcb->cwnd * (1024 + BETA)) / 2048);
+    }
+    else {
+        tcb->cc_state.cubic_lite.w_max = tcb->cwnd;
+    }
+    tcb->ssthresh = (ssthresh > 2 * smss) ? ssthresh : 2 * smss;
+    tcb->cc_state.cubic_lite.epoch = 0;
+    tcb->cc_state.cubic_lite.recover = tcb->snd_nxt;
+}
+
+static void _init(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = GET_SMSS(tcb);
+
+    /* Initial window (see RFC 5681, 3.1) */
+    tcb->cwnd = (smss > 2190) ? 2 * smss : ((smss > 1095) ? 3 * smss : 4 * smss);
+    tcb->ssthresh = UINT32_MAX;
+    tcb->cc_state.cubic_lite.recover = tcb->iss;
+    tcb->cc_state.cubic_lite.epoch = 0;
+    tcb->cc_state.cubic_lite.w_max = 0;
+    tcb->cc_state.cubic_lite.k = 0;
+}
+
+static bool _ack(gnrc_tcp_tcb_t *tcb, uint32_t acked)
+{
+    uint32_t smss = GET_SMSS(tcb);
+    /* Milliseconds of the 64 bit clock wrap only after 49 days, differences stay valid */
+    uint32_t now = (uint32_t)(xtimer_now_usec64() / US_PER_MS);
+    int64_t t;
+    int64_t target;
+
+    /* Slow start */
+    if (tcb->cwnd < tcb->ssthresh) {
+        tcb->cwnd += (acked < smss) ? acked : smss;
+        return false;
+    }
+
+    /* Start of a new epoch: time to grow back to w_max (K) */
+    if (tcb->cc_state.cubic_lite.epoch == 0) {
+        tcb->cc_state.cubic_lite.epoch = (now != 0) ? now : 1;
+        if (tcb->cc_state.cubic_lite.w_max <= tcb->cwnd) {
+            tcb->cc_state.cubic_lite.k = 0;
+            tcb->cc_state.cubic_lite.w_max = tcb->cwnd;
+        }
+        else {
+            /* K^3 = (w_max - cwnd) / C in segments and seconds, here in ms */
+            uint64_t diff = (((uint64_t)(tcb->cc_state.cubic_lite.w_max - tcb->cwnd)) << 10) /
+                            smss;
+            tcb->cc_state.cubic_lite.k = _cbrt((diff * 1000000000ULL) / C);
+        }
+    }
+
+    /* Target window: W(t) = C * (t - K)^3 + w_max */
+    t = (int64_t)(now - tcb->cc_state.cubic_lite.epoch) - tcb->cc_state.cubic_lite.k;
+    t = (t > T_MAX_MS) ? T_MAX_MS : ((t < -T_MAX_MS) ? -T_MAX_MS : t);
+    target = (((C * t * t * t) / 1024) / 1000000) * smss / 1000;
+    target += tcb->cc_state.cubic_lite.w_max;
+
+    /* Grow by at most half the window per RTT (see RFC 8312, 4.1) */
+    if (target > (int64_t)tcb->cwnd + (tcb->cwnd / 2)) {
+        target = (int64_t)tcb->cwnd + (tcb->cwnd / 2);
+    }
+
+    /* Grow by (target - cwnd) / cwnd segments per ACK, at least by 1% of a segment */
+    if (target > (int64_t)tcb->cwnd) {
+        tcb->cwnd += (uint32_t)(((target - tcb->cwnd) * smss) / tcb->cwnd);
+    }
+    else {
+        uint32_t inc = (smss * smss) / (100 * tcb->cwnd);
+        tcb->cwnd += (inc > 0) ? inc : 1;
+    }
+    return false;
+}
+
+static bool _dup_ack(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = GET_SMSS(tcb);
+
+    /* Reduce only once per window, further losses are left to the RTO */
+    if (tcb->dup_acks != GNRC_TCP_DUPACK_THRESHOLD ||
+        LSS_32_BIT(tcb->snd_una, tcb->cc_state.cubic_lite.recover)) {
+        return false;
+    }
+    DEBUG("gnrc_tcp_cc_cubic_lite.c : _dup_ack() : reduce window\n");
+    _reduce(tcb, smss);
+    tcb->cwnd = tcb->ssthresh;
+    return true;
+}
+
+static void _timeout(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = GET_SMSS(tcb);
+
+    /* Reduce only once for repeated timeouts of the same segment */
+    if (tcb->retries == 0) {
+        _reduce(tcb, smss);
+    }
+    /* Loss window */
+    tcb->cwnd = smss;
+    tcb->cc_state.cubic_lite.recover = tcb->snd_nxt;
+}
+
+const gnrc_tcp_cc_t gnrc_tcp_cc_cubic_lite = {
+    .name = "cubic-lite",
+    .init = _init,
+    .ack = _ack,
+    .dup_ack = _dup_ack,
+    .timeout = _timeout,
+};
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_tcp_cc
+ * @{
+ *
+ * @file
+ * @brief       NewReno congestion control (RFC 5681, RFC 6582)
+ * @}
+ */
+
+#include "net/gnrc/tcp/cc.h"
+#include "internal/common.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief Initial window (see RFC 5681, 3.1).
+ */
+static uint32_t _initial_window(uint32_t smss)
+{
+    if (smss > 2190) {
+        return 2 * smss;
+    }
+    return (smss > 1095) ? 3 * smss : 4 * smss;
+}
+
+/**
+ * @brief Slow start threshold after a loss (see RFC 5681, equation 4).
+ */
+static uint32_t _reduced_ssthresh(const gnrc_tcp_tcb_t *tcb, uint32_t smss)
+{
+    uint32_t half = GET_FLIGHT_SIZE(tcb) / 2;
+
+    return (half > 2 * smss) ? half : 2 * smss;
+}
+
+static void _init(gnrc_tcp_tcb_t *tcb)
+{
+    tcb->cwnd = _initial_window(GET_SMSS(tcb));
+    tcb->ssthresh = UINT32_MAX;
+    tcb->cc_state.newreno.recover = tcb->iss;
+    tcb->cc_state.newreno.recovery = false;
+}
+
+static bool _ack(gnrc_tcp_tcb_t *tcb, uint32_t acked)
+{
+    uint32_t smss = GET_SMSS(tcb);
+
+    if (tcb->cc_state.newreno.recovery) {
+        /* Full acknowledgment: deflate the window to ssthresh and leave fast recovery.
+         * Bursts are bounded by GNRC_TCP_SND_QUEUE_SIZE, so no need to limit cwnd further. */
+        if (LEQ_32_BIT(tcb->cc_state.newreno.recover, tcb->snd_una)) {
+            tcb->cwnd = tcb->ssthresh;
+            tcb->cc_state.newreno.recovery = false;
+            DEBUG("gnrc_tcp_cc_newreno.c : _ack() : leave fast recovery\n");
+            return false;
+        }
+        /* Partial acknowledgment: deflate by the acked data, retransmit next segment */
+        tcb->cwnd = (tcb->cwnd > acked) ? tcb->cwnd - acked : 0;
+        if (acked >= smss) {
+            tcb->cwnd += smss;
+        }
+        if (tcb->cwnd < smss) {
+            tcb->cwnd = smss;
+        }
+        return true;
+    }
+
+    /* Slow start */
+    if (tcb->cwnd < tcb->ssthresh) {
+        tcb->cwnd += (acked < smss) ? acked : smss;
+    }
+    /* Congestion avoidance: one SMSS per RTT */
+    else {
+        uint32_t inc = (smss * smss) / tcb->cwnd;
+        tcb->cwnd += (inc > 0) ? inc : 1;
+    }
+    return false;
+}
+
+static bool _dup_ack(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = GET_SMSS(tcb);
+
+    /* Inflate window for every segment that left the network */
+    if (tcb->cc_state.newreno.recovery) {
+        tcb->cwnd += smss;
+        return false;
+    }
+    if (tcb->dup_acks != GNRC_TCP_DUPACK_THRESHOLD) {
+        return false;
+    }
+    /* Don't enter fast recovery again for losses of the same window */
+    if (LEQ_32_BIT(tcb->snd_una, tcb->cc_state.newreno.recover)) {
+        return false;
+    }
+    DEBUG("gnrc_tcp_cc_newreno.c : _dup_ack() : enter fast recovery\n");
+    tcb->cc_state.newreno.recover = tcb->snd_nxt;
+    tcb->cc_state.newreno.recovery = true;
+    tcb->ssthresh = _reduced_ssthresh(tcb, smss);
+    tcb->cwnd = tcb->ssthresh + GNRC_TCP_DUPACK_THRESHOLD * smss;
+    return true;
+}
+
+static void _timeout(gnrc_tcp_tcb_t *tcb)
+{
+    uint32_t smss = GET_SMSS(tcb);
+
+    /* Reduce ssthresh only once for repeated timeouts of the same segment */
+    if (tcb->retries == 0) {
+        tcb->ssthresh = _reduced_ssthresh(tcb, smss);
+    }
+    /* Loss window */
+    tcb->cwnd = smss;
+    tcb->cc_state.newreno.recover = tcb->snd_nxt;
+    tcb->cc_state.newreno.recovery = false;
+}
+
+const gnrc_tcp_cc_t gnrc_tcp_cc_newreno = {
+    .name = "newreno",
+    .init = _init,
+    .ack = _ack,
+    .dup_ack = _dup_ack,
+    .timeout = _timeout,
+};
@@ -263,6 +263,13 @@ void *_event_loop(__attribute__((unused)) void *arg)
                      NULL, NULL, 0);
                 break;
 
+            /* Listen retry timer expired: Call FSM with listen event */
+            case MSG_TYPE_LISTEN:
+                DEBUG("gnrc_tcp_eventloop.c : _event_loop() : MSG_TYPE_LISTEN\n");
+                _fsm((gnrc_tcp_tcb_t *)msg.content.ptr, FSM_EVENT_TIMEOUT_LISTEN,
+                     NULL, NULL, 0);
+                break;
+
             default:
                 DEBUG("gnrc_tcp_eventloop.c : _event_loop() : received expected message\n");
         }
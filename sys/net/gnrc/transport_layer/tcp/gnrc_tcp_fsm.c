@@ -80,11 +80,15 @@ static uint16_t _get_random_local_port(void)
  */
 static int _clear_retransmit(gnrc_tcp_tcb_t *tcb)
 {
-    if (tcb->pkt_retransmit != NULL) {
-        gnrc_pktbuf_release(tcb->pkt_retransmit);
+    if (tcb->pkt_retransmit_numof > 0) {
+        for (unsigned i = 0; i < tcb->pkt_retransmit_numof; i++) {
+            gnrc_pktbuf_release(tcb->pkt_retransmit[i]);
+        }
         xtimer_remove(&(tcb->tim_tout));
-        tcb->pkt_retransmit = NULL;
+        tcb->pkt_retransmit_numof = 0;
     }
+    tcb->dup_acks = 0;
+    tcb->status &= ~STATUS_RTT_PENDING;
     return 0;
 }
 
@@ -189,6 +193,11 @@ static int _transition_to(gnrc_tcp_tcb_t *tcb, fsm_state_t state)
             break;
 
         case FSM_STATE_ESTABLISHED:
+            /* Peers MSS is known now: setup congestion window */
+            tcb->cc->init(tcb);
+            tcb->status |= STATUS_NOTIFY_USER;
+            break;
+
         case FSM_STATE_CLOSE_WAIT:
             tcb->status |= STATUS_NOTIFY_USER;
             break;
@@ -263,24 +272,32 @@ static int _fsm_call_send(gnrc_tcp_tcb_t *tcb, void *buf, size_t len)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_call_send()\n");
 
-    size_t payload = (tcb->snd_una + tcb->snd_wnd) - tcb->snd_nxt;
+    size_t sent = 0;
+
+    /* Usable window is limited by the peers receive window and the congestion window */
+    uint32_t wnd = (tcb->snd_wnd < tcb->cwnd) ? tcb->snd_wnd : tcb->cwnd;
+
+    /* Send segments as long as the window is open and the retransmit queue has space */
+    while (sent < len && tcb->pkt_retransmit_numof < GNRC_TCP_SND_QUEUE_SIZE &&
+           LSS_32_BIT(tcb->snd_nxt, tcb->snd_una + wnd)) {
+        size_t payload = (tcb->snd_una + wnd) - tcb->snd_nxt;
 
-    /* Check if window is open and all packets were transmitted */
-    if (payload > 0 && tcb->snd_wnd > 0 && tcb->pkt_retransmit == NULL) {
         /* Calculate segment size */
-        payload = (payload < GNRC_TCP_MSS) ? payload : GNRC_TCP_MSS;
-        payload = (payload < tcb->mss) ? payload : tcb->mss;
-        payload = (payload < len) ? payload : len;
+        payload = (payload < GET_SMSS(tcb)) ? payload : GET_SMSS(tcb);
+        payload = (payload < (len - sent)) ? payload : (len - sent);
 
         /* Calculate payload size for this segment */
         gnrc_pktsnip_t *out_pkt = NULL;
         uint16_t seq_con = 0;
-        _pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK | MSK_PSH, tcb->snd_nxt, tcb->rcv_nxt, buf, payload);
+        if (_pkt_build(tcb, &out_pkt, &seq_con, MSK_ACK | MSK_PSH, tcb->snd_nxt, tcb->rcv_nxt,
+                       (uint8_t *)buf + sent, payload) < 0) {
+            break;
+        }
         _pkt_setup_retransmit(tcb, out_pkt, false);
         _pkt_send(tcb, out_pkt, seq_con, false);
-        return payload;
+        sent += payload;
     }
-    return 0;
+    return sent;
 }
 
 /**
@@ -614,8 +631,35 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 tcb->state == FSM_STATE_CLOSING || tcb->state == FSM_STATE_LAST_ACK) {
                 /* Acknowledge previously sent data */
                 if (LSS_32_BIT(tcb->snd_una, seg_ack) && LEQ_32_BIT(seg_ack, tcb->snd_nxt)) {
+                    uint32_t acked = seg_ack - tcb->snd_una;
+
                     tcb->snd_una = seg_ack;
+                    tcb->dup_acks = 0;
                     _pkt_acknowledge(tcb, seg_ack);
+
+                    /* Congestion control, retransmit on partial ACKs if requested */
+                    if (tcb->cc->ack(tcb, acked) && tcb->pkt_retransmit_numof > 0) {
+                        gnrc_pktbuf_hold(tcb->pkt_retransmit[0], 1);
+                        _pkt_send(tcb, tcb->pkt_retransmit[0], 0, true);
+                    }
+
+                    /* Signal user: the windows or the retransmit queue have space */
+                    tcb->status |= STATUS_NOTIFY_USER;
+                }
+                /* Duplicate ACK: a segment after snd_una reached the peer (see RFC 5681) */
+                else if (seg_ack == tcb->snd_una && pay_len == 0 && seg_wnd == tcb->snd_wnd &&
+                         !(ctl & (MSK_SYN | MSK_FIN)) && tcb->pkt_retransmit_numof > 0) {
+                    if (tcb->dup_acks < UINT8_MAX) {
+                        tcb->dup_acks++;
+                    }
+                    /* Fast retransmit: resend oldest segment without waiting for the RTO */
+                    if (tcb->cc->dup_ack(tcb)) {
+                        DEBUG("gnrc_tcp_fsm.c : _fsm_rcvd_pkt() : Fast retransmit\n");
+                        gnrc_pktbuf_hold(tcb->pkt_retransmit[0], 1);
+                        _pkt_send(tcb, tcb->pkt_retransmit[0], 0, true);
+                    }
+                    /* Signal user: the congestion window may have been inflated */
+                    tcb->status |= STATUS_NOTIFY_USER;
                 }
                 /* ACK received for something not yet sent: Reply with pure ACK */
                 else if (LSS_32_BIT(tcb->snd_nxt, seg_ack)) {
@@ -639,25 +683,25 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 /* Additional processing */
                 /* Check additionaly if previously sent FIN was acknowledged */
                 if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->pkt_retransmit_numof == 0) {
                         _transition_to(tcb, FSM_STATE_FIN_WAIT_2);
                     }
                 }
                 /* If retransmission queue is empty, acknowledge close operation */
                 if (tcb->state == FSM_STATE_FIN_WAIT_2) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->pkt_retransmit_numof == 0) {
                         /* Optional: Unblock user close operation */
                     }
                 }
                 /* If our FIN has been acknowledged: Transition to TIME_WAIT */
                 if (tcb->state == FSM_STATE_CLOSING) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->pkt_retransmit_numof == 0) {
                         _transition_to(tcb, FSM_STATE_TIME_WAIT);
                     }
                 }
                 /* If our FIN was acknowledged and status is LAST_ACK: close connection */
                 if (tcb->state == FSM_STATE_LAST_ACK) {
-                    if (tcb->pkt_retransmit == NULL) {
+                    if (tcb->pkt_retransmit_numof == 0) {
                         _transition_to(tcb, FSM_STATE_CLOSED);
                         return 0;
                     }
@@ -711,7 +755,7 @@ static int _fsm_rcvd_pkt(gnrc_tcp_tcb_t *tcb, gnrc_pktsnip_t *in_pkt)
                 _transition_to(tcb, FSM_STATE_CLOSE_WAIT);
             }
             else if (tcb->state == FSM_STATE_FIN_WAIT_1) {
-                if (tcb->pkt_retransmit == NULL) {
+                if (tcb->pkt_retransmit_numof == 0) {
                     _transition_to(tcb, FSM_STATE_TIME_WAIT);
                 }
                 else {
@@ -753,9 +797,18 @@ static int _fsm_timeout_timewait(gnrc_tcp_tcb_t *tcb)
 static int _fsm_timeout_retransmit(gnrc_tcp_tcb_t *tcb)
 {
     DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit()\n");
-    if (tcb->pkt_retransmit != NULL) {
-        _pkt_setup_retransmit(tcb, tcb->pkt_retransmit, true);
-        _pkt_send(tcb, tcb->pkt_retransmit, 0, true);
+    if (tcb->pkt_retransmit_numof > 0) {
+        /* Asynchronous connections have no connection timeout: give up after some retries */
+        if (tcb->cb != NULL && tcb->retries >= GNRC_TCP_ASYNC_MAX_RETRIES) {
+            DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit() : Peer unreachable\n");
+            _transition_to(tcb, FSM_STATE_CLOSED);
+            return 0;
+        }
+        /* Go on with the oldest segment, cumulative ACKs release the others */
+        tcb->cc->timeout(tcb);
+        tcb->dup_acks = 0;
+        _pkt_setup_retransmit(tcb, tcb->pkt_retransmit[0], true);
+        _pkt_send(tcb, tcb->pkt_retransmit[0], 0, true);
     }
     else {
         DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_retransmit() : Retransmit queue is empty\n");
@@ -811,6 +864,51 @@ static int _fsm_clear_retransmit(gnrc_tcp_tcb_t *tcb)
     return 0;
 }
 
+/**
+ * @brief Puts a closed TCB of a listener back into LISTEN.
+ *
+ * If the receive buffer could not be allocated, the TCB tries again after
+ * GNRC_TCP_LISTEN_RETRY.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ */
+static void _listener_rearm(gnrc_tcp_tcb_t *tcb)
+{
+    DEBUG("gnrc_tcp_fsm.c : _listener_rearm()\n");
+    tcb->status &= (STATUS_PASSIVE | STATUS_ALLOW_ANY_ADDR | STATUS_LISTENER);
+    tcb->mss = 0;
+    tcb->rtt_var = RTO_UNINITIALIZED;
+    tcb->srtt = RTO_UNINITIALIZED;
+    tcb->rto = RTO_UNINITIALIZED;
+    tcb->retries = 0;
+    tcb->dup_acks = 0;
+    tcb->retransmits = 0;
+    if (_fsm_call_open(tcb) < 0) {
+        DEBUG("gnrc_tcp_fsm.c : _listener_rearm() : No receive buffer, retry later\n");
+        xtimer_remove(&tcb->tim_tout);
+        tcb->msg_tout.type = MSG_TYPE_LISTEN;
+        tcb->msg_tout.content.ptr = (void *)tcb;
+        xtimer_set_msg(&tcb->tim_tout, GNRC_TCP_LISTEN_RETRY, &tcb->msg_tout, gnrc_tcp_pid);
+    }
+}
+
+/**
+ * @brief FSM handling function for retrying to listen.
+ *
+ * @param[in,out] tcb   TCB holding the connection information.
+ *
+ * @returns   Zero on success.
+ */
+static int _fsm_timeout_listen(gnrc_tcp_tcb_t *tcb)
+{
+    DEBUG("gnrc_tcp_fsm.c : _fsm_timeout_listen()\n");
+    /* The listener may have been stopped in the meantime */
+    if ((tcb->status & STATUS_LISTENER) && tcb->state == FSM_STATE_CLOSED) {
+        _listener_rearm(tcb);
+    }
+    return 0;
+}
+
 /**
  * @brief FSM function (not synchronized).
  *
@@ -865,15 +963,70 @@ static int _fsm_unprotected(gnrc_tcp_tcb_t *tcb, fsm_event_t event, gnrc_pktsnip
         case FSM_EVENT_CLEAR_RETRANSMIT :
             ret = _fsm_clear_retransmit(tcb);
             break;
+        case FSM_EVENT_TIMEOUT_LISTEN :
+            ret = _fsm_timeout_listen(tcb);
+            break;
     }
     return ret;
 }
 
+/**
+ * @brief Derives the events of an asynchronous connection from its state change.
+ *
+ * @param[in] tcb       TCB holding the connection information.
+ * @param[in] state     Connection state before the FSM was called.
+ * @param[in] snd_una   snd_una before the FSM was called.
+ * @param[in] snd_wnd   snd_wnd before the FSM was called.
+ * @param[in] rcv_nxt   rcv_nxt before the FSM was called.
+ *
+ * @returns   Events to report to the user.
+ */
+static unsigned _get_events(gnrc_tcp_tcb_t *tcb, uint8_t state, uint32_t snd_una,
+                            uint16_t snd_wnd, uint32_t rcv_nxt)
+{
+    unsigned events = 0;
+
+    /* Handshake completed */
+    if ((state == FSM_STATE_SYN_SENT || state == FSM_STATE_SYN_RCVD) &&
+        (tcb->state == FSM_STATE_ESTABLISHED || tcb->state == FSM_STATE_CLOSE_WAIT)) {
+        events |= (tcb->status & STATUS_LISTENER) ? GNRC_TCP_EVENT_ACCEPT
+                                                  : GNRC_TCP_EVENT_CONNECTED;
+    }
+    /* Connections of a listener are unknown to the user until they are accepted */
+    if ((tcb->status & STATUS_LISTENER) && !(tcb->status & STATUS_ACCEPTED)) {
+        return events;
+    }
+    if (state != FSM_STATE_CLOSED && tcb->state == FSM_STATE_CLOSED) {
+        return events | GNRC_TCP_EVENT_CLOSED;
+    }
+    /* Data or FIN received */
+    if (state != FSM_STATE_LISTEN && state != FSM_STATE_SYN_SENT && tcb->rcv_nxt != rcv_nxt) {
+        events |= GNRC_TCP_EVENT_RECV;
+    }
+    /* Data acknowledged or window update */
+    if ((tcb->state == FSM_STATE_ESTABLISHED || tcb->state == FSM_STATE_CLOSE_WAIT) &&
+        (tcb->snd_una != snd_una || tcb->snd_wnd != snd_wnd) &&
+        !(events & GNRC_TCP_EVENT_CONNECTED)) {
+        events |= GNRC_TCP_EVENT_SEND;
+    }
+    return events;
+}
+
 int _fsm(gnrc_tcp_tcb_t *tcb, fsm_event_t event, gnrc_pktsnip_t *in_pkt, void *buf, size_t len)
 {
+    unsigned events = 0;
+
     /* Lock FSM */
     mutex_lock(&(tcb->fsm_lock));
 
+    /* Remember what asynchronous users are notified about */
+    uint8_t state = tcb->state;
+    uint32_t snd_una = tcb->snd_una;
+    uint16_t snd_wnd = tcb->snd_wnd;
+    uint32_t rcv_nxt = tcb->rcv_nxt;
+    gnrc_tcp_cb_t cb = tcb->cb;
+    void *cb_arg = tcb->cb_arg;
+
     /* Call FSM */
     tcb->status &= ~STATUS_NOTIFY_USER;
     int32_t result = _fsm_unprotected(tcb, event, in_pkt, buf, len);
@@ -884,7 +1037,24 @@ int _fsm(gnrc_tcp_tcb_t *tcb, fsm_event_t event, gnrc_pktsnip_t *in_pkt, void *b
         msg.type = MSG_TYPE_NOTIFY_USER;
         mbox_try_put(&(tcb->mbox), &msg);
     }
+
+    /* Asynchronous users are notified of everything not caused by their own calls */
+    if (cb != NULL && event >= FSM_EVENT_RCVD_PKT) {
+        events = _get_events(tcb, state, snd_una, snd_wnd, rcv_nxt);
+    }
+
+    /* Connections of a listener are reused once they are closed */
+    if ((tcb->status & STATUS_LISTENER) && state != FSM_STATE_CLOSED &&
+        tcb->state == FSM_STATE_CLOSED) {
+        _listener_rearm(tcb);
+    }
+
     /* Unlock FSM */
     mutex_unlock(&(tcb->fsm_lock));
+
+    /* Call the callback without lock, so it can use the asynchronous API */
+    if (events) {
+        cb(tcb, events, cb_arg);
+    }
     return result;
 }
@@ -49,6 +49,9 @@ extern "C" {
 #define STATUS_ALLOW_ANY_ADDR (1 << 1)
 #define STATUS_NOTIFY_USER    (1 << 2)
 #define STATUS_WAIT_FOR_MSG   (1 << 3)
+#define STATUS_RTT_PENDING    (1 << 4)
+#define STATUS_LISTENER       (1 << 5)
+#define STATUS_ACCEPTED       (1 << 6)
 /** @} */
 
 /**
@@ -89,6 +92,7 @@ extern "C" {
 #define MSG_TYPE_RETRANSMISSION     (GNRC_NETAPI_MSG_TYPE_ACK + 104)
 #define MSG_TYPE_TIMEWAIT           (GNRC_NETAPI_MSG_TYPE_ACK + 105)
 #define MSG_TYPE_NOTIFY_USER        (GNRC_NETAPI_MSG_TYPE_ACK + 106)
+#define MSG_TYPE_LISTEN             (GNRC_NETAPI_MSG_TYPE_ACK + 107)
 /** @} */
 
 /**
@@ -112,6 +116,17 @@ extern "C" {
  */
 #define INSIDE_WND(l_ed, seq_num, r_ed) (LEQ_32_BIT(l_ed, seq_num) && LSS_32_BIT(seq_num, r_ed))
 
+/**
+ * @brief Sender MSS: the peers MSS limited by GNRC_TCP_MSS, 536 if the peer sent none.
+ */
+#define GET_SMSS(tcb) (((tcb)->mss == 0) ? 536U : \
+                       (((tcb)->mss < GNRC_TCP_MSS) ? (tcb)->mss : GNRC_TCP_MSS))
+
+/**
+ * @brief Number of bytes sent but not yet acknowledged.
+ */
+#define GET_FLIGHT_SIZE(tcb) ((uint32_t)((tcb)->snd_nxt - (tcb)->snd_una))
+
 /**
  * @brief Extract offset value from "offctl" field in TCP header.
  */
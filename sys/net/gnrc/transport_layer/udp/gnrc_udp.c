@@ -28,6 +28,9 @@
 #include "net/gnrc/udp.h"
 #include "net/gnrc.h"
 #include "net/inet_csum.h"
+#ifdef MODULE_NETSTATS_EXT
+#include "net/netstats/ext.h"
+#endif
 
 
 #define ENABLE_DEBUG    (0)
@@ -104,6 +107,9 @@ static void _receive(gnrc_pktsnip_t *pkt)
     udp_hdr_t *hdr;
     uint32_t port;
 
+#ifdef MODULE_NETSTATS_EXT
+    netstats_ext_latency(NETSTATS_EXT_LAYER_TRANSPORT, pkt->rx_time);
+#endif
     /* mark UDP header */
     udp = gnrc_pktbuf_start_write(pkt);
     if (udp == NULL) {
@@ -142,11 +148,17 @@ static void _receive(gnrc_pktsnip_t *pkt)
          * and should log the error."
          */
         DEBUG("udp: received packet with zero checksum, dropping it\n");
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_TRANSPORT, NETSTATS_EXT_DROP_CSUM);
+#endif
         gnrc_pktbuf_release(pkt);
         return;
     }
     if (_calc_csum(udp, ipv6, pkt) != 0xFFFF) {
         DEBUG("udp: received packet with invalid checksum, dropping it\n");
+#ifdef MODULE_NETSTATS_EXT
+        netstats_ext_drop(NETSTATS_EXT_LAYER_TRANSPORT, NETSTATS_EXT_DROP_CSUM);
+#endif
         gnrc_pktbuf_release(pkt);
         return;
     }
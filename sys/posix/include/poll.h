@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  posix_sockets
+ * @{
+ *
+ * @file
+ * @brief   Input/output multiplexing
+ *
+ * @note    Only available with a @ref net_sock_poll implementation, e.g.
+ *          `gnrc_sock_poll`.
+ *
+ * @see <a href="http://pubs.opengroup.org/onlinepubs/9699919799/basedefs/poll.h.html">
+ *          The Open Group Base Specification Issue 7, poll.h
+ *      </a>
+ */
+#ifndef POLL_H
+#define POLL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    Event flags for struct pollfd
+ * @{
+ */
+#define POLLIN      (0x0001)    /**< Data other than high-priority data may be
+                                 *   read without blocking */
+#define POLLRDNORM  (0x0001)    /**< Normal data may be read without blocking */
+#define POLLPRI     (0x0002)    /**< High priority data may be read without
+                                 *   blocking (never set) */
+#define POLLOUT     (0x0004)    /**< Normal data may be written without
+                                 *   blocking */
+#define POLLWRNORM  (0x0004)    /**< Equivalent to POLLOUT */
+#define POLLERR     (0x0008)    /**< An error has occurred (revents only) */
+#define POLLHUP     (0x0010)    /**< Device has been disconnected (revents
+                                 *   only) */
+#define POLLNVAL    (0x0020)    /**< Invalid fd member (revents only) */
+/** @} */
+
+/**
+ * @brief   Type for the number of entries in an array of struct pollfd
+ */
+typedef unsigned int nfds_t;
+
+/**
+ * @brief   File descriptor to wait for with poll()
+ */
+struct pollfd {
+    int fd;             /**< The following descriptor being polled */
+    short events;       /**< The input event flags */
+    short revents;      /**< The output event flags */
+};
+
+/**
+ * @brief   Waits for one of a set of sockets to become ready
+ *
+ * @see <a href="http://pubs.opengroup.org/onlinepubs/9699919799/functions/poll.html">
+ *          The Open Group Base Specification Issue 7, poll()
+ *      </a>
+ *
+ * @note    Only sockets of type `SOCK_DGRAM` and `SOCK_RAW` are supported.
+ *          Other file descriptors get `POLLNVAL` in pollfd::revents.
+ *
+ * @param[in,out] fds   Array of file descriptors to wait for.
+ * @param[in] nfds      Number of entries in @p fds.
+ * @param[in] timeout   Timeout in milliseconds. -1 to wait indefinitely.
+ *
+ * @return  Number of entries in @p fds with a non-zero pollfd::revents.
+ * @return  0, if @p timeout expired.
+ * @return  -1 on error, errno is set to indicate the error.
+ */
+int poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POLL_H */
+/** @} */
@@ -27,6 +27,7 @@
 #include "net/ipv4/addr.h"
 #include "net/ipv6/addr.h"
 #include "random.h"
+#include "timex.h"
 #include "vfs.h"
 
 #include "sys/socket.h"
@@ -36,6 +37,13 @@
 #include "net/sock/udp.h"
 #include "net/sock/tcp.h"
 
+#ifdef MODULE_SOCK_POLL
+#include <poll.h>
+#include <sys/select.h>
+
+#include "net/sock/poll.h"
+#endif
+
 /* enough to create sockets both with socket() and accept() */
 #define _ACTUAL_SOCKET_POOL_SIZE   (SOCKET_POOL_SIZE + \
                                     (SOCKET_POOL_SIZE * SOCKET_TCP_QUEUE_SIZE))
@@ -990,6 +998,169 @@ ssize_t sendto(int socket, const void *buffer, size_t length, int flags,
     return res;
 }
 
+#ifdef MODULE_SOCK_POLL
+static int _poll(struct pollfd *fds, nfds_t nfds, uint32_t timeout)
+{
+    sock_poll_t set[_ACTUAL_SOCKET_POOL_SIZE];
+    int res = 0;
+
+    if (nfds > _ACTUAL_SOCKET_POOL_SIZE) {
+        return -EINVAL;
+    }
+    mutex_lock(&_socket_pool_mutex);
+    for (nfds_t i = 0; i < nfds; i++) {
+        socket_t *s = (fds[i].fd < 0) ? NULL : _get_socket(fds[i].fd);
+
+        set[i].obj.udp = NULL;
+        set[i].type = SOCK_POLL_UDP;
+        fds[i].revents = 0;
+        if (fds[i].fd < 0) {
+            continue;
+        }
+        switch ((s != NULL) ? s->type : -1) {
+#ifdef MODULE_SOCK_IP
+            case SOCK_RAW:
+                set[i].type = SOCK_POLL_IP;
+                set[i].obj.ip = (s->sock) ? &s->sock->raw : NULL;
+                break;
+#endif
+#ifdef MODULE_SOCK_UDP
+            case SOCK_DGRAM:
+                set[i].obj.udp = (s->sock) ? &s->sock->udp : NULL;
+                break;
+#endif
+            default:
+                fds[i].revents = POLLNVAL;
+                break;
+        }
+        if (fds[i].revents == 0) {
+            /* datagrams are sent right away, so these are always writable */
+            fds[i].revents = fds[i].events & POLLOUT;
+        }
+        if (fds[i].revents != 0) {
+            /* don't wait if an entry is ready anyway */
+            timeout = 0;
+        }
+        if (!(fds[i].events & POLLIN)) {
+            set[i].obj.udp = NULL;
+        }
+    }
+    mutex_unlock(&_socket_pool_mutex);
+    sock_poll(set, nfds, timeout);
+    for (nfds_t i = 0; i < nfds; i++) {
+        if (set[i].ready) {
+            fds[i].revents |= POLLIN;
+        }
+        if (fds[i].revents != 0) {
+            res++;
+        }
+    }
+    return res;
+}
+
+int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    uint32_t timeout_us = SOCK_NO_TIMEOUT;
+    int res;
+
+    if (timeout >= 0) {
+        timeout_us = ((uint32_t)timeout < (UINT32_MAX / US_PER_MS))
+                   ? ((uint32_t)timeout * US_PER_MS)
+                   : (UINT32_MAX - 1);
+    }
+    res = _poll(fds, nfds, timeout_us);
+    if (res < 0) {
+        errno = -res;
+        return -1;
+    }
+    return res;
+}
+
+int select(int nfds, fd_set *restrict readfds, fd_set *restrict writefds,
+           fd_set *restrict errorfds, struct timeval *restrict timeout)
+{
+    struct pollfd fds[_ACTUAL_SOCKET_POOL_SIZE];
+    uint32_t timeout_us = SOCK_NO_TIMEOUT;
+    nfds_t numof = 0;
+    int res;
+
+    if ((nfds < 0) || (nfds > FD_SETSIZE)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (timeout != NULL) {
+        if ((timeout->tv_sec < 0) || (timeout->tv_usec < 0) ||
+            (timeout->tv_usec >= (suseconds_t)US_PER_SEC)) {
+            errno = EINVAL;
+            return -1;
+        }
+        /* clamp long timeouts, SOCK_NO_TIMEOUT would block forever */
+        timeout_us = SOCK_NO_TIMEOUT - 1;
+        if (timeout->tv_sec < (time_t)(SOCK_NO_TIMEOUT / US_PER_SEC)) {
+            uint64_t us = ((uint64_t)timeout->tv_sec * US_PER_SEC) +
+                          timeout->tv_usec;
+
+            if (us < SOCK_NO_TIMEOUT) {
+                timeout_us = (uint32_t)us;
+            }
+        }
+    }
+    for (int fd = 0; fd < nfds; fd++) {
+        short events = 0;
+
+        if ((readfds != NULL) && FD_ISSET(fd, readfds)) {
+            events |= POLLIN;
+        }
+        if ((writefds != NULL) && FD_ISSET(fd, writefds)) {
+            events |= POLLOUT;
+        }
+        if (events == 0) {
+            continue;
+        }
+        if (numof >= _ACTUAL_SOCKET_POOL_SIZE) {
+            /* more descriptors than sockets */
+            errno = EBADF;
+            return -1;
+        }
+        fds[numof].fd = fd;
+        fds[numof].events = events;
+        numof++;
+    }
+    if ((res = _poll(fds, numof, timeout_us)) < 0) {
+        errno = -res;
+        return -1;
+    }
+    res = 0;
+    for (nfds_t i = 0; i < numof; i++) {
+        if (fds[i].revents & POLLNVAL) {
+            errno = EBADF;
+            return -1;
+        }
+    }
+    if (readfds != NULL) {
+        FD_ZERO(readfds);
+    }
+    if (writefds != NULL) {
+        FD_ZERO(writefds);
+    }
+    if (errorfds != NULL) {
+        /* no exceptional conditions for datagram sockets */
+        FD_ZERO(errorfds);
+    }
+    for (nfds_t i = 0; i < numof; i++) {
+        if (fds[i].revents & POLLIN) {
+            FD_SET(fds[i].fd, readfds);
+            res++;
+        }
+        if (fds[i].revents & POLLOUT) {
+            FD_SET(fds[i].fd, writefds);
+            res++;
+        }
+    }
+    return res;
+}
+#endif /* MODULE_SOCK_POLL */
+
 /*
  * This is a partial implementation of setsockopt for changing the receive
  * timeout value of a socket.
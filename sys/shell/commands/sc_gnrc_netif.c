@@ -18,6 +18,7 @@
  * @author      Oliver Hahm <oliver.hahm@inria.fr>
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 
 #include "net/ipv6/addr.h"
@@ -29,6 +30,9 @@
 #ifdef MODULE_NETSTATS
 #include "net/netstats.h"
 #endif
+#ifdef MODULE_NETSTATS_RADIO
+#include "timex.h"
+#endif
 #ifdef MODULE_L2FILTER
 #include "net/l2filter.h"
 #endif
@@ -138,6 +142,41 @@ static int _netif_stats(kernel_pid_t iface, unsigned module, bool reset)
 }
 #endif /* MODULE_NETSTATS */
 
+#ifdef MODULE_NETSTATS_RADIO
+static const char *_radio_states[] = { "off", "sleep", "standby", "listen",
+                                       "rx", "tx" };
+
+static void _netif_radio_stats(kernel_pid_t iface, bool reset)
+{
+    netstats_radio_t stats;
+    unsigned duty_cycle;
+
+    gnrc_netif_radio_stats_get(gnrc_netif_get_by_pid(iface), &stats, reset);
+    if (reset) {
+        puts("Reset statistics for module radio!");
+        return;
+    }
+    duty_cycle = netstats_radio_duty_cycle(&stats);
+    printf("          Statistics for radio\n"
+           "            duty cycle %u.%02u %%  energy %" PRIu32 " uJ\n",
+           duty_cycle / 100, duty_cycle % 100,
+           (uint32_t)netstats_radio_energy(&stats, NETSTATS_RADIO_STATE_NUMOF));
+    for (unsigned i = 0; i < NETSTATS_RADIO_STATE_NUMOF; i++) {
+        uint32_t energy = netstats_radio_energy(&stats, i);
+
+        printf("            %-7s %10" PRIu32 " ms %8" PRIu32 " times %10"
+               PRIu32 " uJ", _radio_states[i],
+               (uint32_t)(stats.time[i] / US_PER_MS), stats.transitions[i],
+               energy);
+        if (((i == NETSTATS_RADIO_RX) || (i == NETSTATS_RADIO_TX)) &&
+            (stats.transitions[i] > 0)) {
+            printf(" (%" PRIu32 " uJ per frame)", energy / stats.transitions[i]);
+        }
+        puts("");
+    }
+}
+#endif
+
 static void _set_usage(char *cmd_name)
 {
     printf("usage: %s <if_id> set <key> <value>\n", cmd_name);
@@ -196,7 +235,7 @@ static void _del_usage(char *cmd_name)
 #ifdef MODULE_NETSTATS
 static void _stats_usage(char *cmd_name)
 {
-    printf("usage: %s <if_id> stats [l2|ipv6] [reset]\n", cmd_name);
+    printf("usage: %s <if_id> stats [l2|ipv6|radio] [reset]\n", cmd_name);
     puts("       reset can be only used if the module is specified.");
 }
 #endif
@@ -376,6 +415,28 @@ static void _netif_list_groups(ipv6_addr_t *addr)
 }
 #endif
 
+#ifdef MODULE_GNRC_NETIF_TXQ
+static void _netif_list_txq(kernel_pid_t iface)
+{
+    static const char *names[] = { "ctrl", "high", "default", "bulk" };
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(iface);
+
+    if (netif == NULL) {
+        return;
+    }
+    printf("          TX queue (%s)\n",
+           (netif->txq.sched == GNRC_NETIF_TXQ_SCHED_DRR) ? "DRR" : "strict");
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_CLASS_NUMOF; i++) {
+        gnrc_netif_txq_stats_t *stats = &netif->txq.stats[i];
+
+        printf("            %-7s queued %u (max %u)  sent %u  dropped %u\n",
+               names[i], (unsigned)stats->len, (unsigned)stats->max_len,
+               (unsigned)(stats->enqueued - stats->len),
+               (unsigned)stats->dropped);
+    }
+}
+#endif
+
 static void _netif_list(kernel_pid_t iface)
 {
 #ifdef MODULE_GNRC_IPV6
@@ -568,12 +629,19 @@ static void _netif_list(kernel_pid_t iface)
     }
 #endif
 
+#ifdef MODULE_GNRC_NETIF_TXQ
+    puts("");
+    _netif_list_txq(iface);
+#endif
 #ifdef MODULE_NETSTATS_L2
     puts("");
     _netif_stats(iface, NETSTATS_LAYER2, false);
 #endif
 #ifdef MODULE_NETSTATS_IPV6
     _netif_stats(iface, NETSTATS_IPV6, false);
+#endif
+#ifdef MODULE_NETSTATS_RADIO
+    _netif_radio_stats(iface, false);
 #endif
     puts("");
 }
@@ -1314,6 +1382,14 @@ int _gnrc_netif_config(int argc, char **argv)
                 else if (strcmp(argv[3], "ipv6") == 0) {
                     module = NETSTATS_IPV6;
                 }
+#ifdef MODULE_NETSTATS_RADIO
+                else if (strcmp(argv[3], "radio") == 0) {
+                    _netif_radio_stats((kernel_pid_t) iface,
+                                       (argc > 4) &&
+                                       (strncmp(argv[4], "reset", 5) == 0));
+                    return 1;
+                }
+#endif
                 else {
                     printf("Module %s doesn't exist or does not provide statistics.\n", argv[3]);
 
@@ -1330,6 +1406,11 @@ int _gnrc_netif_config(int argc, char **argv)
                 if (module & NETSTATS_IPV6) {
                     _netif_stats((kernel_pid_t) iface, NETSTATS_IPV6, reset);
                 }
+#ifdef MODULE_NETSTATS_RADIO
+                if ((module == NETSTATS_ALL) && !reset) {
+                    _netif_radio_stats((kernel_pid_t) iface, false);
+                }
+#endif
 
                 return 1;
             }
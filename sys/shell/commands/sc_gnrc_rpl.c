@@ -283,6 +283,10 @@ int _gnrc_rpl_dodag_show(void)
                ((dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO) ? "on" : "off"),
                (int) cleanup, (1 << dodag->dio_min), dodag->dio_interval_doubl, dodag->trickle.k,
                dodag->trickle.c, (uint32_t) (tc & 0xFFFFFFFF));
+        printf("\tDIO [sent: %" PRIu32 " | suppressed: %" PRIu32
+               " | heard: %" PRIu32 " | resets: %" PRIu32 "]\n",
+               dodag->trickle.stats.sent, dodag->trickle.stats.suppressed,
+               dodag->trickle.stats.heard, dodag->trickle.stats.resets);
 
 #ifdef MODULE_GNRC_RPL_P2P
         if (dodag->instance->mop == GNRC_RPL_P2P_MOP) {
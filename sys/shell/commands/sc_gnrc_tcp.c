@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_shell_commands
+ * @{
+ *
+ * @file
+ * @brief       Shell command to show the state of GNRC TCP connections
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "net/gnrc/tcp.h"
+
+int _gnrc_tcp(int argc, char **argv)
+{
+    gnrc_tcp_stats_t stats;
+    unsigned i;
+
+    if (argc > 1) {
+        printf("usage: %s\n", argv[0]);
+        return 1;
+    }
+    for (i = 0; gnrc_tcp_get_stats(i, &stats) == 0; i++) {
+        printf("%u: %s local port %" PRIu16 " peer port %" PRIu16 " (%s)\n", i,
+               stats.state, stats.local_port, stats.peer_port, stats.cc);
+        printf("   snd_wnd %" PRIu32 " cwnd %" PRIu32 " ssthresh ", stats.snd_wnd,
+               stats.cwnd);
+        if (stats.ssthresh == UINT32_MAX) {
+            printf("-");
+        }
+        else {
+            printf("%" PRIu32, stats.ssthresh);
+        }
+        printf(" in flight %" PRIu32 "\n", stats.flight_size);
+        printf("   srtt %" PRIi32 " us rto %" PRIi32 " us retransmits %" PRIu16 "\n",
+               stats.srtt, stats.rto, stats.retransmits);
+    }
+    if (i == 0) {
+        puts("no active connections");
+    }
+    return 0;
+}
+
+/** @} */
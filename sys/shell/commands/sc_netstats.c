@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_shell_commands
+ * @{
+ *
+ * @file
+ * @brief       Shell command to show extended packet statistics
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/netstats/ext.h"
+
+static const char *_layers[] = { "l2", "6lo", "ipv6", "transport", "sock" };
+static const char *_drops[] = { "pktbuf_full", "queue_full", "rbuf_full",
+                                "csum", "no_route" };
+
+static uint32_t _avg(const netstats_ext_hist_t *hist)
+{
+    return (hist->count > 0) ? (uint32_t)(hist->sum / hist->count) : 0;
+}
+
+static void _usage(char *cmd)
+{
+    printf("usage: %s [-j|reset]\n", cmd);
+}
+
+static void _print_layer(const netstats_ext_t *stats, unsigned layer)
+{
+    const netstats_ext_hist_t *hist = &stats->latency[layer];
+    netstats_ext_rates_t rates;
+
+    netstats_ext_rates(layer, &rates);
+    printf("%s:\n", _layers[layer]);
+    printf("  rate: RX %" PRIu32 " pkt/s %" PRIu32 " B/s, "
+           "TX %" PRIu32 " pkt/s %" PRIu32 " B/s\n",
+           rates.rx_count, rates.rx_bytes, rates.tx_count, rates.tx_bytes);
+    printf("  drops:");
+    for (unsigned i = 0; i < NETSTATS_EXT_DROP_NUMOF; i++) {
+        printf(" %s %" PRIu32, _drops[i], stats->drops[layer][i]);
+    }
+    puts("");
+    if (hist->count == 0) {
+        return;
+    }
+    printf("  latency: count %" PRIu32 " min %" PRIu32 " us avg %" PRIu32
+           " us max %" PRIu32 " us\n", hist->count, hist->min, _avg(hist),
+           hist->max);
+    for (unsigned i = 0; i < NETSTATS_EXT_HIST_BUCKETS; i++) {
+        if (hist->buckets[i] == 0) {
+            continue;
+        }
+        if (i < (NETSTATS_EXT_HIST_BUCKETS - 1)) {
+            printf("    < %8lu us: %" PRIu32 "\n",
+                   1LU << (NETSTATS_EXT_HIST_SHIFT + i), hist->buckets[i]);
+        }
+        else {
+            printf("   >= %8lu us: %" PRIu32 "\n",
+                   1LU << (NETSTATS_EXT_HIST_SHIFT + i - 1), hist->buckets[i]);
+        }
+    }
+}
+
+static void _print_json(const netstats_ext_t *stats)
+{
+    printf("{");
+    for (unsigned layer = 0; layer < NETSTATS_EXT_LAYER_NUMOF; layer++) {
+        const netstats_ext_hist_t *hist = &stats->latency[layer];
+        netstats_ext_rates_t rates;
+
+        netstats_ext_rates(layer, &rates);
+        printf("%s\"%s\":{\"rate\":{\"rx_pkts\":%" PRIu32 ",\"rx_bytes\":%"
+               PRIu32 ",\"tx_pkts\":%" PRIu32 ",\"tx_bytes\":%" PRIu32 "},",
+               (layer > 0) ? "," : "", _layers[layer],
+               rates.rx_count, rates.rx_bytes, rates.tx_count, rates.tx_bytes);
+        printf("\"drops\":{");
+        for (unsigned i = 0; i < NETSTATS_EXT_DROP_NUMOF; i++) {
+            printf("%s\"%s\":%" PRIu32, (i > 0) ? "," : "", _drops[i],
+                   stats->drops[layer][i]);
+        }
+        printf("},\"latency\":{\"count\":%" PRIu32 ",\"min\":%" PRIu32
+               ",\"avg\":%" PRIu32 ",\"max\":%" PRIu32 ",\"buckets\":[",
+               hist->count, hist->min, _avg(hist), hist->max);
+        for (unsigned i = 0; i < NETSTATS_EXT_HIST_BUCKETS; i++) {
+            printf("%s%" PRIu32, (i > 0) ? "," : "", hist->buckets[i]);
+        }
+        printf("]}}");
+    }
+    puts("}");
+}
+
+int _netstats(int argc, char **argv)
+{
+    const netstats_ext_t *stats = netstats_ext_get();
+
+    if (argc == 1) {
+        for (unsigned i = 0; i < NETSTATS_EXT_LAYER_NUMOF; i++) {
+            _print_layer(stats, i);
+        }
+    }
+    else if ((argc == 2) && (strcmp(argv[1], "-j") == 0)) {
+        _print_json(stats);
+    }
+    else if ((argc == 2) && (strcmp(argv[1], "reset") == 0)) {
+        netstats_ext_reset();
+    }
+    else {
+        _usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
+
+/** @} */
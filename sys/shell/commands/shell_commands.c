@@ -138,6 +138,14 @@ extern int _ls_handler(int argc, char **argv);
 extern int _can_handler(int argc, char **argv);
 #endif
 
+#ifdef MODULE_NETSTATS_EXT
+extern int _netstats(int argc, char **argv);
+#endif
+
+#ifdef MODULE_GNRC_TCP
+extern int _gnrc_tcp(int argc, char **argv);
+#endif
+
 const shell_command_t _shell_command_list[] = {
     {"reboot", "Reboot the node", _reboot_handler},
 #ifdef MODULE_CONFIG
@@ -225,6 +233,12 @@ const shell_command_t _shell_command_list[] = {
 #endif
 #ifdef MODULE_CONN_CAN
     {"can", "CAN commands", _can_handler},
+#endif
+#ifdef MODULE_NETSTATS_EXT
+    {"netstats", "Show extended packet statistics ('netstats [-j|reset]')", _netstats},
+#endif
+#ifdef MODULE_GNRC_TCP
+    {"tcp", "Show TCP connections and congestion control state", _gnrc_tcp},
 #endif
     {NULL, NULL, NULL}
 };
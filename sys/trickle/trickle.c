@@ -14,6 +14,8 @@
  * @author  Cenk Gündoğan <cenk.guendogan@haw-hamburg.de>
  */
 
+#include <string.h>
+
 #include "inttypes.h"
 #include "random.h"
 #include "trickle.h"
@@ -25,8 +27,12 @@ void trickle_callback(trickle_t *trickle)
 {
     /* Handle k=0 like k=infinity (according to RFC6206, section 6.5) */
     if ((trickle->c < trickle->k) || (trickle->k == 0)) {
+        trickle->stats.sent++;
         (*trickle->callback.func)(trickle->callback.args);
     }
+    else {
+        trickle->stats.suppressed++;
+    }
 
     trickle_interval(trickle);
 }
@@ -51,6 +57,7 @@ void trickle_interval(trickle_t *trickle)
     /* old_interval == trickle->I / 2 */
     trickle->t = random_uint32_range(old_interval, trickle->I);
 
+    trickle->start = xtimer_now_usec64() + ((uint64_t)diff * MS_PER_SEC);
     trickle->msg_time = (trickle->t + diff) * MS_PER_SEC;
     xtimer_set_msg64(&trickle->msg_timer, trickle->msg_time, &trickle->msg,
                      trickle->pid);
@@ -61,6 +68,7 @@ void trickle_reset_timer(trickle_t *trickle)
     assert(trickle->I > trickle->Imin);
 
     trickle_stop(trickle);
+    trickle->stats.resets++;
     trickle->I = trickle->t = trickle->Imin;
     trickle_interval(trickle);
 }
@@ -82,6 +90,7 @@ void trickle_start(kernel_pid_t pid, trickle_t *trickle, uint16_t msg_type,
     trickle->pid = pid;
     trickle->msg.content.ptr = trickle;
     trickle->msg.type = msg_type;
+    memset(&trickle->stats, 0, sizeof(trickle->stats));
 
     trickle_interval(trickle);
 }
@@ -93,5 +102,6 @@ void trickle_stop(trickle_t *trickle)
 
 void trickle_increment_counter(trickle_t *trickle)
 {
+    trickle->stats.heard++;
     trickle->c++;
 }
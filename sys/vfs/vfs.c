@@ -333,6 +333,28 @@ ssize_t vfs_write(int fd, const void *src, size_t count)
     return filp->f_op->write(filp, src, count);
 }
 
+int vfs_ftruncate(int fd, off_t length)
+{
+    DEBUG("vfs_ftruncate: %d, %ld\n", fd, (long)length);
+    if (length < 0) {
+        return -EINVAL;
+    }
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_WRONLY) && ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for writing */
+        return -EBADF;
+    }
+    if (filp->f_op->ftruncate == NULL) {
+        /* driver does not implement ftruncate() */
+        return -EINVAL;
+    }
+    return filp->f_op->ftruncate(filp, length);
+}
+
 int vfs_opendir(vfs_DIR *dirp, const char *dirname)
 {
     DEBUG("vfs_opendir: %p, \"%s\"\n", (void *)dirp, dirname);
@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the confirmed publishes of emCute against a gateway on
+ *              the loopback address
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "emcute_internal.h"
+#include "net/emcute.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define CLIENT_PORT         (EMCUTE_DEFAULT_PORT)
+#define GW_PORT             (EMCUTE_DEFAULT_PORT + 1)
+#define GW_BUF_SIZE         (64U)
+#define RX_NUMOF            (16U)
+#define TOPIC_ID            (0x1111)
+#define SUB_TOPIC_ID        (0x2222)
+#define RX_MSG_ID           (0x4242)
+#define WAIT_TIMEOUT        (5U * US_PER_SEC)
+#define WAIT_STEP           (10U * US_PER_MS)
+/* result of a publish not done yet */
+#define RES_NONE            (1)
+
+typedef struct {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t msg_id;
+} _rx_t;
+
+static const uint8_t _data[] = "emcute";
+
+static char _emcute_stack[THREAD_STACKSIZE_DEFAULT];
+static char _gw_stack[THREAD_STACKSIZE_DEFAULT];
+static uint8_t _gw_buf[GW_BUF_SIZE];
+static sock_udp_t _gw_sock;
+static sock_udp_ep_t _client;
+static emcute_topic_t _topic = { .name = "test" };
+static emcute_sub_t _sub;
+/* packets received by the gateway */
+static _rx_t _rx[RX_NUMOF];
+static volatile unsigned _rx_numof;
+/* results of the publishes, the index is the argument of the callback */
+static int _pub_res[EMCUTE_PUB_WINDOW + 1];
+static volatile unsigned _pub_done;
+/* publishes received on _sub */
+static volatile unsigned _delivered;
+
+static inline uint16_t _get_u16(const uint8_t *buf)
+{
+    return (uint16_t)((buf[0] << 8) | buf[1]);
+}
+
+static inline void _set_u16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = (uint8_t)(val >> 8);
+    buf[1] = (uint8_t)(val & 0xff);
+}
+
+static void _gw_reply(const uint8_t *buf, size_t len)
+{
+    sock_udp_send(&_gw_sock, buf, len, &_client);
+}
+
+static void *_gw(void *arg)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+
+    (void)arg;
+    local.port = GW_PORT;
+    if (sock_udp_create(&_gw_sock, &local, NULL, 0) < 0) {
+        return NULL;
+    }
+    while (1) {
+        ssize_t res = sock_udp_recv(&_gw_sock, _gw_buf, sizeof(_gw_buf),
+                                    SOCK_NO_TIMEOUT, &_client);
+        _rx_t *rx = &_rx[_rx_numof % RX_NUMOF];
+        uint8_t reply[8];
+
+        if ((res < 2) || (_gw_buf[0] != res)) {
+            continue;
+        }
+        memset(rx, 0, sizeof(*rx));
+        rx->type = _gw_buf[1];
+        switch (rx->type) {
+            case CONNECT:
+                reply[0] = 3;
+                reply[1] = CONNACK;
+                reply[2] = ACCEPT;
+                _gw_reply(reply, 3);
+                break;
+            case REGISTER:
+                reply[0] = 7;
+                reply[1] = REGACK;
+                _set_u16(&reply[2], TOPIC_ID);
+                memcpy(&reply[4], &_gw_buf[4], 2);
+                reply[6] = ACCEPT;
+                _gw_reply(reply, 7);
+                break;
+            case SUBSCRIBE:
+                reply[0] = 8;
+                reply[1] = SUBACK;
+                reply[2] = _gw_buf[2];
+                _set_u16(&reply[3], SUB_TOPIC_ID);
+                memcpy(&reply[5], &_gw_buf[3], 2);
+                reply[7] = ACCEPT;
+                _gw_reply(reply, 8);
+                break;
+            case UNSUBSCRIBE:
+                reply[0] = 4;
+                reply[1] = UNSUBACK;
+                memcpy(&reply[2], &_gw_buf[3], 2);
+                _gw_reply(reply, 4);
+                break;
+            case DISCONNECT:
+                reply[0] = 2;
+                reply[1] = DISCONNECT;
+                _gw_reply(reply, 2);
+                break;
+            case PUBLISH:
+                /* acknowledged by the tests */
+                rx->flags = _gw_buf[2];
+                rx->msg_id = _get_u16(&_gw_buf[5]);
+                break;
+            case PUBREC:
+            case PUBREL:
+            case PUBCOMP:
+                rx->msg_id = _get_u16(&_gw_buf[2]);
+                break;
+            default:
+                break;
+        }
+        _rx_numof++;
+    }
+    return NULL;
+}
+
+static void *_emcute(void *arg)
+{
+    (void)arg;
+    emcute_run(CLIENT_PORT, "test");
+    return NULL;
+}
+
+static void _pub_cb(void *arg, int res)
+{
+    _pub_res[(uintptr_t)arg] = res;
+    _pub_done++;
+}
+
+static void _on_pub(const emcute_topic_t *topic, void *data, size_t len)
+{
+    (void)topic;
+    (void)data;
+    (void)len;
+    _delivered++;
+}
+
+static bool _wait(volatile unsigned *counter, unsigned value)
+{
+    for (uint32_t t = 0; t < WAIT_TIMEOUT; t += WAIT_STEP) {
+        if (*counter >= value) {
+            return true;
+        }
+        xtimer_usleep(WAIT_STEP);
+    }
+    return false;
+}
+
+static void _send_pubresp(uint8_t type, uint16_t msg_id)
+{
+    uint8_t buf[7];
+
+    if (type == PUBACK) {
+        buf[0] = 7;
+        buf[1] = PUBACK;
+        _set_u16(&buf[2], TOPIC_ID);
+        _set_u16(&buf[4], msg_id);
+        buf[6] = ACCEPT;
+    }
+    else {
+        buf[0] = 4;
+        buf[1] = type;
+        _set_u16(&buf[2], msg_id);
+    }
+    _gw_reply(buf, buf[0]);
+}
+
+static void _send_publish(uint8_t flags)
+{
+    uint8_t buf[7 + sizeof(_data)];
+
+    buf[0] = sizeof(buf);
+    buf[1] = PUBLISH;
+    buf[2] = flags;
+    _set_u16(&buf[3], SUB_TOPIC_ID);
+    _set_u16(&buf[5], RX_MSG_ID);
+    memcpy(&buf[7], _data, sizeof(_data));
+    _gw_reply(buf, sizeof(buf));
+}
+
+static int _pub(uintptr_t idx, unsigned flags)
+{
+    return emcute_pub_async(&_topic, _data, sizeof(_data), flags, _pub_cb,
+                            (void *)idx);
+}
+
+static void set_up(void)
+{
+    _rx_numof = 0;
+    _pub_done = 0;
+    _delivered = 0;
+    for (unsigned i = 0; i < (sizeof(_pub_res) / sizeof(_pub_res[0])); i++) {
+        _pub_res[i] = RES_NONE;
+    }
+}
+
+static void test_emcute_pub__window(void)
+{
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub(i, EMCUTE_QOS_1));
+    }
+    TEST_ASSERT_EQUAL_INT(EMCUTE_BUSY, _pub(EMCUTE_PUB_WINDOW, EMCUTE_QOS_1));
+    TEST_ASSERT(_wait(&_rx_numof, EMCUTE_PUB_WINDOW));
+    for (unsigned i = 0; i < EMCUTE_PUB_WINDOW; i++) {
+        TEST_ASSERT_EQUAL_INT(PUBLISH, _rx[i].type);
+        TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_1, _rx[i].flags);
+        for (unsigned j = 0; j < i; j++) {
+            TEST_ASSERT(_rx[i].msg_id != _rx[j].msg_id);
+        }
+    }
+    /* a slot is free again once a publish is acknowledged */
+    _send_pubresp(PUBACK, _rx[0].msg_id);
+    TEST_ASSERT(_wait(&_pub_done, 1));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub_res[0]);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub(EMCUTE_PUB_WINDOW, EMCUTE_QOS_1));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_BUSY, _pub(EMCUTE_PUB_WINDOW, EMCUTE_QOS_1));
+    TEST_ASSERT(_wait(&_rx_numof, EMCUTE_PUB_WINDOW + 1));
+    /* acknowledge out of order */
+    for (unsigned i = EMCUTE_PUB_WINDOW + 1; i > 1; i--) {
+        _send_pubresp(PUBACK, _rx[i - 1].msg_id);
+    }
+    TEST_ASSERT(_wait(&_pub_done, EMCUTE_PUB_WINDOW + 1));
+    for (unsigned i = 0; i <= EMCUTE_PUB_WINDOW; i++) {
+        TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub_res[i]);
+    }
+}
+
+static void test_emcute_pub__retransmit(void)
+{
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub(0, EMCUTE_QOS_1));
+    TEST_ASSERT(_wait(&_rx_numof, 2));
+    TEST_ASSERT_EQUAL_INT(PUBLISH, _rx[0].type);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_1, _rx[0].flags);
+    TEST_ASSERT_EQUAL_INT(PUBLISH, _rx[1].type);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_1 | EMCUTE_DUP, _rx[1].flags);
+    TEST_ASSERT_EQUAL_INT(_rx[0].msg_id, _rx[1].msg_id);
+    TEST_ASSERT_EQUAL_INT(0, _pub_done);
+    _send_pubresp(PUBACK, _rx[0].msg_id);
+    TEST_ASSERT(_wait(&_pub_done, 1));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub_res[0]);
+}
+
+static void test_emcute_pub__qos2(void)
+{
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub(0, EMCUTE_QOS_2));
+    TEST_ASSERT(_wait(&_rx_numof, 1));
+    TEST_ASSERT_EQUAL_INT(PUBLISH, _rx[0].type);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_2, _rx[0].flags);
+    _send_pubresp(PUBREC, _rx[0].msg_id);
+    TEST_ASSERT(_wait(&_rx_numof, 2));
+    TEST_ASSERT_EQUAL_INT(PUBREL, _rx[1].type);
+    TEST_ASSERT_EQUAL_INT(_rx[0].msg_id, _rx[1].msg_id);
+    TEST_ASSERT_EQUAL_INT(0, _pub_done);
+    _send_pubresp(PUBCOMP, _rx[0].msg_id);
+    TEST_ASSERT(_wait(&_pub_done, 1));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub_res[0]);
+}
+
+static void test_emcute_sub__qos2_exactly_once(void)
+{
+    _sub.cb = _on_pub;
+    _sub.topic.name = "test/sub";
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_sub(&_sub, EMCUTE_QOS_2));
+    TEST_ASSERT_EQUAL_INT(SUB_TOPIC_ID, _sub.topic.id);
+    TEST_ASSERT(_wait(&_rx_numof, 1));
+
+    _send_publish(EMCUTE_QOS_2);
+    TEST_ASSERT(_wait(&_rx_numof, 2));
+    TEST_ASSERT_EQUAL_INT(PUBREC, _rx[1].type);
+    TEST_ASSERT_EQUAL_INT(RX_MSG_ID, _rx[1].msg_id);
+    TEST_ASSERT(_wait(&_delivered, 1));
+    /* the PUBREC got lost, the gateway retransmits */
+    _send_publish(EMCUTE_QOS_2 | EMCUTE_DUP);
+    TEST_ASSERT(_wait(&_rx_numof, 3));
+    TEST_ASSERT_EQUAL_INT(PUBREC, _rx[2].type);
+    TEST_ASSERT_EQUAL_INT(RX_MSG_ID, _rx[2].msg_id);
+    _send_pubresp(PUBREL, RX_MSG_ID);
+    TEST_ASSERT(_wait(&_rx_numof, 4));
+    TEST_ASSERT_EQUAL_INT(PUBCOMP, _rx[3].type);
+    TEST_ASSERT_EQUAL_INT(RX_MSG_ID, _rx[3].msg_id);
+    TEST_ASSERT_EQUAL_INT(1, _delivered);
+
+    /* the message ID is free for a new message once released */
+    _send_publish(EMCUTE_QOS_2);
+    TEST_ASSERT(_wait(&_rx_numof, 5));
+    TEST_ASSERT_EQUAL_INT(PUBREC, _rx[4].type);
+    TEST_ASSERT(_wait(&_delivered, 2));
+    _send_pubresp(PUBREL, RX_MSG_ID);
+    TEST_ASSERT(_wait(&_rx_numof, 6));
+    TEST_ASSERT_EQUAL_INT(PUBCOMP, _rx[5].type);
+
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_unsub(&_sub));
+    TEST_ASSERT_EQUAL_INT(2, _delivered);
+}
+
+/* must be the last test, as it disconnects from the gateway */
+static void test_emcute_discon__flush(void)
+{
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub(0, EMCUTE_QOS_1));
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, _pub(1, EMCUTE_QOS_2));
+    TEST_ASSERT(_wait(&_rx_numof, 2));
+    TEST_ASSERT_EQUAL_INT(0, _pub_done);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_OK, emcute_discon());
+    /* called from emcute_discon() */
+    TEST_ASSERT_EQUAL_INT(2, _pub_done);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW, _pub_res[0]);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW, _pub_res[1]);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_NOGW, _pub(0, EMCUTE_QOS_1));
+}
+
+static Test *tests_emcute(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_emcute_pub__window),
+        new_TestFixture(test_emcute_pub__retransmit),
+        new_TestFixture(test_emcute_pub__qos2),
+        new_TestFixture(test_emcute_sub__qos2_exactly_once),
+        new_TestFixture(test_emcute_discon__flush),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    sock_udp_ep_t gw = { .family = AF_INET6, .port = GW_PORT };
+
+    ipv6_addr_set_loopback((ipv6_addr_t *)&gw.addr.ipv6);
+    thread_create(_gw_stack, sizeof(_gw_stack), THREAD_PRIORITY_MAIN - 2,
+                  THREAD_CREATE_STACKTEST, _gw, NULL, "gateway");
+    thread_create(_emcute_stack, sizeof(_emcute_stack),
+                  THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                  _emcute, NULL, "emcute");
+
+    if ((emcute_con(&gw, true, NULL, NULL, 0, 0) != EMCUTE_OK) ||
+        (emcute_reg(&_topic) != EMCUTE_OK) || (_topic.id != TOPIC_ID)) {
+        puts("error: unable to connect to the gateway");
+        return 1;
+    }
+
+    TESTS_START();
+    TESTS_RUN(tests_emcute());
+    TESTS_END();
+
+    return 0;
+}
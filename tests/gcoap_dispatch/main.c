@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for gcoap resource dispatch
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+#include "xtimer.h"
+
+#ifndef RESOURCES_NUMOF
+#define RESOURCES_NUMOF     (128U)
+#endif
+
+#define GROUP_SIZE          (16U)
+#define LISTENERS_NUMOF     ((RESOURCES_NUMOF + GROUP_SIZE - 1) / GROUP_SIZE)
+#define PATH_LEN            (sizeof("/g00/r00"))
+#define REQS_NUMOF          (GROUP_SIZE + 2)
+#define REQ_BUF_SIZE        (32U)
+#define ITERATIONS          (1000U)
+
+static char paths[RESOURCES_NUMOF][PATH_LEN];
+static coap_resource_t resources[RESOURCES_NUMOF];
+static gcoap_listener_t listeners[LISTENERS_NUMOF];
+
+static uint8_t req_bufs[REQS_NUMOF][REQ_BUF_SIZE];
+static coap_pkt_t reqs[REQS_NUMOF];
+
+static ssize_t _handler(coap_pkt_t *pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    return gcoap_response(pdu, buf, len, COAP_CODE_CONTENT);
+}
+
+/* resource lookup of gcoap before the trie: compares the request path with
+ * every resource path, resources of a listener are ordered alphabetically */
+static int _find_linear(coap_pkt_t *pdu, coap_resource_t **resource_ptr)
+{
+    int ret = GCOAP_RESOURCE_NO_PATH;
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+
+    for (unsigned l = 0; l < LISTENERS_NUMOF; l++) {
+        for (size_t i = 0; i < listeners[l].resources_len; i++) {
+            coap_resource_t *resource = &listeners[l].resources[i];
+            int res = strcmp((char *)pdu->url, resource->path);
+
+            if (res > 0) {
+                continue;
+            }
+            else if (res < 0) {
+                break;
+            }
+            if (!(resource->methods & method_flag)) {
+                ret = GCOAP_RESOURCE_WRONG_METHOD;
+                continue;
+            }
+            *resource_ptr = resource;
+            return GCOAP_RESOURCE_FOUND;
+        }
+    }
+    return ret;
+}
+
+static int _find_trie(coap_pkt_t *pdu, coap_resource_t **resource_ptr)
+{
+    gcoap_listener_t *listener;
+
+    return gcoap_find_resource(pdu, resource_ptr, &listener);
+}
+
+static void _init_req(unsigned i, unsigned code, char *path)
+{
+    ssize_t len = gcoap_request(&reqs[i], req_bufs[i], REQ_BUF_SIZE, code,
+                                path);
+
+    if ((len <= 0) || (coap_parse(&reqs[i], req_bufs[i], len) < 0)) {
+        printf("error: can't build request for %s\n", path);
+    }
+}
+
+static void _run(const char *name,
+                 int (*find)(coap_pkt_t *, coap_resource_t **))
+{
+    coap_resource_t *resource;
+    unsigned found = 0;
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned n = 0; n < ITERATIONS; n++) {
+        for (unsigned i = 0; i < REQS_NUMOF; i++) {
+            found += (find(&reqs[i], &resource) == GCOAP_RESOURCE_FOUND);
+        }
+    }
+
+    uint32_t duration = xtimer_now_usec() - start;
+    printf("%s: %lu ns per lookup (%u found)\n", name,
+           (unsigned long)(((uint64_t)duration * 1000) /
+                           (ITERATIONS * REQS_NUMOF)),
+           found / ITERATIONS);
+}
+
+int main(void)
+{
+    unsigned numof = 0;
+
+    puts("gcoap resource dispatch benchmark");
+
+    for (unsigned l = 0; l < LISTENERS_NUMOF; l++) {
+        listeners[l].resources = &resources[numof];
+        for (unsigned i = 0; (i < GROUP_SIZE) && (numof < RESOURCES_NUMOF);
+             i++, numof++) {
+            snprintf(paths[numof], PATH_LEN, "/g%02u/r%02u", l, i);
+            resources[numof].path = paths[numof];
+            resources[numof].methods = COAP_GET;
+            resources[numof].handler = _handler;
+            resources[numof].context = NULL;
+            listeners[l].resources_len++;
+        }
+        if (gcoap_register_listener(&listeners[l]) < 0) {
+            printf("error: can't register listener %u\n", l);
+            return 1;
+        }
+    }
+
+    /* spread the requests over all resources, towards the end of the groups
+     * as the linear search in the last group has to pass all groups before */
+    for (unsigned i = 0; i < GROUP_SIZE; i++) {
+        unsigned idx = (i * RESOURCES_NUMOF) / GROUP_SIZE;
+
+        idx += ((RESOURCES_NUMOF / GROUP_SIZE) > 1) ?
+               (RESOURCES_NUMOF / GROUP_SIZE) - 1 : 0;
+        _init_req(i, COAP_METHOD_GET, paths[idx]);
+    }
+    _init_req(GROUP_SIZE, COAP_METHOD_GET, "/g00/none");
+    _init_req(GROUP_SIZE + 1, COAP_METHOD_POST, paths[RESOURCES_NUMOF - 1]);
+
+    printf("%u resources, %u lookups\n", RESOURCES_NUMOF,
+           ITERATIONS * REQS_NUMOF);
+    _run("linear", _find_linear);
+    _run("trie", _find_trie);
+
+    puts("done");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Request rate benchmark for gcoap over the loopback address
+ *
+ * @}
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef REQUESTS_NUMOF
+#define REQUESTS_NUMOF      (1000U)
+#endif
+
+#ifndef WINDOW
+#define WINDOW              (4U)
+#endif
+
+/* must hold a message for every request in the window */
+#define MAIN_QUEUE_SIZE     (16U)
+
+#if WINDOW > MAIN_QUEUE_SIZE
+#error "WINDOW must not exceed MAIN_QUEUE_SIZE"
+#endif
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static kernel_pid_t _main_pid;
+
+static ssize_t _rate_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             void *ctx)
+{
+    (void)ctx;
+    return gcoap_response(pdu, buf, len, COAP_CODE_CONTENT);
+}
+
+static const coap_resource_t _resources[] = {
+    { "/rate", COAP_GET, _rate_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+/* runs on the gcoap thread */
+static void _resp_handler(unsigned req_state, coap_pkt_t *pdu,
+                          sock_udp_ep_t *remote)
+{
+    msg_t msg;
+
+    (void)pdu;
+    (void)remote;
+    msg.content.value = req_state;
+    msg_try_send(&msg, _main_pid);
+}
+
+static bool _send(const sock_udp_ep_t *remote)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    ssize_t len = gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET,
+                                "/rate");
+    return (len > 0) &&
+           (gcoap_req_send2(buf, len, remote, _resp_handler) > 0);
+}
+
+int main(void)
+{
+    sock_udp_ep_t remote = { .family = AF_INET6,
+                             .netif = SOCK_ADDR_ANY_NETIF,
+                             .port = GCOAP_PORT };
+    unsigned sent = 0, done = 0, failed = 0;
+
+    _main_pid = thread_getpid();
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    ipv6_addr_set_loopback((ipv6_addr_t *)&remote.addr.ipv6);
+    if (gcoap_register_listener(&_listener) < 0) {
+        puts("error: can't register listener");
+        return 1;
+    }
+
+    printf("gcoap request rate benchmark: %u requests, window %u\n",
+           REQUESTS_NUMOF, WINDOW);
+
+    uint32_t start = xtimer_now_usec();
+    while ((sent < WINDOW) && (sent < REQUESTS_NUMOF)) {
+        if (!_send(&remote)) {
+            break;
+        }
+        sent++;
+    }
+    while (done < sent) {
+        msg_t msg;
+
+        msg_receive(&msg);
+        done++;
+        if (msg.content.value != GCOAP_MEMO_RESP) {
+            failed++;
+        }
+        /* the memo of the response is freed once the gcoap thread, which has
+         * the higher priority, returned from _resp_handler() */
+        while ((sent < REQUESTS_NUMOF) && (sent - done < WINDOW)) {
+            if (!_send(&remote)) {
+                failed++;
+                done++;
+            }
+            sent++;
+        }
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+
+    printf("%u requests in %lu us: %lu requests/s, %u failed\n", sent,
+           (unsigned long)duration,
+           (unsigned long)(((uint64_t)sent * US_PER_SEC) /
+                           ((duration > 0) ? duration : 1)),
+           failed);
+    puts("done");
+    return 0;
+}
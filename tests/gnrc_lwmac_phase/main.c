@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the phase tracking of LWMAC
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gnrc/lwmac/lwmac.h"
+#include "include/lwmac_internal.h"
+
+#define INTERVAL    RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_INTERVAL_US)
+#define SCALE       GNRC_LWMAC_PHASE_DRIFT_SCALE
+#define WEIGHT      ((int32_t)GNRC_LWMAC_PHASE_DRIFT_WEIGHT)
+
+static gnrc_mac_tx_neighbor_t _neighbor;
+
+static void _init(uint32_t phase, int32_t drift, uint32_t sync)
+{
+    memset(&_neighbor, 0, sizeof(_neighbor));
+    _neighbor.phase = phase;
+    _neighbor.phase_drift = drift;
+    _neighbor.phase_sync = sync;
+}
+
+static void test_neighbor_phase__no_drift(void)
+{
+    _init(100, 0, 12345);
+    TEST_ASSERT_EQUAL_INT(100, _gnrc_lwmac_neighbor_phase(&_neighbor,
+                                                          12345 + (3 * INTERVAL) + 7));
+}
+
+static void test_neighbor_phase__drift(void)
+{
+    _init(100, 2 * SCALE, 0);
+    TEST_ASSERT_EQUAL_INT(120, _gnrc_lwmac_neighbor_phase(&_neighbor,
+                                                          10 * INTERVAL));
+    _init(100, -2 * SCALE, 0);
+    TEST_ASSERT_EQUAL_INT(80, _gnrc_lwmac_neighbor_phase(&_neighbor,
+                                                         10 * INTERVAL));
+}
+
+static void test_neighbor_phase__wrap_around(void)
+{
+    /* the corrected phase leaves the interval */
+    _init(5, -2 * SCALE, 0);
+    TEST_ASSERT_EQUAL_INT(INTERVAL - 15,
+                          _gnrc_lwmac_neighbor_phase(&_neighbor, 10 * INTERVAL));
+    _init(INTERVAL - 5, 2 * SCALE, 0);
+    TEST_ASSERT_EQUAL_INT(15, _gnrc_lwmac_neighbor_phase(&_neighbor,
+                                                         10 * INTERVAL));
+    /* the RTT overflows since the phase was learned */
+    _init(100, 2 * SCALE, UINT32_MAX - (4 * INTERVAL));
+    TEST_ASSERT_EQUAL_INT(120, _gnrc_lwmac_neighbor_phase(&_neighbor,
+                                                          _neighbor.phase_sync +
+                                                          (10 * INTERVAL)));
+}
+
+static void test_phase_guard(void)
+{
+    _init(100, 0, 4242);
+    TEST_ASSERT_EQUAL_INT(0, _gnrc_lwmac_phase_guard(&_neighbor, 4242));
+    TEST_ASSERT_EQUAL_INT(GNRC_LWMAC_PHASE_GUARD_PPM,
+                          _gnrc_lwmac_phase_guard(&_neighbor, 4242 + US_PER_SEC));
+    /* the RTT overflows since the phase was learned */
+    _init(100, 0, UINT32_MAX - 99);
+    TEST_ASSERT_EQUAL_INT(GNRC_LWMAC_PHASE_GUARD_PPM,
+                          _gnrc_lwmac_phase_guard(&_neighbor,
+                                                  _neighbor.phase_sync + US_PER_SEC));
+}
+
+static void test_phase_outdated(void)
+{
+    const uint64_t half = INTERVAL / 2;
+    /* last ticks with a guard time of at most half an interval */
+    const uint32_t in = (half * US_PER_SEC) / GNRC_LWMAC_PHASE_GUARD_PPM;
+    /* first ticks with a guard time beyond half an interval */
+    const uint32_t out = (((half + 1) * US_PER_SEC) +
+                          GNRC_LWMAC_PHASE_GUARD_PPM - 1) /
+                         GNRC_LWMAC_PHASE_GUARD_PPM;
+
+    _init(100, 0, 0);
+    TEST_ASSERT(!_gnrc_lwmac_phase_outdated(&_neighbor, 0));
+    TEST_ASSERT(!_gnrc_lwmac_phase_outdated(&_neighbor, in));
+    TEST_ASSERT(_gnrc_lwmac_phase_outdated(&_neighbor, out));
+    _init(100, 0, UINT32_MAX - 99);
+    TEST_ASSERT(!_gnrc_lwmac_phase_outdated(&_neighbor, _neighbor.phase_sync + in));
+    TEST_ASSERT(_gnrc_lwmac_phase_outdated(&_neighbor, _neighbor.phase_sync + out));
+}
+
+static void test_phase_learn__unknown(void)
+{
+    _init(GNRC_MAC_PHASE_MAX, 0, 0);
+    _neighbor.phase_misses = 1;
+    _gnrc_lwmac_phase_learn(&_neighbor, 42, 10 * INTERVAL);
+    TEST_ASSERT_EQUAL_INT(42, _neighbor.phase);
+    TEST_ASSERT_EQUAL_INT(10 * INTERVAL, _neighbor.phase_sync);
+    TEST_ASSERT_EQUAL_INT(0, _neighbor.phase_drift);
+    TEST_ASSERT_EQUAL_INT(0, _neighbor.phase_misses);
+}
+
+static void test_phase_learn__drift(void)
+{
+    /* 8 ticks late after 4 intervals: a sample of 2 ticks per interval */
+    _init(100, 0, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, 108, 4 * INTERVAL);
+    TEST_ASSERT_EQUAL_INT(108, _neighbor.phase);
+    TEST_ASSERT_EQUAL_INT(4 * INTERVAL, _neighbor.phase_sync);
+    TEST_ASSERT_EQUAL_INT((2 * SCALE) / WEIGHT, _neighbor.phase_drift);
+    /* a prediction hitting the phase keeps the drift */
+    _init(100, 2 * SCALE, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, 108, 4 * INTERVAL);
+    TEST_ASSERT_EQUAL_INT(2 * SCALE, _neighbor.phase_drift);
+    /* the drift converges towards the samples */
+    _init(100, 0, 0);
+    for (unsigned i = 1; i <= 64; i++) {
+        _gnrc_lwmac_phase_learn(&_neighbor, 100 + (2 * i), i * INTERVAL);
+    }
+    TEST_ASSERT((2 * SCALE) - _neighbor.phase_drift < WEIGHT);
+}
+
+static void test_phase_learn__burst(void)
+{
+    /* no drift measurable within the same interval */
+    _init(100, SCALE, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, 108, INTERVAL - 1);
+    TEST_ASSERT_EQUAL_INT(108, _neighbor.phase);
+    TEST_ASSERT_EQUAL_INT(SCALE, _neighbor.phase_drift);
+}
+
+static void test_phase_learn__wrap_around(void)
+{
+    /* the phase crosses the interval boundary forth and back */
+    _init(INTERVAL - 2, 0, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, 2, 4 * INTERVAL);
+    TEST_ASSERT_EQUAL_INT(SCALE / WEIGHT, _neighbor.phase_drift);
+    _init(2, 0, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, INTERVAL - 2, 4 * INTERVAL);
+    TEST_ASSERT_EQUAL_INT(-SCALE / WEIGHT, _neighbor.phase_drift);
+    /* the RTT overflows since the phase was learned */
+    _init(100, 0, UINT32_MAX - INTERVAL);
+    _gnrc_lwmac_phase_learn(&_neighbor, 108, _neighbor.phase_sync + (4 * INTERVAL));
+    TEST_ASSERT_EQUAL_INT((2 * SCALE) / WEIGHT, _neighbor.phase_drift);
+}
+
+static void test_phase_learn__bound(void)
+{
+    const uint32_t now = 4 * INTERVAL;
+    int32_t max_offset;
+
+    /* predicted phase is 104 */
+    _init(100, SCALE, 0);
+    max_offset = RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_DURATION_US) +
+                 _gnrc_lwmac_phase_guard(&_neighbor, now);
+    _gnrc_lwmac_phase_learn(&_neighbor, 104 + max_offset, now);
+    TEST_ASSERT_EQUAL_INT(SCALE + ((max_offset * SCALE) / 4) / WEIGHT,
+                          _neighbor.phase_drift);
+    /* a larger offset is a reselected phase */
+    _init(100, SCALE, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, 104 + max_offset + 1, now);
+    TEST_ASSERT_EQUAL_INT(104 + max_offset + 1, _neighbor.phase);
+    TEST_ASSERT_EQUAL_INT(0, _neighbor.phase_drift);
+    _init(100, SCALE, 0);
+    _gnrc_lwmac_phase_learn(&_neighbor, 104 - max_offset - 1, now);
+    TEST_ASSERT_EQUAL_INT(0, _neighbor.phase_drift);
+}
+
+static Test *tests_gnrc_lwmac_phase(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_neighbor_phase__no_drift),
+        new_TestFixture(test_neighbor_phase__drift),
+        new_TestFixture(test_neighbor_phase__wrap_around),
+        new_TestFixture(test_phase_guard),
+        new_TestFixture(test_phase_outdated),
+        new_TestFixture(test_phase_learn__unknown),
+        new_TestFixture(test_phase_learn__drift),
+        new_TestFixture(test_phase_learn__burst),
+        new_TestFixture(test_phase_learn__wrap_around),
+        new_TestFixture(test_phase_learn__bound),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, NULL, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_lwmac_phase());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the pcapng file written by gnrc_pktcapture
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "mutex.h"
+#include "net/ethernet.h"
+#include "net/ethertype.h"
+#include "net/gnrc.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/gnrc/pktcapture.h"
+#include "net/netdev_test.h"
+#include "thread.h"
+#include "xtimer.h"
+
+/* declares the host's byte order functions, so included last */
+#include "native_internal.h"
+
+#define CAPTURE_FILE    "gnrc_pktcapture_test.pcapng"
+#define RX_LEN          (200U)
+#define OTHER_LEN       (4U)
+
+/**
+ * @name    Offsets and lengths of the blocks in the capture file
+ *
+ * Section header block, interface description block of the Ethernet
+ * interface, enhanced packet blocks of the sent and the received frame,
+ * interface description block and enhanced packet block of the other
+ * interface.
+ * @{
+ */
+#define SHB_LEN         (28U)
+#define IDB_LEN         (20U)
+#define EPB_TX_LEN      (64U)   /* 14 + 5 bytes of frame, padded to 20 */
+#define EPB_RX_LEN      (172U)  /* truncated to GNRC_PKTCAPTURE_SNAPLEN */
+#define EPB_OTHER_LEN   (48U)
+#define IDB_OFFSET      (SHB_LEN)
+#define EPB_TX_OFFSET   (IDB_OFFSET + IDB_LEN)
+#define EPB_RX_OFFSET   (EPB_TX_OFFSET + EPB_TX_LEN)
+#define IDB_OTHER_OFFSET (EPB_RX_OFFSET + EPB_RX_LEN)
+#define EPB_OTHER_OFFSET (IDB_OTHER_OFFSET + IDB_LEN)
+#define FILE_LEN        (EPB_OTHER_OFFSET + EPB_OTHER_LEN)
+/** @} */
+
+/* offset of the packet data within an enhanced packet block */
+#define EPB_DATA        (28U)
+
+static const uint8_t _l2addr[] = { 0x02, 0, 0, 0, 0, 0x01 };
+static const uint8_t _dst[] = { 0x02, 0, 0, 0, 0, 0x02 };
+static const uint8_t _payload[] = { 0xde, 0xad, 0xbe, 0xef, 0x42 };
+
+static netdev_test_t _netdev;
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static gnrc_netif_t *_netif;
+static mutex_t _sent = MUTEX_INIT_LOCKED;
+static uint8_t _rx[RX_LEN];
+static uint8_t _file[FILE_LEN + 64];
+static int _file_len;
+static int _start_res, _busy_res;
+static uint64_t _start, _end;
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static int _get_address(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len >= sizeof(_l2addr));
+    memcpy(value, _l2addr, sizeof(_l2addr));
+    return sizeof(_l2addr);
+}
+
+static int _send(netdev_t *dev, const iolist_t *iolist)
+{
+    (void)dev;
+    mutex_unlock(&_sent);
+    return iolist_size(iolist);
+}
+
+static uint32_t _word(unsigned offset)
+{
+    uint32_t word;
+
+    memcpy(&word, &_file[offset], sizeof(word));
+    return word;
+}
+
+static uint64_t _time(unsigned epb)
+{
+    return ((uint64_t)_word(epb + 12) << 32) | _word(epb + 16);
+}
+
+static void _check_idb(unsigned offset, uint32_t linktype)
+{
+    TEST_ASSERT_EQUAL_INT(0x00000001, _word(offset));
+    TEST_ASSERT_EQUAL_INT(IDB_LEN, _word(offset + 4));
+    TEST_ASSERT_EQUAL_INT(linktype, _word(offset + 8));
+    TEST_ASSERT_EQUAL_INT(GNRC_PKTCAPTURE_SNAPLEN, _word(offset + 12));
+    TEST_ASSERT_EQUAL_INT(IDB_LEN, _word(offset + 16));
+}
+
+static void _check_epb(unsigned offset, uint32_t block_len, uint32_t if_id,
+                       uint32_t caplen, uint32_t len, uint32_t flags)
+{
+    unsigned opts = offset + block_len - 16;
+
+    TEST_ASSERT_EQUAL_INT(0x00000006, _word(offset));
+    TEST_ASSERT_EQUAL_INT(block_len, _word(offset + 4));
+    TEST_ASSERT_EQUAL_INT(if_id, _word(offset + 8));
+    TEST_ASSERT(_time(offset) >= _start);
+    TEST_ASSERT(_time(offset) <= _end);
+    TEST_ASSERT_EQUAL_INT(caplen, _word(offset + 20));
+    TEST_ASSERT_EQUAL_INT(len, _word(offset + 24));
+    /* packet data is padded with zeros to 32 bit */
+    for (unsigned i = offset + EPB_DATA + caplen; i < opts; i++) {
+        TEST_ASSERT_EQUAL_INT(0, _file[i]);
+    }
+    /* epb_flags with the direction, opt_endofopt */
+    TEST_ASSERT_EQUAL_INT(2U | (4U << 16), _word(opts));
+    TEST_ASSERT_EQUAL_INT(flags, _word(opts + 4));
+    TEST_ASSERT_EQUAL_INT(0, _word(opts + 8));
+    TEST_ASSERT_EQUAL_INT(block_len, _word(opts + 12));
+}
+
+static void test_pktcapture__start(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _start_res);
+    TEST_ASSERT_EQUAL_INT(-EBUSY, _busy_res);
+}
+
+static void test_pktcapture__file_len(void)
+{
+    TEST_ASSERT_EQUAL_INT(FILE_LEN, _file_len);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_pktcapture_dropped());
+}
+
+static void test_pktcapture__shb(void)
+{
+    TEST_ASSERT_EQUAL_INT(0x0a0d0d0a, _word(0));
+    TEST_ASSERT_EQUAL_INT(SHB_LEN, _word(4));
+    TEST_ASSERT_EQUAL_INT(0x1a2b3c4d, _word(8));
+    /* major version 1, minor version 0 */
+    TEST_ASSERT_EQUAL_INT(1, _word(12));
+    /* section length not specified */
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, _word(16));
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, _word(20));
+    TEST_ASSERT_EQUAL_INT(SHB_LEN, _word(24));
+}
+
+static void test_pktcapture__idb(void)
+{
+    _check_idb(IDB_OFFSET, GNRC_PKTCAPTURE_LINKTYPE_ETHERNET);
+    _check_idb(IDB_OTHER_OFFSET, GNRC_PKTCAPTURE_LINKTYPE_IEEE802154);
+}
+
+static void test_pktcapture__epb_tx(void)
+{
+    const uint8_t *data = &_file[EPB_TX_OFFSET + EPB_DATA];
+    size_t len = sizeof(ethernet_hdr_t) + sizeof(_payload);
+    ethernet_hdr_t hdr;
+
+    _check_epb(EPB_TX_OFFSET, EPB_TX_LEN, 0, len, len, 0x2);
+    memcpy(&hdr, data, sizeof(hdr));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(hdr.dst, _dst, sizeof(_dst)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(hdr.src, _l2addr, sizeof(_l2addr)));
+    TEST_ASSERT_EQUAL_INT(ETHERTYPE_UNKNOWN, byteorder_ntohs(hdr.type));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&data[sizeof(hdr)], _payload,
+                                    sizeof(_payload)));
+}
+
+static void test_pktcapture__epb_rx(void)
+{
+    _check_epb(EPB_RX_OFFSET, EPB_RX_LEN, 0, GNRC_PKTCAPTURE_SNAPLEN, RX_LEN,
+               0x1);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&_file[EPB_RX_OFFSET + EPB_DATA], _rx,
+                                    GNRC_PKTCAPTURE_SNAPLEN));
+    TEST_ASSERT(_time(EPB_RX_OFFSET) >= _time(EPB_TX_OFFSET));
+}
+
+static void test_pktcapture__epb_other(void)
+{
+    _check_epb(EPB_OTHER_OFFSET, EPB_OTHER_LEN, 1, OTHER_LEN, OTHER_LEN,
+               0x1);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&_file[EPB_OTHER_OFFSET + EPB_DATA], _rx,
+                                    OTHER_LEN));
+}
+
+static Test *tests_gnrc_pktcapture(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_pktcapture__start),
+        new_TestFixture(test_pktcapture__file_len),
+        new_TestFixture(test_pktcapture__shb),
+        new_TestFixture(test_pktcapture__idb),
+        new_TestFixture(test_pktcapture__epb_tx),
+        new_TestFixture(test_pktcapture__epb_rx),
+        new_TestFixture(test_pktcapture__epb_other),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, NULL, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+static int _read_file(void)
+{
+    int fd, res;
+
+    _native_syscall_enter();
+    if ((fd = real_open(CAPTURE_FILE, O_RDONLY)) < 0) {
+        res = -errno;
+    }
+    else {
+        res = real_read(fd, _file, sizeof(_file));
+        real_close(fd);
+    }
+    real_unlink(CAPTURE_FILE);
+    _native_syscall_leave();
+    return res;
+}
+
+static void _capture(void)
+{
+    gnrc_pktsnip_t *pkt, *hdr;
+    iolist_t rx = { .iol_base = _rx, .iol_len = sizeof(_rx) };
+    iolist_t other = { .iol_base = _rx, .iol_len = OTHER_LEN };
+
+    for (unsigned i = 0; i < sizeof(_rx); i++) {
+        _rx[i] = i;
+    }
+    _start = xtimer_now_usec64();
+    _start_res = gnrc_pktcapture_start(CAPTURE_FILE);
+    _busy_res = gnrc_pktcapture_start(CAPTURE_FILE);
+    /* a frame sent by the interface */
+    pkt = gnrc_pktbuf_add(NULL, (void *)_payload, sizeof(_payload),
+                          GNRC_NETTYPE_UNDEF);
+    hdr = gnrc_netif_hdr_build(NULL, 0, (uint8_t *)_dst, sizeof(_dst));
+    assert((pkt != NULL) && (hdr != NULL));
+    hdr->next = pkt;
+    gnrc_netapi_send(_netif->pid, hdr);
+    mutex_lock(&_sent);
+    /* a received frame exceeding the snap length and a frame of another
+     * interface */
+    gnrc_pktcapture_add(_netif->pid, GNRC_PKTCAPTURE_LINKTYPE_ETHERNET, false,
+                        &rx);
+    gnrc_pktcapture_add(thread_getpid(), GNRC_PKTCAPTURE_LINKTYPE_IEEE802154,
+                        false, &other);
+    _end = xtimer_now_usec64();
+    gnrc_pktcapture_stop();
+    /* the writer thread runs while this thread is sleeping */
+    xtimer_usleep(100U * US_PER_MS);
+    _file_len = _read_file();
+}
+
+static void _init(void)
+{
+    netdev_test_setup(&_netdev, 0);
+    netdev_test_set_get_cb(&_netdev, NETOPT_DEVICE_TYPE, _get_device_type);
+    netdev_test_set_get_cb(&_netdev, NETOPT_MAX_PACKET_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_netdev, NETOPT_ADDRESS, _get_address);
+    netdev_test_set_send_cb(&_netdev, _send);
+    _netif = gnrc_netif_ethernet_create(_netif_stack, sizeof(_netif_stack),
+                                        GNRC_NETIF_PRIO, "mockup_eth",
+                                        &_netdev.netdev);
+    assert(_netif != NULL);
+}
+
+int main(void)
+{
+    _init();
+    _capture();
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_pktcapture());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests reuse and invalidation of the DIO a RPL root caches
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "msg.h"
+#include "net/ethernet.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/gnrc/rpl.h"
+#include "net/icmpv6.h"
+#include "net/netdev_test.h"
+#include "thread.h"
+#include "trickle.h"
+
+#define INSTANCE_ID     (0U)
+#define DIO_BUF_SIZE    (GNRC_RPL_DIO_CACHE_SIZE)
+/* the ICMPv6 checksum is filled in by the IPv6 thread */
+#define DIO_CMP_OFFSET  (sizeof(icmpv6_hdr_t))
+
+static const ipv6_addr_t _root = { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                     0, 0, 0, 0, 0, 0, 0, 0x01 } };
+static const uint8_t _root_l2[] = { 0x02, 0, 0, 0, 0, 0x01 };
+
+static netdev_test_t _netdev;
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static gnrc_netif_t *_netif;
+static gnrc_rpl_instance_t *_inst;
+static gnrc_netreg_entry_t _ipv6_entry;
+static msg_t _msg_queue[8];
+static uint8_t _dio[DIO_BUF_SIZE];
+static uint8_t _prev_dio[DIO_BUF_SIZE];
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static int _get_address(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len >= sizeof(_root_l2));
+    memcpy(value, _root_l2, sizeof(_root_l2));
+    return sizeof(_root_l2);
+}
+
+static int _send(netdev_t *dev, const iolist_t *iolist)
+{
+    (void)dev;
+    return iolist_size(iolist);
+}
+
+/* sends a DIO and copies it, as handed to the IPv6 layer, to _dio */
+static size_t _send_dio(void)
+{
+    size_t len = 0;
+    msg_t msg;
+
+    gnrc_rpl_send_DIO(_inst, NULL);
+    while (msg_try_receive(&msg) > 0) {
+        gnrc_pktsnip_t *pkt = msg.content.ptr;
+        gnrc_pktsnip_t *icmpv6;
+
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_SND) {
+            continue;
+        }
+        icmpv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_ICMPV6);
+        if ((icmpv6 != NULL) &&
+            (((icmpv6_hdr_t *)icmpv6->data)->type == ICMPV6_RPL_CTRL) &&
+            (((icmpv6_hdr_t *)icmpv6->data)->code == GNRC_RPL_ICMPV6_CODE_DIO) &&
+            (gnrc_pkt_len(icmpv6) <= sizeof(_dio))) {
+            for (len = 0; icmpv6 != NULL; icmpv6 = icmpv6->next) {
+                memcpy(&_dio[len], icmpv6->data, icmpv6->size);
+                len += icmpv6->size;
+            }
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+    return len;
+}
+
+/* the prefix information option is the last option of the DIO */
+static gnrc_rpl_opt_prefix_info_t *_prefix_info(uint8_t *dio, size_t len)
+{
+    return (gnrc_rpl_opt_prefix_info_t *)&dio[len -
+                                              sizeof(gnrc_rpl_opt_prefix_info_t)];
+}
+
+static void set_up(void)
+{
+    _inst->dodag.dio_cache_len = 0;
+    _inst->dodag.dio_opts = GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
+}
+
+static void test_dio_cache__reuse(void)
+{
+    gnrc_rpl_dodag_t *dodag = &_inst->dodag;
+    size_t len;
+
+    TEST_ASSERT((len = _send_dio()) > 0);
+    TEST_ASSERT_EQUAL_INT(len, dodag->dio_cache_len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&dodag->dio_cache[DIO_CMP_OFFSET],
+                                    &_dio[DIO_CMP_OFFSET],
+                                    len - DIO_CMP_OFFSET));
+    memcpy(_prev_dio, _dio, len);
+    /* mark the cached DIO to recognize it */
+    _prefix_info(dodag->dio_cache, len)->reserved = UINT32_MAX;
+    TEST_ASSERT_EQUAL_INT(len, _send_dio());
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, _prefix_info(_dio, len)->reserved);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&_prev_dio[DIO_CMP_OFFSET],
+                                    &_dio[DIO_CMP_OFFSET],
+                                    len - DIO_CMP_OFFSET -
+                                    sizeof(gnrc_rpl_opt_prefix_info_t)));
+}
+
+static void test_dio_cache__base_changed(void)
+{
+    gnrc_rpl_dodag_t *dodag = &_inst->dodag;
+    gnrc_rpl_dio_t *dio = (gnrc_rpl_dio_t *)&_dio[sizeof(icmpv6_hdr_t)];
+    uint8_t dtsn = dodag->dtsn;
+    size_t len;
+
+    TEST_ASSERT((len = _send_dio()) > 0);
+    _prefix_info(dodag->dio_cache, len)->reserved = UINT32_MAX;
+    /* a new DTSN changes the DIO base */
+    dodag->dtsn++;
+    TEST_ASSERT_EQUAL_INT(len, _send_dio());
+    dodag->dtsn = dtsn;
+    TEST_ASSERT_EQUAL_INT(dtsn + 1, dio->dtsn);
+    TEST_ASSERT_EQUAL_INT(0, _prefix_info(_dio, len)->reserved);
+    /* the rebuilt DIO is cached */
+    TEST_ASSERT_EQUAL_INT(dtsn + 1,
+                          ((gnrc_rpl_dio_t *)&dodag->dio_cache[sizeof(icmpv6_hdr_t)])->dtsn);
+}
+
+static void test_dio_cache__opts_changed(void)
+{
+    gnrc_rpl_dodag_t *dodag = &_inst->dodag;
+    size_t len;
+
+    TEST_ASSERT((len = _send_dio()) > 0);
+    _prefix_info(dodag->dio_cache, len)->reserved = UINT32_MAX;
+    /* a requested DODAG configuration is added */
+    dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_DODAG_CONF;
+    TEST_ASSERT_EQUAL_INT(len + sizeof(gnrc_rpl_opt_dodag_conf_t), _send_dio());
+    TEST_ASSERT_EQUAL_INT(0, dodag->dio_opts & GNRC_RPL_REQ_DIO_OPT_DODAG_CONF);
+    TEST_ASSERT_EQUAL_INT(len + sizeof(gnrc_rpl_opt_dodag_conf_t),
+                          dodag->dio_cache_len);
+    /* and only sent once */
+    TEST_ASSERT_EQUAL_INT(len, _send_dio());
+    TEST_ASSERT_EQUAL_INT(0, _prefix_info(_dio, len)->reserved);
+    TEST_ASSERT_EQUAL_INT(len, dodag->dio_cache_len);
+}
+
+static void test_dio_cache__prefix_lifetimes(void)
+{
+    gnrc_rpl_dodag_t *dodag = &_inst->dodag;
+    size_t len;
+
+    TEST_ASSERT((len = _send_dio()) > 0);
+    /* lifetimes are refreshed in the reused DIO */
+    _prefix_info(dodag->dio_cache, len)->valid_lifetime = byteorder_htonl(0);
+    _prefix_info(dodag->dio_cache, len)->reserved = UINT32_MAX;
+    TEST_ASSERT_EQUAL_INT(len, _send_dio());
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, _prefix_info(_dio, len)->reserved);
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX,
+                          byteorder_ntohl(_prefix_info(_dio, len)->valid_lifetime));
+}
+
+static Test *tests_gnrc_rpl_dio_cache(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_dio_cache__reuse),
+        new_TestFixture(test_dio_cache__base_changed),
+        new_TestFixture(test_dio_cache__opts_changed),
+        new_TestFixture(test_dio_cache__prefix_lifetimes),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+static void _init(void)
+{
+    msg_init_queue(_msg_queue, sizeof(_msg_queue) / sizeof(_msg_queue[0]));
+    netdev_test_setup(&_netdev, 0);
+    netdev_test_set_get_cb(&_netdev, NETOPT_DEVICE_TYPE, _get_device_type);
+    netdev_test_set_get_cb(&_netdev, NETOPT_MAX_PACKET_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_netdev, NETOPT_ADDRESS, _get_address);
+    netdev_test_set_send_cb(&_netdev, _send);
+    _netif = gnrc_netif_ethernet_create(_netif_stack, sizeof(_netif_stack),
+                                        GNRC_NETIF_PRIO, "mockup_eth",
+                                        &_netdev.netdev);
+    assert(_netif != NULL);
+    gnrc_netapi_set(_netif->pid, NETOPT_IPV6_ADDR, 64U << 8U,
+                    (void *)&_root, sizeof(_root));
+    /* prefix of the prefix information option, without expiry */
+    gnrc_ipv6_nib_pl_set(_netif->pid, &_root, 64U, UINT32_MAX, UINT32_MAX);
+    gnrc_rpl_init(_netif->pid);
+    _inst = gnrc_rpl_root_init(INSTANCE_ID, (ipv6_addr_t *)&_root, false,
+                               false);
+    assert(_inst != NULL);
+    /* only the tests send DIOs */
+    trickle_stop(&_inst->dodag.trickle);
+    /* get the packets sent to the IPv6 layer */
+    gnrc_netreg_entry_init_pid(&_ipv6_entry, GNRC_NETREG_DEMUX_CTX_ALL,
+                               thread_getpid());
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_ipv6_entry);
+}
+
+int main(void)
+{
+    _init();
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_rpl_dio_cache());
+    TESTS_END();
+
+    return 0;
+}
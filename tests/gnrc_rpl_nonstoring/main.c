@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests DAO handling and source routing of a RPL root in
+ *              non-storing mode
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "embUnit.h"
+#include "mutex.h"
+#include "net/ethernet.h"
+#include "net/ethernet/hdr.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/sr_table.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/icmpv6.h"
+#include "net/ipv6/hdr.h"
+#include "net/netdev_test.h"
+#include "net/protnum.h"
+#include "thread.h"
+
+#define INSTANCE_ID     (0U)
+#define DAO_LEN         (sizeof(icmpv6_hdr_t) + sizeof(gnrc_rpl_dao_t) + \
+                         sizeof(ipv6_addr_t) + sizeof(gnrc_rpl_opt_target_t) + \
+                         sizeof(gnrc_rpl_opt_transit_t) + sizeof(ipv6_addr_t))
+#define FRAME_LEN       (ETHERNET_FRAME_LEN)
+
+/* the root, two nodes below it in a line and a host outside the DODAG */
+static const ipv6_addr_t _root = { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                     0, 0, 0, 0, 0, 0, 0, 0x01 } };
+static const ipv6_addr_t _child = { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                      0, 0, 0, 0, 0, 0, 0, 0xc1 } };
+static const ipv6_addr_t _grandchild = { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                           0, 0, 0, 0, 0, 0, 0, 0xc2 } };
+static const ipv6_addr_t _host = { { 0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 0,
+                                     0, 0, 0, 0, 0, 0, 0, 0x05 } };
+static const uint8_t _root_l2[] = { 0x02, 0, 0, 0, 0, 0x01 };
+static const uint8_t _child_l2[] = { 0x02, 0, 0, 0, 0, 0xc1 };
+static const uint8_t _payload[] = { 0xde, 0xad, 0xbe, 0xef };
+
+static netdev_test_t _netdev;
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+static gnrc_netif_t *_netif;
+static gnrc_rpl_instance_t *_inst;
+/* unlocked when a unicast frame was sent */
+static mutex_t _sent = MUTEX_INIT_LOCKED;
+static uint8_t _frame[FRAME_LEN];
+static size_t _frame_len;
+static uint8_t _dao_buf[DAO_LEN];
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static int _get_address(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len >= sizeof(_root_l2));
+    memcpy(value, _root_l2, sizeof(_root_l2));
+    return sizeof(_root_l2);
+}
+
+static int _send(netdev_t *dev, const iolist_t *iolist)
+{
+    size_t len = 0;
+
+    (void)dev;
+    /* DIS, DIOs and neighbor discovery are of no interest */
+    if (((uint8_t *)iolist->iol_base)[0] & 0x01) {
+        return iolist_size(iolist);
+    }
+    for (const iolist_t *iol = iolist; iol != NULL; iol = iol->iol_next) {
+        if ((len + iol->iol_len) <= sizeof(_frame)) {
+            memcpy(&_frame[len], iol->iol_base, iol->iol_len);
+        }
+        len += iol->iol_len;
+    }
+    _frame_len = len;
+    mutex_unlock(&_sent);
+    return len;
+}
+
+static void _dao(const ipv6_addr_t *target, uint8_t prefix_len,
+                 const ipv6_addr_t *parent, uint8_t lifetime)
+{
+    gnrc_rpl_dao_t *dao = (gnrc_rpl_dao_t *)&_dao_buf[sizeof(icmpv6_hdr_t)];
+    ipv6_addr_t *dodag_id = (ipv6_addr_t *)(dao + 1);
+    gnrc_rpl_opt_target_t *opt_target = (gnrc_rpl_opt_target_t *)(dodag_id + 1);
+    gnrc_rpl_opt_transit_t *opt_transit = (gnrc_rpl_opt_transit_t *)(opt_target + 1);
+
+    memset(_dao_buf, 0, sizeof(_dao_buf));
+    dao->instance_id = INSTANCE_ID;
+    dao->k_d_flags = GNRC_RPL_DAO_D_BIT;
+    *dodag_id = _root;
+    opt_target->type = GNRC_RPL_OPT_TARGET;
+    opt_target->length = GNRC_RPL_OPT_TARGET_LEN;
+    opt_target->prefix_length = prefix_len;
+    opt_target->target = *target;
+    opt_transit->type = GNRC_RPL_OPT_TRANSIT;
+    opt_transit->length = GNRC_RPL_OPT_TRANSIT_INFO_LEN + sizeof(ipv6_addr_t);
+    opt_transit->path_lifetime = lifetime;
+    memcpy(opt_transit + 1, parent, sizeof(ipv6_addr_t));
+    gnrc_rpl_recv_DAO(dao, _netif->pid, (ipv6_addr_t *)target,
+                      (ipv6_addr_t *)&_root, sizeof(_dao_buf));
+}
+
+static void _send_own(const ipv6_addr_t *dst)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, (void *)_payload,
+                                          sizeof(_payload), GNRC_NETTYPE_UNDEF);
+
+    assert(pkt != NULL);
+    pkt = gnrc_ipv6_hdr_build(pkt, NULL, dst);
+    assert(pkt != NULL);
+    gnrc_netapi_dispatch_send(GNRC_NETTYPE_IPV6, GNRC_NETREG_DEMUX_CTX_ALL, pkt);
+    mutex_lock(&_sent);
+}
+
+static void _forward(const ipv6_addr_t *dst)
+{
+    uint8_t data[sizeof(ipv6_hdr_t) + sizeof(_payload)];
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)data;
+    gnrc_pktsnip_t *netif_hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    gnrc_pktsnip_t *pkt;
+
+    assert(netif_hdr != NULL);
+    ((gnrc_netif_hdr_t *)netif_hdr->data)->if_pid = _netif->pid;
+    memset(hdr, 0, sizeof(*hdr));
+    ipv6_hdr_set_version(hdr);
+    hdr->len = byteorder_htons(sizeof(_payload));
+    hdr->nh = PROTNUM_IPV6_NONXT;
+    hdr->hl = 64;
+    hdr->src = _host;
+    hdr->dst = *dst;
+    memcpy(hdr + 1, _payload, sizeof(_payload));
+    pkt = gnrc_pktbuf_add(netif_hdr, data, sizeof(data), GNRC_NETTYPE_IPV6);
+    assert(pkt != NULL);
+    gnrc_netapi_receive(gnrc_ipv6_pid, pkt);
+    mutex_lock(&_sent);
+}
+
+static void set_up(void)
+{
+    gnrc_rpl_sr_table_flush();
+    memset(_frame, 0, sizeof(_frame));
+    _frame_len = 0;
+}
+
+static void test_dao__child(void)
+{
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_sr_table_numof());
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_sr_table_depth(&_child));
+}
+
+static void test_dao__grandchild(void)
+{
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _dao(&_grandchild, IPV6_ADDR_BIT_LEN, &_child, GNRC_RPL_DEFAULT_LIFETIME);
+    TEST_ASSERT_EQUAL_INT(2, gnrc_rpl_sr_table_numof());
+    TEST_ASSERT_EQUAL_INT(2, gnrc_rpl_sr_table_depth(&_grandchild));
+}
+
+static void test_dao__no_path(void)
+{
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, 0);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_numof());
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_sr_table_depth(&_child));
+}
+
+static void test_dao__prefix(void)
+{
+    /* only routes to nodes are kept */
+    _dao(&_child, 64, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_numof());
+}
+
+static void test_dao__not_root(void)
+{
+    _inst->dodag.node_status = GNRC_RPL_NORMAL_NODE;
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _inst->dodag.node_status = GNRC_RPL_ROOT_NODE;
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_numof());
+}
+
+static void test_send_own__child(void)
+{
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)&_frame[sizeof(ethernet_hdr_t)];
+
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _send_own(&_child);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_child_l2, _frame, sizeof(_child_l2)));
+    /* no header needed for a neighbor */
+    TEST_ASSERT(ipv6_addr_equal(&_child, &hdr->dst));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_NONXT, hdr->nh);
+    TEST_ASSERT_EQUAL_INT(sizeof(_payload), byteorder_ntohs(hdr->len));
+}
+
+static void test_send_own__grandchild(void)
+{
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)&_frame[sizeof(ethernet_hdr_t)];
+    uint8_t *srh = (uint8_t *)(hdr + 1);
+    uint8_t exp[GNRC_RPL_SR_TABLE_SRH_MAXLEN];
+    ipv6_addr_t first_hop;
+    int srh_len;
+
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _dao(&_grandchild, IPV6_ADDR_BIT_LEN, &_child, GNRC_RPL_DEFAULT_LIFETIME);
+    srh_len = gnrc_rpl_sr_table_srh(&_grandchild, &first_hop, exp, sizeof(exp));
+    TEST_ASSERT(srh_len > 0);
+    TEST_ASSERT(ipv6_addr_equal(&_child, &first_hop));
+    _send_own(&_grandchild);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_child_l2, _frame, sizeof(_child_l2)));
+    /* the header is inserted into the packet */
+    TEST_ASSERT_EQUAL_INT(sizeof(ethernet_hdr_t) + sizeof(ipv6_hdr_t) +
+                          srh_len + sizeof(_payload), _frame_len);
+    TEST_ASSERT(ipv6_addr_equal(&_root, &hdr->src));
+    TEST_ASSERT(ipv6_addr_equal(&_child, &hdr->dst));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_EXT_RH, hdr->nh);
+    TEST_ASSERT_EQUAL_INT(srh_len + sizeof(_payload), byteorder_ntohs(hdr->len));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_NONXT, ((gnrc_rpl_srh_t *)srh)->nh);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&exp[1], &srh[1], srh_len - 1));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_payload, &srh[srh_len], sizeof(_payload)));
+}
+
+static void test_forward__child(void)
+{
+    ipv6_hdr_t *hdr = (ipv6_hdr_t *)&_frame[sizeof(ethernet_hdr_t)];
+
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _forward(&_child);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_child_l2, _frame, sizeof(_child_l2)));
+    /* forwarded as is */
+    TEST_ASSERT_EQUAL_INT(sizeof(ethernet_hdr_t) + sizeof(ipv6_hdr_t) +
+                          sizeof(_payload), _frame_len);
+    TEST_ASSERT(ipv6_addr_equal(&_host, &hdr->src));
+    TEST_ASSERT(ipv6_addr_equal(&_child, &hdr->dst));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_NONXT, hdr->nh);
+    TEST_ASSERT_EQUAL_INT(63, hdr->hl);
+}
+
+static void test_forward__grandchild(void)
+{
+    ipv6_hdr_t *outer = (ipv6_hdr_t *)&_frame[sizeof(ethernet_hdr_t)];
+    uint8_t *srh = (uint8_t *)(outer + 1);
+    ipv6_hdr_t *inner;
+    uint8_t exp[GNRC_RPL_SR_TABLE_SRH_MAXLEN];
+    ipv6_addr_t first_hop;
+    int srh_len;
+
+    _dao(&_child, IPV6_ADDR_BIT_LEN, &_root, GNRC_RPL_DEFAULT_LIFETIME);
+    _dao(&_grandchild, IPV6_ADDR_BIT_LEN, &_child, GNRC_RPL_DEFAULT_LIFETIME);
+    srh_len = gnrc_rpl_sr_table_srh(&_grandchild, &first_hop, exp, sizeof(exp));
+    TEST_ASSERT(srh_len > 0);
+    _forward(&_grandchild);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_child_l2, _frame, sizeof(_child_l2)));
+    /* the header goes into an outer header from the root */
+    TEST_ASSERT_EQUAL_INT(sizeof(ethernet_hdr_t) + (2 * sizeof(ipv6_hdr_t)) +
+                          srh_len + sizeof(_payload), _frame_len);
+    TEST_ASSERT(ipv6_hdr_is(outer));
+    TEST_ASSERT(ipv6_addr_equal(&_root, &outer->src));
+    TEST_ASSERT(ipv6_addr_equal(&_child, &outer->dst));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_EXT_RH, outer->nh);
+    TEST_ASSERT_EQUAL_INT(srh_len + sizeof(ipv6_hdr_t) + sizeof(_payload),
+                          byteorder_ntohs(outer->len));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6, ((gnrc_rpl_srh_t *)srh)->nh);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&exp[1], &srh[1], srh_len - 1));
+    /* the forwarded packet is left alone */
+    inner = (ipv6_hdr_t *)&srh[srh_len];
+    TEST_ASSERT(ipv6_hdr_is(inner));
+    TEST_ASSERT(ipv6_addr_equal(&_host, &inner->src));
+    TEST_ASSERT(ipv6_addr_equal(&_grandchild, &inner->dst));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_NONXT, inner->nh);
+    TEST_ASSERT_EQUAL_INT(sizeof(_payload), byteorder_ntohs(inner->len));
+    TEST_ASSERT_EQUAL_INT(63, inner->hl);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_payload, inner + 1, sizeof(_payload)));
+}
+
+static Test *tests_gnrc_rpl_nonstoring(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_dao__child),
+        new_TestFixture(test_dao__grandchild),
+        new_TestFixture(test_dao__no_path),
+        new_TestFixture(test_dao__prefix),
+        new_TestFixture(test_dao__not_root),
+        new_TestFixture(test_send_own__child),
+        new_TestFixture(test_send_own__grandchild),
+        new_TestFixture(test_forward__child),
+        new_TestFixture(test_forward__grandchild),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+static void _init(void)
+{
+    ipv6_addr_t child_ll;
+
+    netdev_test_setup(&_netdev, 0);
+    netdev_test_set_get_cb(&_netdev, NETOPT_DEVICE_TYPE, _get_device_type);
+    netdev_test_set_get_cb(&_netdev, NETOPT_MAX_PACKET_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_netdev, NETOPT_ADDRESS, _get_address);
+    netdev_test_set_send_cb(&_netdev, _send);
+    _netif = gnrc_netif_ethernet_create(_netif_stack, sizeof(_netif_stack),
+                                        GNRC_NETIF_PRIO, "mockup_eth",
+                                        &_netdev.netdev);
+    assert(_netif != NULL);
+    gnrc_netapi_set(_netif->pid, NETOPT_IPV6_ADDR, 64U << 8U,
+                    (void *)&_root, sizeof(_root));
+    /* the first hop is reached by its link-local address */
+    ipv6_addr_set_link_local_prefix(&child_ll);
+    ipv6_addr_init_iid(&child_ll, &_child.u8[8], 64);
+    gnrc_ipv6_nib_nc_set(&child_ll, _netif->pid, _child_l2, sizeof(_child_l2));
+    gnrc_rpl_init(_netif->pid);
+    _inst = gnrc_rpl_root_init(INSTANCE_ID, (ipv6_addr_t *)&_root, false,
+                               false);
+    assert((_inst != NULL) && (_inst->mop == GNRC_RPL_MOP_NON_STORING_MODE));
+}
+
+int main(void)
+{
+    _init();
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_rpl_nonstoring());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the RPL objective functions and the selection of the
+ *              preferred parent
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/mrhof.h"
+#include "net/gnrc/rpl/of_manager.h"
+#include "thread.h"
+#include "trickle.h"
+
+#define MHRI                (256U)
+#define INSTANCE_ID         (0U)
+/* long enough to never fire during the tests */
+#define TRICKLE_IMIN        (100000U)
+
+static const ipv6_addr_t _dodag_id = { {
+        0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01
+    } };
+static const ipv6_addr_t _parent_addrs[] = {
+    { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01 } },
+    { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02 } },
+};
+
+static gnrc_rpl_instance_t _inst;
+static gnrc_rpl_parent_t _parents[2];
+static gnrc_rpl_of_t *_mrhof;
+
+static void set_up(void)
+{
+    memset(&_inst, 0, sizeof(_inst));
+    memset(_parents, 0, sizeof(_parents));
+    _inst.min_hop_rank_inc = MHRI;
+    _inst.dodag.instance = &_inst;
+    for (unsigned i = 0; i < sizeof(_parents) / sizeof(_parents[0]); i++) {
+        _parents[i].dodag = &_inst.dodag;
+        _parents[i].link_metric = GNRC_RPL_MRHOF_ETX_INIT;
+    }
+    /* _parents[0] is the preferred parent */
+    _parents[0].next = &_parents[1];
+}
+
+static void tear_down(void)
+{
+    gnrc_rpl_instance_remove_by_id(INSTANCE_ID);
+}
+
+static gnrc_rpl_dodag_t *_dodag_init(uint16_t ocp)
+{
+    gnrc_rpl_instance_t *inst;
+
+    if (!gnrc_rpl_instance_add(INSTANCE_ID, &inst)) {
+        return NULL;
+    }
+    inst->mop = GNRC_RPL_MOP_NO_DOWNWARD_ROUTES;
+    inst->of = gnrc_rpl_get_of_for_ocp(ocp);
+    if (!gnrc_rpl_dodag_init(inst, (ipv6_addr_t *)&_dodag_id,
+                             KERNEL_PID_UNDEF)) {
+        return NULL;
+    }
+    trickle_start(thread_getpid(), &inst->dodag.trickle,
+                  GNRC_RPL_MSG_TYPE_TRICKLE_MSG, TRICKLE_IMIN, 1, 0);
+    return &inst->dodag;
+}
+
+static gnrc_rpl_parent_t *_parent_add(gnrc_rpl_dodag_t *dodag, unsigned idx,
+                                      uint16_t rank)
+{
+    gnrc_rpl_parent_t *parent;
+
+    if (!gnrc_rpl_parent_add_by_addr(dodag, (ipv6_addr_t *)&_parent_addrs[idx],
+                                     &parent)) {
+        return NULL;
+    }
+    parent->rank = rank;
+    return parent;
+}
+
+static void test_mrhof_calc_rank__no_parent(void)
+{
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, _mrhof->calc_rank(NULL, 0));
+}
+
+static void test_mrhof_calc_rank__infinite(void)
+{
+    _parents[0].rank = GNRC_RPL_INFINITE_RANK;
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK,
+                          _mrhof->calc_rank(&_parents[0], 0));
+    _parents[0].rank = GNRC_RPL_INFINITE_RANK - 1;
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK,
+                          _mrhof->calc_rank(&_parents[0], 0));
+}
+
+static void test_mrhof_calc_rank__path_cost(void)
+{
+    _parents[0].rank = 2 * MHRI;
+    _parents[0].link_metric = 384;
+    TEST_ASSERT_EQUAL_INT(2 * MHRI + 384, _mrhof->calc_rank(&_parents[0], 0));
+    /* the base rank takes precedence over the rank of the parent */
+    TEST_ASSERT_EQUAL_INT(3 * MHRI + 384,
+                          _mrhof->calc_rank(&_parents[0], 3 * MHRI));
+}
+
+static void test_mrhof_calc_rank__dagrank(void)
+{
+    /* the path cost stays below the next DAGRank */
+    _parents[0].rank = 2 * MHRI + 88;
+    _parents[0].link_metric = 100;
+    TEST_ASSERT_EQUAL_INT(3 * MHRI, _mrhof->calc_rank(&_parents[0], 0));
+}
+
+static void test_mrhof_calc_rank__max_rank_inc(void)
+{
+    _inst.max_rank_inc = 128;
+    _parents[0].rank = MHRI;
+    _parents[1].rank = MHRI;
+    _parents[1].link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC;
+    /* the path cost through _parents[1] minus MaxRankIncrease */
+    TEST_ASSERT_EQUAL_INT(MHRI + GNRC_RPL_MRHOF_MAX_LINK_METRIC - 128,
+                          _mrhof->calc_rank(&_parents[0], 0));
+    /* unacceptable parents are not considered */
+    _parents[1].link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1;
+    TEST_ASSERT_EQUAL_INT(2 * MHRI, _mrhof->calc_rank(&_parents[0], 0));
+    /* neither is the rest of the parent set without a MaxRankIncrease */
+    _parents[1].link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC;
+    _inst.max_rank_inc = 0;
+    TEST_ASSERT_EQUAL_INT(2 * MHRI, _mrhof->calc_rank(&_parents[0], 0));
+}
+
+static void test_mrhof_which_parent__hysteresis(void)
+{
+    _parents[0].rank = 2 * MHRI;
+    _parents[1].rank = 2 * MHRI - GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD + 1;
+    TEST_ASSERT(&_parents[0] == _mrhof->which_parent(&_parents[0],
+                                                     &_parents[1]));
+    _parents[1].rank = 2 * MHRI - GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD;
+    TEST_ASSERT(&_parents[0] == _mrhof->which_parent(&_parents[0],
+                                                     &_parents[1]));
+    _parents[1].rank = 2 * MHRI - GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD - 1;
+    TEST_ASSERT(&_parents[1] == _mrhof->which_parent(&_parents[0],
+                                                     &_parents[1]));
+}
+
+static void test_mrhof_which_parent__unacceptable(void)
+{
+    _parents[0].rank = MHRI;
+    _parents[0].link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1;
+    _parents[1].rank = 4 * MHRI;
+    /* an acceptable parent is preferred regardless of the path cost */
+    TEST_ASSERT(&_parents[1] == _mrhof->which_parent(&_parents[0],
+                                                     &_parents[1]));
+    TEST_ASSERT(&_parents[1] == _mrhof->which_parent(&_parents[1],
+                                                     &_parents[0]));
+    /* no hysteresis without an acceptable current parent */
+    _parents[1].link_metric = GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1;
+    _parents[1].rank = MHRI - 1;
+    TEST_ASSERT(&_parents[1] == _mrhof->which_parent(&_parents[0],
+                                                     &_parents[1]));
+}
+
+static void test_mrhof_parent_cmp(void)
+{
+    _parents[0].rank = 2 * MHRI;
+    _parents[1].rank = 2 * MHRI;
+    TEST_ASSERT_EQUAL_INT(0, _mrhof->parent_cmp(&_parents[0], &_parents[1]));
+    /* the path cost counts, not the rank */
+    _parents[1].rank = 2 * MHRI - 1;
+    TEST_ASSERT(_mrhof->parent_cmp(&_parents[0], &_parents[1]) > 0);
+    TEST_ASSERT(_mrhof->parent_cmp(&_parents[1], &_parents[0]) < 0);
+    _parents[1].link_metric = GNRC_RPL_MRHOF_ETX_INIT + 2;
+    TEST_ASSERT(_mrhof->parent_cmp(&_parents[0], &_parents[1]) < 0);
+    /* path cost over the limit */
+    _parents[1].rank = GNRC_RPL_MRHOF_MAX_PATH_COST;
+    _parents[0].rank = 5 * MHRI;
+    TEST_ASSERT(_mrhof->parent_cmp(&_parents[0], &_parents[1]) < 0);
+    TEST_ASSERT(_mrhof->parent_cmp(&_parents[1], &_parents[0]) > 0);
+}
+
+static void test_parent_update__of0(void)
+{
+    gnrc_rpl_dodag_t *dodag = _dodag_init(0);
+    gnrc_rpl_parent_t *p0, *p1;
+
+    TEST_ASSERT_NOT_NULL(dodag);
+    p0 = _parent_add(dodag, 0, 2 * MHRI);
+    TEST_ASSERT_NOT_NULL(p0);
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT(dodag->parents == p0);
+    TEST_ASSERT_EQUAL_INT(3 * MHRI, dodag->my_rank);
+    /* a parent of the same rank does not replace the preferred one */
+    p1 = _parent_add(dodag, 1, 2 * MHRI);
+    TEST_ASSERT_NOT_NULL(p1);
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT(dodag->parents == p0);
+    TEST_ASSERT(p0->next == p1);
+    TEST_ASSERT_EQUAL_INT(3 * MHRI, dodag->my_rank);
+    /* a parent of a lower rank does */
+    p1->rank = MHRI;
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT(dodag->parents == p1);
+    TEST_ASSERT_EQUAL_INT(2 * MHRI, dodag->my_rank);
+    /* p0 is of the same DAGRank as this node now */
+    TEST_ASSERT_NULL(p1->next);
+    TEST_ASSERT_EQUAL_INT(0, p0->state);
+}
+
+static void test_parent_update__mrhof(void)
+{
+    gnrc_rpl_dodag_t *dodag = _dodag_init(GNRC_RPL_MRHOF_OCP);
+    gnrc_rpl_parent_t *p0, *p1;
+
+    TEST_ASSERT_NOT_NULL(dodag);
+    p0 = _parent_add(dodag, 0, 2 * MHRI);
+    TEST_ASSERT_NOT_NULL(p0);
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT(dodag->parents == p0);
+    TEST_ASSERT_EQUAL_INT(2 * MHRI + GNRC_RPL_MRHOF_ETX_INIT, dodag->my_rank);
+    /* a better parent within the switch threshold */
+    p1 = _parent_add(dodag, 1,
+                     2 * MHRI - GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD + 1);
+    TEST_ASSERT_NOT_NULL(p1);
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT(dodag->parents == p0);
+    TEST_ASSERT(p0->next == p1);
+    TEST_ASSERT_EQUAL_INT(2 * MHRI + GNRC_RPL_MRHOF_ETX_INIT, dodag->my_rank);
+    /* a better parent beyond the switch threshold */
+    p1->rank = 2 * MHRI - GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD - 1;
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT(dodag->parents == p1);
+    TEST_ASSERT_EQUAL_INT(p1->rank + GNRC_RPL_MRHOF_ETX_INIT, dodag->my_rank);
+    /* p0 is of the same DAGRank as this node now */
+    TEST_ASSERT_NULL(p1->next);
+    TEST_ASSERT_EQUAL_INT(0, p0->state);
+}
+
+static void test_parent_update__trickle_reset(void)
+{
+    gnrc_rpl_dodag_t *dodag = _dodag_init(GNRC_RPL_MRHOF_OCP);
+    gnrc_rpl_parent_t *p0;
+
+    TEST_ASSERT_NOT_NULL(dodag);
+    p0 = _parent_add(dodag, 0, 2 * MHRI);
+    TEST_ASSERT_NOT_NULL(p0);
+    /* joining the DODAG is announced */
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT_EQUAL_INT(1, dodag->trickle.stats.resets);
+    /* the rank did not change */
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT_EQUAL_INT(1, dodag->trickle.stats.resets);
+    /* the rank changed within the DAGRank */
+    p0->rank = 2 * MHRI + 8;
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT_EQUAL_INT(p0->rank + GNRC_RPL_MRHOF_ETX_INIT, dodag->my_rank);
+    TEST_ASSERT_EQUAL_INT(1, dodag->trickle.stats.resets);
+    /* the DAGRank changed */
+    p0->rank = 3 * MHRI;
+    gnrc_rpl_parent_update(dodag, NULL);
+    TEST_ASSERT_EQUAL_INT(4 * MHRI, dodag->my_rank);
+    TEST_ASSERT_EQUAL_INT(2, dodag->trickle.stats.resets);
+}
+
+static Test *tests_gnrc_rpl_of(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mrhof_calc_rank__no_parent),
+        new_TestFixture(test_mrhof_calc_rank__infinite),
+        new_TestFixture(test_mrhof_calc_rank__path_cost),
+        new_TestFixture(test_mrhof_calc_rank__dagrank),
+        new_TestFixture(test_mrhof_calc_rank__max_rank_inc),
+        new_TestFixture(test_mrhof_which_parent__hysteresis),
+        new_TestFixture(test_mrhof_which_parent__unacceptable),
+        new_TestFixture(test_mrhof_parent_cmp),
+        new_TestFixture(test_parent_update__of0),
+        new_TestFixture(test_parent_update__mrhof),
+        new_TestFixture(test_parent_update__trickle_reset),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    gnrc_rpl_of_manager_init();
+    _mrhof = gnrc_rpl_get_of_mrhof();
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_rpl_of());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Benchmark for source routing header generation of a RPL root
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/sr_table.h"
+#include "xtimer.h"
+
+#ifndef NODES_NUMOF
+#define NODES_NUMOF         (256U)
+#endif
+
+#ifndef FANOUT
+#define FANOUT              (3U)
+#endif
+
+#define LOOKUPS             (4096U)
+
+typedef struct {
+    ipv6_addr_t target;
+    ipv6_addr_t parent;     /* unspecified for children of the root */
+} _route_t;
+
+static ipv6_addr_t addrs[NODES_NUMOF];
+static _route_t routes[NODES_NUMOF];
+static uint8_t buf[GNRC_RPL_SR_TABLE_SRH_MAXLEN];
+
+/* looks up the parent of every hop in the list of routes, as a root that does
+ * not index its routes would */
+static int _srh_linear(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                       unsigned numof)
+{
+    const ipv6_addr_t *route[GNRC_RPL_SR_TABLE_DEPTH_MAX];
+    unsigned depth = 0;
+
+    while ((dst != NULL) && !ipv6_addr_is_unspecified(dst)) {
+        unsigned i = 0;
+
+        while ((i < numof) && !ipv6_addr_equal(&routes[i].target, dst)) {
+            i++;
+        }
+        if (i == numof) {
+            return -ENOENT;
+        }
+        if (depth == GNRC_RPL_SR_TABLE_DEPTH_MAX) {
+            return -ELOOP;
+        }
+        route[depth++] = &routes[i].target;
+        dst = &routes[i].parent;
+    }
+    *first_hop = *route[--depth];
+    if (depth == 0) {
+        return 0;
+    }
+    for (unsigned i = 0; i < (depth / 2); i++) {
+        const ipv6_addr_t *tmp = route[i];
+
+        route[i] = route[depth - 1 - i];
+        route[depth - 1 - i] = tmp;
+    }
+    return gnrc_rpl_srh_build(first_hop, route, depth, buf, sizeof(buf));
+}
+
+static int _srh_table(const ipv6_addr_t *dst, ipv6_addr_t *first_hop,
+                      unsigned numof)
+{
+    (void)numof;
+    return gnrc_rpl_sr_table_srh(dst, first_hop, buf, sizeof(buf));
+}
+
+static void _run(const char *name, unsigned numof,
+                 int (*srh)(const ipv6_addr_t *, ipv6_addr_t *, unsigned))
+{
+    ipv6_addr_t first_hop;
+    unsigned failed = 0;
+    uint32_t start = xtimer_now_usec();
+
+    for (unsigned n = 0; n < LOOKUPS; n++) {
+        failed += (srh(&addrs[n % numof], &first_hop, numof) < 0);
+    }
+
+    uint32_t duration = xtimer_now_usec() - start;
+    printf("  %s: %lu ns per header", name,
+           (unsigned long)(((uint64_t)duration * 1000) / LOOKUPS));
+    if (failed > 0) {
+        printf(" (%u failed)", failed);
+    }
+    puts("");
+}
+
+int main(void)
+{
+    unsigned depth_sum = 0;
+
+    puts("RPL source routing header benchmark");
+    printf("up to %u nodes, %u children per node, %u headers per run\n",
+           NODES_NUMOF, FANOUT, LOOKUPS);
+
+    for (unsigned i = 0; i < NODES_NUMOF; i++) {
+        /* 2001:db8::<i + 1> */
+        addrs[i].u16[0] = byteorder_htons(0x2001);
+        addrs[i].u16[1] = byteorder_htons(0x0db8);
+        addrs[i].u16[6] = byteorder_htons((i + 1) >> 16);
+        addrs[i].u16[7] = byteorder_htons((i + 1) & 0xffff);
+    }
+
+    for (unsigned i = 0; i < NODES_NUMOF; i++) {
+        const ipv6_addr_t *parent = NULL;
+        unsigned depth = 1;
+
+        if (i >= FANOUT) {
+            parent = &addrs[(i / FANOUT) - 1];
+            for (unsigned p = i; p >= FANOUT; p = (p / FANOUT) - 1) {
+                depth++;
+            }
+        }
+        depth_sum += depth;
+        routes[i].target = addrs[i];
+        if (parent != NULL) {
+            routes[i].parent = *parent;
+        }
+        if (gnrc_rpl_sr_table_add(&addrs[i], parent, UINT32_MAX) < 0) {
+            printf("error: can't add node %u\n", i);
+            return 1;
+        }
+
+        unsigned numof = i + 1;
+        if ((numof & (numof - 1)) == 0) {
+            printf("%u nodes, average depth %u.%02u\n", numof,
+                   depth_sum / numof, ((depth_sum % numof) * 100) / numof);
+            _run("linear", numof, _srh_linear);
+            _run("sr_table", numof, _srh_table);
+        }
+    }
+
+    puts("done");
+    return 0;
+}
@@ -23,6 +23,7 @@
 
 #include <arpa/inet.h>
 
+#include "mutex.h"
 #include "net/sock/dns.h"
 #include "net/sock/util.h"
 #include "xtimer.h"
@@ -31,6 +32,10 @@
 #define TEST_NAME   "example.org"
 #endif
 
+#ifndef TEST_UNKNOWN_NAME
+#define TEST_UNKNOWN_NAME   "unknown.example.org"
+#endif
+
 #ifndef DNS_SERVER
 #define DNS_SERVER  "[2001:db8::1]:53"
 #endif
@@ -42,10 +47,37 @@ sock_udp_ep_t sock_dns_server;
 
 extern int _gnrc_netif_config(int argc, char **argv);
 
-int main(void)
+static void _print_result(const char *name, int res, const void *addr)
+{
+    if (res > 0) {
+        char addrstr[INET6_ADDRSTRLEN];
+        inet_ntop(res == 4 ? AF_INET : AF_INET6, addr, addrstr, sizeof(addrstr));
+        printf("%s resolves to %s\n", name, addrstr);
+    }
+    else {
+        printf("error resolving %s\n", name);
+    }
+}
+
+static void _resolve(const char *name)
 {
     uint8_t addr[16] = {0};
 
+    _print_result(name, sock_dns_query(name, addr, AF_UNSPEC), addr);
+}
+
+#ifdef MODULE_SOCK_DNS_ASYNC
+static void _async_cb(sock_dns_async_t *req, int res, const void *addr)
+{
+    printf("async: ");
+    _print_result(req->domain_name, res, addr);
+    mutex_unlock(req->arg);
+}
+#endif
+
+int main(void)
+{
+
     sock_udp_str2ep(&sock_dns_server, DNS_SERVER);
 
     puts("waiting for router advertisement...");
@@ -55,15 +87,26 @@ int main(void)
     puts("Configured network interfaces:");
     _gnrc_netif_config(0, NULL);
 
-    int res = sock_dns_query(TEST_NAME, addr, AF_UNSPEC);
-    if (res > 0) {
-        char addrstr[INET6_ADDRSTRLEN];
-        inet_ntop(res == 4 ? AF_INET : AF_INET6, addr, addrstr, sizeof(addrstr));
-        printf("%s resolves to %s\n", TEST_NAME, addrstr);
-    }
-    else {
-        printf("error resolving %s\n", TEST_NAME);
-    }
+    _resolve(TEST_NAME);
+    _resolve(TEST_UNKNOWN_NAME);
+
+    /* with sock_dns_cache, these are answered without asking the server */
+    _resolve(TEST_NAME);
+    _resolve(TEST_UNKNOWN_NAME);
+
+#ifdef MODULE_SOCK_DNS_ASYNC
+    mutex_t done = MUTEX_INIT_LOCKED;
+    sock_dns_async_t req;
+
+    sock_dns_query_async(&req, TEST_NAME, AF_UNSPEC, _async_cb, &done);
+    mutex_lock(&done);
+#endif
+
+    sock_dns_stats_t stats;
+    sock_dns_stats(&stats, false);
+    printf("stats: %lu hits, %lu misses, %lu coalesced\n",
+           (unsigned long)stats.hits, (unsigned long)stats.misses,
+           (unsigned long)stats.coalesced);
 
     return 0;
 }
@@ -342,6 +342,52 @@ static void test_sock_ip_recv__non_blocking(void)
     assert(_check_net());
 }
 
+static void test_sock_ip_recv_buf(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR_REMOTE };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR_LOCAL };
+    static const sock_ip_ep_t local = { .family = AF_INET6 };
+    sock_ip_ep_t result;
+    void *data = NULL, *ctx = NULL;
+
+    assert(0 == sock_ip_create(&_sock, &local, NULL, _TEST_PROTO,
+                               SOCK_FLAGS_REUSE_EP));
+    assert(_inject_packet(&src_addr, &dst_addr, _TEST_PROTO, "ABCD",
+                          sizeof("ABCD"), _TEST_NETIF));
+    assert(sizeof("ABCD") == sock_ip_recv_buf(&_sock, &data, &ctx,
+                                              SOCK_NO_TIMEOUT, &result));
+    assert(data != NULL);
+    assert(ctx != NULL);
+    assert(memcmp(data, "ABCD", sizeof("ABCD")) == 0);
+    assert(AF_INET6 == result.family);
+    assert(memcmp(&result.addr, &src_addr, sizeof(result.addr)) == 0);
+    assert(_TEST_NETIF == result.netif);
+    /* data is lent until the next call */
+    assert(!gnrc_pktbuf_is_empty());
+    assert(0 == sock_ip_recv_buf(&_sock, &data, &ctx, 0, NULL));
+    assert(data == NULL);
+    assert(ctx == NULL);
+    assert(_check_net());
+}
+
+static void test_sock_ip_recv_buf__empty(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR_REMOTE };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR_LOCAL };
+    static const sock_ip_ep_t local = { .family = AF_INET6 };
+    void *data = NULL, *ctx = NULL;
+
+    assert(0 == sock_ip_create(&_sock, &local, NULL, _TEST_PROTO,
+                               SOCK_FLAGS_REUSE_EP));
+    assert(_inject_packet(&src_addr, &dst_addr, _TEST_PROTO, "", 0,
+                          _TEST_NETIF));
+    /* nothing is lent, so the packet must already be released */
+    assert(0 == sock_ip_recv_buf(&_sock, &data, &ctx, SOCK_NO_TIMEOUT, NULL));
+    assert(data == NULL);
+    assert(ctx == NULL);
+    assert(_check_net());
+}
+
 static void test_sock_ip_send__EAFNOSUPPORT(void)
 {
     static const sock_ip_ep_t remote = { .addr = { .ipv6 = _TEST_ADDR_REMOTE },
@@ -587,6 +633,27 @@ static void test_sock_ip_send__no_sock(void)
     assert(_check_net());
 }
 
+static void test_sock_ip_sendv__socketed(void)
+{
+    static const ipv6_addr_t src_addr = { .u8 = _TEST_ADDR_LOCAL };
+    static const ipv6_addr_t dst_addr = { .u8 = _TEST_ADDR_REMOTE };
+    static const sock_ip_ep_t local = { .addr = { .ipv6 = _TEST_ADDR_LOCAL },
+                                        .family = AF_INET6,
+                                        .netif = _TEST_NETIF };
+    static const sock_ip_ep_t remote = { .addr = { .ipv6 = _TEST_ADDR_REMOTE },
+                                         .family = AF_INET6 };
+    iolist_t tail = { .iol_base = "CD", .iol_len = sizeof("CD") };
+    iolist_t head = { .iol_next = &tail, .iol_base = "AB", .iol_len = 2 };
+
+    assert(0 == sock_ip_create(&_sock, &local, &remote, _TEST_PROTO,
+                               SOCK_FLAGS_REUSE_EP));
+    assert(sizeof("ABCD") == sock_ip_sendv(&_sock, &head, _TEST_PROTO, NULL));
+    assert(_check_packet(&src_addr, &dst_addr, _TEST_PROTO, "ABCD",
+                         sizeof("ABCD"), _TEST_NETIF));
+    xtimer_usleep(1000);    /* let GNRC stack finish */
+    assert(_check_net());
+}
+
 int main(void)
 {
     _net_init();
@@ -615,6 +682,8 @@ int main(void)
     CALL(test_sock_ip_recv__unsocketed_with_remote());
     CALL(test_sock_ip_recv__with_timeout());
     CALL(test_sock_ip_recv__non_blocking());
+    CALL(test_sock_ip_recv_buf());
+    CALL(test_sock_ip_recv_buf__empty());
     _prepare_send_checks();
     CALL(test_sock_ip_send__EAFNOSUPPORT());
     CALL(test_sock_ip_send__EINVAL_addr());
@@ -632,6 +701,7 @@ int main(void)
     CALL(test_sock_ip_send__unsocketed());
     CALL(test_sock_ip_send__no_sock_no_netif());
     CALL(test_sock_ip_send__no_sock());
+    CALL(test_sock_ip_sendv__socketed());
 
     puts("ALL TESTS SUCCESSFUL");
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "event.h"
+#include "irq.h"
+#include "kernel_defines.h"
+#include "net/af.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/tcp.h"
+#include "net/ipv6/addr.h"
+
+/* Per connection echo state */
+typedef struct {
+    event_t event;
+    unsigned events;
+    bool accepted;
+    size_t len;
+    uint8_t buf[64];
+} conn_t;
+
+static gnrc_tcp_tcb_t tcbs[CONNECTIONS];
+static conn_t conns[CONNECTIONS];
+static gnrc_tcp_listener_t listener;
+static event_queue_t queue;
+
+static void _echo(unsigned idx)
+{
+    conn_t *conn = &conns[idx];
+    gnrc_tcp_tcb_t *tcb = &tcbs[idx];
+    ssize_t ret;
+
+    do {
+        /* Send what is left from the last read first */
+        if (conn->len > 0) {
+            ret = gnrc_tcp_write(tcb, conn->buf, conn->len);
+            if (ret < 0) {
+                /* Continue on GNRC_TCP_EVENT_SEND */
+                return;
+            }
+            conn->len -= ret;
+            memmove(conn->buf, conn->buf + ret, conn->len);
+            if (conn->len > 0) {
+                return;
+            }
+        }
+        ret = gnrc_tcp_read(tcb, conn->buf, sizeof(conn->buf));
+        if (ret == 0) {
+            printf("[%u] peer closed\n", idx);
+            gnrc_tcp_disconnect(tcb);
+        }
+        else if (ret > 0) {
+            conn->len = ret;
+        }
+    } while (ret > 0);
+}
+
+static void _handler(event_t *event)
+{
+    conn_t *conn = container_of(event, conn_t, event);
+    unsigned idx = conn - conns;
+    gnrc_tcp_tcb_t *tcb;
+
+    unsigned state = irq_disable();
+    unsigned events = conn->events;
+    conn->events = 0;
+    irq_restore(state);
+
+    if (events & GNRC_TCP_EVENT_ACCEPT) {
+        while ((tcb = gnrc_tcp_accept(&listener)) != NULL) {
+            unsigned i = tcb - tcbs;
+
+            printf("[%u] accepted\n", i);
+            conns[i].accepted = true;
+            conns[i].len = 0;
+            _echo(i);
+        }
+    }
+    if (!conn->accepted) {
+        return;
+    }
+    if (events & GNRC_TCP_EVENT_CLOSED) {
+        printf("[%u] closed\n", idx);
+        conn->accepted = false;
+    }
+    else if (events & (GNRC_TCP_EVENT_RECV | GNRC_TCP_EVENT_SEND)) {
+        _echo(idx);
+    }
+}
+
+/* Called from the TCP thread: hand the events to the main thread */
+static void _cb(gnrc_tcp_tcb_t *tcb, unsigned events, void *arg)
+{
+    conn_t *conn = &conns[tcb - tcbs];
+
+    unsigned state = irq_disable();
+    conn->events |= events;
+    irq_restore(state);
+    event_post(arg, &conn->event);
+}
+
+/* Prints the link-local addresses the server can be reached at */
+static void _print_addrs(void)
+{
+    gnrc_netif_t *netif = NULL;
+
+    while ((netif = gnrc_netif_iter(netif)) != NULL) {
+        ipv6_addr_t addrs[GNRC_NETIF_IPV6_ADDRS_NUMOF];
+        char addr_str[IPV6_ADDR_MAX_STR_LEN];
+        int res = gnrc_netif_ipv6_addrs_get(netif, addrs, sizeof(addrs));
+
+        for (int i = 0; i < (int)(res / sizeof(ipv6_addr_t)); i++) {
+            if (ipv6_addr_is_link_local(&addrs[i])) {
+                printf("Listening on [%s]:%d\n",
+                       ipv6_addr_to_str(addr_str, &addrs[i], sizeof(addr_str)), LOCAL_PORT);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    int ret;
+
+    printf("\nStarting asynchronous echo server. LOCAL_PORT=%d, CONNECTIONS=%d\n\n",
+           LOCAL_PORT, CONNECTIONS);
+
+    event_queue_init(&queue);
+    for (unsigned i = 0; i < CONNECTIONS; i++) {
+        conns[i].event.handler = _handler;
+        gnrc_tcp_tcb_init(&tcbs[i]);
+    }
+
+    ret = gnrc_tcp_listen(&listener, tcbs, CONNECTIONS, AF_INET6, NULL, LOCAL_PORT, _cb,
+                          &queue);
+    if (ret < 0) {
+        printf("gnrc_tcp_listen() : %d\n", ret);
+        return 1;
+    }
+    _print_addrs();
+    event_loop(&queue);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import socket
+import sys
+
+TIMEOUT = 10
+
+
+def connect(addr, port, iface):
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+    sock.settimeout(TIMEOUT)
+    sock.connect((addr, port, 0, socket.if_nametoindex(iface)))
+    return sock
+
+
+def echo(sock, data):
+    sock.sendall(data)
+    received = b""
+    while len(received) < len(data):
+        chunk = sock.recv(len(data) - len(received))
+        assert chunk, "connection closed before the echo arrived"
+        received += chunk
+    assert received == data
+
+
+def testfunc(child):
+    iface = os.environ.get('PORT', 'tap0')
+    child.expect(r"LOCAL_PORT=(\d+), CONNECTIONS=(\d+)")
+    port = int(child.match.group(1))
+    numof = int(child.match.group(2))
+    child.expect(r"Listening on \[(fe80:[0-9a-f:]+)\]:\d+")
+    addr = child.match.group(1)
+
+    # all connections are served at once from a single thread
+    socks = []
+    for i in range(numof):
+        socks.append(connect(addr, port, iface))
+        child.expect(r"\[(\d+)\] accepted")
+    for i, sock in enumerate(socks):
+        echo(sock, b"connection %d\n" % i)
+    for i, sock in enumerate(socks):
+        echo(sock, bytes(range(256)) * 4)
+
+    # no TCB is left to wait for another connection
+    try:
+        connect(addr, port, iface).close()
+        assert False, "connection beyond CONNECTIONS was accepted"
+    except ConnectionRefusedError:
+        pass
+
+    # end of stream is read, the server closes its side as well
+    socks[0].shutdown(socket.SHUT_WR)
+    assert socks[0].recv(1) == b""
+    child.expect(r"\[(\d+)\] peer closed")
+    idx = child.match.group(1)
+    socks[0].close()
+    child.expect_exact("[%s] closed" % idx)
+
+    # the closed TCB waits for connections again
+    sock = connect(addr, port, iface)
+    child.expect_exact("[%s] accepted" % idx)
+    echo(sock, b"again\n")
+    sock.close()
+    for sock in socks[1:]:
+        sock.close()
+
+
+if __name__ == "__main__":
+    sys.path.append(os.path.join(os.environ['RIOTTOOLS'], 'testrunner'))
+    from testrunner import run
+    sys.exit(run(testfunc, timeout=TIMEOUT))
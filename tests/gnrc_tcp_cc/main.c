@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests congestion control within the GNRC TCP state machine
+ *
+ * Segments are fed directly into the state machine, segments it sends are
+ * received by the main thread instead of the TCP thread.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "msg.h"
+#include "net/gnrc.h"
+#include "net/gnrc/tcp.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+#include "net/tcp.h"
+#include "shell.h"
+#include "thread.h"
+
+#include "internal/common.h"
+#include "internal/fsm.h"
+#include "internal/option.h"
+
+#define LOCAL_PORT      (2000U)
+#define PEER_PORT       (80U)
+#define PEER_ISS        (5000U)
+#define PEER_MSS        (500U)
+#define PEER_WND        (8 * PEER_MSS)
+#define MSG_QUEUE_SIZE  (16U)
+
+static const ipv6_addr_t _local = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+                                      0, 0, 0, 0, 0, 0, 0, 0x01 } };
+static const ipv6_addr_t _peer = { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+                                     0, 0, 0, 0, 0, 0, 0, 0x02 } };
+
+static gnrc_tcp_tcb_t _tcb;
+static msg_t _msg_queue[MSG_QUEUE_SIZE];
+static uint8_t _data[8 * PEER_MSS];
+/* control bits and sequence numbers of the segments sent by the FSM */
+static uint16_t _ctl[MSG_QUEUE_SIZE];
+static uint32_t _seq[MSG_QUEUE_SIZE];
+
+/* returns the number of segments sent by the FSM since the last call */
+static unsigned _sent(void)
+{
+    unsigned num = 0;
+    msg_t msg;
+
+    while (msg_try_receive(&msg) > 0) {
+        gnrc_pktsnip_t *pkt = msg.content.ptr;
+        gnrc_pktsnip_t *tcp;
+
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_SND) {
+            continue;
+        }
+        tcp = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_TCP);
+        if ((tcp != NULL) && (num < MSG_QUEUE_SIZE)) {
+            tcp_hdr_t *hdr = tcp->data;
+
+            _ctl[num] = byteorder_ntohs(hdr->off_ctl) & MSK_CTL;
+            _seq[num] = byteorder_ntohl(hdr->seq_num);
+            num++;
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+    return num;
+}
+
+/* feeds a segment without payload from the peer into the FSM */
+static void _recv(uint16_t ctl, uint32_t seq, uint32_t ack, uint16_t wnd)
+{
+    uint8_t offset = TCP_HDR_OFFSET_MIN + ((ctl & MSK_SYN) ? 1 : 0);
+    gnrc_pktsnip_t *ip;
+    gnrc_pktsnip_t *tcp;
+    ipv6_hdr_t *ip_hdr;
+    tcp_hdr_t *tcp_hdr;
+
+    ip = gnrc_pktbuf_add(NULL, NULL, sizeof(ipv6_hdr_t), GNRC_NETTYPE_IPV6);
+    tcp = gnrc_pktbuf_add(ip, NULL, offset * 4, GNRC_NETTYPE_TCP);
+    TEST_ASSERT_NOT_NULL(ip);
+    TEST_ASSERT_NOT_NULL(tcp);
+    ip_hdr = ip->data;
+    memset(ip_hdr, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(ip_hdr);
+    ip_hdr->len = byteorder_htons(offset * 4);
+    ip_hdr->nh = PROTNUM_TCP;
+    ip_hdr->src = _peer;
+    ip_hdr->dst = _local;
+    tcp_hdr = tcp->data;
+    memset(tcp_hdr, 0, offset * 4);
+    tcp_hdr->src_port = byteorder_htons(PEER_PORT);
+    tcp_hdr->dst_port = byteorder_htons(LOCAL_PORT);
+    tcp_hdr->seq_num = byteorder_htonl(seq);
+    tcp_hdr->ack_num = byteorder_htonl(ack);
+    tcp_hdr->window = byteorder_htons(wnd);
+    tcp_hdr->off_ctl = byteorder_htons(_option_build_offset_control(offset, ctl));
+    if (ctl & MSK_SYN) {
+        network_uint32_t mss = byteorder_htonl(_option_build_mss(PEER_MSS));
+
+        memcpy(tcp_hdr + 1, &mss, sizeof(mss));
+    }
+    _fsm(&_tcb, FSM_EVENT_RCVD_PKT, tcp, NULL, 0);
+    gnrc_pktbuf_release(tcp);
+}
+
+/* acknowledges all data up to @p ack with the peers window */
+static void _ack(uint32_t ack)
+{
+    _recv(MSK_ACK, PEER_ISS + 1, ack, PEER_WND);
+}
+
+static void _connect(const gnrc_tcp_cc_t *cc, uint16_t wnd)
+{
+    gnrc_tcp_tcb_init(&_tcb);
+    _tcb.cc = cc;
+    _tcb.local_port = LOCAL_PORT;
+    _tcb.peer_port = PEER_PORT;
+    memcpy(_tcb.peer_addr, &_peer, sizeof(_peer));
+    TEST_ASSERT_EQUAL_INT(0, _fsm(&_tcb, FSM_EVENT_CALL_OPEN, NULL, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(1, _sent());
+    TEST_ASSERT_EQUAL_INT(MSK_SYN, _ctl[0]);
+    _recv(MSK_SYN_ACK, PEER_ISS, _tcb.iss + 1, wnd);
+    TEST_ASSERT_EQUAL_INT(1, _sent());
+    TEST_ASSERT_EQUAL_INT(MSK_ACK, _ctl[0]);
+    TEST_ASSERT_EQUAL_INT(FSM_STATE_ESTABLISHED, _tcb.state);
+    TEST_ASSERT_EQUAL_INT(PEER_MSS, _tcb.mss);
+    TEST_ASSERT_EQUAL_INT(wnd, _tcb.snd_wnd);
+}
+
+static void set_up(void)
+{
+    _connect(&gnrc_tcp_cc_newreno, PEER_WND);
+}
+
+static void tear_down(void)
+{
+    _fsm(&_tcb, FSM_EVENT_CALL_ABORT, NULL, NULL, 0);
+    _sent();
+}
+
+static void test_gnrc_tcp_cc__wnd_cwnd(void)
+{
+    /* the initial congestion window is smaller than the peers window */
+    TEST_ASSERT_EQUAL_INT(4 * PEER_MSS, _tcb.cwnd);
+    TEST_ASSERT_EQUAL_INT(4 * PEER_MSS,
+                          _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, sizeof(_data)));
+    TEST_ASSERT_EQUAL_INT(4, _sent());
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(_tcb.iss + 1 + (i * PEER_MSS), _seq[i]);
+    }
+    /* slow start opens the window by a segment per ACK */
+    _ack(_tcb.iss + 1 + PEER_MSS);
+    TEST_ASSERT_EQUAL_INT(5 * PEER_MSS, _tcb.cwnd);
+    TEST_ASSERT_EQUAL_INT(2 * PEER_MSS,
+                          _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, sizeof(_data)));
+    TEST_ASSERT_EQUAL_INT(2, _sent());
+}
+
+static void test_gnrc_tcp_cc__wnd_snd_wnd(void)
+{
+    tear_down();
+    /* the peers window is smaller than the initial congestion window */
+    _connect(&gnrc_tcp_cc_newreno, 2 * PEER_MSS);
+    TEST_ASSERT_EQUAL_INT(2 * PEER_MSS,
+                          _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, sizeof(_data)));
+    TEST_ASSERT_EQUAL_INT(2, _sent());
+}
+
+static void test_gnrc_tcp_cc__dup_acks(void)
+{
+    uint32_t una;
+
+    _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, 4 * PEER_MSS);
+    TEST_ASSERT_EQUAL_INT(4, _sent());
+    una = _tcb.snd_una;
+    /* a window update is no duplicate ACK */
+    _recv(MSK_ACK, PEER_ISS + 1, una, PEER_WND - 1);
+    TEST_ASSERT_EQUAL_INT(0, _tcb.dup_acks);
+    _recv(MSK_ACK, PEER_ISS + 1, una, PEER_WND);
+    TEST_ASSERT_EQUAL_INT(0, _tcb.dup_acks);
+    _ack(una);
+    _ack(una);
+    TEST_ASSERT_EQUAL_INT(2, _tcb.dup_acks);
+    TEST_ASSERT_EQUAL_INT(0, _sent());
+    /* the third duplicate ACK triggers a fast retransmit of the oldest segment */
+    _ack(una);
+    TEST_ASSERT_EQUAL_INT(3, _tcb.dup_acks);
+    TEST_ASSERT_EQUAL_INT(1, _sent());
+    TEST_ASSERT_EQUAL_INT(una, _seq[0]);
+    TEST_ASSERT_EQUAL_INT(1, _tcb.retransmits);
+    TEST_ASSERT_EQUAL_INT(2 * PEER_MSS, _tcb.ssthresh);
+    TEST_ASSERT_EQUAL_INT(5 * PEER_MSS, _tcb.cwnd);
+    /* further duplicate ACKs only inflate the window */
+    _ack(una);
+    TEST_ASSERT_EQUAL_INT(4, _tcb.dup_acks);
+    TEST_ASSERT_EQUAL_INT(0, _sent());
+    TEST_ASSERT_EQUAL_INT(6 * PEER_MSS, _tcb.cwnd);
+}
+
+static void test_gnrc_tcp_cc__partial_ack(void)
+{
+    uint32_t una;
+
+    _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, 4 * PEER_MSS);
+    TEST_ASSERT_EQUAL_INT(4, _sent());
+    una = _tcb.snd_una;
+    for (unsigned i = 0; i < GNRC_TCP_DUPACK_THRESHOLD; i++) {
+        _ack(una);
+    }
+    TEST_ASSERT_EQUAL_INT(1, _sent());
+    TEST_ASSERT(_tcb.cc_state.newreno.recovery);
+    /* a partial ACK retransmits the next missing segment right away */
+    _ack(una + PEER_MSS);
+    TEST_ASSERT_EQUAL_INT(0, _tcb.dup_acks);
+    TEST_ASSERT_EQUAL_INT(1, _sent());
+    TEST_ASSERT_EQUAL_INT(una + PEER_MSS, _seq[0]);
+    TEST_ASSERT_EQUAL_INT(2, _tcb.retransmits);
+    TEST_ASSERT(_tcb.cc_state.newreno.recovery);
+    /* the full ACK ends fast recovery without a retransmission */
+    _ack(_tcb.snd_nxt);
+    TEST_ASSERT_EQUAL_INT(0, _sent());
+    TEST_ASSERT(!_tcb.cc_state.newreno.recovery);
+    TEST_ASSERT_EQUAL_INT(_tcb.ssthresh, _tcb.cwnd);
+    TEST_ASSERT_EQUAL_INT(0, _tcb.pkt_retransmit_numof);
+}
+
+static void test_gnrc_tcp_cc__stats(void)
+{
+    gnrc_tcp_stats_t stats;
+
+    _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, 3 * PEER_MSS);
+    TEST_ASSERT_EQUAL_INT(3, _sent());
+    TEST_ASSERT_EQUAL_INT(0, gnrc_tcp_get_stats(0, &stats));
+    TEST_ASSERT_EQUAL_STRING("ESTABLISHED", stats.state);
+    TEST_ASSERT_EQUAL_STRING("newreno", stats.cc);
+    TEST_ASSERT_EQUAL_INT(LOCAL_PORT, stats.local_port);
+    TEST_ASSERT_EQUAL_INT(PEER_PORT, stats.peer_port);
+    TEST_ASSERT_EQUAL_INT(PEER_WND, stats.snd_wnd);
+    TEST_ASSERT_EQUAL_INT(4 * PEER_MSS, stats.cwnd);
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, stats.ssthresh);
+    TEST_ASSERT_EQUAL_INT(3 * PEER_MSS, stats.flight_size);
+    TEST_ASSERT(gnrc_tcp_get_stats(1, &stats) < 0);
+}
+
+static Test *tests_gnrc_tcp_cc(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_tcp_cc__wnd_cwnd),
+        new_TestFixture(test_gnrc_tcp_cc__wnd_snd_wnd),
+        new_TestFixture(test_gnrc_tcp_cc__dup_acks),
+        new_TestFixture(test_gnrc_tcp_cc__partial_ack),
+        new_TestFixture(test_gnrc_tcp_cc__stats),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+
+    msg_init_queue(_msg_queue, MSG_QUEUE_SIZE);
+    /* get the segments sent by the FSM */
+    gnrc_tcp_pid = thread_getpid();
+
+    TESTS_START();
+    TESTS_RUN(tests_gnrc_tcp_cc());
+    TESTS_END();
+
+    /* leave a connection for the tcp shell command */
+    set_up();
+    _fsm(&_tcb, FSM_EVENT_CALL_SEND, NULL, _data, PEER_MSS);
+    _sent();
+    shell_run(NULL, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+
+def testfunc(child):
+    child.expect(r"OK \(\d+ tests\)")
+    child.sendline("tcp")
+    child.expect_exact("0: ESTABLISHED local port 2000 peer port 80 (newreno)")
+    child.expect_exact("snd_wnd 4000 cwnd 2000 ssthresh - in flight 500")
+    child.expect(r"srtt -?\d+ us rto -?\d+ us retransmits 0")
+    child.sendline("tcp foo")
+    child.expect_exact("usage: tcp")
+
+
+if __name__ == "__main__":
+    sys.path.append(os.path.join(os.environ['RIOTTOOLS'], 'testrunner'))
+    from testrunner import run
+    sys.exit(run(testfunc))
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <errno.h>
+#include "xtimer.h"
+#include "net/af.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/tcp.h"
+
+/* Number of bytes handed to gnrc_tcp_send() at once */
+#ifndef CHUNK
+#define CHUNK (4096)
+#endif
+
+/* Test pattern */
+#ifndef TEST_PATERN
+#define TEST_PATERN (0xF0)
+#endif
+
+static uint8_t buf[CHUNK];
+
+int main(void)
+{
+    gnrc_tcp_tcb_t tcb;
+    ipv6_addr_t target_addr;
+    uint32_t start, duration;
+    size_t sent = 0;
+    int ret;
+
+    printf("\nStarting throughput test. TARGET_ADDR=%s, TARGET_PORT=%d, ", TARGET_ADDR,
+           TARGET_PORT);
+    printf("NBYTE=%d, GNRC_TCP_SND_QUEUE_SIZE=%u\n\n", NBYTE, GNRC_TCP_SND_QUEUE_SIZE);
+
+    ipv6_addr_from_str(&target_addr, TARGET_ADDR);
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        buf[i] = TEST_PATERN;
+    }
+
+    /* Connect to peer, retry until the peer is listening */
+    gnrc_tcp_tcb_init(&tcb);
+    while ((ret = gnrc_tcp_open_active(&tcb, AF_INET6, (uint8_t *) &target_addr,
+                                       TARGET_PORT, 0)) < 0) {
+        printf("gnrc_tcp_open_active() : %d : retry after 1sec\n", ret);
+        xtimer_sleep(1);
+        gnrc_tcp_tcb_init(&tcb);
+    }
+
+    /* Send data, stop if errors were found */
+    start = xtimer_now_usec();
+    while (sent < NBYTE) {
+        size_t len = ((NBYTE - sent) < sizeof(buf)) ? (NBYTE - sent) : sizeof(buf);
+
+        ret = gnrc_tcp_send(&tcb, buf, len, 0);
+        if (ret < 0) {
+            printf("gnrc_tcp_send() : %d\n", ret);
+            break;
+        }
+        sent += ret;
+    }
+
+    /* Closing waits until all queued data was acknowledged */
+    gnrc_tcp_close(&tcb);
+    duration = xtimer_now_usec() - start;
+
+    printf("%u bytes sent in %" PRIu32 " ms: %" PRIu32 " kbit/s\n", (unsigned) sent,
+           duration / US_PER_MS, (uint32_t)(((uint64_t) sent * 8 * MS_PER_SEC) / duration));
+    return 0;
+}
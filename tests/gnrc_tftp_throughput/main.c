@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       TFTP windowsize throughput test application
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "board.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/tftp.h"
+#include "shell.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifdef MTD_0
+#include "net/gnrc/tftp/mtd.h"
+#endif
+
+/* must hold a window of data blocks */
+#define MAIN_QUEUE_SIZE     (32)
+#define SERVER_QUEUE_SIZE   (32)
+
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+static uint32_t _received;
+static bool _success;
+
+#ifdef MTD_0
+static msg_t _server_msg_queue[SERVER_QUEUE_SIZE];
+static char _server_stack[THREAD_STACKSIZE_MAIN];
+static kernel_pid_t _server_pid = KERNEL_PID_UNDEF;
+/* files written to the server are stored in the MTD from address 0 */
+static uint32_t _stored;
+static uint32_t _transferred;
+#endif
+
+static int _data_cb(uint32_t offset, void *data, size_t data_len)
+{
+    (void)data;
+    _received = offset + data_len;
+    return data_len;
+}
+
+static bool _start_cb(tftp_action_t action, tftp_mode_t mode,
+                      const char *file_name, size_t *len)
+{
+    (void)action;
+    (void)mode;
+    (void)file_name;
+    (void)len;
+    return true;
+}
+
+static void _stop_cb(tftp_event_t event, const char *msg)
+{
+    _success = (event == TFTP_SUCCESS);
+    if (!_success) {
+        printf("transfer failed: %s\n", msg ? msg : "");
+    }
+}
+
+static int _get(int argc, char **argv)
+{
+    ipv6_addr_t addr;
+    uint32_t start, duration;
+
+    if (argc < 3) {
+        printf("usage: %s <server addr> <file>\n", argv[0]);
+        return 1;
+    }
+    if (ipv6_addr_from_str(&addr, argv[1]) == NULL) {
+        puts("error: unable to parse address");
+        return 1;
+    }
+
+    _received = 0;
+    _success = false;
+    start = xtimer_now_usec();
+    gnrc_tftp_client_read(&addr, argv[2], TTM_OCTET, _data_cb, _start_cb,
+                          _stop_cb, true);
+    duration = xtimer_now_usec() - start;
+    if (!_success) {
+        return 1;
+    }
+
+    printf("%" PRIu32 " bytes received in %" PRIu32 " ms: %" PRIu32 " kbit/s\n",
+           _received, duration / US_PER_MS,
+           (uint32_t)(((uint64_t)_received * 8 * MS_PER_SEC) / duration));
+    return 0;
+}
+
+#ifdef MTD_0
+static int _server_data_cb(uint32_t offset, void *data, size_t data_len)
+{
+    int res = gnrc_tftp_mtd_data_cb(offset, data, data_len);
+
+    if (res >= 0) {
+        _transferred = offset + res;
+    }
+    return res;
+}
+
+static bool _server_start_cb(tftp_action_t action, tftp_mode_t mode,
+                             const char *file_name, size_t *len)
+{
+    (void)mode;
+    (void)file_name;
+    _transferred = 0;
+    if (action == TFTP_WRITE) {
+        uint32_t size = MTD_0->sector_count * MTD_0->pages_per_sector *
+                        MTD_0->page_size;
+
+        /* a transfer size given by the client limits the region, so its
+         * last block fills it exactly */
+        gnrc_tftp_mtd_set(MTD_0, 0, (*len) ? *len : size, true);
+    }
+    else {
+        gnrc_tftp_mtd_set(MTD_0, 0, _stored, false);
+        *len = _stored;
+    }
+    return true;
+}
+
+static void _server_stop_cb(tftp_event_t event, const char *msg)
+{
+    if (event == TFTP_SUCCESS) {
+        _stored = _transferred;
+        printf("server: %" PRIu32 " bytes transferred\n", _transferred);
+    }
+    else {
+        printf("server: transfer failed: %s\n", msg ? msg : "");
+    }
+}
+
+static void *_server(void *arg)
+{
+    (void)arg;
+    /* a window of data blocks may be received at once */
+    msg_init_queue(_server_msg_queue, SERVER_QUEUE_SIZE);
+    gnrc_tftp_server(_server_data_cb, _server_start_cb, _server_stop_cb, true);
+    return NULL;
+}
+
+static int _server_cmd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    if (_server_pid != KERNEL_PID_UNDEF) {
+        puts("error: server running already");
+        return 1;
+    }
+    if (mtd_init(MTD_0) < 0) {
+        puts("error: unable to initialize the MTD");
+        return 1;
+    }
+    _server_pid = thread_create(_server_stack, sizeof(_server_stack),
+                                THREAD_PRIORITY_MAIN - 1,
+                                THREAD_CREATE_STACKTEST, _server, NULL,
+                                "tftp_server");
+    printf("server: listening on port %u\n", GNRC_TFTP_DEFAULT_DST_PORT);
+    return 0;
+}
+#endif
+
+static const shell_command_t _commands[] = {
+    { "tftp_get", "read a file from a TFTP server", _get },
+#ifdef MTD_0
+    { "tftp_server", "store files written to a TFTP server in MTD_0",
+      _server_cmd },
+#endif
+    { NULL, NULL, NULL }
+};
+
+int main(void)
+{
+    /* the TFTP client receives its packets via the message queue */
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+    printf("TFTP throughput test, GNRC_TFTP_MAX_WINDOW_SIZE=%u\n",
+           GNRC_TFTP_MAX_WINDOW_SIZE);
+
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+    return 0;
+}
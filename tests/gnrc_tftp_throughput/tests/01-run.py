@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2018 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import re
+import socket
+import struct
+import subprocess
+import sys
+import threading
+
+SERVER_PORT = int(os.environ.get('TFTP_SERVER_PORT', 6969))
+WINDOW_SIZES = (1, 2, 4, 8, 16)
+FILE_SIZE = 128 * 1024
+# a multiple of the block size, so the last block is empty
+SERVER_FILE_SIZE = 32 * 1024
+SERVER_WINDOW_SIZE = 8
+BLOCK_SIZE = 512
+TIMEOUT = 1
+
+OP_RRQ = 1
+OP_WRQ = 2
+OP_DATA = 3
+OP_ACK = 4
+OP_ERROR = 5
+OP_OACK = 6
+
+
+class Server(threading.Thread):
+    """Minimal TFTP server, sending a file of FILE_SIZE bytes with the window
+    size forced to `window` blocks (RFC 7440)"""
+
+    def __init__(self):
+        super(Server, self).__init__(daemon=True)
+        self.window = 1
+        self.sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+        self.sock.bind(("::", SERVER_PORT))
+        self.data = bytes(i & 0xff for i in range(FILE_SIZE))
+
+    def run(self):
+        while True:
+            req, peer = self.sock.recvfrom(1024)
+            if struct.unpack("!H", req[:2])[0] == OP_RRQ:
+                self.transfer(req, peer)
+
+    def transfer(self, req, peer):
+        fields = req[2:].split(b"\0")
+        opts = dict(zip(fields[2:-1:2], fields[3:-1:2]))
+        blksize = min(int(opts.get(b"blksize", BLOCK_SIZE)), BLOCK_SIZE)
+        window = min(int(opts.get(b"windowsize", 1)), self.window)
+        sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+        sock.settimeout(TIMEOUT)
+        if opts:
+            oack = b"blksize\0%d\0windowsize\0%d\0" % (blksize, window)
+            if b"tsize" in opts:
+                oack += b"tsize\0%d\0" % len(self.data)
+            sock.sendto(struct.pack("!H", OP_OACK) + oack, peer)
+            acked = wait_ack(sock, -1)
+        else:
+            blksize, window, acked = BLOCK_SIZE, 1, 0
+        send_data(sock, peer, self.data, blksize, window, acked)
+        sock.close()
+
+
+def wait_ack(sock, acked):
+    """Returns the block acknowledged, the old one on timeout"""
+    try:
+        while True:
+            pkt = sock.recv(1024)
+            op, block = struct.unpack("!HH", pkt[:4])
+            if op == OP_ERROR:
+                return None
+            if op == OP_ACK:
+                # the block number wraps, keep the absolute one
+                return max(acked, 0) + ((block - max(acked, 0)) & 0xffff)
+    except socket.timeout:
+        return max(acked, 0)
+
+
+def send_data(sock, peer, data, blksize, window, acked):
+    """Sends data in windows of blocks following the block acknowledged,
+    returns if all blocks were acknowledged"""
+    last = len(data) // blksize + 1
+    while acked is not None and acked < last:
+        for block in range(acked + 1, min(acked + window, last) + 1):
+            chunk = data[(block - 1) * blksize:block * blksize]
+            sock.sendto(struct.pack("!HH", OP_DATA, block & 0xffff) + chunk,
+                        peer)
+        acked = wait_ack(sock, acked)
+    return acked is not None
+
+
+def request(sock, dst, op, tsize):
+    """Sends a request to the RIOT server, returns the peer and options of
+    the OACK"""
+    opts = b"blksize\0%d\0windowsize\0%d\0tsize\0%d\0" % \
+        (BLOCK_SIZE, SERVER_WINDOW_SIZE, tsize)
+    sock.sendto(struct.pack("!H", op) + b"test.bin\0octet\0" + opts, dst)
+    pkt, peer = sock.recvfrom(1024)
+    assert struct.unpack("!H", pkt[:2])[0] == OP_OACK
+    fields = pkt[2:].split(b"\0")
+    return peer, dict(zip(fields[0:-1:2], fields[1:-1:2]))
+
+
+def put(dst, data):
+    """Writes data to the RIOT server"""
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    sock.settimeout(TIMEOUT)
+    peer, opts = request(sock, dst, OP_WRQ, len(data))
+    assert int(opts[b"blksize"]) == BLOCK_SIZE
+    assert send_data(sock, peer, data, BLOCK_SIZE,
+                     int(opts.get(b"windowsize", 1)), 0)
+    sock.close()
+
+
+def get(dst):
+    """Reads the file back from the RIOT server, acknowledging every window
+    and the last block received in order on timeout"""
+    sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+    sock.settimeout(TIMEOUT)
+    peer, opts = request(sock, dst, OP_RRQ, 0)
+    window = int(opts.get(b"windowsize", 1))
+    data = b""
+    block = 0
+    received = 0
+    sock.sendto(struct.pack("!HH", OP_ACK, 0), peer)
+    while True:
+        try:
+            pkt = sock.recv(1024)
+        except socket.timeout:
+            sock.sendto(struct.pack("!HH", OP_ACK, block & 0xffff), peer)
+            received = 0
+            continue
+        op, nr = struct.unpack("!HH", pkt[:4])
+        assert op == OP_DATA
+        if nr != (block + 1) & 0xffff:
+            continue
+        data += pkt[4:]
+        block += 1
+        received += 1
+        if (len(pkt) - 4 < BLOCK_SIZE) or (received == window):
+            sock.sendto(struct.pack("!HH", OP_ACK, block & 0xffff), peer)
+            received = 0
+        if len(pkt) - 4 < BLOCK_SIZE:
+            sock.close()
+            return int(opts[b"tsize"]), data
+
+
+def host_addr(iface):
+    out = subprocess.check_output(["ip", "-6", "addr", "show", "dev", iface,
+                                   "scope", "link"]).decode()
+    return re.search(r"inet6 (fe80::[0-9a-f:]+)", out).group(1)
+
+
+def testfunc(child):
+    addr = host_addr(os.environ.get('PORT', 'tap0'))
+    child.expect(r"GNRC_TFTP_MAX_WINDOW_SIZE=(\d+)")
+    max_window = int(child.match.group(1))
+    times = []
+    for window in WINDOW_SIZES:
+        if window > max_window:
+            break
+        server.window = window
+        child.sendline("tftp_get %s test.bin" % addr)
+        child.expect(r"(\d+) bytes received in (\d+) ms: (\d+) kbit/s")
+        assert int(child.match.group(1)) == FILE_SIZE
+        times.append(int(child.match.group(2)))
+        print("windowsize %2d: %5d ms, %5s kbit/s" %
+              (window, times[-1], child.match.group(3)))
+    # sending a window at once must not be slower than lock-step
+    assert times[-1] <= times[0]
+
+    # write a file to the RIOT server, streamed to its MTD, and read it back
+    child.sendline("tftp_server")
+    child.expect(r"server: listening on port (\d+)")
+    port = int(child.match.group(1))
+    child.sendline("ifconfig")
+    child.expect(r"inet6 addr: (fe80:[0-9a-f:]+)")
+    dst = (child.match.group(1), port, 0,
+           socket.if_nametoindex(os.environ.get('PORT', 'tap0')))
+    data = bytes((i * 7) & 0xff for i in range(SERVER_FILE_SIZE))
+    put(dst, data)
+    child.expect_exact("server: %d bytes transferred" % SERVER_FILE_SIZE)
+    tsize, received = get(dst)
+    child.expect_exact("server: %d bytes transferred" % SERVER_FILE_SIZE)
+    assert tsize == SERVER_FILE_SIZE
+    assert received == data
+
+
+if __name__ == "__main__":
+    sys.path.append(os.path.join(os.environ['RIOTTOOLS'], 'testrunner'))
+    import testrunner
+
+    server = Server()
+    server.start()
+    sys.exit(testrunner.run(testfunc, timeout=60))
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests poll(), select() and sock_poll() on UDP sockets
+ *
+ * @}
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "embUnit.h"
+#include "event.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/poll.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#define TEST_PORT       (61616U)
+/* delay of the packets and events that arrive while waiting */
+#define TEST_DELAY      (100U * US_PER_MS)
+#define TEST_TIMEOUT_MS (20U)
+
+static const char _data[] = "ABCD";
+static char _buf[sizeof(_data)];
+static char _sender_stack[THREAD_STACKSIZE_DEFAULT];
+static int _fd = -1;
+static event_queue_t _queue;
+static event_t _event;
+static xtimer_t _event_timer;
+
+static void _send(void)
+{
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = TEST_PORT };
+
+    ipv6_addr_set_loopback((ipv6_addr_t *)&remote.addr.ipv6);
+    sock_udp_send(NULL, _data, sizeof(_data), &remote);
+}
+
+static void *_sender(void *arg)
+{
+    (void)arg;
+    xtimer_usleep(TEST_DELAY);
+    _send();
+    return NULL;
+}
+
+/* sends a packet to the socket after TEST_DELAY */
+static void _send_delayed(void)
+{
+    thread_create(_sender_stack, sizeof(_sender_stack), THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_STACKTEST, _sender, NULL, "sender");
+}
+
+static void _post_event(void *arg)
+{
+    (void)arg;
+    event_post(&_queue, &_event);
+}
+
+static void _handler(event_t *event)
+{
+    (void)event;
+}
+
+static void set_up(void)
+{
+    struct sockaddr_in6 local = { .sin6_family = AF_INET6,
+                                  .sin6_port = htons(TEST_PORT) };
+
+    _fd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    bind(_fd, (struct sockaddr *)&local, sizeof(local));
+}
+
+static void tear_down(void)
+{
+    close(_fd);
+    _fd = -1;
+}
+
+static void test_poll__timeout(void)
+{
+    struct pollfd fds = { .fd = _fd, .events = POLLIN };
+    uint32_t start = xtimer_now_usec();
+
+    TEST_ASSERT_EQUAL_INT(0, poll(&fds, 1, TEST_TIMEOUT_MS));
+    TEST_ASSERT((xtimer_now_usec() - start) >= (TEST_TIMEOUT_MS * US_PER_MS));
+    TEST_ASSERT_EQUAL_INT(0, fds.revents);
+    /* a zero timeout returns right away */
+    TEST_ASSERT_EQUAL_INT(0, poll(&fds, 1, 0));
+}
+
+static void test_poll__readiness(void)
+{
+    struct pollfd fds[] = {
+        { .fd = _fd, .events = POLLIN },
+        { .fd = -1, .events = POLLIN },
+    };
+
+    _send();
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, 2, 1000));
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds[0].revents);
+    TEST_ASSERT_EQUAL_INT(0, fds[1].revents);
+    TEST_ASSERT_EQUAL_INT(sizeof(_data), recv(_fd, _buf, sizeof(_buf), 0));
+    TEST_ASSERT_EQUAL_INT(0, poll(fds, 2, 0));
+    /* datagram sockets are always writable */
+    fds[0].events = POLLIN | POLLOUT;
+    TEST_ASSERT_EQUAL_INT(1, poll(fds, 1, 1000));
+    TEST_ASSERT_EQUAL_INT(POLLOUT, fds[0].revents);
+}
+
+static void test_poll__invalid(void)
+{
+    struct pollfd fds = { .fd = _fd + 1, .events = POLLIN };
+
+    TEST_ASSERT_EQUAL_INT(1, poll(&fds, 1, 1000));
+    TEST_ASSERT_EQUAL_INT(POLLNVAL, fds.revents);
+}
+
+static void test_poll__long_timeout(void)
+{
+    struct pollfd fds = { .fd = _fd, .events = POLLIN };
+
+    /* clamped instead of overflowing to a short timeout */
+    _send_delayed();
+    TEST_ASSERT_EQUAL_INT(1, poll(&fds, 1, INT_MAX));
+    TEST_ASSERT_EQUAL_INT(POLLIN, fds.revents);
+}
+
+static void test_select__readiness(void)
+{
+    struct timeval timeout = { .tv_sec = 1 };
+    fd_set readfds;
+
+    _send();
+    FD_ZERO(&readfds);
+    FD_SET(_fd, &readfds);
+    TEST_ASSERT_EQUAL_INT(1, select(_fd + 1, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT(FD_ISSET(_fd, &readfds));
+    TEST_ASSERT_EQUAL_INT(sizeof(_data), recv(_fd, _buf, sizeof(_buf), 0));
+}
+
+static void test_select__timeout(void)
+{
+    struct timeval timeout = { .tv_usec = TEST_TIMEOUT_MS * US_PER_MS };
+    uint32_t start = xtimer_now_usec();
+    fd_set readfds;
+
+    FD_ZERO(&readfds);
+    FD_SET(_fd, &readfds);
+    TEST_ASSERT_EQUAL_INT(0, select(_fd + 1, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT((xtimer_now_usec() - start) >= (TEST_TIMEOUT_MS * US_PER_MS));
+    TEST_ASSERT(!FD_ISSET(_fd, &readfds));
+}
+
+static void test_select__invalid(void)
+{
+    struct timeval timeout = { .tv_usec = US_PER_SEC };
+    fd_set readfds;
+
+    FD_ZERO(&readfds);
+    FD_SET(_fd, &readfds);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, select(_fd + 1, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    timeout.tv_usec = -1;
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, select(_fd + 1, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT_EQUAL_INT(EINVAL, errno);
+    /* no socket */
+    timeout.tv_usec = 0;
+    FD_ZERO(&readfds);
+    FD_SET(_fd + 1, &readfds);
+    errno = 0;
+    TEST_ASSERT_EQUAL_INT(-1, select(_fd + 2, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT_EQUAL_INT(EBADF, errno);
+}
+
+static void test_select__long_timeout(void)
+{
+    /* exceeds 32 bit microseconds, must neither fail nor wrap around */
+    struct timeval timeout = { .tv_sec = UINT32_MAX / US_PER_SEC,
+                               .tv_usec = US_PER_SEC - 1 };
+    fd_set readfds;
+
+    FD_ZERO(&readfds);
+    FD_SET(_fd, &readfds);
+    _send_delayed();
+    TEST_ASSERT_EQUAL_INT(1, select(_fd + 1, &readfds, NULL, NULL, &timeout));
+    TEST_ASSERT(FD_ISSET(_fd, &readfds));
+}
+
+static void test_sock_poll__event(void)
+{
+    sock_poll_t set[] = {
+        { .type = SOCK_POLL_UDP, .obj.udp = NULL },
+        { .type = SOCK_POLL_EVENT, .obj.queue = &_queue },
+    };
+
+    /* a pending event is ready right away */
+    event_post(&_queue, &_event);
+    TEST_ASSERT_EQUAL_INT(1, sock_poll(set, 2, 0));
+    TEST_ASSERT(set[1].ready);
+    TEST_ASSERT(event_get(&_queue) == &_event);
+    TEST_ASSERT_EQUAL_INT(0, sock_poll(set, 2, 0));
+    TEST_ASSERT(!set[1].ready);
+    /* an event posted while waiting wakes the thread up */
+    _event_timer.callback = _post_event;
+    xtimer_set(&_event_timer, TEST_DELAY);
+    TEST_ASSERT_EQUAL_INT(1, sock_poll(set, 2, 10 * TEST_DELAY));
+    TEST_ASSERT(!set[0].ready);
+    TEST_ASSERT(set[1].ready);
+    TEST_ASSERT(event_get(&_queue) == &_event);
+}
+
+static Test *tests_posix_poll(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_poll__timeout),
+        new_TestFixture(test_poll__readiness),
+        new_TestFixture(test_poll__invalid),
+        new_TestFixture(test_poll__long_timeout),
+        new_TestFixture(test_select__readiness),
+        new_TestFixture(test_select__timeout),
+        new_TestFixture(test_select__invalid),
+        new_TestFixture(test_select__long_timeout),
+        new_TestFixture(test_sock_poll__event),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, tear_down, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    /* the queue belongs to the thread calling sock_poll() */
+    event_queue_init(&_queue);
+    _event.handler = _handler;
+
+    TESTS_START();
+    TESTS_RUN(tests_posix_poll());
+    TESTS_END();
+
+    return 0;
+}
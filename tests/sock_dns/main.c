@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the sock DNS resolver against a DNS server on the
+ *              loopback address
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "embUnit.h"
+#include "msg.h"
+#include "mutex.h"
+#include "net/ipv6/addr.h"
+#include "net/sock/dns.h"
+#include "net/sock/udp.h"
+#include "thread.h"
+
+#define SERVER_BUF_SIZE     (128U)
+#define SERVER_TTL          (300U)
+#define QUERIER_NUMOF       (2U)
+#define ASYNC_NUMOF         (3U)
+
+typedef struct {
+    const char *name;
+    int family;
+    int res;
+    uint8_t addr[sizeof(ipv6_addr_t)];
+    mutex_t done;
+} _querier_t;
+
+typedef struct {
+    sock_dns_async_t *req;
+    int res;
+    uint8_t addr[sizeof(ipv6_addr_t)];
+} _result_t;
+
+sock_udp_ep_t sock_dns_server = { .family = AF_INET6, .port = SOCK_DNS_PORT };
+
+static const uint8_t _addr4[] = { 192, 0, 2, 1 };
+static const uint8_t _addr6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                  0, 0, 0, 0, 0, 0, 0, 1 };
+
+static char _server_stack[THREAD_STACKSIZE_DEFAULT];
+static char _querier_stacks[QUERIER_NUMOF][SOCK_DNS_ASYNC_STACK_SIZE];
+static uint8_t _server_buf[SERVER_BUF_SIZE];
+static _querier_t _queriers[QUERIER_NUMOF];
+static sock_dns_async_t _reqs[ASYNC_NUMOF];
+static _result_t _results[ASYNC_NUMOF];
+static kernel_pid_t _main_pid;
+/* held to let the server sit on the queries it received */
+static mutex_t _gate = MUTEX_INIT;
+/* queries received by the server */
+static volatile unsigned _queries;
+/* length of the address records sent by the server, 0 for the right one */
+static volatile unsigned _rdlen;
+
+static size_t _reply(uint8_t *buf, size_t len)
+{
+    sock_dns_hdr_t *hdr = (sock_dns_hdr_t *)buf;
+    uint8_t *pos = hdr->payload;
+    uint8_t *end = buf + len;
+    uint16_t type;
+    unsigned rdlen;
+
+    /* skip the name of the only question */
+    while ((pos < end) && *pos) {
+        pos += *pos + 1;
+    }
+    pos++;
+    if ((pos + 4) > end) {
+        return 0;
+    }
+    memcpy(&type, pos, sizeof(type));
+    pos += 4;
+    rdlen = _rdlen;
+    if (rdlen == 0) {
+        rdlen = (type == htons(DNS_TYPE_AAAA)) ? sizeof(_addr6) : sizeof(_addr4);
+    }
+    if ((pos + 12 + rdlen) > (buf + SERVER_BUF_SIZE)) {
+        return 0;
+    }
+
+    hdr->flags = htons(0x8180);  /* response, recursion, no error */
+    hdr->ancount = htons(1);
+    /* name is a pointer to the question */
+    *pos++ = 0xc0;
+    *pos++ = sizeof(sock_dns_hdr_t);
+    memcpy(pos, &type, sizeof(type));
+    pos += 2;
+    *pos++ = 0;
+    *pos++ = DNS_CLASS_IN;
+    *pos++ = 0;
+    *pos++ = 0;
+    *pos++ = SERVER_TTL >> 8;
+    *pos++ = SERVER_TTL & 0xff;
+    *pos++ = 0;
+    *pos++ = rdlen;
+    memset(pos, 0xff, rdlen);
+    if (type == htons(DNS_TYPE_AAAA)) {
+        memcpy(pos, _addr6, (rdlen < sizeof(_addr6)) ? rdlen : sizeof(_addr6));
+    }
+    else {
+        memcpy(pos, _addr4, (rdlen < sizeof(_addr4)) ? rdlen : sizeof(_addr4));
+    }
+    return (pos + rdlen) - buf;
+}
+
+static void *_server(void *arg)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+    sock_udp_t sock;
+
+    (void)arg;
+    local.port = SOCK_DNS_PORT;
+    if (sock_udp_create(&sock, &local, NULL, 0) < 0) {
+        return NULL;
+    }
+    while (1) {
+        sock_udp_ep_t remote;
+        ssize_t res = sock_udp_recv(&sock, _server_buf, sizeof(_server_buf),
+                                    SOCK_NO_TIMEOUT, &remote);
+
+        if (res < (ssize_t)sizeof(sock_dns_hdr_t)) {
+            continue;
+        }
+        _queries++;
+        mutex_lock(&_gate);
+        mutex_unlock(&_gate);
+        res = _reply(_server_buf, res);
+        if (res > 0) {
+            sock_udp_send(&sock, _server_buf, res, &remote);
+        }
+    }
+    return NULL;
+}
+
+static void *_querier(void *arg)
+{
+    _querier_t *q = arg;
+
+    q->res = sock_dns_query(q->name, q->addr, q->family);
+    mutex_unlock(&q->done);
+    return NULL;
+}
+
+static void _cb(sock_dns_async_t *req, int res, const void *addr)
+{
+    _result_t *r = req->arg;
+    msg_t msg;
+
+    r->req = req;
+    r->res = res;
+    if (res > 0) {
+        memcpy(r->addr, addr, res);
+    }
+    msg_send(&msg, _main_pid);
+}
+
+static void set_up(void)
+{
+    sock_dns_stats_t stats;
+
+    sock_dns_stats(&stats, true);
+    _queries = 0;
+    _rdlen = 0;
+    memset(_queriers, 0, sizeof(_queriers));
+    memset(_results, 0, sizeof(_results));
+}
+
+static void test_sock_dns_query__aaaa(void)
+{
+    uint8_t addr[sizeof(ipv6_addr_t)];
+
+    TEST_ASSERT_EQUAL_INT(sizeof(_addr6),
+                          sock_dns_query("riot-os.org", addr, AF_INET6));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_addr6, addr, sizeof(_addr6)));
+    TEST_ASSERT_EQUAL_INT(1, _queries);
+}
+
+static void test_sock_dns_query__a(void)
+{
+    uint8_t addr[sizeof(ipv6_addr_t)];
+
+    TEST_ASSERT_EQUAL_INT(sizeof(_addr4),
+                          sock_dns_query("riot-os.org", addr, AF_INET));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_addr4, addr, sizeof(_addr4)));
+    TEST_ASSERT_EQUAL_INT(1, _queries);
+}
+
+static void test_sock_dns_query__a_too_long(void)
+{
+    static const uint8_t zero[sizeof(ipv6_addr_t)] = { 0 };
+    uint8_t addr[sizeof(ipv6_addr_t)] = { 0 };
+
+    /* would overflow a buffer sized for an IPv4 address */
+    _rdlen = sizeof(_addr6);
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, sock_dns_query("riot-os.org", addr,
+                                                   AF_INET));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(zero, addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL_INT(SOCK_DNS_RETRIES, _queries);
+}
+
+static void test_sock_dns_query__aaaa_too_short(void)
+{
+    static const uint8_t zero[sizeof(ipv6_addr_t)] = { 0 };
+    uint8_t addr[sizeof(ipv6_addr_t)] = { 0 };
+
+    _rdlen = sizeof(_addr4);
+    TEST_ASSERT_EQUAL_INT(-EBADMSG, sock_dns_query("riot-os.org", addr,
+                                                   AF_INET6));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(zero, addr, sizeof(addr)));
+    TEST_ASSERT_EQUAL_INT(SOCK_DNS_RETRIES, _queries);
+}
+
+static void test_sock_dns_query__coalesced(void)
+{
+    sock_dns_stats_t stats;
+
+    mutex_lock(&_gate);
+    for (unsigned i = 0; i < QUERIER_NUMOF; i++) {
+        _queriers[i].name = "coalesced.riot-os.org";
+        _queriers[i].family = AF_INET6;
+        mutex_init(&_queriers[i].done);
+        mutex_lock(&_queriers[i].done);
+        /* runs until it waits for the server or the first querier */
+        thread_create(_querier_stacks[i], sizeof(_querier_stacks[i]),
+                      THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                      _querier, &_queriers[i], "querier");
+    }
+    TEST_ASSERT_EQUAL_INT(1, _queries);
+    sock_dns_stats(&stats, false);
+    TEST_ASSERT_EQUAL_INT(1, stats.misses);
+    TEST_ASSERT_EQUAL_INT(QUERIER_NUMOF - 1, stats.coalesced);
+    mutex_unlock(&_gate);
+    for (unsigned i = 0; i < QUERIER_NUMOF; i++) {
+        mutex_lock(&_queriers[i].done);
+        TEST_ASSERT_EQUAL_INT(sizeof(_addr6), _queriers[i].res);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(_addr6, _queriers[i].addr,
+                                        sizeof(_addr6)));
+    }
+    TEST_ASSERT_EQUAL_INT(1, _queries);
+}
+
+static void test_sock_dns_query_async(void)
+{
+    static const char *names[] = { "async.riot-os.org", "async.riot-os.org",
+                                   "riot-os.org" };
+    static const int families[] = { AF_INET6, AF_INET6, AF_INET };
+
+    mutex_lock(&_gate);
+    for (unsigned i = 0; i < ASYNC_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(0, sock_dns_query_async(&_reqs[i], names[i],
+                                                      families[i], _cb,
+                                                      &_results[i]));
+    }
+    /* the resolver waits for the answer to the first query */
+    TEST_ASSERT_EQUAL_INT(1, _queries);
+    mutex_unlock(&_gate);
+    for (unsigned i = 0; i < ASYNC_NUMOF; i++) {
+        msg_t msg;
+
+        msg_receive(&msg);
+    }
+    /* the second query was answered together with the first */
+    TEST_ASSERT_EQUAL_INT(2, _queries);
+    for (unsigned i = 0; i < ASYNC_NUMOF; i++) {
+        TEST_ASSERT(_results[i].req == &_reqs[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(sizeof(_addr6), _results[0].res);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_addr6, _results[0].addr, sizeof(_addr6)));
+    TEST_ASSERT_EQUAL_INT(sizeof(_addr6), _results[1].res);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_addr6, _results[1].addr, sizeof(_addr6)));
+    TEST_ASSERT_EQUAL_INT(sizeof(_addr4), _results[2].res);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_addr4, _results[2].addr, sizeof(_addr4)));
+}
+
+static Test *tests_sock_dns(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sock_dns_query__aaaa),
+        new_TestFixture(test_sock_dns_query__a),
+        new_TestFixture(test_sock_dns_query__a_too_long),
+        new_TestFixture(test_sock_dns_query__aaaa_too_short),
+        new_TestFixture(test_sock_dns_query__coalesced),
+        new_TestFixture(test_sock_dns_query_async),
+    };
+
+    EMB_UNIT_TESTCALLER(tests, set_up, NULL, fixtures);
+
+    return (Test *)&tests;
+}
+
+int main(void)
+{
+    _main_pid = thread_getpid();
+    ipv6_addr_set_loopback((ipv6_addr_t *)&sock_dns_server.addr.ipv6);
+    /* runs until it waits for the first query */
+    thread_create(_server_stack, sizeof(_server_stack),
+                  THREAD_PRIORITY_MAIN - 2, THREAD_CREATE_STACKTEST,
+                  _server, NULL, "dns_server");
+
+    TESTS_START();
+    TESTS_RUN(tests_sock_dns());
+    TESTS_END();
+
+    return 0;
+}
@@ -56,6 +56,27 @@ static void callback(void *args)
 static trickle_t trickle = { .callback = { .func = &callback,
                                            .args = NULL } };
 
+static bool _stats_equal(uint32_t sent, uint32_t suppressed, uint32_t resets,
+                         uint32_t heard)
+{
+    printf("sent = %" PRIu32 ", suppressed = %" PRIu32 ", resets = %" PRIu32
+           ", heard = %" PRIu32 "\n", trickle.stats.sent,
+           trickle.stats.suppressed, trickle.stats.resets, trickle.stats.heard);
+    return (trickle.stats.sent == sent) &&
+           (trickle.stats.suppressed == suppressed) &&
+           (trickle.stats.resets == resets) && (trickle.stats.heard == heard);
+}
+
+static void _callback(trickle_t *t)
+{
+    /* the callback is called at time t within the interval */
+    if (xtimer_now_usec64() < t->start) {
+        puts("callback before start of interval");
+        error = true;
+    }
+    trickle_callback(t);
+}
+
 int main(void)
 {
     msg_t msg;
@@ -74,8 +95,7 @@ int main(void)
             puts("[TRICKLE_RESET]");
         }
         else if (counter == SECOND_ROUND) {
-            puts("[SUCCESS]");
-            return 0;
+            break;
         }
 
         counter++;
@@ -84,14 +104,34 @@ int main(void)
 
         switch (msg.type) {
             case TRICKLE_MSG:
-                trickle_callback((trickle_t *) msg.content.ptr);
+                _callback((trickle_t *) msg.content.ptr);
                 break;
             default:
                 break;
         }
     }
 
-    puts("[FAILURE]");
+    if (error || !_stats_equal(SECOND_ROUND, 0, 1, 0)) {
+        puts("[FAILURE]");
+        return 1;
+    }
+
+    /* hearing k consistent messages suppresses the next callback */
+    for (unsigned i = 0; i < TR_REDCONST; i++) {
+        trickle_increment_counter(&trickle);
+    }
+    do {
+        msg_receive(&msg);
+    } while (msg.type != TRICKLE_MSG);
+    _callback((trickle_t *) msg.content.ptr);
+    trickle_stop(&trickle);
+
+    if (error || !_stats_equal(SECOND_ROUND, 1, 1, TR_REDCONST)) {
+        puts("[FAILURE]");
+        return 1;
+    }
+
+    puts("[SUCCESS]");
 
-    return 1;
+    return 0;
 }
@@ -21,6 +21,8 @@ def testfunc(child):
     for i in range(7):
         child.expect(u"now = \d+, prev_now = \d+, diff = \d+")
 
+    child.expect_exact("sent = 12, suppressed = 0, resets = 1, heard = 0")
+    child.expect_exact("sent = 12, suppressed = 1, resets = 1, heard = 10")
     child.expect_exact("[SUCCESS]")
 
 
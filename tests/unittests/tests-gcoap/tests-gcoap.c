@@ -35,6 +35,13 @@ static const coap_resource_t resources_second[] = {
     { .path = "/second/part", .methods = (COAP_GET)},
 };
 
+/* Resources with path patterns, registered after the resource list test */
+static const coap_resource_t resources_pattern[] = {
+    { .path = "/3/1", .methods = (COAP_PUT) },
+    { .path = "/3/*", .methods = (COAP_GET) },
+    { .path = "/fw", .methods = (COAP_GET | GCOAP_MATCH_SUBTREE) },
+};
+
 static gcoap_listener_t listener = {
     .resources     = (coap_resource_t *)&resources[0],
     .resources_len = (sizeof(resources) / sizeof(resources[0])),
@@ -47,6 +54,21 @@ static gcoap_listener_t listener_second = {
     .next          = NULL
 };
 
+static gcoap_listener_t listener_pattern = {
+    .resources     = (coap_resource_t *)&resources_pattern[0],
+    .resources_len = (sizeof(resources_pattern) / sizeof(resources_pattern[0])),
+    .next          = NULL
+};
+
+/* More resources than fit into the trie, initialized by the test */
+static coap_resource_t resources_overflow[GCOAP_RESOURCES_MAX];
+
+static gcoap_listener_t listener_overflow = {
+    .resources     = &resources_overflow[0],
+    .resources_len = GCOAP_RESOURCES_MAX,
+    .next          = NULL
+};
+
 static const char *resource_list_str = "</act/switch>,</sensor/temp>,</test/info/all>,</second/part>";
 
 /*
@@ -88,6 +110,88 @@ static void test_gcoap__client_get_req(void)
     TEST_ASSERT_EQUAL_INT(sizeof(pdu_data), len);
 }
 
+/*
+ * Client PUT request with options added before the payload, so the payload
+ * is written in place.
+ */
+static void test_gcoap__client_put_req_inplace(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    char path[] = "/riot/value";
+    char payload[] = "10";
+
+    TEST_ASSERT_EQUAL_INT(0, gcoap_req_init(&pdu, &buf[0], sizeof(buf),
+                                            COAP_METHOD_PUT, &path[0]));
+    TEST_ASSERT(coap_opt_add_format(&pdu, COAP_FORMAT_TEXT) > 0);
+    TEST_ASSERT(coap_opt_finish(&pdu, COAP_OPT_FINISH_PAYLOAD) > 0);
+
+    uint8_t *payload_pos = pdu.payload;
+    memcpy(pdu.payload, payload, strlen(payload));
+    ssize_t len = gcoap_finish(&pdu, strlen(payload), COAP_FORMAT_NONE);
+
+    /* header, Uri-Path "riot" and "value", Content-Format, marker */
+    TEST_ASSERT_EQUAL_INT(4 + GCOAP_TOKENLEN + 5 + 6 + 1 + 1, payload_pos - buf);
+    TEST_ASSERT_EQUAL_INT((payload_pos - buf) + strlen(payload), len);
+    TEST_ASSERT(pdu.payload == payload_pos);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, &buf[0], len));
+    TEST_ASSERT_EQUAL_STRING(&path[0], (char *)&pdu.url[0]);
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_TEXT, pdu.content_type);
+    TEST_ASSERT_EQUAL_INT(strlen(payload), pdu.payload_len);
+    TEST_ASSERT(memcmp(pdu.payload, payload, strlen(payload)) == 0);
+}
+
+/*
+ * Client POST request with a query string and the payload written in place.
+ * The Uri-Query options are added before the Content-Format, but end up
+ * behind it.
+ */
+static void test_gcoap__client_post_req_inplace_qstring(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    coap_optiter_t iter;
+    uint8_t *val;
+    int opt_len;
+    char path[] = "/rd";
+    char payload[] = "</a>";
+
+    TEST_ASSERT_EQUAL_INT(0, gcoap_req_init(&pdu, &buf[0], sizeof(buf),
+                                            COAP_METHOD_POST, &path[0]));
+    TEST_ASSERT(gcoap_add_qstring(&pdu, "ep", "node") > 0);
+    TEST_ASSERT(coap_opt_add_format(&pdu, COAP_FORMAT_LINK) > 0);
+    TEST_ASSERT(gcoap_add_qstring(&pdu, "lt", NULL) > 0);
+    TEST_ASSERT(coap_opt_finish(&pdu, COAP_OPT_FINISH_PAYLOAD) > 0);
+    /* no more options once the payload follows */
+    TEST_ASSERT_EQUAL_INT(-1, gcoap_add_qstring(&pdu, "d", "x"));
+
+    memcpy(pdu.payload, payload, strlen(payload));
+    ssize_t len = gcoap_finish(&pdu, strlen(payload), COAP_FORMAT_NONE);
+    TEST_ASSERT(len > 0);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, &buf[0], len));
+    TEST_ASSERT_EQUAL_STRING(&path[0], (char *)&pdu.url[0]);
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_LINK, pdu.content_type);
+    TEST_ASSERT_EQUAL_INT(strlen(payload), pdu.payload_len);
+    TEST_ASSERT(memcmp(pdu.payload, payload, strlen(payload)) == 0);
+
+    coap_optiter_init(&pdu, &iter);
+    TEST_ASSERT(coap_optiter_next(&iter, &opt_len) != NULL);
+    TEST_ASSERT_EQUAL_INT(COAP_OPT_URI_PATH, iter.opt_num);
+    TEST_ASSERT(coap_optiter_next(&iter, &opt_len) != NULL);
+    TEST_ASSERT_EQUAL_INT(COAP_OPT_CONTENT_FORMAT, iter.opt_num);
+    val = coap_optiter_next(&iter, &opt_len);
+    TEST_ASSERT_EQUAL_INT(COAP_OPT_URI_QUERY, iter.opt_num);
+    TEST_ASSERT_EQUAL_INT(7, opt_len);
+    TEST_ASSERT(memcmp(val, "ep=node", 7) == 0);
+    val = coap_optiter_next(&iter, &opt_len);
+    TEST_ASSERT_EQUAL_INT(COAP_OPT_URI_QUERY, iter.opt_num);
+    TEST_ASSERT_EQUAL_INT(2, opt_len);
+    TEST_ASSERT(memcmp(val, "lt", 2) == 0);
+    TEST_ASSERT(coap_optiter_next(&iter, &opt_len) == NULL);
+}
+
 /*
  * Client GET response success case. Test parsing response.
  * Response for /time resource from libcoap example
@@ -278,16 +382,163 @@ static void test_gcoap__server_get_resource_list(void)
     TEST_ASSERT_EQUAL_STRING(resource_list_str, (char *)res);
 }
 
+/*
+ * Helper for server_find_resource tests below.
+ * Builds and parses a request, then looks up its resource.
+ * Returns -EINVAL if the request can't be built.
+ */
+static int _find_resource(unsigned code, char *path, coap_resource_t **resource,
+                          gcoap_listener_t **listener_ptr)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+
+    ssize_t len = gcoap_request(&pdu, &buf[0], sizeof(buf), code, path);
+    if ((len <= 0) || (coap_parse(&pdu, &buf[0], len) < 0)) {
+        return -EINVAL;
+    }
+
+    *resource = NULL;
+    *listener_ptr = NULL;
+    return gcoap_find_resource(&pdu, resource, listener_ptr);
+}
+
+/* Exact matches, also requires resources registered by the previous test */
+static void test_gcoap__server_find_resource(void)
+{
+    coap_resource_t *resource;
+    gcoap_listener_t *res_listener;
+
+    TEST_ASSERT_EQUAL_INT(0, gcoap_register_listener(&listener_pattern));
+
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/sensor/temp",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources[1]);
+    TEST_ASSERT(res_listener == &listener);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/second/part",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_second[0]);
+    TEST_ASSERT(res_listener == &listener_second);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/.well-known/core",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_STRING("/.well-known/core", resource->path);
+
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_WRONG_METHOD,
+                          _find_resource(COAP_METHOD_POST, "/sensor/temp",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/sensor",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/sensor/temp/x",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/",
+                                         &resource, &res_listener));
+}
+
+/* Single segment wildcard and subtree resources */
+static void test_gcoap__server_find_resource_pattern(void)
+{
+    coap_resource_t *resource;
+    gcoap_listener_t *res_listener;
+
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/3/0",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_pattern[1]);
+    TEST_ASSERT(res_listener == &listener_pattern);
+    /* exact segment preferred, wildcard used for other methods */
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_PUT, "/3/1",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_pattern[0]);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/3/1",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_pattern[1]);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_WRONG_METHOD,
+                          _find_resource(COAP_METHOD_PUT, "/3/0",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/3",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/3/0/1",
+                                         &resource, &res_listener));
+
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/fw",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_pattern[2]);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/fw/slot/0",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_pattern[2]);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_WRONG_METHOD,
+                          _find_resource(COAP_METHOD_POST, "/fw/slot",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/fwx",
+                                         &resource, &res_listener));
+    /* code 0.16 shares its flag bit with GCOAP_MATCH_SUBTREE */
+    TEST_ASSERT(_find_resource(16, "/fw", &resource, &res_listener)
+                != GCOAP_RESOURCE_FOUND);
+    TEST_ASSERT(_find_resource(16, "/fw/slot", &resource, &res_listener)
+                != GCOAP_RESOURCE_FOUND);
+}
+
+/* A listener that does not fit into the trie is rejected as a whole */
+static void test_gcoap__server_register_overflow(void)
+{
+    coap_resource_t *resource;
+    gcoap_listener_t *res_listener;
+
+    for (unsigned i = 0; i < GCOAP_RESOURCES_MAX; i++) {
+        resources_overflow[i].path = (i & 1) ? "/overflow/b" : "/overflow/a";
+        resources_overflow[i].methods = COAP_GET;
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, gcoap_register_listener(&listener_overflow));
+
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_NO_PATH,
+                          _find_resource(COAP_METHOD_GET, "/overflow/a",
+                                         &resource, &res_listener));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/sensor/temp",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources[1]);
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/fw/slot",
+                                         &resource, &res_listener));
+    TEST_ASSERT(resource == &resources_pattern[2]);
+
+    /* the space of the rejected listener is available again */
+    listener_overflow.resources_len = 1;
+    TEST_ASSERT_EQUAL_INT(0, gcoap_register_listener(&listener_overflow));
+    TEST_ASSERT_EQUAL_INT(GCOAP_RESOURCE_FOUND,
+                          _find_resource(COAP_METHOD_GET, "/overflow/a",
+                                         &resource, &res_listener));
+    TEST_ASSERT(res_listener == &listener_overflow);
+}
+
 Test *tests_gcoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_gcoap__client_get_req),
+        new_TestFixture(test_gcoap__client_put_req_inplace),
+        new_TestFixture(test_gcoap__client_post_req_inplace_qstring),
         new_TestFixture(test_gcoap__client_get_resp),
         new_TestFixture(test_gcoap__server_get_req),
         new_TestFixture(test_gcoap__server_get_resp),
         new_TestFixture(test_gcoap__server_con_req),
         new_TestFixture(test_gcoap__server_con_resp),
-        new_TestFixture(test_gcoap__server_get_resource_list)
+        new_TestFixture(test_gcoap__server_get_resource_list),
+        new_TestFixture(test_gcoap__server_find_resource),
+        new_TestFixture(test_gcoap__server_find_resource_pattern),
+        new_TestFixture(test_gcoap__server_register_overflow),
     };
 
     EMB_UNIT_TESTCALLER(gcoap_tests, NULL, NULL, fixtures);
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <stddef.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "msg.h"
+#include "thread.h"
+#include "net/ipv6.h"
+#include "net/gnrc/icmpv6/error.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "tests-gnrc_icmpv6_error.h"
+
+#define TEST_NETIF_PID      (7)
+#define TEST_PAYLOAD_SIZE   (16U)
+#define TEST_PTR_OFFSET     (5U)
+#define TEST_MTU            (1280U)
+#define ERROR_HDR_SIZE      (sizeof(icmpv6_error_dst_unr_t))
+
+static const ipv6_addr_t _src = { {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 1
+    } };
+static const ipv6_addr_t _dst = { {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 2
+    } };
+static msg_t _msg_queue[4];
+static uint8_t _payload[IPV6_MIN_MTU];
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    msg_init_queue(_msg_queue, sizeof(_msg_queue) / sizeof(_msg_queue[0]));
+    /* receive the error messages instead of the IPv6 thread */
+    gnrc_ipv6_pid = thread_getpid();
+    for (unsigned i = 0; i < sizeof(_payload); i++) {
+        _payload[i] = (uint8_t)i;
+    }
+}
+
+static void tear_down(void)
+{
+    gnrc_ipv6_pid = KERNEL_PID_UNDEF;
+}
+
+/* builds a packet as received by the IPv6 layer: payload <- IPv6 <- netif */
+static gnrc_pktsnip_t *_build_orig(const ipv6_addr_t *src,
+                                   const ipv6_addr_t *dst,
+                                   size_t payload_size)
+{
+    gnrc_pktsnip_t *netif, *ipv6;
+    ipv6_hdr_t hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    ipv6_hdr_set_version(&hdr);
+    hdr.len = byteorder_htons(payload_size);
+    hdr.nh = PROTNUM_UDP;
+    hdr.hl = 64;
+    hdr.src = *src;
+    hdr.dst = *dst;
+    if ((netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0)) == NULL) {
+        return NULL;
+    }
+    ((gnrc_netif_hdr_t *)netif->data)->if_pid = TEST_NETIF_PID;
+    if ((ipv6 = gnrc_pktbuf_add(netif, &hdr, sizeof(hdr),
+                                GNRC_NETTYPE_IPV6)) == NULL) {
+        return NULL;
+    }
+    return gnrc_pktbuf_add(ipv6, _payload, payload_size, GNRC_NETTYPE_UNDEF);
+}
+
+/* checks that the invoking packet is copied in wire order */
+static void _test_copy(gnrc_pktsnip_t *err, gnrc_pktsnip_t *orig)
+{
+    uint8_t *data = err->data;
+    gnrc_pktsnip_t *ipv6 = orig->next;
+
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data + ERROR_HDR_SIZE, ipv6->data,
+                                    sizeof(ipv6_hdr_t)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data + ERROR_HDR_SIZE + sizeof(ipv6_hdr_t),
+                                    orig->data,
+                                    err->size - ERROR_HDR_SIZE -
+                                    sizeof(ipv6_hdr_t)));
+}
+
+static void test_gnrc_icmpv6_error_dst_unr_build(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&_src, &_dst, TEST_PAYLOAD_SIZE);
+    gnrc_pktsnip_t *err;
+    icmpv6_hdr_t *hdr;
+
+    TEST_ASSERT_NOT_NULL(orig);
+    TEST_ASSERT_NOT_NULL((err = gnrc_icmpv6_error_dst_unr_build(
+                              ICMPV6_ERROR_DST_UNR_PORT, orig)));
+    TEST_ASSERT_NULL(err->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_ICMPV6, err->type);
+    TEST_ASSERT_EQUAL_INT(ERROR_HDR_SIZE + sizeof(ipv6_hdr_t) +
+                          TEST_PAYLOAD_SIZE, err->size);
+    hdr = err->data;
+    TEST_ASSERT_EQUAL_INT(ICMPV6_DST_UNR, hdr->type);
+    TEST_ASSERT_EQUAL_INT(ICMPV6_ERROR_DST_UNR_PORT, hdr->code);
+    _test_copy(err, orig);
+    gnrc_pktbuf_release(err);
+    gnrc_pktbuf_release(orig);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_icmpv6_error_pkt_too_big_build(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&_src, &_dst, TEST_PAYLOAD_SIZE);
+    gnrc_pktsnip_t *err;
+    icmpv6_error_pkt_too_big_t *hdr;
+
+    TEST_ASSERT_NOT_NULL(orig);
+    TEST_ASSERT_NOT_NULL((err = gnrc_icmpv6_error_pkt_too_big_build(TEST_MTU,
+                                                                    orig)));
+    hdr = err->data;
+    TEST_ASSERT_EQUAL_INT(ICMPV6_PKT_TOO_BIG, hdr->type);
+    TEST_ASSERT_EQUAL_INT(0, hdr->code);
+    TEST_ASSERT_EQUAL_INT(TEST_MTU, byteorder_ntohl(hdr->mtu));
+    _test_copy(err, orig);
+    gnrc_pktbuf_release(err);
+    gnrc_pktbuf_release(orig);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_icmpv6_error_param_prob_build(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&_src, &_dst, TEST_PAYLOAD_SIZE);
+    gnrc_pktsnip_t *err;
+    icmpv6_error_param_prob_t *hdr;
+    ipv6_hdr_t *ipv6;
+
+    TEST_ASSERT_NOT_NULL(orig);
+    /* pointer into the payload */
+    TEST_ASSERT_NOT_NULL((err = gnrc_icmpv6_error_param_prob_build(
+                              ICMPV6_ERROR_PARAM_PROB_HDR_FIELD,
+                              ((uint8_t *)orig->data) + TEST_PTR_OFFSET,
+                              orig)));
+    hdr = err->data;
+    TEST_ASSERT_EQUAL_INT(ICMPV6_PARAM_PROB, hdr->type);
+    TEST_ASSERT_EQUAL_INT(ICMPV6_ERROR_PARAM_PROB_HDR_FIELD, hdr->code);
+    TEST_ASSERT_EQUAL_INT(sizeof(ipv6_hdr_t) + TEST_PTR_OFFSET,
+                          byteorder_ntohl(hdr->ptr));
+    _test_copy(err, orig);
+    gnrc_pktbuf_release(err);
+    /* pointer into the IPv6 header */
+    ipv6 = orig->next->data;
+    TEST_ASSERT_NOT_NULL((err = gnrc_icmpv6_error_param_prob_build(
+                              ICMPV6_ERROR_PARAM_PROB_NH, &ipv6->nh, orig)));
+    hdr = err->data;
+    TEST_ASSERT_EQUAL_INT(offsetof(ipv6_hdr_t, nh), byteorder_ntohl(hdr->ptr));
+    gnrc_pktbuf_release(err);
+    gnrc_pktbuf_release(orig);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_icmpv6_error_build_too_large(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&_src, &_dst, sizeof(_payload));
+    gnrc_pktsnip_t *err;
+
+    TEST_ASSERT_NOT_NULL(orig);
+    TEST_ASSERT_NOT_NULL((err = gnrc_icmpv6_error_time_exc_build(
+                              ICMPV6_ERROR_TIME_EXC_HL, orig)));
+    /* the error message must fit into the minimum MTU */
+    TEST_ASSERT_EQUAL_INT(IPV6_MIN_MTU - sizeof(ipv6_hdr_t), err->size);
+    _test_copy(err, orig);
+    gnrc_pktbuf_release(err);
+    gnrc_pktbuf_release(orig);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_icmpv6_error_send(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&_src, &_dst, TEST_PAYLOAD_SIZE);
+    gnrc_pktsnip_t *pkt;
+    gnrc_netif_hdr_t *netif_hdr;
+    ipv6_hdr_t *ipv6_hdr;
+    msg_t msg;
+
+    TEST_ASSERT_NOT_NULL(orig);
+    gnrc_icmpv6_error_dst_unr_send(ICMPV6_ERROR_DST_UNR_PORT, orig);
+    TEST_ASSERT_EQUAL_INT(1, msg_avail());
+    msg_receive(&msg);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETAPI_MSG_TYPE_SND, msg.type);
+    /* netif header <- IPv6 header towards the source <- ICMPv6 */
+    pkt = msg.content.ptr;
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_NETIF, pkt->type);
+    netif_hdr = pkt->data;
+    TEST_ASSERT_EQUAL_INT(TEST_NETIF_PID, netif_hdr->if_pid);
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6, pkt->next->type);
+    ipv6_hdr = pkt->next->data;
+    TEST_ASSERT(ipv6_addr_equal(&_src, &ipv6_hdr->dst));
+    TEST_ASSERT_NOT_NULL(pkt->next->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_ICMPV6, pkt->next->next->type);
+    gnrc_pktbuf_release(pkt);
+    /* the invoking packet was released */
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_icmpv6_error_send_mcast(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&_src, &ipv6_addr_all_nodes_link_local,
+                                       TEST_PAYLOAD_SIZE);
+    msg_t msg;
+
+    TEST_ASSERT_NOT_NULL(orig);
+    gnrc_icmpv6_error_time_exc_send(ICMPV6_ERROR_TIME_EXC_HL, orig);
+    TEST_ASSERT_EQUAL_INT(0, msg_avail());
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+    /* unless reporting an unrecognized option or a packet too big */
+    orig = _build_orig(&_src, &ipv6_addr_all_nodes_link_local,
+                       TEST_PAYLOAD_SIZE);
+    TEST_ASSERT_NOT_NULL(orig);
+    gnrc_icmpv6_error_param_prob_send(ICMPV6_ERROR_PARAM_PROB_OPT,
+                                      orig->data, orig);
+    TEST_ASSERT_EQUAL_INT(1, msg_avail());
+    msg_receive(&msg);
+    gnrc_pktbuf_release(msg.content.ptr);
+    orig = _build_orig(&_src, &ipv6_addr_all_nodes_link_local,
+                       TEST_PAYLOAD_SIZE);
+    TEST_ASSERT_NOT_NULL(orig);
+    gnrc_icmpv6_error_pkt_too_big_send(TEST_MTU, orig);
+    TEST_ASSERT_EQUAL_INT(1, msg_avail());
+    msg_receive(&msg);
+    gnrc_pktbuf_release(msg.content.ptr);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_icmpv6_error_send_unspec_src(void)
+{
+    gnrc_pktsnip_t *orig = _build_orig(&ipv6_addr_unspecified, &_dst,
+                                       TEST_PAYLOAD_SIZE);
+
+    TEST_ASSERT_NOT_NULL(orig);
+    gnrc_icmpv6_error_dst_unr_send(ICMPV6_ERROR_DST_UNR_PORT, orig);
+    TEST_ASSERT_EQUAL_INT(0, msg_avail());
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_icmpv6_error_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_icmpv6_error_dst_unr_build),
+        new_TestFixture(test_gnrc_icmpv6_error_pkt_too_big_build),
+        new_TestFixture(test_gnrc_icmpv6_error_param_prob_build),
+        new_TestFixture(test_gnrc_icmpv6_error_build_too_large),
+        new_TestFixture(test_gnrc_icmpv6_error_send),
+        new_TestFixture(test_gnrc_icmpv6_error_send_mcast),
+        new_TestFixture(test_gnrc_icmpv6_error_send_unspec_src),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_icmpv6_error_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&gnrc_icmpv6_error_tests;
+}
+
+void tests_gnrc_icmpv6_error(void)
+{
+    TESTS_RUN(tests_gnrc_icmpv6_error_tests());
+}
+/** @} */
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "msg.h"
+#include "thread.h"
+#include "net/icmpv6.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/ipv6.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/ipv6/ext.h"
+#include "net/protnum.h"
+
+#include "tests-gnrc_ipv6_ext.h"
+
+/* hop-by-hop options (8 byte) -> destination options (16 byte) -> UDP */
+static uint8_t chain[] = {
+    PROTNUM_IPV6_EXT_DST, 0, 1, 4, 0, 0, 0, 0,
+    PROTNUM_UDP, 1, 1, 12, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+#define CHAIN_DST_OFFSET    (8U)
+#define UDP_SIZE            (8U)
+
+/* hop-by-hop options (8 byte) -> authentication header (16 byte) -> UDP */
+static const uint8_t ah_chain[] = {
+    PROTNUM_IPV6_EXT_AH, 0, 1, 4, 0, 0, 0, 0,
+    PROTNUM_UDP, 1, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/* hop-by-hop options (8 byte) -> routing header of type 0 with segments
+ * left (8 byte) -> UDP */
+static const uint8_t rh_chain[] = {
+    PROTNUM_IPV6_EXT_RH, 0, 1, 4, 0, 0, 0, 0,
+    PROTNUM_UDP, 0, 0, 1, 0, 0, 0, 0,
+};
+
+#define RH_CHAIN_TYPE_OFFSET    (CHAIN_DST_OFFSET + 2U)
+
+static const ipv6_addr_t _src = { {
+        0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 1
+    } };
+static msg_t _msg_queue[8];
+static gnrc_netreg_entry_t _udp_entry, _dst_entry;
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    msg_init_queue(_msg_queue, sizeof(_msg_queue) / sizeof(_msg_queue[0]));
+    gnrc_netreg_entry_init_pid(&_udp_entry, PROTNUM_UDP, thread_getpid());
+    gnrc_netreg_entry_init_pid(&_dst_entry, PROTNUM_IPV6_EXT_DST,
+                               thread_getpid());
+    /* listen like a raw socket for UDP */
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_udp_entry);
+}
+
+static void tear_down(void)
+{
+    msg_t msg;
+
+    gnrc_netreg_unregister(GNRC_NETTYPE_IPV6, &_udp_entry);
+    gnrc_netreg_unregister(GNRC_NETTYPE_IPV6, &_dst_entry);
+    gnrc_ipv6_pid = KERNEL_PID_UNDEF;
+    while (msg_try_receive(&msg) > 0) {
+        if (msg.type == GNRC_NETAPI_MSG_TYPE_RCV) {
+            gnrc_pktbuf_release(msg.content.ptr);
+        }
+    }
+}
+
+static void test_gnrc_ipv6_ext_parse(void)
+{
+    gnrc_ipv6_ext_desc_t desc;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_ext_parse(&desc, chain, sizeof(chain),
+                                                 PROTNUM_IPV6_EXT_HOPOPT));
+    TEST_ASSERT_EQUAL_INT(2, desc.num);
+    TEST_ASSERT_EQUAL_INT(sizeof(chain), desc.len);
+    TEST_ASSERT_EQUAL_INT(PROTNUM_UDP, desc.nh);
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_EXT_HOPOPT, desc.hdrs[0].type);
+    TEST_ASSERT_EQUAL_INT(0, desc.hdrs[0].offset);
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_EXT_DST, desc.hdrs[1].type);
+    TEST_ASSERT_EQUAL_INT(CHAIN_DST_OFFSET, desc.hdrs[1].offset);
+}
+
+static void test_gnrc_ipv6_ext_parse_no_ext(void)
+{
+    gnrc_ipv6_ext_desc_t desc;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_ext_parse(&desc, chain, sizeof(chain),
+                                                 PROTNUM_ICMPV6));
+    TEST_ASSERT_EQUAL_INT(0, desc.num);
+    TEST_ASSERT_EQUAL_INT(0, desc.len);
+    TEST_ASSERT_EQUAL_INT(PROTNUM_ICMPV6, desc.nh);
+}
+
+static void test_gnrc_ipv6_ext_parse_truncated(void)
+{
+    gnrc_ipv6_ext_desc_t desc;
+
+    TEST_ASSERT_EQUAL_INT(-EBADMSG,
+                          gnrc_ipv6_ext_parse(&desc, chain, sizeof(chain) - 1,
+                                              PROTNUM_IPV6_EXT_HOPOPT));
+    TEST_ASSERT_EQUAL_INT(-EBADMSG,
+                          gnrc_ipv6_ext_parse(&desc, chain, CHAIN_DST_OFFSET + 1,
+                                              PROTNUM_IPV6_EXT_HOPOPT));
+}
+
+static void test_gnrc_ipv6_ext_parse_too_many(void)
+{
+    uint8_t data[(GNRC_IPV6_EXT_DESC_NUMOF + 1) * IPV6_EXT_LEN_UNIT];
+    gnrc_ipv6_ext_desc_t desc;
+
+    memset(data, 0, sizeof(data));
+    for (unsigned i = 0; i < sizeof(data); i += IPV6_EXT_LEN_UNIT) {
+        data[i] = PROTNUM_IPV6_EXT_DST;
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          gnrc_ipv6_ext_parse(&desc, data, sizeof(data),
+                                              PROTNUM_IPV6_EXT_DST));
+}
+
+static void test_gnrc_ipv6_ext_parse_ah(void)
+{
+    gnrc_ipv6_ext_desc_t desc;
+
+    TEST_ASSERT_EQUAL_INT(-ENOTSUP,
+                          gnrc_ipv6_ext_parse(&desc, chain, sizeof(chain),
+                                              PROTNUM_IPV6_EXT_AH));
+}
+
+static gnrc_pktsnip_t *_build_rcv_pkt(bool merged)
+{
+    gnrc_pktsnip_t *pkt;
+    ipv6_hdr_t hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    ipv6_hdr_set_version(&hdr);
+    hdr.nh = PROTNUM_IPV6_EXT_HOPOPT;
+    pkt = gnrc_pktbuf_add(NULL, &hdr, sizeof(hdr), GNRC_NETTYPE_IPV6);
+    if (merged) {
+        pkt = gnrc_pktbuf_add(pkt, chain, sizeof(chain),
+                              GNRC_NETTYPE_IPV6_EXT);
+    }
+    else {
+        pkt = gnrc_pktbuf_add(pkt, chain, CHAIN_DST_OFFSET,
+                              GNRC_NETTYPE_IPV6_EXT);
+        pkt = gnrc_pktbuf_add(pkt, chain + CHAIN_DST_OFFSET,
+                              sizeof(chain) - CHAIN_DST_OFFSET,
+                              GNRC_NETTYPE_IPV6_EXT);
+    }
+    return gnrc_pktbuf_add(pkt, NULL, 8, GNRC_NETTYPE_UNDEF);
+}
+
+static void _test_get(bool merged)
+{
+    gnrc_pktsnip_t *pkt = _build_rcv_pkt(merged);
+    ipv6_ext_t *ext;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_NOT_NULL((ext = gnrc_ipv6_ext_get(pkt,
+                                                  PROTNUM_IPV6_EXT_HOPOPT)));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_IPV6_EXT_DST, ext->nh);
+    TEST_ASSERT_NOT_NULL((ext = gnrc_ipv6_ext_get(pkt, PROTNUM_IPV6_EXT_DST)));
+    TEST_ASSERT_EQUAL_INT(PROTNUM_UDP, ext->nh);
+    TEST_ASSERT_EQUAL_INT(1, ext->len);
+    TEST_ASSERT_NULL(gnrc_ipv6_ext_get(pkt, PROTNUM_IPV6_EXT_RH));
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_ipv6_ext_get_merged(void)
+{
+    _test_get(true);
+}
+
+static void test_gnrc_ipv6_ext_get_separate(void)
+{
+    _test_get(false);
+}
+
+/* builds a packet as received by the IPv6 layer before the extension
+ * headers are demultiplexed: UNDEF <- IPv6 */
+static gnrc_pktsnip_t *_build_demux_pkt(const uint8_t *exts, size_t len)
+{
+    gnrc_pktsnip_t *pkt;
+    ipv6_hdr_t hdr;
+
+    memset(&hdr, 0, sizeof(hdr));
+    ipv6_hdr_set_version(&hdr);
+    hdr.nh = PROTNUM_IPV6_EXT_HOPOPT;
+    hdr.len = byteorder_htons(len + UDP_SIZE);
+    hdr.src = _src;
+    hdr.dst = _src;
+    hdr.dst.u8[15] = 2;
+    if ((pkt = gnrc_pktbuf_add(NULL, &hdr, sizeof(hdr),
+                               GNRC_NETTYPE_IPV6)) == NULL) {
+        return NULL;
+    }
+    if ((pkt = gnrc_pktbuf_add(pkt, NULL, len + UDP_SIZE,
+                               GNRC_NETTYPE_UNDEF)) == NULL) {
+        return NULL;
+    }
+    memcpy(pkt->data, exts, len);
+    memset(((uint8_t *)pkt->data) + len, 0, UDP_SIZE);
+    return pkt;
+}
+
+/* gets the last packet received and releases all others */
+static gnrc_pktsnip_t *_recv_last(unsigned *num)
+{
+    gnrc_pktsnip_t *pkt = NULL;
+    msg_t msg;
+
+    *num = 0;
+    while (msg_try_receive(&msg) > 0) {
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        if (pkt != NULL) {
+            gnrc_pktbuf_release(pkt);
+        }
+        pkt = msg.content.ptr;
+        (*num)++;
+    }
+    return pkt;
+}
+
+static void test_gnrc_ipv6_ext_demux_chain(void)
+{
+    gnrc_pktsnip_t *pkt = _build_demux_pkt(chain, sizeof(chain));
+    unsigned num;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    gnrc_ipv6_ext_demux(NULL, pkt, pkt, PROTNUM_IPV6_EXT_HOPOPT);
+    /* the listener for UDP does not prevent marking the chain at once and
+     * gets the packet exactly once */
+    TEST_ASSERT_NOT_NULL((pkt = _recv_last(&num)));
+    TEST_ASSERT_EQUAL_INT(1, num);
+    TEST_ASSERT_EQUAL_INT(UDP_SIZE, pkt->size);
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6_EXT, pkt->next->type);
+    TEST_ASSERT_EQUAL_INT(sizeof(chain), pkt->next->size);
+    TEST_ASSERT_NOT_NULL(pkt->next->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6, pkt->next->next->type);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+/* checks that every extension header was marked as a snip of its own */
+static void _test_separate(gnrc_pktsnip_t *pkt, size_t second_size)
+{
+    TEST_ASSERT_EQUAL_INT(UDP_SIZE, pkt->size);
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6_EXT, pkt->next->type);
+    TEST_ASSERT_EQUAL_INT(second_size, pkt->next->size);
+    TEST_ASSERT_NOT_NULL(pkt->next->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6_EXT, pkt->next->next->type);
+    TEST_ASSERT_EQUAL_INT(CHAIN_DST_OFFSET, pkt->next->next->size);
+    TEST_ASSERT_NOT_NULL(pkt->next->next->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6, pkt->next->next->next->type);
+}
+
+static void test_gnrc_ipv6_ext_demux_chain_registered(void)
+{
+    gnrc_pktsnip_t *pkt = _build_demux_pkt(chain, sizeof(chain));
+    unsigned num;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    /* a listener for a header within the chain needs the packet after the
+     * header preceding it, so the headers are marked one by one */
+    gnrc_netreg_register(GNRC_NETTYPE_IPV6, &_dst_entry);
+    gnrc_ipv6_ext_demux(NULL, pkt, pkt, PROTNUM_IPV6_EXT_HOPOPT);
+    TEST_ASSERT_NOT_NULL((pkt = _recv_last(&num)));
+    TEST_ASSERT(num > 1);
+    _test_separate(pkt, sizeof(chain) - CHAIN_DST_OFFSET);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_ipv6_ext_demux_chain_unparsable(void)
+{
+    gnrc_pktsnip_t *pkt = _build_demux_pkt(ah_chain, sizeof(ah_chain));
+    unsigned num;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    /* gnrc_ipv6_ext_parse() does not support authentication headers */
+    gnrc_ipv6_ext_demux(NULL, pkt, pkt, PROTNUM_IPV6_EXT_HOPOPT);
+    TEST_ASSERT_NOT_NULL((pkt = _recv_last(&num)));
+    _test_separate(pkt, sizeof(ah_chain) - CHAIN_DST_OFFSET);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_ipv6_ext_demux_chain_truncated(void)
+{
+    gnrc_pktsnip_t *pkt = _build_demux_pkt(chain, sizeof(chain));
+    unsigned num;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    /* destination options header exceeds the packet */
+    ((uint8_t *)pkt->data)[CHAIN_DST_OFFSET + 1] = 4;
+    gnrc_ipv6_ext_demux(NULL, pkt, pkt, PROTNUM_IPV6_EXT_HOPOPT);
+    TEST_ASSERT_NULL(_recv_last(&num));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_ipv6_ext_demux_rh_discard(void)
+{
+    gnrc_pktsnip_t *pkt = _build_demux_pkt(rh_chain, sizeof(rh_chain));
+    icmpv6_error_param_prob_t *err;
+    unsigned num;
+    msg_t msg;
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    /* receive the error message instead of the IPv6 thread */
+    gnrc_ipv6_pid = thread_getpid();
+    gnrc_ipv6_ext_demux(NULL, pkt, pkt, PROTNUM_IPV6_EXT_HOPOPT);
+    /* a routing header of unknown type with segments left is not skipped */
+    TEST_ASSERT_EQUAL_INT(1, msg_avail());
+    msg_receive(&msg);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETAPI_MSG_TYPE_SND, msg.type);
+    pkt = msg.content.ptr;
+    TEST_ASSERT_NOT_NULL(pkt->next);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_ICMPV6, pkt->next->type);
+    err = pkt->next->data;
+    TEST_ASSERT_EQUAL_INT(ICMPV6_PARAM_PROB, err->type);
+    TEST_ASSERT_EQUAL_INT(ICMPV6_ERROR_PARAM_PROB_HDR_FIELD, err->code);
+    /* points to the routing type field */
+    TEST_ASSERT_EQUAL_INT(sizeof(ipv6_hdr_t) + RH_CHAIN_TYPE_OFFSET,
+                          byteorder_ntohl(err->ptr));
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT_NULL(_recv_last(&num));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_ipv6_ext_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_ipv6_ext_parse),
+        new_TestFixture(test_gnrc_ipv6_ext_parse_no_ext),
+        new_TestFixture(test_gnrc_ipv6_ext_parse_truncated),
+        new_TestFixture(test_gnrc_ipv6_ext_parse_too_many),
+        new_TestFixture(test_gnrc_ipv6_ext_parse_ah),
+        new_TestFixture(test_gnrc_ipv6_ext_get_merged),
+        new_TestFixture(test_gnrc_ipv6_ext_get_separate),
+        new_TestFixture(test_gnrc_ipv6_ext_demux_chain),
+        new_TestFixture(test_gnrc_ipv6_ext_demux_chain_registered),
+        new_TestFixture(test_gnrc_ipv6_ext_demux_chain_unparsable),
+        new_TestFixture(test_gnrc_ipv6_ext_demux_chain_truncated),
+        new_TestFixture(test_gnrc_ipv6_ext_demux_rh_discard),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_ipv6_ext_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&gnrc_ipv6_ext_tests;
+}
+
+void tests_gnrc_ipv6_ext(void)
+{
+    TESTS_RUN(tests_gnrc_ipv6_ext_tests());
+}
+/** @} */
@@ -239,6 +239,54 @@ static void test_gnrc_mac_queue_rx_packet(void)
 }
 #endif /* GNRC_MAC_RX_QUEUE_SIZE != 0 */
 
+#if (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0)
+/**
+ * @brief This function tests `gnrc_mac_tx_burst_pending()`, to see whether it
+ *        announces the queued packets of the current neighbor up to the burst
+ *        limit, and never announces broadcasts.
+ */
+static void test_gnrc_mac_tx_burst(void)
+{
+    gnrc_mac_tx_t tx = GNRC_MAC_TX_INIT;
+    gnrc_pktsnip_t *pkt;
+    uint8_t dst_addr[] = { 0x76, 0xb6 };
+
+    for (unsigned i = 0; i < 3; i++) {
+        pkt = gnrc_netif_hdr_build(NULL, 0, dst_addr, sizeof(dst_addr));
+        LL_APPEND(pkt, gnrc_pktbuf_add(NULL, TEST_STRING4, sizeof(TEST_STRING4),
+                                       GNRC_NETTYPE_UNDEF));
+        TEST_ASSERT(gnrc_mac_queue_tx_packet(&tx, 0, pkt));
+    }
+    pkt = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    ((gnrc_netif_hdr_t *)pkt->data)->flags |= GNRC_NETIF_HDR_FLAGS_BROADCAST;
+    TEST_ASSERT(gnrc_mac_queue_tx_packet(&tx, 0, pkt));
+
+    /* broadcasts are never sent in bursts */
+    tx.current_neighbor = &tx.neighbors[0];
+    gnrc_mac_tx_burst_start(&tx);
+    TEST_ASSERT(!gnrc_mac_tx_burst_pending(&tx, 2));
+
+    /* the first of three packets is followed by at most two more */
+    tx.current_neighbor = &tx.neighbors[1];
+    gnrc_mac_tx_burst_start(&tx);
+    tx.packet = gnrc_priority_pktqueue_pop(&tx.current_neighbor->queue);
+    TEST_ASSERT(gnrc_mac_tx_burst_pending(&tx, 1));
+    gnrc_pktbuf_release(tx.packet);
+    tx.packet = gnrc_priority_pktqueue_pop(&tx.current_neighbor->queue);
+    /* limit reached, even though a packet is left */
+    TEST_ASSERT(!gnrc_mac_tx_burst_pending(&tx, 1));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_priority_pktqueue_length(&tx.current_neighbor->queue));
+    gnrc_pktbuf_release(tx.packet);
+
+    /* next rendezvous, the last packet ends the burst */
+    gnrc_mac_tx_burst_start(&tx);
+    tx.packet = gnrc_priority_pktqueue_pop(&tx.current_neighbor->queue);
+    TEST_ASSERT(!gnrc_mac_tx_burst_pending(&tx, 1));
+    gnrc_pktbuf_release(tx.packet);
+    gnrc_pktbuf_release(gnrc_priority_pktqueue_pop(&tx.neighbors[0].queue));
+}
+#endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0) */
+
 #if GNRC_MAC_DISPATCH_BUFFER_SIZE != 0
 static void test_gnrc_mac_dispatch(void)
 {
@@ -263,6 +311,9 @@ Test *tests_gnrc_mac_internal_tests(void)
 #if GNRC_MAC_TX_QUEUE_SIZE != 0
         new_TestFixture(test_gnrc_mac_queue_tx_packet),
 #endif /* GNRC_MAC_TX_QUEUE_SIZE != 0 */
+#if (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0)
+        new_TestFixture(test_gnrc_mac_tx_burst),
+#endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0) */
 #if GNRC_MAC_RX_QUEUE_SIZE != 0
         new_TestFixture(test_gnrc_mac_queue_rx_packet),
 #endif /* GNRC_MAC_RX_QUEUE_SIZE != 0 */
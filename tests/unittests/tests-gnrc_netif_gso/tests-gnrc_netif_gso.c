@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "byteorder.h"
+#include "net/inet_csum.h"
+#include "net/ipv6/hdr.h"
+#include "net/udp.h"
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netif/gso.h"
+#include "net/gnrc/udp.h"
+#include "net/protnum.h"
+
+#include "unittests-constants.h"
+#include "tests-gnrc_netif_gso.h"
+
+#define TEST_GSO_SIZE   (10U)
+#define TEST_PID        (KERNEL_PID_LAST)
+
+/* split over two snips, so segments have to be merged */
+#define TEST_PAYLOAD_SPLIT  (7U)
+
+static const ipv6_addr_t src = { {
+        0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    } };
+static const ipv6_addr_t dst = { {
+        0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    } };
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+}
+
+static gnrc_pktsnip_t *_build_pkt(uint16_t gso_size)
+{
+    gnrc_pktsnip_t *pkt, *netif;
+    gnrc_netif_hdr_t *hdr;
+
+    pkt = gnrc_pktbuf_add(NULL, TEST_STRING16 + TEST_PAYLOAD_SPLIT,
+                          sizeof(TEST_STRING16) - TEST_PAYLOAD_SPLIT,
+                          GNRC_NETTYPE_UNDEF);
+    pkt = gnrc_pktbuf_add(pkt, TEST_STRING16, TEST_PAYLOAD_SPLIT,
+                          GNRC_NETTYPE_UNDEF);
+    pkt = gnrc_udp_hdr_build(pkt, TEST_UINT16, TEST_UINT16 + 1);
+    pkt = gnrc_ipv6_hdr_build(pkt, &src, &dst);
+    ((ipv6_hdr_t *)pkt->data)->nh = PROTNUM_UDP;
+    netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    hdr = netif->data;
+    hdr->if_pid = TEST_PID;
+    hdr->gso_size = gso_size;
+    netif->next = pkt;
+    return netif;
+}
+
+/* checksum of a segment as a receiver computes it over the reassembled
+ * datagram */
+static uint16_t _exp_csum(ipv6_hdr_t *ipv6, const udp_hdr_t *udp,
+                          size_t offset, size_t seg_size)
+{
+    uint8_t buf[sizeof(udp_hdr_t) + sizeof(TEST_STRING16)];
+    udp_hdr_t *hdr = (udp_hdr_t *)buf;
+    uint16_t len = sizeof(udp_hdr_t) + seg_size;
+    uint16_t csum;
+
+    memcpy(hdr, udp, sizeof(udp_hdr_t));
+    hdr->checksum.u16 = 0;
+    memcpy(&buf[sizeof(udp_hdr_t)], TEST_STRING16 + offset, seg_size);
+    csum = ipv6_hdr_inet_csum(0, ipv6, PROTNUM_UDP, len);
+    csum = ~inet_csum(csum, buf, len);
+    return (csum == 0) ? 0xffff : csum;
+}
+
+static void test_gnrc_netif_gso_size(void)
+{
+    gnrc_pktsnip_t *pkt = _build_pkt(TEST_GSO_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(TEST_GSO_SIZE, gnrc_netif_gso_size(pkt));
+    /* no netif header */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_gso_size(pkt->next));
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_gnrc_netif_gso_seg_len(void)
+{
+    gnrc_pktsnip_t *pkt = _build_pkt(TEST_GSO_SIZE);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t) +
+                          TEST_GSO_SIZE, gnrc_netif_gso_seg_len(pkt));
+    /* gso_size larger than payload */
+    ((gnrc_netif_hdr_t *)pkt->data)->gso_size = UINT16_MAX;
+    TEST_ASSERT_EQUAL_INT(gnrc_pkt_len(pkt->next),
+                          gnrc_netif_gso_seg_len(pkt));
+    /* no segmentation */
+    ((gnrc_netif_hdr_t *)pkt->data)->gso_size = 0;
+    TEST_ASSERT_EQUAL_INT(gnrc_pkt_len(pkt->next),
+                          gnrc_netif_gso_seg_len(pkt));
+    gnrc_pktbuf_release(pkt);
+}
+
+static void test_gnrc_netif_gso_next(void)
+{
+    gnrc_pktsnip_t *pkt = _build_pkt(TEST_GSO_SIZE);
+    gnrc_pktsnip_t *seg;
+    size_t offset = 0, exp_offset = 0;
+
+    while ((seg = gnrc_netif_gso_next(pkt, &offset)) != NULL) {
+        gnrc_netif_hdr_t *hdr = seg->data;
+        gnrc_pktsnip_t *ipv6, *udp, *payload;
+        size_t seg_size = sizeof(TEST_STRING16) - exp_offset;
+
+        if (seg_size > TEST_GSO_SIZE) {
+            seg_size = TEST_GSO_SIZE;
+        }
+        TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_NETIF, seg->type);
+        TEST_ASSERT_EQUAL_INT(TEST_PID, hdr->if_pid);
+        TEST_ASSERT_EQUAL_INT(0, hdr->gso_size);
+        TEST_ASSERT_NOT_NULL((ipv6 = seg->next));
+        TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_IPV6, ipv6->type);
+        TEST_ASSERT(ipv6->data != pkt->next->data);
+        TEST_ASSERT_EQUAL_INT(sizeof(udp_hdr_t) + seg_size,
+                              byteorder_ntohs(((ipv6_hdr_t *)ipv6->data)->len));
+        TEST_ASSERT_NOT_NULL((udp = ipv6->next));
+        TEST_ASSERT_EQUAL_INT(GNRC_NETTYPE_UDP, udp->type);
+        TEST_ASSERT_EQUAL_INT(TEST_UINT16,
+                              byteorder_ntohs(((udp_hdr_t *)udp->data)->src_port));
+        TEST_ASSERT_EQUAL_INT(sizeof(udp_hdr_t) + seg_size,
+                              byteorder_ntohs(((udp_hdr_t *)udp->data)->length));
+        TEST_ASSERT_EQUAL_INT(_exp_csum(ipv6->data, udp->data, exp_offset,
+                                        seg_size),
+                              byteorder_ntohs(((udp_hdr_t *)udp->data)->checksum));
+        TEST_ASSERT_NOT_NULL((payload = udp->next));
+        TEST_ASSERT_NULL(payload->next);
+        TEST_ASSERT_EQUAL_INT(seg_size, payload->size);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(TEST_STRING16 + exp_offset,
+                                        payload->data, seg_size));
+        exp_offset += seg_size;
+        TEST_ASSERT_EQUAL_INT(exp_offset, offset);
+        gnrc_pktbuf_release(seg);
+    }
+    TEST_ASSERT_EQUAL_INT(sizeof(TEST_STRING16), offset);
+    /* original stays untouched */
+    TEST_ASSERT_EQUAL_INT(TEST_GSO_SIZE, gnrc_netif_gso_size(pkt));
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_netif_gso_next_no_udp(void)
+{
+    gnrc_pktsnip_t *pkt = _build_pkt(TEST_GSO_SIZE);
+    gnrc_pktsnip_t *udp = pkt->next->next;
+    size_t offset = 0;
+
+    udp->type = GNRC_NETTYPE_UNDEF;
+    TEST_ASSERT_NULL(gnrc_netif_gso_next(pkt, &offset));
+    TEST_ASSERT_EQUAL_INT(0, offset);
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_netif_gso_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_netif_gso_size),
+        new_TestFixture(test_gnrc_netif_gso_seg_len),
+        new_TestFixture(test_gnrc_netif_gso_next),
+        new_TestFixture(test_gnrc_netif_gso_next_no_udp),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_netif_gso_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_netif_gso_tests;
+}
+
+void tests_gnrc_netif_gso(void)
+{
+    TESTS_RUN(tests_gnrc_netif_gso_tests());
+}
+/** @} */
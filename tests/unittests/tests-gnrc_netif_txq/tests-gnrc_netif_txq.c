@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/icmpv6.h"
+#include "net/protnum.h"
+#include "net/gnrc/pkt.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/ipv6/hdr.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netif/txq.h"
+
+#include "unittests-constants.h"
+#include "tests-gnrc_netif_txq.h"
+
+#define PKT_INIT_ELEM(len, _data, _next) \
+    { .next = (_next), .data = (_data), .size = (len), .users = 1, \
+      .type = GNRC_NETTYPE_UNDEF }
+#define PKT_INIT_ELEM_STATIC_DATA(data, next) PKT_INIT_ELEM(sizeof(data), data, next)
+
+#define DRR_PKT_SIZE    (GNRC_NETIF_TXQ_DRR_QUANTUM * 2)
+
+static gnrc_netif_txq_t txq;
+static uint8_t drr_data[DRR_PKT_SIZE];
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    gnrc_netif_txq_init(&txq);
+}
+
+static void test_gnrc_netif_txq_init(void)
+{
+    TEST_ASSERT(gnrc_netif_txq_empty(&txq));
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_SCHED_DEFAULT, txq.sched);
+    TEST_ASSERT_NULL(gnrc_netif_txq_pop(&txq));
+}
+
+static void test_gnrc_netif_txq_push_pop_strict(void)
+{
+    gnrc_pktsnip_t pkt_ctrl = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+    gnrc_pktsnip_t pkt_high = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+    gnrc_pktsnip_t pkt_def1 = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+    gnrc_pktsnip_t pkt_def2 = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+    gnrc_pktsnip_t pkt_bulk = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+
+    txq.sched = GNRC_NETIF_TXQ_SCHED_STRICT;
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_bulk,
+                                                 GNRC_NETIF_TXQ_CLASS_BULK));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_def1,
+                                                 GNRC_NETIF_TXQ_CLASS_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_high,
+                                                 GNRC_NETIF_TXQ_CLASS_HIGH));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_def2,
+                                                 GNRC_NETIF_TXQ_CLASS_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_ctrl,
+                                                 GNRC_NETIF_TXQ_CLASS_CTRL));
+    TEST_ASSERT_EQUAL_INT(2, txq.stats[GNRC_NETIF_TXQ_CLASS_DEFAULT].len);
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_ctrl);
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_high);
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_def1);
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_def2);
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_bulk);
+    TEST_ASSERT_NULL(gnrc_netif_txq_pop(&txq));
+    TEST_ASSERT(gnrc_netif_txq_empty(&txq));
+    TEST_ASSERT_EQUAL_INT(0, txq.stats[GNRC_NETIF_TXQ_CLASS_DEFAULT].len);
+    TEST_ASSERT_EQUAL_INT(2, txq.stats[GNRC_NETIF_TXQ_CLASS_DEFAULT].max_len);
+    TEST_ASSERT_EQUAL_INT(2, txq.stats[GNRC_NETIF_TXQ_CLASS_DEFAULT].enqueued);
+}
+
+static void test_gnrc_netif_txq_push_class_full(void)
+{
+    gnrc_pktsnip_t pkts[GNRC_NETIF_TXQ_SIZE + 1];
+
+    memset(pkts, 0, sizeof(pkts));
+    for (unsigned i = 0; i < GNRC_NETIF_TXQ_CLASS_LIMIT; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkts[i],
+                                                     GNRC_NETIF_TXQ_CLASS_BULK));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          gnrc_netif_txq_push(&txq,
+                                              &pkts[GNRC_NETIF_TXQ_CLASS_LIMIT],
+                                              GNRC_NETIF_TXQ_CLASS_BULK));
+    TEST_ASSERT_EQUAL_INT(1, txq.stats[GNRC_NETIF_TXQ_CLASS_BULK].dropped);
+    /* control traffic may still take up the rest of the queue */
+    for (unsigned i = GNRC_NETIF_TXQ_CLASS_LIMIT; i < GNRC_NETIF_TXQ_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkts[i],
+                                                     GNRC_NETIF_TXQ_CLASS_CTRL));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          gnrc_netif_txq_push(&txq, &pkts[GNRC_NETIF_TXQ_SIZE],
+                                              GNRC_NETIF_TXQ_CLASS_CTRL));
+    TEST_ASSERT_EQUAL_INT(1, txq.stats[GNRC_NETIF_TXQ_CLASS_CTRL].dropped);
+}
+
+static void test_gnrc_netif_txq_pop_drr(void)
+{
+    gnrc_pktsnip_t high[5] = {
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+    };
+    gnrc_pktsnip_t bulk[3] = {
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+        PKT_INIT_ELEM_STATIC_DATA(drr_data, NULL),
+    };
+    /* quantum of high is 4 times that of bulk and a packet costs two bulk
+     * quanta */
+    gnrc_pktsnip_t *exp[] = { &high[0], &high[1], &high[2], &high[3],
+                              &bulk[0], &high[4], &bulk[1], &bulk[2] };
+
+    txq.sched = GNRC_NETIF_TXQ_SCHED_DRR;
+    for (unsigned i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &high[i],
+                                                     GNRC_NETIF_TXQ_CLASS_HIGH));
+    }
+    for (unsigned i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &bulk[i],
+                                                     GNRC_NETIF_TXQ_CLASS_BULK));
+    }
+    for (unsigned i = 0; i < (sizeof(exp) / sizeof(exp[0])); i++) {
+        TEST_ASSERT(gnrc_netif_txq_pop(&txq) == exp[i]);
+    }
+    TEST_ASSERT_NULL(gnrc_netif_txq_pop(&txq));
+}
+
+static void test_gnrc_netif_txq_pop_drr_ctrl_first(void)
+{
+    gnrc_pktsnip_t pkt_bulk = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+    gnrc_pktsnip_t pkt_ctrl = PKT_INIT_ELEM_STATIC_DATA(TEST_STRING8, NULL);
+
+    txq.sched = GNRC_NETIF_TXQ_SCHED_DRR;
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_bulk,
+                                                 GNRC_NETIF_TXQ_CLASS_BULK));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, &pkt_ctrl,
+                                                 GNRC_NETIF_TXQ_CLASS_CTRL));
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_ctrl);
+    TEST_ASSERT(gnrc_netif_txq_pop(&txq) == &pkt_bulk);
+}
+
+static void test_gnrc_netif_txq_flush(void)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, TEST_STRING8,
+                                          sizeof(TEST_STRING8),
+                                          GNRC_NETTYPE_UNDEF);
+
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_netif_txq_push(&txq, pkt,
+                                                 GNRC_NETIF_TXQ_CLASS_HIGH));
+    gnrc_netif_txq_flush(&txq);
+    TEST_ASSERT(gnrc_netif_txq_empty(&txq));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_netif_txq_classify(void)
+{
+    gnrc_pktsnip_t *netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
+    gnrc_netif_hdr_t *hdr;
+
+    TEST_ASSERT_NOT_NULL(netif);
+    hdr = netif->data;
+    hdr->flags = GNRC_NETIF_HDR_FLAGS_MULTICAST;
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_AUTO,
+                          gnrc_netif_hdr_get_txq_class(hdr));
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_DEFAULT,
+                          gnrc_netif_txq_classify(netif));
+    gnrc_netif_hdr_set_txq_class(hdr, GNRC_NETIF_TXQ_CLASS_CTRL);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_CTRL,
+                          gnrc_netif_hdr_get_txq_class(hdr));
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_CTRL,
+                          gnrc_netif_txq_classify(netif));
+    gnrc_netif_hdr_set_txq_class(hdr, GNRC_NETIF_TXQ_CLASS_BULK);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_BULK,
+                          gnrc_netif_txq_classify(netif));
+    /* other flags stay untouched */
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_HDR_FLAGS_MULTICAST,
+                          hdr->flags & GNRC_NETIF_HDR_FLAGS_MULTICAST);
+    gnrc_netif_hdr_set_txq_class(hdr, GNRC_NETIF_TXQ_CLASS_AUTO);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_HDR_FLAGS_MULTICAST, hdr->flags);
+    gnrc_pktbuf_release(netif);
+}
+
+static gnrc_pktsnip_t *_build_ipv6(uint8_t dscp, uint8_t icmpv6_type)
+{
+    gnrc_pktsnip_t *payload = NULL, *ipv6, *netif;
+    ipv6_hdr_t *hdr;
+
+    if (icmpv6_type != 0) {
+        uint8_t icmpv6[] = { icmpv6_type, 0, 0, 0 };
+
+        payload = gnrc_pktbuf_add(NULL, icmpv6, sizeof(icmpv6),
+                                  GNRC_NETTYPE_ICMPV6);
+        if (payload == NULL) {
+            return NULL;
+        }
+    }
+    if ((ipv6 = gnrc_ipv6_hdr_build(payload, NULL, NULL)) == NULL) {
+        gnrc_pktbuf_release(payload);
+        return NULL;
+    }
+    hdr = ipv6->data;
+    hdr->nh = (icmpv6_type != 0) ? PROTNUM_ICMPV6 : PROTNUM_UDP;
+    ipv6_hdr_set_tc_dscp(hdr, dscp);
+    if ((netif = gnrc_netif_hdr_build(NULL, 0, NULL, 0)) == NULL) {
+        gnrc_pktbuf_release(ipv6);
+        return NULL;
+    }
+    netif->next = ipv6;
+    return netif;
+}
+
+static void test_gnrc_netif_txq_classify_dscp(void)
+{
+    static const uint8_t dscps[] = { 0x00, 0x01, 0x08, 0x0a, 0x22, 0x2e,
+                                     0x30, 0x38 };
+    static const uint8_t classes[] = {
+        GNRC_NETIF_TXQ_CLASS_DEFAULT,   /* default */
+        GNRC_NETIF_TXQ_CLASS_BULK,      /* LE */
+        GNRC_NETIF_TXQ_CLASS_BULK,      /* CS1 */
+        GNRC_NETIF_TXQ_CLASS_DEFAULT,   /* AF11 */
+        GNRC_NETIF_TXQ_CLASS_HIGH,      /* AF41 */
+        GNRC_NETIF_TXQ_CLASS_HIGH,      /* EF */
+        GNRC_NETIF_TXQ_CLASS_CTRL,      /* CS6 */
+        GNRC_NETIF_TXQ_CLASS_CTRL,      /* CS7 */
+    };
+
+    for (unsigned i = 0; i < sizeof(dscps); i++) {
+        gnrc_pktsnip_t *pkt = _build_ipv6(dscps[i], 0);
+
+        TEST_ASSERT_NOT_NULL(pkt);
+        TEST_ASSERT_EQUAL_INT(classes[i], gnrc_netif_txq_classify(pkt));
+        /* also without a netif header */
+        TEST_ASSERT_EQUAL_INT(classes[i], gnrc_netif_txq_classify(pkt->next));
+        /* an explicit class takes precedence */
+        gnrc_netif_hdr_set_txq_class(pkt->data, GNRC_NETIF_TXQ_CLASS_BULK);
+        TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_BULK,
+                              gnrc_netif_txq_classify(pkt));
+        gnrc_pktbuf_release(pkt);
+    }
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+static void test_gnrc_netif_txq_classify_icmpv6(void)
+{
+    static const uint8_t ctrl[] = { ICMPV6_RTR_SOL, ICMPV6_RTR_ADV,
+                                    ICMPV6_NBR_SOL, ICMPV6_NBR_ADV,
+                                    ICMPV6_REDIRECT, ICMPV6_RPL_CTRL,
+                                    ICMPV6_DAR, ICMPV6_DAC };
+    gnrc_pktsnip_t *pkt;
+
+    for (unsigned i = 0; i < sizeof(ctrl); i++) {
+        /* regardless of the DSCP */
+        pkt = _build_ipv6(0x01, ctrl[i]);
+        TEST_ASSERT_NOT_NULL(pkt);
+        TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_CTRL,
+                              gnrc_netif_txq_classify(pkt));
+        gnrc_pktbuf_release(pkt);
+    }
+    /* other ICMPv6 messages are classified by their DSCP */
+    pkt = _build_ipv6(0x00, ICMPV6_ECHO_REQ);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_DEFAULT,
+                          gnrc_netif_txq_classify(pkt));
+    gnrc_pktbuf_release(pkt);
+    pkt = _build_ipv6(0x2e, ICMPV6_ECHO_REP);
+    TEST_ASSERT_NOT_NULL(pkt);
+    TEST_ASSERT_EQUAL_INT(GNRC_NETIF_TXQ_CLASS_HIGH,
+                          gnrc_netif_txq_classify(pkt));
+    gnrc_pktbuf_release(pkt);
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_netif_txq_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_netif_txq_init),
+        new_TestFixture(test_gnrc_netif_txq_push_pop_strict),
+        new_TestFixture(test_gnrc_netif_txq_push_class_full),
+        new_TestFixture(test_gnrc_netif_txq_pop_drr),
+        new_TestFixture(test_gnrc_netif_txq_pop_drr_ctrl_first),
+        new_TestFixture(test_gnrc_netif_txq_flush),
+        new_TestFixture(test_gnrc_netif_txq_classify),
+        new_TestFixture(test_gnrc_netif_txq_classify_dscp),
+        new_TestFixture(test_gnrc_netif_txq_classify_icmpv6),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_netif_txq_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_netif_txq_tests;
+}
+
+void tests_gnrc_netif_txq(void)
+{
+    TESTS_RUN(tests_gnrc_netif_txq_tests());
+}
+/** @} */
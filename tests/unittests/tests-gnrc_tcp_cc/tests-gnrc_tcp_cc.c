@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <stdint.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/tcp.h"
+
+#include "tests-gnrc_tcp_cc.h"
+
+#define MSS         (500U)
+#define ISS         (1000U)
+/* segments per RTT the simulated link carries without loss */
+#define CAPACITY    (20U)
+#define ROUNDS      (300U)
+
+static gnrc_tcp_tcb_t tcb;
+
+static void set_up(void)
+{
+    gnrc_tcp_tcb_init(&tcb);
+    tcb.mss = MSS;
+    tcb.iss = ISS;
+    tcb.snd_una = ISS + 1;
+    tcb.snd_nxt = ISS + 1;
+}
+
+static void _send(unsigned segs)
+{
+    tcb.snd_nxt += segs * MSS;
+}
+
+static bool _ack(unsigned segs)
+{
+    tcb.snd_una += segs * MSS;
+    tcb.dup_acks = 0;
+    return tcb.cc->ack(&tcb, segs * MSS);
+}
+
+static bool _dup_ack(void)
+{
+    tcb.dup_acks++;
+    return tcb.cc->dup_ack(&tcb);
+}
+
+/* One round trip over a link that loses a segment whenever a window exceeds
+ * its capacity. The following segments get through and cause duplicate ACKs. */
+static void _round(void)
+{
+    unsigned segs = tcb.cwnd / MSS;
+    bool retransmitted = false;
+
+    segs = (segs > 0) ? segs : 1;
+    _send(segs);
+    if (segs <= CAPACITY) {
+        for (unsigned i = 0; i < segs; i++) {
+            _ack(1);
+        }
+        return;
+    }
+    for (unsigned i = 1; i < segs; i++) {
+        retransmitted |= _dup_ack();
+    }
+    if (!retransmitted) {
+        tcb.cc->timeout(&tcb);
+    }
+    /* retransmission repairs the hole */
+    _ack(segs);
+}
+
+static void _test_converges(const gnrc_tcp_cc_t *cc)
+{
+    uint32_t sum = 0;
+
+    tcb.cc = cc;
+    tcb.cc->init(&tcb);
+    for (unsigned i = 0; i < ROUNDS; i++) {
+        _round();
+        if (i >= (ROUNDS / 2)) {
+            TEST_ASSERT(tcb.cwnd >= MSS);
+            TEST_ASSERT(tcb.cwnd <= 2 * CAPACITY * MSS);
+            TEST_ASSERT(tcb.ssthresh >= 2 * MSS);
+            TEST_ASSERT(tcb.ssthresh <= 2 * CAPACITY * MSS);
+            sum += tcb.cwnd;
+        }
+    }
+    /* average window must use at least half of the link */
+    TEST_ASSERT(sum / (ROUNDS - (ROUNDS / 2)) >= (CAPACITY / 2) * MSS);
+}
+
+static void test_gnrc_tcp_cc_default(void)
+{
+    TEST_ASSERT(&GNRC_TCP_CC_DEFAULT == tcb.cc);
+}
+
+static void test_gnrc_tcp_cc_newreno_slow_start(void)
+{
+    tcb.cc = &gnrc_tcp_cc_newreno;
+    tcb.cc->init(&tcb);
+    TEST_ASSERT_EQUAL_INT(4 * MSS, tcb.cwnd);
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, tcb.ssthresh);
+    _send(2);
+    TEST_ASSERT(!_ack(1));
+    TEST_ASSERT_EQUAL_INT(5 * MSS, tcb.cwnd);
+    TEST_ASSERT(!_ack(1));
+    TEST_ASSERT_EQUAL_INT(6 * MSS, tcb.cwnd);
+}
+
+static void test_gnrc_tcp_cc_newreno_fast_recovery(void)
+{
+    tcb.cc = &gnrc_tcp_cc_newreno;
+    tcb.cc->init(&tcb);
+    tcb.cwnd = 10 * MSS;
+    _send(10);
+    TEST_ASSERT(!_dup_ack());
+    TEST_ASSERT(!_dup_ack());
+    TEST_ASSERT(_dup_ack());
+    TEST_ASSERT_EQUAL_INT(5 * MSS, tcb.ssthresh);
+    TEST_ASSERT_EQUAL_INT(8 * MSS, tcb.cwnd);
+    /* inflation */
+    TEST_ASSERT(!_dup_ack());
+    TEST_ASSERT_EQUAL_INT(9 * MSS, tcb.cwnd);
+    /* partial ACK retransmits the next hole */
+    TEST_ASSERT(_ack(4));
+    TEST_ASSERT_EQUAL_INT(6 * MSS, tcb.cwnd);
+    /* full ACK deflates the window */
+    TEST_ASSERT(!_ack(6));
+    TEST_ASSERT_EQUAL_INT(5 * MSS, tcb.ssthresh);
+    TEST_ASSERT_EQUAL_INT(5 * MSS, tcb.cwnd);
+    TEST_ASSERT(!tcb.cc_state.newreno.recovery);
+}
+
+static void test_gnrc_tcp_cc_newreno_timeout(void)
+{
+    tcb.cc = &gnrc_tcp_cc_newreno;
+    tcb.cc->init(&tcb);
+    _send(8);
+    tcb.cc->timeout(&tcb);
+    TEST_ASSERT_EQUAL_INT(MSS, tcb.cwnd);
+    TEST_ASSERT_EQUAL_INT(4 * MSS, tcb.ssthresh);
+    /* same window: no further fast retransmit */
+    _dup_ack();
+    _dup_ack();
+    TEST_ASSERT(!_dup_ack());
+}
+
+static void test_gnrc_tcp_cc_newreno_converges(void)
+{
+    _test_converges(&gnrc_tcp_cc_newreno);
+}
+
+static void test_gnrc_tcp_cc_cubic_lite_reduce(void)
+{
+    tcb.cc = &gnrc_tcp_cc_cubic_lite;
+    tcb.cc->init(&tcb);
+    tcb.cwnd = 10 * MSS;
+    tcb.ssthresh = 10 * MSS;
+    _send(10);
+    _dup_ack();
+    _dup_ack();
+    TEST_ASSERT(_dup_ack());
+    TEST_ASSERT_EQUAL_INT(10 * MSS, tcb.cc_state.cubic_lite.w_max);
+    TEST_ASSERT_EQUAL_INT((10 * MSS * 717) / 1024, tcb.cwnd);
+    TEST_ASSERT_EQUAL_INT(tcb.cwnd, tcb.ssthresh);
+    /* only one reduction per window */
+    TEST_ASSERT(!_dup_ack());
+    TEST_ASSERT_EQUAL_INT((10 * MSS * 717) / 1024, tcb.cwnd);
+}
+
+static void test_gnrc_tcp_cc_cubic_lite_converges(void)
+{
+    _test_converges(&gnrc_tcp_cc_cubic_lite);
+}
+
+Test *tests_gnrc_tcp_cc_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_tcp_cc_default),
+        new_TestFixture(test_gnrc_tcp_cc_newreno_slow_start),
+        new_TestFixture(test_gnrc_tcp_cc_newreno_fast_recovery),
+        new_TestFixture(test_gnrc_tcp_cc_newreno_timeout),
+        new_TestFixture(test_gnrc_tcp_cc_newreno_converges),
+        new_TestFixture(test_gnrc_tcp_cc_cubic_lite_reduce),
+        new_TestFixture(test_gnrc_tcp_cc_cubic_lite_converges),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_tcp_cc_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_tcp_cc_tests;
+}
+
+void tests_gnrc_tcp_cc(void)
+{
+    TESTS_RUN(tests_gnrc_tcp_cc_tests());
+}
+/** @} */
@@ -13,10 +13,12 @@
  */
 #include <errno.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "embUnit.h"
 
 #include "net/nanocoap.h"
+#include "net/nanocoap_block.h"
 
 #include "unittests-constants.h"
 #include "tests-nanocoap.h"
@@ -45,10 +47,247 @@ static void test_nanocoap__hdr(void)
     TEST_ASSERT_EQUAL_STRING((char *)path, (char *)path_tmp);
 }
 
+/*
+ * Validates options added out of order, read back with the option iterator.
+ */
+static void test_nanocoap__opt_add(void)
+{
+    uint8_t buf[64];
+    coap_pkt_t pkt;
+    coap_optiter_t iter;
+    int opt_len;
+    uint8_t *val;
+
+    ssize_t hdr_len = coap_build_hdr((coap_hdr_t *)buf, COAP_REQ, NULL, 0,
+                                     COAP_METHOD_PUT, 1);
+    coap_pkt_init(&pkt, buf, sizeof(buf), hdr_len);
+
+    TEST_ASSERT_EQUAL_INT(1, coap_opt_add_format(&pkt, 0));
+    /* the option behind it keeps its header size */
+    TEST_ASSERT_EQUAL_INT(4, coap_opt_add_string(&pkt, COAP_OPT_URI_PATH,
+                                                 "/a/b", '/'));
+    TEST_ASSERT_EQUAL_INT(3, coap_opt_add_uint(&pkt, COAP_OPT_OBSERVE, 300));
+    TEST_ASSERT_EQUAL_INT(4, coap_opt_add_opaque(&pkt, COAP_OPT_URI_QUERY,
+                                                 (uint8_t *)"x=1", 3));
+    TEST_ASSERT_EQUAL_INT(4, coap_opt_add_opaque(&pkt, 300,
+                                                 (uint8_t *)"z", 1));
+    /* the delta of option 300 shrinks from 285 to 250, so its header loses a
+     * byte */
+    TEST_ASSERT_EQUAL_INT(2, coap_opt_add_opaque(&pkt, 50,
+                                                 (uint8_t *)"y", 1));
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, coap_opt_add_opaque(&pkt, 60, buf, 64));
+
+    ssize_t len = coap_opt_finish(&pkt, COAP_OPT_FINISH_PAYLOAD);
+    TEST_ASSERT_EQUAL_INT(hdr_len + 18 + 1, len);
+    TEST_ASSERT(pkt.payload == &buf[len]);
+    memcpy(pkt.payload, "hi", 2);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pkt, buf, len + 2));
+    TEST_ASSERT_EQUAL_INT(2, pkt.payload_len);
+    TEST_ASSERT_EQUAL_INT(0, coap_get_content_type(&pkt));
+    TEST_ASSERT_NULL(coap_find_option(&pkt, COAP_OPT_BLOCK1));
+
+    static const struct {
+        uint16_t num;
+        const char *val;
+    } exp[] = {
+        { COAP_OPT_OBSERVE, "\x01\x2c" },
+        { COAP_OPT_URI_PATH, "a" },
+        { COAP_OPT_URI_PATH, "b" },
+        { COAP_OPT_CONTENT_FORMAT, "" },
+        { COAP_OPT_URI_QUERY, "x=1" },
+        { 50, "y" },
+        { 300, "z" },
+    };
+    coap_optiter_init(&pkt, &iter);
+    for (unsigned i = 0; i < sizeof(exp) / sizeof(exp[0]); i++) {
+        val = coap_optiter_next(&iter, &opt_len);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(exp[i].num, iter.opt_num);
+        TEST_ASSERT_EQUAL_INT(strlen(exp[i].val), opt_len);
+        TEST_ASSERT(memcmp(val, exp[i].val, opt_len) == 0);
+    }
+    TEST_ASSERT_NULL(coap_optiter_next(&iter, &opt_len));
+}
+
+static uint8_t block_src[100];
+
+static struct {
+    size_t offset;
+    size_t len;
+    bool more;
+    int res;
+} block_written;
+
+static ssize_t _block_read(void *arg, size_t offset, uint8_t *buf, size_t len)
+{
+    (void)arg;
+    if (offset >= sizeof(block_src)) {
+        return 0;
+    }
+    if (len > sizeof(block_src) - offset) {
+        len = sizeof(block_src) - offset;
+    }
+    memcpy(buf, &block_src[offset], len);
+    return len;
+}
+
+static int _block_write(void *arg, size_t offset, const uint8_t *buf,
+                        size_t len, bool more)
+{
+    (void)arg;
+    (void)buf;
+    block_written.offset = offset;
+    block_written.len = len;
+    block_written.more = more;
+    return block_written.res;
+}
+
+/*
+ * Builds a GET request for a block in buf, lets coap_block2_reply() answer it
+ * and parses the response into pkt.
+ */
+static int _block2_get(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                       int blknum, unsigned szx)
+{
+    uint8_t *pktpos = buf;
+    pktpos += coap_build_hdr((coap_hdr_t *)pktpos, COAP_REQ, NULL, 0,
+                             COAP_METHOD_GET, 1);
+    pktpos += coap_put_option_uri(pktpos, 0, "/block", COAP_OPT_URI_PATH);
+    if (blknum >= 0) {
+        pktpos += coap_put_option_block2(pktpos, COAP_OPT_URI_PATH, blknum,
+                                         szx, 0);
+    }
+    if (coap_parse(pkt, buf, pktpos - buf) < 0) {
+        return -EINVAL;
+    }
+
+    ssize_t res = coap_block2_reply(pkt, COAP_CODE_CONTENT, buf, len,
+                                    COAP_CT_OCTET_STREAM, _block_read, NULL);
+    if (res <= 0) {
+        return -EINVAL;
+    }
+    return coap_parse(pkt, buf, res);
+}
+
+/*
+ * Validates the blocks of a Block2 response, sized to the buffer.
+ */
+static void test_nanocoap__block2_reply(void)
+{
+    uint8_t buf[64];
+    coap_pkt_t pkt;
+    coap_block1_t block2;
+
+    for (unsigned i = 0; i < sizeof(block_src); i++) {
+        block_src[i] = i;
+    }
+
+    /* the first block is as large as fits into buf */
+    TEST_ASSERT_EQUAL_INT(0, _block2_get(&pkt, buf, sizeof(buf), -1, 0));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&pkt));
+    TEST_ASSERT_EQUAL_INT(COAP_CT_OCTET_STREAM, coap_get_content_type(&pkt));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pkt, &block2));
+    TEST_ASSERT_EQUAL_INT(0, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block2.szx);
+    TEST_ASSERT_EQUAL_INT(1, block2.more);
+    TEST_ASSERT_EQUAL_INT(32, pkt.payload_len);
+    TEST_ASSERT(memcmp(pkt.payload, &block_src[0], 32) == 0);
+
+    /* a larger block than fits is answered with the block at its offset */
+    TEST_ASSERT_EQUAL_INT(0, _block2_get(&pkt, buf, sizeof(buf), 1, 2));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pkt, &block2));
+    TEST_ASSERT_EQUAL_INT(2, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block2.szx);
+    TEST_ASSERT_EQUAL_INT(1, block2.more);
+    TEST_ASSERT_EQUAL_INT(32, pkt.payload_len);
+    TEST_ASSERT(memcmp(pkt.payload, &block_src[64], 32) == 0);
+
+    /* smaller blocks are served as requested */
+    TEST_ASSERT_EQUAL_INT(0, _block2_get(&pkt, buf, sizeof(buf), 6, 0));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block2(&pkt, &block2));
+    TEST_ASSERT_EQUAL_INT(6, block2.blknum);
+    TEST_ASSERT_EQUAL_INT(0, block2.szx);
+    TEST_ASSERT_EQUAL_INT(0, block2.more);
+    TEST_ASSERT_EQUAL_INT(4, pkt.payload_len);
+    TEST_ASSERT(memcmp(pkt.payload, &block_src[96], 4) == 0);
+
+    /* no block beyond the end */
+    TEST_ASSERT_EQUAL_INT(0, _block2_get(&pkt, buf, sizeof(buf), 4, 1));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_BAD_OPTION, coap_get_code_raw(&pkt));
+
+    /* no space for a block of 16 bytes */
+    TEST_ASSERT_EQUAL_INT(-EINVAL, _block2_get(&pkt, buf, 24, -1, 0));
+}
+
+/*
+ * Builds a PUT request for a block in buf, lets coap_block1_reply() answer it
+ * and parses the response into pkt.
+ */
+static int _block1_put(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                       unsigned blknum, int more)
+{
+    uint8_t *pktpos = buf;
+    pktpos += coap_build_hdr((coap_hdr_t *)pktpos, COAP_REQ, NULL, 0,
+                             COAP_METHOD_PUT, 1);
+    pktpos += coap_put_option_uri(pktpos, 0, "/block", COAP_OPT_URI_PATH);
+    pktpos += coap_put_option_block1(pktpos, COAP_OPT_URI_PATH, blknum, 0,
+                                     more);
+    *pktpos++ = 0xff;
+    memcpy(pktpos, block_src, 16);
+    pktpos += 16;
+    if (coap_parse(pkt, buf, pktpos - buf) < 0) {
+        return -EINVAL;
+    }
+
+    ssize_t res = coap_block1_reply(pkt, COAP_CODE_CHANGED, buf, len,
+                                    _block_write, NULL);
+    if (res <= 0) {
+        return -EINVAL;
+    }
+    return coap_parse(pkt, buf, res);
+}
+
+/*
+ * Validates the responses to the blocks of a Block1 request.
+ */
+static void test_nanocoap__block1_reply(void)
+{
+    uint8_t buf[64];
+    coap_pkt_t pkt;
+    coap_block1_t block1;
+
+    block_written.res = 0;
+    TEST_ASSERT_EQUAL_INT(0, _block1_put(&pkt, buf, sizeof(buf), 1, 1));
+    TEST_ASSERT_EQUAL_INT(16, block_written.offset);
+    TEST_ASSERT_EQUAL_INT(16, block_written.len);
+    TEST_ASSERT(block_written.more);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTINUE, coap_get_code_raw(&pkt));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block1(&pkt, &block1));
+    TEST_ASSERT_EQUAL_INT(1, block1.blknum);
+    TEST_ASSERT_EQUAL_INT(1, block1.more);
+
+    TEST_ASSERT_EQUAL_INT(0, _block1_put(&pkt, buf, sizeof(buf), 2, 0));
+    TEST_ASSERT_EQUAL_INT(32, block_written.offset);
+    TEST_ASSERT(!block_written.more);
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CHANGED, coap_get_code_raw(&pkt));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_block1(&pkt, &block1));
+    TEST_ASSERT_EQUAL_INT(2, block1.blknum);
+    TEST_ASSERT_EQUAL_INT(0, block1.more);
+
+    block_written.res = -ENOSPC;
+    TEST_ASSERT_EQUAL_INT(0, _block1_put(&pkt, buf, sizeof(buf), 3, 1));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_REQUEST_ENTITY_TOO_LARGE,
+                          coap_get_code_raw(&pkt));
+}
+
 Test *tests_nanocoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_nanocoap__hdr),
+        new_TestFixture(test_nanocoap__opt_add),
+        new_TestFixture(test_nanocoap__block2_reply),
+        new_TestFixture(test_nanocoap__block1_reply),
     };
 
     EMB_UNIT_TESTCALLER(nanocoap_tests, NULL, NULL, fixtures);
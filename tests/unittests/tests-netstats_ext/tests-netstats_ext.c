@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/netstats/ext.h"
+
+#include "tests-netstats_ext.h"
+
+#define TEST_SEC    (1000U)
+
+static netstats_ext_hist_t hist;
+static netstats_ext_rate_t rate;
+
+static void set_up(void)
+{
+    memset(&hist, 0, sizeof(hist));
+    memset(&rate, 0, sizeof(rate));
+    netstats_ext_reset();
+}
+
+static void test_netstats_ext_hist_add(void)
+{
+    netstats_ext_hist_add(&hist, 0);
+    netstats_ext_hist_add(&hist, (1U << NETSTATS_EXT_HIST_SHIFT) - 1);
+    netstats_ext_hist_add(&hist, 1U << NETSTATS_EXT_HIST_SHIFT);
+    netstats_ext_hist_add(&hist, 3U << NETSTATS_EXT_HIST_SHIFT);
+    TEST_ASSERT_EQUAL_INT(2, hist.buckets[0]);
+    TEST_ASSERT_EQUAL_INT(1, hist.buckets[1]);
+    TEST_ASSERT_EQUAL_INT(1, hist.buckets[2]);
+    TEST_ASSERT_EQUAL_INT(4, hist.count);
+    TEST_ASSERT_EQUAL_INT(0, hist.min);
+    TEST_ASSERT_EQUAL_INT(3U << NETSTATS_EXT_HIST_SHIFT, hist.max);
+    TEST_ASSERT_EQUAL_INT((1U << NETSTATS_EXT_HIST_SHIFT) - 1 +
+                          (4U << NETSTATS_EXT_HIST_SHIFT), (uint32_t)hist.sum);
+}
+
+static void test_netstats_ext_hist_add_overflow(void)
+{
+    netstats_ext_hist_add(&hist, UINT32_MAX);
+    netstats_ext_hist_add(&hist, 12);
+    TEST_ASSERT_EQUAL_INT(1, hist.buckets[NETSTATS_EXT_HIST_BUCKETS - 1]);
+    TEST_ASSERT_EQUAL_INT(12, hist.min);
+    TEST_ASSERT_EQUAL_INT(UINT32_MAX, hist.max);
+}
+
+static void test_netstats_ext_rate(void)
+{
+    netstats_ext_rates_t res;
+
+    for (unsigned i = 0; i < NETSTATS_EXT_RATE_WINDOW; i++) {
+        netstats_ext_rate_add(&rate, TEST_SEC + i, false, 100);
+        netstats_ext_rate_add(&rate, TEST_SEC + i, false, 100);
+        netstats_ext_rate_add(&rate, TEST_SEC + i, true, 50);
+    }
+    netstats_ext_rate_get(&rate, TEST_SEC + NETSTATS_EXT_RATE_WINDOW - 1,
+                          &res);
+    TEST_ASSERT_EQUAL_INT(2, res.rx_count);
+    TEST_ASSERT_EQUAL_INT(200, res.rx_bytes);
+    TEST_ASSERT_EQUAL_INT(1, res.tx_count);
+    TEST_ASSERT_EQUAL_INT(50, res.tx_bytes);
+}
+
+static void test_netstats_ext_rate_window(void)
+{
+    netstats_ext_rates_t res;
+
+    netstats_ext_rate_add(&rate, TEST_SEC, false,
+                          100 * NETSTATS_EXT_RATE_WINDOW);
+    /* slot leaves the window */
+    netstats_ext_rate_get(&rate, TEST_SEC + NETSTATS_EXT_RATE_WINDOW, &res);
+    TEST_ASSERT_EQUAL_INT(0, res.rx_bytes);
+    netstats_ext_rate_get(&rate, TEST_SEC + NETSTATS_EXT_RATE_WINDOW - 1,
+                          &res);
+    TEST_ASSERT_EQUAL_INT(100, res.rx_bytes);
+    /* slot is reused a full window later */
+    netstats_ext_rate_add(&rate, TEST_SEC + NETSTATS_EXT_RATE_WINDOW, false,
+                          0);
+    netstats_ext_rate_get(&rate, TEST_SEC + NETSTATS_EXT_RATE_WINDOW, &res);
+    TEST_ASSERT_EQUAL_INT(0, res.rx_bytes);
+}
+
+static void test_netstats_ext_drop(void)
+{
+    const netstats_ext_t *stats = netstats_ext_get();
+
+    netstats_ext_drop(NETSTATS_EXT_LAYER_6LO, NETSTATS_EXT_DROP_RBUF_FULL);
+    netstats_ext_drop(NETSTATS_EXT_LAYER_6LO, NETSTATS_EXT_DROP_RBUF_FULL);
+    TEST_ASSERT_EQUAL_INT(2, stats->drops[NETSTATS_EXT_LAYER_6LO]
+                                         [NETSTATS_EXT_DROP_RBUF_FULL]);
+    TEST_ASSERT_EQUAL_INT(0, stats->drops[NETSTATS_EXT_LAYER_IPV6]
+                                         [NETSTATS_EXT_DROP_RBUF_FULL]);
+    netstats_ext_reset();
+    TEST_ASSERT_EQUAL_INT(0, stats->drops[NETSTATS_EXT_LAYER_6LO]
+                                         [NETSTATS_EXT_DROP_RBUF_FULL]);
+}
+
+static void test_netstats_ext_latency_no_rx_time(void)
+{
+    const netstats_ext_t *stats = netstats_ext_get();
+
+    netstats_ext_latency(NETSTATS_EXT_LAYER_IPV6, 0);
+    TEST_ASSERT_EQUAL_INT(0, stats->latency[NETSTATS_EXT_LAYER_IPV6].count);
+    netstats_ext_latency(NETSTATS_EXT_LAYER_IPV6, netstats_ext_now());
+    TEST_ASSERT_EQUAL_INT(1, stats->latency[NETSTATS_EXT_LAYER_IPV6].count);
+}
+
+Test *tests_netstats_ext_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_netstats_ext_hist_add),
+        new_TestFixture(test_netstats_ext_hist_add_overflow),
+        new_TestFixture(test_netstats_ext_rate),
+        new_TestFixture(test_netstats_ext_rate_window),
+        new_TestFixture(test_netstats_ext_drop),
+        new_TestFixture(test_netstats_ext_latency_no_rx_time),
+    };
+
+    EMB_UNIT_TESTCALLER(netstats_ext_tests, set_up, NULL, fixtures);
+
+    return (Test *)&netstats_ext_tests;
+}
+
+void tests_netstats_ext(void)
+{
+    TESTS_RUN(tests_netstats_ext_tests());
+}
+/** @} */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/netstats/neighbor.h"
+
+#include "tests-netstats_neighbor.h"
+
+static netstats_nb_table_t table;
+static const uint8_t addr1[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static const uint8_t addr2[] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 };
+
+static void set_up(void)
+{
+    netstats_nb_init(&table);
+}
+
+static void test_netstats_nb_get_unknown(void)
+{
+    TEST_ASSERT_NULL(netstats_nb_get(&table, addr1, sizeof(addr1)));
+    netstats_nb_record(&table, addr1, sizeof(addr1));
+    TEST_ASSERT_NULL(netstats_nb_get(&table, addr2, sizeof(addr2)));
+    TEST_ASSERT_NULL(netstats_nb_get(&table, addr1, 2));
+}
+
+static void test_netstats_nb_etx(void)
+{
+    const netstats_nb_t *nb;
+
+    netstats_nb_record(&table, addr1, sizeof(addr1));
+    netstats_nb_update_tx(&table, NETSTATS_NB_TX_SUCCESS, 0);
+    nb = netstats_nb_get(&table, addr1, sizeof(addr1));
+    TEST_ASSERT_NOT_NULL(nb);
+    TEST_ASSERT_EQUAL_INT(1, nb->tx_count);
+    TEST_ASSERT_EQUAL_INT(NETSTATS_NB_ETX_DIVISOR, nb->etx);
+
+    /* retransmissions increase the ETX, but only by a fraction */
+    netstats_nb_record(&table, addr1, sizeof(addr1));
+    netstats_nb_update_tx(&table, NETSTATS_NB_TX_SUCCESS, 2);
+    TEST_ASSERT_EQUAL_INT(NETSTATS_NB_ETX_DIVISOR +
+                          ((2 * NETSTATS_NB_ETX_DIVISOR) >> NETSTATS_NB_ETX_SHIFT),
+                          nb->etx);
+
+    /* a busy medium says nothing about the link */
+    uint16_t etx = nb->etx;
+    netstats_nb_record(&table, addr1, sizeof(addr1));
+    netstats_nb_update_tx(&table, NETSTATS_NB_TX_BUSY, 0);
+    TEST_ASSERT_EQUAL_INT(etx, nb->etx);
+    TEST_ASSERT_EQUAL_INT(1, nb->tx_failed);
+
+    netstats_nb_record(&table, addr1, sizeof(addr1));
+    netstats_nb_update_tx(&table, NETSTATS_NB_TX_NOACK, 3);
+    TEST_ASSERT(nb->etx > etx);
+    TEST_ASSERT_EQUAL_INT(3, nb->tx_count);
+    TEST_ASSERT_EQUAL_INT(2, nb->tx_failed);
+}
+
+static void test_netstats_nb_broadcast(void)
+{
+    netstats_nb_record(&table, addr1, sizeof(addr1));
+    netstats_nb_record(&table, NULL, 0);
+    netstats_nb_update_tx(&table, NETSTATS_NB_TX_SUCCESS, 0);
+    TEST_ASSERT_EQUAL_INT(0, netstats_nb_get(&table, addr1, sizeof(addr1))->tx_count);
+}
+
+static void test_netstats_nb_replace_lru(void)
+{
+    uint8_t addr[sizeof(addr1)];
+
+    memcpy(addr, addr1, sizeof(addr));
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        addr[0] = i;
+        netstats_nb_record(&table, addr, sizeof(addr));
+    }
+    /* use the first one again, so the second one is replaced */
+    addr[0] = 0;
+    netstats_nb_record(&table, addr, sizeof(addr));
+    netstats_nb_record(&table, addr2, sizeof(addr2));
+    TEST_ASSERT_NOT_NULL(netstats_nb_get(&table, addr2, sizeof(addr2)));
+    TEST_ASSERT_NOT_NULL(netstats_nb_get(&table, addr, sizeof(addr)));
+    addr[0] = 1;
+    TEST_ASSERT_NULL(netstats_nb_get(&table, addr, sizeof(addr)));
+    addr[0] = 2;
+    TEST_ASSERT_NOT_NULL(netstats_nb_get(&table, addr, sizeof(addr)));
+}
+
+Test *tests_netstats_neighbor_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_netstats_nb_get_unknown),
+        new_TestFixture(test_netstats_nb_etx),
+        new_TestFixture(test_netstats_nb_broadcast),
+        new_TestFixture(test_netstats_nb_replace_lru),
+    };
+
+    EMB_UNIT_TESTCALLER(netstats_neighbor_tests, set_up, NULL, fixtures);
+
+    return (Test *)&netstats_neighbor_tests;
+}
+
+void tests_netstats_neighbor(void)
+{
+    TESTS_RUN(tests_netstats_neighbor_tests());
+}
+/** @} */
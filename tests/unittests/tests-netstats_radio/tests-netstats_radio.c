@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include "embUnit.h"
+
+#include "net/netstats/radio.h"
+
+#include "tests-netstats_radio.h"
+
+#define START   (1000U)
+
+/* 1 mA in every state at 1 V, so 1 ms takes 1 uJ */
+static const netstats_radio_power_t power = {
+    .current = { 1000000, 1000000, 1000000, 1000000, 1000000, 1000000 },
+    .voltage = 1000,
+};
+static netstats_radio_t stats;
+
+static void set_up(void)
+{
+    netstats_radio_init(&stats, &power, START);
+}
+
+static void test_netstats_radio_time(void)
+{
+    netstats_radio_set(&stats, NETSTATS_RADIO_SLEEP, START + 100);
+    netstats_radio_set(&stats, NETSTATS_RADIO_LISTEN, START + 1000);
+    netstats_radio_set(&stats, NETSTATS_RADIO_SLEEP, START + 1200);
+    netstats_radio_update(&stats, START + 2000);
+    TEST_ASSERT_EQUAL_INT(300, stats.time[NETSTATS_RADIO_LISTEN]);
+    TEST_ASSERT_EQUAL_INT(1700, stats.time[NETSTATS_RADIO_SLEEP]);
+    TEST_ASSERT_EQUAL_INT(2, stats.transitions[NETSTATS_RADIO_SLEEP]);
+    TEST_ASSERT_EQUAL_INT(1, stats.transitions[NETSTATS_RADIO_LISTEN]);
+    /* 300 of 2000 us on */
+    TEST_ASSERT_EQUAL_INT(1500, netstats_radio_duty_cycle(&stats));
+}
+
+static void test_netstats_radio_same_state(void)
+{
+    netstats_radio_set(&stats, NETSTATS_RADIO_TX, START + 100);
+    netstats_radio_set(&stats, NETSTATS_RADIO_TX, START + 200);
+    netstats_radio_update(&stats, START + 300);
+    TEST_ASSERT_EQUAL_INT(1, stats.transitions[NETSTATS_RADIO_TX]);
+    TEST_ASSERT_EQUAL_INT(200, stats.time[NETSTATS_RADIO_TX]);
+}
+
+static void test_netstats_radio_energy(void)
+{
+    netstats_radio_set(&stats, NETSTATS_RADIO_TX, START + 3000);
+    netstats_radio_set(&stats, NETSTATS_RADIO_OFF, START + 5000);
+    netstats_radio_update(&stats, START + 10000);
+    TEST_ASSERT_EQUAL_INT(3, netstats_radio_energy(&stats, NETSTATS_RADIO_LISTEN));
+    TEST_ASSERT_EQUAL_INT(2, netstats_radio_energy(&stats, NETSTATS_RADIO_TX));
+    TEST_ASSERT_EQUAL_INT(10, netstats_radio_energy(&stats,
+                                                    NETSTATS_RADIO_STATE_NUMOF));
+    TEST_ASSERT_EQUAL_INT(5000, netstats_radio_duty_cycle(&stats));
+}
+
+static void test_netstats_radio_reset(void)
+{
+    netstats_radio_set(&stats, NETSTATS_RADIO_RX, START + 100);
+    netstats_radio_reset(&stats, START + 200);
+    TEST_ASSERT_EQUAL_INT(0, stats.transitions[NETSTATS_RADIO_RX]);
+    TEST_ASSERT_EQUAL_INT(0, netstats_radio_duty_cycle(&stats));
+    /* the current state is kept */
+    netstats_radio_update(&stats, START + 300);
+    TEST_ASSERT_EQUAL_INT(100, stats.time[NETSTATS_RADIO_RX]);
+    TEST_ASSERT_EQUAL_INT(0, stats.time[NETSTATS_RADIO_LISTEN]);
+}
+
+static void test_netstats_radio_default_power(void)
+{
+    netstats_radio_init(&stats, NULL, START);
+    netstats_radio_set(&stats, NETSTATS_RADIO_TX, START + 1000000);
+    netstats_radio_update(&stats, START + 2000000);
+    /* 1 s at 11.8 mA and 1 s at 13.8 mA, both at 3 V */
+    TEST_ASSERT_EQUAL_INT(35400, netstats_radio_energy(&stats,
+                                                       NETSTATS_RADIO_LISTEN));
+    TEST_ASSERT_EQUAL_INT(41400, netstats_radio_energy(&stats,
+                                                       NETSTATS_RADIO_TX));
+}
+
+Test *tests_netstats_radio_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_netstats_radio_time),
+        new_TestFixture(test_netstats_radio_same_state),
+        new_TestFixture(test_netstats_radio_energy),
+        new_TestFixture(test_netstats_radio_reset),
+        new_TestFixture(test_netstats_radio_default_power),
+    };
+
+    EMB_UNIT_TESTCALLER(netstats_radio_tests, set_up, NULL, fixtures);
+
+    return (Test *)&netstats_radio_tests;
+}
+
+void tests_netstats_radio(void)
+{
+    TESTS_RUN(tests_netstats_radio_tests());
+}
+/** @} */
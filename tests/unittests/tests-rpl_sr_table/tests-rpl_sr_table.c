@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/ipv6/addr.h"
+#include "net/ipv6/ext/rh.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/sr_table.h"
+
+#include "tests-rpl_sr_table.h"
+
+#define LIFETIME    (60U)
+
+static uint8_t buf[GNRC_RPL_SR_TABLE_SRH_MAXLEN];
+
+static ipv6_addr_t *_addr(uint16_t id)
+{
+    /* 2001:db8::<id> */
+    static ipv6_addr_t addrs[4];
+    static unsigned idx;
+    ipv6_addr_t *addr = &addrs[idx++ % 4];
+
+    memset(addr, 0, sizeof(ipv6_addr_t));
+    addr->u16[0] = byteorder_htons(0x2001);
+    addr->u16[1] = byteorder_htons(0x0db8);
+    addr->u16[7] = byteorder_htons(id);
+    return addr;
+}
+
+static void set_up(void)
+{
+    gnrc_rpl_sr_table_flush();
+}
+
+static void test_rpl_sr_table_child(void)
+{
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(1), NULL, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_sr_table_numof());
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_srh(_addr(1), &first_hop, buf,
+                                                   sizeof(buf)));
+    TEST_ASSERT(ipv6_addr_equal(_addr(1), &first_hop));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_sr_table_depth(_addr(1)));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_sr_table_srh(_addr(2), &first_hop,
+                                                         buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_sr_table_depth(_addr(2)));
+}
+
+static void test_rpl_sr_table_route(void)
+{
+    ipv6_addr_t first_hop;
+    ipv6_hdr_t hdr;
+    int res;
+
+    /* 1 <- 2 <- 3 <- 4 */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(1), NULL, LIFETIME));
+    for (uint16_t i = 2; i <= 4; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(i), _addr(i - 1),
+                                                       LIFETIME));
+    }
+    TEST_ASSERT_EQUAL_INT(4, gnrc_rpl_sr_table_depth(_addr(4)));
+    res = gnrc_rpl_sr_table_srh(_addr(4), &first_hop, buf,
+                                GNRC_RPL_SR_TABLE_SRH_LEN(4));
+    TEST_ASSERT(res > 0);
+    TEST_ASSERT(ipv6_addr_equal(_addr(1), &first_hop));
+
+    /* the header leads along the route */
+    hdr.dst = first_hop;
+    for (uint16_t i = 2; i <= 4; i++) {
+        TEST_ASSERT_EQUAL_INT(EXT_RH_CODE_FORWARD,
+                              gnrc_rpl_srh_process(&hdr, (gnrc_rpl_srh_t *)buf));
+        TEST_ASSERT(ipv6_addr_equal(_addr(i), &hdr.dst));
+    }
+    TEST_ASSERT_EQUAL_INT(0, ((gnrc_rpl_srh_t *)buf)->seg_left);
+
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, gnrc_rpl_sr_table_srh(_addr(4), &first_hop,
+                                                          buf, 8));
+}
+
+static void test_rpl_sr_table_unknown_parent(void)
+{
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(2), _addr(1), LIFETIME));
+    TEST_ASSERT_EQUAL_INT(2, gnrc_rpl_sr_table_numof());
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_sr_table_srh(_addr(2), &first_hop,
+                                                         buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(1), NULL, LIFETIME));
+    TEST_ASSERT(gnrc_rpl_sr_table_srh(_addr(2), &first_hop, buf, sizeof(buf)) > 0);
+    TEST_ASSERT(ipv6_addr_equal(_addr(1), &first_hop));
+}
+
+static void test_rpl_sr_table_del(void)
+{
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(1), NULL, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(2), _addr(1), LIFETIME));
+    gnrc_rpl_sr_table_del(_addr(1));
+    TEST_ASSERT_EQUAL_INT(1, gnrc_rpl_sr_table_numof());
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_rpl_sr_table_srh(_addr(2), &first_hop,
+                                                         buf, sizeof(buf)));
+    /* a lifetime of 0 removes the node */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(2), NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_numof());
+}
+
+static void test_rpl_sr_table_loop(void)
+{
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(1), _addr(2), LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(2), _addr(1), LIFETIME));
+    TEST_ASSERT_EQUAL_INT(-ELOOP, gnrc_rpl_sr_table_srh(_addr(1), &first_hop,
+                                                        buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-ELOOP, gnrc_rpl_sr_table_depth(_addr(1)));
+}
+
+static void test_rpl_sr_table_timeout(void)
+{
+    ipv6_addr_t first_hop;
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(1), NULL, 10));
+    gnrc_rpl_sr_table_timeout(5);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_srh(_addr(1), &first_hop, buf,
+                                                   sizeof(buf)));
+    gnrc_rpl_sr_table_timeout(5);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_numof());
+}
+
+static void test_rpl_sr_table_full(void)
+{
+    for (uint16_t i = 1; i <= GNRC_RPL_SR_TABLE_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(i), NULL, LIFETIME));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, gnrc_rpl_sr_table_add(_addr(0xffff), NULL,
+                                                         LIFETIME));
+    /* updates still work */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_add(_addr(2), _addr(1), LIFETIME));
+}
+
+Test *tests_rpl_sr_table_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_rpl_sr_table_child),
+        new_TestFixture(test_rpl_sr_table_route),
+        new_TestFixture(test_rpl_sr_table_unknown_parent),
+        new_TestFixture(test_rpl_sr_table_del),
+        new_TestFixture(test_rpl_sr_table_loop),
+        new_TestFixture(test_rpl_sr_table_timeout),
+        new_TestFixture(test_rpl_sr_table_full),
+    };
+
+    EMB_UNIT_TESTCALLER(rpl_sr_table_tests, set_up, NULL, fixtures);
+
+    return (Test *)&rpl_sr_table_tests;
+}
+
+void tests_rpl_sr_table(void)
+{
+    TESTS_RUN(tests_rpl_sr_table_tests());
+}
+/** @} */
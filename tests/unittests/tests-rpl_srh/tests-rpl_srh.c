@@ -11,6 +11,7 @@
  *
  * @file
  */
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include "embUnit.h"
@@ -36,6 +37,15 @@
                                0x00, 0x00, 0x00, 0x00, \
                                0x00, 0x00, 0x00, 0x03 }}
 
+#define IPV6_ADDR3          {{ 0x20, 0x01, 0xab, 0xcd, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x01, 0x04 }}
+#define IPV6_ADDR4          {{ 0x20, 0x01, 0xab, 0xcd, \
+                               0x00, 0x00, 0x00, 0x01, \
+                               0x00, 0x00, 0x00, 0x00, \
+                               0x00, 0x00, 0x00, 0x05 }}
+
 #define IPV6_ADDR1_ELIDED   { 0x00, 0x00, 0x02 }
 #define IPV6_ADDR2_ELIDED   { 0x00, 0x00, 0x03 }
 #define IPV6_ELIDED_PREFIX  (13)
@@ -105,11 +115,70 @@ static void test_rpl_srh_nexthop_prefix_elided(void)
     TEST_ASSERT(ipv6_addr_equal(&hdr.dst, &expected2));
 }
 
+static void test_rpl_srh_build_prefix_elided(void)
+{
+    uint8_t buf[sizeof(gnrc_rpl_srh_t) + 2 * sizeof(ipv6_addr_t)];
+    gnrc_rpl_srh_t *srh = (gnrc_rpl_srh_t *) buf;
+    uint8_t *vec = (uint8_t *) (srh + 1);
+    ipv6_addr_t dst = IPV6_DST, a1 = IPV6_ADDR1, a2 = IPV6_ADDR2;
+    const ipv6_addr_t *addrs[] = { &a1, &a2 };
+
+    /* one octet per address, padded to 8 octets */
+    TEST_ASSERT_EQUAL_INT(16, gnrc_rpl_srh_build(&dst, addrs, 2, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(1, srh->len);
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_TYPE, srh->type);
+    TEST_ASSERT_EQUAL_INT(2, srh->seg_left);
+    TEST_ASSERT_EQUAL_INT((15 << 4) | 15, srh->compr);
+    TEST_ASSERT_EQUAL_INT(6 << 4, srh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(a1.u8[15], vec[0]);
+    TEST_ASSERT_EQUAL_INT(a2.u8[15], vec[1]);
+}
+
+static void test_rpl_srh_build_error(void)
+{
+    uint8_t buf[sizeof(gnrc_rpl_srh_t) + 2 * sizeof(ipv6_addr_t)];
+    ipv6_addr_t dst = IPV6_DST, a1 = IPV6_ADDR1, a4 = IPV6_ADDR4;
+    const ipv6_addr_t *addrs[] = { &a1, &a4 };
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, gnrc_rpl_srh_build(&dst, addrs, 0, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, gnrc_rpl_srh_build(&dst, addrs, 2, buf,
+                                                       sizeof(gnrc_rpl_srh_t) + 8));
+}
+
+static void test_rpl_srh_build_process(void)
+{
+    ipv6_hdr_t hdr;
+    uint8_t buf[sizeof(gnrc_rpl_srh_t) + 4 * sizeof(ipv6_addr_t)];
+    gnrc_rpl_srh_t *srh = (gnrc_rpl_srh_t *) buf;
+    ipv6_addr_t dst = IPV6_DST, a1 = IPV6_ADDR1, a3 = IPV6_ADDR3,
+                a4 = IPV6_ADDR4, a2 = IPV6_ADDR2;
+    /* the prefixes shared with the address before differ from hop to hop */
+    const ipv6_addr_t *addrs[] = { &a1, &a3, &a4, &a2 };
+    int res;
+
+    res = gnrc_rpl_srh_build(&dst, addrs, 4, buf, sizeof(buf));
+    TEST_ASSERT(res > 0);
+    TEST_ASSERT(res < (int)sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(0, res % 8);
+    TEST_ASSERT_EQUAL_INT((res / 8) - 1, srh->len);
+
+    hdr.dst = dst;
+    for (unsigned i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(EXT_RH_CODE_FORWARD, gnrc_rpl_srh_process(&hdr, srh));
+        TEST_ASSERT_EQUAL_INT(3 - i, srh->seg_left);
+        TEST_ASSERT(ipv6_addr_equal(&hdr.dst, addrs[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(EXT_RH_CODE_OK, gnrc_rpl_srh_process(&hdr, srh));
+}
+
 Test *tests_rpl_srh_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_rpl_srh_nexthop_no_prefix_elided),
         new_TestFixture(test_rpl_srh_nexthop_prefix_elided),
+        new_TestFixture(test_rpl_srh_build_prefix_elided),
+        new_TestFixture(test_rpl_srh_build_error),
+        new_TestFixture(test_rpl_srh_build_process),
     };
 
     EMB_UNIT_TESTCALLER(rpl_srh_tests, NULL, NULL, fixtures);
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/sock/dns.h"
+
+#include "tests-sock_dns_cache.h"
+
+#define TEST_NAME       "example.org"
+#define TEST_TTL        (600U)
+
+static const uint8_t addr4[] = { 10, 0, 0, 1 };
+static const uint8_t addr6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+                                 0, 0, 0, 0, 0, 0, 0, 1 };
+
+static void set_up(void)
+{
+    sock_dns_cache_flush();
+}
+
+static void test_sock_dns_cache_query__empty(void)
+{
+    uint8_t addr[16];
+
+    TEST_ASSERT_EQUAL_INT(0, sock_dns_cache_query(TEST_NAME, addr, AF_UNSPEC));
+}
+
+static void test_sock_dns_cache_add__success(void)
+{
+    uint8_t addr[16];
+
+    sock_dns_cache_add(TEST_NAME, addr6, sizeof(addr6), AF_UNSPEC, TEST_TTL);
+    sock_dns_cache_add(TEST_NAME, addr4, sizeof(addr4), AF_INET, TEST_TTL);
+    TEST_ASSERT_EQUAL_INT(sizeof(addr6),
+                          sock_dns_cache_query(TEST_NAME, addr, AF_UNSPEC));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(addr6, addr, sizeof(addr6)));
+    TEST_ASSERT_EQUAL_INT(sizeof(addr4),
+                          sock_dns_cache_query(TEST_NAME, addr, AF_INET));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(addr4, addr, sizeof(addr4)));
+    /* no entry for that family */
+    TEST_ASSERT_EQUAL_INT(0, sock_dns_cache_query(TEST_NAME, addr, AF_INET6));
+    TEST_ASSERT_EQUAL_INT(0, sock_dns_cache_query("example.com", addr,
+                                                  AF_INET));
+}
+
+static void test_sock_dns_cache_add__replace(void)
+{
+    static const uint8_t other[] = { 10, 0, 0, 2 };
+    uint8_t addr[16];
+
+    sock_dns_cache_add(TEST_NAME, addr4, sizeof(addr4), AF_INET, TEST_TTL);
+    sock_dns_cache_add(TEST_NAME, other, sizeof(other), AF_INET, TEST_TTL);
+    TEST_ASSERT_EQUAL_INT(sizeof(other),
+                          sock_dns_cache_query(TEST_NAME, addr, AF_INET));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(other, addr, sizeof(other)));
+}
+
+static void test_sock_dns_cache_add__negative(void)
+{
+    uint8_t addr[16];
+
+    sock_dns_cache_add(TEST_NAME, NULL, 0, AF_INET, SOCK_DNS_CACHE_NEG_TTL);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, sock_dns_cache_query(TEST_NAME, addr,
+                                                        AF_INET));
+    /* an answer replaces the negative entry */
+    sock_dns_cache_add(TEST_NAME, addr4, sizeof(addr4), AF_INET, TEST_TTL);
+    TEST_ASSERT_EQUAL_INT(sizeof(addr4),
+                          sock_dns_cache_query(TEST_NAME, addr, AF_INET));
+}
+
+static void test_sock_dns_cache_add__expired(void)
+{
+    uint8_t addr[16];
+
+    sock_dns_cache_add(TEST_NAME, addr4, sizeof(addr4), AF_INET, 0);
+    TEST_ASSERT_EQUAL_INT(0, sock_dns_cache_query(TEST_NAME, addr, AF_INET));
+}
+
+static void test_sock_dns_cache_add__full(void)
+{
+    char name[] = "0.example.org";
+    uint8_t addr[16];
+
+    /* the entry expiring first is replaced */
+    for (unsigned i = 0; i <= SOCK_DNS_CACHE_SIZE; i++) {
+        name[0] = '0' + i;
+        sock_dns_cache_add(name, addr4, sizeof(addr4), AF_INET, TEST_TTL + i);
+    }
+    name[0] = '0';
+    TEST_ASSERT_EQUAL_INT(0, sock_dns_cache_query(name, addr, AF_INET));
+    for (unsigned i = 1; i <= SOCK_DNS_CACHE_SIZE; i++) {
+        name[0] = '0' + i;
+        TEST_ASSERT_EQUAL_INT(sizeof(addr4),
+                              sock_dns_cache_query(name, addr, AF_INET));
+    }
+}
+
+static void test_sock_dns_cache_flush(void)
+{
+    uint8_t addr[16];
+
+    sock_dns_cache_add(TEST_NAME, addr4, sizeof(addr4), AF_INET, TEST_TTL);
+    sock_dns_cache_flush();
+    TEST_ASSERT_EQUAL_INT(0, sock_dns_cache_query(TEST_NAME, addr, AF_INET));
+}
+
+Test *tests_sock_dns_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_sock_dns_cache_query__empty),
+        new_TestFixture(test_sock_dns_cache_add__success),
+        new_TestFixture(test_sock_dns_cache_add__replace),
+        new_TestFixture(test_sock_dns_cache_add__negative),
+        new_TestFixture(test_sock_dns_cache_add__expired),
+        new_TestFixture(test_sock_dns_cache_add__full),
+        new_TestFixture(test_sock_dns_cache_flush),
+    };
+
+    EMB_UNIT_TESTCALLER(sock_dns_cache_tests, set_up, NULL, fixtures);
+
+    return (Test *)&sock_dns_cache_tests;
+}
+
+void tests_sock_dns_cache(void)
+{
+    TESTS_RUN(tests_sock_dns_cache_tests());
+}
+/** @} */
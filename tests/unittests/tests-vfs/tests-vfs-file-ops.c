@@ -42,6 +42,7 @@ static const vfs_file_ops_t null_file_ops = {
     .open  = NULL,
     .read  = NULL,
     .write = NULL,
+    .ftruncate = NULL,
 };
 
 static const vfs_dir_ops_t null_dir_ops = {
@@ -150,6 +151,15 @@ static void test_vfs_null_file_ops_write(void)
     TEST_ASSERT_EQUAL_INT(-EFAULT, res);
 }
 
+static void test_vfs_null_file_ops_ftruncate(void)
+{
+    TEST_ASSERT(_test_vfs_file_op_my_fd >= 0);
+    int res = vfs_ftruncate(_test_vfs_file_op_my_fd, 0);
+    TEST_ASSERT_EQUAL_INT(-EBADF, res);
+    res = vfs_ftruncate(_test_vfs_file_op_my_fd, -1);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, res);
+}
+
 Test *tests_vfs_null_file_ops_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -159,6 +169,7 @@ Test *tests_vfs_null_file_ops_tests(void)
         new_TestFixture(test_vfs_null_file_ops_fstat),
         new_TestFixture(test_vfs_null_file_ops_read),
         new_TestFixture(test_vfs_null_file_ops_write),
+        new_TestFixture(test_vfs_null_file_ops_ftruncate),
     };
 
     EMB_UNIT_TESTCALLER(vfs_file_op_tests, setup, teardown, fixtures);